@@ -14,9 +14,18 @@
 #include "mp3_decoder/mp3_decoder.h"
 #include "aac_decoder/aac_decoder.h"
 #include "flac_decoder/flac_decoder.h"
+#include "opus_decoder/opus_decoder.h"
+#include "vorbis_decoder/vorbis_decoder.h"
 #include "../core/config.h"
 #include "core/ModbusHandler.h"
 #include "core/player.h"
+#include "../core/prefetch.h"
+#include "../core/dnscache.h"
+#include "../core/connector.h"
+#include "lwip/sockets.h"
+#include "net/race.h"
+#include "net/recv.h"
+#include <errno.h>
 
 
 #ifdef SDFATFS_USED
@@ -28,6 +37,9 @@ fs::SDFATFS SD_SDFAT;
 #ifndef DMA_BUFLEN
   #define DMA_BUFLEN  512   //  (512)
 #endif
+#ifndef I2S_BLOCK_WRITE
+  #define I2S_BLOCK_WRITE  true   // false: one i2s_write() per frame (reference path for the cycle statistics)
+#endif
 #if defined(ESP_ARDUINO_3)
 #include "soc/io_mux_reg.h"
 #endif
@@ -240,6 +252,17 @@ Audio::Audio(bool internalDAC /* = false */, uint8_t channelEnabled /* = I2S_DAC
         m_filter[i].b1  = 0;
         m_filter[i].b2  = 0;
     }
+    BQ_Init(&m_bqChain);
+    updateGain();
+    VU_Init(&m_vu, VU_PEAK_HOLD_MS, VU_DECAY_MS, VU_RMS_MS);
+    setCrossfade(AUDIO_XFADE_MS);
+
+    static const oggCodec_t oggFLAC   = {CODEC_OGG_FLAC,   FLAC_MAX_OGG_PACKET, oggIsFLAC,   FLACDecoderReset,    FLACDecodeOggPacket};
+    static const oggCodec_t oggOpus   = {CODEC_OGG_OPUS,   OPUS_MAX_PACKET,     oggIsOpus,   OPUSDecoder_Reset,   OPUSDecode};
+    static const oggCodec_t oggVorbis = {CODEC_OGG_VORBIS, VORBIS_MAX_PACKET,   oggIsVorbis, VORBISDecoder_Reset, VORBISDecode};
+    OGG_Register(&m_ogg, &oggFLAC);
+    OGG_Register(&m_ogg, &oggOpus);
+    OGG_Register(&m_ogg, &oggVorbis);
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::setBufsize(int rambuf_sz, int psrambuf_sz) {
@@ -306,25 +329,36 @@ Audio::~Audio() {
     //InBuff.~AudioBuffer(); #215 the AudioBuffer is automatically destroyed by the destructor
     setDefaults();
     if(m_playlistBuff) {free(m_playlistBuff); m_playlistBuff = NULL;}
+    if(m_scStation) {free(m_scStation); m_scStation = NULL;}
+    vector_clear_and_shrink(m_mirrors);
     i2s_driver_uninstall((i2s_port_t)m_i2s_num); // #215 free I2S buffer
 }
 //---------------------------------------------------------------------------------------------------------------------
-void Audio::setDefaults() {
-    stopSong();
+void Audio::setDefaults(bool keepFade) {
+    // keepFade: a new station or track, the crossfade started by xfadeBegin() plays on
+    stopSong(keepFade);
     initInBuff(); // initialize InputBuffer if not already done
     InBuff.resetBuffer();
     MP3Decoder_FreeBuffers();
     FLACDecoder_FreeBuffers();
+    OPUSDecoder_FreeBuffers();
+    VORBISDecoder_FreeBuffers();
     AACDecoder_FreeBuffers();
+    OGG_FreeBuffers(&m_ogg);
     if(m_playlistBuff)   {free(m_playlistBuff);     m_playlistBuff = NULL;} // free if stream is not m3u8
     vector_clear_and_shrink(m_playlistURL);
+    m_playlistSeq.clear(); m_playlistSeq.shrink_to_fit();
     vector_clear_and_shrink(m_playlistContent);
     m_hashQueue.clear(); m_hashQueue.shrink_to_fit(); // uint32_t vector
+    vector_clear_and_shrink(m_hlsVariantURL);
+    m_hlsBandwidth.clear(); m_hlsBandwidth.shrink_to_fit();
+    m_hlsVariant = -1;
+    ABR_Reset(&m_abr);
     if(config.getMode()!=PM_SDCARD){
       if(_client) _client->stop();
       _client = static_cast<WiFiClient*>(&client); /* default to *something* so that no NULL deref can happen */
     }
-    playI2Sremains();
+    if(m_xfSrc.codec == CODEC_NONE) playI2Sremains(); // else the ring holds the fading stream
 
     AUDIO_INFO("buffers freed, free Heap: %u bytes", ESP.getFreeHeap());
 
@@ -343,6 +377,9 @@ void Audio::setDefaults() {
     m_f_m3u8data = false;                                   // set again in processM3U8entries() if necessary
     m_f_continue = false;
     m_f_ts = false;
+    m_f_xfEof = false;
+    m_hlsPending = HLS_NONE;
+    m_hlsRefresh = 0;
 
     m_streamType = ST_NONE;
     m_codec = CODEC_NONE;
@@ -355,7 +392,7 @@ void Audio::setDefaults() {
     m_avr_bitrate = 0;                                      // the same as m_bitrate if CBR, median if VBR
     m_bitRate = 0;                                          // Bitrate still unknown
     m_bytesNotDecoded = 0;                                  // counts all not decodable bytes
-    m_chunkcount = 0;                                       // for chunked streams
+    CK_Reset(&m_chunk);                                     // for chunked streams
     m_contentlength = 0;                                    // If Content-Length is known, count it
     m_curSample = 0;
     m_metaint = 0;                                          // No metaint yet
@@ -373,20 +410,30 @@ void Audio::setConnectionTimeout(uint16_t timeout_ms, uint16_t timeout_ms_ssl){
     if(timeout_ms_ssl) m_timeout_ms_ssl = timeout_ms_ssl;
 }
 
-void Audio::connectTask(void* pvParams) {
-  ConnectParams* params = static_cast<ConnectParams*>(pvParams);
-  Audio* self = params->instance;
-  if(self->_client){
-    self->_connectionResult = self->_client->connect(params->hostwoext, params->port/*, self->m_f_ssl ? self->m_timeout_ms_ssl : self->m_timeout_ms*/);
-  }else{
-    self->_connectionResult = false;
-  }
-  free((void*)params->hostwoext);
-  delete params;
-  self->_connectTaskHandle = nullptr;
-  vTaskDelete(nullptr);
+bool Audio::connectClient(const char* host, uint16_t port) {
+    // DNS and TCP in the connect task (core/connector.h), TLS here, both end at connector.cancel() (a new station, stop)
+    uint32_t gen;
+    int fd = connector.open(host, port, m_timeout_ms, &gen, xfadeIdle, this); // a crossfade plays on while it waits
+    m_connGen = gen;
+    if(fd < 0) return false;
+    if(!m_f_ssl){
+        client = WiFiClient(fd);
+    }
+    else{
+        uint32_t t = millis();
+        if(!clientsecure.attach(fd, host, port, m_timeout_ms_ssl, gen)){
+            connector.fail(CN_TLS, connector.cancelled(gen));
+            return false;
+        }
+        connector.stage(CN_TLS, millis() - t);
+    }
+    m_connDone = millis();
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::connectCancelled() {
+    return connector.cancelledByUser(m_connGen);
 }
-
 //---------------------------------------------------------------------------------------------------------------------
  ModbusHandler MH;
  Player playerID;
@@ -401,6 +448,29 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
         return false;
     }
 
+#if STREAM_CACHE
+    if(!m_f_follow){                                // a station, not a playlist entry, a redirect or a reconnect
+        if(m_scStation) free(m_scStation);
+        m_scStation = strdup(host);
+        m_scHit = m_scStation && streamCache.lookup(m_scStation, &m_scInfo);
+        if(m_scHit && m_scInfo.url[0]) host = m_scInfo.url; // the stream behind the playlist or redirect
+        m_zapCached = m_scHit;
+    }
+#endif
+    if(!m_f_follow && !m_f_mirrorsKeep) mirrorsSet(host, NULL); // a station without mirrors
+    bool station = !m_f_follow;                     // not a playlist entry, a redirect or a reconnect
+    m_f_follow = false;
+    m_f_mirrorsKeep = false;
+    if(m_raceFd >= 0) {close(m_raceFd); m_raceFd = -1;}
+
+    int raced = -1;                                 // mirrorRace(): winner, -1: no race, -2: none has answered
+#if MIRROR_RACE > 1
+    if(!m_scHit && m_mirrorIdx + 1u < m_mirrors.size() && !user[0] && !pwd[0] && sameUrl(host, m_mirrors[m_mirrorIdx])){
+        raced = mirrorRace();
+        if(raced >= 0) {m_mirrorIdx = raced; host = m_mirrors[raced];}
+    }
+#endif
+
     uint16_t lenHost = strlen(host);
 
     if(lenHost >= 512 - 10) {
@@ -454,7 +524,8 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
     
     AUDIO_INFO("Connect to new host: \"%s\"", l_host);
 
-    setDefaults(); // no need to stop clients if connection is established (default is true)
+    if(station) xfadeBegin();                       // the station that is played fades out while this one starts
+    setDefaults(true); // no need to stop clients if connection is established (default is true)
 
     if(startsWith(l_host, "https")) m_f_ssl = true;
     else                            m_f_ssl = false;
@@ -501,47 +572,90 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
     if(m_f_ssl){ _client = static_cast<WiFiClient*>(&clientsecure); if(port == 80) port = 443;}
     else       { _client = static_cast<WiFiClient*>(&client);}
 
+    WiFiClient* warm = NULL;
+#if ZAP_PREFETCH
+    if(!auth) warm = prefetch.take(l_host, rqh);    // connected by the prefetcher, the request is sent
+#endif
+    m_zapWarm = (warm != NULL);
+
     uint32_t t = millis();
     if(m_f_Log) AUDIO_INFO("connect to %s on port %d path %s", hostwoext, port, extension);
-    if(!config.store.watchdog){
-      res = _client->connect(hostwoext, port, m_f_ssl ? m_timeout_ms_ssl : m_timeout_ms);
+    if(warm){
+      _client = warm;
+      m_connGen = connector.claim();               // a cancel() of this station is seen while the header is awaited
+    }else if(raced >= 0){
+      client = WiFiClient(m_raceFd);               // connected by mirrorRace(), the request is sent
+      m_raceFd = -1;
+    }else if(raced == -2){
+      res = false;
     }else{
-      ConnectParams* params = new ConnectParams{ strdup(hostwoext), port, this }; _connectionResult = false;
-      xTaskCreatePinnedToCore(connectTask, "ConnectTask", WATCHDOG_TASK_SIZE, params, WATCHDOG_TASK_PRIORITY, &_connectTaskHandle, WATCHDOG_TASK_CORE_ID);
-      for(;;){
-        if(millis()-t>(m_f_ssl ? m_timeout_ms_ssl : m_timeout_ms) || _connectionResult) break;
-        vTaskDelay(10);
-      }
-      res = _connectionResult;
-      if (_connectTaskHandle!=nullptr) {
-        vTaskDelete(_connectTaskHandle);
-        _connectTaskHandle = nullptr;
-        AUDIO_INFO("WATCH DOG HAS FINISHED A WORK, BYE!");
-      }
+      res = connectClient(hostwoext, port);
     }
     if(res){
         uint32_t dt = millis() - t;
         strcpy(m_lastHost, l_host);
+        if(warm) m_connHost[0] = '\0';              // client and clientsecure are not connected
+        else snprintf(m_connHost, sizeof(m_connHost), "%s:%u", hostwoext, port);
         AUDIO_INFO("%s has been established in %u ms, free Heap: %u bytes",
-                    m_f_ssl?"SSL":"Connection", dt, ESP.getFreeHeap());
+                    warm?"Warm connection":m_f_ssl?"SSL":"Connection", dt, ESP.getFreeHeap());
         m_f_running = true;
     }
 
     m_expectedCodec = CODEC_NONE;
     m_expectedPlsFmt = FORMAT_NONE;
 
+    if(!res && connectCancelled()){                 // a new station or stop: no retry, the player goes on with it
+        AUDIO_INFO("connect to %s cancelled", l_host);
+        m_lastHost[0] = 0;
+        if(hostwoext) {free(hostwoext); hostwoext = NULL;}
+        if(extension) {free(extension); extension = NULL;}
+        if(h_host   ) {free(h_host);    h_host    = NULL;}
+        if(l_host   ) {free(l_host);    l_host    = NULL;}
+        return false;
+    }
+#if STREAM_CACHE
+    if(!res && m_scHit){
+        if(hostwoext) {free(hostwoext); hostwoext = NULL;}
+        if(extension) {free(extension); extension = NULL;}
+        if(h_host   ) {free(h_host);    h_host    = NULL;}
+        if(l_host   ) {free(l_host);    l_host    = NULL;}
+        return streamCacheRetry();
+    }
+#endif
+    if(!res && mirrorFailover(false)){
+        if(hostwoext) {free(hostwoext); hostwoext = NULL;}
+        if(extension) {free(extension); extension = NULL;}
+        if(h_host   ) {free(h_host);    h_host    = NULL;}
+        if(l_host   ) {free(l_host);    l_host    = NULL;}
+        return connecttoRedirect(m_mirrors[m_mirrorIdx]);
+    }
     if(res){
-        _client->print(rqh);
+        if(!warm && raced < 0) _client->print(rqh);
+#if STREAM_CACHE
+        if(m_scHit && m_scInfo.codec != CODEC_NONE){
+            // known stream: decoder and output rate are set up while the server answers, content-type is checked later
+            m_codec = m_scInfo.codec;
+            if(initializeDecoder()) {
+                setChannels(m_scInfo.channels);
+                setSampleRate(m_scInfo.sampleRate);
+            }
+        }
+#endif
 
         if(endsWith(extension, ".mp3"))   m_expectedCodec = CODEC_MP3;
         if(endsWith(extension, ".aac"))   m_expectedCodec = CODEC_AAC;
         if(endsWith(extension, ".wav"))   m_expectedCodec = CODEC_WAV;
         if(endsWith(extension, ".m4a"))   m_expectedCodec = CODEC_M4A;
         if(endsWith(extension, ".flac"))  m_expectedCodec = CODEC_FLAC;
+        if(endsWith(extension, ".opus"))  m_expectedCodec = CODEC_OGG;
+        if(endsWith(extension, ".ogg"))   m_expectedCodec = CODEC_OGG;
         if(endsWith(extension, ".asx"))  m_expectedPlsFmt = FORMAT_ASX;
         if(endsWith(extension, ".m3u"))  m_expectedPlsFmt = FORMAT_M3U;
         if(endsWith(extension, ".m3u8")) m_expectedPlsFmt = FORMAT_M3U8;
         if(endsWith(extension, ".pls"))  m_expectedPlsFmt = FORMAT_PLS;
+#if STREAM_CACHE
+        if(m_scHit && m_expectedCodec == CODEC_NONE) m_expectedCodec = m_scInfo.codec; // for text/plain and the like
+#endif
 
         setDatamode(HTTP_RESPONSE_HEADER);   // Handle header
         m_streamType = ST_WEBSTREAM;
@@ -563,8 +677,189 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
     return res;
 }
 //---------------------------------------------------------------------------------------------------------------------
-bool Audio::httpPrint(const char* host) {
+bool Audio::connecttoRedirect(const char* host) {
+    // playlist entry, http redirect or reconnect of the station that is played, the stream cache key stays
+    m_f_follow = true;
+    return connecttohost(host);
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::connecttoMirrors(const char* host, const char* mirrors) {
+    mirrorsSet(host, mirrors);
+    m_f_mirrorsKeep = true;
+    return connecttohost(host);
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::sameUrl(const char* host, const char* url) {
+    // host as given to connecttohost(), url with http:// or https://
+    const char* h = strstr(host, "http");
+    if(h) return strcmp(h, url) == 0;
+    return startsWith(url, "http://") && strcmp(url + 7, host) == 0;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::mirrorsAdd(std::vector<char*>& vec, const char* url, size_t len) {
+    while(len && *url == ' ') {url++; len--;}
+    while(len && url[len - 1] == ' ') len--;
+    if(!len || len >= 512 - 10 || vec.size() >= MIRRORS_MAX) return;
+    bool scheme = len >= 4 && strncmp(url, "http", 4) == 0;
+    char* u = (char*)malloc(len + 8);
+    if(!u) return;
+    if(scheme) u[0] = '\0';
+    else       strcpy(u, "http://");
+    strncat(u, url, len);
+    vec.push_back(u);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::mirrorsSet(const char* host, const char* mirrors) {
+    // a new station, host first, then the mirrors "url|url|.."
+    vector_clear_and_shrink(m_mirrors);
+    m_mirrorIdx = 0;
+    m_mirrorTries = 0;
+    if(!mirrors || !mirrors[0]) return;                 // one url, nothing to race or to fail over to
+    mirrorsAdd(m_mirrors, host, strlen(host));
+    while(*mirrors){
+        size_t n = strcspn(mirrors, "|");
+        mirrorsAdd(m_mirrors, mirrors, n);
+        mirrors += n;
+        if(*mirrors) mirrors++;
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::mirrorsFromPlaylist(std::vector<char*>& urls) {
+    // the entries of a pls/m3u are mirrors of the stream, the mirrors of the station behind the one in use follow them
+    for(size_t i = 0; i < m_mirrors.size(); i++){
+        if(i > m_mirrorIdx && urls.size() < MIRRORS_MAX) urls.push_back(m_mirrors[i]);
+        else free(m_mirrors[i]);
+    }
+    m_mirrors.swap(urls);
+    urls.clear();
+    m_mirrorIdx = 0;
+    m_mirrorTries = 0;                                  // a new list
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::mirrorFailover(bool rotate) {
+    // the mirror in use has failed, the next one; rotate (stall): the list starts over, the first one may be back
+    if(m_mirrors.size() < 2) return false;
+    if(!rotate && m_mirrorTries + 1u >= m_mirrors.size()) return false;   // all of them have failed
+    if(m_mirrorTries < UINT8_MAX) m_mirrorTries++;
+    m_mirrorIdx = (m_mirrorIdx + 1) % m_mirrors.size();
+    m_stats.mirrorFailovers++;
+    AUDIO_INFO("fail over to mirror %u of %u: \"%s\"", m_mirrorIdx + 1, m_mirrors.size(), m_mirrors[m_mirrorIdx]);
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+int Audio::mirrorRace() {
+    // The plain http mirrors from m_mirrorIdx on (MIRROR_RACE of them, up to the next https one, TLS is not raced) are
+    // connected in parallel and get the request of connecttohost(), the first good status line wins (see net/race.h).
+    // Return: index of the winner (m_raceFd), -1: no race, -2: none has answered, m_mirrorIdx is the last of them,
+    // or connector.cancel()
+    raceConn_t r[MIRROR_RACE];
+    uint8_t idx[MIRROR_RACE];
+    uint8_t n = 0;
+    for(uint8_t i = m_mirrorIdx; i < m_mirrors.size() && n < MIRROR_RACE; i++){
+        if(startsWith(m_mirrors[i], "https")) break;
+        const char* h = m_mirrors[i] + 7;
+        int16_t pos_slash = indexOf(h, "/", 0);
+        int16_t pos_colon = indexOf(h, ":", 0);
+        if(pos_colon >= 0 && isalpha(h[pos_colon + 1])) pos_colon = -1;
+        int16_t pos_ampersand = indexOf(h, "&", 0);
+        uint16_t hlen = pos_slash > 1 ? pos_slash : strlen(h);
+        uint16_t port = 80;
+        if(pos_colon >= 0 && pos_colon < hlen && (pos_ampersand == -1 || pos_ampersand > pos_colon)){
+            port = atoi(h + pos_colon + 1);
+            hlen = pos_colon;
+        }
+        char host[hlen + 1];
+        memcpy(host, h, hlen);
+        host[hlen] = '\0';
+        const char* path = pos_slash > 1 ? h + pos_slash : "/";
+        uint16_t extLen = urlencode_expected_len(path);
+        char* rqh = (char*)malloc(extLen + hlen + 160);
+        if(!rqh) continue;
+        memcpy(rqh, "GET ", 4);
+        memcpy(rqh + 4, path, strlen(path) + 1);
+        urlencode(rqh + 4, extLen, true);
+        sprintf(rqh + strlen(rqh), " HTTP/1.1\r\nHost: %s\r\nIcy-MetaData:1\r\nAccept-Encoding: identity;q=1,*;q=0\r\n"
+                "User-Agent: Mozilla/5.0\r\nConnection: keep-alive\r\n\r\n", host);
+        IPAddress ip;
+#if DNS_CACHE
+        bool ok = dnsCache.resolve(host, ip);
+#else
+        bool ok = WiFi.hostByName(host, ip) == 1;
+#endif
+        int fd = ok ? RACE_Connect((uint32_t)ip, port) : -1;
+        if(fd < 0) {free(rqh); continue;}
+        r[n].fd = fd; r[n].sent = false; r[n].rqh = rqh;
+        idx[n] = i;
+        n++;
+    }
+    int win = -1;
+    if(n > 1){
+        m_stats.mirrorRaces++;
+        m_connGen = connector.claim();              // connector.cancel() ends the race as it ends connectClient()
+        win = RACE_Run(r, n, m_timeout_ms, [](void* a) {return connector.cancelled(((Audio*)a)->m_connGen);}, this);
+    }
+    for(uint8_t k = 0; k < n; k++){
+        if(r[k].fd >= 0 && (int)k != win) close(r[k].fd);
+        free((char*)r[k].rqh);
+    }
+    if(n < 2) return -1;
+    if(win < 0 && connectCancelled()) return -2;
+    if(win < 0) {
+        AUDIO_INFO("mirror race: no answer from %u mirrors", n);
+        m_mirrorTries += n - 1;                         // mirrorFailover() goes on behind them
+        m_mirrorIdx = idx[n - 1];
+        return -2;
+    }
+    int fd = r[win].fd;
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    m_raceFd = fd;
+    if(idx[win] != m_mirrorIdx) m_stats.mirrorRaceWins++;
+    AUDIO_INFO("mirror race: %u of %u has won", idx[win] + 1, m_mirrors.size());
+    return idx[win];
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::streamCacheStore() {
+    // first decoded frame of a web stream: the stream behind playlists and redirects and its format for the next start
+#if STREAM_CACHE
+    m_scHit = false;
+    if(!m_scStation || getDatamode() == AUDIO_LOCALFILE || m_playlistFormat == FORMAT_M3U8) return;
+    streamInfo_t si = {};
+    if(!sameUrl(m_scStation, m_lastHost)){
+        if(strlen(m_lastHost) >= SC_URL_LEN) return;
+        strcpy(si.url, m_lastHost);
+    }
+    si.codec = m_codec;
+    si.sampleRate = getSampleRate();
+    si.channels = getChannels();
+    si.metaint = m_metaint;
+    streamCache.store(m_scStation, si);
+#endif
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::streamCacheRetry() {
+    // the cached stream has failed: the entry is dropped and the station is resolved again, once
+#if STREAM_CACHE
+    if(!m_scHit || !m_scStation) return false;
+    m_scHit = false;
+    AUDIO_INFO("cached stream failed, resolve \"%s\" again", m_scStation);
+    streamCache.invalidate(m_scStation);
+    char* station = strdup(m_scStation);
+    if(!station) return false;
+    m_f_mirrorsKeep = true;
+    bool res = connecttohost(station);
+    free(station);
+    return res;
+#else
+    return false;
+#endif
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::httpPrint(const char* host, bool pipeline) {
     // user and pwd for authentification only, can be empty
+    // pipeline: the request is sent behind the response that is read now, on the same keep-alive connection only,
+    // the datamode is not changed (see hlsTakePending())
 
     if(host == NULL) {
         AUDIO_INFO("Hostaddress is empty");
@@ -608,6 +903,10 @@ bool Audio::httpPrint(const char* host) {
         hostwoext[pos_colon] = '\0';// Host without portnumber
     }
 
+    if(m_f_ssl && port == 80) port = 443;
+    char connHost[sizeof(m_connHost)];
+    snprintf(connHost, sizeof(connHost), "%s:%u", hostwoext, port);
+
     AUDIO_INFO("new request: \"%s\"", host);
 
     char rqh[strlen(h_host) + 200]; // http request header
@@ -623,33 +922,58 @@ bool Audio::httpPrint(const char* host) {
     strcat(rqh, "User-Agent: Mozilla/5.0\r\n");
     strcat(rqh, "Connection: keep-alive\r\n\r\n");
 
-    if(m_f_ssl){ _client = static_cast<WiFiClient*>(&clientsecure); if(port == 80) port = 443;}
-    else       { _client = static_cast<WiFiClient*>(&client);}
-
-    if(!_client->connected()){
-        AUDIO_INFO("The host has disconnected, reconnecting");
-        if(!_client->connect(hostwoext, port)){
-            log_e("connection lost");
-            stopSong();
-            return false;
+    bool res = true;
+    if(pipeline){
+        res = _client->connected() && strcmp(connHost, m_connHost) == 0 && _client->print(rqh) == strlen(rqh);
+    }
+    else{
+        if(m_f_ssl){ _client = static_cast<WiFiClient*>(&clientsecure);}
+        else       { _client = static_cast<WiFiClient*>(&client);}
+
+        if(m_hlsPending == HLS_SEGMENT || m_hlsPending == HLS_PLAYLIST || strcmp(connHost, m_connHost) != 0){
+            _client->stop();                        // a response is still in flight or it is an other host
+        }
+        m_hlsPending = HLS_NONE;
+        if(!_client->connected()){
+            AUDIO_INFO("The host has disconnected, reconnecting");
+            m_connHost[0] = '\0';
+            if(!connectClient(hostwoext, port)){
+                log_e("connection lost");
+                if(hostwoext) {free(hostwoext); hostwoext = NULL;}
+                if(extension) {free(extension); extension = NULL;}
+                if(h_host   ) {free(h_host);    h_host    = NULL;}
+                stopSong();
+                return false;
+            }
+            strcpy(m_connHost, connHost);
         }
+        _client->print(rqh);
+    }
+    if(!res){
+        if(hostwoext) {free(hostwoext); hostwoext = NULL;}
+        if(extension) {free(extension); extension = NULL;}
+        if(h_host   ) {free(h_host);    h_host    = NULL;}
+        return false;
     }
-    _client->print(rqh);
 
     if(endsWith(extension, ".mp3"))   m_expectedCodec = CODEC_MP3;
     if(endsWith(extension, ".aac"))   m_expectedCodec = CODEC_AAC;
     if(endsWith(extension, ".wav"))   m_expectedCodec = CODEC_WAV;
     if(endsWith(extension, ".m4a"))   m_expectedCodec = CODEC_M4A;
     if(endsWith(extension, ".flac"))  m_expectedCodec = CODEC_FLAC;
+    if(endsWith(extension, ".opus"))  m_expectedCodec = CODEC_OGG;
+    if(endsWith(extension, ".ogg"))   m_expectedCodec = CODEC_OGG;
     if(endsWith(extension, ".asx"))  m_expectedPlsFmt = FORMAT_ASX;
     if(endsWith(extension, ".m3u"))  m_expectedPlsFmt = FORMAT_M3U;
     if(endsWith(extension, ".m3u8")) m_expectedPlsFmt = FORMAT_M3U8;
     if(endsWith(extension, ".pls"))  m_expectedPlsFmt = FORMAT_PLS;
 
-    setDatamode(HTTP_RESPONSE_HEADER);   // Handle header
-    m_streamType = ST_WEBSTREAM;
-    m_contentlength = 0;
-    m_f_chunked = false;
+    if(!pipeline){
+        setDatamode(HTTP_RESPONSE_HEADER);   // Handle header
+        m_streamType = ST_WEBSTREAM;
+        m_contentlength = 0;
+        m_f_chunked = false;
+    }
 
     if(hostwoext) {free(hostwoext); hostwoext = NULL;}
     if(extension) {free(extension); extension = NULL;}
@@ -719,7 +1043,8 @@ bool Audio::connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos) {
 
     m_resumeFilePos = resumeFilePos;
     char audioName[256];
-    setDefaults(); // free buffers an set defaults
+    xfadeBegin();  // the track that is played fades out
+    setDefaults(true); // free buffers an set defaults
     memcpy(audioName, path, strlen(path)+1);
     if(audioName[0] != '/'){
         for(int i = 255; i > 0; i--){
@@ -777,6 +1102,10 @@ bool Audio::connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos) {
       m_codec = CODEC_FLAC;
       if(audio_info) audio_info("format is flac");
     }
+    if(endsWith(afn, ".ogg") || endsWith(afn, ".opus")) {
+      m_codec = CODEC_OGG;
+      if(audio_info) audio_info("format is ogg");
+    }
 
     if(m_codec == CODEC_NONE) {
       AUDIO_INFO("The %s format is not supported", afn + dotPos);
@@ -1224,6 +1553,15 @@ size_t Audio::readAudioHeader(uint32_t bytes){
             eofHeader = true;
         }
     }
+    if(m_codec == CODEC_OGG || m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS){
+        int res = read_OGG_Header(InBuff.getReadPtr(), bytes);
+        if(res >= 0) bytesReaded = res;
+        else{ // error, skip header
+            stopSong();
+            m_controlCounter = 100;
+            eofHeader = true;
+        }
+    }
     if(!isRunning()){
         log_e("Processing stopped due to invalid audio header");
         return 0;
@@ -2074,9 +2412,8 @@ int Audio::read_M4A_Header(uint8_t *data, size_t len) {
 }
 //---------------------------------------------------------------------------------------------------------------------
 int Audio::read_OGG_Header(uint8_t *data, size_t len){
+    // the BOS page tells the codec, the headers of the codec are packets for the decoder, see container/ogg.h
     static size_t retvalue = 0;
-    static size_t pageLen = 0;
-    static bool   f_firstPacket = false;
 
     if(retvalue) {
         if(retvalue > len) { // if returnvalue > bufferfillsize
@@ -2095,7 +2432,6 @@ int Audio::read_OGG_Header(uint8_t *data, size_t len){
     if(m_controlCounter == OGG_BEGIN) {  // init
         retvalue = 0;
         m_audioDataStart = 0;
-        f_firstPacket = true;
         m_controlCounter = OGG_MAGIC;
         if(getDatamode() == AUDIO_LOCALFILE){
             m_contentlength = getFileSize();
@@ -2104,171 +2440,54 @@ int Audio::read_OGG_Header(uint8_t *data, size_t len){
         return 0;
     }
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(m_controlCounter == OGG_MAGIC) { /* check MAGIC STRING */
+    if(m_controlCounter == OGG_MAGIC) { /* check MAGIC STRING and BOS page */
         if(specialIndexOf(data, "OggS", 10) != 0) {
             log_e("Magic String 'OggS' not found in header");
             stopSong();
             return -1;
         }
-        m_controlCounter = OGG_HEADER;
-        retvalue = 4;
-        return 0;
-    }
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(m_controlCounter == OGG_HEADER) { /* check OGG PAGE HEADER */
-        uint8_t i = 0;
-        uint8_t ssv = *(data + i);                  // stream_structure_version
-        (void)ssv;
-        i++;
-        uint8_t htf = *(data + i);                  // header_type_flag
-        (void)htf;
-        i++;
-        uint32_t tmp = bigEndian(data + i, 4);      // absolute granule position
-        uint64_t agp = (uint64_t) tmp << 32;
-        i += 4;
-        agp += bigEndian(data + i, 4);
-        i += 4;
-        uint32_t ssnr = bigEndian(data + i, 4);     // stream serial number
-        (void)ssnr;
-        i += 4;
-        uint32_t psnr = bigEndian(data + i, 4);     // page sequence no
-        (void)psnr;
-        i += 4;
-        uint32_t pchk = bigEndian(data + i, 4);     // page checksum
-        (void)pchk;
-        i += 4;
-        uint8_t psegm = *(data + i);
-        i++;
-        uint8_t psegmBuff[256];
-        pageLen = 0;
-        for(uint8_t j = 0; j < psegm; j++){
-            psegmBuff[j] = *(data + i);
-            pageLen += psegmBuff[j];
-            i++;
-        }
-        retvalue = i;
-        if(agp == 0){
-            if(f_firstPacket == true){
-                f_firstPacket = false;
-                m_controlCounter = OGG_FIRST; // ogg first pages
-            }
-            else{
-                retvalue += pageLen;
-                m_controlCounter = OGG_MAGIC;
-            }
-        }
-        else{
-            if(m_codec == CODEC_OGG_FLAC){
-                m_controlCounter = OGG_AMRDY;
-            }
-            else {
-                AUDIO_INFO("unknown format");
-                stopSong();
-                return -1;
+        oggPage_t page;
+        int n = OGG_ParsePage(&page, data, len);
+        if(n <= 0) return 0; // wait for the segment table
+        const oggCodec_t* c = OGG_Probe(&m_ogg, data, len);
+        if(!c){
+            if(page.flags & 0x02){ // BOS
+                if(n + page.bodyLen > len && n + page.bodyLen <= InBuff.getMaxBlockSize()) return 0; // wait for the packet
+                retvalue = n + page.bodyLen; // e.g. Skeleton
+                return 0;
             }
-        }
-        return 0;
-    }
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(m_controlCounter == OGG_FIRST) { /* check OGG FIRST PAGES (has no streaming content) */
-        uint8_t i = 0;
-        uint8_t obp = *(data + i);                  // oneBytePacket shold be 0x7F
-        (void)obp;
-        i++;
-        if(specialIndexOf(data + i, "FLAC", 10) == 0){
-        }
-        else{
-            log_e("ogg/flac support only"); // ogg/vorbis or ogg//opus not supported yet
+            log_e("ogg/flac, ogg/opus and ogg/vorbis support only");
             stopSong();
             return -1;
         }
-        i += 4;
-        uint8_t major_vers = *(data + i);
-        (void)major_vers;
-        i++;
-        uint8_t minor_vers = *(data + i);
-        (void)minor_vers;
-        i++;
-        uint16_t nonah = bigEndian(data + i, 2); // number of non audio headers (0x00 = unknown)
-        (void)nonah;
-        i += 2;
-        if(specialIndexOf(data + i, "fLaC", 10) == 0){
-            m_codec = CODEC_OGG_FLAC;
-        }
-        i += 4;
-        // STREAMINFO metadata block begins
-        uint32_t mblen = bigEndian(data + i, 4);
-        (void)mblen;
-        i += 4; // skip metadata block header + length
-        i += 2; // skip minimun block size
-        m_flacMaxBlockSize = bigEndian(data + i, 2);
-        i += 2;
-        vTaskDelay(2);
-        AUDIO_INFO("FLAC maxBlockSize: %u", m_flacMaxBlockSize);
-        i += 3; // skip minimun frame size
-        vTaskDelay(2);
-        m_flacMaxFrameSize = bigEndian(data + i, 3);
-        i += 3;
-        if(m_flacMaxFrameSize){
-            AUDIO_INFO("FLAC maxFrameSize: %u", m_flacMaxFrameSize);
-        }
-        else {
-            AUDIO_INFO("FLAC maxFrameSize: N/A");
-        }
-        if(m_flacMaxFrameSize > InBuff.getMaxBlockSize()) {
-            log_e("FLAC maxFrameSize too large!");
-            stopSong();
-            return -1;
-        }
-        vTaskDelay(2);
-        uint32_t nextval = bigEndian(data + i, 3);
-        i += 3;
-        m_flacSampleRate = nextval >> 4;
-        AUDIO_INFO("FLAC sampleRate: %u", m_flacSampleRate);
-        vTaskDelay(2);
-        m_flacNumChannels = ((nextval & 0x06) >> 1) + 1;
-        AUDIO_INFO("FLAC numChannels: %u", m_flacNumChannels);
-        if(m_flacNumChannels != 1 && m_flacNumChannels != 2){
-            vTaskDelay(2);
-            AUDIO_INFO("numChannels must be 1 or 2");
-            stopSong();
-            return -1;
-        }
-        vTaskDelay(2);
-        uint8_t bps = (nextval & 0x01) << 4;
-        bps += (*(data +i) >> 4) + 1;
-        i++;
-        m_flacBitsPerSample = bps;
-        if((bps != 8) && (bps != 16)){
-            log_e("bits per sample must be 8 or 16, is %i", bps);
-            stopSong();
-            return -1;
-        }
-        AUDIO_INFO("FLAC bitsPerSample: %u", m_flacBitsPerSample);
-        m_flacTotalSamplesInStream = bigEndian(data + i, 4);
-        i++;
-        if(m_flacTotalSamplesInStream) {
-            AUDIO_INFO("total samples in stream: %u", m_flacTotalSamplesInStream);
-        }
-        else {
-            AUDIO_INFO("total samples in stream: N/A");
-        }
-        if(bps != 0 && m_flacTotalSamplesInStream) {
-            AUDIO_INFO("audio file duration: %u seconds", m_flacTotalSamplesInStream / m_flacSampleRate);
-        }
-        m_controlCounter = OGG_MAGIC;
-        retvalue = pageLen;
+        m_codec = c->id;
+        m_controlCounter = OGG_AMRDY; // the decoder gets the headers from this page on
         return 0;
     }
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(m_controlCounter == OGG_AMRDY){ // ogg almost ready
-        if(!psramFound()){
-            AUDIO_INFO("FLAC works only with PSRAM!");
-            m_f_running = false; stopSong();
-            return -1;
+        const oggCodec_t* c = OGG_Probe(&m_ogg, data, len);
+        if(m_codec == CODEC_OGG_FLAC){
+            if(!psramFound()){
+                AUDIO_INFO("FLAC works only with PSRAM!");
+                m_f_running = false; stopSong();
+                return -1;
+            }
+            if(!FLACDecoder_AllocateBuffers()) {m_f_running = false; stopSong(); return -1;}
+            InBuff.changeMaxBlockSize(m_frameSizeFLAC);
+            AUDIO_INFO("FLACDecoder has been initialized, free Heap: %u bytes", ESP.getFreeHeap());
+        }
+        if(m_codec == CODEC_OGG_OPUS){
+            if(!OPUSDecoder_AllocateBuffers()) {m_f_running = false; stopSong(); return -1;}
+            InBuff.changeMaxBlockSize(m_frameSizeOPUS);
+            AUDIO_INFO("OPUSDecoder has been initialized, free Heap: %u bytes", ESP.getFreeHeap());
+        }
+        if(m_codec == CODEC_OGG_VORBIS){
+            if(!VORBISDecoder_AllocateBuffers()) {m_f_running = false; stopSong(); return -1;}
+            InBuff.changeMaxBlockSize(m_frameSizeVORBIS);
+            AUDIO_INFO("VORBISDecoder has been initialized, free Heap: %u bytes", ESP.getFreeHeap());
         }
-        if(!FLACDecoder_AllocateBuffers()) {m_f_running = false; stopSong(); return -1;}
-        InBuff.changeMaxBlockSize(m_frameSizeFLAC);
-        AUDIO_INFO("FLACDecoder has been initialized, free Heap: %u bytes", ESP.getFreeHeap());
+        if(!c || !OGG_AllocateBuffers(&m_ogg, c)) {m_f_running = false; stopSong(); return -1;}
 
         m_controlCounter = OGG_OKAY; // 100
         eofHeader = true;
@@ -2326,8 +2545,9 @@ size_t Audio::process_m3u8_ID3_Header(uint8_t* packet){
     return id3Size;
 }
 //---------------------------------------------------------------------------------------------------------------------
-uint32_t Audio::stopSong() {
+uint32_t Audio::stopSong(bool keepFade) {
     uint32_t pos = 0;
+    if(!keepFade) xfadeEnd(false);
     if(m_f_running) {
         m_f_running = false;
         if(getDatamode() == AUDIO_LOCALFILE){
@@ -2344,7 +2564,7 @@ uint32_t Audio::stopSong() {
         log_w("Closing audio file");  // for debug
     }
     memset(m_outBuff, 0, sizeof(m_outBuff));     //Clear OutputBuffer
-    i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
+    if(m_xfSrc.codec == CODEC_NONE) flushI2S();  // else the ring holds the fading stream
     return pos;
 }
 //---------------------------------------------------------------------------------------------------------------------
@@ -2358,6 +2578,7 @@ void Audio::playI2Sremains() { // returns true if all dma_buffs flushed
     while(m_validSamples) {
         playChunk();
     }
+    if(!m_outTaskHandle) flushI2Stail();           // else the output task sends it when the ring runs dry
     return;
 }
 //---------------------------------------------------------------------------------------------------------------------
@@ -2368,166 +2589,662 @@ bool Audio::pauseResume() {
         retVal = true;
         if(!m_f_running) {
             memset(m_outBuff, 0, sizeof(m_outBuff));               //Clear OutputBuffer
-            i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
+            flushI2S();
         }
     }
     return retVal;
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::playChunk() {
-    // If we've got data, try and pump it out..
-    int16_t sample[2];
+    // Converts the decoded frame in m_outBuff block by block into I2S frames, every block is handed to the DMA
+    // with a single i2s_write(). 8 bit samples are packed as two bytes in one int16_t of m_outBuff
+    if(getBitsPerSample() != 8 && getBitsPerSample() != 16) {
+        log_e("BitsPer Sample must be 8 or 16!");
+        m_validSamples = 0;
+        stopSong();
+        return false;
+    }
+    bool ret = true;
+    if(m_zapStart && m_validSamples) {  // first decoded frames after a station change
+        uint32_t ms = millis() - m_zapStart;
+        m_zapStart = 0;
+        m_stats.zaps++;
+        if(m_zapWarm) m_stats.warmZaps++;
+        if(m_zapCached) {m_stats.cachedZaps++; m_stats.cachedZapSumMs += ms;}
+        m_stats.zapMs = ms;
+        m_stats.zapSumMs += ms;
+        if(ms > m_stats.zapMaxMs) m_stats.zapMaxMs = ms;
+        m_stats.zapWarm = m_zapWarm;
+        AUDIO_INFO("first audio after %u ms (%s%s)", ms, m_zapCached ? "stream cache" : "resolved", m_zapWarm ? ", warm" : "");
+    }
+    if(m_outTaskHandle) {   // output task: hand the frames over, wait while the ring is full
+        while(true) {
+            uint16_t frames = nextI2Sblock(m_pcmBlock);
+            if(!frames) break;
+            const uint32_t* src = (const uint32_t*)m_pcmBlock;
+            while(frames) {
+                size_t n = m_ring.write(src, frames);
+                src += n;
+                frames -= n;
+                if(frames) vTaskDelay(1);
+            }
+        }
+        m_curSample = 0;
+        return ret;
+    }
+    while(true) {
+        uint32_t t = ESP.getCycleCount();
+        uint16_t frames = nextI2Sblock(m_i2sBlock);
+        if(!frames) break;
+        processI2Sblock(frames);
+        m_stats.dspCycles += ESP.getCycleCount() - t;
+        if(!writeI2Sblock(frames)) {
+            log_e("can't send");
+            ret = false;
+        }
+    }
+    m_curSample = 0;
+    return ret;
+}
+//---------------------------------------------------------------------------------------------------------------------
+uint16_t Audio::fillI2Sblock(int16_t* dst) {
+    // unpack up to I2S_BLOCK_FRAMES frames from m_outBuff into dst (interleaved L/R, signed 16 bit)
+    uint16_t frames = 0;
+
     if(getBitsPerSample() == 8) {
-        if(getChannels() == 1) {
-            while(m_validSamples) {
-                uint8_t x =  m_outBuff[m_curSample] & 0x00FF;
-                uint8_t y = (m_outBuff[m_curSample] & 0xFF00) >> 8;
-                sample[LEFTCHANNEL]  = x;
-                sample[RIGHTCHANNEL] = x;
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
-                sample[LEFTCHANNEL]  = y;
-                sample[RIGHTCHANNEL] = y;
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
+        if(getChannels() == 1) {     // two mono samples in one word
+            while(m_validSamples && frames + 2 <= I2S_BLOCK_FRAMES) {
+                int16_t x = ((m_outBuff[m_curSample] & 0x00FF) - 128) << 8;
+                int16_t y = (((m_outBuff[m_curSample] & 0xFF00) >> 8) - 128) << 8;
+                *dst++ = x; *dst++ = x;
+                *dst++ = y; *dst++ = y;
+                frames += 2;
                 m_validSamples--;
                 m_curSample++;
             }
         }
-        if(getChannels() == 2) {
-            while(m_validSamples) {
+        else {                       // left in the low byte, right in the high byte
+            while(m_validSamples && frames < I2S_BLOCK_FRAMES) {
                 uint8_t x =  m_outBuff[m_curSample] & 0x00FF;
                 uint8_t y = (m_outBuff[m_curSample] & 0xFF00) >> 8;
-                if(!m_f_forceMono) { // stereo mode
-                    sample[LEFTCHANNEL]  = x;
-                    sample[RIGHTCHANNEL] = y;
-                }
-                else { // force mono
-                    uint8_t xy = (x + y) / 2;
-                    sample[LEFTCHANNEL]  = xy;
-                    sample[RIGHTCHANNEL] = xy;
-                }
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
+                if(m_f_forceMono) {x = (x + y) / 2; y = x;} // #100
+                *dst++ = (x - 128) << 8;
+                *dst++ = (y - 128) << 8;
+                frames++;
                 m_validSamples--;
                 m_curSample++;
             }
         }
-        m_curSample = 0;
-        return true;
+        return frames;
     }
-    if(getBitsPerSample() == 16) {
-        if(getChannels() == 1) {
-            while(m_validSamples) {
-                sample[LEFTCHANNEL]  = m_outBuff[m_curSample];
-                sample[RIGHTCHANNEL] = m_outBuff[m_curSample];
-                if(!playSample(sample)) {
-                    log_e("can't send");
-                    return false;
-                } // Can't send
-                m_validSamples--;
-                m_curSample++;
+    // 16 bit
+    if(getChannels() == 1) {
+        while(m_validSamples && frames < I2S_BLOCK_FRAMES) {
+            *dst++ = m_outBuff[m_curSample];
+            *dst++ = m_outBuff[m_curSample];
+            frames++;
+            m_validSamples--;
+            m_curSample++;
+        }
+    }
+    else {
+        uint16_t n = min((int)m_validSamples, I2S_BLOCK_FRAMES);
+        const int16_t* src = m_outBuff + m_curSample * 2;
+        if(!m_f_forceMono) {         // stereo mode
+            memcpy(dst, src, n * 2 * sizeof(int16_t));
+        }
+        else {                       // mono mode, #100
+            for(uint16_t i = 0; i < n; i++) {
+                int16_t xy = (src[2 * i] + src[2 * i + 1]) / 2;
+                dst[2 * i] = xy;
+                dst[2 * i + 1] = xy;
             }
         }
-        if(getChannels() == 2) {
-            m_curSample = 0;
-            while(m_validSamples) {
-                if(!m_f_forceMono) { // stereo mode
-                    sample[LEFTCHANNEL]  = m_outBuff[m_curSample * 2];
-                    sample[RIGHTCHANNEL] = m_outBuff[m_curSample * 2 + 1];
-                }
-                else { // mono mode, #100
-                    int16_t xy = (m_outBuff[m_curSample * 2] + m_outBuff[m_curSample * 2 + 1]) / 2;
-                    sample[LEFTCHANNEL] = xy;
-                    sample[RIGHTCHANNEL] = xy;
-                }
-                playSample(sample);
-                m_validSamples--;
-                m_curSample++;
+        frames = n;
+        m_validSamples -= n;
+        m_curSample += n;
+    }
+    return frames;
+}
+//---------------------------------------------------------------------------------------------------------------------
+uint16_t Audio::nextI2Sblock(int16_t* dst) {
+    // decoded frames at the stream rate, or converted to AUDIO_RESAMPLE_RATE, 0: m_outBuff is used up
+    uint16_t frames;
+    if(!m_rs.active) frames = fillI2Sblock(dst);
+    else while(true) {
+        frames = RS_Read(&m_rs, dst, I2S_BLOCK_FRAMES);
+        if(frames || !m_validSamples) break;
+        RS_Written(&m_rs, fillI2Sblock(RS_Input(&m_rs)));  // the resampler keeps room for one block
+    }
+    if(frames && m_xfSrc.codec != CODEC_NONE) xfadeMix(dst, frames); // the fading stream is added
+    return frames;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::processI2Sblock(uint16_t frames) {
+    // VU, filters and gain, the result is written in place as I2S-ready 32 bit words (left in the high half)
+    uint32_t* out = (uint32_t*)m_i2sBlock;
+    if(config.store.vumeter) VU_Process(&m_vu, m_i2sBlock, frames, getOutputRate()); // before the gain, the volume is merged into the filterchain
+    if(m_spectrum.tap) SP_Tap(&m_spectrum, m_i2sBlock, frames, getOutputRate());
+    for(uint16_t i = 0; i < 2 * frames; i++) {
+        m_i2sBlock[i] >>= 1; // half Vin so we can boost up to 6dB in filters
+    }
+
+    if(m_bqChain.pending) { // new coefficients or gain from setTone(), setSampleRate(), setVolume(), setBalance()
+        portENTER_CRITICAL(&m_bqMux);
+        BQ_Commit(&m_bqChain);
+        portEXIT_CRITICAL(&m_bqMux);
+    }
+    BQ_Process(&m_bqChain, m_i2sBlock, frames); // filterchain (bands at 0dB are skipped) and volume/balance
+
+    for(uint16_t i = 0; i < frames; i++) {
+        uint32_t s32 = ((uint16_t)m_i2sBlock[2 * i] << 16) | (uint16_t)m_i2sBlock[2 * i + 1];
+        if(m_f_internalDAC) s32 += 0x80008000;
+        out[i] = s32;
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::writeI2Sblock(uint16_t frames) {
+    // m_i2sBlock to the DMA, a tail that did not fit goes out first with the next block (the order is kept)
+    if(m_i2sTailBytes) {
+        uint16_t n = m_i2sTailBytes / sizeof(uint32_t);
+        m_i2sTailBytes = 0;
+        if(!writeI2Sframes(m_i2sTail, n)) {        // still no room in the DMA, the block waits behind the tail
+            uint16_t left = m_i2sTailBytes / sizeof(uint32_t);
+            if(left + frames > 2 * I2S_BLOCK_FRAMES) { // the DMA did not take one block in two timeouts
+                m_stats.i2sDropped += frames;
+                return false;
             }
+            memcpy(m_i2sTail + left, m_i2sBlock, frames * sizeof(uint32_t));
+            m_i2sTailBytes += frames * sizeof(uint32_t);
+            return false;
         }
-        m_curSample = 0;
-        return true;
     }
-    log_e("BitsPer Sample must be 8 or 16!");
+    return writeI2Sframes((const uint32_t*)m_i2sBlock, frames);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::flushI2Stail() {
+    // end of the stream, no block follows that would take the tail along: it goes out now
+    for(uint8_t i = 0; i < 10 && m_i2sTailBytes; i++) { // one i2s_write() timeout each
+        uint16_t n = m_i2sTailBytes / sizeof(uint32_t);
+        m_i2sTailBytes = 0;
+        writeI2Sframes(m_i2sTail, n);               // keeps what still did not fit
+    }
+    if(m_i2sTailBytes) m_stats.i2sDropped += m_i2sTailBytes / sizeof(uint32_t);
+    m_i2sTailBytes = 0;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::benchOutputBlock(const int16_t* pcm, uint16_t frames, uint32_t rate) {
+    // the block path of playChunk() and outputLoop() for test/embedded/test_i2s_write, not while a stream plays
+    if(m_sampleRate != rate) setSampleRate(rate);  // I2S clock and filter coefficients
+    if(frames > I2S_BLOCK_FRAMES) frames = I2S_BLOCK_FRAMES;
+    memcpy(m_i2sBlock, pcm, frames * 2 * sizeof(int16_t));
+    uint32_t t = ESP.getCycleCount();
+    processI2Sblock(frames);
+    m_stats.dspCycles += ESP.getCycleCount() - t;
+    return writeI2Sblock(frames);
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::writeI2Sframes(const uint32_t* src, uint16_t frames) {
+    if(!frames) return true;
+    const char* data = (const char*)src;
+    size_t      bytesToWrite = frames * sizeof(uint32_t);
+    uint32_t    t = ESP.getCycleCount();
+    esp_err_t   err = ESP_OK;
+
+#if I2S_BLOCK_WRITE
+    while(bytesToWrite) {
+        m_i2s_bytesWritten = 0;
+        err = i2s_write((i2s_port_t) m_i2s_num, data, bytesToWrite, &m_i2s_bytesWritten, 100);
+        m_stats.i2sWrites++;
+        if(err != ESP_OK || m_i2s_bytesWritten == 0) break;
+        data += m_i2s_bytesWritten;
+        bytesToWrite -= m_i2s_bytesWritten;
+    }
+#else
+    while(bytesToWrite) { // reference path, one driver call per frame
+        m_i2s_bytesWritten = 0;
+        err = i2s_write((i2s_port_t) m_i2s_num, data, sizeof(uint32_t), &m_i2s_bytesWritten, 100);
+        m_stats.i2sWrites++;
+        if(err != ESP_OK || m_i2s_bytesWritten < sizeof(uint32_t)) break;
+        data += sizeof(uint32_t);
+        bytesToWrite -= sizeof(uint32_t);
+    }
+#endif
+    m_stats.i2sCycles += ESP.getCycleCount() - t;
+    m_stats.frames += frames - bytesToWrite / sizeof(uint32_t);
+
+    if(bytesToWrite) {                              // kept for the next call, src can be m_i2sTail itself
+        memmove(m_i2sTail, data, bytesToWrite);
+        m_i2sTailBytes = bytesToWrite;
+        m_stats.i2sRetries++;
+    }
+    if(err != ESP_OK) {
+        log_e("ESP32 Errorcode %i", err);
+        return false;
+    }
+    if(bytesToWrite) {
+        log_e("Can't stuff any more in I2S..."); // increase waitingtime or outputbuffer
+        return false;
+    }
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::waitForData(uint32_t timeoutMs) {
+    // blocks the caller until the socket is readable or timeoutMs has passed (lwIP select), false: no data,
+    // TLS clients have no plain socket, they sleep one tick
+    if(_client->available()) return true;
+    int fd = _client->fd();
+    if(fd >= 0) {
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+        struct timeval tv = {(time_t)(timeoutMs / 1000), (suseconds_t)((timeoutMs % 1000) * 1000)};
+        int r = select(fd + 1, &rfds, NULL, NULL, &tv);
+        if(r > 0 && _client->available()) return true;
+        if(r == 0) return false;                    // timeout, the wait is done
+    }
+    vTaskDelay(1);                                  // no socket, closed by the peer or an error
+    return _client->available() > 0;
+}
+//---------------------------------------------------------------------------------------------------------------------
+int Audio::streamRead(uint8_t* buf, uint32_t len) {
+    // stream data -> InBuff. The socket is read straight into buf as soon as the client has nothing buffered any
+    // more (WiFiClient rx buffer, prefetch buffer), see net/recv.h. The TCP window closes while InBuff is full, as
+    // with WiFiClient. TLS clients have no plain socket, they are read as before.
+    uint32_t t = ESP.getCycleCount();
+    int n;
+#if AUDIO_DIRECT_RECV
+    int fd = _client->fd();
+    int sock = RECV_Level(fd);
+    if(sock >= 0 && _client->available() <= sock) {
+        n = RECV_Read(fd, buf, len);
+        m_stats.recvDirect += n;
+        m_stats.recvDirectCycles += ESP.getCycleCount() - t;
+        return n;
+    }
+#endif
+    n = _client->read(buf, len);
+    if(n > 0) m_stats.recvClient += n;
+    m_stats.recvClientCycles += ESP.getCycleCount() - t;
+    return n;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::resetStats() {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::startOutputTask() {
+    // decoder (caller's task) and I2S output (own task, other core) are decoupled by the PCM ring,
+    // a stall in the player loop is bridged by the ring content
+#if AUDIO_RING_FRAMES > 0
+    if(m_outTaskHandle) return true;
+    if(!m_ring.init(AUDIO_RING_FRAMES)) {
+        log_e("not enough internal RAM for the PCM ring, decoder and I2S output stay in one task");
+        return false;
+    }
+    BaseType_t r = xTaskCreatePinnedToCore(outputTask, "AudioOut", AUDIO_OUT_TASK_SIZE, this, AUDIO_OUT_TASK_PRIORITY,
+                                           &m_outTaskHandle, AUDIO_OUT_TASK_CORE_ID);
+    if(r != pdPASS) {
+        m_outTaskHandle = NULL;
+        log_e("can't create the audio output task");
+        return false;
+    }
+    AUDIO_INFO("PCM ring: %u frames, output task on core %u", m_ring.size(), AUDIO_OUT_TASK_CORE_ID);
+    return true;
+#else
+    return false;
+#endif
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::startSpectrum() {
+    // the tap runs in processI2Sblock(), the FFT in the task that calls getSpectrum()
+    if(m_spectrum.tap) return true;
+    void* mem = heap_caps_malloc(SP_MEM_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(!mem) {
+        log_e("not enough internal RAM for the spectrum analyzer");
+        return false;
+    }
+    SP_Init(&m_spectrum, mem);                      // m_spectrum.tap != NULL enables SP_Tap() in the audio path
+    AUDIO_INFO("spectrum analyzer: %u bytes", SP_MEM_SIZE);
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::getSpectrum(uint8_t* levels, uint8_t bands) {
+    if(!m_spectrum.tap || !m_f_running) return false;
+    uint32_t t = ESP.getCycleCount();
+    bool r = SP_Compute(&m_spectrum, levels, bands);
+    if(r) {
+        m_stats.spectrumCycles += ESP.getCycleCount() - t;
+        m_stats.spectrumUpdates++;
+    }
+    return r;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::outputTask(void* pvParams) {
+    Audio* self = static_cast<Audio*>(pvParams);
+    while(true) self->outputLoop();
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::outputLoop() {
+    // consumer side of the PCM ring: filters, VU, gain and i2s_write()
+    if(m_f_zeroDMA) {
+        m_f_zeroDMA = false;
+        m_i2sTailBytes = 0;
+        i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
+    }
+    uint32_t rate = 0;
+    uint16_t frames = m_ring.read((uint32_t*)m_i2sBlock, I2S_BLOCK_FRAMES, &rate);
+    if(rate) i2s_set_sample_rates((i2s_port_t)m_i2s_num, rate); // the frames of the old rate are played
+    if(!frames) {
+        if(m_i2sTailBytes) flushI2Stail();         // end of the stream or an underrun, nothing follows to take it along
+        if(m_f_outActive && m_f_running) m_stats.underruns++; // ran dry while the stream is running
+        m_f_outActive = false;
+        vTaskDelay(1);
+        return;
+    }
+    m_f_outActive = true;
+    uint32_t t = ESP.getCycleCount();
+    processI2Sblock(frames);
+    m_stats.dspCycles += ESP.getCycleCount() - t;
+    if(!writeI2Sblock(frames)) log_e("can't send");
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::flushI2S() {
+    // drops the frames waiting for the I2S output and clears the DMA buffers
+    if(m_outTaskHandle) {
+        m_ring.flush();
+        m_f_zeroDMA = true;
+        return;
+    }
+    m_i2sTailBytes = 0;
+    i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::setI2Srate(uint32_t hz) {
+    if(m_outTaskHandle && hz == m_i2sRate) return; // same clock, the ring plays on (a crossfade too)
+    m_i2sRate = hz;
+    if(m_outTaskHandle) {
+        // the frames in the ring still belong to the old rate, the output task switches when it reaches the mark
+        while(!m_ring.mark(hz)) vTaskDelay(1);     // PCMRING_MARKS changes wait for the output task
+        return;
+    }
+    i2s_set_sample_rates((i2s_port_t)m_i2s_num, hz);
+}
+//---------------------------------------------------------------------------------------------------------------------
+//      C R O S S F A D E
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::setCrossfade(uint16_t ms) {
+    // 500...5000 ms, 0: hard cut on a station or track change
+    if(ms) ms = constrain(ms, 500, 5000);
+    m_xfadeMs = ms;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::xfadeReady() {
+    // the stream that plays can be handed over to a second decoder: mp3, aac or flac from file or http(s)
+    if(!m_xfadeMs || !m_outTaskHandle || !psramFound()) return false;   // the ring carries the fading stream
+    if(!m_f_running || !m_f_playing || getBitsPerSample() != 16) return false;
+    if(getDatamode() == AUDIO_LOCALFILE) {if(!audiofile) return false;}
+    else if(getDatamode() != AUDIO_DATA || m_streamType != ST_WEBSTREAM || m_playlistFormat == FORMAT_M3U8 || m_f_ts) return false;
+    return m_codec == CODEC_MP3 || m_codec == CODEC_AAC || m_codec == CODEC_FLAC;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadeBegin() {
+    // called before setDefaults(), takes over decoder, input backlog, source and resampler of the stream that plays
+    xfSource_t& x = m_xfSrc;
+    if(x.codec != CODEC_NONE) {
+        if(!m_xfMixing) return;                     // zapping: the first station fades on, the new one replaces the next
+        xfadeEnd(false);                            // the new stream was already mixed in, it is cut
+    }
+    if(!xfadeReady()) return;
+
+    x.buf = (uint8_t*)ps_malloc(AUDIO_XFADE_MEM + 2048 * 2 * sizeof(int16_t) + I2S_BLOCK_FRAMES * 2 * sizeof(int16_t));
+    if(!x.buf) {log_w("crossfade: not enough PSRAM, hard cut"); return;}
+    x.pcm = (int16_t*)(x.buf + AUDIO_XFADE_MEM);
+    x.blk = x.pcm + 2048 * 2;
+    if(m_codec == CODEC_MP3)  x.mp3  = MP3Decoder_Detach();
+    if(m_codec == CODEC_AAC)  x.aac  = AACDecoder_Detach();
+    if(m_codec == CODEC_FLAC) x.flac = FLACDecoder_Detach();
+    if(!x.mp3 && !x.aac && !x.flac) {free(x.buf); x = xfSource_t(); return;}
+    x.codec = m_codec;
+
+    // the decoded frame that is not played yet
+    x.channels = getChannels();
+    x.valid = m_validSamples;
+    if(x.valid) memcpy(x.pcm, m_outBuff + m_curSample * x.channels, x.valid * x.channels * sizeof(int16_t));
     m_validSamples = 0;
-    stopSong();
+
+    // the input backlog, InBuff is a ring
+    uint32_t filled = InBuff.bufferFilled();
+    while(x.wr < AUDIO_XFADE_MEM && InBuff.bufferFilled()) {
+        uint32_t n = min((uint32_t)InBuff.bufferFilled(), (uint32_t)(InBuff.getBufsize() - InBuff.getReadPos()));
+        n = min(n, (uint32_t)(AUDIO_XFADE_MEM - x.wr));
+        memcpy(x.buf + x.wr, InBuff.getReadPtr(), n);
+        InBuff.bytesWasRead(n);
+        x.wr += n;
+    }
+    bool all = x.wr == filled;
+
+    if(getDatamode() == AUDIO_LOCALFILE) {          // read on from the file, File::close() would close it for both
+        x.fileEnd = m_contentlength ? m_contentlength : m_file_size;
+        uint32_t pos = getFilePos();
+        x.file = audiofile;
+        audiofile = File();
+        if(!all) x.file.seek(pos - (filled - x.wr));
+        x.fromFile = true;
+    }
+    else {                                          // read on from the socket (plain http), or play the backlog only
+        x.icy = m_icy;
+        x.icy.onMeta = NULL;                        // no title events from the old station
+        x.chunk = m_chunk;
+        x.chunked = m_f_chunked;
+        if(all && !m_f_ssl && _client == &client) {x.client = client; x.fromClient = true;}
+    }
+    x.window = InBuff.getMaxBlockSize();
+    if(x.codec == CODEC_FLAC) x.window = min(x.window, (uint32_t)16000); // FLACDecode() counts in int16
+    x.rate = getOutputRate();
+    if(m_rs.active) {x.rs = m_rs; m_rs = {};}      // the new stream gets its own one in setSampleRate()
+
+    XF_Init(&m_xfade, (uint32_t)m_xfadeMs * x.rate / 1000);
+    m_xfHold = 0;
+    m_xfFading = false;
+    m_xfMixing = false;
+    AUDIO_INFO("crossfade: %u ms, %u bytes %s", m_xfadeMs, x.wr, x.fromFile ? "and the file" : x.fromClient ? "and the socket" : "backlog");
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadeEnd(bool done) {
+    // done: the new stream has taken over, else the fade is cut
+    xfSource_t& x = m_xfSrc;
+    if(x.codec == CODEC_NONE) return;
+    if(m_xfMixing) {
+        uint32_t ms = millis() - m_xfStart;
+        uint32_t load = ms ? (uint32_t)(m_xfCycles / ((uint64_t)getCpuFrequencyMhz() * ms)) : 0; // per mille of one core
+        if(done) m_stats.xfades++;
+        m_stats.xfadeMs = ms;
+        m_stats.xfadeCycles = m_xfCycles;
+        m_stats.xfadeLoad = load;
+        if(load > m_stats.xfadeMaxLoad) m_stats.xfadeMaxLoad = load;
+        AUDIO_INFO("crossfade %s after %u ms overlap, fading stream: %u.%u%% CPU", done ? "done" : "cut", ms, load / 10, load % 10);
+    }
+    MP3Destroy(x.mp3);
+    AACDestroy(x.aac);
+    FLACDestroy(x.flac);
+    if(x.rs.coef) free(x.rs.coef);                  // RS_Init() memory starts with the coefficients
+    if(x.buf) free(x.buf);
+    if(x.file) x.file.close();
+    if(x.fromClient) x.client.stop();
+    x = xfSource_t();
+    m_xfFading = false;
+    m_xfMixing = false;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadeFeed() {
+    // stream data of the fading source: file or socket into x.buf
+    xfSource_t& x = m_xfSrc;
+    if(x.pending) return;                           // FLAC: the decoder still has samples of the last block
+    if(x.rd > AUDIO_XFADE_MEM / 2) {                // room at the end
+        memmove(x.buf, x.buf + x.rd, x.wr - x.rd);
+        x.wr -= x.rd;
+        x.rd = 0;
+    }
+    uint32_t space = AUDIO_XFADE_MEM - x.wr;
+    if(x.fromFile) {
+        if(x.wr - x.rd >= 2 * x.window) return;     // enough for the next frames
+        uint32_t pos = x.file.position();
+        uint32_t n = min(space, max(2 * x.window, (uint32_t)8192));
+        if(x.fileEnd > pos) n = min(n, x.fileEnd - pos); else n = 0;
+        int32_t r = n ? x.file.read(x.buf + x.wr, n) : 0;
+        if(r > 0) x.wr += r;
+        else {x.fromFile = false; x.file.close();}
+        return;
+    }
+    if(x.fromClient) {
+        int av = x.client.available();
+        if(av <= 0) {
+            if(!x.client.connected()) {x.fromClient = false; x.client.stop();}
+            return;
+        }
+        int r = x.client.read(x.buf + x.wr, min((uint32_t)av, space));
+        if(r <= 0) return;
+        uint32_t payload = r;
+        if(x.chunked) payload = CK_Decode(&x.chunk, x.buf + x.wr, payload);
+        x.wr += ICY_Demux(&x.icy, x.buf + x.wr, payload);
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::xfadeDecode() {
+    // next frame of the fading source into x.pcm, false: no data (yet)
+    xfSource_t& x = m_xfSrc;
+    for(uint8_t i = 0; i < 4; i++) {
+        xfadeFeed();
+        bool more = x.fromFile || x.fromClient;
+        uint32_t len = min(x.wr - x.rd, x.window);
+        if(!x.pending && len < (more ? x.window : 200)) {
+            if(!more) x.ended = true;
+            return false;
+        }
+        int bytesLeft = len;
+        int ret = 0;
+        uint8_t* in = x.buf + x.rd;
+        if(x.codec == CODEC_MP3)  ret = MP3Decode(x.mp3, in, &bytesLeft, x.pcm, 0);
+        if(x.codec == CODEC_AAC)  ret = AACDecode(x.aac, in, &bytesLeft, x.pcm);
+        if(x.codec == CODEC_FLAC) ret = FLACDecode(x.flac, in, &bytesLeft, x.pcm);
+        uint32_t used = len - bytesLeft;
+        x.pending = x.codec == CODEC_FLAC && ret == GIVE_NEXT_LOOP;
+        if(ret < 0 || (!used && !ret)) {            // skip the frame, find the next syncword
+            if(++x.errors > 8) {x.ended = true; return false;}
+            x.rd += used ? used : 1;
+            len = x.wr - x.rd;
+            int sync = -1;
+            if(x.codec == CODEC_MP3)  sync = MP3FindSyncWord(x.buf + x.rd, len);
+            if(x.codec == CODEC_AAC)  sync = AACFindSyncWord(x.buf + x.rd, len);
+            if(x.codec == CODEC_FLAC) sync = FLACFindSyncWord(x.flac, x.buf + x.rd, len);
+            x.rd += sync >= 0 ? sync : len;
+            continue;
+        }
+        x.rd += used;
+        x.errors = 0;
+        uint8_t  ch = x.codec == CODEC_MP3 ? MP3GetChannels(x.mp3) : x.codec == CODEC_AAC ? AACGetChannels(x.aac) : FLACGetChannels(x.flac);
+        uint32_t samples = x.codec == CODEC_MP3 ? MP3GetOutputSamps(x.mp3) : x.codec == CODEC_AAC ? AACGetOutputSamps(x.aac) : FLACGetOutputSamps(x.flac);
+        if(ch == 1 || ch == 2) x.channels = ch;
+        x.valid = samples / x.channels;
+        x.cur = 0;
+        if(x.valid) return true;
+    }
     return false;
 }
+//---------------------------------------------------------------------------------------------------------------------
+uint16_t Audio::xfadeUnpack(int16_t* dst, uint16_t frames) {
+    // decoded frames of the fading source, interleaved L/R like fillI2Sblock(), less at the end of the stream
+    xfSource_t& x = m_xfSrc;
+    uint16_t n = 0;
+    while(n < frames) {
+        if(!x.valid && !xfadeDecode()) break;
+        uint16_t k = min((uint16_t)(frames - n), x.valid);
+        const int16_t* src = x.pcm + x.cur * x.channels;
+        int16_t* d = dst + 2 * n;
+        if(x.channels == 1) {
+            for(uint16_t i = 0; i < k; i++) {d[2 * i] = src[i]; d[2 * i + 1] = src[i];}
+        }
+        else if(!m_f_forceMono) memcpy(d, src, k * 2 * sizeof(int16_t));
+        else {
+            for(uint16_t i = 0; i < k; i++) {int16_t xy = (src[2 * i] + src[2 * i + 1]) / 2; d[2 * i] = xy; d[2 * i + 1] = xy;}
+        }
+        x.valid -= k;
+        x.cur += k;
+        n += k;
+    }
+    return n;
+}
+//---------------------------------------------------------------------------------------------------------------------
+uint16_t Audio::xfadeRead(int16_t* dst, uint16_t frames) {
+    // frames of the fading source at the output rate
+    xfSource_t& x = m_xfSrc;
+    if(!x.rs.active) return xfadeUnpack(dst, frames);
+    uint16_t n = 0;
+    while(n < frames) {
+        uint16_t k = RS_Read(&x.rs, dst + 2 * n, frames - n);
+        if(k) {n += k; continue;}
+        uint16_t in = xfadeUnpack(RS_Input(&x.rs), I2S_BLOCK_FRAMES);
+        if(!in) break;
+        RS_Written(&x.rs, in);
+    }
+    return n;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadePump() {
+    // the fading source alone into the PCM ring while the new stream connects and buffers
+    if(m_xfSrc.codec == CODEC_NONE || m_xfMixing) return;
+    while(m_ring.freeSpace() >= I2S_BLOCK_FRAMES) {
+        uint16_t frames = xfadeRead(m_pcmBlock, I2S_BLOCK_FRAMES);
+        if(!frames) {
+            if(m_xfSrc.ended) xfadeEnd(false);      // nothing left, the new stream starts from silence
+            return;
+        }
+        m_xfHold += frames;
+        if(m_xfHold >= m_xfade.frames) m_xfFading = true; // the new stream takes too long, the old one fades out alone
+        if(m_xfFading) XF_Old(&m_xfade, m_pcmBlock, frames);
+        m_ring.write((const uint32_t*)m_pcmBlock, frames);
+        if(XF_Done(&m_xfade)) {xfadeEnd(false); return;}
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadeMix(int16_t* dst, uint16_t frames) {
+    // the new stream is in dst, the fading source is added, both decoders run (overlap)
+    xfSource_t& x = m_xfSrc;
+    if(!m_xfMixing) {
+        m_xfMixing = true;
+        m_xfFading = true;
+        m_xfStart = millis();
+        m_xfCycles = 0;
+    }
+    if(getOutputRate() != x.rate) {xfadeEnd(false); return;} // fuse, setSampleRate() cuts it earlier
+    uint32_t t = ESP.getCycleCount();
+    uint16_t n = xfadeRead(x.blk, frames);
+    if(n < frames) memset(x.blk + 2 * n, 0, (frames - n) * 2 * sizeof(int16_t));
+    XF_Mix(&m_xfade, dst, x.blk, frames);
+    m_xfCycles += ESP.getCycleCount() - t;
+    if(XF_Done(&m_xfade) || (!n && x.ended)) xfadeEnd(true);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::xfadeIdle(void* arg) {
+    // connector.open() waits, the fading source plays on
+    static_cast<Audio*>(arg)->xfadePump();
+}
 
-/*
- * Shamelessly borrowed from @schreibfaul1 https://github.com/schreibfaul1/ESP32-audioI2S/blob/1296374fc513a6d6bfaa3b1ca08f6ba938b18d99/src/Audio.cpp#L5030
- */
-void Audio::_computeVUlevel(int16_t sample[2]) {
-  if(!config.store.vumeter) return;
-  static uint8_t sampleArray[2][4][8] = {0};
-  static uint8_t cnt0 = 0, cnt1 = 0, cnt2 = 0, cnt3 = 0, cnt4 = 0;
-  static bool    f_vu = false;
-
-  auto avg = [&](uint8_t* sampArr) { // lambda, inner function, compute the average of 8 samples
-    uint16_t av = 0;
-    for(int i = 0; i < 8; i++) { av += sampArr[i]; }
-    return av >> 3;
-  };
-
-  auto largest = [&](uint8_t* sampArr) { // lambda, inner function, compute the largest of 8 samples
-    uint16_t maxValue = 0;
-    for(int i = 0; i < 8; i++) {
-      if(maxValue < sampArr[i]) maxValue = sampArr[i];
-    }
-    return maxValue;
-  };
-
-  if(cnt0 == 64) {
-    cnt0 = 0;
-    cnt1++;
-  }
-  if(cnt1 == 8) {
-    cnt1 = 0;
-    cnt2++;
-  }
-  if(cnt2 == 8) {
-    cnt2 = 0;
-    cnt3++;
-  }
-  if(cnt3 == 8) {
-    cnt3 = 0;
-    cnt4++;
-    f_vu = true;
-  }
-  if(cnt4 == 8) { cnt4 = 0; }
-
-  if(!cnt0) { // store every 64th sample in the array[0]
-    sampleArray[LEFTCHANNEL][0][cnt1] = abs(sample[LEFTCHANNEL] >> 7);
-    sampleArray[RIGHTCHANNEL][0][cnt1] = abs(sample[RIGHTCHANNEL] >> 7);
-  }
-  if(!cnt1) { // store argest from 64 * 8 samples in the array[1]
-    sampleArray[LEFTCHANNEL][1][cnt2] = largest(sampleArray[LEFTCHANNEL][0]);
-    sampleArray[RIGHTCHANNEL][1][cnt2] = largest(sampleArray[RIGHTCHANNEL][0]);
-  }
-  if(!cnt2) { // store avg from 64 * 8 * 8 samples in the array[2]
-    sampleArray[LEFTCHANNEL][2][cnt3] = largest(sampleArray[LEFTCHANNEL][1]);
-    sampleArray[RIGHTCHANNEL][2][cnt3] = largest(sampleArray[RIGHTCHANNEL][1]);
-  }
-  if(!cnt3) { // store avg from 64 * 8 * 8 * 8 samples in the array[3]
-    sampleArray[LEFTCHANNEL][3][cnt4] = avg(sampleArray[LEFTCHANNEL][2]);
-    sampleArray[RIGHTCHANNEL][3][cnt4] = avg(sampleArray[RIGHTCHANNEL][2]);
-  }
-  if(f_vu) {
-    f_vu = false;
-    vuLeft = avg(sampleArray[LEFTCHANNEL][3]);
-    if(vuLeft>config.vuThreshold)  config.vuThreshold = vuLeft;
-    vuRight = avg(sampleArray[RIGHTCHANNEL][3]);
-    if(vuRight>config.vuThreshold) config.vuThreshold = vuRight;
-  }
-  cnt1++;
+void Audio::getVUlevels(vuLevels_t* levels){
+  if(!config.store.vumeter || !m_f_running) { memset(levels, 0, sizeof(vuLevels_t)); return; }
+  VU_Read(&m_vu, levels);
 }
 
 uint16_t Audio::get_VUlevel(uint16_t dimension){
-  if(!config.store.vumeter || config.vuThreshold==0) return 0;
+  if(!config.store.vumeter) return 0;
+  vuLevels_t lv;
+  getVUlevels(&lv);
+  vuLeft  = lv.peak[LEFTCHANNEL] >> 8;    // 0...127
+  vuRight = lv.peak[RIGHTCHANNEL] >> 8;
+  if(vuLeft>config.vuThreshold)  config.vuThreshold = vuLeft;
+  if(vuRight>config.vuThreshold) config.vuThreshold = vuRight;
+  if(config.vuThreshold==0) return 0;
   uint8_t L = map(vuLeft, config.vuThreshold, 0, 0, dimension);
   uint8_t R = map(vuRight, config.vuThreshold, 0, 0, dimension);
   uint16_t LL = (uint16_t)L;
@@ -2536,11 +3253,22 @@ uint16_t Audio::get_VUlevel(uint16_t dimension){
   //Serial.printf("<><><><><><><><><><><><><><><><>VU Left = %d (Threshold=%d, Dimension=%d)\n", L, config.vuThreshold, dimension);
   return (L << 8) | R;
 }
+
+uint16_t Audio::get_VUhold(uint16_t dimension){
+  if(!config.store.vumeter || config.vuThreshold==0) return 0;
+  vuLevels_t lv;
+  getVUlevels(&lv);
+  uint16_t hL = min(lv.hold[LEFTCHANNEL] >> 8, (int)config.vuThreshold);
+  uint16_t hR = min(lv.hold[RIGHTCHANNEL] >> 8, (int)config.vuThreshold);
+  uint8_t L = map(hL, config.vuThreshold, 0, 0, dimension);
+  uint8_t R = map(hR, config.vuThreshold, 0, 0, dimension);
+  return (L << 8) | R;
+}
 //---------------------------------------------------------------------------------------------------------------------
 
 void Audio::loop() {
+    if(m_xfSrc.codec != CODEC_NONE) xfadePump();   // the old station or track while the new one starts
     if(!m_f_running) {
-      vuLeft=0; vuRight=0;
       vTaskDelay(2);
       return;
     }
@@ -2556,9 +3284,9 @@ void Audio::loop() {
                 readPlayListData();
                 break;
             case AUDIO_PLAYLISTDATA:
-                if(m_playlistFormat == FORMAT_M3U)  connecttohost(parsePlaylist_M3U());
-                if(m_playlistFormat == FORMAT_PLS)  connecttohost(parsePlaylist_PLS());
-                if(m_playlistFormat == FORMAT_ASX)  connecttohost(parsePlaylist_ASX());
+                if(m_playlistFormat == FORMAT_M3U)  connecttoRedirect(parsePlaylist_M3U());
+                if(m_playlistFormat == FORMAT_PLS)  connecttoRedirect(parsePlaylist_PLS());
+                if(m_playlistFormat == FORMAT_ASX)  connecttoRedirect(parsePlaylist_ASX());
                 break;
             case AUDIO_DATA:
                 processWebStream();
@@ -2577,16 +3305,23 @@ void Audio::loop() {
                 m_codec = CODEC_AAC;
                 break;
             case AUDIO_PLAYLISTINIT:
+                playAudioData(); // the segments before are still in InBuff
                 readPlayListData();
                 break;
             case AUDIO_PLAYLISTDATA:
+                if(m_playlistContent.size()) m_hlsRefresh = millis() + m_m3u8_targetDuration * 1000;
                 host = parsePlaylist_M3U8();
                 m_f_m3u8data = true;
                 if(host){
                     f_noNewHost = false;
                     timestamp1 = millis();
+                    if(host != m_lastHost) m_stats.hlsSegments++;
                     httpPrint(host);
                 }
+                else if(m_abr.switched){ // other variant, load its playlist now
+                    f_noNewHost = false;
+                    httpPrint(m_lastHost);
+                }
                 else {
                     f_noNewHost = true;
                     timestamp2 = millis() + remaintime;
@@ -2608,8 +3343,10 @@ void Audio::loop() {
                         remaintime = (int32_t)(m_m3u8_targetDuration * 1000) - (millis() - timestamp1);
                     //    if(m_m3u8_targetDuration < 10) remaintime += 1000;
                         m_f_continue = false;
-                        setDatamode(AUDIO_PLAYLISTDATA);
+                        if(hlsTakePending()) timestamp1 = millis();
+                        else setDatamode(AUDIO_PLAYLISTDATA);
                     }
+                    else hlsPipeline();
                 }
                 break;
         }
@@ -2711,7 +3448,7 @@ bool Audio::readPlayListData() {
 const char* Audio::parsePlaylist_M3U(){
     uint8_t lines = m_playlistContent.size();
     int pos = 0;
-    char* host = nullptr;
+    std::vector<char*> urls;                                            // all entries, mirrors of the stream
 
     for(int i= 0; i < lines; i++){
         if(indexOf(m_playlistContent[i], "#EXTINF:") >= 0) {            // Info?
@@ -2729,25 +3466,26 @@ const char* Audio::parsePlaylist_M3U(){
         pos = indexOf(m_playlistContent[i], "http://:@", 0);            // ":@"??  remove that!
         if(pos >= 0) {
             AUDIO_INFO("Entry in playlist found: %s", (m_playlistContent[i] + pos + 9));
-            host = m_playlistContent[i] + pos + 9;
-            break;
+            mirrorsAdd(urls, m_playlistContent[i] + pos + 9, strlen(m_playlistContent[i] + pos + 9));
+            continue;
         }
         // AUDIO_INFO("Entry in playlist found: %s", pl);
         pos = indexOf(m_playlistContent[i], "http", 0);                 // Search for "http"
         if(pos >= 0) {                                                  // Does URL contain "http://"?
     //    log_e("%s pos=%i", m_playlistContent[i], pos);
-            host = m_playlistContent[i] + pos;                        // Yes, set new host
-            break;
+            mirrorsAdd(urls, m_playlistContent[i] + pos, strlen(m_playlistContent[i] + pos)); // Yes, set new host
         }
     }
     vector_clear_and_shrink(m_playlistContent);
-    return host;
+    if(urls.empty()) return nullptr;
+    mirrorsFromPlaylist(urls);
+    return m_mirrors[0];
 }
 //----------------------------------------------------------------------------------------------------------------------
 const char* Audio::parsePlaylist_PLS(){
     uint8_t lines = m_playlistContent.size();
     int pos = 0;
-    char* host = nullptr;
+    std::vector<char*> urls;                                            // File1, File2 .. mirrors of the stream
 
     for(int i= 0; i < lines; i++){
         if(i == 0){
@@ -2759,11 +3497,10 @@ const char* Audio::parsePlaylist_PLS(){
             }
             continue;
         }
-        if(startsWith(m_playlistContent[i], "File1")) {
-            if(host) continue;                                          // we have already a url
+        if(startsWith(m_playlistContent[i], "File")) {
             pos = indexOf(m_playlistContent[i], "http", 0);             // File1=http://streamplus30.leonex.de:14840/;
             if(pos >= 0) {                                              // yes, URL contains "http"?
-                host = m_playlistContent[i] + pos;                      // Now we have an URL for a stream in host.
+                mirrorsAdd(urls, m_playlistContent[i] + pos, strlen(m_playlistContent[i] + pos)); // Now we have an URL for a stream
             }
             continue;
         }
@@ -2780,9 +3517,12 @@ const char* Audio::parsePlaylist_PLS(){
             goto exit;                                                  // Invalid username or password
         }
     }
-    return host;
+    if(urls.empty()) return nullptr;
+    mirrorsFromPlaylist(urls);
+    return m_mirrors[0];
 
 exit:
+    vector_clear_and_shrink(urls);
     m_f_running = false;
     stopSong();
     vector_clear_and_shrink(m_playlistContent);
@@ -2836,7 +3576,8 @@ const char* Audio::parsePlaylist_ASX(){                             // Advanced
 const char* Audio::parsePlaylist_M3U8(){
     uint8_t lines = m_playlistContent.size();
     bool f_begin = false;
-    uint8_t occurence = 0;
+    bool f_master = false;                                             // #EXT-X-STREAM-INF seen
+    int64_t seq = -1;                                                  // media sequence number of the next segment
     if(lines){
         for(int i= 0; i < lines; i++){
             if(strlen(m_playlistContent[i]) == 0) continue;                    // empty line
@@ -2846,35 +3587,39 @@ const char* Audio::parsePlaylist_M3U8(){
             }
             if(!f_begin) continue;
 
-            // example: redirection
+            // example: master playlist, all variants are kept, see hlsSegmentDone()
             // #EXTM3U
             // #EXT-X-STREAM-INF:BANDWIDTH=22050,CODECS="mp4a.40.2"
             // http://ample.revma.ihrhls.com/zc7729/63_sdtszizjcjbz02/playlist.m3u8
+            // #EXT-X-STREAM-INF:BANDWIDTH=132300,CODECS="mp4a.40.2"
+            // http://ample.revma.ihrhls.com/zc7729/63_sdtszizjcjbz02/playlist-128.m3u8
             if(startsWith(m_playlistContent[i],"#EXT-X-STREAM-INF:")){
-                if(occurence > 0) break; // no more than one #EXT-X-STREAM-INF: (can have different BANDWIDTH)
-                occurence++;
-                if(!endsWith(m_playlistContent[i+1], "m3u8")){ // we have a new m3u8 playlist, skip to next line
-                    int pos = indexOf(m_playlistContent[i], "CODECS=\"mp4a", 18);
-                    // 'mp4a.40.01' AAC Main
-                    // 'mp4a.40.02' AAC LC (Low Complexity)
-                    // 'mp4a.40.03' AAC SSR (Scalable Sampling Rate) ??
-                    // 'mp4a.40.03' AAC LTP (Long Term Prediction) ??
-                    // 'mp4a.40.03' SBR (Spectral Band Replication)
-                    if(pos < 0){ // not found
-                        int pos1 = indexOf(m_playlistContent[i], "CODECS=", 18);
-                        if(pos1 < 0) pos1 = 0;
-                        log_e("codec %s in m3u8 playlist not supported", m_playlistContent[i] + pos1);
-                        goto exit;
-                    }
+                if(!f_master){
+                    f_master = true;
+                    vector_clear_and_shrink(m_hlsVariantURL);
+                    m_hlsBandwidth.clear();
                 }
+                const char* inf = m_playlistContent[i];
                 i++;                                                    // next line
                 if(i == lines) continue; // and exit for()
-
+                int pos = indexOf(inf, "CODECS=", 18);
+                // 'mp4a.40.01' AAC Main
+                // 'mp4a.40.02' AAC LC (Low Complexity)
+                // 'mp4a.40.03' AAC SSR (Scalable Sampling Rate) ??
+                // 'mp4a.40.03' AAC LTP (Long Term Prediction) ??
+                // 'mp4a.40.03' SBR (Spectral Band Replication)
+                if(pos >= 0 && indexOf(inf, "mp4a", pos) < 0){
+                    log_e("codec %s in m3u8 playlist not supported", inf + pos);
+                    continue;
+                }
+                uint32_t bandwidth = 0;
+                for(int b = indexOf(inf, "BANDWIDTH=", 18); b >= 0; b = indexOf(inf, "BANDWIDTH=", b + 10)){
+                    if(inf[b - 1] == ':' || inf[b - 1] == ','){bandwidth = atoi(inf + b + 10); break;} // not AVERAGE-BANDWIDTH
+                }
                 char* tmp = nullptr;
                 if(!startsWith(m_playlistContent[i], "http")){
-                  //http://livees.com/prog_index.m3u8 and prog_index48347.aac --> http://livees.com/prog_index48347.aac
                   //http://livees.com/prog_index.m3u8 and chunklist022.m3u8   --> http://livees.com/chunklist022.m3u8
-                    tmp = (char*)malloc(strlen(m_lastHost)+ strlen(m_playlistContent[i]));
+                    tmp = (char*)malloc(strlen(m_lastHost)+ strlen(m_playlistContent[i]) + 1);
                     strcpy(tmp, m_lastHost);
                     int idx = lastIndexOf(tmp, "/");
                     strcpy(tmp + idx + 1, m_playlistContent[i]);
@@ -2882,12 +3627,11 @@ const char* Audio::parsePlaylist_M3U8(){
                 else{
                     tmp = strdup(m_playlistContent[i]);
                 }
-                if(m_playlistContent[i]){free(m_playlistContent[i]); m_playlistContent[i] = NULL;}
-                m_playlistContent[i] = strdup(tmp);
-                strcpy(m_lastHost, tmp);
-                if(tmp){free(tmp); tmp = NULL;}
-                if(m_f_Log) log_i("redirect %s", m_playlistContent[i]);
-                return m_playlistContent[i];                            // it's a redirection, a new m3u8 playlist
+                if(strlen(tmp) >= sizeof(m_lastHost)) {free(tmp); continue;}
+                m_hlsVariantURL.push_back(tmp);
+                m_hlsBandwidth.push_back(bandwidth);
+                if(m_f_Log) log_i("variant %u bit/s %s", bandwidth, tmp);
+                continue;
             }
 
             // example: audio chunks
@@ -2900,7 +3644,8 @@ const char* Audio::parsePlaylist_M3U8(){
             // #EXTINF:10,title="text=\"Spot Block End\" amgTrackId=\"9876543\"",artist=" ",url="length=\"00:00:00\""
             // http://n3fa-e2.revma.ihrhls.com/zc7729/63_sdtszizjcjbz02/main/163374039.aac
             if(startsWith(m_playlistContent[i], "#EXT-X-MEDIA-SEQUENCE:")){
-                // do nothing, because MEDIA-SECUENCE is not set sometimes
+                // not set sometimes, used only to continue after a variant change
+                seq = atoll(m_playlistContent[i] + 22);
             }
             static uint16_t targetDuration = 0;
             if(startsWith(m_playlistContent[i], "#EXT-X-TARGETDURATION:")) {
@@ -2927,9 +3672,18 @@ const char* Audio::parsePlaylist_M3U8(){
                 }
 
                 uint32_t hash = simpleHash(tmp);
+                int64_t segSeq = seq;
+                if(seq >= 0) seq++;
+                if(!ABR_Queue(&m_abr, segSeq)){                         // requested from the variant before
+                    m_hashQueue.insert(m_hashQueue.begin(), hash);
+                    if(m_hashQueue.size() > 20)  m_hashQueue.pop_back();
+                    free(tmp);
+                    continue;
+                }
                 if(m_hashQueue.size() == 0){
                     m_hashQueue.insert(m_hashQueue.begin(), hash);
                     m_playlistURL.insert(m_playlistURL.begin(), strdup(tmp));
+                    m_playlistSeq.insert(m_playlistSeq.begin(), segSeq);
                 }
                 else{
                     bool known = false;
@@ -2942,6 +3696,7 @@ const char* Audio::parsePlaylist_M3U8(){
                     if(!known){
                         m_hashQueue.insert(m_hashQueue.begin(), hash);
                         m_playlistURL.insert(m_playlistURL.begin(), strdup(tmp));
+                        m_playlistSeq.insert(m_playlistSeq.begin(), segSeq);
                     }
                 }
 
@@ -2957,8 +3712,25 @@ const char* Audio::parsePlaylist_M3U8(){
             }
         }
         vector_clear_and_shrink(m_playlistContent); //clear after reading everything, m_playlistContent.size is now 0
+        ABR_PlaylistDone(&m_abr);
     }
 
+    if(f_master){
+        if(m_hlsVariantURL.size() == 0) goto exit;                         // no variant with a supported codec
+        m_hlsVariant = ABR_Select(&m_abr, m_hlsBandwidth.data(), m_hlsBandwidth.size(), 0); // first listed, no measure yet
+        m_stats.hlsBandwidth = m_hlsBandwidth[m_hlsVariant];
+        strcpy(m_lastHost, m_hlsVariantURL[m_hlsVariant]);
+        if(m_f_Log) log_i("redirect %s", m_lastHost);
+        return m_lastHost;                                              // it's a redirection, a new m3u8 playlist
+    }
+    return popPlaylistURL();
+exit:
+    stopSong();
+    return NULL;
+}
+//---------------------------------------------------------------------------------------------------------------------
+const char* Audio::popPlaylistURL(){
+    // the oldest segment of the queue -> m_playlistBuff
     if(m_playlistURL.size() > 0){
         if(m_playlistBuff) {free(m_playlistBuff); m_playlistBuff = NULL;}
 
@@ -2969,15 +3741,71 @@ const char* Audio::parsePlaylist_M3U8(){
                 m_playlistURL.pop_back();
                 m_playlistURL.shrink_to_fit();
         }
+        if(m_playlistSeq.size()){                       // a switch continues behind the requested segment
+            ABR_Requested(&m_abr, m_playlistSeq.back());
+            m_playlistSeq.pop_back();
+        }
         if(m_f_Log) log_i("now playing %s", m_playlistBuff);
         return m_playlistBuff;
     }
     else{
         return NULL;
     }
-exit:
-    stopSong();
-    return NULL;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::hlsPipeline(){
+    // a segment is read (AUDIO_DATA), the next request goes out now on the same keep-alive connection,
+    // the server sends the response right behind this one: segment N+1 arrives while segment N is decoded.
+    // The playlist is reloaded every #EXT-X-TARGETDURATION or when the queue is empty.
+    // Not for chunked responses, their end is not tracked
+#if HLS_PIPELINE
+    if(m_hlsPending != HLS_NONE) return;
+    m_hlsPending = HLS_SKIP;                        // one attempt per response
+    if(m_f_chunked || !m_contentlength) return;
+    if(m_playlistURL.size() == 0 || (int32_t)(millis() - m_hlsRefresh) >= 0){
+        if(httpPrint(m_lastHost, true)) m_hlsPending = HLS_PLAYLIST;
+        return;
+    }
+    if(httpPrint(m_playlistURL[m_playlistURL.size() - 1], true)){
+        popPlaylistURL();
+        m_stats.hlsSegments++;
+        m_stats.hlsPipelined++;
+        m_hlsPending = HLS_SEGMENT;
+    }
+#endif
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::hlsSegmentDone(uint32_t bytes, uint32_t ms, bool limited){
+    // a segment is complete: throughput sample, the variant of the master playlist is changed here (segment boundary)
+    ABR_Sample(&m_abr, bytes, ms, limited);
+    m_stats.hlsThroughput = m_abr.estimate;
+    if(m_hlsVariant < 0 || m_hlsPending == HLS_PLAYLIST) return; // no master playlist, or a reload of this variant is in flight
+    int v = ABR_Select(&m_abr, m_hlsBandwidth.data(), m_hlsBandwidth.size(), m_hlsVariant);
+    if(v == m_hlsVariant) return;
+    AUDIO_INFO("HLS variant %u -> %u kbit/s, throughput %u kbit/s", m_hlsBandwidth[m_hlsVariant] / 1000,
+               m_hlsBandwidth[v] / 1000, m_abr.estimate / 1000);
+    m_hlsVariant = v;
+    m_stats.hlsSwitches++;
+    m_stats.hlsBandwidth = m_hlsBandwidth[v];
+    strcpy(m_lastHost, m_hlsVariantURL[v]);
+    vector_clear_and_shrink(m_playlistURL);         // segments of the old variant, not requested yet, the new
+    m_playlistSeq.clear();                          // variant continues behind the last requested one (m_abr.lastSeq)
+    m_hlsRefresh = millis();
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::hlsTakePending(){
+    // the current response is complete, switch to the pipelined one, false: nothing is in flight
+    uint8_t pending = m_hlsPending;
+    m_hlsPending = HLS_NONE;
+    if(pending != HLS_SEGMENT && pending != HLS_PLAYLIST) return false;
+    if(!_client->connected()){                      // closed by the server after the last response, ask again
+        return httpPrint(pending == HLS_SEGMENT ? m_playlistBuff : m_lastHost);
+    }
+    setDatamode(HTTP_RESPONSE_HEADER);
+    m_streamType = ST_WEBSTREAM;
+    m_contentlength = 0;
+    m_f_chunked = false;
+    return true;
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::STfromEXTINF(char* str){
@@ -3064,6 +3892,23 @@ void Audio::processLocalFile() {
     }
 
     if(bytesAddedToBuffer == -1) bytesAddedToBuffer = 0; // read error? eof?
+
+    // crossfade: the end of the track is reported early, the next one starts while this one fades out
+    if(f_stream && !m_f_xfEof && !m_f_loop && audio_eof_mp3 && m_avr_bitrate && xfadeReady()) {
+        uint32_t end = m_contentlength ? m_contentlength : m_file_size;
+        uint32_t pos = getFilePos() - InBuff.bufferFilled();
+        uint32_t ms = end > pos ? (uint64_t)(end - pos) * 8000 / m_avr_bitrate : 0;
+        if(ms <= m_xfadeMs + 1000u) {
+            m_f_xfEof = true;
+#ifdef SDFATFS_USED
+            audiofile.getName(chbuf, sizeof(chbuf));
+#else
+            strlcpy(chbuf, audiofile.name(), sizeof(chbuf));
+#endif
+            AUDIO_INFO("End of file \"%s\" in %u ms, crossfade", chbuf, ms);
+            audio_eof_mp3(chbuf);
+        }
+    }
     bytesCanBeRead = InBuff.bufferFilled();
     if(bytesCanBeRead > InBuff.getMaxBlockSize()) bytesCanBeRead = InBuff.getMaxBlockSize();
     if(bytesCanBeRead == InBuff.getMaxBlockSize()) { // mp3 or aac frame complete?
@@ -3085,10 +3930,11 @@ void Audio::processLocalFile() {
 
     if(!bytesAddedToBuffer) {  // eof
         bytesCanBeRead = InBuff.bufferFilled();
-        if(bytesCanBeRead > 200){
+        bool f_ogg = m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS;
+        if(bytesCanBeRead > 200 || (f_ogg && m_ogg.pending)){ // the last ogg packet can be in the packet buffer
             if(bytesCanBeRead > InBuff.getMaxBlockSize()) bytesCanBeRead = InBuff.getMaxBlockSize();
             bytesDecoded = sendBytes(InBuff.getReadPtr(), bytesCanBeRead); // play last chunk(s)
-            if(bytesDecoded > 0){
+            if(bytesDecoded > 0 || (f_ogg && m_ogg.pending && m_f_playing)){
                 InBuff.bytesWasRead(bytesDecoded);
                 return;
             }
@@ -3100,6 +3946,7 @@ void Audio::processLocalFile() {
             AUDIO_INFO("loop from: %u to: %u", getFilePos(), m_audioDataStart); //TEST loop
             setFilePos(m_audioDataStart);
             if(m_codec == CODEC_FLAC) FLACDecoderReset();
+            if(m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS) OGG_Reset(&m_ogg);
             /*
                 The current time of the loop mode is not reset,
                 which will cause the total audio duration to be exceeded.
@@ -3122,8 +3969,12 @@ void Audio::processLocalFile() {
         if(m_codec == CODEC_AAC)   AACDecoder_FreeBuffers();
         if(m_codec == CODEC_M4A)   AACDecoder_FreeBuffers();
         if(m_codec == CODEC_FLAC) FLACDecoder_FreeBuffers();
+        if(m_codec == CODEC_OGG_FLAC) FLACDecoder_FreeBuffers();
+        if(m_codec == CODEC_OGG_OPUS) OPUSDecoder_FreeBuffers();
+        if(m_codec == CODEC_OGG_VORBIS) VORBISDecoder_FreeBuffers();
+        OGG_FreeBuffers(&m_ogg);
         AUDIO_INFO("End of file \"%s\"", afn);
-        if(audio_eof_mp3) audio_eof_mp3(afn);
+        if(audio_eof_mp3 && !m_f_xfEof) audio_eof_mp3(afn); // else already reported for the crossfade
         if(afn) {free(afn); afn = NULL;}
     }
 }
@@ -3138,9 +3989,8 @@ void Audio::processWebStream() {
     static bool     f_webFileAudioComplete;                     // all audio data received
     static int      bytesDecoded;
     static uint32_t byteCounter;                                // count received data
-    static uint32_t chunksize;                                  // chunkcount read from stream
     static uint32_t tmr_1s;                                     // timer 1 sec
-    static uint32_t loopCnt;                                    // count loops if clientbuffer is empty
+    static uint32_t lastData;                                   // millis() of the last data from the stream
     static size_t   audioDataCount;                             // counts the decoded audiodata only
 
     // first call, set some values to default - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -3150,14 +4000,13 @@ void Audio::processWebStream() {
         f_webFileAudioComplete = false;
         f_stream = false;
         byteCounter = 0;
-        chunksize = 0;
         bytesDecoded = 0;
-        loopCnt = 0;
+        lastData = millis();
         audioDataCount = 0;
         tmr_1s = millis();
         m_t0 = millis();
-        m_metacount = m_metaint;
-        readMetadata(0, true); // reset all static vars
+        ICY_Reset(&m_icy, m_f_swm ? 0 : m_metaint, icyEvent, this);
+        JB_Reset(&m_jb, JITTER_START_MS, JITTER_MAX_MS, InBuff.getBufsize(), millis());
     }
 
     if(getDatamode() != AUDIO_DATA) return;        // guard
@@ -3166,6 +4015,12 @@ void Audio::processWebStream() {
 
     }
     availableBytes = _client->available();      // available from stream
+    if(!availableBytes && !f_webFileDataComplete &&
+       (!f_stream || m_jb.rebuffer || InBuff.bufferFilled() < maxFrameSize)) { // nothing to decode, sleep until data arrives
+        waitForData(AUDIO_READ_WAIT_MS);
+        availableBytes = _client->available();
+    }
+    JB_Arrival(&m_jb, availableBytes, getBitRate() / 8, millis());
 
     // timer, triggers every second - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if((tmr_1s + 1000) < millis()) {
@@ -3191,40 +4046,6 @@ void Audio::processWebStream() {
         }
     }
 
-    // if we have chunked data transfer: get the chunksize- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(m_f_chunked && !m_chunkcount && availableBytes) { // Expecting a new chunkcount?
-        int b;
-        b = _client->read();
-
-        if(b == '\r') return;
-        if(b == '\n'){
-            m_chunkcount = chunksize;
-            chunksize = 0;
-            if(m_f_tts){
-                m_contentlength = m_chunkcount; // tts has one chunk only
-                m_streamType = ST_WEBFILE;
-                m_f_chunked = false;
-            }
-            return;
-        }
-        // We have received a hexadecimal character.  Decode it and add to the result.
-        b = toupper(b) - '0';                       // Be sure we have uppercase
-        if(b > 9) b = b - 7;                        // Translate A..F to 10..15
-        chunksize = (chunksize << 4) + b;
-        return;
-    }
-
-    // if we have metadata: get them - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(!m_metacount && !m_f_swm){
-        int bytes = 0;
-        int res = 0;
-        if(m_f_chunked) bytes = min(m_chunkcount, availableBytes);
-        else bytes = availableBytes;
-        res = readMetadata(bytes);
-        if(m_f_chunked) m_chunkcount -= res;
-        if(!m_metacount) return;
-    }
-
     // if the buffer is often almost empty issue a warning  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(InBuff.bufferFilled() < maxFrameSize && f_stream && !f_webFileDataComplete){
         static uint8_t cnt_slow = 0;
@@ -3238,25 +4059,23 @@ void Audio::processWebStream() {
 
     // if the buffer can't filled for several seconds try a new connection  - - - - - - - - - - - - - - - - - - - - - -
     if(f_stream && !availableBytes && !f_webFileAudioComplete){
-        loopCnt++;
-        if(loopCnt > 200000) {              // wait several seconds
-            loopCnt = 0;
+        if(millis() - lastData > AUDIO_STALL_MS) {
+            lastData = millis();
             AUDIO_INFO("Stream lost -> try new connection");
-            connecttohost(m_lastHost);
+            connecttoRedirect(mirrorFailover(true) ? m_mirrors[m_mirrorIdx] : m_lastHost);
             return;
         }
     }
-    if(availableBytes) loopCnt = 0;
+    if(availableBytes) lastData = millis();
 
     // buffer fill routine  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(true) { // statement has no effect
         uint32_t bytesCanBeWritten = InBuff.writeSpace();
-        if(!m_f_swm)    bytesCanBeWritten = min(m_metacount,  bytesCanBeWritten);
-        if(m_f_chunked) bytesCanBeWritten = min(m_chunkcount, bytesCanBeWritten);
 
-        int16_t bytesAddedToBuffer = 0;
+        int32_t bytesAddedToBuffer = 0;
 
-        // Audiobuffer throttle - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Audiobuffer throttle, below the target depth of the jitter buffer the socket is read in full - - - - - - - -
+        if(JB_ReadLimit(&m_jb, InBuff.bufferFilled(), maxFrameSize) != UINT32_MAX){
             if(m_codec == CODEC_AAC || m_codec == CODEC_MP3 || m_codec == CODEC_M4A){
                 if(bytesCanBeWritten > maxFrameSize) bytesCanBeWritten = maxFrameSize;
             }
@@ -3266,6 +4085,7 @@ void Audio::processWebStream() {
             if(m_codec == CODEC_FLAC){
                 if(bytesCanBeWritten > maxFrameSize) bytesCanBeWritten = maxFrameSize;
             }
+        }
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
         if(m_streamType == ST_WEBFILE){
@@ -3276,16 +4096,23 @@ void Audio::processWebStream() {
             if(byteCounter + bytesCanBeWritten >= m_contentlength) bytesCanBeWritten = m_contentlength - byteCounter;
         }
 
-        bytesAddedToBuffer = _client->read(InBuff.getWritePtr(), bytesCanBeWritten);
+        bytesAddedToBuffer = streamRead(InBuff.getWritePtr(), bytesCanBeWritten);
 
         if(bytesAddedToBuffer > 0) {
-            if(m_streamType == ST_WEBFILE)             byteCounter  += bytesAddedToBuffer;  // Pull request #42
-            if(!m_f_swm)                m_metacount  -= bytesAddedToBuffer;
-            if(m_f_chunked)             m_chunkcount -= bytesAddedToBuffer;
-            InBuff.bytesWritten(bytesAddedToBuffer);
+            JB_Read(&m_jb, bytesAddedToBuffer);
+            uint32_t payload = bytesAddedToBuffer;
+            if(m_f_chunked){                                // the chunk framing is removed in place
+                payload = CK_Decode(&m_chunk, InBuff.getWritePtr(), payload);
+                if(m_f_tts && m_chunk.chunks && m_streamType != ST_WEBFILE){
+                    m_contentlength = m_chunk.first; // tts has one chunk only
+                    m_streamType = ST_WEBFILE;
+                }
+            }
+            if(m_streamType == ST_WEBFILE)             byteCounter  += payload;  // Pull request #42
+            InBuff.bytesWritten(ICY_Demux(&m_icy, InBuff.getWritePtr(), payload)); // the metadata is removed in place
         }
 
-        if(InBuff.bufferFilled() > maxFrameSize && !f_stream) {  // waiting for buffer filled
+        if(!f_stream && JB_Ready(&m_jb, InBuff.bufferFilled(), maxFrameSize)) {  // waiting for the start watermark
             f_stream = true;  // ready to play the audio data
             uint16_t filltime = millis() - m_t0;
 
@@ -3350,6 +4177,7 @@ void Audio::processWebStream() {
 
     // play audio data - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(!f_stream) return; // 1. guard
+    if(!JB_Decode(&m_jb, InBuff.bufferFilled(), maxFrameSize, m_streamType == ST_WEBSTREAM, millis())) return; // underrun, refill
     bool a = InBuff.bufferFilled() >= maxFrameSize;
     bool b = (m_audioDataSize  > 0) && (m_audioDataSize <= audioDataCount + maxFrameSize);
     if(!a && !b) return; // 2. guard   fill < frame && last frame(s)
@@ -3372,7 +4200,7 @@ void Audio::processWebStream() {
         if(byteCounter == m_contentlength){
             if(m_playlistFormat == FORMAT_M3U8){
                 byteCounter = 0;
-                m_metacount = m_metaint;
+                ICY_Reset(&m_icy, m_f_swm ? 0 : m_metaint, icyEvent, this);
                 m_f_continue = true;
                 return;
             }
@@ -3381,7 +4209,7 @@ void Audio::processWebStream() {
         if(m_audioDataSize == audioDataCount &&  m_controlCounter == 100) f_webFileAudioComplete = true;
     }
     else { // not a webfile
-        if(m_controlCounter != 100 && (m_codec == CODEC_OGG || m_codec == CODEC_OGG_FLAC)) {  //application/ogg
+        if(m_controlCounter != 100 && (m_codec == CODEC_OGG || m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS)) {  //application/ogg
             int res = read_OGG_Header(InBuff.getReadPtr(), InBuff.bufferFilled());
             if(res >= 0) bytesDecoded = res;
             else { // error, skip header
@@ -3420,7 +4248,8 @@ void Audio::processWebStreamTS() {
     static int      bytesDecoded;
     static uint32_t byteCounter;                                // count received data
     static uint32_t tmr_1s;                                     // timer 1 sec
-    static uint32_t loopCnt;                                    // count loops if clientbuffer is empty
+    static uint32_t lastData;                                   // millis() of the last data from the stream
+    static bool     f_limited;                                  // the segment was slowed down by a full InBuff
     static uint8_t  ts_packet[188];                             // m3u8 transport stream is 188 bytes long
     uint8_t         ts_packetStart = 0;
     uint8_t         ts_packetLength = 0;
@@ -3435,10 +4264,11 @@ void Audio::processWebStreamTS() {
         byteCounter = 0;
         bytesDecoded = 0;
         chunkSize = 0;
-        loopCnt = 0;
+        lastData = millis();
         tmr_1s = millis();
         m_t0 = millis();
         ts_packetPtr = 0;
+        f_limited = false;
         ts_parsePacket(0, 0, 0); // reset ts routine
         m_controlCounter = 0;
         m_f_firstCall = false;
@@ -3446,15 +4276,30 @@ void Audio::processWebStreamTS() {
 
     if(getDatamode() != AUDIO_DATA) return;        // guard
 
-    if(InBuff.freeSpace() < maxFrameSize && f_stream){playAudioData(); return;}
+    if(InBuff.freeSpace() < maxFrameSize && f_stream){f_limited = true; playAudioData(); return;}
 
     availableBytes = _client->available();
+    if(!availableBytes && InBuff.bufferFilled() < maxFrameSize) { // nothing to decode, sleep until data arrives
+        waitForData(AUDIO_READ_WAIT_MS);
+        availableBytes = _client->available();
+    }
     if(availableBytes){
         if(m_f_chunked) chunkSize = chunkedDataTransfer();
-        int res = _client->read(ts_packet + ts_packetPtr, ts_packetsize - ts_packetPtr);
+        uint32_t len = ts_packetsize - ts_packetPtr;
+        if(m_contentlength && !m_f_chunked && len > m_contentlength - byteCounter){
+            len = m_contentlength - byteCounter;    // the next response may follow (pipelined)
+        }
+        int res = _client->read(ts_packet + ts_packetPtr, len);
         if(res > 0){
             ts_packetPtr += res;
             byteCounter += res;
+            if(ts_packetPtr < ts_packetsize && byteCounter == m_contentlength){ // incomplete last packet
+                hlsSegmentDone(byteCounter, millis() - m_t0, f_limited);
+                ts_packetPtr = 0;
+                byteCounter = 0;
+                m_f_continue = true;
+                return;
+            }
             if(ts_packetPtr < ts_packetsize)  return;
             ts_packetPtr = 0;
             if(f_firstPacket){  // search for ID3 Header in the first packet
@@ -3487,6 +4332,7 @@ void Audio::processWebStreamTS() {
                 }
             }
             if(byteCounter == m_contentlength  || byteCounter == chunkSize){
+                hlsSegmentDone(byteCounter, millis() - m_t0, f_limited);
                 byteCounter = 0;
                 m_f_continue = true;
             }
@@ -3514,15 +4360,14 @@ void Audio::processWebStreamTS() {
 
     // if the buffer can't filled for several seconds try a new connection  - - - - - - - - - - - - - - - - - - - - - -
     if(f_stream && !availableBytes){
-        loopCnt++;
-        if(loopCnt > 200000) {              // wait several seconds
-            loopCnt = 0;
+        if(millis() - lastData > AUDIO_STALL_MS) {
+            lastData = millis();
             AUDIO_INFO("Stream lost -> try new connection");
             httpPrint(m_lastHost);
             return;
         }
     }
-    if(availableBytes) loopCnt = 0;
+    if(availableBytes) lastData = millis();
 
     // buffer fill routine  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(true) { // statement has no effect
@@ -3554,7 +4399,8 @@ void Audio::processWebStreamHLS() {
     static uint32_t byteCounter;                                // count received data
     static size_t   chunkSize = 0;
     static uint32_t tmr_1s;                                     // timer 1 sec
-    static uint32_t loopCnt;                                    // count loops if clientbuffer is empty
+    static uint32_t lastData;                                   // millis() of the last data from the stream
+    static bool     f_limited;                                  // the segment was slowed down by a full InBuff
     (void)bytesDecoded;
     // first call, set some values to default - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(m_f_firstCall) { // runs only ont time per connection, prepare for start
@@ -3562,7 +4408,8 @@ void Audio::processWebStreamHLS() {
         byteCounter = 0;
         bytesDecoded = 0;
         chunkSize = 0;
-        loopCnt = 0;
+        f_limited = false;
+        lastData = millis();
         tmr_1s = millis();
         m_t0 = millis();
          m_f_firstCall = false;
@@ -3571,18 +4418,27 @@ void Audio::processWebStreamHLS() {
     if(getDatamode() != AUDIO_DATA) return;        // guard
 
     availableBytes = _client->available();
+    if(!availableBytes && InBuff.bufferFilled() < maxFrameSize) { // nothing to decode, sleep until data arrives
+        waitForData(AUDIO_READ_WAIT_MS);
+        availableBytes = _client->available();
+    }
     if(availableBytes){
         if(m_f_chunked) chunkSize = chunkedDataTransfer();
         size_t bytesWasWritten = 0;
+        if(m_contentlength && !m_f_chunked && availableBytes > m_contentlength - byteCounter){
+            availableBytes = m_contentlength - byteCounter; // the next response may follow (pipelined)
+        }
         if(InBuff.writeSpace() >= availableBytes){
-            bytesWasWritten = _client->read(InBuff.getWritePtr(), availableBytes);
+            bytesWasWritten = streamRead(InBuff.getWritePtr(), availableBytes);
         }
         else{
-            bytesWasWritten = _client->read(InBuff.getWritePtr(), InBuff.writeSpace());
+            bytesWasWritten = streamRead(InBuff.getWritePtr(), InBuff.writeSpace());
+            f_limited = true;
         }
         InBuff.bytesWritten(bytesWasWritten);
         byteCounter += bytesWasWritten;
         if(byteCounter == m_contentlength || byteCounter == chunkSize){
+            hlsSegmentDone(byteCounter, millis() - m_t0, f_limited);
             byteCounter = 0;
             m_f_continue = true;
         }
@@ -3607,15 +4463,14 @@ void Audio::processWebStreamHLS() {
 
     // if the buffer can't filled for several seconds try a new connection  - - - - - - - - - - - - - - - - - - - - - -
     if(f_stream && !availableBytes){
-        loopCnt++;
-        if(loopCnt > 200000) {              // wait several seconds
-            loopCnt = 0;
+        if(millis() - lastData > AUDIO_STALL_MS) {
+            lastData = millis();
             AUDIO_INFO("Stream lost -> try new connection");
             httpPrint(m_lastHost);
             return;
         }
     }
-    if(availableBytes) loopCnt = 0;
+    if(availableBytes) lastData = millis();
 
     if(InBuff.bufferFilled() > maxFrameSize && !f_stream) {  // waiting for buffer filled
         f_stream = true;  // ready to play the audio data
@@ -3653,21 +4508,34 @@ void Audio::playAudioData(){
 bool Audio::parseHttpResponseHeader() { // this is the response to a GET / request
     static uint32_t notavailablefor = 0;
     if(getDatamode() != HTTP_RESPONSE_HEADER) return false;
+    if(_client->available() == 0 && InBuff.bufferFilled() < InBuff.getMaxBlockSize()) waitForData(AUDIO_READ_WAIT_MS);
     if(_client->available() == 0) {
       if (notavailablefor == 0) notavailablefor = millis();
       if (millis() - notavailablefor > HEADER_TIMEOUT) {
         notavailablefor = 0;
+        bool cancelled = connectCancelled();       // the station has been left while it did not answer
+        if(m_connDone) connector.fail(CN_HEADER, cancelled);
+        m_connDone = 0;
+        m_lastHost[0] = '\0';
+        setDatamode(AUDIO_NONE);
+        stopSong();
+        if(cancelled) return false;
         if(audio_showstation) audio_showstation("");
         if(audio_icydescription) audio_icydescription("");
         if(audio_icyurl) audio_icyurl("");
         AUDIO_ERROR("Host not available");
-        m_lastHost[0] = '\0';
-        setDatamode(AUDIO_NONE);
-        stopSong();
+      #if STREAM_CACHE
+        if(streamCacheRetry()) return false;
+      #endif
+        if(mirrorFailover(false)) connecttoRedirect(m_mirrors[m_mirrorIdx]);
       }
       return false;
     }
     notavailablefor = 0;
+    if(m_connDone){                                 // first byte of the response
+        connector.stage(CN_HEADER, millis() - m_connDone);
+        m_connDone = 0;
+    }
     char rhl[512]; // responseHeaderline
     bool ct_seen = false;
     uint32_t ctime = millis();
@@ -3748,7 +4616,7 @@ bool Audio::parseHttpResponseHeader() { // this is the response to a GET / reque
                         }
                     }
                     AUDIO_INFO("redirect to new host \"%s\"", c_host);
-                    connecttohost(c_host);
+                    connecttoRedirect(c_host);
                     return true;
                 }
             }
@@ -3837,7 +4705,7 @@ bool Audio::parseHttpResponseHeader() { // this is the response to a GET / reque
             if(endsWith(rhl, "chunked") || endsWith(rhl, "Chunked") ) { // Station provides chunked transfer
                 m_f_chunked = true;
                 if(!m_f_Log) AUDIO_INFO("chunked data transfer");
-                m_chunkcount = 0;                         // Expect chunkcount in DATA
+                CK_Reset(&m_chunk);                       // Expect chunkcount in DATA
             }
         }
 
@@ -3855,6 +4723,11 @@ bool Audio::parseHttpResponseHeader() { // this is the response to a GET / reque
     } // outer while
 
     exit:  // termination condition
+        if(connectCancelled()) {m_lastHost[0] = '\0'; setDatamode(AUDIO_NONE); stopSong(); return false;} // station left
+    #if STREAM_CACHE
+        if(streamCacheRetry()) return false;
+    #endif
+        if(mirrorFailover(false)) {connecttoRedirect(m_mirrors[m_mirrorIdx]); return false;}
         if(audio_showstation) audio_showstation("");
         if(audio_icydescription) audio_icydescription("");
         if(audio_icyurl) audio_icyurl("");
@@ -3917,11 +4790,10 @@ bool Audio:: initializeDecoder(){
         case CODEC_WAV:
             InBuff.changeMaxBlockSize(m_frameSizeWav);
             break;
-        case CODEC_OGG:
-            m_codec = CODEC_OGG;
-            AUDIO_INFO("ogg not supported");
-            AUDIO_ERROR("ogg not supported");
-            goto exit;
+        case CODEC_OGG:         // FLAC, OPUS or VORBIS, read_OGG_Header() decides and allocates the decoder
+        case CODEC_OGG_FLAC:
+        case CODEC_OGG_OPUS:
+        case CODEC_OGG_VORBIS:
             break;
         default:
             goto exit;
@@ -3935,56 +4807,34 @@ bool Audio:: initializeDecoder(){
         return false;
 }
 //---------------------------------------------------------------------------------------------------------------------
-uint16_t Audio::readMetadata(uint16_t maxBytes, bool first) {
-
-    static uint16_t pos_ml = 0;                          // determines the current position in metaline
-    static uint16_t metalen = 0;
-    uint16_t res = 0;
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(first){
-        pos_ml = 0;
-        metalen = 0;
-        return 0;
-    }
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(!maxBytes) return 0;  // guard
-
-    if(!metalen) {
-        int b = _client->read();   // First byte of metadata?
-        metalen = b * 16 ;                              // New count for metadata including length byte
-        if(metalen > 512){
-            AUDIO_INFO("Metadata block to long! Skipping all Metadata from now on.");
-            m_f_swm = true;                              // expect stream without metadata
-        }
-        pos_ml = 0; chbuf[pos_ml] = 0;                   // Prepare for new line
-        res = 1;
-    }
-    if(!metalen) {m_metacount = m_metaint; return res;}
-
-    uint16_t a = _client->readBytes(&chbuf[pos_ml], min((uint16_t)(metalen - pos_ml), (uint16_t)(maxBytes -1)));
-    res += a;
-    pos_ml += a;
-    if(pos_ml == metalen) {
-        metalen = 0;
-        chbuf[pos_ml] = '\0';
-        m_metacount = m_metaint;
-        if(strlen(chbuf)) {                             // Any info present?
-            // metaline contains artist and song name.  For example:
-            // "StreamTitle='Don McLean - American Pie';StreamUrl='';"
-            // Sometimes it is just other info like:
-            // "StreamTitle='60s 03 05 Magic60s';StreamUrl='';"
-            // Isolate the StreamTitle, remove leading and trailing quotes if present.
-            if(m_f_Log) log_i("metaline %s", chbuf);
-            latinToUTF8(chbuf, sizeof(chbuf)); // convert to UTF-8 if necessary
-            int pos = indexOf(chbuf, "song_spot", 0);    // remove some irrelevant infos
-            if(pos > 3) {                                // e.g. song_spot="T" MediaBaseId="0" itunesTrackId="0"
-                chbuf[pos] = 0;
-            }
-            showstreamtitle(chbuf);   // Show artist and title if present in metadata
-        }
-        pos_ml = 0;
-    }
-    return res;
+void Audio::icyEvent(void* arg, const char* meta) {
+    static_cast<Audio*>(arg)->icyMetadata(meta);
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::oggIsFLAC(const uint8_t* pkt, uint32_t len) {
+    return len >= 5 && pkt[0] == 0x7F && memcmp(pkt + 1, "FLAC", 4) == 0;
+}
+bool Audio::oggIsOpus(const uint8_t* pkt, uint32_t len) {
+    return len >= 8 && memcmp(pkt, "OpusHead", 8) == 0;
+}
+bool Audio::oggIsVorbis(const uint8_t* pkt, uint32_t len) {
+    return len >= 7 && pkt[0] == 1 && memcmp(pkt + 1, "vorbis", 6) == 0;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::icyMetadata(const char* meta) {
+    // metaline contains artist and song name.  For example:
+    // "StreamTitle='Don McLean - American Pie';StreamUrl='';"
+    // Sometimes it is just other info like:
+    // "StreamTitle='60s 03 05 Magic60s';StreamUrl='';"
+    // Isolate the StreamTitle, remove leading and trailing quotes if present.
+    strlcpy(chbuf, meta, sizeof(chbuf));
+    if(m_f_Log) log_i("metaline %s", chbuf);
+    latinToUTF8(chbuf, sizeof(chbuf)); // convert to UTF-8 if necessary
+    int pos = indexOf(chbuf, "song_spot", 0);    // remove some irrelevant infos
+    if(pos > 3) {                                // e.g. song_spot="T" MediaBaseId="0" itunesTrackId="0"
+        chbuf[pos] = 0;
+    }
+    showstreamtitle(chbuf);   // Show artist and title if present in metadata
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::parseContentType(char* ct) {
@@ -4025,6 +4875,8 @@ bool Audio::parseContentType(char* ct) {
     else if(!strcmp(ct, "video/x-ms-asf"))   ct_val = CT_ASX;
 
     else if(!strcmp(ct, "application/ogg"))  ct_val = CT_OGG;
+    else if(!strcmp(ct, "audio/ogg"))        ct_val = CT_OGG;
+    else if(!strcmp(ct, "audio/opus"))       ct_val = CT_OGG;
     else if(!strcmp(ct, "application/vnd.apple.mpegurl")) ct_val = CT_M3U8;
     else if(!strcmp(ct, "application/x-mpegurl")) ct_val =CT_M3U8;
 
@@ -4218,14 +5070,12 @@ int Audio::findNextSync(uint8_t* data, size_t len){
                               m_flacBitsPerSample, m_flacTotalSamplesInStream, m_audioDataSize);
         nextSync = FLACFindSyncWord(data, len);
     }
-    if(m_codec == CODEC_OGG_FLAC) {
-        FLACSetRawBlockParams(m_flacNumChannels,   m_flacSampleRate,
-                              m_flacBitsPerSample, m_flacTotalSamplesInStream, m_audioDataSize);
-        nextSync = FLACFindSyncWord(data, len);
+    if(m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS) {
+        nextSync = OGG_FindSyncWord(&m_ogg, data, len);
     }
     if(nextSync == -1) {
          if(audio_info && swnf == 0) audio_info("syncword not found");
-         if(m_codec == CODEC_OGG_FLAC){
+         if(m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS){
              nextSync = len;
          }
          else {
@@ -4251,9 +5101,13 @@ int Audio::findNextSync(uint8_t* data, size_t len){
 int Audio::sendBytes(uint8_t* data, size_t len) {
     int bytesLeft;
     static bool f_setDecodeParamsOnce = true;
+    static uint32_t oggChains = 0;
+    static bool f_opusMuted = false;
     int nextSync = 0;
     if(!m_f_playing) {
         f_setDecodeParamsOnce = true;
+        oggChains = m_ogg.chains;
+        f_opusMuted = false;
         nextSync = findNextSync(data, len);
         if(nextSync == 0) { m_f_playing = true;}
         return nextSync;
@@ -4262,6 +5116,7 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
     bytesLeft = len;
     int ret = 0;
     int bytesDecoded = 0;
+    uint32_t t = ESP.getCycleCount();
 
     switch(m_codec){
         case CODEC_WAV:      memmove(m_outBuff, data , len); //copy len data in outbuff and set validsamples and bytesdecoded=len
@@ -4272,9 +5127,15 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
         case CODEC_AAC:      ret = AACDecode(data, &bytesLeft, m_outBuff);    break;
         case CODEC_M4A:      ret = AACDecode(data, &bytesLeft, m_outBuff);    break;
         case CODEC_FLAC:     ret = FLACDecode(data, &bytesLeft, m_outBuff);   break;
-        case CODEC_OGG_FLAC: ret = FLACDecode(data, &bytesLeft, m_outBuff);   break; // FLAC webstream wrapped in OGG
+        case CODEC_OGG_FLAC:                                                          // the pages go through the demuxer,
+        case CODEC_OGG_OPUS:                                                          // the codec gets the packets
+        case CODEC_OGG_VORBIS: ret = OGG_Decode(&m_ogg, data, &bytesLeft, m_outBuff); break;
         default: {log_e("no valid codec found codec = %d", m_codec); stopSong();}
     }
+    t = ESP.getCycleCount() - t;
+    m_stats.decodeFrames++;
+    m_stats.decodeCycles += t;
+    if(t > m_stats.decodeMaxCycles) m_stats.decodeMaxCycles = t;
 
     bytesDecoded = len - bytesLeft;
     if(bytesDecoded == 0 && ret == 0){ // unlikely framesize
@@ -4286,7 +5147,7 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
     }
     if(ret < 0) { // Error, skip the frame...
         if(m_f_Log) if(m_codec == CODEC_M4A){log_i("begin not found"); return 1;}
-        i2s_zero_dma_buffer((i2s_port_t)m_i2s_num);
+        if(!m_outTaskHandle) flushI2S(); // the frame is skipped, the PCM ring plays on (a crossfade too)
         if(!getChannels() && (ret == -2)) {
              ; // suppress errorcode MAINDATA_UNDERFLOW
         }
@@ -4298,6 +5159,18 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
         return bytesDecoded;
     }
     else{  // ret>=0
+        if(m_codec == CODEC_OGG_FLAC || m_codec == CODEC_OGG_OPUS || m_codec == CODEC_OGG_VORBIS){
+            uint8_t ch = m_codec == CODEC_OGG_FLAC ? FLACGetChannels() : m_codec == CODEC_OGG_OPUS ? OPUSGetChannels() : VORBISGetChannels();
+            if(!ch) return bytesDecoded; // identification header not yet read
+            if(m_ogg.chains != oggChains){ // next track of a chained stream, the headers are read
+                oggChains = m_ogg.chains;
+                f_setDecodeParamsOnce = true;
+            }
+        }
+        if(m_codec == CODEC_OGG_OPUS && !f_opusMuted && OPUSGetMutedFrames()){
+            f_opusMuted = true;
+            AUDIO_INFO("Opus stream with SILK or hybrid frames, they are muted (only CELT is decoded)");
+        }
         if(f_setDecodeParamsOnce){
             f_setDecodeParamsOnce = false;
             m_PlayingStartTime = millis();
@@ -4320,7 +5193,21 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
                 setBitsPerSample(FLACGetBitsPerSample());
                 setBitrate(FLACGetBitRate());
             }
+            if(m_codec == CODEC_OGG_OPUS){
+                setChannels(OPUSGetChannels());
+                setSampleRate(OPUSGetSampRate());
+                setBitsPerSample(OPUSGetBitsPerSample());
+                setBitrate(OPUSGetBitRate());
+            }
+            if(m_codec == CODEC_OGG_VORBIS){
+                setChannels(VORBISGetChannels());
+                setSampleRate(VORBISGetSampRate());
+                setBitsPerSample(VORBISGetBitsPerSample());
+                setBitrate(VORBISGetBitRate());
+            }
             showCodecParams();
+            streamCacheStore();
+            m_mirrorTries = 0;
         }
         if(m_codec == CODEC_MP3){
             m_validSamples = MP3GetOutputSamps() / getChannels();
@@ -4331,6 +5218,13 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
         if((m_codec == CODEC_FLAC) || (m_codec == CODEC_OGG_FLAC)){
             m_validSamples = FLACGetOutputSamps() / getChannels();
         }
+        if(m_codec == CODEC_OGG_OPUS){
+            m_validSamples = OPUSGetOutputSamps() / getChannels();
+        }
+        if(m_codec == CODEC_OGG_VORBIS){
+            m_validSamples = VORBISGetOutputSamps() / getChannels();
+        }
+        m_stats.decodeSamples += m_validSamples;
     }
     compute_audioCurrentTime(bytesDecoded);
 
@@ -4357,6 +5251,8 @@ void Audio::compute_audioCurrentTime(int bd) {
     if(m_codec == CODEC_M4A) {setBitrate(AACGetBitrate()) ;} // if not CBR, bitrate can be changed
     if(m_codec == CODEC_AAC) {setBitrate(AACGetBitrate()) ;} // if not CBR, bitrate can be changed
     if(m_codec == CODEC_FLAC){setBitrate(FLACGetBitRate());} // if not CBR, bitrate can be changed
+    if(m_codec == CODEC_OGG_OPUS){setBitrate(OPUSGetBitRate());}
+    if(m_codec == CODEC_OGG_VORBIS){setBitrate(VORBISGetBitRate());}
     if(!getBitRate()) return;
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -4403,6 +5299,15 @@ void Audio::compute_audioCurrentTime(int bd) {
 void Audio::printDecodeError(int r) {
     const char *e;
 
+    if(r <= ERR_OGG_NO_CODEC){ // errors of the demuxer, see container/ogg.h
+        switch(r){
+            case ERR_OGG_NO_CODEC:                          e = "NO CODEC";                         break;
+            case ERR_OGG_CODEC_CHANGED:                     e = "CODEC CHANGED";                    break;
+            default: e = "ERR_UNKNOWN";
+        }
+        AUDIO_INFO("OGG demux error %d : %s", r, e);
+        return;
+    }
     if(m_codec == CODEC_MP3){
         switch(r){
             case ERR_MP3_NONE:                              e = "NONE";                             break;
@@ -4451,7 +5356,7 @@ void Audio::printDecodeError(int r) {
         }
         AUDIO_INFO("AAC decode error %d : %s", r, e);
     }
-    if(m_codec == CODEC_FLAC){
+    if(m_codec == CODEC_FLAC || m_codec == CODEC_OGG_FLAC){
         switch(r){
             case ERR_FLAC_NONE:                             e = "NONE";                             break;
             case ERR_FLAC_BLOCKSIZE_TOO_BIG:                e = "BLOCKSIZE TOO BIG";                break;
@@ -4465,10 +5370,36 @@ void Audio::printDecodeError(int r) {
             case ERR_FLAC_WRONG_RICE_PARTITION_NR:          e = "WRONG RICE PARTITION NR";          break;
             case ERR_FLAC_BITS_PER_SAMPLE_TOO_BIG:          e = "BITS PER SAMPLE > 16";             break;
             case ERR_FLAG_BITS_PER_SAMPLE_UNKNOWN:          e = "BITS PER SAMPLE UNKNOWN";          break;
+            case ERR_FLAC_OGG_HEADER:                       e = "BAD OGG FLAC HEADER";              break;
             default: e = "ERR_UNKNOWN";
         }
         AUDIO_INFO("FLAC decode error %d : %s", r, e);
     }
+    if(m_codec == CODEC_OGG_OPUS){
+        switch(r){
+            case ERR_OPUS_NONE:                             e = "NONE";                             break;
+            case ERR_OPUS_BAD_HEAD:                         e = "BAD OPUSHEAD";                     break;
+            case ERR_OPUS_CHANNEL_MAPPING:                  e = "CHANNEL MAPPING UNSUPPORTED";      break;
+            case ERR_OPUS_INVALID_PACKET:                   e = "INVALID PACKET";                   break;
+            case ERR_OPUS_PACKET_TOO_BIG:                   e = "PACKET TOO BIG";                   break;
+            case ERR_OPUS_CELT:                             e = "CELT FRAME";                       break;
+            default: e = "ERR_UNKNOWN";
+        }
+        AUDIO_INFO("OPUS decode error %d : %s", r, e);
+    }
+    if(m_codec == CODEC_OGG_VORBIS){
+        switch(r){
+            case ERR_VORBIS_NONE:                           e = "NONE";                             break;
+            case ERR_VORBIS_BAD_HEADER:                     e = "BAD HEADER";                       break;
+            case ERR_VORBIS_UNSUPPORTED:                    e = "UNSUPPORTED STREAM";               break;
+            case ERR_VORBIS_SETUP_TOO_BIG:                  e = "SETUP EXCEEDS MEMORY BUDGET";      break;
+            case ERR_VORBIS_NO_SETUP:                       e = "NO SETUP HEADER";                  break;
+            case ERR_VORBIS_INVALID_PACKET:                 e = "INVALID PACKET";                   break;
+            case ERR_VORBIS_PACKET_TOO_BIG:                 e = "PACKET TOO BIG";                   break;
+            default: e = "ERR_UNKNOWN";
+        }
+        AUDIO_INFO("VORBIS decode error %d : %s", r, e);
+    }
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::setPinout(uint8_t BCLK, uint8_t LRC, uint8_t DOUT, int8_t DIN, int8_t MCK) {
@@ -4577,14 +5508,31 @@ bool Audio::audioFileSeek(const float speed) {
     // 1.5 is one and half speed
     if((speed > 1.5f) || (speed < 0.25f)) return false;
 
-    uint32_t srate = getSampleRate() * speed;
-    i2s_set_sample_rates((i2s_port_t)m_i2s_num, srate);
+    uint32_t srate = getOutputRate() * speed;
+    setI2Srate(srate);
     return true;
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::setSampleRate(uint32_t sampRate) {
     if(!sampRate) sampRate = 16000; // fuse, if there is no value -> set default #209
-    i2s_set_sample_rates((i2s_port_t)m_i2s_num, sampRate);
+    uint32_t outRate = sampRate;
+#if AUDIO_RESAMPLE_RATE > 0
+    if(!m_rs.buf) {
+        void* mem = heap_caps_malloc(RS_MEM_SIZE(I2S_BLOCK_FRAMES), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if(mem) RS_Init(&m_rs, mem, I2S_BLOCK_FRAMES, AUDIO_RESAMPLE_QUALITY);
+        else    log_e("not enough internal RAM for the resampler, the I2S rate follows the stream");
+    }
+    if(m_rs.buf) outRate = AUDIO_RESAMPLE_RATE;
+#endif
+    if(m_xfSrc.codec != CODEC_NONE && outRate != m_xfSrc.rate) xfadeEnd(false); // the I2S clock changes, cut
+#if AUDIO_RESAMPLE_RATE > 0
+    if(m_rs.buf) {  // the I2S clock stays at AUDIO_RESAMPLE_RATE, no reconfiguration on a station change
+        RS_SetRate(&m_rs, sampRate, AUDIO_RESAMPLE_RATE);   // bypassed if the stream has this rate
+        if(m_i2sRate != AUDIO_RESAMPLE_RATE) setI2Srate(AUDIO_RESAMPLE_RATE);
+    }
+    else
+#endif
+    setI2Srate(sampRate);
     m_sampleRate = sampRate;
     IIR_calculateCoefficients(m_gain0, m_gain1, m_gain2); // must be recalculated after each samplerate change
     return true;
@@ -4592,6 +5540,9 @@ bool Audio::setSampleRate(uint32_t sampRate) {
 uint32_t Audio::getSampleRate(){
     return m_sampleRate;
 }
+uint32_t Audio::getOutputRate(){
+    return m_rs.buf ? m_rs.outRate : m_sampleRate;
+}
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::setBitsPerSample(int bits) {
     if((bits != 16) && (bits != 8)) return false;
@@ -4655,40 +5606,6 @@ void Audio::setI2SCommFMT_LSB(bool commFMT) {
     i2s_driver_install  ((i2s_port_t)m_i2s_num, &m_i2s_config, 0, NULL);
 }
 //---------------------------------------------------------------------------------------------------------------------
-bool Audio::playSample(int16_t sample[2]) {
-
-    if (getBitsPerSample() == 8) { // Upsample from unsigned 8 bits to signed 16 bits
-        sample[LEFTCHANNEL]  = ((sample[LEFTCHANNEL]  & 0xff) -128) << 8;
-        sample[RIGHTCHANNEL] = ((sample[RIGHTCHANNEL] & 0xff) -128) << 8;
-    }
-
-    sample[LEFTCHANNEL]  = sample[LEFTCHANNEL]  >> 1; // half Vin so we can boost up to 6dB in filters
-    sample[RIGHTCHANNEL] = sample[RIGHTCHANNEL] >> 1;
-
-    // Filterchain, can commented out if not used
-    sample = IIR_filterChain0(sample);
-    sample = IIR_filterChain1(sample);
-    sample = IIR_filterChain2(sample);
-    //-------------------------------------------
-    _computeVUlevel(sample);
-    uint32_t s32 = Gain(sample); // vosample2lume;
-
-    if(m_f_internalDAC) {
-        s32 += 0x80008000;
-    }
-    m_i2s_bytesWritten = 0;
-    esp_err_t err = i2s_write((i2s_port_t) m_i2s_num, (const char*) &s32, sizeof(uint32_t), &m_i2s_bytesWritten, 100);
-    if(err != ESP_OK) {
-        log_e("ESP32 Errorcode %i", err);
-        return false;
-    }
-    if(m_i2s_bytesWritten < 4) {
-        log_e("Can't stuff any more in I2S..."); // increase waitingtime or outputbuffer
-        return false;
-    }
-    return true;
-}
-//---------------------------------------------------------------------------------------------------------------------
 void Audio::setTone(int8_t gainLowPass, int8_t gainBandPass, int8_t gainHighPass){
     // see https://www.earlevel.com/main/2013/10/13/biquad-calculator-v2/
     // values can be between -40 ... +6 (dB)
@@ -4700,16 +5617,9 @@ void Audio::setTone(int8_t gainLowPass, int8_t gainBandPass, int8_t gainHighPass
     IIR_calculateCoefficients(m_gain0, m_gain1, m_gain2);
 
     /*
-        This will cause a clicking sound when adjusting the EQ.
-        Because when the EQ is adjusted, the IIR filter will be cleared and played,
-        mixed in the audio data frame, and a click-like sound will be produced.
-    */
-    /*
-    int16_t tmp[2]; tmp[0] = 0; tmp[1]= 0;
-
-    IIR_filterChain0(tmp, true ); // flush the filter
-    IIR_filterChain1(tmp, true ); // flush the filter
-    IIR_filterChain2(tmp, true ); // flush the filter
+        The filter history is not cleared, this would cause a clicking sound when adjusting the EQ.
+        The audio path takes the new coefficients at the next block and cross-fades the changed
+        bands from the old to the new coefficients over that block.
     */
 }
 //---------------------------------------------------------------------------------------------------------------------
@@ -4721,11 +5631,13 @@ void Audio::setBalance(int8_t bal){ // bal -16...16
     if(bal < -16) bal = -16;
     if(bal >  16) bal =  16;
     m_balance = bal;
+    updateGain();
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::setVolume(uint8_t vol) { // vol 22 steps, 0...21
     if(vol > 254) vol = 254;
     m_vol = vol;
+    updateGain();
 /*    if(vol > 21) vol = 21;
     m_vol = volumetable[vol];*/
     //Serial.printf(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>Volume set to %u\n", m_vol);
@@ -4744,24 +5656,19 @@ uint8_t Audio::getI2sPort() {
     return m_i2s_num;
 }
 //---------------------------------------------------------------------------------------------------------------------
-int32_t Audio::Gain(int16_t s[2]) {
-    int32_t v[2];
-    float step = (float)m_vol /254;
-    uint8_t l = 0, r = 0;
-
-    if(m_balance < 0){
-        step = step * (float)(abs(m_balance) * 16);
-        l = (uint8_t)(step);
-    }
-    if(m_balance > 0){
-        step = step * m_balance * 16;
-        r = (uint8_t)(step);
-    }
-
-    v[LEFTCHANNEL] = (s[LEFTCHANNEL]  * (m_vol - l)) >> 8;
-    v[RIGHTCHANNEL]= (s[RIGHTCHANNEL] * (m_vol - r)) >> 8;
-
-    return (v[LEFTCHANNEL] << 16) | (v[RIGHTCHANNEL] & 0xffff);
+void Audio::updateGain() {
+    // L/R gain factors (Q15) for the gain stage, recomputed only when volume or balance change,
+    // the audio path ramps to the new values over one block
+    int32_t l = 0, r = 0;
+
+    if(m_balance < 0) l = (m_vol * abs(m_balance) * 16) / 254;
+    if(m_balance > 0) r = (m_vol * m_balance * 16) / 254;
+    if(l > m_vol) l = m_vol;
+    if(r > m_vol) r = m_vol;
+
+    portENTER_CRITICAL(&m_bqMux);
+    BQ_SetGain(&m_bqChain, (m_vol - l) << 7, (m_vol - r) << 7); // (vol - l) / 256
+    portEXIT_CRITICAL(&m_bqMux);
 }
 //---------------------------------------------------------------------------------------------------------------------
 uint32_t Audio::inBufferFilled() {
@@ -4783,7 +5690,7 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
     // G3 - gain high shelf  set between -40 ... +6 dB
     // https://www.earlevel.com/main/2012/11/26/biquad-c-source-code/
 
-    if(getSampleRate() < 1000) return;  // fuse
+    if(getOutputRate() < 1000) return;  // fuse
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -4801,7 +5708,7 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
     float K, norm, Q, Fc, V ;
 
     // LOWSHELF
-    Fc = (float)FcLS / (float)getSampleRate(); // Cutoff frequency
+    Fc = (float)FcLS / (float)getOutputRate(); // Cutoff frequency
     K = tanf((float)PI * Fc);
     V = powf(10, fabs(G0) / 20.0);
 
@@ -4823,7 +5730,7 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
     }
 
     // PEAK EQ
-    Fc = (float)FcPKEQ / (float)getSampleRate(); // Cutoff frequency
+    Fc = (float)FcPKEQ / (float)getOutputRate(); // Cutoff frequency
     K = tanf((float)PI * Fc);
     V = powf(10, fabs(G1) / 20.0);
     Q = 2.5; // Quality factor
@@ -4845,7 +5752,7 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
     }
 
     // HIGHSHELF
-    Fc = (float)FcHS / (float)getSampleRate(); // Cutoff frequency
+    Fc = (float)FcHS / (float)getOutputRate(); // Cutoff frequency
     K = tanf((float)PI * Fc);
     V = powf(10, fabs(G2) / 20.0);
     if (G2 >= 0) {  // boost
@@ -4865,6 +5772,14 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
         m_filter[HIFGSHELF].b2 = (V - sqrtf(2*V) * K + K * K) * norm;
     }
 
+    int8_t G[3] = {G0, G1, G2};
+    portENTER_CRITICAL(&m_bqMux);
+    for(uint8_t i = 0; i < 3; i++) {  // 0dB is a flat filter, such bands are bypassed
+        BQ_SetStage(&m_bqChain, i, m_filter[i].a0, m_filter[i].a1, m_filter[i].a2,
+                                   m_filter[i].b1, m_filter[i].b2, G[i] != 0);
+    }
+    portEXIT_CRITICAL(&m_bqMux);
+
 //    log_i("LS a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[0].a0, m_filter[0].a1, m_filter[0].a2,
 //                                                  m_filter[0].b1, m_filter[0].b2);
 //    log_i("EQ a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[1].a0, m_filter[1].a1, m_filter[1].a2,
@@ -4872,147 +5787,6 @@ void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infi
 //    log_i("HS a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[2].a0, m_filter[2].a1, m_filter[2].a2,
 //                                                  m_filter[2].b1, m_filter[2].b2);
 }
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain0(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[0].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[0].a1  * m_filterBuff[0][z1][in] [LEFTCHANNEL]
-                             + m_filter[0].a2  * m_filterBuff[0][z2][in] [LEFTCHANNEL]
-                             - m_filter[0].b1  * m_filterBuff[0][z1][out][LEFTCHANNEL]
-                             - m_filter[0].b2  * m_filterBuff[0][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[0][z2][in] [LEFTCHANNEL]  = m_filterBuff[0][z1][in][LEFTCHANNEL];
-    m_filterBuff[0][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[0][z2][out][LEFTCHANNEL]  = m_filterBuff[0][z1][out][LEFTCHANNEL];
-    m_filterBuff[0][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[0].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[0].a1 * m_filterBuff[0][z1][in] [RIGHTCHANNEL]
-                             + m_filter[0].a2 * m_filterBuff[0][z2][in] [RIGHTCHANNEL]
-                             - m_filter[0].b1 * m_filterBuff[0][z1][out][RIGHTCHANNEL]
-                             - m_filter[0].b2 * m_filterBuff[0][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[0][z2][in] [RIGHTCHANNEL] = m_filterBuff[0][z1][in][RIGHTCHANNEL];
-    m_filterBuff[0][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[0][z2][out][RIGHTCHANNEL] = m_filterBuff[0][z1][out][RIGHTCHANNEL];
-    m_filterBuff[0][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain1(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[1].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[1].a1  * m_filterBuff[1][z1][in] [LEFTCHANNEL]
-                             + m_filter[1].a2  * m_filterBuff[1][z2][in] [LEFTCHANNEL]
-                             - m_filter[1].b1  * m_filterBuff[1][z1][out][LEFTCHANNEL]
-                             - m_filter[1].b2  * m_filterBuff[1][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[1][z2][in] [LEFTCHANNEL]  = m_filterBuff[1][z1][in][LEFTCHANNEL];
-    m_filterBuff[1][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[1][z2][out][LEFTCHANNEL]  = m_filterBuff[1][z1][out][LEFTCHANNEL];
-    m_filterBuff[1][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[1].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[1].a1 * m_filterBuff[1][z1][in] [RIGHTCHANNEL]
-                             + m_filter[1].a2 * m_filterBuff[1][z2][in] [RIGHTCHANNEL]
-                             - m_filter[1].b1 * m_filterBuff[1][z1][out][RIGHTCHANNEL]
-                             - m_filter[1].b2 * m_filterBuff[1][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[1][z2][in] [RIGHTCHANNEL] = m_filterBuff[1][z1][in][RIGHTCHANNEL];
-    m_filterBuff[1][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[1][z2][out][RIGHTCHANNEL] = m_filterBuff[1][z1][out][RIGHTCHANNEL];
-    m_filterBuff[1][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain2(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[2].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[2].a1  * m_filterBuff[2][z1][in] [LEFTCHANNEL]
-                             + m_filter[2].a2  * m_filterBuff[2][z2][in] [LEFTCHANNEL]
-                             - m_filter[2].b1  * m_filterBuff[2][z1][out][LEFTCHANNEL]
-                             - m_filter[2].b2  * m_filterBuff[2][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[2][z2][in] [LEFTCHANNEL]  = m_filterBuff[2][z1][in][LEFTCHANNEL];
-    m_filterBuff[2][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[2][z2][out][LEFTCHANNEL]  = m_filterBuff[2][z1][out][LEFTCHANNEL];
-    m_filterBuff[2][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[2].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[2].a1 * m_filterBuff[2][z1][in] [RIGHTCHANNEL]
-                             + m_filter[2].a2 * m_filterBuff[2][z2][in] [RIGHTCHANNEL]
-                             - m_filter[2].b1 * m_filterBuff[2][z1][out][RIGHTCHANNEL]
-                             - m_filter[2].b2 * m_filterBuff[2][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[2][z2][in] [RIGHTCHANNEL] = m_filterBuff[2][z1][in][RIGHTCHANNEL];
-    m_filterBuff[2][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[2][z2][out][RIGHTCHANNEL] = m_filterBuff[2][z1][out][RIGHTCHANNEL];
-    m_filterBuff[2][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
 //----------------------------------------------------------------------------------------------------------------------
 //    AAC - T R A N S P O R T S T R E A M
 //----------------------------------------------------------------------------------------------------------------------
@@ -19,7 +19,21 @@
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 #include <vector>
+#include <atomic>
 #include <driver/i2s.h>
+#include "dsp/biquad.h"
+#include "dsp/vumeter.h"
+#include "dsp/spectrum.h"
+#include "dsp/resampler.h"
+#include "dsp/crossfade.h"
+#include "dsp/pcmring.h"
+#include "net/jitter.h"
+#include "net/abr.h"
+#include "net/icy.h"
+#include "net/chunked.h"
+#include "container/ogg.h"
+#include "../core/streamcache.h"
+#include "../core/tlssession.h"
 
 #ifdef SDFATFS_USED
 #include <SdFat.h>  // https://github.com/greiman/SdFat
@@ -90,10 +104,59 @@ extern __attribute__((weak)) void audio_process_extern(int16_t* buff, uint16_t l
 extern __attribute__((weak)) void audio_progress(uint32_t startpos, uint32_t endpos);
 extern __attribute__((weak)) void audio_error(const char*);
 
+#ifndef I2S_BLOCK_FRAMES
+  #define I2S_BLOCK_FRAMES  256   // stereo frames per i2s_write(), must be even
+#endif
+#ifndef MIRRORS_MAX
+  #define MIRRORS_MAX       8     // urls kept per stream (mirrors of the station, entries of a pls/m3u)
+#endif
+
 #define AUDIO_INFO(...) {char buff[512 + 64]; sprintf(buff,__VA_ARGS__); if(audio_info) audio_info(buff);}
 #define AUDIO_ERROR(...) {char buff[512 + 64]; sprintf(buff,__VA_ARGS__); if(audio_error) audio_error(buff);}
 //----------------------------------------------------------------------------------------------------------------------
 
+typedef struct {
+    uint32_t frames;            // stereo frames handed to the I2S DMA
+    uint32_t i2sWrites;         // number of i2s_write() calls
+    uint32_t i2sRetries;        // blocks whose tail did not fit into the DMA and went out with the next one
+    uint32_t i2sDropped;        // frames lost because the DMA took neither the tail nor the block behind it
+    uint64_t dspCycles;         // CPU cycles in unpack, filters, VU and gain
+    uint64_t i2sCycles;         // CPU cycles in i2s_write(), including the wait for a free DMA buffer
+    uint32_t underruns;         // PCM ring ran dry while a stream was running (output task only)
+    uint64_t spectrumCycles;    // CPU cycles in getSpectrum() (FFT and bands, caller's task)
+    uint32_t spectrumUpdates;
+    uint32_t zaps;              // station changes (zapStart()) that reached the first decoded frames
+    uint32_t warmZaps;          // of them on a warm connection of the prefetcher
+    uint32_t cachedZaps;        // of them with a resolved stream from the stream cache
+    uint32_t zapMs;             // last one: play request to the first decoded frames
+    uint32_t zapMaxMs;
+    uint64_t zapSumMs;
+    uint64_t cachedZapSumMs;    // of zapSumMs, the cached zaps (time to first audio with and without the stream cache)
+    bool     zapWarm;           // last one was warm
+    uint32_t hlsSegments;       // m3u8 segments requested
+    uint32_t hlsPipelined;      // of them sent on the keep-alive connection while the previous one was read
+    uint32_t hlsSwitches;       // variant changes of the master playlist
+    uint32_t hlsBandwidth;      // BANDWIDTH of the variant that is played, bit/s
+    uint32_t hlsThroughput;     // estimated segment throughput, bit/s
+    uint32_t mirrorRaces;       // connects raced across the mirrors of a station
+    uint32_t mirrorRaceWins;    // of them won by an other mirror than the first candidate
+    uint32_t mirrorFailovers;   // connect, header or stall failures that moved on to the next mirror
+    uint32_t recvDirect;        // stream bytes read from the socket straight into InBuff (streamRead())
+    uint32_t recvClient;        // stream bytes read through the client (TLS, buffered data)
+    uint64_t recvDirectCycles;  // CPU cycles of the reads
+    uint64_t recvClientCycles;
+    uint32_t decodeFrames;      // sendBytes() calls that ran a decoder
+    uint32_t decodeSamples;     // samples per channel out of them
+    uint64_t decodeCycles;      // CPU cycles in the decoders
+    uint32_t decodeMaxCycles;   // slowest call
+    uint32_t xfades;            // crossfades that have reached the new station or track
+    uint32_t xfadeMs;           // last one: overlap, both decoders running
+    uint64_t xfadeCycles;       // last one: CPU cycles of the fading stream (read, decode, resample, mix) in the overlap
+    uint32_t xfadeLoad;         // last one: of them in per mille of one core
+    uint32_t xfadeMaxLoad;
+} audioStats_t;
+//----------------------------------------------------------------------------------------------------------------------
+
 class AudioBuffer {
 // AudioBuffer will be allocated in PSRAM, If PSRAM not available or has not enough space AudioBuffer will be
 // allocated in FlashRAM with reduced size
@@ -140,6 +203,7 @@ public:
     uint32_t getReadPos();                      // read position relative to the beginning
     void     resetBuffer();                     // restore defaults
     bool     havePSRAM() { return m_f_psram; };
+    size_t   getBufsize() { return m_buffSize; };   // usable size without the reserved space
 
 protected:
     size_t   m_buffSizePSRAM    = 300000;   // most webstreams limit the advance to 100...300Kbytes
@@ -163,6 +227,9 @@ protected:
 //----------------------------------------------------------------------------------------------------------------------
 
 struct Audio;
+struct MP3Decoder;
+struct AACDecoder;
+struct FLACDecoder;
 
 class Audio : private AudioBuffer{
 
@@ -173,6 +240,7 @@ public:
     ~Audio();
     void setBufsize(int rambuf_sz, int psrambuf_sz);
     bool connecttohost(const char* host, const char* user = "", const char* pwd = "");
+    bool connecttoMirrors(const char* host, const char* mirrors); // mirrors: more urls of the stream, "url|url|.."
     bool connecttospeech(const char* speech, const char* lang);
     bool connecttomarytts(const char* speech, const char* lang, const char* voice);
     bool connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos = 0);
@@ -187,7 +255,7 @@ public:
     bool pauseResume();
     bool isRunning() {return m_f_running;}
     void loop();
-    uint32_t stopSong();
+    uint32_t stopSong(bool keepFade = false);
     void forceMono(bool m);
     void setBalance(int8_t bal = 0);
     void setVolume(uint8_t vol);
@@ -198,6 +266,7 @@ public:
     uint32_t getFileSize();
     uint32_t getFilePos();
     uint32_t getSampleRate();
+    uint32_t getOutputRate();                       // I2S rate, AUDIO_RESAMPLE_RATE when the resampler is used
     uint8_t  getBitsPerSample();
     uint8_t  getChannels();
     uint32_t getBitRate(bool avg = false);
@@ -205,11 +274,13 @@ public:
     uint32_t getAudioCurrentTime();
     uint32_t getTotalPlayingTime();
 
-    void setDefaults();
+    void setDefaults(bool keepFade = false);
     /* VU METER */
     void     setVUmeter() {};
     void     getVUlevel() {};
     uint16_t get_VUlevel(uint16_t dimension);
+    uint16_t get_VUhold(uint16_t dimension);
+    void     getVUlevels(vuLevels_t* levels);   // peak, hold, rms 0...32767 (I2S output, pre volume)
     
     bool     eofHeader;
     esp_err_t i2s_mclk_pin_select(const uint8_t pin);
@@ -219,6 +290,21 @@ public:
     void setI2SCommFMT_LSB(bool commFMT);
     int getCodec() {return m_codec;}
     const char *getCodecname() {return codecname[m_codec];}
+    const audioStats_t& getStats() {return m_stats;}
+    bool benchOutputBlock(const int16_t* pcm, uint16_t frames, uint32_t rate); // stereo PCM through processI2Sblock(), writeI2Sblock()
+    void resetStats();
+    void zapStart(bool start = true) {m_zapStart = start ? millis() | 1 : 0;} // times the next station change
+    bool connectCancelled();                        // the last connect was ended by connector.cancel(), no error
+    const jitterBuf_t& getJitterBuf() {return m_jb;} // web stream input buffer control, see net/jitter.h
+    bool startOutputTask();                         // decoder and I2S output decoupled by the PCM ring
+    bool hasOutputTask() {return m_outTaskHandle != NULL;}
+    size_t ringFilled() {return m_ring.filled();}   // frames
+    size_t ringSize() {return m_ring.size();}
+    bool startSpectrum();                           // PCM tap for getSpectrum(), see dsp/spectrum.h
+    bool getSpectrum(uint8_t* levels, uint8_t bands); // levels 0...255, false: no new samples
+    void setCrossfade(uint16_t ms);                 // 500...5000 ms, 0: hard cut on station changes and track ends
+    uint16_t getCrossfade() {return m_xfadeMs;}
+    bool isCrossfading() {return m_xfSrc.codec != CODEC_NONE;}
 private:
 
     #ifndef ESP_ARDUINO_VERSION_VAL
@@ -231,11 +317,22 @@ private:
     bool latinToUTF8(char* buff, size_t bufflen);
     //void setDefaults(); // free buffers and set defaults
     void initInBuff();
-    bool httpPrint(const char* host);
+    bool httpPrint(const char* host, bool pipeline = false);
     void processLocalFile();
     void processWebStream();
     void processWebStreamTS();
     void processWebStreamHLS();
+    bool waitForData(uint32_t timeoutMs);
+    int  streamRead(uint8_t* buf, uint32_t len);
+    bool connecttoRedirect(const char* host);
+    bool sameUrl(const char* host, const char* url);
+    void mirrorsSet(const char* host, const char* mirrors);
+    void mirrorsAdd(std::vector<char*>& vec, const char* url, size_t len);
+    void mirrorsFromPlaylist(std::vector<char*>& urls);
+    bool mirrorFailover(bool rotate);
+    int  mirrorRace();
+    void streamCacheStore();
+    bool streamCacheRetry();
     void playAudioData();
     size_t chunkedDataTransfer();
     bool readPlayListData();
@@ -243,6 +340,10 @@ private:
     const char* parsePlaylist_PLS();
     const char* parsePlaylist_ASX();
     const char* parsePlaylist_M3U8();
+    const char* popPlaylistURL();
+    void hlsPipeline();
+    bool hlsTakePending();
+    void hlsSegmentDone(uint32_t bytes, uint32_t ms, bool limited);
     bool STfromEXTINF(char* str);
     void showCodecParams();
     int  findNextSync(uint8_t* data, size_t len);
@@ -263,28 +364,47 @@ private:
     bool setChannels(int channels);
     bool setBitrate(int br);
     bool playChunk();
-    bool playSample(int16_t sample[2]) ;
+    uint16_t fillI2Sblock(int16_t* dst);
+    uint16_t nextI2Sblock(int16_t* dst);
+    void processI2Sblock(uint16_t frames);
+    bool writeI2Sblock(uint16_t frames);
+    bool writeI2Sframes(const uint32_t* src, uint16_t frames);
+    void flushI2Stail();
     void playI2Sremains();
-    int32_t Gain(int16_t s[2]);
+    static void outputTask(void* pvParams);
+    void outputLoop();
+    void flushI2S();
+    void setI2Srate(uint32_t hz);
+    void updateGain();
     bool fill_InputBuf();
     void showstreamtitle(const char* ml);
     bool parseContentType(char* ct);
     bool parseHttpResponseHeader();
     bool initializeDecoder();
-    uint16_t readMetadata(uint16_t b, bool first = false);
+    void icyMetadata(const char* meta);
+    static void icyEvent(void* arg, const char* meta);
+    static bool oggIsFLAC(const uint8_t* pkt, uint32_t len);
+    static bool oggIsOpus(const uint8_t* pkt, uint32_t len);
+    static bool oggIsVorbis(const uint8_t* pkt, uint32_t len);
     esp_err_t I2Sstart(uint8_t i2s_num);
     esp_err_t I2Sstop(uint8_t i2s_num);
     void urlencode(char* buff, uint16_t buffLen, bool spacesOnly = false);
-    int16_t* IIR_filterChain0(int16_t iir_in[2], bool clear = false);
-    int16_t* IIR_filterChain1(int16_t* iir_in, bool clear = false);
-    int16_t* IIR_filterChain2(int16_t* iir_in, bool clear = false);
     inline void setDatamode(uint8_t dm){m_datamode=dm;}
     inline uint8_t getDatamode(){return m_datamode;}
     inline uint32_t streamavail(){ return _client ? _client->available() : 0;}
     void IIR_calculateCoefficients(int8_t G1, int8_t G2, int8_t G3);
     bool ts_parsePacket(uint8_t* packet, uint8_t* packetStart, uint8_t* packetLength);
-    void _computeVUlevel(int16_t sample[2]);
-    static void connectTask(void* pvParams);
+    bool connectClient(const char* host, uint16_t port);
+    bool xfadeReady();
+    void xfadeBegin();
+    void xfadeEnd(bool done);
+    bool xfadeDecode();
+    uint16_t xfadeUnpack(int16_t* dst, uint16_t frames);
+    uint16_t xfadeRead(int16_t* dst, uint16_t frames);
+    void xfadeFeed();
+    void xfadePump();
+    void xfadeMix(int16_t* dst, uint16_t frames);
+    static void xfadeIdle(void* arg);
     // implement several function with respect to the index of string
     void trim(char *s) {
     //fb   trim in place
@@ -430,7 +550,7 @@ private:
   }
 
 private:
-    const char *codecname[9] = {"unknown", "WAV", "MP3", "AAC", "M4A", "FLAC", "OGG", "OGG FLAC", "OPUS"};
+    const char *codecname[11] = {"unknown", "WAV", "MP3", "AAC", "M4A", "FLAC", "OGG", "OGG FLAC", "OPUS", "AACP", "VORBIS"};
     enum : int { APLL_AUTO = -1, APLL_ENABLE = 1, APLL_DISABLE = 0 };
     enum : int { EXTERNAL_I2S = 0, INTERNAL_DAC = 1, INTERNAL_PDM = 2 };
     enum : int { FORMAT_NONE = 0, FORMAT_M3U = 1, FORMAT_PLS = 2, FORMAT_ASX = 3, FORMAT_M3U8 = 4};
@@ -440,10 +560,11 @@ private:
                  FLAC_SEEK = 6, FLAC_VORBIS = 7, FLAC_CUESHEET = 8, FLAC_PICTURE = 9, FLAC_OKAY = 100};
     enum : int { M4A_BEGIN = 0, M4A_FTYP = 1, M4A_CHK = 2, M4A_MOOV = 3, M4A_FREE = 4, M4A_TRAK = 5, M4A_MDAT = 6,
                  M4A_ILST = 7, M4A_MP4A = 8, M4A_AMRDY = 99, M4A_OKAY = 100};
-    enum : int { OGG_BEGIN = 0, OGG_MAGIC = 1, OGG_HEADER = 2, OGG_FIRST = 3, OGG_AMRDY = 99, OGG_OKAY = 100};
+    enum : int { OGG_BEGIN = 0, OGG_MAGIC = 1, OGG_AMRDY = 99, OGG_OKAY = 100};
     enum : int { CODEC_NONE = 0, CODEC_WAV = 1, CODEC_MP3 = 2, CODEC_AAC = 3, CODEC_M4A = 4, CODEC_FLAC = 5,
-                 CODEC_OGG = 6, CODEC_OGG_FLAC = 7, CODEC_OGG_OPUS = 8, CODEC_AACP = 9};
+                 CODEC_OGG = 6, CODEC_OGG_FLAC = 7, CODEC_OGG_OPUS = 8, CODEC_AACP = 9, CODEC_OGG_VORBIS = 10};
     enum : int { ST_NONE = 0, ST_WEBFILE = 1, ST_WEBSTREAM = 2};
+    enum : int { HLS_NONE = 0, HLS_SEGMENT = 1, HLS_PLAYLIST = 2, HLS_SKIP = 3};
     typedef enum { LEFTCHANNEL=0, RIGHTCHANNEL=1 } SampleIndex;
     typedef enum { LOWSHELF = 0, PEAKEQ = 1, HIFGSHELF =2 } FilterType;
 
@@ -463,31 +584,53 @@ private:
         int pids[4];
     } pid_array;
 
+    struct xfSource_t {                             // the station or track that fades out, see xfadeBegin()
+        uint8_t       codec = CODEC_NONE;           // CODEC_MP3, CODEC_AAC, CODEC_FLAC, CODEC_NONE: no fade
+        MP3Decoder*   mp3 = NULL;                   // decoder context taken over from the stream
+        AACDecoder*   aac = NULL;
+        FLACDecoder*  flac = NULL;
+        uint8_t*      buf = NULL;                   // PSRAM: AUDIO_XFADE_MEM bytes of stream data, then pcm
+        uint32_t      rd = 0, wr = 0;               // stream data in buf
+        uint32_t      window = 0;                   // decoder input per call (max block size of InBuff)
+        int16_t*      pcm = NULL;                   // decoded frame, interleaved
+        int16_t*      blk = NULL;                   // output block for xfadeMix()
+        uint16_t      valid = 0, cur = 0;           // frames in pcm, next one
+        uint8_t       channels = 2;
+        uint8_t       errors = 0;                   // decode errors in a row
+        bool          pending = false;              // FLAC: the rest of the block comes with the next call
+        bool          ended = false;                // no more stream data
+        bool          fromClient = false;           // the stream data is read on from client (http)
+        bool          fromFile = false;             // or from file
+        bool          chunked = false;
+        WiFiClient    client;                       // shares the socket with the client of the old connection
+        File          file;                         // taken over from audiofile
+        uint32_t      fileEnd = 0;                  // end of the audio block in file
+        icyDemux_t    icy = {};                     // copies, the old station's metadata is dropped
+        chunked_t     chunk = {};
+        resampler_t   rs = {};                      // m_rs of the old stream if it was resampled
+        uint32_t      rate = 0;                     // output rate of the fade
+    };
+
     File                  audiofile;    // @suppress("Abstract class cannot be instantiated")
     WiFiClient            client;       // @suppress("Abstract class cannot be instantiated")
-    WiFiClientSecure      clientsecure; // @suppress("Abstract class cannot be instantiated")
+    TlsClient             clientsecure; // @suppress("Abstract class cannot be instantiated")
     WiFiClient*           _client = nullptr;
     i2s_config_t          m_i2s_config = {}; // stores values for I2S driver
     i2s_pin_config_t      m_pin_config = {};
     std::vector<char*>    m_playlistContent; // m3u8 playlist buffer
     std::vector<char*>    m_playlistURL;     // m3u8 streamURLs buffer
+    std::vector<int64_t>  m_playlistSeq;     // media sequence numbers of m_playlistURL, -1: unknown
     std::vector<uint32_t> m_hashQueue;
-    
-    struct ConnectParams {
-      char *hostwoext = nullptr;
-      uint16_t port = 80;
-      Audio* instance = nullptr;
-      
-      ConnectParams(char* h, uint16_t p, Audio* a)
-        : hostwoext(h), port(p), instance(a) {}
-    };
-    volatile bool _connectionResult;
-    TaskHandle_t _connectTaskHandle = nullptr;
+    std::vector<char*>    m_hlsVariantURL;   // m3u8 master playlist: media playlists of the variants
+    std::vector<uint32_t> m_hlsBandwidth;    // BANDWIDTH of the variants, bit/s
+    std::vector<char*>    m_mirrors;         // urls of the stream: mirrors of the station or the entries of a pls/m3u
     
     const size_t    m_frameSizeWav  = 1600;
     const size_t    m_frameSizeMP3  = 1600;
     const size_t    m_frameSizeAAC  = 1600;
     const size_t    m_frameSizeFLAC = 4096 * 4;
+    const size_t    m_frameSizeOPUS = 1600;
+    const size_t    m_frameSizeVORBIS = 1600;
 
     static const uint8_t m_tsPacketSize  = 188;
     static const uint8_t m_tsHeaderSize  = 4;
@@ -495,6 +638,9 @@ private:
     char            chbuf[512 + 128];               // must be greater than m_lastHost #254
     char            m_lastHost[512];                // Store the last URL to a webstream
     char*           m_playlistBuff = NULL;          // stores playlistdata
+    uint32_t        m_connDone = 0;                 // millis() of the last connectClient(), until the first header byte
+    uint32_t        m_connGen = 0;                  // connector request of the last connectClient() or mirrorRace()
+    char            m_connHost[160] = "";           // "host:port" of the keep-alive connection (client, clientsecure)
     const uint16_t  m_plsBuffEntryLen = 256;        // length of each entry in playlistBuff
     filter_t        m_filter[3];                    // digital filters
     int             m_LFcount = 0;                  // Detection of end of header
@@ -502,7 +648,6 @@ private:
     uint32_t        m_bitRate=0;                    // current bitrate given fom decoder
     uint32_t        m_avr_bitrate = 0;              // average bitrate, median computed by VBR
     int             m_readbytes = 0;                // bytes read
-    uint32_t        m_metacount = 0;                // counts down bytes between metadata
     int             m_controlCounter = 0;           // Status within readID3data() and readWaveHeader()
     int8_t          m_balance = 0;                  // -16 (mute left) ... +16 (mute right)
     uint8_t         m_vol=64;                       // volume
@@ -517,6 +662,10 @@ private:
     uint8_t         m_streamType = ST_NONE;
     uint8_t         m_ID3Size = 0;                  // lengt of ID3frame - ID3header
     int16_t         m_outBuff[2048*2];              // Interleaved L/R
+    int16_t         m_i2sBlock[I2S_BLOCK_FRAMES*2]; // I2S output block, L/R pairs, processed in place to 32 bit words
+    uint32_t        m_i2sTail[I2S_BLOCK_FRAMES*2];  // I2S words that i2s_write() did not take, at most one block plus the next
+    uint16_t        m_i2sTailBytes = 0;
+    int16_t         m_pcmBlock[I2S_BLOCK_FRAMES*2]; // decoder side block for the PCM ring (output task only)
     int16_t         m_validSamples = 0;
     int16_t         m_curSample = 0;
     uint16_t        m_datamode = 0;                 // Statemaschine
@@ -530,7 +679,6 @@ private:
     uint16_t        m_flacMaxBlockSize = 0;         // can be read out in the FLAC file header
     uint32_t        m_flacTotalSamplesInStream = 0; // can be read out in the FLAC file header
     uint32_t        m_metaint = 0;                  // Number of databytes between metadata
-    uint32_t        m_chunkcount = 0 ;              // Counter for chunked transfer
     uint32_t        m_t0 = 0;                       // store millis(), is needed for a small delay
     uint32_t        m_contentlength = 0;            // Stores the length if the stream comes from fileserver
     uint32_t        m_bytesNotDecoded = 0;          // pictures or something else that comes with the stream
@@ -555,13 +703,51 @@ private:
     bool            m_f_Log = false;                // set in platformio.ini  -DAUDIO_LOG and -DCORE_DEBUG_LEVEL=3 or 4
     bool            m_f_continue = false;           // next m3u8 chunk is available
     bool            m_f_ts = true;                  // transport stream
+    uint8_t         m_hlsPending = HLS_NONE;        // m3u8: request sent behind the current response
+    uint32_t        m_hlsRefresh = 0;               // m3u8: millis() of the next playlist reload
+    int             m_hlsVariant = -1;              // m3u8: index in m_hlsVariantURL, -1: no master playlist
+    abr_t           m_abr = {};                     // m3u8: segment throughput, see net/abr.h
     uint8_t         m_f_channelEnabled = 3;         // internal DAC, both channels
     uint32_t        m_audioFileDuration = 0;
     float           m_audioCurrentTime = 0;
     uint32_t        m_audioDataStart = 0;           // in bytes
     size_t          m_audioDataSize = 0;            //
-    float           m_filterBuff[3][2][2][2];       // IIR filters memory for Audio DSP
-    size_t          m_i2s_bytesWritten = 0;         // set in i2s_write() but not used
+    bqChain_t       m_bqChain;                      // fixed point tone control (LS, PEQ, HS), see dsp/biquad.h
+    portMUX_TYPE    m_bqMux = portMUX_INITIALIZER_UNLOCKED; // setTone() vs. audio path
+    vuMeter_t       m_vu;                           // block level meter, see dsp/vumeter.h
+    spectrum_t      m_spectrum = {};                // tap and FFT, m_spectrum.tap == NULL: off
+    resampler_t     m_rs = {};                      // stream rate -> AUDIO_RESAMPLE_RATE, m_rs.buf == NULL: not used
+    uint32_t        m_i2sRate = 0;                  // last rate given to setI2Srate()
+    size_t          m_i2s_bytesWritten = 0;         // set in i2s_write()
+    audioStats_t    m_stats = {};                   // output path statistics
+    uint32_t        m_zapStart = 0;                 // millis() of zapStart(), 0: not timed
+    bool            m_zapWarm = false;              // connecttohost() got a warm connection
+    bool            m_zapCached = false;            // connecttohost() found the station in the stream cache
+    bool            m_f_follow = false;             // connecttohost() follows a playlist or redirect, same station
+    bool            m_scHit = false;                // the cached stream is in use and not confirmed yet
+    char*           m_scStation = NULL;             // url of the station (stream cache key)
+    streamInfo_t    m_scInfo;                       // stream cache entry of the station
+    uint8_t         m_mirrorIdx = 0;                // m_mirrors: the one in use
+    uint8_t         m_mirrorTries = 0;              // failovers since the last decoded frame
+    bool            m_f_mirrorsKeep = false;        // connecttohost() keeps m_mirrors (same station)
+    int             m_raceFd = -1;                  // socket of the mirror that has won the race, request sent
+    jitterBuf_t     m_jb = {};                      // start watermark and target depth of InBuff (web streams)
+    icyDemux_t      m_icy = {};                     // strips the ICY metadata from the stream, see net/icy.h
+    oggDemux_t      m_ogg = {};                     // pages -> packets of FLAC, Opus and Vorbis, see container/ogg.h
+    chunked_t       m_chunk = {};                   // chunked transfer state of the web stream, see net/chunked.h
+    xfSource_t      m_xfSrc;                        // crossfade: the stream that fades out
+    xfade_t         m_xfade = {};                   // crossfade: gains, see dsp/crossfade.h
+    uint16_t        m_xfadeMs = 0;                  // crossfade length, 0: hard cut
+    uint32_t        m_xfHold = 0;                   // crossfade: frames of the old stream alone (new one not started)
+    bool            m_xfFading = false;             // crossfade: the gains run (new stream started or hold timed out)
+    bool            m_xfMixing = false;             // crossfade: the new stream has started, both decoders run
+    uint32_t        m_xfStart = 0;                  // crossfade: millis() of the first frames of the new stream
+    uint64_t        m_xfCycles = 0;                 // crossfade: CPU cycles of the old stream in the overlap
+    bool            m_f_xfEof = false;              // SD: end of track reported early to start the next one
+    PcmRing         m_ring;                         // decoder -> I2S output task
+    TaskHandle_t    m_outTaskHandle = NULL;
+    volatile bool   m_f_zeroDMA = false;            // output task: clear the DMA buffers
+    bool            m_f_outActive = false;          // output task: the last read got frames
     size_t          m_file_size = 0;                // size of the file
     uint16_t        m_filterFrequency[2];
     int8_t          m_gain0 = 0;                    // cut or boost filters (EQ)
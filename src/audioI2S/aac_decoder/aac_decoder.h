@@ -431,11 +431,45 @@ typedef struct _PSInfoSBR {
     int      XBuf[32+8][64][2];
 } PSInfoSBR_t;
 
+/* decoder context, one per stream - holds everything that was file-scope state before,
+ * so independent instances can run side by side (crossfade, prefetch, host benchmarks)
+ */
+typedef struct AACDecoder {
+    PSInfoBase_t        *m_PSInfoBase;
+    AACDecInfo_t        *m_AACDecInfo;
+    AACFrameInfo_t       m_AACFrameInfo;
+    ADTSHeader_t         m_fhADTS;
+    ADIFHeader_t         m_fhADIF;
+    ProgConfigElement_t *m_pce[16];
+    PulseInfo_t          m_pulseInfo[2]; // [MAX_NCHANS_ELEM]
+    aac_BitStreamInfo_t  m_aac_BitStreamInfo;
+    PSInfoSBR_t         *m_PSInfoSBR;
+} AACDecoder;
+
+AACDecoder* AACCreate();
+void AACDestroy(AACDecoder* dec);
+bool AACDecoder_AllocateBuffers(AACDecoder* dec);
+int AACFlushCodec(AACDecoder* dec);
+void AACDecoder_FreeBuffers(AACDecoder* dec);
+bool AACDecoder_IsInit(AACDecoder* dec);
+int AACFindSyncWord(uint8_t *buf, int nBytes);
+int AACSetRawBlockParams(AACDecoder* dec, int copyLast, int nChans, int sampRateCore, int profile);
+int AACDecode(AACDecoder* dec, uint8_t *inbuf, int *bytesLeft, short *outbuf);
+int AACGetSampRate(AACDecoder* dec);
+int AACGetChannels(AACDecoder* dec);
+int AACGetID(AACDecoder* dec); // 0-MPEG4, 1-MPEG2
+uint8_t AACGetProfile(AACDecoder* dec); // 0-Main, 1-LC, 2-SSR, 3-reserved
+uint8_t AACGetFormat(AACDecoder* dec); // 0-unknown 1-ADTS 2-ADIF, 3-RAW
+int AACGetBitsPerSample();
+int AACGetBitrate(AACDecoder* dec);
+int AACGetOutputSamps(AACDecoder* dec);
+int AACGetBitrate(AACDecoder* dec);
+// compatibility, single default instance
 bool AACDecoder_AllocateBuffers(void);
 int AACFlushCodec();
 void AACDecoder_FreeBuffers(void);
+AACDecoder* AACDecoder_Detach(void); // hands the default instance over (AACDestroy() by the caller)
 bool AACDecoder_IsInit(void);
-int AACFindSyncWord(uint8_t *buf, int nBytes);
 int AACSetRawBlockParams(int copyLast, int nChans, int sampRateCore, int profile);
 int AACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
 int AACGetSampRate();
@@ -443,20 +477,18 @@ int AACGetChannels();
 int AACGetID(); // 0-MPEG4, 1-MPEG2
 uint8_t AACGetProfile(); // 0-Main, 1-LC, 2-SSR, 3-reserved
 uint8_t AACGetFormat(); // 0-unknown 1-ADTS 2-ADIF, 3-RAW
-int AACGetBitsPerSample();
 int AACGetBitrate();
 int AACGetOutputSamps();
-int AACGetBitrate();
 void DecodeLPCCoefs(int order, int res, int8_t *filtCoef, int *a, int *b);
 int FilterRegion(int size, int dir, int order, int *audioCoef, int *a, int *hist);
-int TNSFilter(int ch);
-int DecodeSingleChannelElement();
-int DecodeChannelPairElement();
-int DecodeLFEChannelElement();
-int DecodeDataStreamElement();
-int DecodeProgramConfigElement(uint8_t idx);
-int DecodeFillElement();
-int DecodeNextElement(uint8_t **buf, int *bitOffset, int *bitsAvail);
+int TNSFilter(AACDecoder* dec, int ch);
+int DecodeSingleChannelElement(AACDecoder* dec);
+int DecodeChannelPairElement(AACDecoder* dec);
+int DecodeLFEChannelElement(AACDecoder* dec);
+int DecodeDataStreamElement(AACDecoder* dec);
+int DecodeProgramConfigElement(AACDecoder* dec, uint8_t idx);
+int DecodeFillElement(AACDecoder* dec);
+int DecodeNextElement(AACDecoder* dec, uint8_t **buf, int *bitOffset, int *bitsAvail);
 void PreMultiply(int tabidx, int *zbuf1);
 void PostMultiply(int tabidx, int *fft1);
 void PreMultiplyRescale(int tabidx, int *zbuf1, int es);
@@ -468,47 +500,47 @@ void R8FirstPass(int *x, int bg);
 void R4Core(int *x, int bg, int gp, int *wtab);
 void R4FFT(int tabidx, int *x);
 void UnpackZeros(int nVals, int *coef);
-void UnpackQuads(int cb, int nVals, int *coef);
-void UnpackPairsNoEsc(int cb, int nVals, int *coef);
-void UnpackPairsEsc(int cb, int nVals, int *coef);
-void DecodeSpectrumLong(int ch);
-void DecodeSpectrumShort(int ch);
+void UnpackQuads(AACDecoder* dec, int cb, int nVals, int *coef);
+void UnpackPairsNoEsc(AACDecoder* dec, int cb, int nVals, int *coef);
+void UnpackPairsEsc(AACDecoder* dec, int cb, int nVals, int *coef);
+void DecodeSpectrumLong(AACDecoder* dec, int ch);
+void DecodeSpectrumShort(AACDecoder* dec, int ch);
 void DecWindowOverlap(int *buf0, int *over0, short *pcm0, int nChans, int winTypeCurr, int winTypePrev);
 void DecWindowOverlapLongStart(int *buf0, int *over0, short *pcm0, int nChans, int winTypeCurr, int winTypePrev);
 void DecWindowOverlapLongStop(int *buf0, int *over0, short *pcm0, int nChans, int winTypeCurr, int winTypePrev);
 void DecWindowOverlapShort(int *buf0, int *over0, short *pcm0, int nChans, int winTypeCurr, int winTypePrev);
-int IMDCT(int ch, int chOut, short *outbuf);
-void DecodeICSInfo(ICSInfo_t *icsInfo, int sampRateIdx);
-void DecodeSectionData(int winSequence, int numWinGrp, int maxSFB, uint8_t *sfbCodeBook);
-int DecodeOneScaleFactor();
-void DecodeScaleFactors(int numWinGrp, int maxSFB, int globalGain, uint8_t *sfbCodeBook, short *scaleFactors);
-void DecodePulseInfo(uint8_t ch);
-void DecodeTNSInfo(int winSequence, TNSInfo_t *ti, int8_t *tnsCoef);
-void DecodeGainControlInfo(int winSequence, GainControlInfo_t *gi);
-void DecodeICS(int ch);
-int DecodeNoiselessData(uint8_t **buf, int *bitOffset, int *bitsAvail, int ch);
+int IMDCT(AACDecoder* dec, int ch, int chOut, short *outbuf);
+void DecodeICSInfo(AACDecoder* dec, ICSInfo_t *icsInfo, int sampRateIdx);
+void DecodeSectionData(AACDecoder* dec, int winSequence, int numWinGrp, int maxSFB, uint8_t *sfbCodeBook);
+int DecodeOneScaleFactor(AACDecoder* dec);
+void DecodeScaleFactors(AACDecoder* dec, int numWinGrp, int maxSFB, int globalGain, uint8_t *sfbCodeBook, short *scaleFactors);
+void DecodePulseInfo(AACDecoder* dec, uint8_t ch);
+void DecodeTNSInfo(AACDecoder* dec, int winSequence, TNSInfo_t *ti, int8_t *tnsCoef);
+void DecodeGainControlInfo(AACDecoder* dec, int winSequence, GainControlInfo_t *gi);
+void DecodeICS(AACDecoder* dec, int ch);
+int DecodeNoiselessData(AACDecoder* dec, uint8_t **buf, int *bitOffset, int *bitsAvail, int ch);
 int DecodeHuffmanScalar(const signed short *huffTab, const HuffInfo_t *huffTabInfo, uint32_t bitBuf, int32_t *val);
 int DecodeHuffmanScalar(const signed int *huffTab, const HuffInfo_t *huffTabInfo, unsigned int bitBuf, signed int *val);
-int UnpackADTSHeader(uint8_t **buf, int *bitOffset, int *bitsAvail);
-int GetADTSChannelMapping(uint8_t *buf, int bitOffset, int bitsAvail);
-int GetNumChannelsADIF(int nPCE);
-int GetSampleRateIdxADIF(int nPCE);
-int UnpackADIFHeader(uint8_t **buf, int *bitOffset, int *bitsAvail);
-int SetRawBlockParams(int copyLast, int nChans, int sampRate, int profile);
-int PrepareRawBlock();
+int UnpackADTSHeader(AACDecoder* dec, uint8_t **buf, int *bitOffset, int *bitsAvail);
+int GetADTSChannelMapping(AACDecoder* dec, uint8_t *buf, int bitOffset, int bitsAvail);
+int GetNumChannelsADIF(AACDecoder* dec, int nPCE);
+int GetSampleRateIdxADIF(AACDecoder* dec, int nPCE);
+int UnpackADIFHeader(AACDecoder* dec, uint8_t **buf, int *bitOffset, int *bitsAvail);
+int SetRawBlockParams(AACDecoder* dec, int copyLast, int nChans, int sampRate, int profile);
+int PrepareRawBlock(AACDecoder* dec);
 int DequantBlock(int *inbuf, int nSamps, int scale);
-int AACDequantize(int ch);
+int AACDequantize(AACDecoder* dec, int ch);
 int DeinterleaveShortBlocks(int ch);
 unsigned int Get32BitVal(uint32_t *last);
 int InvRootR(int r);
 int ScaleNoiseVector(int *coef, int nVals, int sf);
 void GenerateNoiseVector(int *coef, int *last, int nVals);
 void CopyNoiseVector(int *coefL, int *coefR, int nVals);
-int PNS(int ch);
+int PNS(AACDecoder* dec, int ch);
 int GetSampRateIdx(int sampRate);
 void StereoProcessGroup(int *coefL, int *coefR, const uint16_t *sfbTab, int msMaskPres, uint8_t *msMaskPtr,
         int msMaskOffset, int maxSFB, uint8_t *cbRight, short *sfRight, int *gbCurrent);
-int StereoProcess();
+int StereoProcess(AACDecoder* dec);
 int RatioPowInv(int a, int b, int c);
 int SqrtFix(int q, int fBitsIn, int *fBitsOut);
 int InvRNormalized(int r);
@@ -518,17 +550,17 @@ void R4Core32(int *r0);
 void FFT32C(int *x);
 void CVKernel1(int *XBuf, int *accBuf);
 void CVKernel2(int *XBuf, int *accBuf);
-void SetBitstreamPointer(int nBytes, uint8_t *buf);
-inline void RefillBitstreamCache();
-unsigned int GetBits(int nBits);
-unsigned int GetBitsNoAdvance(int nBits);
-void AdvanceBitstream(int nBits);
-int CalcBitsUsed(uint8_t *startBuf, int startOffset);
-void ByteAlignBitstream();
+void SetBitstreamPointer(AACDecoder* dec, int nBytes, uint8_t *buf);
+inline void RefillBitstreamCache(AACDecoder* dec);
+unsigned int GetBits(AACDecoder* dec, int nBits);
+unsigned int GetBitsNoAdvance(AACDecoder* dec, int nBits);
+void AdvanceBitstream(AACDecoder* dec, int nBits);
+int CalcBitsUsed(AACDecoder* dec, uint8_t *startBuf, int startOffset);
+void ByteAlignBitstream(AACDecoder* dec);
 // SBR
-void InitSBRState();
-int DecodeSBRBitstream(int chBase);
-int DecodeSBRData(int chBase, short *outbuf);
+void InitSBRState(AACDecoder* dec);
+int DecodeSBRBitstream(AACDecoder* dec, int chBase);
+int DecodeSBRData(AACDecoder* dec, int chBase, short *outbuf);
 int FlushCodecSBR();
 void BubbleSort(uint8_t *v, int nItems);
 uint8_t VMin(uint8_t *v, int nItems);
@@ -545,27 +577,27 @@ void RemoveFreq(uint8_t *freq, int nFreq, int removeIdx);
 int CalcFreqLimiter(uint8_t *freqLimiter, uint8_t *patchNumSubbands, uint8_t *freqLow, int nLow, int kStart,
         int limiterBands, int numPatches);
 int CalcFreqTables(SBRHeader *sbrHdr, SBRFreq *sbrFreq, int sampRateIdx);
-void EstimateEnvelope(SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, int env);
+void EstimateEnvelope(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, int env);
 int GetSMapped(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int env, int band, int la);
-void CalcMaxGain(SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, int ch, int env, int lim, int fbitsDQ);
+void CalcMaxGain(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, int ch, int env, int lim, int fbitsDQ);
 void CalcNoiseDivFactors(int q, int *qp1Inv, int *qqp1Inv);
-void CalcComponentGains(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch, int env, int lim, int fbitsDQ);
-void ApplyBoost(SBRFreq *sbrFreq, int lim, int fbitsDQ);
-void CalcGain(SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch, int env);
-void MapHF(SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int env, int hfReset);
-void AdjustHighFreq(SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
+void CalcComponentGains(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch, int env, int lim, int fbitsDQ);
+void ApplyBoost(AACDecoder* dec, SBRFreq *sbrFreq, int lim, int fbitsDQ);
+void CalcGain(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch, int env);
+void MapHF(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int env, int hfReset);
+void AdjustHighFreq(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
 int CalcCovariance1(int *XBuf, int *p01reN, int *p01imN, int *p12reN, int *p12imN, int *p11reN, int *p22reN);
 int CalcCovariance2(int *XBuf, int *p02reN, int *p02imN);
 void CalcLPCoefs(int *XBuf, int *a0re, int *a0im, int *a1re, int *a1im, int gb);
-void GenerateHighFreq(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
+void GenerateHighFreq(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
 
-int DecodeOneSymbol(int huffTabIndex);
+int DecodeOneSymbol(AACDecoder* dec, int huffTabIndex);
 int DequantizeEnvelope(int nBands, int ampRes, int8_t *envQuant, int *envDequant);
 void DequantizeNoise(int nBands, int8_t *noiseQuant, int *noiseDequant);
-void DecodeSBREnvelope(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
-void DecodeSBRNoise(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
-void UncoupleSBREnvelope(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChanR);
-void UncoupleSBRNoise(SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChanR);
+void DecodeSBREnvelope(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
+void DecodeSBRNoise(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChan, int ch);
+void UncoupleSBREnvelope(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChanR);
+void UncoupleSBRNoise(AACDecoder* dec, SBRGrid *sbrGrid, SBRFreq *sbrFreq, SBRChan *sbrChanR);
 void DecWindowOverlapNoClip(int *buf0, int *over0, int *out0, int winTypeCurr, int winTypePrev);
 void DecWindowOverlapLongStartNoClip(int *buf0, int *over0, int *out0, int winTypeCurr, int winTypePrev);
 void DecWindowOverlapLongStopNoClip(int *buf0, int *over0, int *out0, int winTypeCurr, int winTypePrev);
@@ -576,12 +608,12 @@ void QMFAnalysisConv(int *cTab, int *delay, int dIdx, int *uBuf);
 int QMFAnalysis(int *inbuf, int *delay, int *XBuf, int fBitsIn, int *delayIdx, int qmfaBands);
 void QMFSynthesisConv(int *cPtr, int *delay, int dIdx, short *outbuf, int nChans);
 void QMFSynthesis(int *inbuf, int *delay, int *delayIdx, int qmfsBands, short *outbuf, int nChans);
-int UnpackSBRHeader(SBRHeader *sbrHdr);
-void UnpackSBRGrid(SBRHeader *sbrHdr, SBRGrid *sbrGrid);
-void UnpackDeltaTimeFreq(int numEnv, uint8_t *deltaFlagEnv, int numNoiseFloors, uint8_t *deltaFlagNoise);
-void UnpackInverseFilterMode(int numNoiseFloorBands, uint8_t *mode);
-void UnpackSinusoids(int nHigh, int addHarmonicFlag, uint8_t *addHarmonic);
+int UnpackSBRHeader(AACDecoder* dec, SBRHeader *sbrHdr);
+void UnpackSBRGrid(AACDecoder* dec, SBRHeader *sbrHdr, SBRGrid *sbrGrid);
+void UnpackDeltaTimeFreq(AACDecoder* dec, int numEnv, uint8_t *deltaFlagEnv, int numNoiseFloors, uint8_t *deltaFlagNoise);
+void UnpackInverseFilterMode(AACDecoder* dec, int numNoiseFloorBands, uint8_t *mode);
+void UnpackSinusoids(AACDecoder* dec, int nHigh, int addHarmonicFlag, uint8_t *addHarmonic);
 void CopyCouplingGrid(SBRGrid *sbrGridLeft, SBRGrid *sbrGridRight);
 void CopyCouplingInverseFilterMode(int numNoiseFloorBands, uint8_t *modeLeft, uint8_t *modeRight);
-void UnpackSBRSingleChannel(int chBase);
-void UnpackSBRChannelPair(int chBase);
+void UnpackSBRSingleChannel(AACDecoder* dec, int chBase);
+void UnpackSBRChannelPair(AACDecoder* dec, int chBase);
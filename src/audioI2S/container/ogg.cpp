@@ -0,0 +1,307 @@
+/*
+ * ogg.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Ogg demultiplexer, see ogg.h
+ */
+#include "ogg.h"
+#include "Arduino.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+static inline uint32_t ogg_le32(const uint8_t* p){
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t ogg_crc(const uint8_t* page, uint32_t len){
+    // CRC-32 of a page, polynomial 0x04c11db7, no reflection, the CRC field counts as zero; 4 bits per step
+    static const uint32_t tab[16] = {
+        0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005,
+        0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61, 0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd};
+    uint32_t crc = 0;
+    for(uint32_t i = 0; i < len; i++){
+        uint8_t b = (i >= 22 && i < 26) ? 0 : page[i];
+        crc = (crc << 4) ^ tab[(crc >> 28) ^ (b >> 4)];
+        crc = (crc << 4) ^ tab[(crc >> 28) ^ (b & 0x0F)];
+    }
+    return crc;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ogg_capture(const uint8_t* buf, uint32_t len){
+    // position of the capture pattern "OggS", memchr() finds the candidates
+    const uint8_t* p = buf;
+    const uint8_t* end = buf + len;
+    while(end - p > 3){
+        p = (const uint8_t*)memchr(p, 'O', end - p - 3);
+        if(!p) break;
+        if(p[1] == 'g' && p[2] == 'g' && p[3] == 'S') return p - buf;
+        p++;
+    }
+    return -1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void ogg_drop(oggDemux_t* d){
+    // the packet and the page in progress are lost
+    d->segCount = d->segIdx = 0;
+    d->skipLeft = d->runLeft = 0;
+    d->runActive = d->runEnds = d->runDrop = false;
+    d->pktLen = 0;
+    d->pending = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static const oggCodec_t* ogg_probe(oggDemux_t* d, const uint8_t* pkt, uint32_t len){
+    for(int i = 0; i < d->numCodecs; i++){
+        if(d->codecs[i]->probe(pkt, len)) return d->codecs[i];
+    }
+    return NULL;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t ogg_firstPacket(const oggPage_t* page, const uint8_t* segTable){
+    // length of the first packet (part) of a page
+    uint32_t n = 0;
+    for(int i = 0; i < page->segCount; i++){
+        n += segTable[i];
+        if(segTable[i] < 255) break;
+    }
+    return n;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t ogg_packet(oggDemux_t* d, uint8_t* pkt, uint32_t len, bool inPlace, short* outbuf, uint32_t* consumed){
+    // the codec takes (a part of) the packet, *consumed: bytes of the packet that are finished
+    int left = len;
+    int8_t ret = d->codec->decode(pkt, &left, outbuf);
+    uint32_t used = left > 0 ? len - left : len;
+    bool done = ret < 0 || left <= 0 || (ret == ERR_OGG_NONE && !used); // error, finished or no progress
+    d->pending = done ? 0 : left;
+    d->pendingInPlace = inPlace;
+    if(done && !inPlace) d->pktLen = 0;
+    *consumed = done ? len : used;
+    return ret;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OGG_Register(oggDemux_t* d, const oggCodec_t* codec){
+    for(int i = 0; i < d->numCodecs; i++) if(d->codecs[i] == codec) return;
+    if(d->numCodecs < OGG_MAX_CODECS) d->codecs[d->numCodecs++] = codec;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int OGG_ParsePage(oggPage_t* page, const uint8_t* buf, uint32_t len){
+    if(len < OGG_PAGE_HEADER) return 0;
+    if(buf[0] != 'O' || buf[1] != 'g' || buf[2] != 'g' || buf[3] != 'S' || buf[4] != 0) return -1; // version 0
+    page->flags    = buf[5];
+    page->granule  = ogg_le32(buf + 6) | (uint64_t)ogg_le32(buf + 10) << 32;
+    page->serial   = ogg_le32(buf + 14);
+    page->seqNo    = ogg_le32(buf + 18);
+    page->segCount = buf[26];
+    page->headerLen = OGG_PAGE_HEADER + page->segCount;
+    if(len < page->headerLen) return 0;
+    page->bodyLen = 0;
+    for(int i = 0; i < page->segCount; i++) page->bodyLen += buf[OGG_PAGE_HEADER + i];
+    return page->headerLen;
+}
+//----------------------------------------------------------------------------------------------------------------------
+const oggCodec_t* OGG_Probe(oggDemux_t* d, const uint8_t* buf, uint32_t len){
+    oggPage_t page;
+    if(OGG_ParsePage(&page, buf, len) <= 0 || !(page.flags & 0x02)) return NULL;
+    uint32_t n = ogg_firstPacket(&page, buf + OGG_PAGE_HEADER);
+    if(page.headerLen + n > len) return NULL;
+    return ogg_probe(d, buf + page.headerLen, n);
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool OGG_AllocateBuffers(oggDemux_t* d, const oggCodec_t* codec){
+    if(d->buf && d->bufSize < codec->maxPacket) OGG_FreeBuffers(d);
+    if(!d->buf){
+        if(psramFound()) d->buf = (uint8_t*)ps_malloc(codec->maxPacket);
+        else             d->buf = (uint8_t*)malloc(codec->maxPacket);
+        if(!d->buf){
+            log_e("not enough memory to allocate the ogg packet buffer");
+            return false;
+        }
+        d->bufSize = codec->maxPacket;
+    }
+    d->codec = codec;
+    d->hasSerial = false;
+    d->inData = false;
+    d->ignore = false;
+    d->pages = d->packets = d->copied = d->skipped = d->resyncs = d->chains = d->crcErrors = 0;
+    ogg_drop(d);
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OGG_FreeBuffers(oggDemux_t* d){
+    if(d->buf) {free(d->buf); d->buf = NULL;}
+    d->bufSize = 0;
+    d->codec = NULL;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OGG_Reset(oggDemux_t* d){
+    ogg_drop(d);
+    if(d->codec && d->codec->reset) d->codec->reset();
+}
+//----------------------------------------------------------------------------------------------------------------------
+int OGG_FindSyncWord(oggDemux_t* d, const uint8_t* buf, int len){
+    int i = len > 0 ? ogg_capture(buf, len) : -1;
+    if(i >= 0){
+        OGG_Reset(d);
+        d->resyncs++;
+    }
+    return i;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int8_t OGG_Decode(oggDemux_t* d, uint8_t* buf, int* bytesLeft, short* outbuf){
+    // page headers and packet parts until one packet is complete, the codec is called once
+    if(!d->codec || !d->buf) return ERR_OGG_NO_CODEC;
+    uint8_t* p   = buf;
+    uint8_t* end = buf + *bytesLeft;
+    uint32_t consumed;
+    if(d->pending){                                             // the codec goes on with the rest of a packet
+        if(!d->pendingInPlace){                                 // in the buffer, no input is used
+            int8_t ret = ogg_packet(d, d->buf + d->pktLen - d->pending, d->pending, false, outbuf, &consumed);
+            return ret == ERR_OGG_NONE ? OGG_GIVE_NEXT_LOOP : ret;
+        }
+        uint32_t len = d->pending;
+        if((uint32_t)(end - p) < len){                          // less input than before, wait for it
+            *bytesLeft = end - p;
+            return OGG_GIVE_NEXT_LOOP;
+        }
+        int8_t ret = ogg_packet(d, p, len, true, outbuf, &consumed);
+        *bytesLeft -= consumed;
+        return ret;
+    }
+    while(p < end){
+        uint32_t avail = end - p;
+        if(d->skipLeft){                                        // a page of another logical stream
+            uint32_t n = avail < d->skipLeft ? avail : d->skipLeft;
+            p += n;
+            d->skipLeft -= n;
+            continue;
+        }
+        if(!d->runActive){
+            if(d->segIdx == d->segCount){                       // next page
+                if(avail < 4) break;
+                if(p[0] != 'O' || p[1] != 'g' || p[2] != 'g' || p[3] != 'S'){ // sync lost, skip to the next page
+                    int i = ogg_capture(p, avail);
+                    OGG_Reset(d);
+                    d->resyncs++;
+                    if(i < 0) {p = end - 3; break;}             // the rest can begin "OggS"
+                    p += i;
+                    continue;
+                }
+                oggPage_t page;
+                int n = OGG_ParsePage(&page, p, avail);
+                if(n == 0) break;
+                if(n < 0) {p += 4; continue;}                   // "OggS" in the data, not a page
+                if(n + page.bodyLen <= avail && ogg_crc(p, n + page.bodyLen) != ogg_le32(p + 22)){ // damaged page
+                    OGG_Reset(d);                               // the packets of the page are lost
+                    d->crcErrors++;
+                    p += n;
+                    d->skipLeft = page.bodyLen;
+                    continue;
+                }
+                if(page.flags & 0x02){                          // BOS, the identification header of a codec
+                    uint32_t first = ogg_firstPacket(&page, p + OGG_PAGE_HEADER);
+                    if((uint32_t)n + first > avail) break;
+                    const oggCodec_t* c = ogg_probe(d, p + n, first);
+                    if(!c){                                     // e.g. Skeleton or Theora
+                        p += n;
+                        d->skipLeft = page.bodyLen;
+                        continue;
+                    }
+                    if(!d->hasSerial || page.serial != d->serial){
+                        if(d->hasSerial && !d->inData){         // another stream of the BOS group
+                            p += n;
+                            d->skipLeft = page.bodyLen;
+                            continue;
+                        }
+                        if(d->hasSerial) {                      // chained stream, next track
+                            d->chains++;
+                            OGG_Reset(d);
+                        }
+                        d->serial = page.serial;
+                        d->hasSerial = true;
+                        d->inData = false;
+                        d->ignore = c != d->codec;
+                        if(d->ignore){
+                            log_w("ogg: chained stream with another codec, not played");
+                            p += n;
+                            d->skipLeft = page.bodyLen;
+                            *bytesLeft = end - p;
+                            return ERR_OGG_CODEC_CHANGED;
+                        }
+                    }
+                }
+                else if(!d->hasSerial){                         // the stream was joined after its BOS page
+                    d->serial = page.serial;
+                    d->hasSerial = true;
+                }
+                p += n;
+                if(page.serial == d->serial && !(page.flags & 0x02)) d->inData = true;
+                if(page.serial != d->serial || d->ignore){
+                    d->skipLeft = page.bodyLen;
+                    continue;
+                }
+                d->pages++;
+                memcpy(d->segTable, p - page.segCount, page.segCount);
+                d->segCount = page.segCount;
+                d->segIdx = 0;
+                d->runDrop = (page.flags & 0x01) && !d->pktLen; // continued packet without its beginning
+                if(!(page.flags & 0x01) && d->pktLen){          // the rest of the last packet is missing
+                    d->pktLen = 0;
+                    d->skipped++;
+                }
+                continue;
+            }
+            uint32_t n = 0;                                     // the segments of the next packet (part)
+            uint8_t  s;
+            do{
+                s = d->segTable[d->segIdx++];
+                n += s;
+            }while(s == 255 && d->segIdx < d->segCount);
+            d->runLeft = n;
+            d->runEnds = s < 255;
+            d->runActive = true;
+        }
+        if(d->runDrop){
+            uint32_t n = avail < d->runLeft ? avail : d->runLeft;
+            p += n;
+            d->runLeft -= n;
+            if(d->runLeft) continue;
+            d->runActive = false;
+            if(d->runEnds) {d->runDrop = false; d->skipped++;}
+            continue;
+        }
+        if(!d->pktLen && d->runEnds && d->runLeft && avail >= d->runLeft){ // complete here: no copy
+            uint8_t* pkt = p;
+            uint32_t len = d->runLeft;
+            d->runLeft = 0;
+            d->runActive = false;
+            d->packets++;
+            int8_t ret = ogg_packet(d, pkt, len, true, outbuf, &consumed);
+            *bytesLeft = end - (pkt + consumed);
+            return ret;
+        }
+        uint32_t n = avail < d->runLeft ? avail : d->runLeft;   // assembled in the buffer
+        if(d->pktLen + n <= d->bufSize) memcpy(d->buf + d->pktLen, p, n);
+        d->pktLen += n;
+        p += n;
+        d->runLeft -= n;
+        if(d->runLeft) continue;
+        d->runActive = false;
+        if(!d->runEnds) continue;                               // the packet goes on in the next page
+        uint32_t len = d->pktLen;
+        if(!len) continue;                                      // empty packet
+        if(len > d->bufSize){                                   // e.g. a picture in the comment header
+            log_i("ogg: packet of %u bytes skipped", len);
+            d->pktLen = 0;
+            d->skipped++;
+            continue;
+        }
+        d->packets++;
+        d->copied++;
+        int8_t ret = ogg_packet(d, d->buf, len, false, outbuf, &consumed);
+        *bytesLeft = end - p;
+        if(p == buf && ret == ERR_OGG_NONE) ret = OGG_GIVE_NEXT_LOOP; // no input used, but not a wrong frame
+        return ret;
+    }
+    *bytesLeft = end - p;
+    return ERR_OGG_NONE;
+}
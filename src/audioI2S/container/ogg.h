@@ -0,0 +1,93 @@
+/*
+ * ogg.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Ogg demultiplexer (RFC 3533) for the codecs in Ogg: FLAC, Opus and Vorbis. OGG_Decode() takes the input as it is
+ *  in the input buffer and hands one packet to the codec of the followed logical stream, the return value is the one
+ *  of the codec. The codecs see packets only, the headers of the codec included.
+ *
+ *  pages:     the capture pattern is searched with memchr(), a page header is taken only when it is complete; the
+ *             CRC of a page that lies complete in the input is checked, a damaged page is skipped (a page longer
+ *             than the input is taken unchecked)
+ *  packets:   a packet that lies complete in one page and in the input is given to the codec where it is, packets
+ *             across pages or across the end of the input are assembled in the packet buffer; packets that do not
+ *             fit (pictures in the comment header) are skipped
+ *  streams:   the codec probes the first packet of a BOS page, pages of other serials are skipped (multiplexed
+ *             streams, the first stream of the BOS group is played); a BOS page with a new serial after the data
+ *             pages starts the next track of a chained stream
+ *  codecs:    a codec may take a packet over several calls (the frames of an Opus packet, a FLAC frame), the input
+ *             is then consumed up to the unused rest of the packet only, or the packet is kept in the buffer
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define OGG_MAX_CODECS      4
+#define OGG_PAGE_HEADER     27          // without the segment table
+
+enum : int8_t  {OGG_GIVE_NEXT_LOOP = +1,
+                ERR_OGG_NONE = 0,
+                ERR_OGG_NO_CODEC = -100,
+                ERR_OGG_CODEC_CHANGED = -101};
+
+typedef struct {
+    uint8_t  id;                                                    // of the caller, e.g. CODEC_OGG_OPUS
+    uint32_t maxPacket;                                             // size of the packet buffer
+    bool   (*probe)(const uint8_t* pkt, uint32_t len);              // identification header, first packet of a BOS page
+    void   (*reset)(void);                                          // the packets are interrupted (resync, next track)
+    int8_t (*decode)(uint8_t* pkt, int* bytesLeft, short* outbuf);  // as the decoders, the input is one packet
+} oggCodec_t;
+
+typedef struct {
+    uint8_t  flags;                     // header_type_flag: 1 continued packet, 2 BOS, 4 EOS
+    uint64_t granule;
+    uint32_t serial;
+    uint32_t seqNo;
+    uint8_t  segCount;
+    uint16_t headerLen;                 // with the segment table
+    uint32_t bodyLen;
+} oggPage_t;
+
+typedef struct {
+    const oggCodec_t* codecs[OGG_MAX_CODECS];
+    uint8_t   numCodecs;
+    const oggCodec_t* codec;            // of the followed logical stream
+    uint32_t  serial;
+    bool      hasSerial;
+    bool      ignore;                   // the stream of this serial has another codec
+    bool      inData;                   // a page after the BOS pages, the next BOS begins a chained stream
+    // current page
+    uint8_t   segTable[255];
+    uint8_t   segCount;
+    uint8_t   segIdx;
+    uint32_t  skipLeft;                 // body bytes of a page of another stream
+    uint32_t  runLeft;                  // bytes of the packet (part) in the current page still to read
+    bool      runActive;
+    bool      runEnds;                  // the packet ends in this page
+    bool      runDrop;                  // the beginning of the packet is missing
+    // packet
+    uint8_t*  buf;
+    uint32_t  bufSize;
+    uint32_t  pktLen;                   // bytes assembled, counted on when the packet does not fit
+    uint32_t  pending;                  // rest of a packet the codec has not finished
+    bool      pendingInPlace;           // the rest is at the beginning of the next input
+    // statistics
+    uint32_t  pages;
+    uint32_t  packets;
+    uint32_t  copied;                   // packets that were assembled in the buffer
+    uint32_t  skipped;                  // packets too big or incomplete
+    uint32_t  resyncs;
+    uint32_t  chains;                   // tracks of a chained stream
+    uint32_t  crcErrors;                // pages skipped for a wrong CRC
+} oggDemux_t;
+
+void     OGG_Register(oggDemux_t* d, const oggCodec_t* codec);
+int      OGG_ParsePage(oggPage_t* page, const uint8_t* buf, uint32_t len);  // header length, 0: incomplete, -1: no page
+const oggCodec_t* OGG_Probe(oggDemux_t* d, const uint8_t* buf, uint32_t len); // codec of the BOS page at buf or NULL
+bool     OGG_AllocateBuffers(oggDemux_t* d, const oggCodec_t* codec);     // follows the stream of this codec
+void     OGG_FreeBuffers(oggDemux_t* d);
+void     OGG_Reset(oggDemux_t* d);                                          // seek or loop, begins with the next page
+int      OGG_FindSyncWord(oggDemux_t* d, const uint8_t* buf, int len);
+int8_t   OGG_Decode(oggDemux_t* d, uint8_t* buf, int* bytesLeft, short* outbuf);
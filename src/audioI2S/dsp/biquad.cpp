@@ -0,0 +1,221 @@
+/*
+ * biquad.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Fixed point biquad cascade, see biquad.h
+ */
+#include "biquad.h"
+#include <string.h>
+#include <math.h>
+
+static const bqCoef_t bqIdentity = {1 << BQ_FRAC, 0, 0, 0, 0};
+
+//----------------------------------------------------------------------------------------------------------------------
+static inline int16_t bq_sat16(int32_t v){
+    if(v >  32767) return  32767;
+    if(v < -32768) return -32768;
+    return (int16_t)v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t bq_step(const bqCoef_t* c, bqState_t* s, int32_t x){
+    int64_t acc = (int64_t)c->a0 * x
+                + (int64_t)c->a1 * s->x1
+                + (int64_t)c->a2 * s->x2
+                - (int64_t)c->b1 * s->y1
+                - (int64_t)c->b2 * s->y2
+                - (((int64_t)c->b1 * s->e1 + (int64_t)c->b2 * s->e2) >> BQ_FRAC);  // fraction of y1, y2
+    int32_t y = (int32_t)(acc >> BQ_FRAC);
+    s->e2 = s->e1;
+    s->e1 = (int32_t)(acc - ((int64_t)y << BQ_FRAC));     // 0 ... 2^29-1
+    s->x2 = s->x1; s->x1 = x;
+    s->y2 = s->y1; s->y1 = y;
+    return y + (s->e1 >> (BQ_FRAC - 1));                   // rounded output, the history keeps floor + fraction
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_track(bqState_t* s, const int16_t* buff, uint16_t frames){
+    // bypassed stage: keep the history of an identity filter, so that it can be switched on without a jump
+    if(frames >= 2){
+        s->x2 = buff[2 * (frames - 2)];
+        s->x1 = buff[2 * (frames - 1)];
+    }
+    else if(frames == 1){
+        s->x2 = s->x1;
+        s->x1 = buff[0];
+    }
+    s->y2 = s->x2;
+    s->y1 = s->x1;
+    s->e1 = s->e2 = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_run(const bqCoef_t* c, bqState_t* s, int16_t* buff, uint16_t frames){
+    bqCoef_t  cf = *c;   // keep coefficients and history in registers
+    bqState_t st = *s;
+    for(uint16_t i = 0; i < frames; i++){
+        buff[2 * i] = bq_sat16(bq_step(&cf, &st, buff[2 * i]));
+    }
+    *s = st;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_fade(bqStage_t* stg, uint8_t ch, int16_t* buff, uint16_t frames){
+    // old and new coefficients start from the same history, the outputs are cross-faded linear over the block
+    const bqCoef_t* cOld = stg->active     ? &stg->coef[ch] : &bqIdentity;
+    const bqCoef_t* cNew = stg->fadeActive ? &stg->fade[ch] : &bqIdentity;
+    bqState_t sOld = stg->state[ch];
+    bqState_t sNew = stg->state[ch];
+    uint32_t  step = (1UL << 16) / frames;
+    uint32_t  w = 0;                                            // weight of the new output, Q16
+    for(uint16_t i = 0; i < frames; i++){
+        w += step;
+        int32_t x  = buff[2 * i];
+        int32_t yo = bq_step(cOld, &sOld, x);
+        int32_t yn = bq_step(cNew, &sNew, x);
+        buff[2 * i] = bq_sat16(yo + (int32_t)(((int64_t)(yn - yo) * w) >> 16));
+    }
+    stg->state[ch] = sNew;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_gain(int16_t* buff, uint16_t frames, int32_t from, int32_t to){
+    // Q15 gain, linear ramp from -> to over the block
+    if(from == to){
+        if(to == BQ_GAIN_UNITY) return;
+        for(uint16_t i = 0; i < frames; i++) buff[2 * i] = bq_sat16((buff[2 * i] * to) >> 15);
+        return;
+    }
+    int32_t g = from << 8;                                      // Q23 while ramping
+    int32_t step = ((to - from) << 8) / frames;
+    for(uint16_t i = 0; i < frames; i++){
+        g += step;
+        buff[2 * i] = bq_sat16((buff[2 * i] * (g >> 8)) >> 15);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_scaleHistory(bqState_t* s, int32_t mul, int32_t div){
+    // output history (with fraction) * mul / div, moves the gain into or out of a stage
+    int32_t* y[2] = {&s->y1, &s->y2};
+    int32_t* e[2] = {&s->e1, &s->e2};
+    for(uint8_t i = 0; i < 2; i++){
+        int64_t v = ((int64_t)*y[i] << BQ_FRAC) + *e[i];
+        v = v * mul / div;
+        *y[i] = (int32_t)(v >> BQ_FRAC);
+        *e[i] = (int32_t)(v - ((int64_t)*y[i] << BQ_FRAC));
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void bq_merge(bqChain_t* chain, int8_t n){
+    // moves the gain out of the stage it is merged in and into stage n (-1: separate gain stage)
+    if(chain->merged == n) return;
+    if(chain->merged >= 0){
+        bqStage_t* stg = &chain->stage[chain->merged];
+        for(uint8_t ch = 0; ch < 2; ch++) bq_scaleHistory(&stg->state[ch], BQ_GAIN_UNITY, chain->gainCur[ch]);
+    }
+    if(n >= 0){
+        bqStage_t* stg = &chain->stage[n];
+        for(uint8_t ch = 0; ch < 2; ch++){
+            int32_t g = chain->gainCur[ch];
+            bq_scaleHistory(&stg->state[ch], g, BQ_GAIN_UNITY);
+            chain->mergedCoef[ch]    = stg->coef[ch];
+            chain->mergedCoef[ch].a0 = (int32_t)(((int64_t)stg->coef[ch].a0 * g) >> 15);
+            chain->mergedCoef[ch].a1 = (int32_t)(((int64_t)stg->coef[ch].a1 * g) >> 15);
+            chain->mergedCoef[ch].a2 = (int32_t)(((int64_t)stg->coef[ch].a2 * g) >> 15);
+        }
+    }
+    chain->merged = n;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_Init(bqChain_t* chain){
+    memset(chain, 0, sizeof(bqChain_t));
+    for(uint8_t n = 0; n < BQ_STAGES; n++){
+        chain->stage[n].coef[0] = chain->stage[n].coef[1] = bqIdentity;
+        chain->next[n][0] = chain->next[n][1] = bqIdentity;
+    }
+    for(uint8_t ch = 0; ch < 2; ch++) chain->nextGain[ch] = chain->gain[ch] = chain->gainCur[ch] = BQ_GAIN_UNITY;
+    chain->merged = -1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_Reset(bqChain_t* chain){
+    for(uint8_t n = 0; n < BQ_STAGES; n++) memset(chain->stage[n].state, 0, sizeof(chain->stage[n].state));
+    chain->merged = -1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int32_t BQ_ToFixed(float coef){
+    float v = coef * (float)(1L << BQ_FRAC);
+    if(v >=  2147483647.0f) return  2147483647;
+    if(v <= -2147483648.0f) return -2147483647 - 1;
+    return (int32_t)lrintf(v);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_SetStage(bqChain_t* chain, uint8_t n, float a0, float a1, float a2, float b1, float b2, bool active){
+    if(n >= BQ_STAGES) return;
+    bqCoef_t c;
+    c.a0 = BQ_ToFixed(a0);
+    c.a1 = BQ_ToFixed(a1);
+    c.a2 = BQ_ToFixed(a2);
+    c.b1 = BQ_ToFixed(b1);
+    c.b2 = BQ_ToFixed(b2);
+    chain->next[n][0] = chain->next[n][1] = c;
+    chain->nextActive[n] = active;
+    chain->pending = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_SetGain(bqChain_t* chain, int32_t gainL, int32_t gainR){
+    if(gainL < 0) gainL = 0;
+    if(gainL > BQ_GAIN_UNITY) gainL = BQ_GAIN_UNITY;
+    if(gainR < 0) gainR = 0;
+    if(gainR > BQ_GAIN_UNITY) gainR = BQ_GAIN_UNITY;
+    chain->nextGain[0] = gainL;
+    chain->nextGain[1] = gainR;
+    chain->pending = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_Commit(bqChain_t* chain){
+    // takes coefficients and gain written by BQ_SetStage()/BQ_SetGain(), changed stages are faded in and the
+    // gain is ramped by the next BQ_Process()
+    if(!chain->pending) return;
+    chain->pending = false;
+    chain->gain[0] = chain->nextGain[0];
+    chain->gain[1] = chain->nextGain[1];
+    for(uint8_t n = 0; n < BQ_STAGES; n++){
+        bqStage_t* stg = &chain->stage[n];
+        bool same = (stg->active == chain->nextActive[n]);
+        if(same && stg->active) same = !memcmp(stg->coef, chain->next[n], sizeof(stg->coef));
+        if(same) continue;
+        memcpy(stg->fade, chain->next[n], sizeof(stg->fade));
+        stg->fadeActive = chain->nextActive[n];
+        stg->fading = true;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void BQ_Process(bqChain_t* chain, int16_t* buff, uint16_t frames){
+    if(!frames) return;
+
+    // the gain can be merged into the last stage that runs, as long as it is steady and not muted
+    int8_t last = -1;
+    for(uint8_t n = 0; n < BQ_STAGES; n++) if(chain->stage[n].active || chain->stage[n].fading) last = n;
+    bool steady = chain->gainCur[0] == chain->gain[0] && chain->gainCur[1] == chain->gain[1];
+    if(last >= 0 && (chain->stage[last].fading || !steady || !chain->gain[0] || !chain->gain[1])) last = -1;
+    bq_merge(chain, last);
+
+    for(uint8_t n = 0; n < BQ_STAGES; n++){
+        bqStage_t* stg = &chain->stage[n];
+        const bqCoef_t* coef = (n == chain->merged) ? chain->mergedCoef : stg->coef;
+        for(uint8_t ch = 0; ch < 2; ch++){
+            if(stg->fading)      bq_fade(stg, ch, buff + ch, frames);
+            else if(stg->active) bq_run(&coef[ch], &stg->state[ch], buff + ch, frames);
+            else                 bq_track(&stg->state[ch], buff + ch, frames);
+        }
+        if(stg->fading){
+            memcpy(stg->coef, stg->fade, sizeof(stg->coef));
+            stg->active = stg->fadeActive;
+            stg->fading = false;
+            if(!stg->active) for(uint8_t ch = 0; ch < 2; ch++) bq_track(&stg->state[ch], buff + ch, frames);
+        }
+    }
+
+    if(chain->merged < 0){
+        for(uint8_t ch = 0; ch < 2; ch++){
+            bq_gain(buff + ch, frames, chain->gainCur[ch], chain->gain[ch]);
+            chain->gainCur[ch] = chain->gain[ch];
+        }
+    }
+}
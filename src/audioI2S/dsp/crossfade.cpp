@@ -0,0 +1,62 @@
+/*
+ * crossfade.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Equal power crossfade, see crossfade.h
+ */
+#include "crossfade.h"
+#include <math.h>
+
+static uint16_t xfSine[XF_STEPS + 1];   // sin(pi/2 * i / XF_STEPS), Q15, 32768 = 1.0
+static bool     xfTable = false;
+
+//----------------------------------------------------------------------------------------------------------------------
+static inline int16_t xf_sat16(int32_t v){
+    if(v >  32767) return  32767;
+    if(v < -32768) return -32768;
+    return (int16_t)v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t xf_gain(uint32_t phase){
+    // sine at the Q20 table index, Q15
+    uint32_t i = phase >> XF_FRAC_BITS;
+    if(i >= XF_STEPS) return xfSine[XF_STEPS];
+    int32_t  f = (phase >> (XF_FRAC_BITS - 15)) & 0x7FFF;
+    int32_t  a = xfSine[i];
+    return a + (((xfSine[i + 1] - a) * f + 16384) >> 15);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void XF_Init(xfade_t* xf, uint32_t frames){
+    if(!xfTable){
+        for(uint16_t i = 0; i <= XF_STEPS; i++) xfSine[i] = (uint16_t)lrintf(sinf((float)M_PI_2 * i / XF_STEPS) * 32768.0f);
+        xfTable = true;
+    }
+    if(!frames) frames = 1;
+    xf->frames = frames;
+    xf->phase = 0;
+    xf->step = (uint32_t)(((uint64_t)XF_STEPS << XF_FRAC_BITS) / frames);
+    if(!xf->step) xf->step = 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void XF_Old(xfade_t* xf, int16_t* old, uint16_t frames){
+    const uint32_t end = (uint32_t)XF_STEPS << XF_FRAC_BITS;
+    for(uint16_t i = 0; i < frames; i++){
+        int32_t gOld = xf->phase < end ? xf_gain(end - xf->phase) : 0;
+        old[2 * i]     = (int16_t)((old[2 * i]     * gOld + 16384) >> 15);
+        old[2 * i + 1] = (int16_t)((old[2 * i + 1] * gOld + 16384) >> 15);
+        if(xf->phase < end) xf->phase += xf->step;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void XF_Mix(xfade_t* xf, int16_t* dst, const int16_t* old, uint16_t frames){
+    const uint32_t end = (uint32_t)XF_STEPS << XF_FRAC_BITS;
+    for(uint16_t i = 0; i < frames; i++){
+        if(xf->phase >= end) return;            // the rest is the new stream alone
+        int32_t gNew = xf_gain(xf->phase);
+        int32_t gOld = xf_gain(end - xf->phase);
+        dst[2 * i]     = xf_sat16((dst[2 * i]     * gNew + old[2 * i]     * gOld + 16384) >> 15);
+        dst[2 * i + 1] = xf_sat16((dst[2 * i + 1] * gNew + old[2 * i + 1] * gOld + 16384) >> 15);
+        xf->phase += xf->step;
+    }
+}
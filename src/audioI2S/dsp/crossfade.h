@@ -0,0 +1,36 @@
+/*
+ * crossfade.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Equal power crossfade of two interleaved stereo int16 streams at the same rate, integer math.
+ *
+ *  curve:     gNew = sin(pi/2 * x), gOld = cos(pi/2 * x), x = pos / len, gOld^2 + gNew^2 = 1: the loudness of two
+ *             unrelated programmes stays the same over the fade (a linear fade dips by 3dB in the middle)
+ *  table:     quarter sine in XF_STEPS + 1 values (Q15), linear interpolation between them (rounded), error < 3.2e-5
+ *             (one Q15 step), gOld^2 + gNew^2 within 0.9999...1.0001 at every position
+ *  position:  Q20 table index, advanced by a fixed step per frame, no division in the audio path
+ *  sum:       old * gOld + new * gNew, saturated to 16 bit (correlated material can peak at +3dB in the middle)
+ *
+ *  XF_Old() fades the old stream alone (the new one has not started yet), XF_Mix() adds both. Both advance the
+ *  position, XF_Done() is true at the end of the fade, from there gOld = 0 and gNew = 1.
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define XF_STEPS        256
+#define XF_FRAC_BITS    20
+
+typedef struct {
+    uint32_t  phase;                // Q20 index in the sine table, XF_STEPS << XF_FRAC_BITS: end of the fade
+    uint32_t  step;                 // per frame
+    uint32_t  frames;               // length of the fade
+} xfade_t;
+
+void XF_Init(xfade_t* xf, uint32_t frames);                                  // new fade over frames (> 0)
+void XF_Old(xfade_t* xf, int16_t* old, uint16_t frames);                     // old stream alone, in place
+void XF_Mix(xfade_t* xf, int16_t* dst, const int16_t* old, uint16_t frames); // dst: new stream in, sum out
+inline bool XF_Done(const xfade_t* xf) {return xf->phase >= ((uint32_t)XF_STEPS << XF_FRAC_BITS);}
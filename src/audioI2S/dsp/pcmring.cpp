@@ -0,0 +1,96 @@
+/*
+ * pcmring.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  PCM ring between decoder and I2S output task, see pcmring.h
+ */
+#include "pcmring.h"
+#include "Arduino.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+PcmRing::~PcmRing() {
+    if(m_buffer) free(m_buffer);
+    m_buffer = NULL;
+}
+
+bool PcmRing::init(size_t frames) {
+    if(m_buffer) free(m_buffer);
+    m_size = 0;
+    size_t sz = 64;
+    while(sz * 2 <= frames) sz *= 2;  // power of two, the indices are free running 32 bit counters
+    m_buffer = (uint32_t*) heap_caps_calloc(sz, sizeof(uint32_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(!m_buffer) return false;
+    m_size = sz;
+    m_wr.store(0);
+    m_rd.store(0);
+    m_flushTo.store(0);
+    m_flushReq.store(0);
+    m_flushSeen = 0;
+    m_markWr.store(0);
+    m_markRd.store(0);
+    return true;
+}
+
+size_t PcmRing::filled() {
+    return m_wr.load(std::memory_order_acquire) - m_rd.load(std::memory_order_acquire);
+}
+
+size_t PcmRing::freeSpace() {
+    return m_size - filled();
+}
+
+size_t PcmRing::write(const uint32_t* src, size_t frames) {
+    uint32_t wr = m_wr.load(std::memory_order_relaxed);
+    size_t   space = m_size - (wr - m_rd.load(std::memory_order_acquire));
+    if(frames > space) frames = space;
+    size_t pos = wr & (m_size - 1);
+    size_t n = frames < m_size - pos ? frames : m_size - pos;
+    memcpy(m_buffer + pos, src, n * sizeof(uint32_t));
+    memcpy(m_buffer, src + n, (frames - n) * sizeof(uint32_t));
+    m_wr.store(wr + frames, std::memory_order_release);
+    return frames;
+}
+
+size_t PcmRing::read(uint32_t* dst, size_t frames, uint32_t* mark) {
+    uint32_t rd = m_rd.load(std::memory_order_relaxed);
+    uint32_t req = m_flushReq.load(std::memory_order_acquire);
+    if(req != m_flushSeen) {
+        m_flushSeen = req;
+        uint32_t to = m_flushTo.load(std::memory_order_acquire);
+        if((int32_t)(to - rd) > 0) rd = to;
+    }
+    size_t   avail = m_wr.load(std::memory_order_acquire) - rd; // marks put later lie behind these frames
+    uint32_t mr = m_markRd.load(std::memory_order_relaxed);
+    uint32_t mw = m_markWr.load(std::memory_order_acquire);
+    while(mr != mw) {
+        const mark_t& m = m_marks[mr & (PCMRING_MARKS - 1)];
+        if((int32_t)(m.at - rd) > 0) {              // ahead, stop in front of it
+            if(avail > m.at - rd) avail = m.at - rd;
+            break;
+        }
+        if(mark) *mark = m.val;                     // reached (or flushed past), the frames from here belong to it
+        mr++;
+    }
+    m_markRd.store(mr, std::memory_order_release);
+    if(frames > avail) frames = avail;
+    size_t pos = rd & (m_size - 1);
+    size_t n = frames < m_size - pos ? frames : m_size - pos;
+    memcpy(dst, m_buffer + pos, n * sizeof(uint32_t));
+    memcpy(dst + n, m_buffer, (frames - n) * sizeof(uint32_t));
+    m_rd.store(rd + frames, std::memory_order_release);
+    return frames;
+}
+
+void PcmRing::flush() {
+    m_flushTo.store(m_wr.load(std::memory_order_relaxed), std::memory_order_release);
+    m_flushReq.fetch_add(1, std::memory_order_release);
+}
+
+bool PcmRing::mark(uint32_t value) {
+    uint32_t mw = m_markWr.load(std::memory_order_relaxed);
+    if(mw - m_markRd.load(std::memory_order_acquire) >= PCMRING_MARKS) return false;
+    m_marks[mw & (PCMRING_MARKS - 1)] = {m_wr.load(std::memory_order_relaxed), value};
+    m_markWr.store(mw + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * pcmring.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Lock-free ring of I2S frames (L/R int16 in one word) between the decoder (single producer) and the I2S output
+ *  task (single consumer), allocated in internal RAM. Read and write indices are free running frame counters.
+ *
+ *  m_buffer          m_rd % m_size                 m_wr % m_size
+ *   |                     |<-------- filled() -------->|                          |
+ *   ▼                     ▼                            ▼                          ▼
+ *   -----------------------------------------------------------------------------
+ *
+ *  flush() is called by the producer, the consumer drops everything written before at its next read()
+ *  mark() puts a value (the new sample rate) between the frames written so far and the next ones, read() stops in
+ *  front of it and hands it over with the first frames behind it. Up to PCMRING_MARKS marks wait in a FIFO, each
+ *  one keeps its frames; marks with no frame between them are handed over as the last one. mark() returns false
+ *  while the FIFO is full, the producer waits for the consumer then.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#define PCMRING_MARKS   8       // power of two
+
+class PcmRing {
+public:
+    PcmRing() {}
+    ~PcmRing();
+    bool     init(size_t frames);               // false if there is not enough internal RAM
+    bool     isInitialized() { return m_buffer != NULL; }
+    size_t   write(const uint32_t* src, size_t frames); // producer, returns the number of frames written
+    size_t   read(uint32_t* dst, size_t frames, uint32_t* mark = NULL); // consumer, returns the number of frames read
+    void     flush();                           // producer
+    bool     mark(uint32_t value);              // producer, value != 0, false: PCMRING_MARKS marks are pending
+    size_t   filled();                          // frames waiting for the I2S output
+    size_t   freeSpace();
+    size_t   size() { return m_size; }
+
+protected:
+    struct mark_t {uint32_t at; uint32_t val;}; // write index of the mark, value
+    uint32_t*             m_buffer = NULL;
+    size_t                m_size = 0;
+    std::atomic<uint32_t> m_wr{0};              // written by the producer only
+    std::atomic<uint32_t> m_rd{0};              // written by the consumer only
+    std::atomic<uint32_t> m_flushTo{0};         // producer: drop all frames before this write index
+    std::atomic<uint32_t> m_flushReq{0};        // producer: incremented with every flush()
+    uint32_t              m_flushSeen = 0;      // consumer: last flush request handled
+    mark_t                m_marks[PCMRING_MARKS];
+    std::atomic<uint32_t> m_markWr{0};          // producer: marks put, free running
+    std::atomic<uint32_t> m_markRd{0};          // consumer: marks handed over, free running
+};
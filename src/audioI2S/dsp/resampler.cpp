@@ -0,0 +1,135 @@
+/*
+ * resampler.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Fixed point polyphase resampler, see resampler.h
+ */
+#include "resampler.h"
+#include <string.h>
+#include <math.h>
+
+static const uint8_t rsTaps[3]      = {8, 16, 32};
+static const uint8_t rsPhaseBits[3] = {5, 6, 7};
+static const float   rsCutoff[3]    = {0.80f, 0.88f, 0.92f};   // of min(in, out) / 2
+static const float   rsBeta[3]      = {5.0f, 7.0f, 9.0f};      // Kaiser window
+
+//----------------------------------------------------------------------------------------------------------------------
+static inline int16_t rs_sat16(int32_t v){
+    if(v >  32767) return  32767;
+    if(v < -32768) return -32768;
+    return (int16_t)v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static double rs_bessel0(double x){
+    // modified Bessel function of the first kind, order 0 (Kaiser window)
+    double sum = 1.0, term = 1.0;
+    for(uint8_t k = 1; k < 32; k++){
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if(term < sum * 1e-12) break;
+    }
+    return sum;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void rs_design(resampler_t* rs, uint8_t quality){
+    // row p, tap j: h(p / phases + taps / 2 - 1 - j), t in input frames
+    float  ratio = rs->outRate < rs->inRate ? (float)rs->outRate / rs->inRate : 1.0f;
+    double fc = 0.5 * (double)(rsCutoff[quality] * ratio);      // cycles per input frame
+    double beta = rsBeta[quality];
+    double half = rs->taps / 2.0;
+    double i0b = rs_bessel0(beta);
+    double h[RS_MAX_TAPS];
+    for(uint16_t p = 0; p <= rs->phases; p++){
+        double sum = 0;
+        for(uint16_t j = 0; j < rs->taps; j++){
+            double t = (double)p / rs->phases + half - 1 - j;
+            double s = t == 0 ? 2 * fc : sin(2 * M_PI * fc * t) / (M_PI * t);
+            double r = t / half;
+            double w = r * r < 1 ? rs_bessel0(beta * sqrt(1 - r * r)) / i0b : 0;
+            h[j] = s * w;
+            sum += h[j];
+        }
+        int16_t* c = rs->coef + p * rs->taps;
+        int32_t  q = 0;
+        for(uint16_t j = 0; j < rs->taps; j++){
+            c[j] = (int16_t)lrint(h[j] / sum * 32768.0);
+            q += c[j];
+        }
+        c[rs->taps / 2 - 1 + (p > rs->phases / 2)] += 32768 - q;  // DC gain exactly 1, rest to the largest tap
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RS_Init(resampler_t* rs, void* mem, uint16_t inFrames, uint8_t quality){
+    if(quality > RS_HIGH) quality = RS_HIGH;
+    memset(rs, 0, sizeof(resampler_t));
+    rs->coef      = (int16_t*)mem;
+    rs->buf       = rs->coef + (RS_MAX_PHASES + 1) * RS_MAX_TAPS;
+    rs->taps      = rsTaps[quality];
+    rs->phaseBits = rsPhaseBits[quality];
+    rs->phases    = 1 << rs->phaseBits;
+    rs->inFrames  = inFrames;
+    rs->quality   = quality;
+    rs->stepInt   = 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RS_SetRate(resampler_t* rs, uint32_t inRate, uint32_t outRate){
+    bool redesign = (inRate != rs->inRate || outRate != rs->outRate);
+    rs->inRate  = inRate;
+    rs->outRate = outRate;
+    rs->active  = inRate && outRate && inRate != outRate;
+    if(rs->active){
+        uint64_t step = ((uint64_t)inRate << 32) / outRate;
+        rs->stepInt  = (uint32_t)(step >> 32);
+        rs->stepFrac = (uint32_t)step;
+        if(redesign) rs_design(rs, rs->quality);
+    }
+    RS_Reset(rs);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RS_Reset(resampler_t* rs){
+    // taps / 2 - 1 frames of silence, the first output frame is at the first input frame
+    rs->fill = rs->taps / 2 - 1;
+    memset(rs->buf, 0, rs->fill * 2 * sizeof(int16_t));
+    rs->idx  = 0;
+    rs->frac = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int16_t* RS_Input(resampler_t* rs){
+    if(rs->fill > RS_MAX_TAPS) return NULL;                     // RS_Read() first
+    return rs->buf + 2 * rs->fill;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RS_Written(resampler_t* rs, uint16_t frames){
+    rs->fill += frames;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint16_t RS_Read(resampler_t* rs, int16_t* out, uint16_t maxFrames){
+    uint16_t n = 0;
+    const uint8_t shift = 32 - rs->phaseBits;
+    while(n < maxFrames && rs->idx + rs->taps <= rs->fill){
+        const int16_t* x  = rs->buf + 2 * rs->idx;
+        const int16_t* c0 = rs->coef + (rs->frac >> shift) * rs->taps;
+        const int16_t* c1 = c0 + rs->taps;
+        int32_t l0 = 0, l1 = 0, r0 = 0, r1 = 0;
+        for(uint16_t j = 0; j < rs->taps; j++){
+            int32_t xl = x[2 * j], xr = x[2 * j + 1];
+            l0 += xl * c0[j]; l1 += xl * c1[j];
+            r0 += xr * c0[j]; r1 += xr * c1[j];
+        }
+        int64_t w = (rs->frac << rs->phaseBits) >> 17;         // weight of the next phase, Q15
+        out[2 * n]     = rs_sat16((int32_t)(((int64_t)l0 * (32768 - w) + (int64_t)l1 * w + (1LL << 29)) >> 30));
+        out[2 * n + 1] = rs_sat16((int32_t)(((int64_t)r0 * (32768 - w) + (int64_t)r1 * w + (1LL << 29)) >> 30));
+        n++;
+        uint32_t f = rs->frac + rs->stepFrac;
+        rs->idx += rs->stepInt + (f < rs->frac);
+        rs->frac = f;
+    }
+    if(rs->idx){                                                // drop the frames that are no longer needed
+        uint16_t drop = rs->idx < rs->fill ? rs->idx : rs->fill;
+        memmove(rs->buf, rs->buf + 2 * drop, (rs->fill - drop) * 2 * sizeof(int16_t));
+        rs->fill -= drop;
+        rs->idx  -= drop;
+    }
+    return n;
+}
@@ -0,0 +1,65 @@
+/*
+ * resampler.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Fixed point polyphase resampler, interleaved stereo int16, any input rate to one output rate.
+ *
+ *  filter:    Kaiser windowed sinc, cutoff below min(in, out) / 2, taps per phase and number of phases from the
+ *             quality preset, every phase normalized to a DC gain of 1, Q15 coefficients
+ *  phase:     Q32 fraction of the input position, the output is interpolated linear between the two nearest
+ *             phases (2 dot products per channel and output frame, 32 bit MAC)
+ *
+ *  preset     taps  phases  table
+ *  RS_LOW        8      32   0.5kB
+ *  RS_MEDIUM    16      64   2.1kB
+ *  RS_HIGH      32     128   8.3kB
+ *
+ *  SNR to 48kHz in dB, 1kHz / 10kHz sine at -1dBFS (test/native/test_resampler asserts every value)
+ *  preset     44.1kHz   22.05kHz  24kHz     32kHz     96kHz
+ *  RS_LOW     61 / 36   54 / -    55 /  5   59 / 16   57 / 17
+ *  RS_MEDIUM  80 / 78   75 / -    76 / 10   78 / 52   79 / 42
+ *  RS_HIGH    87 / 84   85 / -    75 / 23   85 / 83   91 / 82
+ *
+ *  known limit: the transition band of the filter is a fixed number of taps wide, in input frames. A tone near the
+ *  input Nyquist frequency lies in it and is damped: 10kHz is 0.83 of it at 24kHz, 0.63 at 32kHz. Downsampling 96kHz
+ *  the taps cover only half as many output frames, the band is twice as wide. A higher cutoff does not help (tried
+ *  0.90 / 0.95 / 0.97: 24kHz RS_LOW 9dB, RS_MEDIUM 44.1kHz worse), only more taps do; streams at 24kHz (HE-AAC) rarely
+ *  carry much above 10kHz.
+ *
+ *  RS_Input() returns room for inFrames (RS_Init), RS_Written() commits them, RS_Read() produces output frames
+ *  while there are enough input frames. RS_SetRate() restarts the stream (history cleared).
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include <stdint.h>
+#include <stdbool.h>
+
+enum { RS_LOW = 0, RS_MEDIUM = 1, RS_HIGH = 2 };
+
+#define RS_MAX_TAPS     32
+#define RS_MAX_PHASES   128
+#define RS_MEM_SIZE(inFrames)  (((RS_MAX_PHASES + 1) * RS_MAX_TAPS + ((inFrames) + RS_MAX_TAPS) * 2) * sizeof(int16_t))
+
+typedef struct {
+    int16_t*  coef;                 // (phases + 1) rows of taps
+    int16_t*  buf;                  // input frames, interleaved
+    uint16_t  taps, phases;
+    uint8_t   phaseBits;
+    uint8_t   quality;
+    uint16_t  inFrames;             // capacity of RS_Input()
+    uint16_t  fill;                 // frames in buf
+    uint16_t  idx;                  // first tap of the next output frame
+    uint32_t  frac;                 // position between idx and idx + 1, Q32
+    uint32_t  stepInt, stepFrac;    // input frames per output frame
+    uint32_t  inRate, outRate;
+    bool      active;               // false: rates are equal, bypass
+} resampler_t;
+
+void     RS_Init(resampler_t* rs, void* mem, uint16_t inFrames, uint8_t quality); // mem: RS_MEM_SIZE(inFrames)
+void     RS_SetRate(resampler_t* rs, uint32_t inRate, uint32_t outRate);
+void     RS_Reset(resampler_t* rs);
+int16_t* RS_Input(resampler_t* rs);
+void     RS_Written(resampler_t* rs, uint16_t frames);
+uint16_t RS_Read(resampler_t* rs, int16_t* out, uint16_t maxFrames);
@@ -0,0 +1,137 @@
+/*
+ * spectrum.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Spectrum analyzer, see spectrum.h
+ */
+#include "spectrum.h"
+#include "../aac_decoder/aac_decoder.h"
+#include <string.h>
+#include <math.h>
+
+#define SP_FFT_TABIDX   1               // R4FFT(): 512 complex points
+#define SP_REF_LOG2     (52 << 8)       // peak bin of a full scale sine: |X| = 32767 * 2^10 * 256 / 128 ~ 2^26
+
+static const uint16_t spLog2Frac[17] = {  // log2(1 + i/16), Q8
+    0, 22, 44, 63, 82, 100, 118, 134, 150, 165, 179, 193, 207, 220, 232, 244, 256
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t sp_log2(uint64_t v){
+    // log2(v) in Q8, v > 0
+    int32_t n = 63 - __builtin_clzll(v);
+    uint32_t m = n >= 8 ? (uint32_t)(v >> (n - 8)) & 0xFF : (uint32_t)(v << (8 - n)) & 0xFF; // fraction, Q8
+    uint32_t i = m >> 4, f = m & 0x0F;
+    return (n << 8) + spLog2Frac[i] + (((spLog2Frac[i + 1] - spLog2Frac[i]) * f) >> 4);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void sp_edges(spectrum_t* sp, uint8_t bands, uint32_t rate){
+    // log spaced band edges in bins, every band gets at least one bin
+    float fHigh = rate / 2 < SP_FREQ_HIGH ? rate / 2 : SP_FREQ_HIGH;
+    float ratio = powf(fHigh / SP_FREQ_LOW, 1.0f / bands);
+    float binHz = (float)rate / SP_FFT_LEN;
+    float f = SP_FREQ_LOW;
+    sp->edge[0] = (uint16_t)lrintf(f / binHz);
+    if(sp->edge[0] < 1) sp->edge[0] = 1;                        // no DC
+    for(uint8_t b = 1; b <= bands; b++){
+        f *= ratio;
+        uint16_t e = (uint16_t)lrintf(f / binHz);
+        if(e <= sp->edge[b - 1]) e = sp->edge[b - 1] + 1;
+        if(e > SP_FFT_LEN / 2) e = SP_FFT_LEN / 2;
+        sp->edge[b] = e;
+    }
+    sp->bands = bands;
+    sp->edgeRate = rate;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SP_Init(spectrum_t* sp, void* mem){
+    memset(sp, 0, sizeof(spectrum_t));
+    memset(mem, 0, SP_MEM_SIZE);
+    sp->fft    = (int32_t*)mem;
+    sp->cosTab = sp->fft + SP_FFT_LEN;
+    sp->tap    = (int16_t*)(sp->cosTab + 257);
+    sp->window = sp->tap + SP_TAP_LEN;
+    for(uint16_t n = 0; n < SP_FFT_LEN / 2; n++){
+        sp->window[n] = (int16_t)lrintf(32767.0f * (0.5f - 0.5f * cosf(2.0f * (float)M_PI * (n + 0.5f) / SP_FFT_LEN)));
+    }
+    for(uint16_t k = 0; k <= 256; k++){
+        sp->cosTab[k] = (int32_t)lrint(2147483647.0 * cos(M_PI * k / 512));
+    }
+    sp->decim = 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SP_Reset(spectrum_t* sp){
+    sp->odd = false;
+    sp->acc = 0;
+    sp->rd = sp->wr;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SP_Tap(spectrum_t* sp, const int16_t* buff, uint16_t frames, uint32_t sampleRate){
+    if(sampleRate != sp->tapRate){
+        sp->decim = sampleRate > 32000 ? 2 : 1;
+        sp->odd = false;
+        sp->tapRate = sampleRate;
+    }
+    uint32_t w = sp->wr;
+    for(uint16_t i = 0; i < frames; i++){
+        int32_t s = ((int32_t)buff[2 * i] + buff[2 * i + 1]) >> 1;
+        if(sp->decim == 2){
+            if(!sp->odd){ sp->acc = s; sp->odd = true; continue; }
+            s = (sp->acc + s) >> 1;                             // 2 tap average, enough for a display
+            sp->odd = false;
+        }
+        sp->tap[w % SP_TAP_LEN] = s;
+        w++;
+    }
+    __sync_synchronize();
+    sp->wr = w;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool SP_Compute(spectrum_t* sp, uint8_t* levels, uint8_t bands){
+    uint32_t w = sp->wr;
+    if(w == sp->rd || w < SP_FFT_LEN) return false;
+    sp->rd = w;
+    if(bands > SP_MAX_BANDS) bands = SP_MAX_BANDS;
+    uint32_t rate = sp->tapRate / sp->decim;
+    if(bands != sp->bands || rate != sp->edgeRate) sp_edges(sp, bands, rate);
+
+    // newest SP_FFT_LEN samples, windowed, even samples -> re, odd -> im, 5 guard bits for R4FFT()
+    int32_t* z = sp->fft;
+    uint32_t r = w - SP_FFT_LEN;
+    for(uint16_t n = 0; n < SP_FFT_LEN; n++){
+        uint16_t wn = n < SP_FFT_LEN / 2 ? n : SP_FFT_LEN - 1 - n;
+        int32_t  s  = ((int32_t)sp->tap[(r + n) % SP_TAP_LEN] * sp->window[wn]) >> 15;
+        z[n] = s << 10;
+    }
+    R4FFT(SP_FFT_TABIDX, z);                                    // Z = DFT512(z) / 128
+
+    // split: X[k] = (Z[k] + Z*[N-k]) / 2 - j * W^k * (Z[k] - Z*[N-k]) / 2, W = exp(-j*2*pi/1024)
+    // band energies are summed from the bins, bins 0 and 512 are not used
+    uint8_t  b = 0;
+    uint64_t energy = 0;
+    for(uint16_t k = sp->edge[0]; k < sp->edge[bands] && k < SP_FFT_LEN / 2; k++){
+        int32_t zr = z[2 * k], zi = z[2 * k + 1];
+        int32_t cr = z[2 * (SP_FFT_LEN / 2 - k)], ci = -z[2 * (SP_FFT_LEN / 2 - k) + 1];
+        int32_t er = (zr + cr) >> 1, ei = (zi + ci) >> 1;     // even part
+        int32_t or_ = (zr - cr) >> 1, oi = (zi - ci) >> 1;    // odd part * j
+        int32_t wc = k <= 256 ? sp->cosTab[k] : -sp->cosTab[512 - k];  // cos(pi*k/512)
+        int32_t ws = sp->cosTab[k <= 256 ? 256 - k : k - 256];         // sin(pi*k/512)
+        // -j * (wc - j*ws) * (or + j*oi) = (wc*oi - ws*or) - j*(wc*or + ws*oi)
+        int64_t xr = er + (((int64_t)wc * oi - (int64_t)ws * or_) >> 31);
+        int64_t xi = ei - (((int64_t)wc * or_ + (int64_t)ws * oi) >> 31);
+        energy += (uint64_t)(xr * xr + xi * xi);
+        if(k + 1 == sp->edge[b + 1]){
+            int32_t lv = 0;
+            if(energy){
+                int32_t db = ((sp_log2(energy) - SP_REF_LOG2) * 771) >> 8;  // 10 * log10(e / ref) in Q8
+                lv = (db + (SP_RANGE_DB << 8)) * 255 / (SP_RANGE_DB << 8);
+            }
+            levels[b] = lv < 0 ? 0 : lv > 255 ? 255 : lv;
+            energy = 0;
+            b++;
+        }
+    }
+    for(; b < bands; b++) levels[b] = 0;
+    return true;
+}
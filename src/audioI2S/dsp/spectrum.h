@@ -0,0 +1,52 @@
+/*
+ * spectrum.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Spectrum analyzer: mono tap of the I2S blocks, 1024 point real FFT, log spaced bands.
+ *
+ *  tap:       SP_Tap() runs in the audio path, (L+R)/2, decimated by 2 above 32kHz (22.05/24kHz tap rate),
+ *             written into a ring of SP_TAP_LEN samples
+ *  transform: SP_Compute() runs in the caller's task (display), takes the newest SP_FFT_LEN samples,
+ *             Hann window, the real signal is packed into 512 complex points for R4FFT() of the AAC decoder
+ *             (radix-4, Q31 twiddles) and split into 512 bins (21.5...23.4Hz at the tap rate)
+ *  bands:     energy sum of the bins between log spaced edges (SP_FREQ_LOW ... min(SP_FREQ_HIGH, rate/2)),
+ *             every band has at least one bin, level 0...255 = -SP_RANGE_DB ... 0dB (full scale sine)
+ *
+ *  single writer (SP_Tap) and single reader (SP_Compute), the reader uses the samples behind the write index,
+ *  the tap ring is twice the transform length so a block written during the copy never reaches them
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SP_FFT_LEN    1024
+#define SP_TAP_LEN    (SP_FFT_LEN * 2)
+#define SP_MAX_BANDS  32
+#define SP_FREQ_LOW   50
+#define SP_FREQ_HIGH  16000
+#define SP_RANGE_DB   60
+#define SP_MEM_SIZE   (SP_TAP_LEN * 2 + SP_FFT_LEN * 4 + SP_FFT_LEN + 257 * 4)   // tap, fft, window, cos table
+
+typedef struct {
+    int16_t*  tap;                  // SP_TAP_LEN mono samples
+    int32_t*  fft;                  // SP_FFT_LEN / 2 complex points
+    int16_t*  window;               // first half of the Hann window, Q15
+    int32_t*  cosTab;               // cos(pi * k / 512), k = 0...256, Q31
+    volatile uint32_t wr;           // samples written (the ring index is wr % SP_TAP_LEN)
+    volatile uint32_t tapRate;
+    uint32_t  rd;                   // wr of the last transform
+    uint8_t   decim;
+    bool      odd;                  // decimator: one sample is waiting in acc
+    int32_t   acc;
+    uint8_t   bands;                // band edges are valid for bands and edgeRate
+    uint32_t  edgeRate;
+    uint16_t  edge[SP_MAX_BANDS + 1];
+} spectrum_t;
+
+void SP_Init(spectrum_t* sp, void* mem);    // mem: SP_MEM_SIZE bytes, 4 byte aligned
+void SP_Reset(spectrum_t* sp);
+void SP_Tap(spectrum_t* sp, const int16_t* buff, uint16_t frames, uint32_t sampleRate);
+bool SP_Compute(spectrum_t* sp, uint8_t* levels, uint8_t bands); // false: no new samples since the last call
@@ -0,0 +1,104 @@
+/*
+ * vumeter.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Block level meter, see vumeter.h
+ */
+#include "vumeter.h"
+#include <string.h>
+
+#define VU_FULLSCALE 32767
+
+//----------------------------------------------------------------------------------------------------------------------
+static uint16_t vu_isqrt(uint32_t x){
+    uint32_t r = 0, b = 1UL << 30;
+    while(b > x) b >>= 2;
+    while(b){
+        if(x >= r + b){
+            x -= r + b;
+            r = (r >> 1) + b;
+        }
+        else r >>= 1;
+        b >>= 2;
+    }
+    return (uint16_t)r;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t vu_fall(uint32_t level, uint32_t blockUs, uint32_t decayUs){
+    uint32_t d = decayUs ? (uint32_t)(((uint64_t)VU_FULLSCALE * blockUs) / decayUs) : VU_FULLSCALE;
+    return level > d ? level - d : 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VU_Init(vuMeter_t* vu, uint16_t holdMs, uint16_t decayMs, uint16_t rmsMs){
+    memset(vu, 0, sizeof(vuMeter_t));
+    vu->holdUs  = holdMs  * 1000UL;
+    vu->decayUs = decayMs * 1000UL;
+    vu->rmsUs   = rmsMs   * 1000UL;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VU_Reset(vuMeter_t* vu){
+    memset(vu->meanSq, 0, sizeof(vu->meanSq));
+    memset(vu->peak, 0, sizeof(vu->peak));
+    memset(vu->hold, 0, sizeof(vu->hold));
+    memset(vu->holdAge, 0, sizeof(vu->holdAge));
+    vu->seq++;
+    memset(&vu->snap, 0, sizeof(vu->snap));
+    __sync_synchronize();
+    vu->seq++;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VU_Process(vuMeter_t* vu, const int16_t* buff, uint16_t frames, uint32_t sampleRate){
+    if(!frames || !sampleRate) return;
+    uint32_t blockUs = (uint32_t)(((uint64_t)frames * 1000000UL) / sampleRate);
+    uint32_t alpha = (uint32_t)(((uint64_t)blockUs << 16) / (vu->rmsUs + blockUs));   // Q16, 1 - exp(-t/tau)
+    vuLevels_t lv;
+
+    for(uint8_t ch = 0; ch < 2; ch++){
+        const int16_t* s = buff + ch;
+        uint32_t pk = 0;
+        uint64_t sq = 0;
+        for(uint16_t i = 0; i < frames; i++){
+            int32_t x = s[2 * i];
+            uint32_t a = x < 0 ? -x : x;
+            if(a > pk) pk = a;
+            sq += (uint32_t)(x * x);
+        }
+        if(pk > VU_FULLSCALE) pk = VU_FULLSCALE;                   // -32768
+
+        uint32_t ms = (uint32_t)(sq / frames);
+        int64_t  d  = (int64_t)ms - vu->meanSq[ch];
+        vu->meanSq[ch] += (int32_t)((d * alpha) >> 16);
+
+        vu->peak[ch] = vu_fall(vu->peak[ch], blockUs, vu->decayUs);
+        if(pk > vu->peak[ch]) vu->peak[ch] = pk;
+
+        vu->holdAge[ch] += blockUs;
+        if(vu->holdAge[ch] > vu->holdUs) vu->hold[ch] = vu_fall(vu->hold[ch], blockUs, vu->decayUs);
+        if(pk >= vu->hold[ch]){
+            vu->hold[ch] = pk;
+            vu->holdAge[ch] = 0;
+        }
+
+        lv.peak[ch] = vu->peak[ch];
+        lv.hold[ch] = vu->hold[ch];
+        lv.rms[ch]  = vu_isqrt(vu->meanSq[ch]);
+    }
+
+    vu->seq++;                  // odd: snapshot is written
+    __sync_synchronize();
+    vu->snap = lv;
+    __sync_synchronize();
+    vu->seq++;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VU_Read(vuMeter_t* vu, vuLevels_t* levels){
+    uint32_t s1, s2;
+    do{
+        s1 = vu->seq;
+        __sync_synchronize();
+        *levels = vu->snap;
+        __sync_synchronize();
+        s2 = vu->seq;
+    } while((s1 & 1) || s1 != s2);
+}
@@ -0,0 +1,40 @@
+/*
+ * vumeter.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Block level meter: true peak and RMS per channel, integer math, called once per I2S block.
+ *
+ *  peak:  max |sample| of the block, falls linear from full scale to 0 within decayMs
+ *  hold:  highest peak, held for holdMs, then falls like peak
+ *  rms:   mean square of the block, smoothed with the time constant rmsMs
+ *
+ *  All times are derived from the block length and the sample rate, the ballistics are the same at any rate.
+ *  The levels (0...32767) are published through a sequence locked snapshot, VU_Read() can be called from any
+ *  task and never blocks the audio path (single writer).
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include <stdint.h>
+
+typedef struct {
+    uint16_t peak[2];           // left, right
+    uint16_t hold[2];
+    uint16_t rms[2];
+} vuLevels_t;
+
+typedef struct {
+    uint32_t holdUs, decayUs, rmsUs;
+    uint32_t meanSq[2];         // smoothed mean square
+    uint32_t peak[2];           // decaying peak
+    uint32_t hold[2];
+    uint32_t holdAge[2];        // us since the hold value was set
+    vuLevels_t snap;
+    volatile uint32_t seq;      // odd while snap is written
+} vuMeter_t;
+
+void VU_Init(vuMeter_t* vu, uint16_t holdMs, uint16_t decayMs, uint16_t rmsMs);
+void VU_Reset(vuMeter_t* vu);
+void VU_Process(vuMeter_t* vu, const int16_t* buff, uint16_t frames, uint32_t sampleRate);
+void VU_Read(vuMeter_t* vu, vuLevels_t* levels);
@@ -11,268 +11,248 @@
  *
  */
 #include "flac_decoder.h"
-#include "vector"
-using namespace std;
 
 
-FLACFrameHeader_t   *FLACFrameHeader;
-FLACMetadataBlock_t *FLACMetadataBlock;
-FLACsubFramesBuff_t *FLACsubFramesBuff;
+FLACDecoder *m_FLACDec = NULL;  // default instance behind the compatibility API
 
-vector<int32_t>coefs;
 const uint16_t outBuffSize = 2048;
-uint16_t m_blockSize=0;
-uint16_t m_blockSizeLeft = 0;
-uint16_t m_validSamples = 0;
-uint8_t  m_status = 0;
-uint8_t* m_inptr;
-int16_t  m_bytesAvail;
-int16_t  m_bytesDecoded = 0;
-float    m_compressionRatio = 0;
-uint16_t m_rIndex=0;
-uint64_t m_bitBuffer = 0;
-uint8_t  m_bitBufferLen = 0;
-bool     m_f_OggS_found = false;
 
 //----------------------------------------------------------------------------------------------------------------------
 //          FLAC INI SECTION
 //----------------------------------------------------------------------------------------------------------------------
-bool FLACDecoder_AllocateBuffers(void){
+bool FLACDecoder_AllocateBuffers(FLACDecoder* dec){
     if(psramFound()) {
         // PSRAM found, Buffer will be allocated in PSRAM
-        if(!FLACFrameHeader)    {FLACFrameHeader   = (FLACFrameHeader_t*)    ps_malloc(sizeof(FLACFrameHeader_t));}
-        if(!FLACMetadataBlock)  {FLACMetadataBlock = (FLACMetadataBlock_t*)  ps_malloc(sizeof(FLACMetadataBlock_t));}
-        if(!FLACsubFramesBuff)  {FLACsubFramesBuff = (FLACsubFramesBuff_t*)  ps_malloc(sizeof(FLACsubFramesBuff_t));}
+        if(!dec->FLACFrameHeader)    {dec->FLACFrameHeader   = (FLACFrameHeader_t*)    ps_malloc(sizeof(FLACFrameHeader_t));}
+        if(!dec->FLACMetadataBlock)  {dec->FLACMetadataBlock = (FLACMetadataBlock_t*)  ps_malloc(sizeof(FLACMetadataBlock_t));}
+        if(!dec->FLACsubFramesBuff)  {dec->FLACsubFramesBuff = (FLACsubFramesBuff_t*)  ps_malloc(sizeof(FLACsubFramesBuff_t));}
     }
     else {
-        if(!FLACFrameHeader)    {FLACFrameHeader   = (FLACFrameHeader_t*)    malloc(sizeof(FLACFrameHeader_t));}
-        if(!FLACMetadataBlock)  {FLACMetadataBlock = (FLACMetadataBlock_t*)  malloc(sizeof(FLACMetadataBlock_t));}
-        if(!FLACsubFramesBuff)  {FLACsubFramesBuff = (FLACsubFramesBuff_t*)  malloc(sizeof(FLACsubFramesBuff_t));}
+        if(!dec->FLACFrameHeader)    {dec->FLACFrameHeader   = (FLACFrameHeader_t*)    malloc(sizeof(FLACFrameHeader_t));}
+        if(!dec->FLACMetadataBlock)  {dec->FLACMetadataBlock = (FLACMetadataBlock_t*)  malloc(sizeof(FLACMetadataBlock_t));}
+        if(!dec->FLACsubFramesBuff)  {dec->FLACsubFramesBuff = (FLACsubFramesBuff_t*)  malloc(sizeof(FLACsubFramesBuff_t));}
     }
-    if(!FLACFrameHeader || !FLACMetadataBlock || !FLACsubFramesBuff ){
+    if(!dec->FLACFrameHeader || !dec->FLACMetadataBlock || !dec->FLACsubFramesBuff ){
         log_e("not enough memory to allocate flacdecoder buffers");
         return false;
     }
-    FLACDecoder_ClearBuffer();
+    FLACDecoder_ClearBuffer(dec);
     return true;
 }
 //----------------------------------------------------------------------------------------------------------------------
-void FLACDecoder_ClearBuffer(){
-    memset(FLACFrameHeader,   0, sizeof(FLACFrameHeader_t));
-    memset(FLACMetadataBlock, 0, sizeof(FLACMetadataBlock_t));
-    memset(FLACsubFramesBuff, 0, sizeof(FLACsubFramesBuff_t));
-    m_status = DECODE_FRAME;
+void FLACDecoder_ClearBuffer(FLACDecoder* dec){
+    memset(dec->FLACFrameHeader,   0, sizeof(FLACFrameHeader_t));
+    memset(dec->FLACMetadataBlock, 0, sizeof(FLACMetadataBlock_t));
+    memset(dec->FLACsubFramesBuff, 0, sizeof(FLACsubFramesBuff_t));
+    dec->m_status = DECODE_FRAME;
     return;
 }
 //----------------------------------------------------------------------------------------------------------------------
-void FLACDecoder_FreeBuffers(){
-    if(FLACFrameHeader)    {free(FLACFrameHeader);   FLACFrameHeader   = NULL;}
-    if(FLACMetadataBlock)  {free(FLACMetadataBlock); FLACMetadataBlock = NULL;}
-    if(FLACsubFramesBuff)  {free(FLACsubFramesBuff); FLACsubFramesBuff = NULL;}
+void FLACDecoder_FreeBuffers(FLACDecoder* dec){
+    if(dec->FLACFrameHeader)    {free(dec->FLACFrameHeader);   dec->FLACFrameHeader   = NULL;}
+    if(dec->FLACMetadataBlock)  {free(dec->FLACMetadataBlock); dec->FLACMetadataBlock = NULL;}
+    if(dec->FLACsubFramesBuff)  {free(dec->FLACsubFramesBuff); dec->FLACsubFramesBuff = NULL;}
+}
+//----------------------------------------------------------------------------------------------------------------------
+FLACDecoder* FLACCreate(){ // a context with its own buffers, NULL if out of memory
+    FLACDecoder* dec = (FLACDecoder*)(psramFound() ? ps_malloc(sizeof(FLACDecoder)) : malloc(sizeof(FLACDecoder)));
+    if(!dec) {log_e("not enough memory to allocate flacdecoder context"); return NULL;}
+    memset(dec, 0, sizeof(FLACDecoder));
+    if(!FLACDecoder_AllocateBuffers(dec)) {FLACDestroy(dec); return NULL;}
+    return dec;
 }
 //----------------------------------------------------------------------------------------------------------------------
+void FLACDestroy(FLACDecoder* dec){
+    if(!dec) return;
+    FLACDecoder_FreeBuffers(dec);
+    free(dec);
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          C O M P A T I B I L I T Y   (single default instance)
+//----------------------------------------------------------------------------------------------------------------------
+bool FLACDecoder_AllocateBuffers(void){
+    if(!m_FLACDec) {m_FLACDec = FLACCreate(); return m_FLACDec != NULL;}
+    return FLACDecoder_AllocateBuffers(m_FLACDec);
+}
+void FLACDecoder_ClearBuffer(){if(m_FLACDec) FLACDecoder_ClearBuffer(m_FLACDec);}
+void FLACDecoder_FreeBuffers(){FLACDestroy(m_FLACDec); m_FLACDec = NULL;}
+FLACDecoder* FLACDecoder_Detach(){FLACDecoder* dec = m_FLACDec; m_FLACDec = NULL; return dec;} // caller owns it
+void FLACDecoderReset(){if(m_FLACDec) FLACDecoderReset(m_FLACDec);}
+int  FLACFindSyncWord(unsigned char *buf, int nBytes){
+    if(m_FLACDec) return FLACFindSyncWord(m_FLACDec, buf, nBytes);
+    return -1;
+}
+int  FLACparseOggHead(unsigned char *buf, int len){return FLACparseOggHead(m_FLACDec, buf, len);}
+void FLACSetRawBlockParams(uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength){
+    FLACSetRawBlockParams(m_FLACDec, Chans, SampRate, BPS, tsis, AuDaLength);
+}
+int8_t FLACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf){return FLACDecode(m_FLACDec, inbuf, bytesLeft, outbuf);}
+int8_t FLACDecodeOggPacket(uint8_t *inbuf, int *bytesLeft, short *outbuf){return FLACDecodeOggPacket(m_FLACDec, inbuf, bytesLeft, outbuf);}
+uint16_t FLACGetOutputSamps(){return FLACGetOutputSamps(m_FLACDec);}
+uint64_t FLACGetTotoalSamplesInStream(){return FLACGetTotoalSamplesInStream(m_FLACDec);}
+uint8_t  FLACGetBitsPerSample(){return FLACGetBitsPerSample(m_FLACDec);}
+uint8_t  FLACGetChannels(){return FLACGetChannels(m_FLACDec);}
+uint32_t FLACGetSampRate(){return FLACGetSampRate(m_FLACDec);}
+uint32_t FLACGetBitRate(){return FLACGetBitRate(m_FLACDec);}
+uint32_t FLACGetAudioFileDuration(){return FLACGetAudioFileDuration(m_FLACDec);}
+//----------------------------------------------------------------------------------------------------------------------
 //            B I T R E A D E R
 //----------------------------------------------------------------------------------------------------------------------
-uint32_t readUint(uint8_t nBits){
-    while (m_bitBufferLen < nBits){
-        uint8_t temp = *(m_inptr + m_rIndex);
-        m_rIndex++;
-        m_bytesAvail--;
-        if(m_bytesAvail < 0) { log_i("error in bitreader"); }
-        m_bitBuffer = (m_bitBuffer << 8) | temp;
-        m_bitBufferLen += 8;
-    }
-    m_bitBufferLen -= nBits;
-    uint32_t result = m_bitBuffer >> m_bitBufferLen;
+uint32_t readUint(FLACDecoder* dec, uint8_t nBits){
+    while (dec->m_bitBufferLen < nBits){
+        uint8_t temp = *(dec->m_inptr + dec->m_rIndex);
+        dec->m_rIndex++;
+        dec->m_bytesAvail--;
+        if(dec->m_bytesAvail < 0) { log_i("error in bitreader"); }
+        dec->m_bitBuffer = (dec->m_bitBuffer << 8) | temp;
+        dec->m_bitBufferLen += 8;
+    }
+    dec->m_bitBufferLen -= nBits;
+    uint32_t result = dec->m_bitBuffer >> dec->m_bitBufferLen;
     if (nBits < 32)
         result &= (1 << nBits) - 1;
     return result;
 }
 
-int32_t readSignedInt(int nBits){
-    int32_t temp = readUint(nBits) << (32 - nBits);
+int32_t readSignedInt(FLACDecoder* dec, int nBits){
+    int32_t temp = readUint(dec, nBits) << (32 - nBits);
     temp = temp >> (32 - nBits); // The C++ compiler uses the sign bit to fill vacated bit positions
     return temp;
 }
 
-int64_t readRiceSignedInt(uint8_t param){
+int64_t readRiceSignedInt(FLACDecoder* dec, uint8_t param){
     long val = 0;
-    while (readUint(1) == 0)
+    while (readUint(dec, 1) == 0)
         val++;
-    val = (val << param) | readUint(param);
+    val = (val << param) | readUint(dec, param);
     return (val >> 1) ^ -(val & 1);
 }
 
-void alignToByte() {
-    m_bitBufferLen -= m_bitBufferLen % 8;
+void alignToByte(FLACDecoder* dec) {
+    dec->m_bitBufferLen -= dec->m_bitBufferLen % 8;
 }
 //----------------------------------------------------------------------------------------------------------------------
 //              F L A C - D E C O D E R
 //----------------------------------------------------------------------------------------------------------------------
-void FLACSetRawBlockParams(uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength){
-    FLACMetadataBlock->numChannels = Chans;
-    FLACMetadataBlock->sampleRate = SampRate;
-    FLACMetadataBlock->bitsPerSample = BPS;
-    FLACMetadataBlock->totalSamples = tsis;  // total samples in stream
-    FLACMetadataBlock->audioDataLength = AuDaLength;
+void FLACSetRawBlockParams(FLACDecoder* dec, uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength){
+    dec->FLACMetadataBlock->numChannels = Chans;
+    dec->FLACMetadataBlock->sampleRate = SampRate;
+    dec->FLACMetadataBlock->bitsPerSample = BPS;
+    dec->FLACMetadataBlock->totalSamples = tsis;  // total samples in stream
+    dec->FLACMetadataBlock->audioDataLength = AuDaLength;
 }
 //----------------------------------------------------------------------------------------------------------------------
-void FLACDecoderReset(){ // set var to default
-    m_status = DECODE_FRAME;
-    m_bitBuffer = 0;
-    m_bitBufferLen = 0;
+void FLACDecoderReset(FLACDecoder* dec){ // set var to default
+    dec->m_status = DECODE_FRAME;
+    dec->m_offset = 0;
+    dec->m_bitBuffer = 0;
+    dec->m_bitBufferLen = 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int FLACFindSyncWord(unsigned char *buf, int nBytes) {
+int FLACFindSyncWord(FLACDecoder* dec, unsigned char *buf, int nBytes) {
     int i;
 
     /* find byte-aligned syncword - need 13 matching bits */
     for (i = 0; i < nBytes - 1; i++) {
         if ((buf[i + 0] & 0xFF) == 0xFF  && (buf[i + 1] & 0xF8) == 0xF8) {
-            FLACDecoderReset();
+            FLACDecoderReset(dec);
             return i;
         }
     }
     return -1;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int FLACFindOggSyncWord(unsigned char *buf, int nBytes){
-    int i;
-
-    /* find byte-aligned syncword - need 13 matching bits */
-    for (i = 0; i < nBytes - 1; i++) {
-        if ((buf[i + 0] & 0xFF) == 0xFF  && (buf[i + 1] & 0xF8) == 0xF8) {
-            FLACDecoderReset();
-            log_i("FLAC sync found");
-            return i;
-        }
-    }
-    /* find byte-aligned OGG Magic - OggS */
-    for (i = 0; i < nBytes - 1; i++) {
-        if ((buf[i + 0] == 'O') && (buf[i + 1] == 'g') && (buf[i + 2] == 'g') && (buf[i + 3] == 'S')) {
-            FLACDecoderReset();
-            log_i("OggS found");
-            m_f_OggS_found = true;
-            return i;
-        }
-    }
-    return -1;
+int FLACparseOggHead(FLACDecoder* dec, unsigned char *buf, int len){
+    // FLAC in Ogg: 0x7F "FLAC", version, number of header packets, "fLaC", the STREAMINFO metadata block
+    if(len < 51 || buf[0] != 0x7F || memcmp(buf + 1, "FLAC", 4) != 0 || memcmp(buf + 9, "fLaC", 4) != 0)
+        return ERR_FLAC_OGG_HEADER;
+    uint8_t *si = buf + 17;                         // STREAMINFO
+    dec->FLACMetadataBlock->minblocksize = si[0] << 8 | si[1];
+    dec->FLACMetadataBlock->maxblocksize = si[2] << 8 | si[3];
+    dec->FLACMetadataBlock->minframesize = si[4] << 16 | si[5] << 8 | si[6];
+    dec->FLACMetadataBlock->maxframesize = si[7] << 16 | si[8] << 8 | si[9];
+    dec->FLACMetadataBlock->sampleRate = si[10] << 12 | si[11] << 4 | si[12] >> 4;
+    dec->FLACMetadataBlock->numChannels = ((si[12] >> 1) & 0x07) + 1;
+    dec->FLACMetadataBlock->bitsPerSample = ((si[12] & 0x01) << 4 | si[13] >> 4) + 1;
+    dec->FLACMetadataBlock->totalSamples = (uint64_t)(si[13] & 0x0F) << 32 | (uint32_t)si[14] << 24 | si[15] << 16 | si[16] << 8 | si[17];
+    dec->FLACMetadataBlock->audioDataLength = 0;
+    if(dec->FLACMetadataBlock->maxblocksize > MAX_BLOCKSIZE) return ERR_FLAC_BLOCKSIZE_TOO_BIG;
+    if(dec->FLACMetadataBlock->numChannels > MAX_CHANNELS) return ERR_FLAC_UNKNOWN_CHANNEL_ASSIGNMENT;
+    if(dec->FLACMetadataBlock->bitsPerSample > 16) return ERR_FLAC_BITS_PER_SAMPLE_TOO_BIG;
+    if(dec->FLACMetadataBlock->bitsPerSample != 8 && dec->FLACMetadataBlock->bitsPerSample != 16) return ERR_FLAC_OGG_HEADER; // 8 or 16 bits only
+    log_i("FLAC in Ogg: %u Hz, %u channels, %u bits, maxBlockSize %u", dec->FLACMetadataBlock->sampleRate,
+          dec->FLACMetadataBlock->numChannels, dec->FLACMetadataBlock->bitsPerSample, dec->FLACMetadataBlock->maxblocksize);
+    return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int FLACparseOggHeader(unsigned char *buf){
-    uint8_t i = 0;
-    uint8_t ssv = *(buf + i);                  // stream_structure_version
-    (void)ssv;
-    i++;
-    uint8_t htf = *(buf + i);                  // header_type_flag
-    (void)htf;
-    i++;
-    uint32_t tmp = 0;                         // absolute granule position
-    for (int j = 0; j < 4; j++) {
-        tmp += *(buf + j + i) << (4 -j - 1) * 8;
-    }
-    i += 4;
-    uint64_t agp = (uint64_t) tmp << 32;
-    for (int j = 0; j < 4; j++) {
-        agp += *(buf + j + i) << (4 -j - 1) * 8;
-    }
-    i += 4;
-    uint32_t ssnr = 0;                        // stream serial number
-    for (int j = 0; j < 4; j++) {
-        ssnr += *(buf + j + i) << (4 -j - 1) * 8;
-    }
-    i += 4;
-    uint32_t psnr = 0;                        // page sequence no
-    for (int j = 0; j < 4; j++) {
-        psnr += *(buf + j + i) << (4 -j - 1) * 8;
-    }
-    i += 4;
-    uint32_t pchk = 0;                        // page checksum
-    for (int j = 0; j < 4; j++) {
-        pchk += *(buf + j + i) << (4 -j - 1) * 8;
-    }
-    i += 4;
-    uint8_t psegm = *(buf + i);
-    i++;
-    uint8_t psegmBuff[256];
-    uint32_t pageLen = 0;
-    for(uint8_t j = 0; j < psegm; j++){
-        psegmBuff[j] = *(buf + i);
-        pageLen += psegmBuff[j];
-        i++;
-    }
-    return i;
+int8_t FLACDecodeOggPacket(FLACDecoder* dec, uint8_t *inbuf, int *bytesLeft, short *outbuf){
+    // one packet of a FLAC in Ogg stream: the mapping header, other metadata blocks (skipped) or one frame
+    if(dec->m_status == DECODE_FRAME && *bytesLeft > 0 && inbuf[0] != 0xFF){
+        int len = *bytesLeft;
+        *bytesLeft = 0;
+        if(inbuf[0] == 0x7F) return FLACparseOggHead(dec, inbuf, len);
+        return ERR_FLAC_NONE;                       // VORBIS_COMMENT, PICTURE ...
+    }
+    return FLACDecode(dec, inbuf, bytesLeft, outbuf);
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t FLACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf){
-
-    if(m_f_OggS_found == true){
-        m_f_OggS_found = false;
-        *bytesLeft -= FLACparseOggHeader(inbuf);
-        return ERR_FLAC_NONE;
-    }
+int8_t FLACDecode(FLACDecoder* dec, uint8_t *inbuf, int *bytesLeft, short *outbuf){
 
-    if(m_status != OUT_SAMPLES){
-        m_rIndex = 0;
-        m_bytesAvail = (*bytesLeft);
-        m_inptr = inbuf;
+    if(dec->m_status != OUT_SAMPLES){
+        dec->m_rIndex = 0;
+        dec->m_bytesAvail = (*bytesLeft);
+        dec->m_inptr = inbuf;
     }
 
-    if(m_status == DECODE_FRAME){  // Read a ton of header fields, and ignore most of them
+    if(dec->m_status == DECODE_FRAME){  // Read a ton of header fields, and ignore most of them
 
-        if ((inbuf[0] == 'O') && (inbuf[1] == 'g') && (inbuf[2] == 'g') && (inbuf[3] == 'S')){
-            *bytesLeft -= 4;
-            m_f_OggS_found = true;
-            return ERR_FLAC_NONE;
-        }
-
-        uint32_t temp = readUint(8);
-        uint16_t sync = temp << 6 |readUint(6);
+        uint32_t temp = readUint(dec, 8);
+        uint16_t sync = temp << 6 |readUint(dec, 6);
         if (sync != 0x3FFE){
             log_i("Sync code expected 0x3FFE but received %X", sync);
             return ERR_FLAC_SYNC_CODE_NOT_FOUND;
         }
 
-        readUint(1);
-        FLACFrameHeader->blockingStrategy = readUint(1);
-        FLACFrameHeader->blockSizeCode = readUint(4);
-        FLACFrameHeader->sampleRateCode = readUint(4);
-        FLACFrameHeader->chanAsgn = readUint(4);
-        FLACFrameHeader->sampleSizeCode = readUint(3);
-
-        if(!FLACMetadataBlock->numChannels){
-            if(FLACFrameHeader->chanAsgn == 0) FLACMetadataBlock->numChannels = 1;
-            if(FLACFrameHeader->chanAsgn == 1) FLACMetadataBlock->numChannels = 2;
-            if(FLACFrameHeader->chanAsgn > 7)  FLACMetadataBlock->numChannels = 2;
+        readUint(dec, 1);
+        dec->FLACFrameHeader->blockingStrategy = readUint(dec, 1);
+        dec->FLACFrameHeader->blockSizeCode = readUint(dec, 4);
+        dec->FLACFrameHeader->sampleRateCode = readUint(dec, 4);
+        dec->FLACFrameHeader->chanAsgn = readUint(dec, 4);
+        dec->FLACFrameHeader->sampleSizeCode = readUint(dec, 3);
+
+        if(!dec->FLACMetadataBlock->numChannels){
+            if(dec->FLACFrameHeader->chanAsgn == 0) dec->FLACMetadataBlock->numChannels = 1;
+            if(dec->FLACFrameHeader->chanAsgn == 1) dec->FLACMetadataBlock->numChannels = 2;
+            if(dec->FLACFrameHeader->chanAsgn > 7)  dec->FLACMetadataBlock->numChannels = 2;
         }
-        if(FLACMetadataBlock->numChannels < 1) return ERR_FLAC_UNKNOWN_CHANNEL_ASSIGNMENT;
-
-        if(!FLACMetadataBlock->bitsPerSample){
-            if(FLACFrameHeader->sampleSizeCode == 1) FLACMetadataBlock->bitsPerSample =  8;
-            if(FLACFrameHeader->sampleSizeCode == 2) FLACMetadataBlock->bitsPerSample = 12;
-            if(FLACFrameHeader->sampleSizeCode == 4) FLACMetadataBlock->bitsPerSample = 16;
-            if(FLACFrameHeader->sampleSizeCode == 5) FLACMetadataBlock->bitsPerSample = 20;
-            if(FLACFrameHeader->sampleSizeCode == 6) FLACMetadataBlock->bitsPerSample = 24;
+        if(dec->FLACMetadataBlock->numChannels < 1) return ERR_FLAC_UNKNOWN_CHANNEL_ASSIGNMENT;
+
+        if(!dec->FLACMetadataBlock->bitsPerSample){
+            if(dec->FLACFrameHeader->sampleSizeCode == 1) dec->FLACMetadataBlock->bitsPerSample =  8;
+            if(dec->FLACFrameHeader->sampleSizeCode == 2) dec->FLACMetadataBlock->bitsPerSample = 12;
+            if(dec->FLACFrameHeader->sampleSizeCode == 4) dec->FLACMetadataBlock->bitsPerSample = 16;
+            if(dec->FLACFrameHeader->sampleSizeCode == 5) dec->FLACMetadataBlock->bitsPerSample = 20;
+            if(dec->FLACFrameHeader->sampleSizeCode == 6) dec->FLACMetadataBlock->bitsPerSample = 24;
         }
-        if(FLACMetadataBlock->bitsPerSample > 16) return ERR_FLAC_BITS_PER_SAMPLE_TOO_BIG;
-        if(FLACMetadataBlock->bitsPerSample < 8 ) return ERR_FLAG_BITS_PER_SAMPLE_UNKNOWN;
-
-        if(!FLACMetadataBlock->sampleRate){
-            if(FLACFrameHeader->sampleRateCode == 1)  FLACMetadataBlock->sampleRate =  88200;
-            if(FLACFrameHeader->sampleRateCode == 2)  FLACMetadataBlock->sampleRate = 176400;
-            if(FLACFrameHeader->sampleRateCode == 3)  FLACMetadataBlock->sampleRate = 192000;
-            if(FLACFrameHeader->sampleRateCode == 4)  FLACMetadataBlock->sampleRate =   8000;
-            if(FLACFrameHeader->sampleRateCode == 5)  FLACMetadataBlock->sampleRate =  16000;
-            if(FLACFrameHeader->sampleRateCode == 6)  FLACMetadataBlock->sampleRate =  22050;
-            if(FLACFrameHeader->sampleRateCode == 7)  FLACMetadataBlock->sampleRate =  24000;
-            if(FLACFrameHeader->sampleRateCode == 8)  FLACMetadataBlock->sampleRate =  32000;
-            if(FLACFrameHeader->sampleRateCode == 9)  FLACMetadataBlock->sampleRate =  44100;
-            if(FLACFrameHeader->sampleRateCode == 10) FLACMetadataBlock->sampleRate =  48000;
-            if(FLACFrameHeader->sampleRateCode == 11) FLACMetadataBlock->sampleRate =  96000;
+        if(dec->FLACMetadataBlock->bitsPerSample > 16) return ERR_FLAC_BITS_PER_SAMPLE_TOO_BIG;
+        if(dec->FLACMetadataBlock->bitsPerSample < 8 ) return ERR_FLAG_BITS_PER_SAMPLE_UNKNOWN;
+
+        if(!dec->FLACMetadataBlock->sampleRate){
+            if(dec->FLACFrameHeader->sampleRateCode == 1)  dec->FLACMetadataBlock->sampleRate =  88200;
+            if(dec->FLACFrameHeader->sampleRateCode == 2)  dec->FLACMetadataBlock->sampleRate = 176400;
+            if(dec->FLACFrameHeader->sampleRateCode == 3)  dec->FLACMetadataBlock->sampleRate = 192000;
+            if(dec->FLACFrameHeader->sampleRateCode == 4)  dec->FLACMetadataBlock->sampleRate =   8000;
+            if(dec->FLACFrameHeader->sampleRateCode == 5)  dec->FLACMetadataBlock->sampleRate =  16000;
+            if(dec->FLACFrameHeader->sampleRateCode == 6)  dec->FLACMetadataBlock->sampleRate =  22050;
+            if(dec->FLACFrameHeader->sampleRateCode == 7)  dec->FLACMetadataBlock->sampleRate =  24000;
+            if(dec->FLACFrameHeader->sampleRateCode == 8)  dec->FLACMetadataBlock->sampleRate =  32000;
+            if(dec->FLACFrameHeader->sampleRateCode == 9)  dec->FLACMetadataBlock->sampleRate =  44100;
+            if(dec->FLACFrameHeader->sampleRateCode == 10) dec->FLACMetadataBlock->sampleRate =  48000;
+            if(dec->FLACFrameHeader->sampleRateCode == 11) dec->FLACMetadataBlock->sampleRate =  96000;
         }
 
-        readUint(1);
-        temp = (readUint(8) << 24);
+        readUint(dec, 1);
+        temp = (readUint(dec, 8) << 24);
         temp = ~temp;
 
         uint32_t shift = 0x80000000; // Number of leading zeros
@@ -282,147 +262,146 @@ int8_t FLACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf){
             else break;
         }
         count--;
-        for (int i = 0; i < count; i++) readUint(8);
-        m_blockSize = 0;
-
-        if (FLACFrameHeader->blockSizeCode == 1)
-            m_blockSize = 192;
-        else if (2 <= FLACFrameHeader->blockSizeCode && FLACFrameHeader->blockSizeCode <= 5)
-            m_blockSize = 576 << (FLACFrameHeader->blockSizeCode - 2);
-        else if (FLACFrameHeader->blockSizeCode == 6)
-            m_blockSize = readUint(8) + 1;
-        else if (FLACFrameHeader->blockSizeCode == 7)
-            m_blockSize = readUint(16) + 1;
-        else if (8 <= FLACFrameHeader->blockSizeCode && FLACFrameHeader->blockSizeCode <= 15)
-            m_blockSize = 256 << (FLACFrameHeader->blockSizeCode - 8);
+        for (int i = 0; i < count; i++) readUint(dec, 8);
+        dec->m_blockSize = 0;
+
+        if (dec->FLACFrameHeader->blockSizeCode == 1)
+            dec->m_blockSize = 192;
+        else if (2 <= dec->FLACFrameHeader->blockSizeCode && dec->FLACFrameHeader->blockSizeCode <= 5)
+            dec->m_blockSize = 576 << (dec->FLACFrameHeader->blockSizeCode - 2);
+        else if (dec->FLACFrameHeader->blockSizeCode == 6)
+            dec->m_blockSize = readUint(dec, 8) + 1;
+        else if (dec->FLACFrameHeader->blockSizeCode == 7)
+            dec->m_blockSize = readUint(dec, 16) + 1;
+        else if (8 <= dec->FLACFrameHeader->blockSizeCode && dec->FLACFrameHeader->blockSizeCode <= 15)
+            dec->m_blockSize = 256 << (dec->FLACFrameHeader->blockSizeCode - 8);
         else{
             return ERR_FLAC_RESERVED_BLOCKSIZE_UNSUPPORTED;
         }
 
-        if(m_blockSize > 8192){
+        if(dec->m_blockSize > 8192){
             log_e("Error: blockSize too big");
             return ERR_FLAC_BLOCKSIZE_TOO_BIG;
         }
 
-        if(FLACFrameHeader->sampleRateCode == 12)
-            readUint(8);
-        else if (FLACFrameHeader->sampleRateCode == 13 || FLACFrameHeader->sampleRateCode == 14){
-            readUint(16);
+        if(dec->FLACFrameHeader->sampleRateCode == 12)
+            readUint(dec, 8);
+        else if (dec->FLACFrameHeader->sampleRateCode == 13 || dec->FLACFrameHeader->sampleRateCode == 14){
+            readUint(dec, 16);
         }
-        readUint(8);
-        m_status = DECODE_SUBFRAMES;
-        *bytesLeft = m_bytesAvail;
-        m_blockSizeLeft = m_blockSize;
+        readUint(dec, 8);
+        dec->m_status = DECODE_SUBFRAMES;
+        *bytesLeft = dec->m_bytesAvail;
+        dec->m_blockSizeLeft = dec->m_blockSize;
 
         return ERR_FLAC_NONE;
     }
 
-    if(m_status == DECODE_SUBFRAMES){
+    if(dec->m_status == DECODE_SUBFRAMES){
 
         // Decode each channel's subframe, then skip footer
-        int ret = decodeSubframes();
+        int ret = decodeSubframes(dec);
         if(ret != 0) return ret;
-        m_status = OUT_SAMPLES;
+        dec->m_status = OUT_SAMPLES;
     }
 
-    if(m_status == OUT_SAMPLES){  // Write the decoded samples
+    if(dec->m_status == OUT_SAMPLES){  // Write the decoded samples
         // blocksize can be much greater than outbuff, so we can't stuff all in once
         // therefore we need often more than one loop (split outputblock into pieces)
         uint16_t blockSize;
-        static uint16_t offset = 0;
-        if(m_blockSize < outBuffSize + offset) blockSize = m_blockSize - offset;
+        if(dec->m_blockSize < outBuffSize + dec->m_offset) blockSize = dec->m_blockSize - dec->m_offset;
         else blockSize = outBuffSize;
 
 
         for (int i = 0; i < blockSize; i++) {
-            for (int j = 0; j < FLACMetadataBlock->numChannels; j++) {
-                int val = FLACsubFramesBuff->samplesBuffer[j][i + offset];
-                if (FLACMetadataBlock->bitsPerSample == 8) val += 128;
+            for (int j = 0; j < dec->FLACMetadataBlock->numChannels; j++) {
+                int val = dec->FLACsubFramesBuff->samplesBuffer[j][i + dec->m_offset];
+                if (dec->FLACMetadataBlock->bitsPerSample == 8) val += 128;
                 outbuf[2*i+j] = val;
             }
         }
 
-        m_validSamples = blockSize * FLACMetadataBlock->numChannels;
-        offset += blockSize;
+        dec->m_validSamples = blockSize * dec->FLACMetadataBlock->numChannels;
+        dec->m_offset += blockSize;
 
-        if(offset != m_blockSize) return GIVE_NEXT_LOOP;
-        offset = 0;
-        if(offset > m_blockSize) { log_e("offset has a wrong value"); }
+        if(dec->m_offset != dec->m_blockSize) return GIVE_NEXT_LOOP;
+        dec->m_offset = 0;
+        if(dec->m_offset > dec->m_blockSize) { log_e("m_offset has a wrong value"); }
     }
 
-    alignToByte();
-    readUint(16);
-    m_bytesDecoded = *bytesLeft - m_bytesAvail;
+    alignToByte(dec);
+    readUint(dec, 16);
+    dec->m_bytesDecoded = *bytesLeft - dec->m_bytesAvail;
 //    log_i("m_bytesDecoded %i", m_bytesDecoded);
 //    m_compressionRatio = (float)m_bytesDecoded / (float)m_blockSize * FLACMetadataBlock->numChannels * (16/8);
 //    log_i("m_compressionRatio % f", m_compressionRatio);
-    *bytesLeft = m_bytesAvail;
-    m_status = DECODE_FRAME;
+    *bytesLeft = dec->m_bytesAvail;
+    dec->m_status = DECODE_FRAME;
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint16_t FLACGetOutputSamps(){
-    int vs = m_validSamples;
-    m_validSamples=0;
+uint16_t FLACGetOutputSamps(FLACDecoder* dec){
+    int vs = dec->m_validSamples;
+    dec->m_validSamples=0;
     return vs;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint64_t FLACGetTotoalSamplesInStream(){
-    return FLACMetadataBlock->totalSamples;
+uint64_t FLACGetTotoalSamplesInStream(FLACDecoder* dec){
+    return dec->FLACMetadataBlock->totalSamples;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint8_t FLACGetBitsPerSample(){
-    return FLACMetadataBlock->bitsPerSample;
+uint8_t FLACGetBitsPerSample(FLACDecoder* dec){
+    return dec->FLACMetadataBlock->bitsPerSample;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint8_t FLACGetChannels(){
-    return FLACMetadataBlock->numChannels;
+uint8_t FLACGetChannels(FLACDecoder* dec){
+    return dec->FLACMetadataBlock->numChannels;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint32_t FLACGetSampRate(){
-    return FLACMetadataBlock->sampleRate;
+uint32_t FLACGetSampRate(FLACDecoder* dec){
+    return dec->FLACMetadataBlock->sampleRate;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint32_t FLACGetBitRate(){
-    if(FLACMetadataBlock->totalSamples){
-        float BitsPerSamp = (float)FLACMetadataBlock->audioDataLength / (float)FLACMetadataBlock->totalSamples * 8;
-        return ((uint32_t)BitsPerSamp * FLACMetadataBlock->sampleRate);
+uint32_t FLACGetBitRate(FLACDecoder* dec){
+    if(dec->FLACMetadataBlock->totalSamples){
+        float BitsPerSamp = (float)dec->FLACMetadataBlock->audioDataLength / (float)dec->FLACMetadataBlock->totalSamples * 8;
+        return ((uint32_t)BitsPerSamp * dec->FLACMetadataBlock->sampleRate);
     }
     return 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
-uint32_t FLACGetAudioFileDuration() {
-    if(FLACGetSampRate()){
-        uint32_t afd = FLACGetTotoalSamplesInStream()/ FLACGetSampRate(); // AudioFileDuration
+uint32_t FLACGetAudioFileDuration(FLACDecoder* dec) {
+    if(FLACGetSampRate(dec)){
+        uint32_t afd = FLACGetTotoalSamplesInStream(dec)/ FLACGetSampRate(dec); // AudioFileDuration
         return afd;
     }
     return 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t decodeSubframes(){
-    if(FLACFrameHeader->chanAsgn <= 7) {
-        for (int ch = 0; ch < FLACMetadataBlock->numChannels; ch++)
-            decodeSubframe(FLACMetadataBlock->bitsPerSample, ch);
-    }
-    else if (8 <= FLACFrameHeader->chanAsgn && FLACFrameHeader->chanAsgn <= 10) {
-        decodeSubframe(FLACMetadataBlock->bitsPerSample + (FLACFrameHeader->chanAsgn == 9 ? 1 : 0), 0);
-        decodeSubframe(FLACMetadataBlock->bitsPerSample + (FLACFrameHeader->chanAsgn == 9 ? 0 : 1), 1);
-        if(FLACFrameHeader->chanAsgn == 8) {
-            for (int i = 0; i < m_blockSize; i++)
-                FLACsubFramesBuff->samplesBuffer[1][i] = (
-                        FLACsubFramesBuff->samplesBuffer[0][i] -
-                        FLACsubFramesBuff->samplesBuffer[1][i]);
+int8_t decodeSubframes(FLACDecoder* dec){
+    if(dec->FLACFrameHeader->chanAsgn <= 7) {
+        for (int ch = 0; ch < dec->FLACMetadataBlock->numChannels; ch++)
+            decodeSubframe(dec, dec->FLACMetadataBlock->bitsPerSample, ch);
+    }
+    else if (8 <= dec->FLACFrameHeader->chanAsgn && dec->FLACFrameHeader->chanAsgn <= 10) {
+        decodeSubframe(dec, dec->FLACMetadataBlock->bitsPerSample + (dec->FLACFrameHeader->chanAsgn == 9 ? 1 : 0), 0);
+        decodeSubframe(dec, dec->FLACMetadataBlock->bitsPerSample + (dec->FLACFrameHeader->chanAsgn == 9 ? 0 : 1), 1);
+        if(dec->FLACFrameHeader->chanAsgn == 8) {
+            for (int i = 0; i < dec->m_blockSize; i++)
+                dec->FLACsubFramesBuff->samplesBuffer[1][i] = (
+                        dec->FLACsubFramesBuff->samplesBuffer[0][i] -
+                        dec->FLACsubFramesBuff->samplesBuffer[1][i]);
         }
-        else if (FLACFrameHeader->chanAsgn == 9) {
-            for (int i = 0; i < m_blockSize; i++)
-                FLACsubFramesBuff->samplesBuffer[0][i] += FLACsubFramesBuff->samplesBuffer[1][i];
+        else if (dec->FLACFrameHeader->chanAsgn == 9) {
+            for (int i = 0; i < dec->m_blockSize; i++)
+                dec->FLACsubFramesBuff->samplesBuffer[0][i] += dec->FLACsubFramesBuff->samplesBuffer[1][i];
         }
-        else if (FLACFrameHeader->chanAsgn == 10) {
-            for (int i = 0; i < m_blockSize; i++) {
-                long side =  FLACsubFramesBuff->samplesBuffer[1][i];
-                long right = FLACsubFramesBuff->samplesBuffer[0][i] - (side >> 1);
-                FLACsubFramesBuff->samplesBuffer[1][i] = right;
-                FLACsubFramesBuff->samplesBuffer[0][i] = right + side;
+        else if (dec->FLACFrameHeader->chanAsgn == 10) {
+            for (int i = 0; i < dec->m_blockSize; i++) {
+                long side =  dec->FLACsubFramesBuff->samplesBuffer[1][i];
+                long right = dec->FLACsubFramesBuff->samplesBuffer[0][i] - (side >> 1);
+                dec->FLACsubFramesBuff->samplesBuffer[1][i] = right;
+                dec->FLACsubFramesBuff->samplesBuffer[0][i] = right + side;
             }
         }
         else {
@@ -437,119 +416,118 @@ int8_t decodeSubframes(){
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t decodeSubframe(uint8_t sampleDepth, uint8_t ch) {
+int8_t decodeSubframe(FLACDecoder* dec, uint8_t sampleDepth, uint8_t ch) {
     int8_t ret = 0;
-    readUint(1);
-    uint8_t type = readUint(6);
-    int shift = readUint(1);
+    readUint(dec, 1);
+    uint8_t type = readUint(dec, 6);
+    int shift = readUint(dec, 1);
     if (shift == 1) {
-        while (readUint(1) == 0)
+        while (readUint(dec, 1) == 0)
             shift++;
     }
     sampleDepth -= shift;
 
     if(type == 0){  // Constant coding
-        int16_t s= readSignedInt(sampleDepth);
-        for(int i=0; i < m_blockSize; i++){
-            FLACsubFramesBuff->samplesBuffer[ch][i] = s;
+        int16_t s= readSignedInt(dec, sampleDepth);
+        for(int i=0; i < dec->m_blockSize; i++){
+            dec->FLACsubFramesBuff->samplesBuffer[ch][i] = s;
         }
     }
     else if (type == 1) {  // Verbatim coding
-        for (int i = 0; i < m_blockSize; i++)
-            FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(sampleDepth);
+        for (int i = 0; i < dec->m_blockSize; i++)
+            dec->FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(dec, sampleDepth);
     }
     else if (8 <= type && type <= 12){
-        ret = decodeFixedPredictionSubframe(type - 8, sampleDepth, ch);
+        ret = decodeFixedPredictionSubframe(dec, type - 8, sampleDepth, ch);
         if(ret) return ret;
     }
     else if (32 <= type && type <= 63){
-        ret = decodeLinearPredictiveCodingSubframe(type - 31, sampleDepth, ch);
+        ret = decodeLinearPredictiveCodingSubframe(dec, type - 31, sampleDepth, ch);
         if(ret) return ret;
     }
     else{
         return ERR_FLAC_RESERVED_SUB_TYPE;
     }
     if(shift>0){
-        for (int i = 0; i < m_blockSize; i++){
-            FLACsubFramesBuff->samplesBuffer[ch][i] <<= shift;
+        for (int i = 0; i < dec->m_blockSize; i++){
+            dec->FLACsubFramesBuff->samplesBuffer[ch][i] <<= shift;
         }
     }
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t decodeFixedPredictionSubframe(uint8_t predOrder, uint8_t sampleDepth, uint8_t ch) {
+int8_t decodeFixedPredictionSubframe(FLACDecoder* dec, uint8_t predOrder, uint8_t sampleDepth, uint8_t ch) {
     uint8_t ret = 0;
     for(uint8_t i = 0; i < predOrder; i++)
-        FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(sampleDepth);
-    ret = decodeResiduals(predOrder, ch);
+        dec->FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(dec, sampleDepth);
+    ret = decodeResiduals(dec, predOrder, ch);
     if(ret) return ret;
-    coefs.clear();
-    if(predOrder == 0) coefs.resize(0);
-    if(predOrder == 1) coefs.push_back(1);  // FIXED_PREDICTION_COEFFICIENTS
-    if(predOrder == 2){coefs.push_back(2); coefs.push_back(-1);}
-    if(predOrder == 3){coefs.push_back(3); coefs.push_back(-3); coefs.push_back(1);}
-    if(predOrder == 4){coefs.push_back(4); coefs.push_back(-6); coefs.push_back(4); coefs.push_back(-1);}
     if(predOrder > 4) return ERR_FLAC_PREORDER_TOO_BIG; // Error: preorder > 4"
-    restoreLinearPrediction(ch, 0);
+    dec->m_numCoefs = predOrder;
+    if(predOrder == 1){dec->m_coefs[0] = 1;}  // FIXED_PREDICTION_COEFFICIENTS
+    if(predOrder == 2){dec->m_coefs[0] = 2; dec->m_coefs[1] = -1;}
+    if(predOrder == 3){dec->m_coefs[0] = 3; dec->m_coefs[1] = -3; dec->m_coefs[2] = 1;}
+    if(predOrder == 4){dec->m_coefs[0] = 4; dec->m_coefs[1] = -6; dec->m_coefs[2] = 4; dec->m_coefs[3] = -1;}
+    restoreLinearPrediction(dec, ch, 0);
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t decodeLinearPredictiveCodingSubframe(int lpcOrder, int sampleDepth, uint8_t ch){
+int8_t decodeLinearPredictiveCodingSubframe(FLACDecoder* dec, int lpcOrder, int sampleDepth, uint8_t ch){
     int8_t ret = 0;
     for (int i = 0; i < lpcOrder; i++)
-        FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(sampleDepth);
-    int precision = readUint(4) + 1;
-    int shift = readSignedInt(5);
-    coefs.resize(0);
+        dec->FLACsubFramesBuff->samplesBuffer[ch][i] = readSignedInt(dec, sampleDepth);
+    int precision = readUint(dec, 4) + 1;
+    int shift = readSignedInt(dec, 5);
     for (uint8_t i = 0; i < lpcOrder; i++)
-        coefs.push_back(readSignedInt(precision));
-    ret = decodeResiduals(lpcOrder, ch);
+        dec->m_coefs[i] = readSignedInt(dec, precision);
+    dec->m_numCoefs = lpcOrder;
+    ret = decodeResiduals(dec, lpcOrder, ch);
     if(ret) return ret;
-    restoreLinearPrediction(ch, shift);
+    restoreLinearPrediction(dec, ch, shift);
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int8_t decodeResiduals(uint8_t warmup, uint8_t ch) {
+int8_t decodeResiduals(FLACDecoder* dec, uint8_t warmup, uint8_t ch) {
 
-    int method = readUint(2);
+    int method = readUint(dec, 2);
     if (method >= 2)
         return ERR_FLAC_RESERVED_RESIDUAL_CODING; // Reserved residual coding method
     uint8_t paramBits = method == 0 ? 4 : 5;
     int escapeParam = (method == 0 ? 0xF : 0x1F);
-    int partitionOrder = readUint(4);
+    int partitionOrder = readUint(dec, 4);
 
     int numPartitions = 1 << partitionOrder;
-    if (m_blockSize % numPartitions != 0)
+    if (dec->m_blockSize % numPartitions != 0)
         return ERR_FLAC_WRONG_RICE_PARTITION_NR; //Error: Block size not divisible by number of Rice partitions
-    int partitionSize = m_blockSize/ numPartitions;
+    int partitionSize = dec->m_blockSize/ numPartitions;
 
     for (int i = 0; i < numPartitions; i++) {
         int start = i * partitionSize + (i == 0 ? warmup : 0);
         int end = (i + 1) * partitionSize;
 
-        int param = readUint(paramBits);
+        int param = readUint(dec, paramBits);
         if (param < escapeParam) {
             for (int j = start; j < end; j++){
-                FLACsubFramesBuff->samplesBuffer[ch][j] = readRiceSignedInt(param);
+                dec->FLACsubFramesBuff->samplesBuffer[ch][j] = readRiceSignedInt(dec, param);
             }
         } else {
-            int numBits = readUint(5);
+            int numBits = readUint(dec, 5);
             for (int j = start; j < end; j++){
-                FLACsubFramesBuff->samplesBuffer[ch][j] = readSignedInt(numBits);
+                dec->FLACsubFramesBuff->samplesBuffer[ch][j] = readSignedInt(dec, numBits);
             }
         }
     }
     return ERR_FLAC_NONE;
 }
 //----------------------------------------------------------------------------------------------------------------------
-void restoreLinearPrediction(uint8_t ch, uint8_t shift) {
+void restoreLinearPrediction(FLACDecoder* dec, uint8_t ch, uint8_t shift) {
 
-    for (int i = coefs.size(); i < m_blockSize; i++) {
+    for (int i = dec->m_numCoefs; i < dec->m_blockSize; i++) {
         int32_t sum = 0;
-        for (int j = 0; j < coefs.size(); j++){
-            sum += FLACsubFramesBuff->samplesBuffer[ch][i - 1 - j] * coefs[j];
+        for (int j = 0; j < dec->m_numCoefs; j++){
+            sum += dec->FLACsubFramesBuff->samplesBuffer[ch][i - 1 - j] * dec->m_coefs[j];
         }
-        FLACsubFramesBuff->samplesBuffer[ch][i] += (sum >> shift);
+        dec->FLACsubFramesBuff->samplesBuffer[ch][i] += (sum >> shift);
     }
 }
 //----------------------------------------------------------------------------------------------------------------------
@@ -20,6 +20,7 @@
 
 #define MAX_CHANNELS 2
 #define MAX_BLOCKSIZE 8192
+#define FLAC_MAX_OGG_PACKET (4096 * 4 + 1024)   // one frame in Ogg, 4096 stereo samples verbatim and the headers
 #define APLL_DISABLE 0
 #define EXTERNAL_I2S  0
 
@@ -42,7 +43,8 @@ enum : int8_t  {GIVE_NEXT_LOOP = +1,
                 ERR_FLAC_RESERVED_RESIDUAL_CODING = -8,
                 ERR_FLAC_WRONG_RICE_PARTITION_NR = -9,
                 ERR_FLAC_BITS_PER_SAMPLE_TOO_BIG = -10,
-                ERR_FLAG_BITS_PER_SAMPLE_UNKNOWN = 11};
+                ERR_FLAG_BITS_PER_SAMPLE_UNKNOWN = 11,
+                ERR_FLAC_OGG_HEADER = -12};
 
 typedef struct FLACMetadataBlock_t{
                               // METADATA_BLOCK_STREAMINFO
@@ -145,15 +147,58 @@ typedef struct FLACFrameHeader_t {
 
 }FLACFrameHeader_t;
 
+/* decoder context, one per stream - the former file-scope state, so that several
+ * independent instances can be used at the same time
+ */
+typedef struct FLACDecoder {
+    FLACFrameHeader_t   *FLACFrameHeader;
+    FLACMetadataBlock_t *FLACMetadataBlock;
+    FLACsubFramesBuff_t *FLACsubFramesBuff;
+    uint16_t m_blockSize;
+    uint16_t m_blockSizeLeft;
+    uint16_t m_validSamples;
+    uint8_t  m_status;
+    uint8_t* m_inptr;
+    int16_t  m_bytesAvail;
+    int16_t  m_bytesDecoded;
+    float    m_compressionRatio;
+    uint16_t m_rIndex;
+    uint64_t m_bitBuffer;
+    uint8_t  m_bitBufferLen;
+    uint16_t m_offset;        // position in samplesBuffer while a block is written out in pieces
+    int32_t  m_coefs[32];     // max LPC order
+    uint8_t  m_numCoefs;
+} FLACDecoder;
+
+FLACDecoder* FLACCreate();
+void     FLACDestroy(FLACDecoder* dec);
+int      FLACFindSyncWord(FLACDecoder* dec, unsigned char *buf, int nBytes);
+int      FLACparseOggHead(FLACDecoder* dec, unsigned char *buf, int len);
+bool     FLACDecoder_AllocateBuffers(FLACDecoder* dec);
+void     FLACDecoder_ClearBuffer(FLACDecoder* dec);
+void     FLACDecoder_FreeBuffers(FLACDecoder* dec);
+void     FLACSetRawBlockParams(FLACDecoder* dec, uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength);
+void     FLACDecoderReset(FLACDecoder* dec);
+int8_t   FLACDecode(FLACDecoder* dec, uint8_t *inbuf, int *bytesLeft, short *outbuf);
+int8_t   FLACDecodeOggPacket(FLACDecoder* dec, uint8_t *inbuf, int *bytesLeft, short *outbuf);
+uint16_t FLACGetOutputSamps(FLACDecoder* dec);
+uint64_t FLACGetTotoalSamplesInStream(FLACDecoder* dec);
+uint8_t  FLACGetBitsPerSample(FLACDecoder* dec);
+uint8_t  FLACGetChannels(FLACDecoder* dec);
+uint32_t FLACGetSampRate(FLACDecoder* dec);
+uint32_t FLACGetBitRate(FLACDecoder* dec);
+uint32_t FLACGetAudioFileDuration(FLACDecoder* dec);
+// compatibility, single default instance
 int      FLACFindSyncWord(unsigned char *buf, int nBytes);
-int      FLACFindOggSyncWord(unsigned char *buf, int nBytes);
-int      FLACparseOggHeader(unsigned char *buf);
+int      FLACparseOggHead(unsigned char *buf, int len);
 bool     FLACDecoder_AllocateBuffers(void);
 void     FLACDecoder_ClearBuffer();
 void     FLACDecoder_FreeBuffers();
+FLACDecoder* FLACDecoder_Detach();  // hands the default instance over (FLACDestroy() by the caller)
 void     FLACSetRawBlockParams(uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength);
 void     FLACDecoderReset();
 int8_t   FLACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
+int8_t   FLACDecodeOggPacket(uint8_t *inbuf, int *bytesLeft, short *outbuf);
 uint16_t FLACGetOutputSamps();
 uint64_t FLACGetTotoalSamplesInStream();
 uint8_t  FLACGetBitsPerSample();
@@ -161,15 +206,15 @@ uint8_t  FLACGetChannels();
 uint32_t FLACGetSampRate();
 uint32_t FLACGetBitRate();
 uint32_t FLACGetAudioFileDuration();
-uint32_t readUint(uint8_t nBits);
-int32_t  readSignedInt(int nBits);
-int64_t  readRiceSignedInt(uint8_t param);
-void     alignToByte();
-int8_t   decodeSubframes();
-int8_t   decodeSubframe(uint8_t sampleDepth, uint8_t ch);
-int8_t   decodeFixedPredictionSubframe(uint8_t predOrder, uint8_t sampleDepth, uint8_t ch);
-int8_t   decodeLinearPredictiveCodingSubframe(int lpcOrder, int sampleDepth, uint8_t ch);
-int8_t   decodeResiduals(uint8_t warmup, uint8_t ch);
-void     restoreLinearPrediction(uint8_t ch, uint8_t shift);
+uint32_t readUint(FLACDecoder* dec, uint8_t nBits);
+int32_t  readSignedInt(FLACDecoder* dec, int nBits);
+int64_t  readRiceSignedInt(FLACDecoder* dec, uint8_t param);
+void     alignToByte(FLACDecoder* dec);
+int8_t   decodeSubframes(FLACDecoder* dec);
+int8_t   decodeSubframe(FLACDecoder* dec, uint8_t sampleDepth, uint8_t ch);
+int8_t   decodeFixedPredictionSubframe(FLACDecoder* dec, uint8_t predOrder, uint8_t sampleDepth, uint8_t ch);
+int8_t   decodeLinearPredictiveCodingSubframe(FLACDecoder* dec, int lpcOrder, int sampleDepth, uint8_t ch);
+int8_t   decodeResiduals(FLACDecoder* dec, uint8_t warmup, uint8_t ch);
+void     restoreLinearPrediction(FLACDecoder* dec, uint8_t ch, uint8_t shift);
 
 
@@ -197,6 +197,27 @@ typedef struct MP3DecInfo {
     int part23Length[m_MAX_NGRAN][m_MAX_NCHAN];
 } MP3DecInfo_t;
 
+/* decoder context, one per stream - all former file-scope state lives here, so several
+ * instances can decode independently (e.g. crossfade or a prefetching second stream)
+ */
+typedef struct MP3Decoder {
+    MP3FrameInfo_t *m_MP3FrameInfo;
+    SFBandTable_t m_SFBandTable;
+    StereoMode_t m_sMode;  /* mono/stereo mode */
+    MPEGVersion_t m_MPEGVersion;  /* version ID */
+    FrameHeader_t *m_FrameHeader;
+    SideInfoSub_t m_SideInfoSub[m_MAX_NGRAN][m_MAX_NCHAN];
+    SideInfo_t *m_SideInfo;
+    CriticalBandInfo_t m_CriticalBandInfo[m_MAX_NCHAN];  /* filled in dequantizer, used in joint stereo reconstruction */
+    DequantInfo_t *m_DequantInfo;
+    HuffmanInfo_t *m_HuffmanInfo;
+    IMDCTInfo_t *m_IMDCTInfo;
+    ScaleFactorInfoSub_t m_ScaleFactorInfoSub[m_MAX_NGRAN][m_MAX_NCHAN];
+    ScaleFactorJS_t *m_ScaleFactorJS;
+    SubbandInfo_t *m_SubbandInfo;
+    MP3DecInfo_t *m_MP3DecInfo;
+} MP3Decoder;
+
 
 
 
@@ -455,45 +476,61 @@ const uint32_t csa[8][2] PROGMEM = {
  */
 
 // prototypes
+MP3Decoder* MP3Create();
+void MP3Destroy(MP3Decoder* dec);
+bool MP3Decoder_AllocateBuffers(MP3Decoder* dec);
+void MP3Decoder_FreeBuffers(MP3Decoder* dec);
+int  MP3Decode(MP3Decoder* dec, unsigned char *inbuf, int *bytesLeft, short *outbuf, int useSize);
+void MP3GetLastFrameInfo(MP3Decoder* dec);
+int  MP3GetNextFrameInfo(MP3Decoder* dec, unsigned char *buf);
+int  MP3FindSyncWord(unsigned char *buf, int nBytes);
+int  MP3GetSampRate(MP3Decoder* dec);
+int  MP3GetChannels(MP3Decoder* dec);
+int  MP3GetBitsPerSample(MP3Decoder* dec);
+int  MP3GetBitrate(MP3Decoder* dec);
+int  MP3GetOutputSamps(MP3Decoder* dec);
+
+// compatibility, single default instance
 bool MP3Decoder_AllocateBuffers(void);
 void MP3Decoder_FreeBuffers();
-int  MP3Decode( unsigned char *inbuf, int *bytesLeft, short *outbuf, int useSize);
+MP3Decoder* MP3Decoder_Detach(); // hands the default instance over (MP3Destroy() by the caller)
+int  MP3Decode(unsigned char *inbuf, int *bytesLeft, short *outbuf, int useSize);
 void MP3GetLastFrameInfo();
 int  MP3GetNextFrameInfo(unsigned char *buf);
-int  MP3FindSyncWord(unsigned char *buf, int nBytes);
 int  MP3GetSampRate();
 int  MP3GetChannels();
 int  MP3GetBitsPerSample();
 int  MP3GetBitrate();
 int  MP3GetOutputSamps();
+void MP3Decoder_ClearBuffer(void);
 
 //internally used
-void MP3Decoder_ClearBuffer(void);
+void MP3Decoder_ClearBuffer(MP3Decoder* dec);
 void PolyphaseMono(short *pcm, int *vbuf, const uint32_t *coefBase);
 void PolyphaseStereo(short *pcm, int *vbuf, const uint32_t *coefBase);
 void SetBitstreamPointer(BitStreamInfo_t *bsi, int nBytes, unsigned char *buf);
 unsigned int GetBits(BitStreamInfo_t *bsi, int nBits);
 int CalcBitsUsed(BitStreamInfo_t *bsi, unsigned char *startBuf, int startOffset);
-int DequantChannel(int *sampleBuf, int *workBuf, int *nonZeroBound, SideInfoSub_t *sis, ScaleFactorInfoSub_t *sfis, CriticalBandInfo_t *cbi);
+int DequantChannel(MP3Decoder* dec, int *sampleBuf, int *workBuf, int *nonZeroBound, SideInfoSub_t *sis, ScaleFactorInfoSub_t *sfis, CriticalBandInfo_t *cbi);
 void MidSideProc(int x[m_MAX_NCHAN][m_MAX_NSAMP], int nSamps, int mOut[2]);
-void IntensityProcMPEG1(int x[m_MAX_NCHAN][m_MAX_NSAMP], int nSamps, ScaleFactorInfoSub_t *sfis,	CriticalBandInfo_t *cbi, int midSideFlag, int mixFlag, int mOut[2]);
-void IntensityProcMPEG2(int x[m_MAX_NCHAN][m_MAX_NSAMP], int nSamps, ScaleFactorInfoSub_t *sfis, CriticalBandInfo_t *cbi, ScaleFactorJS_t *sfjs, int midSideFlag, int mixFlag, int mOut[2]);
+void IntensityProcMPEG1(MP3Decoder* dec, int x[m_MAX_NCHAN][m_MAX_NSAMP], int nSamps, ScaleFactorInfoSub_t *sfis,	CriticalBandInfo_t *cbi, int midSideFlag, int mixFlag, int mOut[2]);
+void IntensityProcMPEG2(MP3Decoder* dec, int x[m_MAX_NCHAN][m_MAX_NSAMP], int nSamps, ScaleFactorInfoSub_t *sfis, CriticalBandInfo_t *cbi, ScaleFactorJS_t *sfjs, int midSideFlag, int mixFlag, int mOut[2]);
 void FDCT32(int *x, int *d, int offset, int oddBlock, int gb);// __attribute__ ((section (".data")));
 void FreeBuffers();
-int CheckPadBit();
-int UnpackFrameHeader(unsigned char *buf);
-int UnpackSideInfo(unsigned char *buf);
-int DecodeHuffman( unsigned char *buf, int *bitOffset, int huffBlockBits, int gr, int ch);
-int MP3Dequantize( int gr);
-int IMDCT( int gr, int ch);
-int UnpackScaleFactors( unsigned char *buf, int *bitOffset, int bitsAvail, int gr, int ch);
-int Subband(short *pcmBuf);
+int CheckPadBit(MP3Decoder* dec);
+int UnpackFrameHeader(MP3Decoder* dec, unsigned char *buf);
+int UnpackSideInfo(MP3Decoder* dec, unsigned char *buf);
+int DecodeHuffman(MP3Decoder* dec, unsigned char *buf, int *bitOffset, int huffBlockBits, int gr, int ch);
+int MP3Dequantize(MP3Decoder* dec, int gr);
+int IMDCT(MP3Decoder* dec, int gr, int ch);
+int UnpackScaleFactors(MP3Decoder* dec, unsigned char *buf, int *bitOffset, int bitsAvail, int gr, int ch);
+int Subband(MP3Decoder* dec, short *pcmBuf);
 short ClipToShort(int x, int fracBits);
 void RefillBitstreamCache(BitStreamInfo_t *bsi);
 void UnpackSFMPEG1(BitStreamInfo_t *bsi, SideInfoSub_t *sis, ScaleFactorInfoSub_t *sfis, int *scfsi, int gr, ScaleFactorInfoSub_t *sfisGr0);
 void UnpackSFMPEG2(BitStreamInfo_t *bsi, SideInfoSub_t *sis, ScaleFactorInfoSub_t *sfis, int gr, int ch, int modeExt, ScaleFactorJS_t *sfjs);
 int MP3FindFreeSync(unsigned char *buf, unsigned char firstFH[4], int nBytes);
-void MP3ClearBadFrame( short *outbuf);
+void MP3ClearBadFrame(MP3Decoder* dec, short *outbuf);
 int DecodeHuffmanPairs(int *xy, int nVals, int tabIdx, int bitsLeft, unsigned char *buf, int bitOffset);
 int DecodeHuffmanQuads(int *vwxy, int nVals, int tabIdx, int bitsLeft, unsigned char *buf, int bitOffset);
 int DequantBlock(int *inbuf, int *outbuf, int num, int scale);
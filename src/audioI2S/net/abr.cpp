@@ -0,0 +1,59 @@
+/*
+ * abr.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Variant selection for HLS master playlists, see abr.h
+ */
+#include "abr.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+void ABR_Reset(abr_t* abr){
+    memset(abr, 0, sizeof(abr_t));
+    abr->lastSeq = -1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ABR_Sample(abr_t* abr, uint32_t bytes, uint32_t ms, bool limited){
+    if(ms < ABR_MIN_MS) {ms = ABR_MIN_MS; limited = true;}         // already buffered in the socket, no measure
+    uint32_t s = (uint32_t)(((uint64_t)bytes * 8000) / ms);
+    abr->sample = s;
+    abr->samples++;
+    if(abr->hold < UINT16_MAX) abr->hold++;
+    if(!abr->estimate) {abr->estimate = s; return;}
+    if(s < abr->estimate){
+        if(!limited) abr->estimate = s;
+    }
+    else{
+        abr->estimate += (s - abr->estimate) / 4;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+int ABR_Select(abr_t* abr, const uint32_t* bandwidth, int count, int current){
+    if(!abr->estimate || count < 2 || current < 0 || current >= count) return current;
+    uint32_t budget = (uint32_t)(((uint64_t)abr->estimate * ABR_MARGIN) / 100);
+    int best = -1, lowest = 0;
+    for(int i = 0; i < count; i++){
+        if(bandwidth[i] < bandwidth[lowest]) lowest = i;
+        if(bandwidth[i] <= budget && (best < 0 || bandwidth[i] > bandwidth[best])) best = i;
+    }
+    if(best < 0) best = lowest;
+    if(bandwidth[best] == bandwidth[current]) return current;
+    if(bandwidth[best] > bandwidth[current] && abr->hold < ABR_HOLD_SEGMENTS) return current;
+    abr->hold = 0;
+    abr->switched = true;
+    return best;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ABR_Requested(abr_t* abr, int64_t seq){
+    if(seq >= 0) abr->lastSeq = seq;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool ABR_Queue(abr_t* abr, int64_t seq){
+    // only the first playlist after a switch, a restarted sequence of the same variant is not dropped
+    return !(abr->switched && seq >= 0 && abr->lastSeq >= 0 && seq <= abr->lastSeq);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ABR_PlaylistDone(abr_t* abr){
+    abr->switched = false;
+}
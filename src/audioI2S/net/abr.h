@@ -0,0 +1,41 @@
+/*
+ * abr.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Variant selection for HLS master playlists (adaptive bitrate), works on the BANDWIDTH of the variants.
+ *
+ *  sample:    one per segment, body bytes over the time from the end of the response header to the last byte.
+ *             A segment that was slowed down by a full input buffer or came in under ABR_MIN_MS only tells
+ *             "at least this fast", it can raise the estimate but not lower it.
+ *  estimate:  a lower sample is taken at once, a higher one with a weight of 1/4 (fast down, slow up)
+ *  select:    the highest variant with BANDWIDTH <= ABR_MARGIN % of the estimate, the lowest one if none fits.
+ *             Up only after ABR_HOLD_SEGMENTS segments on the current variant, down at once.
+ *  sequence:  the media sequence number of the last requested segment is kept (ABR_Requested()). After a switch
+ *             the first playlist of the new variant continues behind it, ABR_Queue() drops what was requested
+ *             already; segments that were queued but not requested are taken from the new variant.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ABR_MARGIN          75          // % of the measured throughput a variant may use
+#define ABR_HOLD_SEGMENTS   3
+#define ABR_MIN_MS          50
+
+typedef struct {
+    uint32_t  estimate;             // bit/s, 0: no sample yet
+    uint32_t  sample;               // bit/s, last segment
+    uint32_t  samples;
+    uint16_t  hold;                 // segments since the last switch
+    int64_t   lastSeq;              // media sequence number of the last requested segment, -1: unknown
+    bool      switched;             // other variant, its first playlist continues behind lastSeq
+} abr_t;
+
+void     ABR_Reset(abr_t* abr);
+void     ABR_Sample(abr_t* abr, uint32_t bytes, uint32_t ms, bool limited);      // a segment is complete
+int      ABR_Select(abr_t* abr, const uint32_t* bandwidth, int count, int current); // index of the variant
+void     ABR_Requested(abr_t* abr, int64_t seq);                                 // a segment is requested, -1: unknown
+bool     ABR_Queue(abr_t* abr, int64_t seq);            // playlist entry, false: requested from the variant before
+void     ABR_PlaylistDone(abr_t* abr);                                           // a media playlist is parsed
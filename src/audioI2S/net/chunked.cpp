@@ -0,0 +1,58 @@
+/*
+ * chunked.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Chunked transfer decoder, see chunked.h
+ */
+#include "chunked.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+static void ck_line(chunked_t* ck){                             // end of a size line
+    if(!ck->digits) return;                                     // CRLF after the payload of a chunk
+    ck->digits = false;
+    if(!ck->size){
+        ck->state = CK_DONE;
+        return;
+    }
+    if(!ck->chunks) ck->first = ck->size;
+    ck->chunks++;
+    ck->count = ck->size;
+    ck->size = 0;
+    ck->state = CK_DATA;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void CK_Reset(chunked_t* ck){
+    memset(ck, 0, sizeof(chunked_t));
+    ck->state = CK_SIZE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t CK_Decode(chunked_t* ck, uint8_t* buf, uint32_t len){
+    uint8_t* in  = buf;
+    uint8_t* out = buf;
+    uint8_t* end = buf + len;
+    while(in < end && ck->state != CK_DONE){
+        if(ck->state == CK_DATA){                               // payload, moved down over the framing
+            uint32_t n = end - in;
+            if(n > ck->count) n = ck->count;
+            if(out != in) memmove(out, in, n);
+            out += n; in += n;
+            ck->count -= n;
+            if(!ck->count) ck->state = CK_SIZE;
+            continue;
+        }
+        uint8_t b = *in++;
+        if(b == '\n'){ ck_line(ck); if(ck->state == CK_EXTENSION) ck->state = CK_SIZE; continue;}
+        if(ck->state == CK_EXTENSION) continue;
+        if(b == ';'){ ck->state = CK_EXTENSION; continue;}
+        int v = -1;
+        if(b >= '0' && b <= '9') v = b - '0';
+        else if(b >= 'a' && b <= 'f') v = b - 'a' + 10;
+        else if(b >= 'A' && b <= 'F') v = b - 'A' + 10;
+        if(v < 0) continue;                                     // CR, blanks
+        ck->size = (ck->size << 4) + v;
+        ck->digits = true;
+    }
+    return out - buf;
+}
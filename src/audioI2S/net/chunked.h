@@ -0,0 +1,31 @@
+/*
+ * chunked.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Decoder for "Transfer-Encoding: chunked" web streams, works on the blocks read into the input buffer.
+ *  CK_Decode() removes the chunk framing in place and returns the payload bytes. The result can be passed on to
+ *  ICY_Demux() (net/icy.h), chunks and ICY blocks are independent of each other.
+ *
+ *  framing:   hex size [;extension] CRLF, size bytes of payload, CRLF, ... , 0 CRLF [trailer] CRLF
+ *             the state is kept over the calls, a boundary can be anywhere in a size line or the CRLF
+ *  end:       the last chunk (size 0) sets done, everything after it is dropped
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+enum : uint8_t { CK_SIZE = 0, CK_EXTENSION = 1, CK_DATA = 2, CK_DONE = 3 };
+
+typedef struct {
+    uint8_t   state;
+    bool      digits;               // size line: a hex digit has been seen
+    uint32_t  size;                 // size line: value so far
+    uint32_t  count;                // payload bytes left in the chunk
+    uint32_t  chunks;               // chunks started
+    uint32_t  first;                // size of the first chunk (tts has one chunk only)
+} chunked_t;
+
+void     CK_Reset(chunked_t* ck);
+uint32_t CK_Decode(chunked_t* ck, uint8_t* buf, uint32_t len);  // bytes read -> payload bytes at buf
@@ -0,0 +1,63 @@
+/*
+ * icy.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  ICY metadata demultiplexer, see icy.h
+ */
+#include "icy.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+static void icy_block(icyDemux_t* d){
+    if(!d->metalen || d->metalen > ICY_META_MAX) return;
+    d->meta[d->metalen] = '\0';                                 // the block is padded with '\0'
+    if(!d->meta[0]) return;
+    uint32_t hash = 2166136261u;                                // FNV-1a
+    for(const char* p = d->meta; *p; p++) hash = (hash ^ (uint8_t)*p) * 16777619u;
+    if(hash == d->hash) return;
+    d->hash = hash;
+    if(d->onMeta) d->onMeta(d->arg, d->meta);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ICY_Reset(icyDemux_t* d, uint32_t metaint, icyEvent_t onMeta, void* arg){
+    memset(d, 0, sizeof(icyDemux_t));
+    d->metaint = metaint;
+    d->count   = metaint;
+    d->metalen = ICY_NO_LENGTH;
+    d->onMeta  = onMeta;
+    d->arg     = arg;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t ICY_Demux(icyDemux_t* d, uint8_t* buf, uint32_t len){
+    if(!d->metaint) return len;
+    uint8_t* in  = buf;
+    uint8_t* out = buf;
+    uint8_t* end = buf + len;
+    while(in < end){
+        uint32_t n = end - in;
+        if(d->count){                                           // audio, moved down over the removed blocks
+            if(n > d->count) n = d->count;
+            if(out != in) memmove(out, in, n);
+            out += n; in += n;
+            d->count -= n;
+            continue;
+        }
+        if(d->metalen == ICY_NO_LENGTH){
+            d->metalen = *in++ * 16;
+            d->pos = 0;
+        }
+        else{
+            if(n > (uint32_t)(d->metalen - d->pos)) n = d->metalen - d->pos;
+            if(d->pos < ICY_META_MAX) memcpy(d->meta + d->pos, in, d->pos + n > ICY_META_MAX ? ICY_META_MAX - d->pos : n);
+            in += n;
+            d->pos += n;
+        }
+        if(d->pos == d->metalen){
+            icy_block(d);
+            d->metalen = ICY_NO_LENGTH;
+            d->count = d->metaint;
+        }
+    }
+    return out - buf;
+}
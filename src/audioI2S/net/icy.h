@@ -0,0 +1,36 @@
+/*
+ * icy.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  ICY metadata demultiplexer for shoutcast/icecast streams (icy-metaint). The stream is read in large blocks
+ *  straight into the input buffer, ICY_Demux() strips the interleaved metadata in place and returns the audio bytes.
+ *
+ *  stream:    metaint audio bytes, a length byte (x16), the metadata block, metaint audio bytes, ...
+ *             the countdown and a partly received block are kept over the calls, a boundary can be anywhere
+ *  event:     onMeta is called for a complete block with a text that differs from the previous one (title change),
+ *             empty blocks and blocks longer than ICY_META_MAX are removed without an event
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ICY_META_MAX        512         // longest metadata block that is reported, the format allows 4080
+#define ICY_NO_LENGTH       0xFFFF      // metalen: the length byte is the next one
+
+typedef void (*icyEvent_t)(void* arg, const char* meta);
+
+typedef struct {
+    uint32_t   metaint;             // audio bytes between the blocks, 0: stream without metadata
+    uint32_t   count;               // audio bytes until the next block
+    uint16_t   metalen;             // length of the current block or ICY_NO_LENGTH
+    uint16_t   pos;                 // bytes of the current block received
+    uint32_t   hash;                // of the last reported text
+    icyEvent_t onMeta;
+    void*      arg;
+    char       meta[ICY_META_MAX + 1];
+} icyDemux_t;
+
+void     ICY_Reset(icyDemux_t* d, uint32_t metaint, icyEvent_t onMeta, void* arg); // new stream or segment
+uint32_t ICY_Demux(icyDemux_t* d, uint8_t* buf, uint32_t len); // bytes read -> audio bytes at buf
@@ -0,0 +1,123 @@
+/*
+ * jitter.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Adaptive jitter buffer controller, see jitter.h
+ */
+#include "jitter.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t jb_ms(uint32_t bytes, uint32_t byteRate){
+    return (uint32_t)(((uint64_t)bytes * 1000) / byteRate);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t jb_bytes(uint32_t ms, uint32_t byteRate){
+    return (uint32_t)(((uint64_t)ms * byteRate) / 1000);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void jb_limit(jitterBuf_t* jb){
+    uint32_t cap = jb_ms(jb->capacity / 4 * 3, jb->byteRate);
+    uint32_t hi  = jb->maxMs < cap ? jb->maxMs : cap;
+    uint32_t lo  = jb->startMs < hi ? jb->startMs : hi;
+    if(jb->targetMs > hi) jb->targetMs = hi;
+    if(jb->targetMs < lo) jb->targetMs = lo;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void JB_Reset(jitterBuf_t* jb, uint32_t startMs, uint32_t maxMs, uint32_t capacity, uint32_t nowMs){
+    memset(jb, 0, sizeof(jitterBuf_t));
+    jb->startMs  = startMs;
+    jb->maxMs    = maxMs;
+    jb->capacity = capacity;
+    jb->byteRate = JB_DEFAULT_RATE;
+    jb->rateMs   = nowMs;
+    jb->winMs    = nowMs;
+    jb->calmMs   = nowMs;
+    jb->targetMs = startMs;
+    jb_limit(jb);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void JB_Arrival(jitterBuf_t* jb, uint32_t sockBytes, uint32_t byteRate, uint32_t nowMs){
+    if(!byteRate) byteRate = JB_DEFAULT_RATE;
+    if(byteRate != jb->byteRate){                               // bitrate known or changed, new media clock
+        jb->byteRate = byteRate;
+        jb->received = 0;
+        jb->rateMs = nowMs;
+        jb->haveTransit = false;
+        jb_limit(jb);
+    }
+    if(sockBytes > jb->sockLevel){
+        uint32_t n = sockBytes - jb->sockLevel;
+        // lateness of the first new byte against the media clock, the initial burst and other early arrivals count as 0
+        int32_t transit = (int32_t)(nowMs - jb->rateMs) - (int32_t)jb_ms(jb->received, byteRate);
+        if(jb->haveTransit){
+            int32_t d = transit - jb->transit;
+            if(d < 0) d = 0;
+            jb->jitterQ4 = (int32_t)jb->jitterQ4 + (d * 16 - (int32_t)jb->jitterQ4) / 16;
+        }
+        jb->transit = transit;
+        jb->haveTransit = true;
+        jb->received += n;
+        jb->winBytes += n;
+    }
+    jb->sockLevel = sockBytes;
+
+    if(nowMs - jb->winMs < 1000) return;
+    jb->throughput = (uint32_t)(((uint64_t)jb->winBytes * 1000) / (nowMs - jb->winMs));
+    jb->winBytes = 0;
+    jb->winMs = nowMs;
+    uint32_t jt = JB_JITTER_FACTOR * (jb->jitterQ4 >> 4);
+    if(jt > jb->targetMs){
+        jb->targetMs = jt;
+        jb->calmMs = nowMs;
+    }
+    else if(nowMs - jb->calmMs >= JB_STABLE_MS){                // stable link, give the depth back step by step
+        uint32_t t = jb->targetMs > JB_SHRINK_MS ? jb->targetMs - JB_SHRINK_MS : 0;
+        jb->targetMs = t > jt ? t : jt;
+        jb->calmMs = nowMs - JB_STABLE_MS + JB_SHRINK_EVERY_MS;
+    }
+    jb_limit(jb);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void JB_Read(jitterBuf_t* jb, uint32_t bytes){
+    jb->sockLevel = jb->sockLevel > bytes ? jb->sockLevel - bytes : 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool JB_Ready(jitterBuf_t* jb, uint32_t filled, uint32_t frame){
+    if(jb->started) return true;
+    uint32_t start = jb_bytes(jb->startMs, jb->byteRate);
+    if(start > jb->capacity / 4 * 3) start = jb->capacity / 4 * 3;     // small buffer without PSRAM
+    if(filled <= frame || filled < start) return false;
+    jb->started = true;
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t JB_ReadLimit(jitterBuf_t* jb, uint32_t filled, uint32_t frame){
+    if(!jb->started || jb->rebuffer || filled < jb_bytes(jb->targetMs, jb->byteRate)) return UINT32_MAX;
+    return frame;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool JB_Decode(jitterBuf_t* jb, uint32_t filled, uint32_t frame, bool live, uint32_t nowMs){
+    if(jb->rebuffer){
+        if(filled < frame || filled < jb_bytes(jb->targetMs, jb->byteRate)) return false;
+        jb->rebuffer = false;
+        return true;
+    }
+    if(!live || filled >= frame) return true;
+    jb->underruns++;
+    uint32_t grow = jb->targetMs / 2 > JB_GROW_MS ? jb->targetMs / 2 : JB_GROW_MS;
+    jb->targetMs += grow;
+    jb->calmMs = nowMs;
+    jb_limit(jb);
+    jb->rebuffer = true;
+    return false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t JB_FilledMs(const jitterBuf_t* jb, uint32_t filled){
+    return jb_ms(filled, jb->byteRate);
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t JB_JitterMs(const jitterBuf_t* jb){
+    return jb->jitterQ4 >> 4;
+}
@@ -0,0 +1,56 @@
+/*
+ * jitter.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Adaptive jitter buffer controller for web streams, it works on the fill level of the input buffer (InBuff).
+ *
+ *  arrival:   JB_Arrival() samples the bytes waiting in the socket on every loop, new bytes are an arrival.
+ *             Jitter is the mean lateness of the arrivals (RFC 3550 interarrival jitter, early arrivals count
+ *             as 0), media time from the byte rate of the stream. Throughput is measured in 1s windows.
+ *  start:     decoding starts at startMs of buffered audio (low watermark, at least one frame)
+ *  target:    depth the buffer is refilled to, starts at startMs, follows JB_JITTER_FACTOR x jitter up at once,
+ *             grows by half (at least JB_GROW_MS) on every underrun, shrinks by JB_SHRINK_MS every
+ *             JB_SHRINK_EVERY_MS after JB_STABLE_MS without growth. Limits: startMs ... maxMs and 3/4 of the buffer
+ *  underrun:  a live stream has less than one frame buffered, decoding waits until the target depth is buffered
+ *  read:      JB_ReadLimit(), below the target the socket is read in full, above it one frame per loop
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define JB_DEFAULT_RATE     16000       // bytes per second while the bitrate is unknown (128kbit/s)
+#define JB_JITTER_FACTOR    4
+#define JB_GROW_MS          500
+#define JB_SHRINK_MS        250
+#define JB_SHRINK_EVERY_MS  10000
+#define JB_STABLE_MS        30000
+
+typedef struct {
+    uint32_t  startMs, maxMs;       // settings
+    uint32_t  capacity;             // size of the input buffer, bytes
+    uint32_t  byteRate;             // bytes per second of the stream
+    uint32_t  sockLevel;            // bytes in the socket after the last read
+    uint32_t  received;             // bytes since the last rate change, media time
+    uint32_t  rateMs;               // millis() of the last rate change
+    int32_t   transit;              // arrival - media time of the previous arrival, ms
+    uint32_t  jitterQ4;             // ms, Q4
+    uint32_t  winMs, winBytes;      // throughput window
+    uint32_t  throughput;           // bytes per second, last window
+    uint32_t  targetMs;
+    uint32_t  calmMs;               // millis() of the last growth (shrink timer)
+    uint32_t  underruns;
+    bool      started;              // start watermark reached
+    bool      rebuffer;             // underrun, waiting for the target depth
+    bool      haveTransit;
+} jitterBuf_t;
+
+void     JB_Reset(jitterBuf_t* jb, uint32_t startMs, uint32_t maxMs, uint32_t capacity, uint32_t nowMs); // new stream
+void     JB_Arrival(jitterBuf_t* jb, uint32_t sockBytes, uint32_t byteRate, uint32_t nowMs); // socket level, every loop
+void     JB_Read(jitterBuf_t* jb, uint32_t bytes);                              // bytes taken from the socket
+bool     JB_Ready(jitterBuf_t* jb, uint32_t filled, uint32_t frame);            // true: start watermark reached
+uint32_t JB_ReadLimit(jitterBuf_t* jb, uint32_t filled, uint32_t frame);        // max. bytes for this read
+bool     JB_Decode(jitterBuf_t* jb, uint32_t filled, uint32_t frame, bool live, uint32_t nowMs); // false: wait
+uint32_t JB_FilledMs(const jitterBuf_t* jb, uint32_t filled);
+uint32_t JB_JitterMs(const jitterBuf_t* jb);
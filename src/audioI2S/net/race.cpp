@@ -0,0 +1,105 @@
+/*
+ * race.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Connection race between the mirrors of a stream, see race.h
+ */
+#include "race.h"
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t race_ms(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static bool race_prefix(const char* s, const char* prefix, int len){
+    // s (len bytes) starts with prefix, or is the start of it
+    int p = strlen(prefix);
+    return strncmp(s, prefix, len < p ? len : p) == 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int RACE_Connect(uint32_t ip, uint16_t port){
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(fd < 0) return -1;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    sa.sin_addr.s_addr = ip;
+    if(connect(fd, (struct sockaddr*)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) {close(fd); return -1;}
+    return fd;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int8_t RACE_Status(const char* st, int len){
+    // "HTTP/1.1 200", "ICY 200"
+    if(len <= 0) return RACE_DROP;
+    if(len >= 5 && race_prefix(st, "ICY ", len)) return st[4] == '2' ? RACE_WIN : RACE_DROP;
+    if(len >= 10 && race_prefix(st, "HTTP/", len)) return st[9] == '2' || st[9] == '3' ? RACE_WIN : RACE_DROP;
+    if(len < 10 && (race_prefix(st, "HTTP/", len) || race_prefix(st, "ICY ", len))) return RACE_WAIT; // not complete
+    return RACE_DROP;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int RACE_Run(raceConn_t* c, uint8_t n, uint32_t timeoutMs, raceCancel_t cancelled, void* arg){
+    int win = -1;
+    uint8_t alive = 0;
+    for(uint8_t k = 0; k < n; k++) if(c[k].fd >= 0) alive++;
+    uint32_t t = race_ms();
+    while(win < 0 && alive && race_ms() - t < timeoutMs && !(cancelled && cancelled(arg))){
+        fd_set rs, ws;
+        FD_ZERO(&rs);
+        FD_ZERO(&ws);
+        int maxfd = -1;
+        for(uint8_t k = 0; k < n; k++){
+            if(c[k].fd < 0) continue;
+            FD_SET(c[k].fd, c[k].sent ? &rs : &ws);
+            if(c[k].fd > maxfd) maxfd = c[k].fd;
+        }
+        struct timeval tv = {0, 50000};
+        if(select(maxfd + 1, &rs, &ws, NULL, &tv) < 0) break;
+        bool partial = false;
+        for(uint8_t k = 0; k < n && win < 0; k++){
+            if(c[k].fd < 0) continue;
+            bool drop = false;
+            if(!c[k].sent && FD_ISSET(c[k].fd, &ws)){           // connected or refused
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(c[k].fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                size_t l = strlen(c[k].rqh);
+                drop = err || send(c[k].fd, c[k].rqh, l, 0) != (int)l;
+                c[k].sent = true;
+            }
+            else if(c[k].sent && FD_ISSET(c[k].fd, &rs)){
+                char st[16];
+                int got = recv(c[k].fd, st, sizeof(st) - 1, MSG_PEEK);
+                int8_t s = RACE_Status(st, got);
+                if(s == RACE_WIN) win = k;
+                else if(s == RACE_DROP) drop = true;
+                else partial = true;
+            }
+            if(drop){
+                close(c[k].fd);
+                c[k].fd = -1;
+                alive--;
+            }
+        }
+        if(partial) usleep(1000);                               // the rest of the status line, one tick
+    }
+    for(uint8_t k = 0; k < n; k++){
+        if(c[k].fd < 0 || (int)k == win) continue;
+        close(c[k].fd);
+        c[k].fd = -1;
+    }
+    if(win >= 0) fcntl(c[win].fd, F_SETFL, fcntl(c[win].fd, F_GETFL, 0) & ~O_NONBLOCK);  // as WiFiClient::connect()
+    return win;
+}
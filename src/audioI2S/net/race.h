@@ -0,0 +1,33 @@
+/*
+ * race.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Connection race between the mirrors of a stream, BSD sockets (lwIP on the board, the host stack in the native test).
+ *
+ *  connect:   RACE_Connect() opens a non-blocking socket and starts the connect, the caller keeps the request
+ *  race:      RACE_Run() sends a socket its request as soon as it is connected and peeks at the response. The first
+ *             good status line (2xx, 3xx, ICY 200) wins, it is not read, the header is parsed as usual. A refused
+ *             connect, a failed send, a closed socket or another status drops the mirror, a status line that is not
+ *             complete yet is waited for (RACE_Status()).
+ *  end:       the others are closed (fd -1), the winner is blocking again. The race ends without a winner when all
+ *             are dropped, after timeoutMs or when cancelled() returns true.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+enum : int8_t { RACE_WAIT = 0, RACE_WIN = 1, RACE_DROP = 2 };
+
+typedef struct {
+    int         fd;                 // -1: dropped
+    bool        sent;               // connected, the request is sent
+    const char* rqh;                // http request
+} raceConn_t;
+
+typedef bool (*raceCancel_t)(void* arg);
+
+int    RACE_Connect(uint32_t ip, uint16_t port);        // ip in network order (IPAddress), -1: failed at once
+int8_t RACE_Status(const char* st, int len);            // first bytes of a response
+int    RACE_Run(raceConn_t* c, uint8_t n, uint32_t timeoutMs, raceCancel_t cancelled, void* arg); // index, -1: none
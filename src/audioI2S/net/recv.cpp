@@ -0,0 +1,22 @@
+/*
+ * recv.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Direct socket receive of the stream data, see recv.h
+ */
+#include "recv.h"
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+int RECV_Level(int fd){
+    int n = 0;
+    if(fd < 0 || ioctl(fd, FIONREAD, &n) != 0) return -1;
+    return n;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int RECV_Read(int fd, uint8_t* buf, uint32_t len){
+    int n = recv(fd, buf, len, MSG_DONTWAIT);
+    return n < 0 ? 0 : n;                               // EAGAIN, a closed socket is seen by connected()
+}
@@ -0,0 +1,24 @@
+/*
+ * recv.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Direct socket receive of the stream data, BSD sockets (lwIP on the board, the host stack in the native test).
+ *
+ *  The data of a plain http stream is read from the socket straight into InBuff (pbuf -> InBuff, one copy, one
+ *  call per block) instead of through the rx buffer of WiFiClient (pbuf -> 1436 bytes -> InBuff). The client may
+ *  still hold bytes of the stream (the rest of its rx buffer after the header, the prefetch buffer of a warm
+ *  connection), they come first:
+ *
+ *      int sock = RECV_Level(fd);
+ *      if(sock >= 0 && client.available() <= sock) n = RECV_Read(fd, buf, len); else n = client.read(buf, len);
+ *
+ *  available() is the buffered bytes plus the socket level, taken after RECV_Level(): data that arrives in between
+ *  only makes it larger, so the socket is read only when the client holds nothing. In this order, not the other.
+ */
+#pragma once
+
+#include <stdint.h>
+
+int RECV_Level(int fd);                                 // bytes waiting in the socket, -1: no socket
+int RECV_Read(int fd, uint8_t* buf, uint32_t len);      // without waiting, 0: nothing there (or closed)
@@ -0,0 +1,2070 @@
+/*
+ * celt.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Fixed point CELT decoder, the decoder part of the CELT layer of libopus 1.3 (range decoder, energy,
+ *  allocation, PVQ, band folding, anti collapse, postfilter) for the 48kHz mode, see celt.h
+ */
+#include "celt.h"
+
+#define BITRES                  3
+#define FINE_OFFSET             21
+#define QTHETA_OFFSET           4
+#define QTHETA_OFFSET_TWOPHASE  16
+#define MAX_FINE_BITS           8
+#define ALLOC_STEPS             6
+#define LOG_MAX_PSEUDO          6
+#define MAX_PULSES              128
+#define MAX_BAND                176                 // widest band, 22 * 8
+#define DB_SHIFT                10
+#define NORM_SCALING            16384
+#define Q15ONE                  32767
+#define SIG_SHIFT               12
+#define SIG_SAT                 300000000
+#define COMBFILTER_MINPERIOD    15
+#define PREEMPH                 27853               // 0.85 Q15
+#define SPREAD_NONE             0
+#define SPREAD_LIGHT            1
+#define SPREAD_NORMAL           2
+#define SPREAD_AGGRESSIVE       3
+#define MAX_LM                  3
+#define SHORT_MDCT              120
+
+#define EC_SYM_BITS             8
+#define EC_CODE_BITS            32
+#define EC_SYM_MAX              255
+#define EC_CODE_TOP             0x80000000U
+#define EC_CODE_BOT             0x00800000U
+#define EC_CODE_EXTRA           7
+#define EC_UINT_BITS            8
+#define EC_WINDOW_SIZE          32
+
+#define ADD16(a, b)             ((int16_t)((int16_t)(a) + (int16_t)(b)))
+#define SUB16(a, b)             ((int16_t)((int16_t)(a) - (int16_t)(b)))
+#define MULT16_16(a, b)         ((int32_t)(int16_t)(a) * (int32_t)(int16_t)(b))
+#define MULT16_16_Q14(a, b)     (MULT16_16(a, b) >> 14)
+#define MULT16_16_Q15(a, b)     (MULT16_16(a, b) >> 15)
+#define MULT16_16_P15(a, b)     ((MULT16_16(a, b) + 16384) >> 15)
+#define MULT16_32_Q15(a, b)     ((int32_t)(((int64_t)(int16_t)(a) * (int32_t)(b)) >> 15))
+#define S_MUL(a, b)             MULT16_32_Q15(b, a)
+#define FRAC_MUL16(a, b)        ((16384 + MULT16_16(a, b)) >> 15)
+#define PSHR32(a, s)            (((a) + ((1 << (s)) >> 1)) >> (s))
+#define VSHR32(a, s)            ((s) > 0 ? (a) >> (s) : (int32_t)((uint32_t)(a) << -(s)))
+#define SATURATE(x, a)          ((x) > (a) ? (a) : (x) < -(a) ? -(a) : (x))
+#define IMIN(a, b)              ((a) < (b) ? (a) : (b))
+#define IMAX(a, b)              ((a) > (b) ? (a) : (b))
+
+typedef struct { int32_t r, i; } cpx32_t;
+typedef struct { int16_t r, i; } cpx16_t;
+
+typedef struct {                                    // range decoder, RFC 6716 section 4.1
+    const uint8_t *buf;
+    uint32_t storage;
+    uint32_t end_offs;
+    uint32_t end_window;
+    int      nend_bits;
+    int      nbits_total;
+    uint32_t offs;
+    uint32_t rng;
+    uint32_t val;
+    uint32_t ext;
+    int      rem;
+    int      error;
+} ecDec_t;
+
+typedef struct {
+    ecDec_t *ec;
+    int      i;                                     // band
+    int      intensity;
+    int      spread;
+    int      tf_change;
+    int32_t  remaining_bits;
+    uint32_t seed;
+    int      disable_inv;
+} bandCtx_t;
+
+typedef struct {
+    int inv, imid, iside, delta, itheta, qalloc;
+} splitCtx_t;
+
+//----------------------------------------------------------------------------------------------------------------------
+//          T A B L E S
+//----------------------------------------------------------------------------------------------------------------------
+static const int16_t eband5ms[CELT_NBANDS + 1] = { // band edges in 5ms MDCT bins (400Hz)
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 34, 40, 48, 60, 78, 100};
+static const uint8_t band_allocation[11 * CELT_NBANDS] = { // bits per band, 1/32 bit per MDCT bin
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    90, 80, 75, 69, 63, 56, 49, 40, 34, 29, 20, 18, 10, 0, 0, 0, 0, 0, 0, 0, 0,
+    110, 100, 90, 84, 78, 71, 65, 58, 51, 45, 39, 32, 26, 20, 12, 0, 0, 0, 0, 0, 0,
+    118, 110, 103, 93, 86, 80, 75, 70, 65, 59, 53, 47, 40, 31, 23, 15, 4, 0, 0, 0, 0,
+    126, 119, 112, 104, 95, 89, 83, 78, 72, 66, 60, 54, 47, 39, 32, 25, 17, 12, 1, 0, 0,
+    134, 127, 120, 114, 103, 97, 91, 85, 78, 72, 66, 60, 54, 47, 41, 35, 29, 23, 16, 10, 1,
+    144, 137, 130, 124, 113, 107, 101, 95, 88, 82, 76, 70, 64, 57, 51, 45, 39, 33, 26, 15, 1,
+    152, 145, 138, 132, 123, 117, 111, 105, 98, 92, 86, 80, 74, 67, 61, 55, 49, 43, 36, 20, 1,
+    162, 155, 148, 142, 133, 127, 121, 115, 108, 102, 96, 90, 84, 77, 71, 65, 59, 53, 46, 30, 1,
+    172, 165, 158, 152, 143, 137, 131, 125, 118, 112, 106, 100, 94, 87, 81, 75, 69, 63, 56, 45, 20,
+    200, 200, 200, 200, 200, 200, 200, 200, 198, 193, 188, 183, 178, 173, 168, 163, 158, 153, 148, 129, 104};
+static const int16_t logN400[CELT_NBANDS] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 16, 16, 16, 21, 21, 24, 29, 34, 36};
+static const int8_t eMeans[25] = { // mean band energies Q4
+    103, 100, 92, 85, 81, 77, 72, 70, 78, 75, 73, 71, 78, 74, 69, 72, 70, 74, 76, 71, 60, 60, 60, 60, 60};
+static const int16_t pred_coef[4] = {
+    29440, 26112, 21248, 16384};
+static const int16_t beta_coef[4] = {
+    30147, 22282, 12124, 6554};
+static const int8_t tf_select_table[4][8] = {
+    {0, -1, 0, -1, 0, -1, 0, -1},
+    {0, -1, 0, -2, 1, 0, 1, -1},
+    {0, -2, 0, -3, 2, 0, 1, -1},
+    {0, -2, 0, -3, 3, 0, 1, -1}};
+static const uint8_t LOG2_FRAC_TABLE[24] = {
+    0, 8, 13, 16, 19, 21, 23, 24, 26, 27, 28, 29, 30, 31, 32, 32, 33, 34, 34, 35, 36, 36, 37, 37};
+static const uint8_t e_prob_model[4][2][42] = { // Laplace parameters of the coarse energy, inter and intra
+    {{72, 127, 65, 129, 66, 128, 65, 128, 64, 128, 62, 128, 64, 128, 64, 128, 92, 78, 92, 79, 92, 78, 90, 79, 116, 41, 115, 40, 114, 40, 132, 26, 132, 26, 145, 17, 161, 12, 176, 10, 177, 11},
+     {24, 179, 48, 138, 54, 135, 54, 132, 53, 134, 56, 133, 55, 132, 55, 132, 61, 114, 70, 96, 74, 88, 75, 88, 87, 74, 89, 66, 91, 67, 100, 59, 108, 50, 120, 40, 122, 37, 97, 43, 78, 50}},
+    {{83, 78, 84, 81, 88, 75, 86, 74, 87, 71, 90, 73, 93, 74, 93, 74, 109, 40, 114, 36, 117, 34, 117, 34, 143, 17, 145, 18, 146, 19, 162, 12, 165, 10, 178, 7, 189, 6, 190, 8, 177, 9},
+     {23, 178, 54, 115, 63, 102, 66, 98, 69, 99, 74, 89, 71, 91, 73, 91, 78, 89, 86, 80, 92, 66, 93, 64, 102, 59, 103, 60, 104, 60, 117, 52, 123, 44, 138, 35, 133, 31, 97, 38, 77, 45}},
+    {{61, 90, 93, 60, 105, 42, 107, 41, 110, 45, 116, 38, 113, 38, 112, 38, 124, 26, 132, 27, 136, 19, 140, 20, 155, 14, 159, 16, 158, 18, 170, 13, 177, 10, 187, 8, 192, 6, 175, 9, 159, 10},
+     {21, 178, 59, 110, 71, 86, 75, 85, 84, 83, 91, 66, 88, 73, 87, 72, 92, 75, 98, 72, 105, 58, 107, 54, 115, 52, 114, 55, 112, 56, 129, 51, 132, 40, 150, 33, 140, 29, 98, 35, 77, 42}},
+    {{42, 121, 96, 66, 108, 43, 111, 40, 117, 44, 123, 32, 120, 36, 119, 33, 127, 33, 134, 34, 139, 21, 147, 23, 152, 20, 158, 25, 154, 26, 166, 21, 173, 16, 184, 13, 184, 10, 150, 13, 139, 15},
+     {22, 178, 63, 114, 74, 82, 84, 83, 92, 82, 103, 62, 96, 72, 96, 67, 101, 73, 107, 72, 113, 55, 118, 52, 125, 52, 118, 52, 117, 55, 135, 49, 137, 39, 157, 32, 145, 29, 97, 33, 77, 40}}};
+static const int8_t ordery_table[30] = {
+    1, 0, 3, 0, 2, 1, 7, 0, 4, 3, 6, 1, 5, 2, 15, 0, 8, 7, 12, 3, 11, 4, 14, 1, 9, 6, 13, 2, 10, 5};
+static const uint8_t cache_caps50[168] = { // maximum bits per band
+    224, 224, 224, 224, 224, 224, 224, 224, 160, 160, 160, 160, 185, 185, 185, 178, 178, 168, 134, 61, 37,
+    224, 224, 224, 224, 224, 224, 224, 224, 240, 240, 240, 240, 207, 207, 207, 198, 198, 183, 144, 66, 40,
+    160, 160, 160, 160, 160, 160, 160, 160, 185, 185, 185, 185, 193, 193, 193, 183, 183, 172, 138, 64, 38,
+    240, 240, 240, 240, 240, 240, 240, 240, 207, 207, 207, 207, 204, 204, 204, 193, 193, 180, 143, 66, 40,
+    185, 185, 185, 185, 185, 185, 185, 185, 193, 193, 193, 193, 193, 193, 193, 183, 183, 172, 138, 65, 39,
+    207, 207, 207, 207, 207, 207, 207, 207, 204, 204, 204, 204, 201, 201, 201, 188, 188, 176, 141, 66, 40,
+    193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 194, 194, 194, 184, 184, 173, 139, 65, 39,
+    204, 204, 204, 204, 204, 204, 204, 204, 201, 201, 201, 201, 198, 198, 198, 187, 187, 175, 140, 66, 40};
+static const uint8_t cache_bits50[392] = { // pulse cache: bits of K pulses per band size
+    40, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 40, 15, 23, 28, 31, 34, 36,
+    38, 39, 41, 42, 43, 44, 45, 46, 47, 47, 49, 50, 51, 52, 53, 54, 55, 55, 57, 58, 59, 60, 61, 62,
+    63, 63, 65, 66, 67, 68, 69, 70, 71, 71, 40, 20, 33, 41, 48, 53, 57, 61, 64, 66, 69, 71, 73, 75,
+    76, 78, 80, 82, 85, 87, 89, 91, 92, 94, 96, 98, 101, 103, 105, 107, 108, 110, 112, 114, 117, 119, 121, 123,
+    124, 126, 128, 40, 23, 39, 51, 60, 67, 73, 79, 83, 87, 91, 94, 97, 100, 102, 105, 107, 111, 115, 118, 121,
+    124, 126, 129, 131, 135, 139, 142, 145, 148, 150, 153, 155, 159, 163, 166, 169, 172, 174, 177, 179, 35, 28, 49, 65,
+    78, 89, 99, 107, 114, 120, 126, 132, 136, 141, 145, 149, 153, 159, 165, 171, 176, 180, 185, 189, 192, 199, 205, 211,
+    216, 220, 225, 229, 232, 239, 245, 251, 21, 33, 58, 79, 97, 112, 125, 137, 148, 157, 166, 174, 182, 189, 195, 201,
+    207, 217, 227, 235, 243, 251, 17, 35, 63, 86, 106, 123, 139, 152, 165, 177, 187, 197, 206, 214, 222, 230, 237, 250,
+    25, 31, 55, 75, 91, 105, 117, 128, 138, 146, 154, 161, 168, 174, 180, 185, 190, 200, 208, 215, 222, 229, 235, 240,
+    245, 255, 16, 36, 65, 89, 110, 128, 144, 159, 173, 185, 196, 207, 217, 226, 234, 242, 250, 11, 41, 74, 103, 128,
+    151, 172, 191, 209, 225, 241, 255, 9, 43, 79, 110, 138, 163, 186, 207, 227, 246, 12, 39, 71, 99, 123, 144, 164,
+    182, 198, 214, 228, 241, 253, 9, 44, 81, 113, 142, 168, 192, 214, 235, 255, 7, 49, 90, 127, 160, 191, 220, 247,
+    6, 51, 95, 134, 170, 203, 234, 7, 47, 87, 123, 155, 184, 212, 237, 6, 52, 97, 137, 174, 208, 240, 5, 57,
+    106, 151, 192, 231, 5, 59, 111, 158, 202, 243, 5, 55, 103, 147, 187, 224, 5, 60, 113, 161, 206, 248, 4, 65,
+    122, 175, 224, 4, 67, 127, 182, 234};
+static const int16_t cache_index50[105] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 41, 41, 41, 82, 82, 123, 164, 200, 222,
+    0, 0, 0, 0, 0, 0, 0, 0, 41, 41, 41, 41, 123, 123, 123, 164, 164, 240, 266, 283, 295,
+    41, 41, 41, 41, 41, 41, 41, 41, 123, 123, 123, 123, 240, 240, 240, 266, 266, 305, 318, 328, 336,
+    123, 123, 123, 123, 123, 123, 123, 123, 240, 240, 240, 240, 305, 305, 305, 318, 318, 343, 351, 358, 364,
+    240, 240, 240, 240, 240, 240, 240, 240, 305, 305, 305, 305, 343, 343, 343, 351, 351, 370, 376, 382, 387};
+static const cpx16_t fftTwiddles[480] = { // exp(-2pi*i*k/480) Q15
+    {32767, 0}, {32765, -429}, {32757, -858}, {32743, -1286}, {32723, -1715}, {32698, -2143}, {32667, -2571}, {32631, -2998},
+    {32588, -3425}, {32541, -3851}, {32488, -4277}, {32429, -4702}, {32365, -5126}, {32295, -5549}, {32219, -5971}, {32138, -6393},
+    {32052, -6813}, {31960, -7232}, {31863, -7650}, {31760, -8066}, {31651, -8481}, {31538, -8895}, {31419, -9307}, {31294, -9717},
+    {31164, -10126}, {31029, -10533}, {30888, -10938}, {30743, -11342}, {30592, -11743}, {30435, -12142}, {30274, -12540}, {30107, -12935},
+    {29935, -13328}, {29758, -13719}, {29576, -14107}, {29389, -14493}, {29197, -14876}, {28999, -15257}, {28797, -15636}, {28590, -16011},
+    {28378, -16384}, {28161, -16754}, {27939, -17121}, {27713, -17485}, {27482, -17847}, {27246, -18205}, {27005, -18560}, {26760, -18912},
+    {26510, -19261}, {26255, -19606}, {25997, -19948}, {25733, -20286}, {25466, -20622}, {25193, -20953}, {24917, -21281}, {24636, -21605},
+    {24351, -21926}, {24062, -22243}, {23769, -22556}, {23472, -22865}, {23170, -23170}, {22865, -23472}, {22556, -23769}, {22243, -24062},
+    {21926, -24351}, {21605, -24636}, {21281, -24917}, {20953, -25193}, {20622, -25466}, {20286, -25733}, {19948, -25997}, {19606, -26255},
+    {19261, -26510}, {18912, -26760}, {18560, -27005}, {18205, -27246}, {17847, -27482}, {17485, -27713}, {17121, -27939}, {16754, -28161},
+    {16384, -28378}, {16011, -28590}, {15636, -28797}, {15257, -28999}, {14876, -29197}, {14493, -29389}, {14107, -29576}, {13719, -29758},
+    {13328, -29935}, {12935, -30107}, {12540, -30274}, {12142, -30435}, {11743, -30592}, {11342, -30743}, {10938, -30888}, {10533, -31029},
+    {10126, -31164}, {9717, -31294}, {9307, -31419}, {8895, -31538}, {8481, -31651}, {8066, -31760}, {7650, -31863}, {7232, -31960},
+    {6813, -32052}, {6393, -32138}, {5971, -32219}, {5549, -32295}, {5126, -32365}, {4702, -32429}, {4277, -32488}, {3851, -32541},
+    {3425, -32588}, {2998, -32631}, {2571, -32667}, {2143, -32698}, {1715, -32723}, {1286, -32743}, {858, -32757}, {429, -32765},
+    {0, -32768}, {-429, -32765}, {-858, -32757}, {-1286, -32743}, {-1715, -32723}, {-2143, -32698}, {-2571, -32667}, {-2998, -32631},
+    {-3425, -32588}, {-3851, -32541}, {-4277, -32488}, {-4702, -32429}, {-5126, -32365}, {-5549, -32295}, {-5971, -32219}, {-6393, -32138},
+    {-6813, -32052}, {-7232, -31960}, {-7650, -31863}, {-8066, -31760}, {-8481, -31651}, {-8895, -31538}, {-9307, -31419}, {-9717, -31294},
+    {-10126, -31164}, {-10533, -31029}, {-10938, -30888}, {-11342, -30743}, {-11743, -30592}, {-12142, -30435}, {-12540, -30274}, {-12935, -30107},
+    {-13328, -29935}, {-13719, -29758}, {-14107, -29576}, {-14493, -29389}, {-14876, -29197}, {-15257, -28999}, {-15636, -28797}, {-16011, -28590},
+    {-16384, -28378}, {-16754, -28161}, {-17121, -27939}, {-17485, -27713}, {-17847, -27482}, {-18205, -27246}, {-18560, -27005}, {-18912, -26760},
+    {-19261, -26510}, {-19606, -26255}, {-19948, -25997}, {-20286, -25733}, {-20622, -25466}, {-20953, -25193}, {-21281, -24917}, {-21605, -24636},
+    {-21926, -24351}, {-22243, -24062}, {-22556, -23769}, {-22865, -23472}, {-23170, -23170}, {-23472, -22865}, {-23769, -22556}, {-24062, -22243},
+    {-24351, -21926}, {-24636, -21605}, {-24917, -21281}, {-25193, -20953}, {-25466, -20622}, {-25733, -20286}, {-25997, -19948}, {-26255, -19606},
+    {-26510, -19261}, {-26760, -18912}, {-27005, -18560}, {-27246, -18205}, {-27482, -17847}, {-27713, -17485}, {-27939, -17121}, {-28161, -16754},
+    {-28378, -16384}, {-28590, -16011}, {-28797, -15636}, {-28999, -15257}, {-29197, -14876}, {-29389, -14493}, {-29576, -14107}, {-29758, -13719},
+    {-29935, -13328}, {-30107, -12935}, {-30274, -12540}, {-30435, -12142}, {-30592, -11743}, {-30743, -11342}, {-30888, -10938}, {-31029, -10533},
+    {-31164, -10126}, {-31294, -9717}, {-31419, -9307}, {-31538, -8895}, {-31651, -8481}, {-31760, -8066}, {-31863, -7650}, {-31960, -7232},
+    {-32052, -6813}, {-32138, -6393}, {-32219, -5971}, {-32295, -5549}, {-32365, -5126}, {-32429, -4702}, {-32488, -4277}, {-32541, -3851},
+    {-32588, -3425}, {-32631, -2998}, {-32667, -2571}, {-32698, -2143}, {-32723, -1715}, {-32743, -1286}, {-32757, -858}, {-32765, -429},
+    {-32768, 0}, {-32765, 429}, {-32757, 858}, {-32743, 1286}, {-32723, 1715}, {-32698, 2143}, {-32667, 2571}, {-32631, 2998},
+    {-32588, 3425}, {-32541, 3851}, {-32488, 4277}, {-32429, 4702}, {-32365, 5126}, {-32295, 5549}, {-32219, 5971}, {-32138, 6393},
+    {-32052, 6813}, {-31960, 7232}, {-31863, 7650}, {-31760, 8066}, {-31651, 8481}, {-31538, 8895}, {-31419, 9307}, {-31294, 9717},
+    {-31164, 10126}, {-31029, 10533}, {-30888, 10938}, {-30743, 11342}, {-30592, 11743}, {-30435, 12142}, {-30274, 12540}, {-30107, 12935},
+    {-29935, 13328}, {-29758, 13719}, {-29576, 14107}, {-29389, 14493}, {-29197, 14876}, {-28999, 15257}, {-28797, 15636}, {-28590, 16011},
+    {-28378, 16384}, {-28161, 16754}, {-27939, 17121}, {-27713, 17485}, {-27482, 17847}, {-27246, 18205}, {-27005, 18560}, {-26760, 18912},
+    {-26510, 19261}, {-26255, 19606}, {-25997, 19948}, {-25733, 20286}, {-25466, 20622}, {-25193, 20953}, {-24917, 21281}, {-24636, 21605},
+    {-24351, 21926}, {-24062, 22243}, {-23769, 22556}, {-23472, 22865}, {-23170, 23170}, {-22865, 23472}, {-22556, 23769}, {-22243, 24062},
+    {-21926, 24351}, {-21605, 24636}, {-21281, 24917}, {-20953, 25193}, {-20622, 25466}, {-20286, 25733}, {-19948, 25997}, {-19606, 26255},
+    {-19261, 26510}, {-18912, 26760}, {-18560, 27005}, {-18205, 27246}, {-17847, 27482}, {-17485, 27713}, {-17121, 27939}, {-16754, 28161},
+    {-16384, 28378}, {-16011, 28590}, {-15636, 28797}, {-15257, 28999}, {-14876, 29197}, {-14493, 29389}, {-14107, 29576}, {-13719, 29758},
+    {-13328, 29935}, {-12935, 30107}, {-12540, 30274}, {-12142, 30435}, {-11743, 30592}, {-11342, 30743}, {-10938, 30888}, {-10533, 31029},
+    {-10126, 31164}, {-9717, 31294}, {-9307, 31419}, {-8895, 31538}, {-8481, 31651}, {-8066, 31760}, {-7650, 31863}, {-7232, 31960},
+    {-6813, 32052}, {-6393, 32138}, {-5971, 32219}, {-5549, 32295}, {-5126, 32365}, {-4702, 32429}, {-4277, 32488}, {-3851, 32541},
+    {-3425, 32588}, {-2998, 32631}, {-2571, 32667}, {-2143, 32698}, {-1715, 32723}, {-1286, 32743}, {-858, 32757}, {-429, 32765},
+    {0, 32767}, {429, 32765}, {858, 32757}, {1286, 32743}, {1715, 32723}, {2143, 32698}, {2571, 32667}, {2998, 32631},
+    {3425, 32588}, {3851, 32541}, {4277, 32488}, {4702, 32429}, {5126, 32365}, {5549, 32295}, {5971, 32219}, {6393, 32138},
+    {6813, 32052}, {7232, 31960}, {7650, 31863}, {8066, 31760}, {8481, 31651}, {8895, 31538}, {9307, 31419}, {9717, 31294},
+    {10126, 31164}, {10533, 31029}, {10938, 30888}, {11342, 30743}, {11743, 30592}, {12142, 30435}, {12540, 30274}, {12935, 30107},
+    {13328, 29935}, {13719, 29758}, {14107, 29576}, {14493, 29389}, {14876, 29197}, {15257, 28999}, {15636, 28797}, {16011, 28590},
+    {16384, 28378}, {16754, 28161}, {17121, 27939}, {17485, 27713}, {17847, 27482}, {18205, 27246}, {18560, 27005}, {18912, 26760},
+    {19261, 26510}, {19606, 26255}, {19948, 25997}, {20286, 25733}, {20622, 25466}, {20953, 25193}, {21281, 24917}, {21605, 24636},
+    {21926, 24351}, {22243, 24062}, {22556, 23769}, {22865, 23472}, {23170, 23170}, {23472, 22865}, {23769, 22556}, {24062, 22243},
+    {24351, 21926}, {24636, 21605}, {24917, 21281}, {25193, 20953}, {25466, 20622}, {25733, 20286}, {25997, 19948}, {26255, 19606},
+    {26510, 19261}, {26760, 18912}, {27005, 18560}, {27246, 18205}, {27482, 17847}, {27713, 17485}, {27939, 17121}, {28161, 16754},
+    {28378, 16384}, {28590, 16011}, {28797, 15636}, {28999, 15257}, {29197, 14876}, {29389, 14493}, {29576, 14107}, {29758, 13719},
+    {29935, 13328}, {30107, 12935}, {30274, 12540}, {30435, 12142}, {30592, 11743}, {30743, 11342}, {30888, 10938}, {31029, 10533},
+    {31164, 10126}, {31294, 9717}, {31419, 9307}, {31538, 8895}, {31651, 8481}, {31760, 8066}, {31863, 7650}, {31960, 7232},
+    {32052, 6813}, {32138, 6393}, {32219, 5971}, {32295, 5549}, {32365, 5126}, {32429, 4702}, {32488, 4277}, {32541, 3851},
+    {32588, 3425}, {32631, 2998}, {32667, 2571}, {32698, 2143}, {32723, 1715}, {32743, 1286}, {32757, 858}, {32765, 429}};
+static const int16_t mdctTrig[1800] = { // cos(2pi(i+1/8)/N) Q15 for N = 1920, 960, 480, 240
+    32767, 32767, 32767, 32766, 32765, 32763, 32761, 32759, 32756, 32753, 32750, 32746, 32742, 32738, 32733, 32728,
+    32722, 32717, 32710, 32704, 32697, 32690, 32682, 32674, 32666, 32657, 32648, 32639, 32629, 32619, 32609, 32598,
+    32587, 32576, 32564, 32552, 32539, 32526, 32513, 32500, 32486, 32472, 32457, 32442, 32427, 32411, 32395, 32379,
+    32362, 32345, 32328, 32310, 32292, 32274, 32255, 32236, 32217, 32197, 32177, 32157, 32136, 32115, 32093, 32071,
+    32049, 32027, 32004, 31981, 31957, 31933, 31909, 31884, 31859, 31834, 31809, 31783, 31756, 31730, 31703, 31676,
+    31648, 31620, 31592, 31563, 31534, 31505, 31475, 31445, 31415, 31384, 31353, 31322, 31290, 31258, 31226, 31193,
+    31160, 31127, 31093, 31059, 31025, 30990, 30955, 30920, 30884, 30848, 30812, 30775, 30738, 30701, 30663, 30625,
+    30587, 30548, 30509, 30470, 30430, 30390, 30350, 30309, 30269, 30227, 30186, 30144, 30102, 30059, 30016, 29973,
+    29930, 29886, 29842, 29797, 29752, 29707, 29662, 29616, 29570, 29524, 29477, 29430, 29383, 29335, 29287, 29239,
+    29190, 29142, 29092, 29043, 28993, 28943, 28892, 28842, 28791, 28739, 28688, 28636, 28583, 28531, 28478, 28425,
+    28371, 28317, 28263, 28209, 28154, 28099, 28044, 27988, 27932, 27876, 27820, 27763, 27706, 27648, 27591, 27533,
+    27474, 27416, 27357, 27298, 27238, 27178, 27118, 27058, 26997, 26936, 26875, 26814, 26752, 26690, 26628, 26565,
+    26502, 26439, 26375, 26312, 26247, 26183, 26119, 26054, 25988, 25923, 25857, 25791, 25725, 25658, 25592, 25524,
+    25457, 25389, 25322, 25253, 25185, 25116, 25047, 24978, 24908, 24838, 24768, 24698, 24627, 24557, 24485, 24414,
+    24342, 24270, 24198, 24126, 24053, 23980, 23907, 23834, 23760, 23686, 23612, 23537, 23462, 23387, 23312, 23237,
+    23161, 23085, 23009, 22932, 22856, 22779, 22701, 22624, 22546, 22468, 22390, 22312, 22233, 22154, 22075, 21996,
+    21916, 21836, 21756, 21676, 21595, 21515, 21434, 21352, 21271, 21189, 21107, 21025, 20943, 20860, 20777, 20694,
+    20611, 20528, 20444, 20360, 20276, 20192, 20107, 20022, 19937, 19852, 19767, 19681, 19595, 19509, 19423, 19336,
+    19250, 19163, 19076, 18988, 18901, 18813, 18725, 18637, 18549, 18460, 18372, 18283, 18194, 18104, 18015, 17925,
+    17835, 17745, 17655, 17565, 17474, 17383, 17292, 17201, 17110, 17018, 16927, 16835, 16743, 16650, 16558, 16465,
+    16372, 16279, 16186, 16093, 15999, 15906, 15812, 15718, 15624, 15529, 15435, 15340, 15245, 15150, 15055, 14960,
+    14864, 14769, 14673, 14577, 14481, 14385, 14288, 14192, 14095, 13998, 13901, 13804, 13706, 13609, 13511, 13414,
+    13316, 13218, 13119, 13021, 12923, 12824, 12725, 12626, 12527, 12428, 12329, 12230, 12130, 12030, 11930, 11831,
+    11730, 11630, 11530, 11430, 11329, 11228, 11128, 11027, 10926, 10824, 10723, 10622, 10520, 10419, 10317, 10215,
+    10113, 10011, 9909, 9807, 9704, 9602, 9499, 9397, 9294, 9191, 9088, 8985, 8882, 8778, 8675, 8572,
+    8468, 8364, 8261, 8157, 8053, 7949, 7845, 7741, 7637, 7532, 7428, 7323, 7219, 7114, 7009, 6905,
+    6800, 6695, 6590, 6485, 6380, 6274, 6169, 6064, 5958, 5853, 5747, 5642, 5536, 5430, 5325, 5219,
+    5113, 5007, 4901, 4795, 4689, 4583, 4476, 4370, 4264, 4157, 4051, 3945, 3838, 3732, 3625, 3518,
+    3412, 3305, 3198, 3092, 2985, 2878, 2771, 2664, 2558, 2451, 2344, 2237, 2130, 2023, 1916, 1809,
+    1702, 1594, 1487, 1380, 1273, 1166, 1059, 952, 844, 737, 630, 523, 416, 308, 201, 94,
+    -13, -121, -228, -335, -442, -550, -657, -764, -871, -978, -1086, -1193, -1300, -1407, -1514, -1621,
+    -1728, -1835, -1942, -2049, -2157, -2263, -2370, -2477, -2584, -2691, -2798, -2905, -3012, -3118, -3225, -3332,
+    -3439, -3545, -3652, -3758, -3865, -3971, -4078, -4184, -4290, -4397, -4503, -4609, -4715, -4821, -4927, -5033,
+    -5139, -5245, -5351, -5457, -5562, -5668, -5774, -5879, -5985, -6090, -6195, -6301, -6406, -6511, -6616, -6721,
+    -6826, -6931, -7036, -7140, -7245, -7349, -7454, -7558, -7663, -7767, -7871, -7975, -8079, -8183, -8287, -8390,
+    -8494, -8597, -8701, -8804, -8907, -9011, -9114, -9217, -9319, -9422, -9525, -9627, -9730, -9832, -9934, -10037,
+    -10139, -10241, -10342, -10444, -10546, -10647, -10748, -10850, -10951, -11052, -11153, -11253, -11354, -11455, -11555, -11655,
+    -11756, -11856, -11955, -12055, -12155, -12254, -12354, -12453, -12552, -12651, -12750, -12849, -12947, -13046, -13144, -13242,
+    -13340, -13438, -13536, -13633, -13731, -13828, -13925, -14022, -14119, -14216, -14312, -14409, -14505, -14601, -14697, -14793,
+    -14888, -14984, -15079, -15174, -15269, -15364, -15459, -15553, -15647, -15741, -15835, -15929, -16023, -16116, -16210, -16303,
+    -16396, -16488, -16581, -16673, -16766, -16858, -16949, -17041, -17133, -17224, -17315, -17406, -17497, -17587, -17678, -17768,
+    -17858, -17948, -18037, -18127, -18216, -18305, -18394, -18483, -18571, -18659, -18747, -18835, -18923, -19010, -19098, -19185,
+    -19271, -19358, -19444, -19531, -19617, -19702, -19788, -19873, -19959, -20043, -20128, -20213, -20297, -20381, -20465, -20549,
+    -20632, -20715, -20798, -20881, -20963, -21046, -21128, -21210, -21291, -21373, -21454, -21535, -21616, -21696, -21776, -21856,
+    -21936, -22016, -22095, -22174, -22253, -22331, -22410, -22488, -22566, -22643, -22721, -22798, -22875, -22951, -23028, -23104,
+    -23180, -23256, -23331, -23406, -23481, -23556, -23630, -23704, -23778, -23852, -23925, -23998, -24071, -24144, -24216, -24288,
+    -24360, -24432, -24503, -24574, -24645, -24716, -24786, -24856, -24926, -24995, -25064, -25133, -25202, -25270, -25339, -25406,
+    -25474, -25541, -25608, -25675, -25742, -25808, -25874, -25939, -26005, -26070, -26135, -26199, -26264, -26327, -26391, -26455,
+    -26518, -26581, -26643, -26705, -26767, -26829, -26891, -26952, -27013, -27073, -27133, -27193, -27253, -27312, -27372, -27430,
+    -27489, -27547, -27605, -27663, -27720, -27777, -27834, -27890, -27946, -28002, -28058, -28113, -28168, -28223, -28277, -28331,
+    -28385, -28438, -28491, -28544, -28596, -28649, -28701, -28752, -28803, -28854, -28905, -28955, -29006, -29055, -29105, -29154,
+    -29203, -29251, -29299, -29347, -29395, -29442, -29489, -29535, -29582, -29628, -29673, -29719, -29764, -29808, -29853, -29897,
+    -29941, -29984, -30027, -30070, -30112, -30154, -30196, -30238, -30279, -30320, -30360, -30400, -30440, -30480, -30519, -30558,
+    -30596, -30635, -30672, -30710, -30747, -30784, -30821, -30857, -30893, -30929, -30964, -30999, -31033, -31068, -31102, -31135,
+    -31168, -31201, -31234, -31266, -31298, -31330, -31361, -31392, -31422, -31453, -31483, -31512, -31541, -31570, -31599, -31627,
+    -31655, -31682, -31710, -31737, -31763, -31789, -31815, -31841, -31866, -31891, -31915, -31939, -31963, -31986, -32010, -32032,
+    -32055, -32077, -32099, -32120, -32141, -32162, -32182, -32202, -32222, -32241, -32260, -32279, -32297, -32315, -32333, -32350,
+    -32367, -32383, -32399, -32415, -32431, -32446, -32461, -32475, -32489, -32503, -32517, -32530, -32542, -32555, -32567, -32579,
+    -32590, -32601, -32612, -32622, -32632, -32641, -32651, -32659, -32668, -32676, -32684, -32692, -32699, -32706, -32712, -32718,
+    -32724, -32729, -32734, -32739, -32743, -32747, -32751, -32754, -32757, -32760, -32762, -32764, -32765, -32767, -32767, -32768,
+    32767, 32767, 32765, 32761, 32756, 32750, 32742, 32732, 32722, 32710, 32696, 32681, 32665, 32647, 32628, 32608,
+    32586, 32562, 32538, 32512, 32484, 32455, 32425, 32393, 32360, 32326, 32290, 32253, 32214, 32174, 32133, 32090,
+    32046, 32001, 31954, 31906, 31856, 31805, 31753, 31700, 31645, 31588, 31530, 31471, 31411, 31349, 31286, 31222,
+    31156, 31089, 31020, 30951, 30880, 30807, 30733, 30658, 30582, 30504, 30425, 30345, 30263, 30181, 30096, 30011,
+    29924, 29836, 29747, 29656, 29564, 29471, 29377, 29281, 29184, 29086, 28987, 28886, 28784, 28681, 28577, 28471,
+    28365, 28257, 28147, 28037, 27925, 27812, 27698, 27583, 27467, 27349, 27231, 27111, 26990, 26868, 26744, 26620,
+    26494, 26367, 26239, 26110, 25980, 25849, 25717, 25583, 25449, 25313, 25176, 25038, 24900, 24760, 24619, 24477,
+    24333, 24189, 24044, 23898, 23751, 23602, 23453, 23303, 23152, 22999, 22846, 22692, 22537, 22380, 22223, 22065,
+    21906, 21746, 21585, 21423, 21261, 21097, 20933, 20767, 20601, 20434, 20265, 20096, 19927, 19756, 19584, 19412,
+    19239, 19065, 18890, 18714, 18538, 18361, 18183, 18004, 17824, 17644, 17463, 17281, 17098, 16915, 16731, 16546,
+    16361, 16175, 15988, 15800, 15612, 15423, 15234, 15043, 14852, 14661, 14469, 14276, 14083, 13889, 13694, 13499,
+    13303, 13107, 12910, 12713, 12515, 12317, 12118, 11918, 11718, 11517, 11316, 11115, 10913, 10710, 10508, 10304,
+    10100, 9896, 9691, 9486, 9281, 9075, 8869, 8662, 8455, 8248, 8040, 7832, 7623, 7415, 7206, 6996,
+    6787, 6577, 6366, 6156, 5945, 5734, 5523, 5311, 5100, 4888, 4675, 4463, 4251, 4038, 3825, 3612,
+    3399, 3185, 2972, 2758, 2544, 2330, 2116, 1902, 1688, 1474, 1260, 1045, 831, 617, 402, 188,
+    -27, -241, -456, -670, -885, -1099, -1313, -1528, -1742, -1956, -2170, -2384, -2598, -2811, -3025, -3239,
+    -3452, -3665, -3878, -4091, -4304, -4516, -4728, -4941, -5153, -5364, -5576, -5787, -5998, -6209, -6419, -6629,
+    -6839, -7049, -7258, -7467, -7676, -7884, -8092, -8300, -8507, -8714, -8920, -9127, -9332, -9538, -9743, -9947,
+    -10151, -10355, -10558, -10761, -10963, -11165, -11367, -11568, -11768, -11968, -12167, -12366, -12565, -12762, -12960, -13156,
+    -13352, -13548, -13743, -13937, -14131, -14324, -14517, -14709, -14900, -15091, -15281, -15470, -15659, -15847, -16035, -16221,
+    -16407, -16593, -16777, -16961, -17144, -17326, -17508, -17689, -17869, -18049, -18227, -18405, -18582, -18758, -18934, -19108,
+    -19282, -19455, -19627, -19799, -19969, -20139, -20308, -20475, -20642, -20809, -20974, -21138, -21301, -21464, -21626, -21786,
+    -21946, -22105, -22263, -22420, -22575, -22730, -22884, -23037, -23189, -23340, -23490, -23640, -23788, -23935, -24080, -24225,
+    -24369, -24512, -24654, -24795, -24934, -25073, -25211, -25347, -25482, -25617, -25750, -25882, -26013, -26143, -26272, -26399,
+    -26526, -26651, -26775, -26898, -27020, -27141, -27260, -27379, -27496, -27612, -27727, -27841, -27953, -28065, -28175, -28284,
+    -28391, -28498, -28603, -28707, -28810, -28911, -29012, -29111, -29209, -29305, -29401, -29495, -29587, -29679, -29769, -29858,
+    -29946, -30032, -30118, -30201, -30284, -30365, -30445, -30524, -30601, -30677, -30752, -30825, -30897, -30968, -31038, -31106,
+    -31172, -31238, -31302, -31365, -31426, -31486, -31545, -31602, -31658, -31713, -31766, -31818, -31869, -31918, -31966, -32012,
+    -32058, -32101, -32144, -32185, -32224, -32262, -32299, -32335, -32369, -32401, -32433, -32463, -32491, -32518, -32544, -32568,
+    -32591, -32613, -32633, -32652, -32669, -32685, -32700, -32713, -32724, -32735, -32744, -32751, -32757, -32762, -32766, -32767,
+    32767, 32764, 32755, 32741, 32720, 32694, 32663, 32626, 32583, 32535, 32481, 32421, 32356, 32286, 32209, 32128,
+    32041, 31948, 31850, 31747, 31638, 31523, 31403, 31278, 31148, 31012, 30871, 30724, 30572, 30415, 30253, 30086,
+    29913, 29736, 29553, 29365, 29172, 28974, 28771, 28564, 28351, 28134, 27911, 27684, 27452, 27216, 26975, 26729,
+    26478, 26223, 25964, 25700, 25432, 25159, 24882, 24601, 24315, 24026, 23732, 23434, 23133, 22827, 22517, 22204,
+    21886, 21565, 21240, 20912, 20580, 20244, 19905, 19563, 19217, 18868, 18516, 18160, 17802, 17440, 17075, 16708,
+    16338, 15964, 15588, 15210, 14829, 14445, 14059, 13670, 13279, 12886, 12490, 12093, 11693, 11291, 10888, 10482,
+    10075, 9666, 9255, 8843, 8429, 8014, 7597, 7180, 6760, 6340, 5919, 5496, 5073, 4649, 4224, 3798,
+    3372, 2945, 2517, 2090, 1661, 1233, 804, 375, -54, -483, -911, -1340, -1768, -2197, -2624, -3052,
+    -3479, -3905, -4330, -4755, -5179, -5602, -6024, -6445, -6865, -7284, -7702, -8118, -8533, -8946, -9358, -9768,
+    -10177, -10584, -10989, -11392, -11793, -12192, -12589, -12984, -13377, -13767, -14155, -14541, -14924, -15305, -15683, -16058,
+    -16430, -16800, -17167, -17531, -17892, -18249, -18604, -18956, -19304, -19649, -19990, -20329, -20663, -20994, -21322, -21646,
+    -21966, -22282, -22595, -22904, -23208, -23509, -23806, -24099, -24387, -24672, -24952, -25228, -25499, -25766, -26029, -26288,
+    -26541, -26791, -27035, -27275, -27511, -27741, -27967, -28188, -28405, -28616, -28823, -29024, -29221, -29412, -29599, -29780,
+    -29957, -30128, -30294, -30455, -30611, -30761, -30906, -31046, -31181, -31310, -31434, -31552, -31665, -31773, -31875, -31972,
+    -32063, -32149, -32229, -32304, -32373, -32437, -32495, -32547, -32594, -32635, -32671, -32701, -32726, -32745, -32758, -32766,
+    32767, 32754, 32717, 32658, 32577, 32473, 32348, 32200, 32029, 31837, 31624, 31388, 31131, 30853, 30553, 30232,
+    29891, 29530, 29148, 28746, 28324, 27883, 27423, 26944, 26447, 25931, 25398, 24847, 24279, 23695, 23095, 22478,
+    21846, 21199, 20538, 19863, 19174, 18472, 17757, 17030, 16291, 15541, 14781, 14010, 13230, 12441, 11643, 10837,
+    10024, 9204, 8377, 7545, 6708, 5866, 5020, 4171, 3319, 2464, 1608, 751, -107, -965, -1822, -2678,
+    -3532, -4383, -5232, -6077, -6918, -7754, -8585, -9409, -10228, -11039, -11843, -12639, -13426, -14204, -14972, -15730,
+    -16477, -17213, -17937, -18648, -19347, -20033, -20705, -21363, -22006, -22634, -23246, -23843, -24423, -24986, -25533, -26062,
+    -26573, -27066, -27540, -27995, -28431, -28848, -29245, -29622, -29979, -30315, -30630, -30924, -31197, -31449, -31679, -31887,
+    -32074, -32239, -32381, -32501, -32600, -32675, -32729, -32759};
+static const int16_t window120[CELT_OVERLAP] = { // power complementary window of the overlap Q15
+    2, 20, 55, 108, 178, 266, 372, 494, 635, 792, 966, 1157, 1365, 1590, 1831, 2089,
+    2362, 2651, 2956, 3276, 3611, 3961, 4325, 4703, 5094, 5499, 5916, 6346, 6788, 7241, 7705, 8179,
+    8663, 9156, 9657, 10167, 10684, 11207, 11736, 12271, 12810, 13353, 13899, 14447, 14997, 15547, 16098, 16648,
+    17197, 17744, 18287, 18827, 19363, 19893, 20418, 20936, 21447, 21950, 22445, 22931, 23407, 23874, 24330, 24774,
+    25208, 25629, 26039, 26435, 26819, 27190, 27548, 27893, 28224, 28541, 28845, 29135, 29411, 29674, 29924, 30160,
+    30384, 30594, 30792, 30977, 31151, 31313, 31463, 31602, 31731, 31849, 31958, 32057, 32148, 32229, 32303, 32370,
+    32429, 32481, 32528, 32568, 32604, 32634, 32661, 32683, 32701, 32717, 32729, 32740, 32748, 32754, 32758, 32762,
+    32764, 32766, 32767, 32767, 32767, 32767, 32767, 32767};
+//----------------------------------------------------------------------------------------------------------------------
+//          R A N G E   D E C O D E R
+//----------------------------------------------------------------------------------------------------------------------
+static inline int ec_ilog(uint32_t x) { return x ? 32 - __builtin_clz(x) : 0; }
+static inline int celt_ilog2(int32_t x) { return 31 - __builtin_clz((uint32_t)x); }
+
+static int ec_read_byte(ecDec_t *d) {
+    return d->offs < d->storage ? d->buf[d->offs++] : 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ec_read_byte_from_end(ecDec_t *d) {
+    return d->end_offs < d->storage ? d->buf[d->storage - ++(d->end_offs)] : 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void ec_dec_normalize(ecDec_t *d) {
+    while(d->rng <= EC_CODE_BOT) {
+        d->nbits_total += EC_SYM_BITS;
+        d->rng <<= EC_SYM_BITS;
+        int sym = d->rem;
+        d->rem = ec_read_byte(d);
+        sym = (sym << EC_SYM_BITS | d->rem) >> (EC_SYM_BITS - EC_CODE_EXTRA);
+        d->val = ((d->val << EC_SYM_BITS) + (EC_SYM_MAX & ~sym)) & (EC_CODE_TOP - 1);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void ec_dec_init(ecDec_t *d, const uint8_t *buf, uint32_t storage) {
+    d->buf = buf;
+    d->storage = storage;
+    d->end_offs = 0;
+    d->end_window = 0;
+    d->nend_bits = 0;
+    d->nbits_total = EC_CODE_BITS + 1 - ((EC_CODE_BITS - EC_CODE_EXTRA) / EC_SYM_BITS) * EC_SYM_BITS;
+    d->offs = 0;
+    d->rng = 1U << EC_CODE_EXTRA;
+    d->rem = ec_read_byte(d);
+    d->val = d->rng - 1 - (d->rem >> (EC_SYM_BITS - EC_CODE_EXTRA));
+    d->error = 0;
+    ec_dec_normalize(d);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned ec_decode(ecDec_t *d, unsigned ft) {
+    d->ext = d->rng / ft;
+    unsigned s = (unsigned)(d->val / d->ext);
+    return ft - IMIN(s + 1, ft);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned ec_decode_bin(ecDec_t *d, unsigned bits) {
+    d->ext = d->rng >> bits;
+    unsigned s = (unsigned)(d->val / d->ext);
+    return (1U << bits) - IMIN(s + 1U, 1U << bits);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void ec_dec_update(ecDec_t *d, unsigned fl, unsigned fh, unsigned ft) {
+    uint32_t s = d->ext * (ft - fh);
+    d->val -= s;
+    d->rng = fl > 0 ? d->ext * (fh - fl) : d->rng - s;
+    ec_dec_normalize(d);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ec_dec_bit_logp(ecDec_t *d, unsigned logp) {
+    uint32_t r = d->rng;
+    uint32_t v = d->val;
+    uint32_t s = r >> logp;
+    int ret = v < s;
+    if(!ret) d->val = v - s;
+    d->rng = ret ? s : r - s;
+    ec_dec_normalize(d);
+    return ret;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ec_dec_icdf(ecDec_t *d, const uint8_t *icdf, unsigned ftb) {
+    uint32_t s = d->rng;
+    uint32_t v = d->val;
+    uint32_t r = s >> ftb;
+    uint32_t t;
+    int ret = -1;
+    do {
+        t = s;
+        s = r * icdf[++ret];
+    } while(v < s);
+    d->val = v - s;
+    d->rng = t - s;
+    ec_dec_normalize(d);
+    return ret;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t ec_dec_bits(ecDec_t *d, unsigned bits) {
+    uint32_t window = d->end_window;
+    int available = d->nend_bits;
+    if((unsigned)available < bits) {
+        do {
+            window |= (uint32_t)ec_read_byte_from_end(d) << available;
+            available += EC_SYM_BITS;
+        } while(available <= EC_WINDOW_SIZE - EC_SYM_BITS);
+    }
+    uint32_t ret = window & (((uint32_t)1 << bits) - 1U);
+    window >>= bits;
+    available -= bits;
+    d->end_window = window;
+    d->nend_bits = available;
+    d->nbits_total += bits;
+    return ret;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t ec_dec_uint(ecDec_t *d, uint32_t ft) {
+    ft--;
+    int ftb = ec_ilog(ft);
+    if(ftb > EC_UINT_BITS) {
+        ftb -= EC_UINT_BITS;
+        unsigned ft1 = (unsigned)(ft >> ftb) + 1;
+        unsigned s = ec_decode(d, ft1);
+        ec_dec_update(d, s, s + 1, ft1);
+        uint32_t t = (uint32_t)s << ftb | ec_dec_bits(d, ftb);
+        if(t <= ft) return t;
+        d->error = 1;
+        return ft;
+    }
+    ft++;
+    unsigned s = ec_decode(d, (unsigned)ft);
+    ec_dec_update(d, s, s + 1, (unsigned)ft);
+    return s;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int ec_tell(ecDec_t *d) {
+    return d->nbits_total - ec_ilog(d->rng);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t ec_tell_frac(ecDec_t *d) {
+    uint32_t nbits = d->nbits_total << BITRES;
+    int l = ec_ilog(d->rng);
+    uint32_t r = d->rng >> (l - 16);
+    for(int i = BITRES; i-- > 0;) {
+        r = r * r >> 15;
+        int b = (int)(r >> 16);
+        l = l << 1 | b;
+        r >>= b;
+    }
+    return nbits - l;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ec_laplace_decode(ecDec_t *d, unsigned fs, int decay) {
+    int val = 0;
+    unsigned fm = ec_decode_bin(d, 15);
+    unsigned fl = 0;
+    if(fm >= fs) {
+        val++;
+        fl = fs;
+        fs = ((32768 - 2 * 16 - fs) * (int32_t)(16384 - decay) >> 15) + 1;
+        while(fs > 1 && fm >= fl + 2 * fs) {        // the decaying part of the PDF
+            fs *= 2;
+            fl += fs;
+            fs = ((fs - 2) * (int32_t)decay) >> 15;
+            fs += 1;
+            val++;
+        }
+        if(fs <= 1) {                               // everything beyond has the minimum probability
+            int di = (fm - fl) >> 1;
+            val += di;
+            fl += 2 * di;
+        }
+        if(fm < fl + fs) val = -val;
+        else fl += fs;
+    }
+    ec_dec_update(d, fl, IMIN(fl + fs, 32768), 32768);
+    return val;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          M A T H
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t MULT32_32_Q31(int32_t a, int32_t b) { // as fixed_generic.h, without the low x low product
+    return (int32_t)(((int32_t)(int16_t)(a >> 16) * (int32_t)(int16_t)(b >> 16)) << 1)
+         + (((int32_t)(int16_t)(a >> 16) * (int32_t)(b & 0xFFFF)) >> 15)
+         + (((int32_t)(int16_t)(b >> 16) * (int32_t)(a & 0xFFFF)) >> 15);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int16_t celt_rsqrt_norm(int32_t x) {         // Q16 x in [0.25,1) -> Q14 1/sqrt(x)
+    int16_t n = x - 32768;
+    int16_t r = ADD16(23557, MULT16_16_Q15(n, ADD16(-13490, MULT16_16_Q15(n, 6713))));
+    int16_t r2 = MULT16_16_Q15(r, r);
+    int16_t y = (int16_t)(SUB16(ADD16(MULT16_16_Q15(r2, n), r2), 16384) << 1);
+    return ADD16(r, MULT16_16_Q15(r, MULT16_16_Q15(y, SUB16(MULT16_16_Q15(y, 12288), 16384))));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t celt_rcp(int32_t x) {
+    int i = celt_ilog2(x);
+    int16_t n = VSHR32(x, i - 15) - 32768;
+    int16_t r = ADD16(30840, MULT16_16_Q15(-15420, n));
+    r = SUB16(r, MULT16_16_Q15(r, ADD16(MULT16_16_Q15(r, n), ADD16(r, -32768))));
+    r = SUB16(r, ADD16(1, MULT16_16_Q15(r, ADD16(MULT16_16_Q15(r, n), ADD16(r, -32768)))));
+    return VSHR32((int32_t)r, i - 16);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t celt_div(int32_t a, int32_t b) { return MULT32_32_Q31(a, celt_rcp(b)); }
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t celt_sqrt(int32_t x) {
+    static const int16_t C[5] = {23175, 11561, -3011, 1699, -664};
+    if(x == 0) return 0;
+    if(x >= 1073741824) return 32767;
+    int k = (celt_ilog2(x) >> 1) - 7;
+    x = VSHR32(x, 2 * k);
+    int16_t n = x - 32768;
+    int32_t rt = ADD16(C[0], MULT16_16_Q15(n, ADD16(C[1], MULT16_16_Q15(n, ADD16(C[2],
+                 MULT16_16_Q15(n, ADD16(C[3], MULT16_16_Q15(n, (C[4])))))))));
+    return VSHR32(rt, 7 - k);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int16_t celt_cos_pi_2(int16_t x) {
+    int16_t x2 = MULT16_16_P15(x, x);
+    return ADD16(1, IMIN(32766, (int32_t)SUB16(32767, x2) + MULT16_16_P15(x2, -7651 + MULT16_16_P15(x2,
+                 8277 + MULT16_16_P15(-626, x2)))));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int16_t celt_cos_norm(int32_t x) {
+    x = x & 0x0001ffff;
+    if(x > (1 << 16)) x = (1 << 17) - x;
+    if(x & 0x00007fff) {
+        if(x < (1 << 15)) return celt_cos_pi_2((int16_t)x);
+        return -celt_cos_pi_2((int16_t)(65536 - x));
+    }
+    if(x & 0x0000ffff) return 0;
+    if(x & 0x0001ffff) return -32767;
+    return 32767;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t celt_exp2_frac(int16_t x) {   // Q10 fraction -> Q14
+    int16_t frac = x << 4;
+    return ADD16(16383, MULT16_16_Q15(frac, ADD16(22804, MULT16_16_Q15(frac, ADD16(14819, MULT16_16_Q15(10204, frac))))));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t celt_exp2(int16_t x) {               // Q10 -> Q16
+    int integer = x >> 10;
+    if(integer > 14) return 0x7f000000;
+    if(integer < -15) return 0;
+    int16_t frac = celt_exp2_frac(x - (integer << 10));
+    return VSHR32((int32_t)frac, -integer - 2);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int16_t bitexact_cos(int16_t x) {
+    int32_t tmp = (4096 + ((int32_t)(x) * (x))) >> 13;
+    int16_t x2 = tmp;
+    x2 = (32767 - x2) + FRAC_MUL16(x2, (-7651 + FRAC_MUL16(x2, (8277 + FRAC_MUL16(-626, x2)))));
+    return 1 + x2;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int bitexact_log2tan(int isin, int icos) {
+    int lc = ec_ilog(icos);
+    int ls = ec_ilog(isin);
+    icos <<= 15 - lc;
+    isin <<= 15 - ls;
+    return (ls - lc) * (1 << 11) + FRAC_MUL16(isin, FRAC_MUL16(isin, -2597) + 7932)
+                                 - FRAC_MUL16(icos, FRAC_MUL16(icos, -2597) + 7932);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned isqrt32(uint32_t val) {
+    unsigned g = 0;
+    int bshift = (ec_ilog(val) - 1) >> 1;
+    unsigned b = 1U << bshift;
+    do {
+        uint32_t t = (((uint32_t)g << 1) + b) << bshift;
+        if(t <= val) {
+            g += b;
+            val -= t;
+        }
+        b >>= 1;
+        bshift--;
+    } while(bshift >= 0);
+    return g;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline uint32_t celt_lcg_rand(uint32_t seed) { return 1664525 * seed + 1013904223; }
+//----------------------------------------------------------------------------------------------------------------------
+//          E N E R G Y
+//----------------------------------------------------------------------------------------------------------------------
+static void unquant_coarse_energy(int end, int16_t *oldEBands, int intra, ecDec_t *dec, int C, int LM) {
+    static const uint8_t small_energy_icdf[3] = {2, 1, 0};
+    const uint8_t *prob_model = e_prob_model[LM][intra];
+    int32_t prev[2] = {0, 0};
+    int16_t coef, beta;
+    if(intra) {
+        coef = 0;
+        beta = 4915;                                // beta_intra
+    }
+    else {
+        beta = beta_coef[LM];
+        coef = pred_coef[LM];
+    }
+    int32_t budget = dec->storage * 8;
+    for(int i = 0; i < end; i++) {                  // a fixed coarse resolution of 6dB
+        int c = 0;
+        do {
+            int qi;
+            int32_t tell = ec_tell(dec);
+            if(budget - tell >= 15) {
+                int pi = 2 * IMIN(i, 20);
+                qi = ec_laplace_decode(dec, prob_model[pi] << 7, prob_model[pi + 1] << 6);
+            }
+            else if(budget - tell >= 2) {
+                qi = ec_dec_icdf(dec, small_energy_icdf, 2);
+                qi = (qi >> 1) ^ -(qi & 1);
+            }
+            else if(budget - tell >= 1) {
+                qi = -ec_dec_bit_logp(dec, 1);
+            }
+            else qi = -1;
+            int32_t q = (int32_t)qi << DB_SHIFT;
+            int16_t *e = &oldEBands[i + c * CELT_NBANDS];
+            *e = IMAX(-(9 << DB_SHIFT), *e);
+            int32_t tmp = PSHR32(MULT16_16(coef, *e), 8) + prev[c] + (q << 7);
+            tmp = IMAX(-(28 << (DB_SHIFT + 7)), tmp);
+            *e = PSHR32(tmp, 7);
+            prev[c] = prev[c] + (q << 7) - MULT16_16(beta, PSHR32(q, 8));
+        } while(++c < C);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void unquant_fine_energy(int end, int16_t *oldEBands, const int *fine_quant, ecDec_t *dec, int C) {
+    for(int i = 0; i < end; i++) {
+        if(fine_quant[i] <= 0) continue;
+        int c = 0;
+        do {
+            int q2 = ec_dec_bits(dec, fine_quant[i]);
+            int16_t offset = (int16_t)((((int32_t)q2 << DB_SHIFT) + (1 << (DB_SHIFT - 1))) >> fine_quant[i]) - (1 << (DB_SHIFT - 1));
+            oldEBands[i + c * CELT_NBANDS] += offset;
+        } while(++c < C);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void unquant_energy_finalise(int end, int16_t *oldEBands, const int *fine_quant, const int *fine_priority,
+                                    int bits_left, ecDec_t *dec, int C) {
+    for(int prio = 0; prio < 2; prio++) {           // use up the remaining bits
+        for(int i = 0; i < end && bits_left >= C; i++) {
+            if(fine_quant[i] >= MAX_FINE_BITS || fine_priority[i] != prio) continue;
+            int c = 0;
+            do {
+                int q2 = ec_dec_bits(dec, 1);
+                int16_t offset = (int16_t)(((q2 << DB_SHIFT) - (1 << (DB_SHIFT - 1))) >> (fine_quant[i] + 1));
+                oldEBands[i + c * CELT_NBANDS] += offset;
+                bits_left--;
+            } while(++c < C);
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void tf_decode(int end, int isTransient, int *tf_res, int LM, ecDec_t *dec) {
+    uint32_t budget = dec->storage * 8;
+    uint32_t tell = ec_tell(dec);
+    int logp = isTransient ? 2 : 4;
+    int tf_select_rsv = LM > 0 && tell + logp + 1 <= budget;
+    budget -= tf_select_rsv;
+    int tf_changed = 0, curr = 0;
+    for(int i = 0; i < end; i++) {
+        if(tell + logp <= budget) {
+            curr ^= ec_dec_bit_logp(dec, logp);
+            tell = ec_tell(dec);
+            tf_changed |= curr;
+        }
+        tf_res[i] = curr;
+        logp = isTransient ? 4 : 5;
+    }
+    int tf_select = 0;
+    if(tf_select_rsv && tf_select_table[LM][4 * isTransient + 0 + tf_changed] !=
+                        tf_select_table[LM][4 * isTransient + 2 + tf_changed]) {
+        tf_select = ec_dec_bit_logp(dec, 1);
+    }
+    for(int i = 0; i < end; i++) {
+        tf_res[i] = tf_select_table[LM][4 * isTransient + 2 * tf_select + tf_res[i]];
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          B I T   A L L O C A T I O N
+//----------------------------------------------------------------------------------------------------------------------
+static inline int get_pulses(int i) { return i < 8 ? i : (8 + (i & 7)) << ((i >> 3) - 1); }
+//----------------------------------------------------------------------------------------------------------------------
+static inline const uint8_t *pulse_cache(int band, int LM) {
+    return cache_bits50 + cache_index50[(LM + 1) * CELT_NBANDS + band];
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int bits2pulses(int band, int LM, int bits) {
+    const uint8_t *cache = pulse_cache(band, LM);
+    int lo = 0;
+    int hi = cache[0];
+    bits--;
+    for(int i = 0; i < LOG_MAX_PSEUDO; i++) {
+        int mid = (lo + hi + 1) >> 1;
+        if((int)cache[mid] >= bits) hi = mid;
+        else lo = mid;
+    }
+    if(bits - (lo == 0 ? -1 : (int)cache[lo]) <= (int)cache[hi] - bits) return lo;
+    return hi;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int pulses2bits(int band, int LM, int pulses) {
+    return pulses == 0 ? 0 : pulse_cache(band, LM)[pulses] + 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int interp_bits2pulses(int end, int skip_start, const int *bits1, const int *bits2, const int *thresh,
+                              const int *cap, int32_t total, int32_t *_balance, int skip_rsv, int *intensity,
+                              int intensity_rsv, int *dual_stereo, int dual_stereo_rsv, int *bits, int *ebits,
+                              int *fine_priority, int C, int LM, ecDec_t *ec) {
+    int alloc_floor = C << BITRES;
+    int stereo = C > 1;
+    int logM = LM << BITRES;
+    int lo = 0;
+    int hi = 1 << ALLOC_STEPS;
+    int32_t psum;
+    int done;
+    int j;
+    for(int i = 0; i < ALLOC_STEPS; i++) {
+        int mid = (lo + hi) >> 1;
+        psum = 0;
+        done = 0;
+        for(j = end; j-- > 0;) {
+            int tmp = bits1[j] + (mid * (int32_t)bits2[j] >> ALLOC_STEPS);
+            if(tmp >= thresh[j] || done) {
+                done = 1;
+                psum += IMIN(tmp, cap[j]);          // not more than we can actually use
+            }
+            else if(tmp >= alloc_floor) psum += alloc_floor;
+        }
+        if(psum > total) hi = mid;
+        else lo = mid;
+    }
+    psum = 0;
+    done = 0;
+    for(j = end; j-- > 0;) {
+        int tmp = bits1[j] + ((int32_t)lo * bits2[j] >> ALLOC_STEPS);
+        if(tmp < thresh[j] && !done) {
+            if(tmp >= alloc_floor) tmp = alloc_floor;
+            else tmp = 0;
+        }
+        else done = 1;
+        tmp = IMIN(tmp, cap[j]);
+        bits[j] = tmp;
+        psum += tmp;
+    }
+    int codedBands;                                 // the bands to skip, backwards from the end
+    for(codedBands = end;; codedBands--) {
+        j = codedBands - 1;
+        if(j <= skip_start) {                       // never the first band, nor a band boosted by dynalloc
+            total += skip_rsv;
+            break;
+        }
+        int32_t left = total - psum;
+        int32_t percoeff = left / (eband5ms[codedBands] - eband5ms[0]);
+        left -= (eband5ms[codedBands] - eband5ms[0]) * percoeff;
+        int rem = IMAX(left - (eband5ms[j] - eband5ms[0]), 0);
+        int band_width = eband5ms[codedBands] - eband5ms[j];
+        int band_bits = (int)(bits[j] + percoeff * band_width + rem);
+        if(band_bits >= IMAX(thresh[j], alloc_floor + (1 << BITRES))) {
+            if(ec_dec_bit_logp(ec, 1)) break;
+            psum += 1 << BITRES;
+            band_bits -= 1 << BITRES;
+        }
+        psum -= bits[j] + intensity_rsv;
+        if(intensity_rsv > 0) intensity_rsv = LOG2_FRAC_TABLE[j];
+        psum += intensity_rsv;
+        if(band_bits >= alloc_floor) {              // a fine energy bit per channel
+            psum += alloc_floor;
+            bits[j] = alloc_floor;
+        }
+        else bits[j] = 0;
+    }
+    if(intensity_rsv > 0) *intensity = ec_dec_uint(ec, codedBands + 1);
+    else *intensity = 0;
+    if(*intensity <= 0) {
+        total += dual_stereo_rsv;
+        dual_stereo_rsv = 0;
+    }
+    if(dual_stereo_rsv > 0) *dual_stereo = ec_dec_bit_logp(ec, 1);
+    else *dual_stereo = 0;
+
+    int32_t left = total - psum;                    // the remaining bits
+    int32_t percoeff = left / (eband5ms[codedBands] - eband5ms[0]);
+    left -= (eband5ms[codedBands] - eband5ms[0]) * percoeff;
+    for(j = 0; j < codedBands; j++) bits[j] += ((int)percoeff * (eband5ms[j + 1] - eband5ms[j]));
+    for(j = 0; j < codedBands; j++) {
+        int tmp = (int)IMIN(left, eband5ms[j + 1] - eband5ms[j]);
+        bits[j] += tmp;
+        left -= tmp;
+    }
+    int32_t balance = 0;
+    for(j = 0; j < codedBands; j++) {
+        int N0 = eband5ms[j + 1] - eband5ms[j];
+        int N = N0 << LM;
+        int32_t bit = (int32_t)bits[j] + balance;
+        int32_t excess;
+        if(N > 1) {
+            excess = IMAX(bit - cap[j], 0);
+            bits[j] = bit - excess;
+            int den = (C * N + ((C == 2 && N > 2 && !*dual_stereo && j < *intensity) ? 1 : 0));
+            int NClogN = den * (logN400[j] + logM);
+            int offset = (NClogN >> 1) - den * FINE_OFFSET;
+            if(N == 2) offset += den << BITRES >> 2;
+            if(bits[j] + offset < den * 2 << BITRES) offset += NClogN >> 2;
+            else if(bits[j] + offset < den * 3 << BITRES) offset += NClogN >> 3;
+            ebits[j] = IMAX(0, (bits[j] + offset + (den << (BITRES - 1))));
+            ebits[j] = (ebits[j] / den) >> BITRES;
+            if(C * ebits[j] > (bits[j] >> BITRES)) ebits[j] = bits[j] >> stereo >> BITRES;
+            ebits[j] = IMIN(ebits[j], MAX_FINE_BITS);
+            fine_priority[j] = ebits[j] * (den << BITRES) >= bits[j] + offset;
+            bits[j] -= C * ebits[j] << BITRES;
+        }
+        else {                                      // N=1: all bits to fine energy except a sign bit
+            excess = IMAX(0, bit - (C << BITRES));
+            bits[j] = bit - excess;
+            ebits[j] = 0;
+            fine_priority[j] = 1;
+        }
+        if(excess > 0) {                            // rebalance the fine energy here
+            int extra_fine = IMIN(excess >> (stereo + BITRES), MAX_FINE_BITS - ebits[j]);
+            ebits[j] += extra_fine;
+            int extra_bits = extra_fine * C << BITRES;
+            fine_priority[j] = extra_bits >= excess - balance;
+            excess -= extra_bits;
+        }
+        balance = excess;
+    }
+    *_balance = balance;
+    for(; j < end; j++) {                           // the skipped bands use all their bits for fine energy
+        ebits[j] = bits[j] >> stereo >> BITRES;
+        bits[j] = 0;
+        fine_priority[j] = ebits[j] < 1;
+    }
+    return codedBands;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int clt_compute_allocation(int end, const int *offsets, const int *cap, int alloc_trim, int *intensity,
+                                  int *dual_stereo, int32_t total, int32_t *balance, int *pulses, int *ebits,
+                                  int *fine_priority, int C, int LM, ecDec_t *ec) {
+    int bits1[CELT_NBANDS], bits2[CELT_NBANDS], thresh[CELT_NBANDS], trim_offset[CELT_NBANDS];
+    total = IMAX(total, 0);
+    int skip_start = 0;
+    int skip_rsv = total >= 1 << BITRES ? 1 << BITRES : 0;  // a bit to signal the end of skipped bands
+    total -= skip_rsv;
+    int intensity_rsv = 0, dual_stereo_rsv = 0;
+    if(C == 2) {
+        intensity_rsv = LOG2_FRAC_TABLE[end];
+        if(intensity_rsv > total) intensity_rsv = 0;
+        else {
+            total -= intensity_rsv;
+            dual_stereo_rsv = total >= 1 << BITRES ? 1 << BITRES : 0;
+            total -= dual_stereo_rsv;
+        }
+    }
+    for(int j = 0; j < end; j++) {
+        int N0 = eband5ms[j + 1] - eband5ms[j];
+        thresh[j] = IMAX((C) << BITRES, (3 * N0 << LM << BITRES) >> 4);
+        trim_offset[j] = C * N0 * (alloc_trim - 5 - LM) * (end - j - 1) * (1 << (LM + BITRES)) >> 6;
+        if(N0 << LM == 1) trim_offset[j] -= C << BITRES;
+    }
+    int lo = 1;
+    int hi = 11 - 1;                                // nbAllocVectors - 1
+    do {
+        int done = 0;
+        int psum = 0;
+        int mid = (lo + hi) >> 1;
+        for(int j = end; j-- > 0;) {
+            int N = eband5ms[j + 1] - eband5ms[j];
+            int bitsj = C * N * band_allocation[mid * CELT_NBANDS + j] << LM >> 2;
+            if(bitsj > 0) bitsj = IMAX(0, bitsj + trim_offset[j]);
+            bitsj += offsets[j];
+            if(bitsj >= thresh[j] || done) {
+                done = 1;
+                psum += IMIN(bitsj, cap[j]);
+            }
+            else if(bitsj >= C << BITRES) psum += C << BITRES;
+        }
+        if(psum > total) hi = mid - 1;
+        else lo = mid + 1;
+    } while(lo <= hi);
+    hi = lo--;
+    for(int j = 0; j < end; j++) {
+        int N = eband5ms[j + 1] - eband5ms[j];
+        int bits1j = C * N * band_allocation[lo * CELT_NBANDS + j] << LM >> 2;
+        int bits2j = hi >= 11 ? cap[j] : C * N * band_allocation[hi * CELT_NBANDS + j] << LM >> 2;
+        if(bits1j > 0) bits1j = IMAX(0, bits1j + trim_offset[j]);
+        if(bits2j > 0) bits2j = IMAX(0, bits2j + trim_offset[j]);
+        if(lo > 0) bits1j += offsets[j];
+        bits2j += offsets[j];
+        if(offsets[j] > 0) skip_start = j;
+        bits2j = IMAX(0, bits2j - bits1j);
+        bits1[j] = bits1j;
+        bits2[j] = bits2j;
+    }
+    return interp_bits2pulses(end, skip_start, bits1, bits2, thresh, cap, total, balance, skip_rsv, intensity,
+                              intensity_rsv, dual_stereo, dual_stereo_rsv, pulses, ebits, fine_priority, C, LM, ec);
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          P V Q
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t decode_pulses(int *y, int n, int k, ecDec_t *dec) {
+    // the codeword index is uniform over V(n,k), the number of vectors of n integers with k pulses;
+    // u[m] = V(n-1-j, m) while the coordinates j are decoded, RFC 6716 section 4.3.4.2
+    uint32_t u[MAX_PULSES + 2];
+    u[0] = 1;
+    for(int m = 1; m <= k; m++) u[m] = 0;           // V(0,m)
+    for(int r = 1; r < n; r++) {                    // up to V(n-1,m)
+        uint32_t oldPrev = u[0];
+        for(int m = 1; m <= k; m++) {
+            uint32_t o = u[m];
+            u[m] = o + oldPrev + u[m - 1];
+            oldPrev = o;
+        }
+    }
+    uint32_t total = u[k];
+    for(int m = 0; m < k; m++) total += 2 * u[m];   // V(n,k)
+    uint32_t i = ec_dec_uint(dec, total);
+    int32_t yy = 0;
+    for(int j = 0; j < n; j++) {
+        uint32_t s = 0;                             // vectors with y[j] >= 0
+        for(int m = 0; m <= k; m++) s += u[m];
+        int sgn = 1;
+        if(i >= s) {
+            sgn = -1;
+            i -= s;
+        }
+        uint32_t p = s - u[k];                      // vectors with |y[j]| > 0 of this sign
+        int k0 = k;
+        while(p > i) {
+            k--;
+            p -= u[k];
+        }
+        i -= p;
+        y[j] = sgn * (k0 - k);
+        yy += (k0 - k) * (k0 - k);
+        if(j + 1 < n) {                             // V(n-1-j,m) -> V(n-2-j,m)
+            uint32_t oldPrev = u[0];
+            for(int m = 1; m <= k; m++) {
+                uint32_t o = u[m];
+                u[m] = o - oldPrev - u[m - 1];
+                oldPrev = o;
+            }
+        }
+    }
+    return yy;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void exp_rotation1(int16_t *X, int len, int stride, int16_t c, int16_t s) {
+    int16_t ms = -s;
+    int16_t *Xptr = X;
+    for(int i = 0; i < len - stride; i++) {
+        int16_t x1 = Xptr[0];
+        int16_t x2 = Xptr[stride];
+        Xptr[stride] = (int16_t)PSHR32(MULT16_16(c, x2) + MULT16_16(s, x1), 15);
+        *Xptr++      = (int16_t)PSHR32(MULT16_16(c, x1) + MULT16_16(ms, x2), 15);
+    }
+    Xptr = &X[len - 2 * stride - 1];
+    for(int i = len - 2 * stride - 1; i >= 0; i--) {
+        int16_t x1 = Xptr[0];
+        int16_t x2 = Xptr[stride];
+        Xptr[stride] = (int16_t)PSHR32(MULT16_16(c, x2) + MULT16_16(s, x1), 15);
+        *Xptr--      = (int16_t)PSHR32(MULT16_16(c, x1) + MULT16_16(ms, x2), 15);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void exp_rotation(int16_t *X, int len, int stride, int K, int spread) { // spreading, decoder direction
+    static const int SPREAD_FACTOR[3] = {15, 10, 5};
+    if(2 * K >= len || spread == SPREAD_NONE) return;
+    int factor = SPREAD_FACTOR[spread - 1];
+    int16_t gain = celt_div((int32_t)MULT16_16(Q15ONE, len), (int32_t)(len + factor * K));
+    int16_t theta = MULT16_16_Q15(gain, gain) >> 1;
+    int16_t c = celt_cos_norm((int32_t)theta);
+    int16_t s = celt_cos_norm((int32_t)SUB16(Q15ONE, theta));
+    int stride2 = 0;
+    if(len >= 8 * stride) {
+        stride2 = 1;                                // sqrt(len/stride) with rounding
+        while((stride2 * stride2 + stride2) * stride + (stride >> 2) < len) stride2++;
+    }
+    len = len / stride;
+    for(int i = 0; i < stride; i++) {
+        if(stride2) exp_rotation1(X + i * len, len, stride2, s, c);
+        exp_rotation1(X + i * len, len, 1, c, s);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void renormalise_vector(int16_t *X, int N, int16_t gain) {
+    int32_t E = 1;
+    for(int i = 0; i < N; i++) E += MULT16_16(X[i], X[i]);
+    int k = celt_ilog2(E) >> 1;
+    int32_t t = VSHR32(E, 2 * (k - 7));
+    int16_t g = MULT16_16_P15(celt_rsqrt_norm(t), gain);
+    for(int i = 0; i < N; i++) X[i] = (int16_t)PSHR32(MULT16_16(g, X[i]), k + 1);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned alg_unquant(int16_t *X, int N, int K, int spread, int B, ecDec_t *dec, int16_t gain) {
+    int iy[MAX_BAND];
+    int32_t Ryy = decode_pulses(iy, N, K, dec);
+    int k = celt_ilog2(Ryy) >> 1;                   // normalise the residual
+    int32_t t = VSHR32(Ryy, 2 * (k - 7));
+    int16_t g = MULT16_16_P15(celt_rsqrt_norm(t), gain);
+    for(int i = 0; i < N; i++) X[i] = (int16_t)PSHR32(MULT16_16(g, iy[i]), k + 1);
+    exp_rotation(X, N, B, K, spread);
+    if(B <= 1) return 1;
+    unsigned collapse_mask = 0;                     // blocks with pulses
+    int N0 = N / B;
+    for(int i = 0; i < B; i++) {
+        int tmp = 0;
+        for(int j = 0; j < N0; j++) tmp |= iy[i * N0 + j];
+        collapse_mask |= (unsigned)(tmp != 0) << i;
+    }
+    return collapse_mask;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void anti_collapse(int16_t *X_, const uint8_t *collapse_masks, int LM, int C, int size, int end,
+                          const int16_t *logE, const int16_t *prev1logE, const int16_t *prev2logE,
+                          const int *pulses, uint32_t seed) {
+    for(int i = 0; i < end; i++) {
+        int N0 = eband5ms[i + 1] - eband5ms[i];
+        int depth = ((1 + pulses[i]) / N0) >> LM;   // in 1/8 bits
+        int32_t thresh32 = celt_exp2(-(depth << (10 - BITRES))) >> 1;
+        int16_t thresh = MULT16_32_Q15(16384, IMIN(32767, thresh32));
+        int32_t t = N0 << LM;
+        int shift = celt_ilog2(t) >> 1;
+        t = t << ((7 - shift) << 1);
+        int16_t sqrt_1 = celt_rsqrt_norm(t);
+        int c = 0;
+        do {
+            int16_t prev1 = prev1logE[c * CELT_NBANDS + i];
+            int16_t prev2 = prev2logE[c * CELT_NBANDS + i];
+            if(C == 1) {
+                prev1 = IMAX(prev1, prev1logE[CELT_NBANDS + i]);
+                prev2 = IMAX(prev2, prev2logE[CELT_NBANDS + i]);
+            }
+            int32_t Ediff = (int32_t)logE[c * CELT_NBANDS + i] - IMIN(prev1, prev2);
+            Ediff = IMAX(0, Ediff);
+            int16_t r;
+            if(Ediff < 16384) {
+                int32_t r32 = celt_exp2(-(int16_t)Ediff) >> 1;
+                r = 2 * IMIN(16383, r32);
+            }
+            else r = 0;
+            if(LM == 3) r = MULT16_16_Q14(23170, IMIN(23169, r));
+            r = IMIN(thresh, r) >> 1;
+            r = MULT16_16_Q15(sqrt_1, r) >> shift;
+            int16_t *X = X_ + c * size + (eband5ms[i] << LM);
+            bool renormalize = false;
+            for(int k = 0; k < 1 << LM; k++) {
+                if(!(collapse_masks[i * C + c] & 1 << k)) { // collapsed, fill with noise
+                    for(int j = 0; j < N0; j++) {
+                        seed = celt_lcg_rand(seed);
+                        X[(j << LM) + k] = (seed & 0x8000 ? r : -r);
+                    }
+                    renormalize = true;
+                }
+            }
+            if(renormalize) renormalise_vector(X, N0 << LM, Q15ONE);
+        } while(++c < C);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void stereo_merge(int16_t *X, int16_t *Y, int16_t mid, int N) {
+    int32_t xp = 0, side = 0;
+    for(int j = 0; j < N; j++) {
+        xp += MULT16_16(Y[j], X[j]);
+        side += MULT16_16(Y[j], Y[j]);
+    }
+    xp = MULT16_32_Q15(mid, xp);                    // compensate the mid normalisation
+    int16_t mid2 = mid >> 1;
+    int32_t El = MULT16_16(mid2, mid2) + side - 2 * xp;
+    int32_t Er = MULT16_16(mid2, mid2) + side + 2 * xp;
+    if(Er < 161061 || El < 161061) {                // 6e-4 Q28
+        memcpy(Y, X, N * sizeof(int16_t));
+        return;
+    }
+    int kl = celt_ilog2(El) >> 1;
+    int kr = celt_ilog2(Er) >> 1;
+    int16_t lgain = celt_rsqrt_norm(VSHR32(El, (kl - 7) << 1));
+    int16_t rgain = celt_rsqrt_norm(VSHR32(Er, (kr - 7) << 1));
+    if(kl < 7) kl = 7;
+    if(kr < 7) kr = 7;
+    for(int j = 0; j < N; j++) {
+        int16_t l = MULT16_16_P15(mid, X[j]);       // the side is already scaled
+        int16_t r = Y[j];
+        X[j] = (int16_t)PSHR32(MULT16_16(lgain, SUB16(l, r)), kl + 1);
+        Y[j] = (int16_t)PSHR32(MULT16_16(rgain, ADD16(l, r)), kr + 1);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void haar1(int16_t *X, int N0, int stride) {
+    N0 >>= 1;
+    for(int i = 0; i < stride; i++) {
+        for(int j = 0; j < N0; j++) {
+            int32_t tmp1 = MULT16_16(23170, X[stride * 2 * j + i]);
+            int32_t tmp2 = MULT16_16(23170, X[stride * (2 * j + 1) + i]);
+            X[stride * 2 * j + i] = (int16_t)PSHR32(tmp1 + tmp2, 15);
+            X[stride * (2 * j + 1) + i] = (int16_t)PSHR32(tmp1 - tmp2, 15);
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void deinterleave_hadamard(int16_t *X, int N0, int stride, int hadamard) {
+    int16_t tmp[MAX_BAND];
+    int N = N0 * stride;
+    if(hadamard) {
+        const int8_t *ordery = ordery_table + stride - 2;
+        for(int i = 0; i < stride; i++)
+            for(int j = 0; j < N0; j++) tmp[ordery[i] * N0 + j] = X[j * stride + i];
+    }
+    else {
+        for(int i = 0; i < stride; i++)
+            for(int j = 0; j < N0; j++) tmp[i * N0 + j] = X[j * stride + i];
+    }
+    memcpy(X, tmp, N * sizeof(int16_t));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void interleave_hadamard(int16_t *X, int N0, int stride, int hadamard) {
+    int16_t tmp[MAX_BAND];
+    int N = N0 * stride;
+    if(hadamard) {
+        const int8_t *ordery = ordery_table + stride - 2;
+        for(int i = 0; i < stride; i++)
+            for(int j = 0; j < N0; j++) tmp[j * stride + i] = X[ordery[i] * N0 + j];
+    }
+    else {
+        for(int i = 0; i < stride; i++)
+            for(int j = 0; j < N0; j++) tmp[j * stride + i] = X[i * N0 + j];
+    }
+    memcpy(X, tmp, N * sizeof(int16_t));
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          B A N D S
+//----------------------------------------------------------------------------------------------------------------------
+static int compute_qn(int N, int b, int offset, int pulse_cap, int stereo) {
+    static const int16_t exp2_table8[8] = {16384, 17866, 19483, 21247, 23170, 25267, 27554, 30048};
+    int N2 = 2 * N - 1;
+    if(stereo && N == 2) N2--;
+    int qb = (b + N2 * offset) / N2;
+    qb = IMIN(b - pulse_cap - (4 << BITRES), qb);   // enough bits left for one pulse in the side
+    qb = IMIN(8 << BITRES, qb);
+    if(qb < (1 << BITRES >> 1)) return 1;
+    int qn = exp2_table8[qb & 0x7] >> (14 - (qb >> BITRES));
+    return (qn + 1) >> 1 << 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void compute_theta(bandCtx_t *ctx, splitCtx_t *sctx, int N, int *b, int B, int B0, int LM, int stereo, int *fill) {
+    ecDec_t *ec = ctx->ec;
+    int i = ctx->i;
+    int itheta = 0;
+    int inv = 0;
+    int pulse_cap = logN400[i] + LM * (1 << BITRES);
+    int offset = (pulse_cap >> 1) - (stereo && N == 2 ? QTHETA_OFFSET_TWOPHASE : QTHETA_OFFSET);
+    int qn = compute_qn(N, *b, offset, pulse_cap, stereo);
+    if(stereo && i >= ctx->intensity) qn = 1;
+    int32_t tell = ec_tell_frac(ec);
+    if(qn != 1) {
+        if(stereo && N > 2) {                       // step pdf
+            int p0 = 3;
+            int x0 = qn / 2;
+            int ft = p0 * (x0 + 1) + x0;
+            int x;
+            int fs = ec_decode(ec, ft);
+            if(fs < (x0 + 1) * p0) x = fs / p0;
+            else x = x0 + 1 + (fs - (x0 + 1) * p0);
+            ec_dec_update(ec, x <= x0 ? p0 * x : (x - 1 - x0) + (x0 + 1) * p0,
+                              x <= x0 ? p0 * (x + 1) : (x - x0) + (x0 + 1) * p0, ft);
+            itheta = x;
+        }
+        else if(B0 > 1 || stereo) {                 // uniform pdf
+            itheta = ec_dec_uint(ec, qn + 1);
+        }
+        else {                                      // triangular pdf
+            int fs, fl;
+            int ft = ((qn >> 1) + 1) * ((qn >> 1) + 1);
+            int fm = ec_decode(ec, ft);
+            if(fm < ((qn >> 1) * ((qn >> 1) + 1) >> 1)) {
+                itheta = (isqrt32(8 * (uint32_t)fm + 1) - 1) >> 1;
+                fs = itheta + 1;
+                fl = itheta * (itheta + 1) >> 1;
+            }
+            else {
+                itheta = (2 * (qn + 1) - isqrt32(8 * (uint32_t)(ft - fm - 1) + 1)) >> 1;
+                fs = qn + 1 - itheta;
+                fl = ft - ((qn + 1 - itheta) * (qn + 2 - itheta) >> 1);
+            }
+            ec_dec_update(ec, fl, fl + fs, ft);
+        }
+        itheta = (int32_t)itheta * 16384 / qn;
+    }
+    else if(stereo) {
+        if(*b > 2 << BITRES && ctx->remaining_bits > 2 << BITRES) inv = ec_dec_bit_logp(ec, 2);
+        if(ctx->disable_inv) inv = 0;               // no phase inversion for a mono downmix
+        itheta = 0;
+    }
+    int qalloc = ec_tell_frac(ec) - tell;
+    *b -= qalloc;
+    int imid, iside, delta;
+    if(itheta == 0) {
+        imid = 32767;
+        iside = 0;
+        *fill &= (1 << B) - 1;
+        delta = -16384;
+    }
+    else if(itheta == 16384) {
+        imid = 0;
+        iside = 32767;
+        *fill &= ((1 << B) - 1) << B;
+        delta = 16384;
+    }
+    else {
+        imid = bitexact_cos((int16_t)itheta);
+        iside = bitexact_cos((int16_t)(16384 - itheta));
+        delta = FRAC_MUL16((N - 1) << 7, bitexact_log2tan(iside, imid)); // mid/side allocation of least squared error
+    }
+    sctx->inv = inv;
+    sctx->imid = imid;
+    sctx->iside = iside;
+    sctx->delta = delta;
+    sctx->itheta = itheta;
+    sctx->qalloc = qalloc;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned quant_band_n1(bandCtx_t *ctx, int16_t *X, int16_t *Y, int16_t *lowband_out) {
+    int16_t *x = X;
+    int c = 0;
+    do {
+        int sign = 0;
+        if(ctx->remaining_bits >= 1 << BITRES) {
+            sign = ec_dec_bits(ctx->ec, 1);
+            ctx->remaining_bits -= 1 << BITRES;
+        }
+        x[0] = sign ? -NORM_SCALING : NORM_SCALING;
+        x = Y;
+    } while(++c < 1 + (Y != NULL));
+    if(lowband_out) lowband_out[0] = X[0] >> 4;
+    return 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned quant_partition(bandCtx_t *ctx, int16_t *X, int N, int b, int B, int16_t *lowband, int LM,
+                                int16_t gain, int fill) {
+    int B0 = B;
+    unsigned cm = 0;
+    int i = ctx->i;
+    const uint8_t *cache = pulse_cache(i, LM);
+    if(LM != -1 && b > cache[cache[0]] + 12 && N > 2) { // split the band in two if we need 1.5 more bits
+        splitCtx_t sctx;
+        int16_t *next_lowband2 = NULL;
+        N >>= 1;
+        int16_t *Y = X + N;
+        LM -= 1;
+        if(B == 1) fill = (fill & 1) | (fill << 1);
+        B = (B + 1) >> 1;
+        compute_theta(ctx, &sctx, N, &b, B, B0, LM, 0, &fill);
+        int16_t mid = sctx.imid;
+        int16_t side = sctx.iside;
+        int delta = sctx.delta;
+        int itheta = sctx.itheta;
+        if(B0 > 1 && (itheta & 0x3fff)) {           // more bits to low-energy MDCTs
+            if(itheta > 8192) delta -= delta >> (4 - LM);
+            else delta = IMIN(0, delta + (N << BITRES >> (5 - LM)));
+        }
+        int mbits = IMAX(0, IMIN(b, (b - delta) / 2));
+        int sbits = b - mbits;
+        ctx->remaining_bits -= sctx.qalloc;
+        if(lowband) next_lowband2 = lowband + N;
+        int32_t rebalance = ctx->remaining_bits;
+        if(mbits >= sbits) {
+            cm = quant_partition(ctx, X, N, mbits, B, lowband, LM, MULT16_16_P15(gain, mid), fill);
+            rebalance = mbits - (rebalance - ctx->remaining_bits);
+            if(rebalance > 3 << BITRES && itheta != 0) sbits += rebalance - (3 << BITRES);
+            cm |= quant_partition(ctx, Y, N, sbits, B, next_lowband2, LM, MULT16_16_P15(gain, side), fill >> B) << (B0 >> 1);
+        }
+        else {
+            cm = quant_partition(ctx, Y, N, sbits, B, next_lowband2, LM, MULT16_16_P15(gain, side), fill >> B) << (B0 >> 1);
+            rebalance = sbits - (rebalance - ctx->remaining_bits);
+            if(rebalance > 3 << BITRES && itheta != 16384) mbits += rebalance - (3 << BITRES);
+            cm |= quant_partition(ctx, X, N, mbits, B, lowband, LM, MULT16_16_P15(gain, mid), fill);
+        }
+        return cm;
+    }
+    int q = bits2pulses(i, LM, b);                  // the basic no-split case
+    int curr_bits = pulses2bits(i, LM, q);
+    ctx->remaining_bits -= curr_bits;
+    while(ctx->remaining_bits < 0 && q > 0) {       // never bust the budget
+        ctx->remaining_bits += curr_bits;
+        q--;
+        curr_bits = pulses2bits(i, LM, q);
+        ctx->remaining_bits -= curr_bits;
+    }
+    if(q != 0) return alg_unquant(X, N, get_pulses(q), ctx->spread, B, ctx->ec, gain);
+
+    unsigned cm_mask = (unsigned)(1UL << B) - 1;    // no pulse, fill the band anyway
+    fill &= cm_mask;
+    if(!fill) {
+        memset(X, 0, N * sizeof(int16_t));
+        return 0;
+    }
+    if(lowband == NULL) {                           // noise
+        for(int j = 0; j < N; j++) {
+            ctx->seed = celt_lcg_rand(ctx->seed);
+            X[j] = (int16_t)((int32_t)ctx->seed >> 20);
+        }
+        cm = cm_mask;
+    }
+    else {                                          // folded spectrum, about 48dB below the folding level
+        for(int j = 0; j < N; j++) {
+            ctx->seed = celt_lcg_rand(ctx->seed);
+            int16_t tmp = (ctx->seed) & 0x8000 ? 4 : -4;
+            X[j] = lowband[j] + tmp;
+        }
+        cm = fill;
+    }
+    renormalise_vector(X, N, gain);
+    return cm;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned quant_band(bandCtx_t *ctx, int16_t *X, int N, int b, int B, int16_t *lowband, int LM,
+                           int16_t *lowband_out, int16_t gain, int16_t *lowband_scratch, int fill) {
+    static const uint8_t bit_interleave_table[16] = {0, 1, 1, 1, 2, 3, 3, 3, 2, 3, 3, 3, 2, 3, 3, 3};
+    static const uint8_t bit_deinterleave_table[16] = {0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+                                                       0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+    int N0 = N;
+    int B0 = B;
+    int time_divide = 0;
+    int recombine = 0;
+    int longBlocks = B0 == 1;
+    int tf_change = ctx->tf_change;
+    int N_B = N / B;
+    if(N == 1) return quant_band_n1(ctx, X, NULL, lowband_out);
+    if(tf_change > 0) recombine = tf_change;
+    if(lowband_scratch && lowband && (recombine || ((N_B & 1) == 0 && tf_change < 0) || B0 > 1)) {
+        memcpy(lowband_scratch, lowband, N * sizeof(int16_t));
+        lowband = lowband_scratch;
+    }
+    for(int k = 0; k < recombine; k++) {            // band recombining, more frequency resolution
+        if(lowband) haar1(lowband, N >> k, 1 << k);
+        fill = bit_interleave_table[fill & 0xF] | bit_interleave_table[fill >> 4] << 2;
+    }
+    B >>= recombine;
+    N_B <<= recombine;
+    while((N_B & 1) == 0 && tf_change < 0) {        // more time resolution
+        if(lowband) haar1(lowband, N_B, B);
+        fill |= fill << B;
+        B <<= 1;
+        N_B >>= 1;
+        time_divide++;
+        tf_change++;
+    }
+    B0 = B;
+    int N_B0 = N_B;
+    if(B0 > 1 && lowband) deinterleave_hadamard(lowband, N_B >> recombine, B0 << recombine, longBlocks);
+
+    unsigned cm = quant_partition(ctx, X, N, b, B, lowband, LM, gain, fill);
+
+    if(B0 > 1) interleave_hadamard(X, N_B >> recombine, B0 << recombine, longBlocks);
+    N_B = N_B0;                                     // undo the time-frequency changes
+    B = B0;
+    for(int k = 0; k < time_divide; k++) {
+        B >>= 1;
+        N_B <<= 1;
+        cm |= cm >> B;
+        haar1(X, N_B, B);
+    }
+    for(int k = 0; k < recombine; k++) {
+        cm = bit_deinterleave_table[cm];
+        haar1(X, N0 >> k, 1 << k);
+    }
+    B <<= recombine;
+    if(lowband_out) {                               // scaled for the folding of the next bands
+        int16_t n = celt_sqrt((int32_t)N0 << 22);
+        for(int j = 0; j < N0; j++) lowband_out[j] = MULT16_16_Q15(n, X[j]);
+    }
+    cm &= (1 << B) - 1;
+    return cm;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static unsigned quant_band_stereo(bandCtx_t *ctx, int16_t *X, int16_t *Y, int N, int b, int B, int16_t *lowband,
+                                  int LM, int16_t *lowband_out, int16_t *lowband_scratch, int fill) {
+    unsigned cm = 0;
+    splitCtx_t sctx;
+    if(N == 1) return quant_band_n1(ctx, X, Y, lowband_out);
+    int orig_fill = fill;
+    compute_theta(ctx, &sctx, N, &b, B, B, LM, 1, &fill);
+    int16_t mid = sctx.imid;
+    int16_t side = sctx.iside;
+    int itheta = sctx.itheta;
+    int mbits, sbits;
+    if(N == 2) {                                    // mid and side are orthogonal, one bit for the side
+        int sign = 0;
+        mbits = b;
+        sbits = 0;
+        if(itheta != 0 && itheta != 16384) sbits = 1 << BITRES;
+        mbits -= sbits;
+        int c = itheta > 8192;
+        ctx->remaining_bits -= sctx.qalloc + sbits;
+        int16_t *x2 = c ? Y : X;
+        int16_t *y2 = c ? X : Y;
+        if(sbits) sign = ec_dec_bits(ctx->ec, 1);
+        sign = 1 - 2 * sign;
+        cm = quant_band(ctx, x2, N, mbits, B, lowband, LM, lowband_out, Q15ONE, lowband_scratch, orig_fill);
+        y2[0] = -sign * x2[1];
+        y2[1] = sign * x2[0];
+        X[0] = MULT16_16_Q15(mid, X[0]);
+        X[1] = MULT16_16_Q15(mid, X[1]);
+        Y[0] = MULT16_16_Q15(side, Y[0]);
+        Y[1] = MULT16_16_Q15(side, Y[1]);
+        int16_t tmp = X[0];
+        X[0] = SUB16(tmp, Y[0]);
+        Y[0] = ADD16(tmp, Y[0]);
+        tmp = X[1];
+        X[1] = SUB16(tmp, Y[1]);
+        Y[1] = ADD16(tmp, Y[1]);
+    }
+    else {
+        mbits = IMAX(0, IMIN(b, (b - sctx.delta) / 2));
+        sbits = b - mbits;
+        ctx->remaining_bits -= sctx.qalloc;
+        int32_t rebalance = ctx->remaining_bits;
+        if(mbits >= sbits) {                        // the mid is not scaled, it is needed normalised for the folding
+            cm = quant_band(ctx, X, N, mbits, B, lowband, LM, lowband_out, Q15ONE, lowband_scratch, fill);
+            rebalance = mbits - (rebalance - ctx->remaining_bits);
+            if(rebalance > 3 << BITRES && itheta != 0) sbits += rebalance - (3 << BITRES);
+            cm |= quant_band(ctx, Y, N, sbits, B, NULL, LM, NULL, side, NULL, fill >> B);
+        }
+        else {
+            cm = quant_band(ctx, Y, N, sbits, B, NULL, LM, NULL, side, NULL, fill >> B);
+            rebalance = sbits - (rebalance - ctx->remaining_bits);
+            if(rebalance > 3 << BITRES && itheta != 16384) mbits += rebalance - (3 << BITRES);
+            cm |= quant_band(ctx, X, N, mbits, B, lowband, LM, lowband_out, Q15ONE, lowband_scratch, fill);
+        }
+    }
+    if(N != 2) stereo_merge(X, Y, mid, N);
+    if(sctx.inv) {
+        for(int j = 0; j < N; j++) Y[j] = -Y[j];
+    }
+    return cm;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void quant_all_bands(CELTDecoder_t *st, int end, int16_t *X_, int16_t *Y_, uint8_t *collapse_masks,
+                            const int *pulses, int shortBlocks, int spread, int dual_stereo, int intensity,
+                            const int *tf_res, int32_t total_bits, int32_t balance, ecDec_t *ec, int LM,
+                            int codedBands, uint32_t *seed) {
+    int M = 1 << LM;
+    int B = shortBlocks ? M : 1;
+    int C = Y_ != NULL ? 2 : 1;
+    int lowband_offset = 0;
+    int update_lowband = 1;
+    int16_t *norm = st->norm;                       // start is always 0 here, no hybrid folding
+    int16_t *norm2 = norm + M * eband5ms[CELT_NBANDS - 1];
+    int16_t *lowband_scratch = X_ + M * eband5ms[CELT_NBANDS - 1]; // the last band is scratch until it is decoded
+    bandCtx_t ctx;
+    ctx.ec = ec;
+    ctx.intensity = intensity;
+    ctx.seed = *seed;
+    ctx.spread = spread;
+    ctx.disable_inv = st->channels == 1;
+    for(int i = 0; i < end; i++) {
+        int effective_lowband = -1;
+        unsigned x_cm, y_cm;
+        int b;
+        ctx.i = i;
+        int last = (i == end - 1);
+        int16_t *X = X_ + M * eband5ms[i];
+        int16_t *Y = Y_ != NULL ? Y_ + M * eband5ms[i] : NULL;
+        int N = M * eband5ms[i + 1] - M * eband5ms[i];
+        int32_t tell = ec_tell_frac(ec);
+        if(i != 0) balance -= tell;
+        int32_t remaining_bits = total_bits - tell - 1;
+        ctx.remaining_bits = remaining_bits;
+        if(i <= codedBands - 1) {
+            int32_t curr_balance = balance / IMIN(3, codedBands - i);
+            b = IMAX(0, IMIN(16383, IMIN(remaining_bits + 1, pulses[i] + curr_balance)));
+        }
+        else b = 0;
+        if((M * eband5ms[i] - N >= 0 || i == 1) && (update_lowband || lowband_offset == 0)) lowband_offset = i;
+        int tf_change = tf_res[i];
+        ctx.tf_change = tf_change;
+        if(last) lowband_scratch = NULL;
+        if(lowband_offset != 0 && (spread != SPREAD_AGGRESSIVE || B > 1 || tf_change < 0)) {
+            effective_lowband = IMAX(0, M * eband5ms[lowband_offset] - N); // never repeat content within a band
+            int fold_start = lowband_offset;
+            while(M * eband5ms[--fold_start] > effective_lowband);
+            int fold_end = lowband_offset - 1;
+            while(++fold_end < i && M * eband5ms[fold_end] < effective_lowband + N);
+            x_cm = y_cm = 0;
+            int fold_i = fold_start;
+            do {
+                x_cm |= collapse_masks[fold_i * C + 0];
+                y_cm |= collapse_masks[fold_i * C + C - 1];
+            } while(++fold_i < fold_end);
+        }
+        else x_cm = y_cm = (1 << B) - 1;            // folding with the LCG, all blocks non-zero
+        if(dual_stereo && i == intensity) {         // switch off dual stereo for the intensity
+            dual_stereo = 0;
+            for(int j = 0; j < M * eband5ms[i]; j++) norm[j] = (norm[j] + norm2[j]) >> 1;
+        }
+        if(dual_stereo) {
+            x_cm = quant_band(&ctx, X, N, b / 2, B, effective_lowband != -1 ? norm + effective_lowband : NULL, LM,
+                              last ? NULL : norm + M * eband5ms[i], Q15ONE, lowband_scratch, x_cm);
+            y_cm = quant_band(&ctx, Y, N, b / 2, B, effective_lowband != -1 ? norm2 + effective_lowband : NULL, LM,
+                              last ? NULL : norm2 + M * eband5ms[i], Q15ONE, lowband_scratch, y_cm);
+        }
+        else {
+            if(Y != NULL) {
+                x_cm = quant_band_stereo(&ctx, X, Y, N, b, B, effective_lowband != -1 ? norm + effective_lowband : NULL,
+                                         LM, last ? NULL : norm + M * eband5ms[i], lowband_scratch, x_cm | y_cm);
+            }
+            else {
+                x_cm = quant_band(&ctx, X, N, b, B, effective_lowband != -1 ? norm + effective_lowband : NULL, LM,
+                                  last ? NULL : norm + M * eband5ms[i], Q15ONE, lowband_scratch, x_cm | y_cm);
+            }
+            y_cm = x_cm;
+        }
+        collapse_masks[i * C + 0] = (uint8_t)x_cm;
+        collapse_masks[i * C + C - 1] = (uint8_t)y_cm;
+        balance += pulses[i] + tell;
+        update_lowband = b > (N << BITRES);         // the folding position moves while we have 1 bit/sample
+    }
+    *seed = ctx.seed;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          S Y N T H E S I S
+//----------------------------------------------------------------------------------------------------------------------
+static void denormalise_bands(const int16_t *X, int32_t *freq, const int16_t *bandLogE, int end, int M, int silence) {
+    int N = M * SHORT_MDCT;
+    int bound = M * eband5ms[end];
+    if(silence) {
+        bound = 0;
+        end = 0;
+    }
+    int32_t *f = freq;
+    const int16_t *x = X;
+    for(int i = 0; i < end; i++) {
+        int j = M * eband5ms[i];
+        int band_end = M * eband5ms[i + 1];
+        int32_t lg32 = bandLogE[i] + ((int32_t)eMeans[i] << 6);
+        int16_t lg = SATURATE(lg32, 32767);
+        int shift = 16 - (lg >> DB_SHIFT);          // the integer part of the log energy
+        int16_t g;
+        if(shift > 31) {
+            shift = 0;
+            g = 0;
+        }
+        else g = celt_exp2_frac(lg & ((1 << DB_SHIFT) - 1)); // the fractional part
+        if(shift < 0) {                             // extreme gains, a cap of 18 on lg
+            if(shift <= -2) {
+                g = 16384;
+                shift = -2;
+            }
+            do { *f++ = MULT16_16(*x++, g) << -shift; } while(++j < band_end);
+        }
+        else {
+            do { *f++ = MULT16_16(*x++, g) >> shift; } while(++j < band_end);
+        }
+    }
+    memset(&freq[bound], 0, (N - bound) * sizeof(int32_t));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void kf_bfly2(cpx32_t *Fout, int tstride, int m) {
+    cpx32_t *Fout2 = Fout + m;
+    for(int k = 0; k < m; k++) {
+        const cpx16_t tw = fftTwiddles[k * tstride];
+        cpx32_t t;
+        t.r = S_MUL(Fout2[k].r, tw.r) - S_MUL(Fout2[k].i, tw.i);
+        t.i = S_MUL(Fout2[k].r, tw.i) + S_MUL(Fout2[k].i, tw.r);
+        Fout2[k].r = Fout[k].r - t.r;
+        Fout2[k].i = Fout[k].i - t.i;
+        Fout[k].r += t.r;
+        Fout[k].i += t.i;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline cpx32_t c_mul(cpx32_t a, cpx16_t b) {
+    cpx32_t m;
+    m.r = S_MUL(a.r, b.r) - S_MUL(a.i, b.i);
+    m.i = S_MUL(a.r, b.i) + S_MUL(a.i, b.r);
+    return m;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void kf_bfly3(cpx32_t *Fout, int tstride, int m) {
+    const int16_t epi3i = fftTwiddles[tstride * m].i;   // sin(-2pi/3)
+    for(int k = 0; k < m; k++) {
+        cpx32_t s0, s1, s2, s3;
+        s1 = c_mul(Fout[k + m], fftTwiddles[k * tstride]);
+        s2 = c_mul(Fout[k + 2 * m], fftTwiddles[2 * k * tstride]);
+        s3.r = s1.r + s2.r; s3.i = s1.i + s2.i;
+        s0.r = s1.r - s2.r; s0.i = s1.i - s2.i;
+        Fout[k + m].r = Fout[k].r - (s3.r >> 1);
+        Fout[k + m].i = Fout[k].i - (s3.i >> 1);
+        s0.r = S_MUL(s0.r, epi3i);
+        s0.i = S_MUL(s0.i, epi3i);
+        Fout[k].r += s3.r;
+        Fout[k].i += s3.i;
+        Fout[k + 2 * m].r = Fout[k + m].r + s0.i;
+        Fout[k + 2 * m].i = Fout[k + m].i - s0.r;
+        Fout[k + m].r -= s0.i;
+        Fout[k + m].i += s0.r;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void kf_bfly4(cpx32_t *Fout, int tstride, int m) {
+    for(int k = 0; k < m; k++) {
+        cpx32_t s0, s1, s2, s3, s4, s5;
+        s0 = c_mul(Fout[k + m], fftTwiddles[k * tstride]);
+        s1 = c_mul(Fout[k + 2 * m], fftTwiddles[2 * k * tstride]);
+        s2 = c_mul(Fout[k + 3 * m], fftTwiddles[3 * k * tstride]);
+        s5.r = Fout[k].r - s1.r; s5.i = Fout[k].i - s1.i;
+        Fout[k].r += s1.r; Fout[k].i += s1.i;
+        s3.r = s0.r + s2.r; s3.i = s0.i + s2.i;
+        s4.r = s0.r - s2.r; s4.i = s0.i - s2.i;
+        Fout[k + 2 * m].r = Fout[k].r - s3.r;
+        Fout[k + 2 * m].i = Fout[k].i - s3.i;
+        Fout[k].r += s3.r; Fout[k].i += s3.i;
+        Fout[k + m].r = s5.r + s4.i;
+        Fout[k + m].i = s5.i - s4.r;
+        Fout[k + 3 * m].r = s5.r - s4.i;
+        Fout[k + 3 * m].i = s5.i + s4.r;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void kf_bfly5(cpx32_t *Fout, int tstride, int m) {
+    const cpx16_t ya = fftTwiddles[tstride * m];
+    const cpx16_t yb = fftTwiddles[tstride * 2 * m];
+    cpx32_t *F0 = Fout, *F1 = Fout + m, *F2 = Fout + 2 * m, *F3 = Fout + 3 * m, *F4 = Fout + 4 * m;
+    for(int u = 0; u < m; u++) {
+        cpx32_t s0 = F0[u], s5, s6, s7, s8, s9, s10, s11, s12;
+        cpx32_t s1 = c_mul(F1[u], fftTwiddles[u * tstride]);
+        cpx32_t s2 = c_mul(F2[u], fftTwiddles[2 * u * tstride]);
+        cpx32_t s3 = c_mul(F3[u], fftTwiddles[3 * u * tstride]);
+        cpx32_t s4 = c_mul(F4[u], fftTwiddles[4 * u * tstride]);
+        s7.r = s1.r + s4.r; s7.i = s1.i + s4.i;
+        s10.r = s1.r - s4.r; s10.i = s1.i - s4.i;
+        s8.r = s2.r + s3.r; s8.i = s2.i + s3.i;
+        s9.r = s2.r - s3.r; s9.i = s2.i - s3.i;
+        F0[u].r = s0.r + s7.r + s8.r;
+        F0[u].i = s0.i + s7.i + s8.i;
+        s5.r = s0.r + S_MUL(s7.r, ya.r) + S_MUL(s8.r, yb.r);
+        s5.i = s0.i + S_MUL(s7.i, ya.r) + S_MUL(s8.i, yb.r);
+        s6.r = S_MUL(s10.i, ya.i) + S_MUL(s9.i, yb.i);
+        s6.i = -S_MUL(s10.r, ya.i) - S_MUL(s9.r, yb.i);
+        F1[u].r = s5.r - s6.r; F1[u].i = s5.i - s6.i;
+        F4[u].r = s5.r + s6.r; F4[u].i = s5.i + s6.i;
+        s11.r = s0.r + S_MUL(s7.r, yb.r) + S_MUL(s8.r, ya.r);
+        s11.i = s0.i + S_MUL(s7.i, yb.r) + S_MUL(s8.i, ya.r);
+        s12.r = -S_MUL(s10.i, yb.i) + S_MUL(s9.i, ya.i);
+        s12.i = S_MUL(s10.r, yb.i) - S_MUL(s9.r, ya.i);
+        F2[u].r = s11.r + s12.r; F2[u].i = s11.i + s12.i;
+        F3[u].r = s11.r - s12.r; F3[u].i = s11.i - s12.i;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void kf_work(cpx32_t *Fout, const cpx32_t *f, int fstride, const uint8_t *factors, int tbase) {
+    // out of place mixed radix decimation in time (kiss_fft), factors: radix p and the remaining length m
+    cpx32_t *Fout_beg = Fout;
+    const int p = *factors++;
+    const int m = *factors++;
+    const cpx32_t *Fout_end = Fout + p * m;
+    if(m == 1) {
+        do { *Fout = *f; f += fstride; } while(++Fout != Fout_end);
+    }
+    else {
+        do {
+            kf_work(Fout, f, fstride * p, factors, tbase);
+            f += fstride;
+        } while((Fout += m) != Fout_end);
+    }
+    Fout = Fout_beg;
+    switch(p) {
+        case 2: kf_bfly2(Fout, fstride * tbase, m); break;
+        case 3: kf_bfly3(Fout, fstride * tbase, m); break;
+        case 4: kf_bfly4(Fout, fstride * tbase, m); break;
+        case 5: kf_bfly5(Fout, fstride * tbase, m); break;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void clt_mdct_backward(CELTDecoder_t *st, const int32_t *in, int32_t *out, int shift, int stride) {
+    static const uint8_t factors[4][10] = {{4, 120, 4, 30, 3, 10, 2, 5, 5, 1},  // N/4 = 480
+                                           {4, 60, 4, 15, 3, 5, 5, 1},          // 240
+                                           {4, 30, 2, 15, 3, 5, 5, 1},          // 120
+                                           {4, 15, 3, 5, 5, 1}};                // 60
+    int N = 1920;
+    const int16_t *trig = mdctTrig;
+    for(int i = 0; i < shift; i++) {
+        N >>= 1;
+        trig += N;
+    }
+    int N2 = N >> 1;
+    int N4 = N >> 2;
+    const int overlap = CELT_OVERLAP;
+    cpx32_t *f = (cpx32_t *)st->fft;
+    const int32_t *xp1 = in;                        // pre-rotation, real and imag swapped for a forward FFT
+    const int32_t *xp2 = in + stride * (N2 - 1);
+    for(int i = 0; i < N4; i++) {
+        f[i].i = S_MUL(*xp2, trig[i]) + S_MUL(*xp1, trig[N4 + i]);
+        f[i].r = S_MUL(*xp1, trig[i]) - S_MUL(*xp2, trig[N4 + i]);
+        xp1 += 2 * stride;
+        xp2 -= 2 * stride;
+    }
+    kf_work((cpx32_t *)(out + (overlap >> 1)), f, 1, factors[shift], 1 << shift);
+    int32_t *yp0 = out + (overlap >> 1);            // post-rotation from both ends, in place
+    int32_t *yp1 = out + (overlap >> 1) + N2 - 2;
+    for(int i = 0; i < (N4 + 1) >> 1; i++) {
+        int32_t re = yp0[1];
+        int32_t im = yp0[0];
+        int16_t t0 = trig[i];
+        int16_t t1 = trig[N4 + i];
+        int32_t yr = S_MUL(re, t0) + S_MUL(im, t1);
+        int32_t yi = S_MUL(re, t1) - S_MUL(im, t0);
+        re = yp1[1];
+        im = yp1[0];
+        yp0[0] = yr;
+        yp1[1] = yi;
+        t0 = trig[N4 - i - 1];
+        t1 = trig[N2 - i - 1];
+        yr = S_MUL(re, t0) + S_MUL(im, t1);
+        yi = S_MUL(re, t1) - S_MUL(im, t0);
+        yp1[0] = yr;
+        yp0[1] = yi;
+        yp0 += 2;
+        yp1 -= 2;
+    }
+    int32_t *xq1 = out + overlap - 1;               // mirror on both sides for TDAC
+    int32_t *yq1 = out;
+    const int16_t *wp1 = window120;
+    const int16_t *wp2 = window120 + overlap - 1;
+    for(int i = 0; i < overlap / 2; i++) {
+        int32_t x1 = *xq1;
+        int32_t x2 = *yq1;
+        *yq1++ = MULT16_32_Q15(*wp2, x2) - MULT16_32_Q15(*wp1, x1);
+        *xq1-- = MULT16_32_Q15(*wp1, x2) + MULT16_32_Q15(*wp2, x1);
+        wp1++;
+        wp2--;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void celt_synthesis(CELTDecoder_t *st, const int16_t *X, int32_t *out_syn[], const int16_t *oldBandE, int end,
+                           int C, int CC, int isTransient, int LM, int silence) {
+    const int overlap = CELT_OVERLAP;
+    int N = SHORT_MDCT << LM;
+    int M = 1 << LM;
+    int B, NB, shift;
+    int32_t *freq = st->freq;
+    if(isTransient) {
+        B = M;
+        NB = SHORT_MDCT;
+        shift = MAX_LM;
+    }
+    else {
+        B = 1;
+        NB = SHORT_MDCT << LM;
+        shift = MAX_LM - LM;
+    }
+    if(CC == 2 && C == 1) {                         // mono stream to two channels
+        denormalise_bands(X, freq, oldBandE, end, M, silence);
+        int32_t *freq2 = out_syn[1] + overlap / 2;  // a copy in the output buffer, the IMDCT destroys its input
+        memcpy(freq2, freq, N * sizeof(int32_t));
+        for(int b = 0; b < B; b++) clt_mdct_backward(st, &freq2[b], out_syn[0] + NB * b, shift, B);
+        for(int b = 0; b < B; b++) clt_mdct_backward(st, &freq[b], out_syn[1] + NB * b, shift, B);
+    }
+    else if(CC == 1 && C == 2) {                    // stereo stream downmixed to mono
+        int32_t *freq2 = out_syn[0] + overlap / 2;
+        denormalise_bands(X, freq, oldBandE, end, M, silence);
+        denormalise_bands(X + N, freq2, oldBandE + CELT_NBANDS, end, M, silence);
+        for(int i = 0; i < N; i++) freq[i] = (freq[i] >> 1) + (freq2[i] >> 1);
+        for(int b = 0; b < B; b++) clt_mdct_backward(st, &freq[b], out_syn[0] + NB * b, shift, B);
+    }
+    else {
+        int c = 0;
+        do {
+            denormalise_bands(X + c * N, freq, oldBandE + c * CELT_NBANDS, end, M, silence);
+            for(int b = 0; b < B; b++) clt_mdct_backward(st, &freq[b], out_syn[c] + NB * b, shift, B);
+        } while(++c < CC);
+    }
+    int c = 0;                                      // no overflow in the postfilter
+    do {
+        for(int i = 0; i < N; i++) out_syn[c][i] = SATURATE(out_syn[c][i], SIG_SAT);
+    } while(++c < CC);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void comb_filter(int32_t *y, int32_t *x, int T0, int T1, int N, int16_t g0, int16_t g1, int tapset0,
+                        int tapset1, int overlap) {
+    // pitch postfilter, in place (y == x) it is the IIR of the decoder; the old filter fades out over the overlap
+    static const int16_t gains[3][3] = {{10048, 7112, 4248}, {15200, 8784, 0}, {26208, 3280, 0}};
+    if(g0 == 0 && g1 == 0) {
+        if(x != y) memmove(y, x, N * sizeof(int32_t));
+        return;
+    }
+    T0 = IMAX(T0, COMBFILTER_MINPERIOD);
+    T1 = IMAX(T1, COMBFILTER_MINPERIOD);
+    int16_t g00 = MULT16_16_P15(g0, gains[tapset0][0]);
+    int16_t g01 = MULT16_16_P15(g0, gains[tapset0][1]);
+    int16_t g02 = MULT16_16_P15(g0, gains[tapset0][2]);
+    int16_t g10 = MULT16_16_P15(g1, gains[tapset1][0]);
+    int16_t g11 = MULT16_16_P15(g1, gains[tapset1][1]);
+    int16_t g12 = MULT16_16_P15(g1, gains[tapset1][2]);
+    int32_t x0;
+    int32_t x1 = x[-T1 + 1];
+    int32_t x2 = x[-T1];
+    int32_t x3 = x[-T1 - 1];
+    int32_t x4 = x[-T1 - 2];
+    if(g0 == g1 && T0 == T1 && tapset0 == tapset1) overlap = 0;
+    int i;
+    for(i = 0; i < overlap; i++) {
+        x0 = x[i - T1 + 2];
+        int16_t f = MULT16_16_Q15(window120[i], window120[i]);
+        int32_t v = x[i]
+                  + MULT16_32_Q15(MULT16_16_Q15((Q15ONE - f), g00), x[i - T0])
+                  + MULT16_32_Q15(MULT16_16_Q15((Q15ONE - f), g01), x[i - T0 + 1] + x[i - T0 - 1])
+                  + MULT16_32_Q15(MULT16_16_Q15((Q15ONE - f), g02), x[i - T0 + 2] + x[i - T0 - 2])
+                  + MULT16_32_Q15(MULT16_16_Q15(f, g10), x2)
+                  + MULT16_32_Q15(MULT16_16_Q15(f, g11), x1 + x3)
+                  + MULT16_32_Q15(MULT16_16_Q15(f, g12), x0 + x4);
+        y[i] = SATURATE(v, SIG_SAT);
+        x4 = x3;
+        x3 = x2;
+        x2 = x1;
+        x1 = x0;
+    }
+    if(g1 == 0) {
+        if(x != y) memmove(y + overlap, x + overlap, (N - overlap) * sizeof(int32_t));
+        return;
+    }
+    x4 = x[i - T1 - 2];                             // the constant filter
+    x3 = x[i - T1 - 1];
+    x2 = x[i - T1];
+    x1 = x[i - T1 + 1];
+    for(; i < N; i++) {
+        x0 = x[i - T1 + 2];
+        int32_t v = x[i] + MULT16_32_Q15(g10, x2) + MULT16_32_Q15(g11, x1 + x3) + MULT16_32_Q15(g12, x0 + x4);
+        y[i] = SATURATE(v, SIG_SAT);
+        x4 = x3;
+        x3 = x2;
+        x2 = x1;
+        x1 = x0;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void deemphasis(int32_t *in[], int16_t *pcm, int N, int C, int32_t *mem) {
+    int c = 0;
+    do {
+        int32_t m = mem[c];
+        const int32_t *x = in[c];
+        int16_t *y = pcm + c;
+        for(int j = 0; j < N; j++) {
+            int32_t tmp = x[j] + m;
+            m = MULT16_32_Q15(PREEMPH, tmp);
+            int32_t s = PSHR32(tmp, SIG_SHIFT);
+            y[j * C] = (int16_t)(s > 32767 ? 32767 : s < -32768 ? -32768 : s);
+        }
+        mem[c] = m;
+    } while(++c < C);
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          D E C O D E R
+//----------------------------------------------------------------------------------------------------------------------
+void CELTDecoder_Init(CELTDecoder_t *st, uint8_t channels) {
+    st->channels = channels;
+    st->endBand = CELT_NBANDS;
+    CELTDecoder_Reset(st);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void CELTDecoder_Reset(CELTDecoder_t *st) {
+    st->rng = 0;
+    st->preemphMem[0] = st->preemphMem[1] = 0;
+    st->postfilterPeriod = st->postfilterPeriodOld = 0;
+    st->postfilterGain = st->postfilterGainOld = 0;
+    st->postfilterTapset = st->postfilterTapsetOld = 0;
+    memset(st->decodeMem, 0, sizeof(st->decodeMem));
+    for(int i = 0; i < 2 * CELT_NBANDS; i++) {
+        st->oldBandE[i] = 0;
+        st->oldLogE[i] = st->oldLogE2[i] = -(28 << DB_SHIFT);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void CELTDecoder_SetEndBand(CELTDecoder_t *st, uint8_t endBand) {
+    if(endBand >= 1 && endBand <= CELT_NBANDS) st->endBand = endBand;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int CELTDecode(CELTDecoder_t *st, const uint8_t *data, int len, int16_t *pcm, int frameSize, uint8_t streamChannels) {
+    static const uint8_t spread_icdf[4] = {25, 23, 2, 0};
+    static const uint8_t trim_icdf[11] = {126, 124, 119, 109, 87, 41, 19, 9, 4, 2, 0};
+    static const uint8_t tapset_icdf[3] = {2, 1, 0};
+    const int CC = st->channels;
+    const int C = streamChannels;
+    const int end = st->endBand;
+    const int nbEBands = CELT_NBANDS;
+    int16_t *oldBandE = st->oldBandE;
+    int LM;
+    int tf_res[CELT_NBANDS], cap[CELT_NBANDS], offsets[CELT_NBANDS];
+    int fine_quant[CELT_NBANDS], pulses[CELT_NBANDS], fine_priority[CELT_NBANDS];
+    uint8_t collapse_masks[2 * CELT_NBANDS];
+    int32_t *out_syn[2];
+    ecDec_t dec;
+
+    if(len < 0 || len > 1275 || pcm == NULL || C < 1 || C > 2) return ERR_CELT_BAD_ARG;
+    for(LM = 0; LM <= MAX_LM; LM++) if(SHORT_MDCT << LM == frameSize) break;
+    if(LM > MAX_LM) return ERR_CELT_BAD_ARG;
+    int M = 1 << LM;
+    int N = M * SHORT_MDCT;
+    for(int c = 0; c < CC; c++) out_syn[c] = st->decodeMem[c] + CELT_BUFFER_SIZE - N;
+    if(C == 1) {
+        for(int i = 0; i < nbEBands; i++) oldBandE[i] = IMAX(oldBandE[i], oldBandE[nbEBands + i]);
+    }
+    ec_dec_init(&dec, data, len);
+    int32_t total_bits = len * 8;
+    int32_t tell = ec_tell(&dec);
+    int silence;
+    if(tell >= total_bits) silence = 1;
+    else if(tell == 1) silence = ec_dec_bit_logp(&dec, 15);
+    else silence = 0;
+    if(silence) {                                   // pretend we have read all the remaining bits
+        tell = len * 8;
+        dec.nbits_total += tell - ec_tell(&dec);
+    }
+    int16_t postfilter_gain = 0;
+    int postfilter_pitch = 0;
+    int postfilter_tapset = 0;
+    if(tell + 16 <= total_bits) {
+        if(ec_dec_bit_logp(&dec, 1)) {
+            int octave = ec_dec_uint(&dec, 6);
+            postfilter_pitch = (16 << octave) + ec_dec_bits(&dec, 4 + octave) - 1;
+            int qg = ec_dec_bits(&dec, 3);
+            if(ec_tell(&dec) + 2 <= total_bits) postfilter_tapset = ec_dec_icdf(&dec, tapset_icdf, 2);
+            postfilter_gain = 3072 * (qg + 1);      // 0.09375 Q15
+        }
+        tell = ec_tell(&dec);
+    }
+    int isTransient = 0;
+    if(LM > 0 && tell + 3 <= total_bits) {
+        isTransient = ec_dec_bit_logp(&dec, 3);
+        tell = ec_tell(&dec);
+    }
+    int shortBlocks = isTransient ? M : 0;
+    int intra_ener = tell + 3 <= total_bits ? ec_dec_bit_logp(&dec, 3) : 0;
+    unquant_coarse_energy(end, oldBandE, intra_ener, &dec, C, LM);
+    tf_decode(end, isTransient, tf_res, LM, &dec);
+    tell = ec_tell(&dec);
+    int spread_decision = SPREAD_NORMAL;
+    if(tell + 4 <= total_bits) spread_decision = ec_dec_icdf(&dec, spread_icdf, 5);
+
+    for(int i = 0; i < nbEBands; i++) {             // init_caps()
+        int Nb = (eband5ms[i + 1] - eband5ms[i]) << LM;
+        cap[i] = (cache_caps50[nbEBands * (2 * LM + C - 1) + i] + 64) * C * Nb >> 2;
+    }
+    int dynalloc_logp = 6;
+    total_bits <<= BITRES;
+    tell = ec_tell_frac(&dec);
+    for(int i = 0; i < end; i++) {                  // dynamic allocation
+        int width = C * (eband5ms[i + 1] - eband5ms[i]) << LM;
+        int quanta = IMIN(width << BITRES, IMAX(6 << BITRES, width)); // 6 bits, max 1 bit and min 1/8 bit per sample
+        int dynalloc_loop_logp = dynalloc_logp;
+        int boost = 0;
+        while(tell + (dynalloc_loop_logp << BITRES) < total_bits && boost < cap[i]) {
+            int flag = ec_dec_bit_logp(&dec, dynalloc_loop_logp);
+            tell = ec_tell_frac(&dec);
+            if(!flag) break;
+            boost += quanta;
+            total_bits -= quanta;
+            dynalloc_loop_logp = 1;
+        }
+        offsets[i] = boost;
+        if(boost > 0) dynalloc_logp = IMAX(2, dynalloc_logp - 1);
+    }
+    int alloc_trim = tell + (6 << BITRES) <= total_bits ? ec_dec_icdf(&dec, trim_icdf, 7) : 5;
+    int32_t bits = (((int32_t)len * 8) << BITRES) - ec_tell_frac(&dec) - 1;
+    int anti_collapse_rsv = isTransient && LM >= 2 && bits >= ((LM + 2) << BITRES) ? (1 << BITRES) : 0;
+    bits -= anti_collapse_rsv;
+    int intensity = 0, dual_stereo = 0;
+    int32_t balance;
+    int codedBands = clt_compute_allocation(end, offsets, cap, alloc_trim, &intensity, &dual_stereo, bits, &balance,
+                                            pulses, fine_quant, fine_priority, C, LM, &dec);
+    unquant_fine_energy(end, oldBandE, fine_quant, &dec, C);
+    for(int c = 0; c < CC; c++) {
+        memmove(st->decodeMem[c], st->decodeMem[c] + N, (CELT_BUFFER_SIZE - N + CELT_OVERLAP / 2) * sizeof(int32_t));
+    }
+    uint32_t seed = st->rng;
+    quant_all_bands(st, end, st->X, C == 2 ? st->X + N : NULL, collapse_masks, pulses, shortBlocks, spread_decision,
+                    dual_stereo, intensity, tf_res, len * (8 << BITRES) - anti_collapse_rsv, balance, &dec, LM,
+                    codedBands, &seed);
+    int anti_collapse_on = 0;
+    if(anti_collapse_rsv > 0) anti_collapse_on = ec_dec_bits(&dec, 1);
+    unquant_energy_finalise(end, oldBandE, fine_quant, fine_priority, len * 8 - ec_tell(&dec), &dec, C);
+    if(anti_collapse_on) {
+        anti_collapse(st->X, collapse_masks, LM, C, N, end, oldBandE, st->oldLogE, st->oldLogE2, pulses, seed);
+    }
+    if(silence) {
+        for(int i = 0; i < C * nbEBands; i++) oldBandE[i] = -(28 << DB_SHIFT);
+    }
+    celt_synthesis(st, st->X, out_syn, oldBandE, end, C, CC, isTransient, LM, silence);
+
+    for(int c = 0; c < CC; c++) {
+        st->postfilterPeriod = IMAX(st->postfilterPeriod, COMBFILTER_MINPERIOD);
+        st->postfilterPeriodOld = IMAX(st->postfilterPeriodOld, COMBFILTER_MINPERIOD);
+        comb_filter(out_syn[c], out_syn[c], st->postfilterPeriodOld, st->postfilterPeriod, SHORT_MDCT,
+                    st->postfilterGainOld, st->postfilterGain, st->postfilterTapsetOld, st->postfilterTapset, CELT_OVERLAP);
+        if(LM != 0) {
+            comb_filter(out_syn[c] + SHORT_MDCT, out_syn[c] + SHORT_MDCT, st->postfilterPeriod, postfilter_pitch,
+                        N - SHORT_MDCT, st->postfilterGain, postfilter_gain, st->postfilterTapset, postfilter_tapset,
+                        CELT_OVERLAP);
+        }
+    }
+    st->postfilterPeriodOld = st->postfilterPeriod;
+    st->postfilterGainOld = st->postfilterGain;
+    st->postfilterTapsetOld = st->postfilterTapset;
+    st->postfilterPeriod = postfilter_pitch;
+    st->postfilterGain = postfilter_gain;
+    st->postfilterTapset = postfilter_tapset;
+    if(LM != 0) {
+        st->postfilterPeriodOld = st->postfilterPeriod;
+        st->postfilterGainOld = st->postfilterGain;
+        st->postfilterTapsetOld = st->postfilterTapset;
+    }
+    if(C == 1) memcpy(&oldBandE[nbEBands], oldBandE, nbEBands * sizeof(int16_t));
+    if(!isTransient) {
+        memcpy(st->oldLogE2, st->oldLogE, 2 * nbEBands * sizeof(int16_t));
+        memcpy(st->oldLogE, oldBandE, 2 * nbEBands * sizeof(int16_t));
+    }
+    else {
+        for(int i = 0; i < 2 * nbEBands; i++) st->oldLogE[i] = IMIN(st->oldLogE[i], oldBandE[i]);
+    }
+    for(int c = 0; c < 2; c++) {                    // in case the end band changes
+        for(int i = end; i < nbEBands; i++) {
+            oldBandE[c * nbEBands + i] = 0;
+            st->oldLogE[c * nbEBands + i] = st->oldLogE2[c * nbEBands + i] = -(28 << DB_SHIFT);
+        }
+    }
+    st->rng = dec.rng;
+    deemphasis(out_syn, pcm, N, CC, st->preemphMem);
+    if(ec_tell(&dec) > 8 * len) return ERR_CELT_INTERNAL;
+    return frameSize;
+}
@@ -0,0 +1,48 @@
+/*
+ * celt.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Fixed point CELT decoder (RFC 6716, section 4.3) for the Opus decoder, the 48kHz mode of Opus only:
+ *  21 bands, frames of 2.5, 5, 10 and 20ms, overlap 120, coded mono or stereo, output mono or stereo.
+ *  Integer arithmetic throughout (Q14 normalised bands, Q12 signal, Q10 log energies) as in the fixed
+ *  point build of libopus 1.3, the inverse MDCT uses an own mixed radix FFT (N/4 = 480/240/120/60).
+ *  No packet loss concealment, a lost or broken frame is decoded as silence.
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include "Arduino.h"
+
+#define CELT_NBANDS         21
+#define CELT_OVERLAP        120
+#define CELT_MAX_FRAME      960                     // 20ms at 48kHz
+#define CELT_BUFFER_SIZE    2048                    // history for the postfilter (max pitch period 1024)
+
+enum : int8_t {ERR_CELT_NONE = 0,
+               ERR_CELT_BAD_ARG = -1,
+               ERR_CELT_INTERNAL = -2};
+
+typedef struct CELTDecoder_t {
+    uint8_t  channels;                              // output channels
+    uint8_t  endBand;                               // 13 NB, 17 WB, 19 SWB, 21 FB
+    uint32_t rng;                                   // final range of the last frame
+    int32_t  preemphMem[2];
+    int      postfilterPeriod, postfilterPeriodOld;
+    int16_t  postfilterGain,   postfilterGainOld;
+    int      postfilterTapset, postfilterTapsetOld;
+    int16_t  oldBandE[2 * CELT_NBANDS];             // Q10
+    int16_t  oldLogE[2 * CELT_NBANDS];
+    int16_t  oldLogE2[2 * CELT_NBANDS];
+    int32_t  decodeMem[2][CELT_BUFFER_SIZE + CELT_OVERLAP];
+    // work buffers of one frame
+    int16_t  X[2 * CELT_MAX_FRAME];                 // normalised MDCT coefficients, channel 0 and 1
+    int16_t  norm[2 * 8 * 78];                      // folding source of quant_all_bands()
+    int32_t  freq[CELT_MAX_FRAME];                  // denormalised coefficients
+    int32_t  fft[CELT_MAX_FRAME];                   // N/4 complex values of the inverse MDCT
+}CELTDecoder_t;
+
+void    CELTDecoder_Init(CELTDecoder_t *st, uint8_t channels);
+void    CELTDecoder_Reset(CELTDecoder_t *st);
+void    CELTDecoder_SetEndBand(CELTDecoder_t *st, uint8_t endBand);
+int     CELTDecode(CELTDecoder_t *st, const uint8_t *data, int len, int16_t *pcm, int frameSize, uint8_t streamChannels);
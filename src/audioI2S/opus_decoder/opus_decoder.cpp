@@ -0,0 +1,308 @@
+/*
+ * opus_decoder.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Opus packets -> frames -> CELT, see opus_decoder.h
+ */
+#include "opus_decoder.h"
+
+typedef struct OPUSDecoder_t {
+    CELTDecoder_t celt;
+}OPUSDecoder_t;
+
+static OPUSDecoder_t *OPUSDec = NULL;
+
+// OpusHead, kept while the buffers are freed and allocated again
+static uint8_t  s_channels = 2;
+static uint16_t s_preSkip = 0;
+static int32_t  s_gainQ14 = 16384;                  // output gain
+
+// frames of the current packet
+static uint8_t  s_toc = 0;
+static uint8_t  s_frameCount = 0;
+static uint8_t  s_frameIdx = 0;
+static uint16_t s_frameOffs[OPUS_MAX_FRAMES];
+static uint16_t s_frameLen[OPUS_MAX_FRAMES];
+
+static uint16_t s_preSkipLeft = 0;
+static uint16_t s_validSamples = 0;
+static uint32_t s_bitRate = 0;
+static uint32_t s_finalRange = 0;
+
+// SILK and hybrid frames
+static uint16_t s_muteLeft = 0;                     // samples of the current frame still to be given out as silence
+static uint32_t s_mutedFrames = 0;                  // of the stream
+static bool     s_celtReset = false;                // the next CELT frame starts from a reset decoder
+
+//----------------------------------------------------------------------------------------------------------------------
+//          O P U S   I N I   S E C T I O N
+//----------------------------------------------------------------------------------------------------------------------
+bool OPUSDecoder_AllocateBuffers(){
+    if(!OPUSDec) {
+        if(psramFound()) OPUSDec = (OPUSDecoder_t*) ps_malloc(sizeof(OPUSDecoder_t));
+        else             OPUSDec = (OPUSDecoder_t*) malloc(sizeof(OPUSDecoder_t));
+    }
+    if(!OPUSDec) {
+        log_e("not enough memory to allocate opusdecoder buffers");
+        return false;
+    }
+    OPUSDecoder_ClearBuffers();
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OPUSDecoder_ClearBuffers(){
+    if(OPUSDec) CELTDecoder_Init(&OPUSDec->celt, s_channels);
+    s_frameCount = s_frameIdx = 0;
+    s_preSkipLeft = s_preSkip;
+    s_validSamples = 0;
+    s_finalRange = 0;
+    s_muteLeft = 0;
+    s_mutedFrames = 0;
+    s_celtReset = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OPUSDecoder_FreeBuffers(){
+    if(OPUSDec) {free(OPUSDec); OPUSDec = NULL;}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void OPUSDecoder_Reset(){                           // the packets are interrupted
+    s_frameCount = s_frameIdx = 0;
+    s_muteLeft = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          H E A D E R S
+//----------------------------------------------------------------------------------------------------------------------
+int OPUSParseHead(unsigned char *buf, int len){
+    // "OpusHead", version, channels, pre-skip, input sample rate, output gain, mapping family (RFC 7845 5.1)
+    if(len < 19 || memcmp(buf, "OpusHead", 8) != 0) return ERR_OPUS_BAD_HEAD;
+    if((buf[8] & 0xF0) != 0) return ERR_OPUS_BAD_HEAD; // major version 0 only
+    uint8_t channels = buf[9];
+    uint8_t family = buf[18];
+    if(channels < 1 || channels > 2 || family > 1) return ERR_OPUS_CHANNEL_MAPPING;
+    if(family == 1) {                               // one stream, no coupled stream for mono, one for stereo
+        if(len < 21 + channels || buf[19] != 1 || buf[20] != channels - 1) return ERR_OPUS_CHANNEL_MAPPING;
+        for(int i = 0; i < channels; i++) if(buf[21 + i] != i) return ERR_OPUS_CHANNEL_MAPPING;
+    }
+    s_preSkip = buf[10] | buf[11] << 8;
+    int16_t gain = (int16_t)(buf[16] | buf[17] << 8); // Q7.8 dB
+    s_gainQ14 = 16384;
+    if(gain) {
+        float g = 16384.0f * powf(10.0f, (float)gain / (20.0f * 256.0f));
+        s_gainQ14 = g > 1048576.0f ? 1048576 : (int32_t)g;
+    }
+    if(channels != s_channels && OPUSDec) CELTDecoder_Init(&OPUSDec->celt, channels);
+    s_channels = channels;
+    s_preSkipLeft = s_preSkip;
+    return ERR_OPUS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          P A C K E T S
+//----------------------------------------------------------------------------------------------------------------------
+static uint16_t OPUSFrameSize(uint8_t config){
+    if(config < 12) return (config & 3) == 3 ? 2880 : 480 << (config & 3); // SILK 10, 20, 40, 60ms
+    if(config < 16) return 480 << (config & 1);     // hybrid 10, 20ms
+    return 120 << (config & 3);                     // CELT 2.5, 5, 10, 20ms
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int OPUSParseSize(const uint8_t *data, int len, uint16_t *size){
+    if(len < 1) return -1;
+    if(data[0] < 252) {
+        *size = data[0];
+        return 1;
+    }
+    if(len < 2) return -1;
+    *size = 4 * data[1] + data[0];
+    return 2;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t OPUSParsePacket(const uint8_t *data, int len){
+    // TOC byte and frame lengths (RFC 6716 3.2)
+    if(len < 1) return ERR_OPUS_INVALID_PACKET;
+    s_toc = data[0];
+    int offs = 1;
+    int rest = len - 1;
+    uint16_t frameSize = OPUSFrameSize(s_toc >> 3);
+    switch(s_toc & 3) {
+        case 0:                                     // one frame
+            s_frameCount = 1;
+            s_frameLen[0] = rest;
+            break;
+        case 1:                                     // two frames of equal size
+            if(rest & 1) return ERR_OPUS_INVALID_PACKET;
+            s_frameCount = 2;
+            s_frameLen[0] = s_frameLen[1] = rest / 2;
+            break;
+        case 2: {                                   // two frames of different size
+            int n = OPUSParseSize(data + offs, rest, &s_frameLen[0]);
+            if(n < 0 || s_frameLen[0] > rest - n) return ERR_OPUS_INVALID_PACKET;
+            offs += n;
+            rest -= n;
+            s_frameCount = 2;
+            s_frameLen[1] = rest - s_frameLen[0];
+            break;
+        }
+        default: {                                  // an arbitrary number of frames
+            if(rest < 1) return ERR_OPUS_INVALID_PACKET;
+            uint8_t ch = data[offs++];
+            rest--;
+            s_frameCount = ch & 0x3F;
+            if(s_frameCount == 0 || s_frameCount * frameSize > 5760) return ERR_OPUS_INVALID_PACKET;
+            if(ch & 0x40) {                         // padding
+                int p;
+                do {
+                    if(rest <= 0) return ERR_OPUS_INVALID_PACKET;
+                    p = data[offs++];
+                    rest--;
+                    int tmp = p == 255 ? 254 : p;
+                    rest -= tmp;
+                    len -= tmp;
+                } while(p == 255);
+                if(rest < 0) return ERR_OPUS_INVALID_PACKET;
+            }
+            if(ch & 0x80) {                         // VBR
+                int last = rest;
+                for(int i = 0; i < s_frameCount - 1; i++) {
+                    int n = OPUSParseSize(data + offs, rest, &s_frameLen[i]);
+                    if(n < 0 || s_frameLen[i] > rest - n) return ERR_OPUS_INVALID_PACKET;
+                    offs += n;
+                    rest -= n;
+                    last -= n + s_frameLen[i];
+                }
+                if(last < 0) return ERR_OPUS_INVALID_PACKET;
+                s_frameLen[s_frameCount - 1] = last;
+            }
+            else {                                  // CBR
+                if(rest % s_frameCount) return ERR_OPUS_INVALID_PACKET;
+                for(int i = 0; i < s_frameCount; i++) s_frameLen[i] = rest / s_frameCount;
+            }
+        }
+    }
+    for(int i = 0; i < s_frameCount; i++) {
+        if(s_frameLen[i] > 1275) return ERR_OPUS_INVALID_PACKET;
+        s_frameOffs[i] = offs;
+        offs += s_frameLen[i];
+    }
+    if(offs > len) return ERR_OPUS_INVALID_PACKET;
+    s_frameIdx = 0;
+    s_muteLeft = 0;
+    s_bitRate = (uint32_t)len * 8 * OPUS_SAMPLE_RATE / (frameSize * s_frameCount);
+    return ERR_OPUS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void OPUSOutput(short *outbuf, uint16_t samples){
+    // pre-skip and output gain of the decoded samples
+    if(s_preSkipLeft) {                             // the first samples of the stream are dropped
+        uint16_t skip = s_preSkipLeft < samples ? s_preSkipLeft : samples;
+        s_preSkipLeft -= skip;
+        samples -= skip;
+        memmove(outbuf, outbuf + skip * s_channels, samples * s_channels * sizeof(short));
+    }
+    if(s_gainQ14 != 16384) {
+        for(int i = 0; i < samples * s_channels; i++) {
+            int32_t s = (int32_t)(((int64_t)outbuf[i] * s_gainQ14) >> 14);
+            outbuf[i] = s > 32767 ? 32767 : s < -32768 ? -32768 : s;
+        }
+    }
+    s_validSamples = samples * s_channels;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t OPUSMuteFrame(short *outbuf){
+    // a SILK or hybrid frame is given out as silence of its length, in parts of CELT_MAX_FRAME (60ms SILK frames);
+    // the CELT decoder is reset for the next CELT frame, as libopus does on a change of the mode
+    if(!s_muteLeft) {
+        s_muteLeft = OPUSFrameSize(s_toc >> 3);
+        s_mutedFrames++;
+        s_celtReset = true;
+    }
+    uint16_t samples = s_muteLeft < CELT_MAX_FRAME ? s_muteLeft : CELT_MAX_FRAME;
+    s_muteLeft -= samples;
+    if(!s_muteLeft) s_frameIdx++;
+    memset(outbuf, 0, samples * s_channels * sizeof(short));
+    OPUSOutput(outbuf, samples);
+    return ERR_OPUS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t OPUSDecodeFrame(const uint8_t *packet, short *outbuf){
+    // one CELT frame of the current packet
+    uint8_t config = s_toc >> 3;
+    if(config < 16) return OPUSMuteFrame(outbuf);
+    if(s_celtReset) {
+        CELTDecoder_Reset(&OPUSDec->celt);
+        s_celtReset = false;
+    }
+    const uint8_t *data = packet + s_frameOffs[s_frameIdx];
+    int len = s_frameLen[s_frameIdx];
+    static const uint8_t endBand[4] = {13, 17, 19, 21}; // NB, WB, SWB, FB
+    CELTDecoder_SetEndBand(&OPUSDec->celt, endBand[(config - 16) >> 2]);
+    uint16_t samples = OPUSFrameSize(config);
+    int ret = CELTDecode(&OPUSDec->celt, data, len, outbuf, samples, (s_toc & 0x04) ? 2 : 1);
+    s_frameIdx++;
+    if(ret < 0) return ERR_OPUS_CELT;
+    s_finalRange = OPUSDec->celt.rng;
+    OPUSOutput(outbuf, samples);
+    return ERR_OPUS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          O P U S - D E C O D E R
+//----------------------------------------------------------------------------------------------------------------------
+int8_t OPUSDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf){
+    // one frame per call, the input is one packet; it is consumed (*bytesLeft = 0) with its last frame, until then
+    // the same packet is given again (OPUS_GIVE_NEXT_LOOP)
+    s_validSamples = 0;
+    int len = *bytesLeft;
+    if(s_frameIdx >= s_frameCount) {                // a new packet
+        if(len >= 8 && memcmp(inbuf, "OpusHead", 8) == 0) { // also the next track of a chained stream
+            *bytesLeft = 0;
+            int ret = OPUSParseHead(inbuf, len);
+            if(OPUSDec) CELTDecoder_Reset(&OPUSDec->celt);
+            return ret;
+        }
+        if(len >= 8 && memcmp(inbuf, "OpusTags", 8) == 0) {
+            *bytesLeft = 0;
+            return ERR_OPUS_NONE;
+        }
+        if(len > OPUS_MAX_PACKET) {*bytesLeft = 0; return ERR_OPUS_PACKET_TOO_BIG;}
+        int8_t ret = OPUSParsePacket(inbuf, len);
+        if(ret < 0) {*bytesLeft = 0; return ret;}
+    }
+    int8_t ret = OPUSDecodeFrame(inbuf, outbuf);
+    if(ret < 0) {
+        s_frameCount = s_frameIdx = 0;
+        *bytesLeft = 0;
+        return ret;
+    }
+    if(s_frameIdx < s_frameCount) return OPUS_GIVE_NEXT_LOOP;
+    *bytesLeft = 0;
+    return ERR_OPUS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint16_t OPUSGetOutputSamps(){
+    int vs = s_validSamples;
+    s_validSamples = 0;
+    return vs;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint8_t OPUSGetChannels(){
+    return s_channels;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t OPUSGetSampRate(){
+    return OPUS_SAMPLE_RATE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint8_t OPUSGetBitsPerSample(){
+    return 16;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t OPUSGetBitRate(){
+    return s_bitRate;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t OPUSGetFinalRange(){                       // of the last CELT frame, as OPUS_GET_FINAL_RANGE of libopus
+    return s_finalRange;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t OPUSGetMutedFrames(){                      // SILK and hybrid frames of the stream, given out as silence
+    return s_mutedFrames;
+}
@@ -0,0 +1,42 @@
+/*
+ * opus_decoder.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Opus decoder (RFC 6716, RFC 7845), the input are the packets of an Ogg/Opus stream, see container/ogg.h
+ *  Restrictions:
+ *  CELT frames only (configs 16..31), SILK and hybrid frames are given out as silence of their length
+ *  channel mapping family 0, or family 1 with 1 or 2 channels
+ *  output is always 48kHz, 16 bit, mono or stereo as given in OpusHead
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include "Arduino.h"
+#include "celt.h"
+
+#define OPUS_MAX_PACKET     (3 * 1275 + 15)         // 60ms of CELT at the maximum frame size
+#define OPUS_MAX_FRAMES     48                      // 120ms of 2.5ms frames
+#define OPUS_SAMPLE_RATE    48000
+
+enum : int8_t  {OPUS_GIVE_NEXT_LOOP = +1,
+                ERR_OPUS_NONE = 0,
+                ERR_OPUS_BAD_HEAD = -2,
+                ERR_OPUS_CHANNEL_MAPPING = -3,
+                ERR_OPUS_INVALID_PACKET = -4,
+                ERR_OPUS_PACKET_TOO_BIG = -5,
+                ERR_OPUS_CELT = -6};
+
+bool     OPUSDecoder_AllocateBuffers();
+void     OPUSDecoder_ClearBuffers();
+void     OPUSDecoder_FreeBuffers();
+void     OPUSDecoder_Reset();
+int      OPUSParseHead(unsigned char *buf, int len);
+int8_t   OPUSDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
+uint16_t OPUSGetOutputSamps();
+uint8_t  OPUSGetChannels();
+uint32_t OPUSGetSampRate();
+uint8_t  OPUSGetBitsPerSample();
+uint32_t OPUSGetBitRate();
+uint32_t OPUSGetFinalRange();
+uint32_t OPUSGetMutedFrames();
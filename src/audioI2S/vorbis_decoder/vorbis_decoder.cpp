@@ -0,0 +1,1559 @@
+/*
+ * vorbis_decoder.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Vorbis packets -> floor 1, residue, inverse coupling, inverse MDCT, overlap-add, see vorbis_decoder.h
+ *  Fixed point: residue values Q12, spectrum and time signal Q20, window, floor and trig tables Q31.
+ */
+#include "vorbis_decoder.h"
+
+#define RQ      12                                  // fraction bits of the codebook values
+#define SQ      20                                  // fraction bits of the spectrum and the time signal
+#define FAST_BITS 7                                 // codewords up to this length are found by one table lookup
+
+#define MULT31(a, b) ((int32_t)(((int64_t)(a) * (b)) >> 31))
+
+//----------------------------------------------------------------------------------------------------------------------
+//          T A B L E S
+//----------------------------------------------------------------------------------------------------------------------
+// FLOOR1_fromdB_LOOKUP of the specification, Q31
+static const int32_t fromdB[256] = {
+            229,         244,         259,         276,         294,         313,         334,         355,
+            378,         403,         429,         457,         487,         518,         552,         588,
+            626,         667,         710,         756,         806,         858,         914,         973,
+           1036,        1104,        1175,        1252,        1333,        1420,        1512,        1610,
+           1715,        1826,        1945,        2072,        2206,        2350,        2502,        2665,
+           2838,        3023,        3219,        3428,        3651,        3888,        4141,        4410,
+           4696,        5002,        5327,        5673,        6042,        6434,        6852,        7298,
+           7772,        8277,        8815,        9388,        9998,       10647,       11339,       12076,
+          12861,       13697,       14587,       15535,       16544,       17619,       18764,       19984,
+          21283,       22666,       24139,       25707,       27378,       29157,       31052,       33070,
+          35219,       37507,       39945,       42541,       45305,       48249,       51385,       54724,
+          58281,       62068,       66101,       70397,       74972,       79844,       85033,       90559,
+          96444,      102711,      109386,      116494,      124065,      132127,      140714,      149858,
+         159597,      169968,      181014,      192777,      205305,      218646,      232855,      247988,
+         264103,      281266,      299544,      319011,      339742,      361820,      385333,      410374,
+         437043,      465444,      495691,      527904,      562210,      598746,      637656,      679094,
+         723226,      770225,      820278,      873585,      930355,      990815,     1055204,     1123777,
+        1196806,     1274581,     1357411,     1445623,     1539568,     1639617,     1746169,     1859645,
+        1980495,     2109199,     2246266,     2392241,     2547703,     2713267,     2889590,     3077372,
+        3277357,     3490338,     3717160,     3958722,     4215982,     4489960,     4781743,     5092487,
+        5423426,     5775871,     6151219,     6550960,     6976679,     7430062,     7912910,     8427135,
+        8974778,     9558009,    10179143,    10840641,    11545127,    12295394,    13094418,    13945367,
+       14851616,    15816757,    16844619,    17939277,    19105073,    20346628,    21668866,    23077031,
+       24576707,    26173840,    27874763,    29686222,    31615400,    33669947,    35858010,    38188266,
+       40669954,    43312917,    46127634,    49125268,    52317704,    55717603,    59338447,    63194594,
+       67301334,    71674954,    76332796,    81293331,    86576230,    92202441,    98194275,   104575492,
+      111371397,   118608937,   126316814,   134525592,   143267823,   152578173,   162493562,   173053309,
+      184299288,   196276094,   209031220,   222615246,   237082039,   252488965,   268897120,   286371569,
+      304981607,   324801030,   345908430,   368387508,   392327404,   417823048,   444975543,   473892561,
+      504688769,   537486288,   572415174,   609613936,   649230084,   691420712,   736353124,   784205498,
+      835167588,   889441482,   947242400,  1008799547,  1074357023,  1144174794,  1218529717,  1297716642,
+     1382049579,  1471862945,  1567512890,  1669378707,  1777864339,  1893399978,  2016443773,  2147483647
+};
+// sin(i * pi/2 / 4096), Q31
+static const int32_t sinTab[4097] = {
+              0,      823550,     1647099,     2470648,     3294197,     4117746,     4941294,     5764841,
+        6588387,     7411932,     8235476,     9059019,     9882561,    10706101,    11529640,    12353177,
+       13176712,    14000245,    14823776,    15647305,    16470832,    17294356,    18117878,    18941397,
+       19764913,    20588426,    21411936,    22235444,    23058947,    23882448,    24705945,    25529438,
+       26352928,    27176413,    27999895,    28823373,    29646846,    30470315,    31293780,    32117239,
+       32940695,    33764145,    34587590,    35411031,    36234466,    37057895,    37881320,    38704738,
+       39528151,    40351559,    41174960,    41998355,    42821744,    43645127,    44468503,    45291873,
+       46115236,    46938593,    47761942,    48585284,    49408620,    50231948,    51055268,    51878581,
+       52701887,    53525185,    54348475,    55171756,    55995030,    56818296,    57641553,    58464802,
+       59288042,    60111273,    60934496,    61757709,    62580914,    63404109,    64227295,    65050471,
+       65873638,    66696795,    67519943,    68343080,    69166208,    69989325,    70812432,    71635529,
+       72458615,    73281690,    74104755,    74927809,    75750851,    76573883,    77396903,    78219912,
+       79042909,    79865895,    80688869,    81511831,    82334782,    83157720,    83980645,    84803559,
+       85626460,    86449348,    87272224,    88095087,    88917937,    89740774,    90563597,    91386408,
+       92209205,    93031988,    93854758,    94677513,    95500255,    96322983,    97145697,    97968396,
+       98791081,    99613752,   100436408,   101259049,   102081675,   102904286,   103726882,   104549463,
+      105372028,   106194578,   107017112,   107839631,   108662134,   109484620,   110307091,   111129545,
+      111951983,   112774405,   113596810,   114419198,   115241570,   116063924,   116886262,   117708582,
+      118530885,   119353170,   120175438,   120997688,   121819921,   122642135,   123464332,   124286510,
+      125108670,   125930812,   126752935,   127575040,   128397125,   129219192,   130041240,   130863269,
+      131685278,   132507269,   133329239,   134151190,   134973122,   135795033,   136616925,   137438796,
+      138260647,   139082478,   139904288,   140726078,   141547847,   142369596,   143191323,   144013029,
+      144834714,   145656378,   146478021,   147299642,   148121241,   148942818,   149764374,   150585907,
+      151407418,   152228908,   153050374,   153871818,   154693240,   155514639,   156336015,   157157368,
+      157978697,   158800004,   159621287,   160442547,   161263783,   162084996,   162906184,   163727349,
+      164548489,   165369606,   166190698,   167011765,   167832808,   168653827,   169474820,   170295789,
+      171116733,   171937651,   172758544,   173579412,   174400254,   175221071,   176041861,   176862626,
+      177683365,   178504078,   179324764,   180145425,   180966058,   181786665,   182607245,   183427799,
+      184248325,   185068825,   185889297,   186709742,   187530159,   188350549,   189170911,   189991245,
+      190811551,   191631829,   192452080,   193272301,   194092495,   194912659,   195732795,   196552903,
+      197372981,   198193031,   199013051,   199833042,   200653003,   201472935,   202292838,   203112711,
+      203932553,   204752366,   205572149,   206391901,   207211624,   208031315,   208850976,   209670607,
+      210490206,   211309775,   212129312,   212948818,   213768293,   214587737,   215407149,   216226529,
+      217045878,   217865194,   218684479,   219503731,   220322951,   221142139,   221961294,   222780416,
+      223599506,   224418563,   225237587,   226056578,   226875535,   227694459,   228513350,   229332207,
+      230151030,   230969820,   231788575,   232607296,   233425984,   234244636,   235063255,   235881839,
+      236700388,   237518902,   238337382,   239155826,   239974235,   240792609,   241610947,   242429250,
+      243247518,   244065749,   244883945,   245702104,   246520228,   247338315,   248156366,   248974380,
+      249792358,   250610299,   251428203,   252246070,   253063900,   253881693,   254699448,   255517166,
+      256334847,   257152490,   257970095,   258787662,   259605191,   260422681,   261240134,   262057548,
+      262874923,   263692260,   264509558,   265326817,   266144038,   266961219,   267778360,   268595463,
+      269412525,   270229549,   271046532,   271863476,   272680379,   273497243,   274314066,   275130849,
+      275947592,   276764294,   277580955,   278397575,   279214155,   280030693,   280847190,   281663646,
+      282480061,   283296434,   284112765,   284929054,   285745302,   286561508,   287377671,   288193792,
+      289009871,   289825907,   290641901,   291457852,   292273760,   293089625,   293905447,   294721225,
+      295536961,   296352653,   297168301,   297983906,   298799466,   299614983,   300430456,   301245885,
+      302061269,   302876609,   303691904,   304507155,   305322361,   306137522,   306952638,   307767708,
+      308582734,   309397714,   310212649,   311027538,   311842381,   312657179,   313471930,   314286635,
+      315101295,   315915907,   316730474,   317544993,   318359466,   319173893,   319988272,   320802604,
+      321616889,   322431127,   323245317,   324059460,   324873555,   325687603,   326501602,   327315554,
+      328129457,   328943312,   329757119,   330570877,   331384586,   332198247,   333011859,   333825422,
+      334638936,   335452401,   336265816,   337079182,   337892498,   338705765,   339518981,   340332148,
+      341145265,   341958332,   342771348,   343584314,   344397230,   345210094,   346022908,   346835671,
+      347648383,   348461044,   349273654,   350086213,   350898719,   351711175,   352523578,   353335930,
+      354148230,   354960477,   355772673,   356584816,   357396906,   358208945,   359020930,   359832863,
+      360644742,   361456569,   362268343,   363080063,   363891730,   364703343,   365514903,   366326408,
+      367137861,   367949259,   368760603,   369571892,   370383128,   371194308,   372005435,   372816506,
+      373627523,   374438485,   375249392,   376060243,   376871039,   377681780,   378492466,   379303095,
+      380113669,   380924187,   381734649,   382545055,   383355404,   384165697,   384975934,   385786114,
+      386596237,   387406303,   388216313,   389026265,   389836160,   390645998,   391455778,   392265501,
+      393075166,   393884774,   394694323,   395503814,   396313247,   397122622,   397931939,   398741197,
+      399550396,   400359536,   401168618,   401977641,   402786604,   403595508,   404404353,   405213139,
+      406021865,   406830531,   407639137,   408447683,   409256170,   410064596,   410872962,   411681267,
+      412489512,   413297696,   414105819,   414913882,   415721883,   416529824,   417337703,   418145520,
+      418953276,   419760971,   420568604,   421376175,   422183684,   422991131,   423798515,   424605838,
+      425413098,   426220295,   427027430,   427834502,   428641511,   429448457,   430255339,   431062159,
+      431868915,   432675607,   433482236,   434288802,   435095303,   435901740,   436708113,   437514422,
+      438320667,   439126847,   439932963,   440739014,   441545000,   442350921,   443156777,   443962568,
+      444768294,   445573954,   446379549,   447185078,   447990541,   448795938,   449601270,   450406535,
+      451211734,   452016867,   452821933,   453626932,   454431865,   455236731,   456041530,   456846262,
+      457650927,   458455525,   459260055,   460064517,   460868912,   461673239,   462477499,   463281690,
+      464085813,   464889868,   465693854,   466497772,   467301622,   468105402,   468909114,   469712757,
+      470516330,   471319835,   472123270,   472926636,   473729932,   474533159,   475336316,   476139403,
+      476942419,   477745366,   478548243,   479351049,   480153784,   480956449,   481759043,   482561567,
+      483364019,   484166400,   484968710,   485770949,   486573117,   487375212,   488177236,   488979189,
+      489781069,   490582878,   491384614,   492186278,   492987869,   493789388,   494590835,   495392208,
+      496193509,   496994737,   497795892,   498596973,   499397982,   500198916,   500999778,   501800565,
+      502601279,   503401919,   504202485,   505002976,   505803394,   506603737,   507404005,   508204199,
+      509004318,   509804362,   510604332,   511404226,   512204045,   513003788,   513803457,   514603049,
+      515402566,   516202007,   517001373,   517800662,   518599875,   519399012,   520198072,   520997056,
+      521795963,   522594794,   523393547,   524192224,   524990824,   525789346,   526587791,   527386159,
+      528184449,   528982661,   529780796,   530578852,   531376831,   532174731,   532972554,   533770298,
+      534567963,   535365550,   536163058,   536960487,   537757837,   538555108,   539352300,   540149412,
+      540946445,   541743399,   542540273,   543337067,   544133781,   544930415,   545726969,   546523443,
+      547319836,   548116149,   548912382,   549708533,   550504604,   551300594,   552096502,   552892330,
+      553688076,   554483741,   555279324,   556074825,   556870245,   557665583,   558460839,   559256012,
+      560051104,   560846113,   561641039,   562435883,   563230645,   564025323,   564819919,   565614431,
+      566408860,   567203206,   567997469,   568791648,   569585743,   570379754,   571173682,   571967526,
+      572761285,   573554961,   574348552,   575142058,   575935480,   576728817,   577522070,   578315237,
+      579108320,   579901317,   580694229,   581487055,   582279796,   583072452,   583865021,   584657505,
+      585449903,   586242215,   587034440,   587826579,   588618632,   589410598,   590202477,   590994270,
+      591785976,   592577595,   593369126,   594160570,   594951927,   595743197,   596534378,   597325472,
+      598116479,   598907397,   599698227,   600488969,   601279623,   602070188,   602860664,   603651052,
+      604441352,   605231562,   606021683,   606811716,   607601658,   608391512,   609181276,   609970951,
+      610760536,   611550031,   612339436,   613128751,   613917975,   614707110,   615496154,   616285108,
+      617073971,   617862743,   618651424,   619440015,   620228514,   621016922,   621805239,   622593464,
+      623381598,   624169640,   624957590,   625745448,   626533215,   627320889,   628108471,   628895960,
+      629683357,   630470662,   631257873,   632044992,   632832018,   633618951,   634405791,   635192537,
+      635979190,   636765749,   637552215,   638338587,   639124865,   639911049,   640697139,   641483135,
+      642269036,   643054843,   643840556,   644626174,   645411696,   646197124,   646982457,   647767695,
+      648552838,   649337885,   650122837,   650907693,   651692453,   652477117,   653261686,   654046158,
+      654830535,   655614815,   656398998,   657183085,   657967075,   658750969,   659534766,   660318465,
+      661102068,   661885573,   662668981,   663452292,   664235505,   665018620,   665801638,   666584557,
+      667367379,   668150102,   668932727,   669715254,   670497682,   671280012,   672062243,   672844375,
+      673626408,   674408342,   675190177,   675971913,   676753549,   677535085,   678316522,   679097860,
+      679879097,   680660234,   681441272,   682222209,   683003045,   683783782,   684564417,   685344952,
+      686125387,   686905720,   687685952,   688466083,   689246113,   690026042,   690805869,   691585594,
+      692365218,   693144740,   693924160,   694703478,   695482694,   696261807,   697040818,   697819727,
+      698598533,   699377236,   700155836,   700934334,   701712728,   702491019,   703269207,   704047291,
+      704825272,   705603149,   706380923,   707158592,   707936158,   708713619,   709490976,   710268229,
+      711045377,   711822421,   712599360,   713376195,   714152924,   714929548,   715706067,   716482481,
+      717258790,   718034993,   718811090,   719587082,   720362968,   721138748,   721914422,   722689990,
+      723465451,   724240806,   725016055,   725791197,   726566232,   727341160,   728115982,   728890696,
+      729665303,   730439803,   731214195,   731988480,   732762657,   733536727,   734310688,   735084542,
+      735858287,   736631924,   737405453,   738178874,   738952186,   739725389,   740498483,   741271469,
+      742044345,   742817112,   743589770,   744362319,   745134758,   745907088,   746679308,   747451418,
+      748223418,   748995309,   749767089,   750538758,   751310318,   752081767,   752853105,   753624333,
+      754395449,   755166455,   755937350,   756708133,   757478806,   758249367,   759019816,   759790154,
+      760560380,   761330494,   762100496,   762870386,   763640164,   764409829,   765179382,   765948823,
+      766718151,   767487366,   768256469,   769025458,   769794334,   770563097,   771331747,   772100283,
+      772868706,   773637015,   774405210,   775173292,   775941259,   776709112,   777476851,   778244476,
+      779011986,   779779382,   780546663,   781313829,   782080880,   782847817,   783614638,   784381344,
+      785147934,   785914409,   786680769,   787447013,   788213141,   788979153,   789745049,   790510829,
+      791276492,   792042039,   792807470,   793572784,   794337982,   795103062,   795868026,   796632873,
+      797397602,   798162214,   798926709,   799691087,   800455346,   801219488,   801983513,   802747419,
+      803511207,   804274877,   805038429,   805801862,   806565177,   807328373,   808091450,   808854409,
+      809617249,   810379969,   811142571,   811905053,   812667415,   813429659,   814191782,   814953786,
+      815715670,   816477434,   817239078,   818000602,   818762005,   819523288,   820284450,   821045492,
+      821806413,   822567214,   823327893,   824088451,   824848888,   825609204,   826369398,   827129471,
+      827889422,   828649251,   829408958,   830168544,   830928007,   831687348,   832446567,   833205664,
+      833964638,   834723489,   835482217,   836240823,   836999305,   837757665,   838515901,   839274014,
+      840032004,   840789870,   841547612,   842305231,   843062726,   843820096,   844577343,   845334465,
+      846091463,   846848337,   847605086,   848361711,   849118210,   849874585,   850630835,   851386960,
+      852142959,   852898834,   853654582,   854410206,   855165703,   855921075,   856676321,   857431441,
+      858186435,   858941302,   859696043,   860450658,   861205147,   861959508,   862713743,   863467851,
+      864221832,   864975686,   865729413,   866483012,   867236484,   867989828,   868743045,   869496134,
+      870249095,   871001928,   871754633,   872507210,   873259659,   874011979,   874764170,   875516233,
+      876268167,   877019973,   877771649,   878523196,   879274614,   880025903,   880777062,   881528092,
+      882278992,   883029762,   883780402,   884530913,   885281293,   886031543,   886781663,   887531653,
+      888281512,   889031240,   889780838,   890530304,   891279640,   892028845,   892777918,   893526860,
+      894275671,   895024350,   895772898,   896521313,   897269597,   898017749,   898765769,   899513657,
+      900261413,   901009036,   901756526,   902503884,   903251110,   903998202,   904745161,   905491988,
+      906238681,   906985241,   907731667,   908477961,   909224120,   909970146,   910716038,   911461795,
+      912207419,   912952909,   913698265,   914443486,   915188572,   915933524,   916678342,   917423024,
+      918167572,   918911984,   919656262,   920400404,   921144411,   921888282,   922632018,   923375618,
+      924119082,   924862410,   925605603,   926348659,   927091579,   927834362,   928577010,   929319520,
+      930061894,   930804131,   931546231,   932288195,   933030021,   933771710,   934513261,   935254675,
+      935995952,   936737091,   937478092,   938218955,   938959681,   939700268,   940440717,   941181028,
+      941921200,   942661234,   943401129,   944140885,   944880503,   945619981,   946359321,   947098521,
+      947837582,   948576504,   949315286,   950053929,   950792431,   951530794,   952269017,   953007100,
+      953745043,   954482846,   955220508,   955958030,   956695411,   957432651,   958169751,   958906709,
+      959643527,   960380204,   961116739,   961853133,   962589385,   963325496,   964061465,   964797293,
+      965532978,   966268522,   967003923,   967739183,   968474300,   969209274,   969944106,   970678795,
+      971413342,   972147745,   972882006,   973616124,   974350098,   975083929,   975817617,   976551161,
+      977284562,   978017819,   978750932,   979483901,   980216726,   980949407,   981681943,   982414336,
+      983146583,   983878686,   984610645,   985342459,   986074127,   986805651,   987537030,   988268263,
+      988999351,   989730294,   990461091,   991191742,   991922248,   992652607,   993382821,   994112889,
+      994842810,   995572585,   996302214,   997031696,   997761031,   998490220,   999219262,   999948157,
+     1000676905,  1001405506,  1002133959,  1002862265,  1003590424,  1004318435,  1005046298,  1005774014,
+     1006501581,  1007229001,  1007956272,  1008683395,  1009410370,  1010137197,  1010863875,  1011590404,
+     1012316784,  1013043016,  1013769098,  1014495031,  1015220816,  1015946451,  1016671936,  1017397272,
+     1018122458,  1018847495,  1019572382,  1020297119,  1021021705,  1021746142,  1022470428,  1023194564,
+     1023918550,  1024642385,  1025366069,  1026089602,  1026812985,  1027536217,  1028259297,  1028982226,
+     1029705004,  1030427630,  1031150105,  1031872428,  1032594600,  1033316619,  1034038487,  1034760203,
+     1035481766,  1036203177,  1036924436,  1037645542,  1038366495,  1039087296,  1039807944,  1040528439,
+     1041248781,  1041968970,  1042689006,  1043408889,  1044128617,  1044848193,  1045567615,  1046286882,
+     1047005996,  1047724957,  1048443763,  1049162414,  1049880912,  1050599255,  1051317443,  1052035477,
+     1052753357,  1053471081,  1054188651,  1054906065,  1055623324,  1056340428,  1057057377,  1057774170,
+     1058490808,  1059207290,  1059923616,  1060639786,  1061355801,  1062071659,  1062787361,  1063502907,
+     1064218296,  1064933529,  1065648605,  1066363525,  1067078288,  1067792893,  1068507342,  1069221634,
+     1069935768,  1070649745,  1071363564,  1072077226,  1072790730,  1073504077,  1074217266,  1074930296,
+     1075643169,  1076355883,  1077068439,  1077780837,  1078493076,  1079205156,  1079917078,  1080628841,
+     1081340445,  1082051890,  1082763176,  1083474303,  1084185270,  1084896078,  1085606726,  1086317215,
+     1087027544,  1087737713,  1088447722,  1089157571,  1089867259,  1090576788,  1091286156,  1091995364,
+     1092704411,  1093413297,  1094122023,  1094830587,  1095538991,  1096247233,  1096955314,  1097663234,
+     1098370993,  1099078590,  1099786025,  1100493299,  1101200410,  1101907360,  1102614148,  1103320773,
+     1104027237,  1104733537,  1105439676,  1106145652,  1106851465,  1107557115,  1108262603,  1108967927,
+     1109673089,  1110378087,  1111082922,  1111787593,  1112492101,  1113196446,  1113900627,  1114604643,
+     1115308496,  1116012185,  1116715710,  1117419071,  1118122267,  1118825299,  1119528166,  1120230868,
+     1120933406,  1121635779,  1122337987,  1123040030,  1123741908,  1124443621,  1125145168,  1125846549,
+     1126547765,  1127248816,  1127949701,  1128650419,  1129350972,  1130051359,  1130751579,  1131451633,
+     1132151521,  1132851242,  1133550797,  1134250185,  1134949406,  1135648460,  1136347348,  1137046068,
+     1137744621,  1138443006,  1139141224,  1139839275,  1140537158,  1141234873,  1141932420,  1142629800,
+     1143327011,  1144024054,  1144720929,  1145417636,  1146114174,  1146810544,  1147506745,  1148202777,
+     1148898640,  1149594335,  1150289860,  1150985216,  1151680403,  1152375421,  1153070269,  1153764947,
+     1154459456,  1155153795,  1155847964,  1156541963,  1157235792,  1157929451,  1158622939,  1159316257,
+     1160009405,  1160702382,  1161395188,  1162087824,  1162780288,  1163472582,  1164164704,  1164856655,
+     1165548435,  1166240044,  1166931481,  1167622746,  1168313840,  1169004762,  1169695512,  1170386090,
+     1171076495,  1171766729,  1172456790,  1173146679,  1173836395,  1174525939,  1175215310,  1175904508,
+     1176593533,  1177282385,  1177971064,  1178659570,  1179347902,  1180036061,  1180724046,  1181411858,
+     1182099496,  1182786960,  1183474250,  1184161366,  1184848308,  1185535076,  1186221669,  1186908088,
+     1187594332,  1188280402,  1188966297,  1189652017,  1190337562,  1191022932,  1191708127,  1192393146,
+     1193077991,  1193762659,  1194447153,  1195131470,  1195815612,  1196499578,  1197183368,  1197866982,
+     1198550419,  1199233681,  1199916766,  1200599675,  1201282407,  1201964962,  1202647340,  1203329542,
+     1204011567,  1204693415,  1205375085,  1206056578,  1206737894,  1207419033,  1208099993,  1208780776,
+     1209461382,  1210141809,  1210822059,  1211502130,  1212182024,  1212861738,  1213541275,  1214220633,
+     1214899813,  1215578814,  1216257636,  1216936279,  1217614743,  1218293029,  1218971135,  1219649061,
+     1220326809,  1221004377,  1221681765,  1222358974,  1223036002,  1223712852,  1224389521,  1225066010,
+     1225742318,  1226418447,  1227094395,  1227770163,  1228445750,  1229121156,  1229796382,  1230471427,
+     1231146291,  1231820974,  1232495475,  1233169796,  1233843935,  1234517892,  1235191668,  1235865263,
+     1236538675,  1237211906,  1237884955,  1238557822,  1239230506,  1239903009,  1240575329,  1241247466,
+     1241919421,  1242591194,  1243262783,  1243934190,  1244605414,  1245276454,  1245947312,  1246617986,
+     1247288478,  1247958785,  1248628909,  1249298850,  1249968606,  1250638179,  1251307568,  1251976773,
+     1252645794,  1253314630,  1253983283,  1254651751,  1255320034,  1255988133,  1256656047,  1257323776,
+     1257991320,  1258658679,  1259325853,  1259992842,  1260659646,  1261326264,  1261992697,  1262658944,
+     1263325005,  1263990881,  1264656571,  1265322074,  1265987392,  1266652523,  1267317469,  1267982227,
+     1268646800,  1269311185,  1269975384,  1270639397,  1271303222,  1271966861,  1272630312,  1273293576,
+     1273956653,  1274619543,  1275282245,  1275944759,  1276607086,  1277269225,  1277931177,  1278592940,
+     1279254516,  1279915903,  1280577102,  1281238112,  1281898935,  1282559568,  1283220013,  1283880270,
+     1284540337,  1285200216,  1285859905,  1286519406,  1287178717,  1287837839,  1288496772,  1289155515,
+     1289814068,  1290472432,  1291130606,  1291788590,  1292446384,  1293103988,  1293761402,  1294418626,
+     1295075659,  1295732502,  1296389154,  1297045616,  1297701886,  1298357966,  1299013855,  1299669553,
+     1300325060,  1300980376,  1301635500,  1302290433,  1302945174,  1303599724,  1304254082,  1304908248,
+     1305562222,  1306216004,  1306869594,  1307522992,  1308176198,  1308829211,  1309482032,  1310134660,
+     1310787095,  1311439338,  1312091388,  1312743245,  1313394909,  1314046379,  1314697657,  1315348741,
+     1315999631,  1316650328,  1317300832,  1317951141,  1318601257,  1319251179,  1319900907,  1320550441,
+     1321199781,  1321848926,  1322497877,  1323146633,  1323795195,  1324443562,  1325091734,  1325739712,
+     1326387494,  1327035081,  1327682474,  1328329671,  1328976672,  1329623478,  1330270089,  1330916504,
+     1331562723,  1332208746,  1332854574,  1333500205,  1334145641,  1334790880,  1335435923,  1336080769,
+     1336725419,  1337369872,  1338014129,  1338658189,  1339302052,  1339945718,  1340589187,  1341232459,
+     1341875533,  1342518410,  1343161090,  1343803572,  1344445857,  1345087944,  1345729833,  1346371524,
+     1347013017,  1347654312,  1348295409,  1348936307,  1349577007,  1350217509,  1350857812,  1351497917,
+     1352137822,  1352777529,  1353417037,  1354056346,  1354695455,  1355334366,  1355973077,  1356611589,
+     1357249901,  1357888013,  1358525926,  1359163639,  1359801152,  1360438465,  1361075579,  1361712491,
+     1362349204,  1362985716,  1363622028,  1364258140,  1364894050,  1365529760,  1366165269,  1366800578,
+     1367435685,  1368070591,  1368705296,  1369339799,  1369974101,  1370608202,  1371242101,  1371875799,
+     1372509294,  1373142588,  1373775680,  1374408570,  1375041258,  1375673743,  1376306026,  1376938107,
+     1377569986,  1378201661,  1378833134,  1379464404,  1380095472,  1380726336,  1381356997,  1381987456,
+     1382617710,  1383247762,  1383877610,  1384507255,  1385136696,  1385765933,  1386394966,  1387023796,
+     1387652422,  1388280843,  1388909060,  1389537074,  1390164882,  1390792487,  1391419886,  1392047081,
+     1392674072,  1393300857,  1393927438,  1394553813,  1395179984,  1395805949,  1396431709,  1397057264,
+     1397682613,  1398307757,  1398932695,  1399557427,  1400181954,  1400806274,  1401430389,  1402054297,
+     1402678000,  1403301495,  1403924785,  1404547868,  1405170745,  1405793414,  1406415878,  1407038134,
+     1407660183,  1408282026,  1408903661,  1409525089,  1410146309,  1410767323,  1411388129,  1412008727,
+     1412629117,  1413249300,  1413869275,  1414489042,  1415108601,  1415727952,  1416347095,  1416966029,
+     1417584755,  1418203273,  1418821582,  1419439682,  1420057574,  1420675256,  1421292730,  1421909995,
+     1422527051,  1423143897,  1423760534,  1424376962,  1424993180,  1425609189,  1426224988,  1426840577,
+     1427455956,  1428071126,  1428686085,  1429300835,  1429915374,  1430529703,  1431143821,  1431757729,
+     1432371426,  1432984913,  1433598189,  1434211254,  1434824109,  1435436752,  1436049184,  1436661405,
+     1437273414,  1437885213,  1438496799,  1439108175,  1439719338,  1440330290,  1440941030,  1441551558,
+     1442161874,  1442771978,  1443381870,  1443991550,  1444601017,  1445210271,  1445819314,  1446428143,
+     1447036760,  1447645164,  1448253355,  1448861333,  1449469098,  1450076650,  1450683988,  1451291114,
+     1451898025,  1452504724,  1453111208,  1453717479,  1454323536,  1454929380,  1455535009,  1456140424,
+     1456745625,  1457350612,  1457955385,  1458559943,  1459164286,  1459768415,  1460372329,  1460976029,
+     1461579514,  1462182783,  1462785838,  1463388677,  1463991302,  1464593711,  1465195904,  1465797882,
+     1466399645,  1467001192,  1467602523,  1468203638,  1468804538,  1469405221,  1470005688,  1470605939,
+     1471205974,  1471805792,  1472405394,  1473004780,  1473603949,  1474202901,  1474801636,  1475400154,
+     1475998456,  1476596540,  1477194407,  1477792057,  1478389489,  1478986705,  1479583702,  1480180482,
+     1480777044,  1481373389,  1481969516,  1482565424,  1483161115,  1483756588,  1484351842,  1484946878,
+     1485541696,  1486136295,  1486730675,  1487324837,  1487918781,  1488512505,  1489106011,  1489699297,
+     1490292364,  1490885213,  1491477842,  1492070251,  1492662441,  1493254412,  1493846163,  1494437694,
+     1495029006,  1495620098,  1496210969,  1496801621,  1497392053,  1497982264,  1498572255,  1499162026,
+     1499751576,  1500340905,  1500930014,  1501518902,  1502107570,  1502696016,  1503284242,  1503872246,
+     1504460029,  1505047591,  1505634932,  1506222051,  1506808949,  1507395625,  1507982079,  1508568312,
+     1509154322,  1509740111,  1510325678,  1510911022,  1511496145,  1512081045,  1512665723,  1513250178,
+     1513834411,  1514418421,  1515002208,  1515585772,  1516169114,  1516752233,  1517335128,  1517917801,
+     1518500250,  1519082476,  1519664478,  1520246257,  1520827813,  1521409144,  1521990252,  1522571137,
+     1523151797,  1523732233,  1524312445,  1524892433,  1525472197,  1526051736,  1526631051,  1527210141,
+     1527789007,  1528367648,  1528946064,  1529524256,  1530102222,  1530679964,  1531257480,  1531834771,
+     1532411837,  1532988678,  1533565293,  1534141682,  1534717846,  1535293784,  1535869497,  1536444983,
+     1537020244,  1537595278,  1538170087,  1538744669,  1539319024,  1539893154,  1540467057,  1541040733,
+     1541614183,  1542187406,  1542760402,  1543333172,  1543905714,  1544478030,  1545050118,  1545621979,
+     1546193612,  1546765019,  1547336197,  1547907149,  1548477872,  1549048368,  1549618636,  1550188676,
+     1550758488,  1551328072,  1551897428,  1552466556,  1553035455,  1553604126,  1554172569,  1554740783,
+     1555308768,  1555876524,  1556444052,  1557011351,  1557578421,  1558145261,  1558711873,  1559278255,
+     1559844408,  1560410332,  1560976026,  1561541490,  1562106725,  1562671730,  1563236506,  1563801051,
+     1564365367,  1564929452,  1565493307,  1566056932,  1566620327,  1567183491,  1567746425,  1568309128,
+     1568871601,  1569433843,  1569995854,  1570557634,  1571119183,  1571680501,  1572241588,  1572802444,
+     1573363068,  1573923461,  1574483623,  1575043553,  1575603251,  1576162718,  1576721952,  1577280955,
+     1577839726,  1578398265,  1578956572,  1579514647,  1580072489,  1580630099,  1581187476,  1581744621,
+     1582301533,  1582858213,  1583414660,  1583970873,  1584526854,  1585082602,  1585638117,  1586193399,
+     1586748447,  1587303262,  1587857843,  1588412191,  1588966306,  1589520187,  1590073833,  1590627247,
+     1591180426,  1591733371,  1592286082,  1592838559,  1593390801,  1593942810,  1594494583,  1595046123,
+     1595597428,  1596148498,  1596699333,  1597249934,  1597800299,  1598350430,  1598900325,  1599449986,
+     1599999411,  1600548601,  1601097555,  1601646274,  1602194758,  1602743006,  1603291018,  1603838794,
+     1604386335,  1604933639,  1605480708,  1606027540,  1606574136,  1607120496,  1607666620,  1608212507,
+     1608758157,  1609303571,  1609848749,  1610393689,  1610938393,  1611482860,  1612027089,  1612571082,
+     1613114838,  1613658356,  1614201637,  1614744681,  1615287487,  1615830055,  1616372386,  1616914479,
+     1617456335,  1617997952,  1618539332,  1619080473,  1619621377,  1620162042,  1620702469,  1621242658,
+     1621782608,  1622322319,  1622861793,  1623401027,  1623940023,  1624478779,  1625017297,  1625555576,
+     1626093616,  1626631417,  1627168978,  1627706300,  1628243383,  1628780226,  1629316830,  1629853194,
+     1630389319,  1630925203,  1631460848,  1631996253,  1632531418,  1633066343,  1633601027,  1634135472,
+     1634669676,  1635203639,  1635737362,  1636270845,  1636804087,  1637337088,  1637869848,  1638402368,
+     1638934646,  1639466684,  1639998480,  1640530036,  1641061349,  1641592422,  1642123253,  1642653843,
+     1643184191,  1643714297,  1644244162,  1644773785,  1645303166,  1645832305,  1646361202,  1646889857,
+     1647418269,  1647946439,  1648474367,  1649002053,  1649529496,  1650056696,  1650583654,  1651110369,
+     1651636841,  1652163070,  1652689057,  1653214800,  1653740300,  1654265557,  1654790570,  1655315341,
+     1655839867,  1656364151,  1656888190,  1657411986,  1657935539,  1658458847,  1658981911,  1659504732,
+     1660027308,  1660549641,  1661071729,  1661593572,  1662115172,  1662636527,  1663157637,  1663678503,
+     1664199124,  1664719501,  1665239632,  1665759519,  1666279161,  1666798557,  1667317709,  1667836615,
+     1668355276,  1668873692,  1669391862,  1669909787,  1670427466,  1670944900,  1671462087,  1671979029,
+     1672495725,  1673012175,  1673528379,  1674044337,  1674560049,  1675075514,  1675590733,  1676105706,
+     1676620432,  1677134911,  1677649144,  1678163130,  1678676870,  1679190362,  1679703608,  1680216606,
+     1680729357,  1681241862,  1681754118,  1682266128,  1682777890,  1683289405,  1683800672,  1684311692,
+     1684822463,  1685332987,  1685843263,  1686353292,  1686863072,  1687372604,  1687881888,  1688390924,
+     1688899711,  1689408250,  1689916541,  1690424583,  1690932376,  1691439921,  1691947217,  1692454264,
+     1692961062,  1693467612,  1693973912,  1694479963,  1694985765,  1695491317,  1695996621,  1696501674,
+     1697006479,  1697511033,  1698015339,  1698519394,  1699023199,  1699526755,  1700030061,  1700533117,
+     1701035922,  1701538478,  1702040783,  1702542838,  1703044642,  1703546196,  1704047500,  1704548553,
+     1705049355,  1705549906,  1706050207,  1706550257,  1707050055,  1707549603,  1708048900,  1708547945,
+     1709046739,  1709545282,  1710043573,  1710541613,  1711039401,  1711536938,  1712034223,  1712531256,
+     1713028037,  1713524566,  1714020844,  1714516869,  1715012642,  1715508163,  1716003431,  1716498448,
+     1716993211,  1717487723,  1717981981,  1718475987,  1718969740,  1719463241,  1719956488,  1720449483,
+     1720942225,  1721434713,  1721926948,  1722418931,  1722910659,  1723402135,  1723893357,  1724384325,
+     1724875040,  1725365501,  1725855708,  1726345662,  1726835361,  1727324807,  1727813999,  1728302936,
+     1728791620,  1729280049,  1729768224,  1730256144,  1730743810,  1731231221,  1731718378,  1732205280,
+     1732691928,  1733178320,  1733664458,  1734150340,  1734635968,  1735121341,  1735606458,  1736091320,
+     1736575927,  1737060278,  1737544374,  1738028214,  1738511799,  1738995128,  1739478202,  1739961019,
+     1740443581,  1740925886,  1741407936,  1741889729,  1742371267,  1742852548,  1743333573,  1743814341,
+     1744294853,  1744775108,  1745255107,  1745734849,  1746214334,  1746693563,  1747172535,  1747651249,
+     1748129707,  1748607908,  1749085851,  1749563537,  1750040966,  1750518137,  1750995052,  1751471708,
+     1751948107,  1752424248,  1752900132,  1753375758,  1753851126,  1754326236,  1754801087,  1755275681,
+     1755750017,  1756224095,  1756697914,  1757171475,  1757644777,  1758117821,  1758590607,  1759063133,
+     1759535401,  1760007411,  1760479161,  1760950653,  1761421885,  1761892859,  1762363573,  1762834028,
+     1763304224,  1763774161,  1764243838,  1764713256,  1765182414,  1765651313,  1766119952,  1766588331,
+     1767056450,  1767524310,  1767991909,  1768459249,  1768926328,  1769393148,  1769859707,  1770326006,
+     1770792044,  1771257822,  1771723340,  1772188597,  1772653593,  1773118328,  1773582803,  1774047017,
+     1774510970,  1774974663,  1775438094,  1775901264,  1776364172,  1776826820,  1777289206,  1777751331,
+     1778213194,  1778674796,  1779136137,  1779597215,  1780058032,  1780518587,  1780978881,  1781438912,
+     1781898681,  1782358189,  1782817434,  1783276417,  1783735137,  1784193596,  1784651792,  1785109725,
+     1785567396,  1786024805,  1786481950,  1786938833,  1787395453,  1787851811,  1788307905,  1788763736,
+     1789219305,  1789674610,  1790129652,  1790584430,  1791038946,  1791493198,  1791947186,  1792400911,
+     1792854372,  1793307570,  1793760504,  1794213174,  1794665580,  1795117722,  1795569601,  1796021215,
+     1796472565,  1796923651,  1797374472,  1797825030,  1798275323,  1798725351,  1799175115,  1799624614,
+     1800073849,  1800522818,  1800971523,  1801419964,  1801868139,  1802316049,  1802763694,  1803211074,
+     1803658189,  1804105039,  1804551623,  1804997942,  1805443995,  1805889783,  1806335305,  1806780562,
+     1807225553,  1807670278,  1808114737,  1808558931,  1809002858,  1809446519,  1809889915,  1810333044,
+     1810775906,  1811218503,  1811660833,  1812102897,  1812544694,  1812986225,  1813427489,  1813868486,
+     1814309216,  1814749680,  1815189877,  1815629807,  1816069469,  1816508865,  1816947994,  1817386855,
+     1817825449,  1818263776,  1818701835,  1819139627,  1819577151,  1820014408,  1820451397,  1820888118,
+     1821324572,  1821760758,  1822196675,  1822632325,  1823067707,  1823502820,  1823937666,  1824372243,
+     1824806552,  1825240592,  1825674364,  1826107868,  1826541103,  1826974069,  1827406767,  1827839196,
+     1828271356,  1828703247,  1829134869,  1829566223,  1829997307,  1830428122,  1830858668,  1831288944,
+     1831718951,  1832148689,  1832578158,  1833007357,  1833436286,  1833864946,  1834293336,  1834721456,
+     1835149306,  1835576887,  1836004197,  1836431238,  1836858008,  1837284509,  1837710739,  1838136698,
+     1838562388,  1838987807,  1839412956,  1839837834,  1840262441,  1840686778,  1841110844,  1841534640,
+     1841958164,  1842381418,  1842804401,  1843227113,  1843649553,  1844071723,  1844493621,  1844915248,
+     1845336604,  1845757688,  1846178501,  1846599042,  1847019312,  1847439310,  1847859036,  1848278491,
+     1848697674,  1849116585,  1849535224,  1849953591,  1850371686,  1850789508,  1851207059,  1851624337,
+     1852041343,  1852458077,  1852874538,  1853290727,  1853706643,  1854122287,  1854537657,  1854952756,
+     1855367581,  1855782133,  1856196413,  1856610419,  1857024153,  1857437613,  1857850800,  1858263714,
+     1858676355,  1859088722,  1859500816,  1859912636,  1860324183,  1860735457,  1861146456,  1861557182,
+     1861967634,  1862377813,  1862787717,  1863197347,  1863606704,  1864015786,  1864424594,  1864833128,
+     1865241388,  1865649374,  1866057085,  1866464521,  1866871683,  1867278571,  1867685184,  1868091522,
+     1868497586,  1868903374,  1869308888,  1869714127,  1870119091,  1870523780,  1870928194,  1871332333,
+     1871736196,  1872139784,  1872543097,  1872946135,  1873348897,  1873751383,  1874153594,  1874555530,
+     1874957189,  1875358573,  1875759681,  1876160513,  1876561070,  1876961350,  1877361354,  1877761083,
+     1878160535,  1878559710,  1878958610,  1879357233,  1879755580,  1880153650,  1880551444,  1880948961,
+     1881346202,  1881743166,  1882139853,  1882536263,  1882932397,  1883328253,  1883723833,  1884119136,
+     1884514161,  1884908909,  1885303381,  1885697574,  1886091491,  1886485130,  1886878492,  1887271576,
+     1887664383,  1888056912,  1888449163,  1888841137,  1889232832,  1889624250,  1890015391,  1890406253,
+     1890796837,  1891187143,  1891577171,  1891966920,  1892356392,  1892745585,  1893134500,  1893523136,
+     1893911494,  1894299573,  1894687374,  1895074896,  1895462140,  1895849104,  1896235790,  1896622197,
+     1897008325,  1897394174,  1897779744,  1898165035,  1898550047,  1898934779,  1899319232,  1899703406,
+     1900087301,  1900470916,  1900854251,  1901237307,  1901620084,  1902002580,  1902384797,  1902766735,
+     1903148392,  1903529769,  1903910867,  1904291685,  1904672222,  1905052479,  1905432457,  1905812153,
+     1906191570,  1906570706,  1906949562,  1907328138,  1907706433,  1908084447,  1908462181,  1908839634,
+     1909216806,  1909593698,  1909970309,  1910346639,  1910722688,  1911098455,  1911473942,  1911849148,
+     1912224073,  1912598716,  1912973078,  1913347159,  1913720958,  1914094476,  1914467712,  1914840667,
+     1915213340,  1915585732,  1915957841,  1916329669,  1916701216,  1917072480,  1917443462,  1917814163,
+     1918184581,  1918554717,  1918924571,  1919294143,  1919663432,  1920032440,  1920401165,  1920769607,
+     1921137767,  1921505644,  1921873239,  1922240551,  1922607581,  1922974327,  1923340791,  1923706972,
+     1924072871,  1924438486,  1924803818,  1925168867,  1925533633,  1925898115,  1926262315,  1926626231,
+     1926989864,  1927353213,  1927716279,  1928079062,  1928441561,  1928803776,  1929165708,  1929527356,
+     1929888720,  1930249800,  1930610597,  1930971109,  1931331338,  1931691282,  1932050943,  1932410319,
+     1932769411,  1933128219,  1933486742,  1933844982,  1934202936,  1934560607,  1934917992,  1935275094,
+     1935631910,  1935988442,  1936344689,  1936700652,  1937056329,  1937411722,  1937766830,  1938121653,
+     1938476190,  1938830443,  1939184411,  1939538093,  1939891490,  1940244602,  1940597428,  1940949969,
+     1941302225,  1941654195,  1942005880,  1942357279,  1942708392,  1943059219,  1943409761,  1943760017,
+     1944109987,  1944459671,  1944809070,  1945158182,  1945507008,  1945855548,  1946203802,  1946551769,
+     1946899451,  1947246846,  1947593954,  1947940777,  1948287312,  1948633562,  1948979524,  1949325200,
+     1949670589,  1950015692,  1950360508,  1950705037,  1951049279,  1951393234,  1951736902,  1952080283,
+     1952423377,  1952766184,  1953108703,  1953450936,  1953792881,  1954134539,  1954475909,  1954816992,
+     1955157788,  1955498296,  1955838516,  1956178449,  1956518093,  1956857451,  1957196520,  1957535302,
+     1957873796,  1958212001,  1958549919,  1958887549,  1959224890,  1959561944,  1959898709,  1960235186,
+     1960571375,  1960907276,  1961242888,  1961578211,  1961913246,  1962247993,  1962582451,  1962916621,
+     1963250501,  1963584093,  1963917396,  1964250411,  1964583136,  1964915573,  1965247720,  1965579579,
+     1965911148,  1966242429,  1966573420,  1966904122,  1967234535,  1967564658,  1967894492,  1968224037,
+     1968553292,  1968882257,  1969210933,  1969539320,  1969867417,  1970195224,  1970522741,  1970849968,
+     1971176906,  1971503554,  1971829912,  1972155980,  1972481757,  1972807245,  1973132443,  1973457350,
+     1973781967,  1974106294,  1974430331,  1974754077,  1975077532,  1975400698,  1975723572,  1976046157,
+     1976368450,  1976690453,  1977012165,  1977333587,  1977654717,  1977975557,  1978296106,  1978616364,
+     1978936331,  1979256007,  1979575392,  1979894485,  1980213288,  1980531799,  1980850019,  1981167948,
+     1981485585,  1981802931,  1982119985,  1982436748,  1982753220,  1983069400,  1983385288,  1983700884,
+     1984016189,  1984331202,  1984645923,  1984960352,  1985274489,  1985588335,  1985901888,  1986215149,
+     1986528118,  1986840795,  1987153180,  1987465272,  1987777073,  1988088580,  1988399796,  1988710719,
+     1989021350,  1989331688,  1989641733,  1989951486,  1990260946,  1990570114,  1990878989,  1991187570,
+     1991495860,  1991803856,  1992111559,  1992418969,  1992726087,  1993032911,  1993339442,  1993645680,
+     1993951625,  1994257276,  1994562635,  1994867700,  1995172471,  1995476949,  1995781134,  1996085025,
+     1996388622,  1996691926,  1996994937,  1997297653,  1997600076,  1997902205,  1998204040,  1998505582,
+     1998806829,  1999107782,  1999408442,  1999708807,  2000008879,  2000308656,  2000608139,  2000907328,
+     2001206222,  2001504822,  2001803128,  2002101140,  2002398857,  2002696279,  2002993407,  2003290240,
+     2003586779,  2003883023,  2004178973,  2004474627,  2004769987,  2005065052,  2005359822,  2005654297,
+     2005948478,  2006242363,  2006535953,  2006829248,  2007122248,  2007414953,  2007707362,  2007999477,
+     2008291295,  2008582819,  2008874047,  2009164980,  2009455617,  2009745959,  2010036005,  2010325756,
+     2010615210,  2010904370,  2011193233,  2011481801,  2011770073,  2012058048,  2012345729,  2012633113,
+     2012920201,  2013206993,  2013493489,  2013779689,  2014065592,  2014351200,  2014636511,  2014921526,
+     2015206245,  2015490667,  2015774793,  2016058622,  2016342155,  2016625391,  2016908331,  2017190974,
+     2017473321,  2017755370,  2018037123,  2018318580,  2018599739,  2018880602,  2019161167,  2019441436,
+     2019721407,  2020001082,  2020280460,  2020559540,  2020838323,  2021116809,  2021394998,  2021672890,
+     2021950484,  2022227781,  2022504780,  2022781482,  2023057887,  2023333994,  2023609803,  2023885315,
+     2024160529,  2024435445,  2024710064,  2024984385,  2025258408,  2025532133,  2025805561,  2026078690,
+     2026351522,  2026624055,  2026896291,  2027168228,  2027439867,  2027711208,  2027982251,  2028252996,
+     2028523442,  2028793590,  2029063439,  2029332990,  2029602243,  2029871197,  2030139853,  2030408210,
+     2030676269,  2030944029,  2031211490,  2031478652,  2031745516,  2032012081,  2032278347,  2032544314,
+     2032809982,  2033075351,  2033340422,  2033605193,  2033869665,  2034133838,  2034397712,  2034661286,
+     2034924562,  2035187538,  2035450215,  2035712592,  2035974670,  2036236449,  2036497928,  2036759108,
+     2037019988,  2037280569,  2037540850,  2037800831,  2038060512,  2038319894,  2038578976,  2038837759,
+     2039096241,  2039354424,  2039612306,  2039869889,  2040127172,  2040384154,  2040640837,  2040897219,
+     2041153301,  2041409084,  2041664565,  2041919747,  2042174628,  2042429209,  2042683490,  2042937470,
+     2043191150,  2043444529,  2043697608,  2043950386,  2044202863,  2044455040,  2044706916,  2044958492,
+     2045209767,  2045460741,  2045711414,  2045961786,  2046211857,  2046461628,  2046711097,  2046960266,
+     2047209133,  2047457700,  2047705965,  2047953929,  2048201592,  2048448953,  2048696014,  2048942773,
+     2049189231,  2049435387,  2049681242,  2049926796,  2050172048,  2050416998,  2050661647,  2050905995,
+     2051150040,  2051393785,  2051637227,  2051880368,  2052123207,  2052365744,  2052607979,  2052849913,
+     2053091544,  2053332874,  2053573901,  2053814627,  2054055050,  2054295172,  2054534991,  2054774508,
+     2055013723,  2055252636,  2055491246,  2055729554,  2055967560,  2056205264,  2056442665,  2056679763,
+     2056916560,  2057153053,  2057389244,  2057625133,  2057860719,  2058096002,  2058330983,  2058565661,
+     2058800036,  2059034108,  2059267877,  2059501344,  2059734508,  2059967369,  2060199927,  2060432182,
+     2060664133,  2060895782,  2061127128,  2061358171,  2061588910,  2061819346,  2062049479,  2062279309,
+     2062508835,  2062738059,  2062966978,  2063195595,  2063423908,  2063651917,  2063879623,  2064107026,
+     2064334124,  2064560920,  2064787411,  2065013599,  2065239484,  2065465064,  2065690341,  2065915314,
+     2066139983,  2066364348,  2066588410,  2066812167,  2067035621,  2067258770,  2067481616,  2067704157,
+     2067926394,  2068148328,  2068369957,  2068591281,  2068812302,  2069033018,  2069253430,  2069473538,
+     2069693342,  2069912841,  2070132035,  2070350925,  2070569511,  2070787792,  2071005769,  2071223441,
+     2071440808,  2071657871,  2071874629,  2072091082,  2072307231,  2072523075,  2072738614,  2072953848,
+     2073168777,  2073383402,  2073597721,  2073811736,  2074025446,  2074238850,  2074451950,  2074664744,
+     2074877233,  2075089417,  2075301296,  2075512870,  2075724139,  2075935102,  2076145760,  2076356112,
+     2076566160,  2076775901,  2076985338,  2077194469,  2077403294,  2077611814,  2077820028,  2078027937,
+     2078235540,  2078442838,  2078649830,  2078856516,  2079062896,  2079268971,  2079474740,  2079680203,
+     2079885360,  2080090211,  2080294757,  2080498996,  2080702930,  2080906557,  2081109879,  2081312894,
+     2081515603,  2081718006,  2081920103,  2082121894,  2082323379,  2082524557,  2082725429,  2082925995,
+     2083126254,  2083326207,  2083525854,  2083725194,  2083924228,  2084122955,  2084321376,  2084519490,
+     2084717298,  2084914799,  2085111994,  2085308882,  2085505463,  2085701737,  2085897705,  2086093366,
+     2086288720,  2086483767,  2086678508,  2086872941,  2087067068,  2087260887,  2087454400,  2087647606,
+     2087840505,  2088033096,  2088225381,  2088417358,  2088609029,  2088800392,  2088991448,  2089182196,
+     2089372638,  2089562772,  2089752599,  2089942118,  2090131331,  2090320235,  2090508833,  2090697123,
+     2090885105,  2091072780,  2091260147,  2091447207,  2091633960,  2091820404,  2092006541,  2092192370,
+     2092377892,  2092563106,  2092748012,  2092932611,  2093116901,  2093300884,  2093484559,  2093667926,
+     2093850985,  2094033736,  2094216179,  2094398314,  2094580142,  2094761661,  2094942872,  2095123775,
+     2095304370,  2095484656,  2095664635,  2095844305,  2096023667,  2096202721,  2096381466,  2096559904,
+     2096738032,  2096915853,  2097093365,  2097270569,  2097447464,  2097624051,  2097800329,  2097976299,
+     2098151960,  2098327313,  2098502357,  2098677092,  2098851519,  2099025637,  2099199446,  2099372947,
+     2099546139,  2099719022,  2099891596,  2100063862,  2100235819,  2100407466,  2100578805,  2100749835,
+     2100920556,  2101090968,  2101261071,  2101430865,  2101600350,  2101769526,  2101938393,  2102106950,
+     2102275199,  2102443138,  2102610768,  2102778089,  2102945101,  2103111803,  2103278196,  2103444280,
+     2103610054,  2103775519,  2103940674,  2104105521,  2104270057,  2104434284,  2104598202,  2104761810,
+     2104925109,  2105088098,  2105250778,  2105413148,  2105575208,  2105736958,  2105898399,  2106059530,
+     2106220352,  2106380864,  2106541065,  2106700958,  2106860540,  2107019812,  2107178775,  2107337427,
+     2107495770,  2107653803,  2107811526,  2107968939,  2108126041,  2108282834,  2108439317,  2108595489,
+     2108751352,  2108906904,  2109062146,  2109217078,  2109371700,  2109526012,  2109680013,  2109833704,
+     2109987085,  2110140156,  2110292916,  2110445366,  2110597505,  2110749334,  2110900853,  2111052061,
+     2111202959,  2111353546,  2111503822,  2111653789,  2111803444,  2111952789,  2112101824,  2112250547,
+     2112398960,  2112547063,  2112694855,  2112842336,  2112989506,  2113136366,  2113282914,  2113429152,
+     2113575080,  2113720696,  2113866001,  2114010996,  2114155680,  2114300052,  2114444114,  2114587865,
+     2114731305,  2114874434,  2115017252,  2115159758,  2115301954,  2115443839,  2115585412,  2115726675,
+     2115867626,  2116008266,  2116148595,  2116288612,  2116428319,  2116567714,  2116706797,  2116845570,
+     2116984031,  2117122181,  2117260020,  2117397547,  2117534762,  2117671667,  2117808259,  2117944541,
+     2118080511,  2118216169,  2118351516,  2118486551,  2118621275,  2118755687,  2118889788,  2119023577,
+     2119157054,  2119290220,  2119423074,  2119555616,  2119687847,  2119819765,  2119951372,  2120082668,
+     2120213651,  2120344323,  2120474683,  2120604731,  2120734467,  2120863891,  2120993003,  2121121804,
+     2121250292,  2121378468,  2121506333,  2121633885,  2121761126,  2121888054,  2122014670,  2122140975,
+     2122266967,  2122392647,  2122518015,  2122643070,  2122767814,  2122892245,  2123016364,  2123140171,
+     2123263666,  2123386848,  2123509718,  2123632276,  2123754522,  2123876455,  2123998076,  2124119384,
+     2124240380,  2124361064,  2124481435,  2124601494,  2124721240,  2124840674,  2124959795,  2125078604,
+     2125197100,  2125315284,  2125433155,  2125550714,  2125667960,  2125784893,  2125901514,  2126017822,
+     2126133817,  2126249500,  2126364870,  2126479927,  2126594672,  2126709103,  2126823222,  2126937029,
+     2127050522,  2127163703,  2127276570,  2127389125,  2127501367,  2127613296,  2127724913,  2127836216,
+     2127947206,  2128057884,  2128168248,  2128278300,  2128388038,  2128497464,  2128606576,  2128715375,
+     2128823862,  2128932035,  2129039895,  2129147442,  2129254676,  2129361596,  2129468204,  2129574498,
+     2129680480,  2129786148,  2129891502,  2129996544,  2130101272,  2130205687,  2130309789,  2130413577,
+     2130517052,  2130620214,  2130723062,  2130825597,  2130927819,  2131029727,  2131131322,  2131232604,
+     2131333572,  2131434226,  2131534567,  2131634595,  2131734309,  2131833709,  2131932796,  2132031570,
+     2132130030,  2132228176,  2132326009,  2132423528,  2132520734,  2132617626,  2132714204,  2132810469,
+     2132906420,  2133002057,  2133097381,  2133192391,  2133287087,  2133381469,  2133475538,  2133569293,
+     2133662734,  2133755862,  2133848675,  2133941175,  2134033361,  2134125233,  2134216791,  2134308035,
+     2134398966,  2134489582,  2134579885,  2134669873,  2134759548,  2134848909,  2134937956,  2135026689,
+     2135115107,  2135203212,  2135291003,  2135378480,  2135465642,  2135552491,  2135639026,  2135725246,
+     2135811153,  2135896745,  2135982023,  2136066987,  2136151637,  2136235973,  2136319994,  2136403701,
+     2136487095,  2136570174,  2136652938,  2136735389,  2136817525,  2136899347,  2136980855,  2137062048,
+     2137142927,  2137223492,  2137303743,  2137383679,  2137463301,  2137542608,  2137621601,  2137700280,
+     2137778644,  2137856694,  2137934430,  2138011851,  2138088958,  2138165750,  2138242228,  2138318391,
+     2138394240,  2138469774,  2138544994,  2138619899,  2138694490,  2138768766,  2138842728,  2138916375,
+     2138989708,  2139062726,  2139135429,  2139207818,  2139279892,  2139351652,  2139423097,  2139494227,
+     2139565043,  2139635544,  2139705730,  2139775602,  2139845159,  2139914401,  2139983329,  2140051942,
+     2140120240,  2140188223,  2140255892,  2140323245,  2140390284,  2140457009,  2140523418,  2140589513,
+     2140655293,  2140720758,  2140785908,  2140850743,  2140915264,  2140979469,  2141043360,  2141106936,
+     2141170197,  2141233143,  2141295774,  2141358091,  2141420092,  2141481778,  2141543150,  2141604206,
+     2141664948,  2141725375,  2141785486,  2141845283,  2141904764,  2141963931,  2142022783,  2142081319,
+     2142139541,  2142197447,  2142255039,  2142312315,  2142369276,  2142425923,  2142482254,  2142538270,
+     2142593971,  2142649357,  2142704427,  2142759183,  2142813624,  2142867749,  2142921559,  2142975054,
+     2143028234,  2143081099,  2143133648,  2143185883,  2143237802,  2143289406,  2143340694,  2143391668,
+     2143442326,  2143492669,  2143542697,  2143592410,  2143641807,  2143690889,  2143739656,  2143788107,
+     2143836244,  2143884064,  2143931570,  2143978760,  2144025635,  2144072195,  2144118439,  2144164369,
+     2144209982,  2144255281,  2144300264,  2144344931,  2144389283,  2144433320,  2144477042,  2144520448,
+     2144563539,  2144606314,  2144648774,  2144690919,  2144732748,  2144774261,  2144815460,  2144856343,
+     2144896910,  2144937162,  2144977098,  2145016719,  2145056025,  2145095015,  2145133690,  2145172049,
+     2145210092,  2145247821,  2145285233,  2145322330,  2145359112,  2145395578,  2145431729,  2145467564,
+     2145503083,  2145538287,  2145573176,  2145607749,  2145642006,  2145675948,  2145709574,  2145742885,
+     2145775880,  2145808560,  2145840924,  2145872972,  2145904705,  2145936122,  2145967224,  2145998010,
+     2146028480,  2146058635,  2146088474,  2146117997,  2146147205,  2146176098,  2146204674,  2146232935,
+     2146260881,  2146288510,  2146315824,  2146342823,  2146369505,  2146395873,  2146421924,  2146447660,
+     2146473080,  2146498184,  2146522973,  2146547446,  2146571603,  2146595445,  2146618971,  2146642181,
+     2146665076,  2146687654,  2146709917,  2146731865,  2146753497,  2146774813,  2146795813,  2146816497,
+     2146836866,  2146856919,  2146876656,  2146896078,  2146915184,  2146933974,  2146952448,  2146970607,
+     2146988450,  2147005977,  2147023188,  2147040084,  2147056664,  2147072928,  2147088876,  2147104508,
+     2147119825,  2147134826,  2147149511,  2147163881,  2147177934,  2147191672,  2147205094,  2147218201,
+     2147230991,  2147243466,  2147255625,  2147267468,  2147278995,  2147290207,  2147301102,  2147311682,
+     2147321946,  2147331895,  2147341527,  2147350844,  2147359845,  2147368530,  2147376899,  2147384953,
+     2147392690,  2147400112,  2147407218,  2147414008,  2147420483,  2147426641,  2147432484,  2147438011,
+     2147443222,  2147448118,  2147452697,  2147456961,  2147460908,  2147464540,  2147467857,  2147470857,
+     2147473542,  2147475910,  2147477963,  2147479700,  2147481121,  2147482227,  2147483016,  2147483490,
+     2147483647
+};
+//----------------------------------------------------------------------------------------------------------------------
+//          S E T U P   S T R U C T U R E S   (in the arena)
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    uint32_t code;                                  // codeword, first bit in the MSB
+    uint16_t entry;
+    uint8_t  len;
+}codeword_t;
+
+typedef struct {
+    uint16_t    dimensions;
+    uint16_t    used;                               // entries with a codeword
+    uint8_t     lookupType;
+    uint8_t     sequenceP;
+    uint16_t    lookupValues;
+    codeword_t *words;                              // sorted by code
+    int16_t    *fast;                               // FAST_BITS lookahead -> index into words, -1: binary search
+    int32_t    *mult;                               // minimum + delta * multiplicand, Q12
+}codebook_t;
+
+typedef struct {
+    uint8_t  partitions;
+    uint8_t  multiplier;
+    uint8_t  values;
+    uint8_t  partClass[31];
+    uint8_t  classDim[16];
+    uint8_t  classSub[16];
+    uint8_t  classMaster[16];
+    int16_t  subBooks[16][8];
+    uint16_t X[65];
+    uint8_t  sorted[65];                            // indices of X in ascending order
+    uint8_t  lowN[65];
+    uint8_t  highN[65];
+}floor1_t;
+
+typedef struct {
+    uint8_t  type;
+    uint32_t begin, end;
+    uint32_t partSize;
+    uint8_t  classifications;
+    uint8_t  classBook;
+    uint8_t  cascade[64];
+    int16_t  (*books)[8];                           // [classifications][pass]
+}residue_t;
+
+typedef struct {
+    uint8_t  submaps;
+    uint8_t  couplingSteps;
+    uint8_t  magnitude[2], angle[2];                // mono or stereo: one coupling step at most is useful
+    uint8_t  mux[VORBIS_MAX_CHANNELS];
+    uint8_t  submapFloor[16];
+    uint8_t  submapResidue[16];
+}mapping_t;
+
+typedef struct {
+    uint8_t  blockFlag;
+    uint8_t  mapping;
+}vorbisMode_t;
+
+static uint8_t  *s_arena = NULL;
+static uint32_t  s_arenaSize = 0;
+static uint32_t  s_arenaUsed = 0;                   // from the bottom, the setup
+static uint32_t  s_arenaTop = 0;                    // from the top, temporary while the setup is read
+static uint32_t  s_arenaPeak = 0;
+
+// identification header
+static uint8_t   s_channels = 2;
+static uint32_t  s_sampleRate = 44100;
+static uint32_t  s_nominalBitRate = 0;
+static uint16_t  s_blockSize[2] = {256, 2048};
+
+// setup header
+static bool        s_setupOk = false;
+static uint16_t    s_bookCount = 0;
+static codebook_t *s_books = NULL;
+static uint8_t     s_floorCount = 0;
+static floor1_t   *s_floors = NULL;
+static uint8_t     s_residueCount = 0;
+static residue_t  *s_residues = NULL;
+static uint8_t     s_mappingCount = 0;
+static mapping_t  *s_mappings = NULL;
+static uint8_t     s_modeCount = 0;
+static uint8_t     s_modeBits = 0;
+static vorbisMode_t      s_modes[64];
+static int32_t    *s_window[2] = {NULL, NULL};      // rising slopes, blocksize / 2 values
+static int32_t    *s_vec[2] = {NULL, NULL};         // residue, spectrum and DCT-IV output of a channel
+static int32_t    *s_overlap[2] = {NULL, NULL};     // windowed right half of the previous block
+static int32_t    *s_fft = NULL;                    // blocksize / 4 complex values
+static uint8_t    *s_partClass[2] = {NULL, NULL};   // classifications of the residue partitions
+static uint32_t    s_partClassSize = 0;
+
+// overlap-add
+static int16_t   s_prevBlock = 0;                   // size of the previous block, 0: no previous block
+static uint16_t  s_validSamples = 0;
+static uint32_t  s_bitRate = 0;
+
+//----------------------------------------------------------------------------------------------------------------------
+//          A R E N A
+//----------------------------------------------------------------------------------------------------------------------
+static void *arenaAlloc(uint32_t size){
+    size = (size + 3) & ~3;
+    if(s_arenaUsed + size > s_arenaTop) return NULL;
+    void *p = s_arena + s_arenaUsed;
+    s_arenaUsed += size;
+    if(s_arenaUsed + s_arenaSize - s_arenaTop > s_arenaPeak) s_arenaPeak = s_arenaUsed + s_arenaSize - s_arenaTop;
+    return p;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void *arenaTemp(uint32_t size){
+    size = (size + 3) & ~3;
+    if(s_arenaUsed + size > s_arenaTop) return NULL;
+    s_arenaTop -= size;
+    if(s_arenaUsed + s_arenaSize - s_arenaTop > s_arenaPeak) s_arenaPeak = s_arenaUsed + s_arenaSize - s_arenaTop;
+    return s_arena + s_arenaTop;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void arenaReset(){
+    s_arenaUsed = 0;
+    s_arenaTop = s_arenaSize;
+    s_setupOk = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          B I T S
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    const uint8_t *ptr, *end;
+    uint64_t acc;                                   // next bits, the first one in the LSB
+    int      bits;
+    bool     eop;                                   // end of packet, read beyond the last byte
+}bitReader_t;
+
+static inline void brInit(bitReader_t *br, const uint8_t *data, int len){
+    br->ptr = data;
+    br->end = data + len;
+    br->acc = 0;
+    br->bits = 0;
+    br->eop = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline void brFill(bitReader_t *br){
+    while(br->bits <= 56 && br->ptr < br->end) {
+        br->acc |= (uint64_t)*br->ptr++ << br->bits;
+        br->bits += 8;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline uint32_t brRead(bitReader_t *br, int n){ // n <= 32
+    if(br->bits < n) {
+        brFill(br);
+        if(br->bits < n) {
+            br->eop = true;
+            br->bits = 0;
+            br->acc = 0;
+            return 0;
+        }
+    }
+    uint32_t v = (uint32_t)(br->acc & ((1ULL << n) - 1));
+    br->acc >>= n;
+    br->bits -= n;
+    return v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline uint32_t bitReverse(uint32_t n){
+    n = ((n & 0xAAAAAAAA) >>  1) | ((n & 0x55555555) << 1);
+    n = ((n & 0xCCCCCCCC) >>  2) | ((n & 0x33333333) << 2);
+    n = ((n & 0xF0F0F0F0) >>  4) | ((n & 0x0F0F0F0F) << 4);
+    n = ((n & 0xFF00FF00) >>  8) | ((n & 0x00FF00FF) << 8);
+    return (n >> 16) | (n << 16);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ilog(uint32_t v){
+    int ret = 0;
+    while(v) {ret++; v >>= 1;}
+    return ret;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          C O D E B O O K S
+//----------------------------------------------------------------------------------------------------------------------
+static inline int bookDecode(bitReader_t *br, const codebook_t *cb){
+    // index into cb->words, -1 at the end of the packet or for a codeword that is not in the book
+    if(!cb->used) return -1;
+    if(br->bits < 32) brFill(br);
+    uint32_t peek = (uint32_t)br->acc;
+    int idx = cb->fast[peek & ((1 << FAST_BITS) - 1)];
+    if(idx < 0) {
+        uint32_t code = bitReverse(peek);
+        int x = 0, n = cb->used;
+        while(n > 1) {
+            int h = n >> 1;
+            if(cb->words[x + h].code <= code) {x += h; n -= h;}
+            else n = h;
+        }
+        idx = x;
+        int len = cb->words[idx].len;
+        if(cb->used > 1 && (code ^ cb->words[idx].code) >> (32 - len)) return -1;
+    }
+    int len = cb->words[idx].len;
+    if(len > br->bits) {
+        br->eop = true;
+        br->bits = 0;
+        br->acc = 0;
+        return -1;
+    }
+    br->acc >>= len;
+    br->bits -= len;
+    return idx;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int bookDecodeScalar(bitReader_t *br, const codebook_t *cb){
+    int idx = bookDecode(br, cb);
+    return idx < 0 ? -1 : cb->words[idx].entry;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t bookValue(const codebook_t *cb, uint32_t entry, int j){
+    // value j of the vector of an entry, the lattice (lookup type 1) is not expanded to save memory
+    if(cb->lookupType == 2) return cb->mult[entry * cb->dimensions + j];
+    int32_t v = 0;
+    for(int i = 0; i <= j; i++) {
+        int32_t m = cb->mult[entry % cb->lookupValues];
+        entry /= cb->lookupValues;
+        v = cb->sequenceP ? v + m : m;
+    }
+    return v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmpCodeword(const void *a, const void *b){
+    uint32_t x = ((const codeword_t*)a)->code, y = ((const codeword_t*)b)->code;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int64_t float32ToFixed(uint32_t x, int frac){
+    // Vorbis float32: 21 bit mantissa, 10 bit exponent biased by 788, sign; saturated to 48 bits
+    int64_t mant = x & 0x1FFFFF;
+    int exp = (int)((x & 0x7FE00000) >> 21) - 788 + frac;
+    int64_t v = mant;
+    if(exp >= 0) v = exp > 26 ? (int64_t)1 << 47 : v << exp;
+    else v = exp < -40 ? 0 : (v + ((int64_t)1 << (-exp - 1))) >> -exp;
+    return (x & 0x80000000) ? -v : v;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseCodebook(bitReader_t *br, codebook_t *cb){
+    if(brRead(br, 24) != 0x564342) return ERR_VORBIS_BAD_HEADER;
+    cb->dimensions = brRead(br, 16);
+    uint32_t entries = brRead(br, 24);
+    if(entries > 65535 || !cb->dimensions) return ERR_VORBIS_UNSUPPORTED;
+    uint8_t *lengths = (uint8_t*)arenaTemp(entries);
+    if(!lengths) return ERR_VORBIS_SETUP_TOO_BIG;
+    uint32_t used = 0;
+    if(brRead(br, 1)) {                             // ordered
+        uint32_t cur = 0;
+        int len = brRead(br, 5) + 1;
+        while(cur < entries) {
+            uint32_t n = brRead(br, ilog(entries - cur));
+            if(cur + n > entries || len > 32) return ERR_VORBIS_BAD_HEADER;
+            memset(lengths + cur, len, n);
+            cur += n;
+            len++;
+        }
+        used = entries;
+    }
+    else {
+        bool sparse = brRead(br, 1);
+        for(uint32_t i = 0; i < entries; i++) {
+            if(sparse && !brRead(br, 1)) {lengths[i] = 0; continue;}
+            lengths[i] = brRead(br, 5) + 1;
+            used++;
+        }
+    }
+    if(br->eop) return ERR_VORBIS_BAD_HEADER;
+    cb->used = used;
+    cb->words = (codeword_t*)arenaAlloc(used * sizeof(codeword_t));
+    cb->fast = (int16_t*)arenaAlloc((1 << FAST_BITS) * sizeof(int16_t));
+    if(!cb->words || !cb->fast) return ERR_VORBIS_SETUP_TOO_BIG;
+    // codewords in the order of the entries: always the lowest free one of the given length
+    uint32_t available[33] = {0};
+    uint32_t m = 0;
+    for(uint32_t i = 0; i < entries; i++) {
+        int len = lengths[i];
+        if(!len) continue;
+        uint32_t code;
+        if(m == 0) {
+            code = 0;
+            for(int k = 1; k <= len; k++) available[k] = 1UL << (32 - k);
+        }
+        else {
+            int z = len;
+            while(z > 0 && !available[z]) z--;
+            if(z == 0) return ERR_VORBIS_BAD_HEADER; // overspecified
+            code = available[z];
+            available[z] = 0;
+            for(int y = len; y > z; y--) available[y] = code + (1UL << (32 - y));
+        }
+        cb->words[m].code = code;
+        cb->words[m].entry = i;
+        cb->words[m].len = len;
+        m++;
+    }
+    qsort(cb->words, used, sizeof(codeword_t), cmpCodeword);
+    for(int i = 0; i < (1 << FAST_BITS); i++) cb->fast[i] = -1;
+    for(uint32_t i = 0; i < used; i++) {
+        int len = cb->words[i].len;
+        if(len > FAST_BITS) continue;
+        uint32_t r = bitReverse(cb->words[i].code);   // as it is read, first bit in the LSB
+        for(uint32_t j = r; j < (1 << FAST_BITS); j += 1 << len) cb->fast[j] = i;
+    }
+    if(used == 1) for(int i = 0; i < (1 << FAST_BITS); i++) cb->fast[i] = 0; // single entry, matches always
+    cb->lookupType = brRead(br, 4);
+    cb->mult = NULL;
+    if(cb->lookupType == 0) return ERR_VORBIS_NONE;
+    if(cb->lookupType > 2) return ERR_VORBIS_BAD_HEADER;
+    uint32_t minimum = brRead(br, 32);
+    uint32_t delta = brRead(br, 32);
+    int valueBits = brRead(br, 4) + 1;
+    cb->sequenceP = brRead(br, 1);
+    uint32_t n;
+    if(cb->lookupType == 1) {                       // lookup1_values(): the greatest n with n ^ dimensions <= entries
+        n = 0;
+        while(true) {
+            uint64_t p = 1;
+            for(int i = 0; i < cb->dimensions && p <= entries; i++) p *= n + 1;
+            if(p > entries) break;
+            n++;
+        }
+    }
+    else n = entries * cb->dimensions;
+    if(n > 65535 || n == 0) return ERR_VORBIS_BAD_HEADER;
+    cb->lookupValues = n;
+    cb->mult = (int32_t*)arenaAlloc(n * sizeof(int32_t));
+    if(!cb->mult) return ERR_VORBIS_SETUP_TOO_BIG;
+    int64_t vMin = float32ToFixed(minimum, RQ + 8);  // 8 extra bits, rounded after the multiplication
+    int64_t vDelta = float32ToFixed(delta, RQ + 8);
+    for(uint32_t i = 0; i < n; i++) {
+        int64_t v = vMin + vDelta * brRead(br, valueBits);
+        v = (v + 128) >> 8;
+        cb->mult[i] = v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (int32_t)v;
+    }
+    return br->eop ? ERR_VORBIS_BAD_HEADER : ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          S E T U P
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseFloor(bitReader_t *br, floor1_t *f){
+    if(brRead(br, 16) != 1) return ERR_VORBIS_UNSUPPORTED; // floor 0
+    f->partitions = brRead(br, 5);
+    int maxClass = -1;
+    for(int i = 0; i < f->partitions; i++) {
+        f->partClass[i] = brRead(br, 4);
+        if(f->partClass[i] > maxClass) maxClass = f->partClass[i];
+    }
+    for(int c = 0; c <= maxClass; c++) {
+        f->classDim[c] = brRead(br, 3) + 1;
+        f->classSub[c] = brRead(br, 2);
+        if(f->classSub[c]) {
+            f->classMaster[c] = brRead(br, 8);
+            if(f->classMaster[c] >= s_bookCount) return ERR_VORBIS_BAD_HEADER;
+        }
+        for(int j = 0; j < (1 << f->classSub[c]); j++) {
+            f->subBooks[c][j] = (int16_t)brRead(br, 8) - 1;
+            if(f->subBooks[c][j] >= s_bookCount) return ERR_VORBIS_BAD_HEADER;
+        }
+    }
+    f->multiplier = brRead(br, 2) + 1;
+    int rangeBits = brRead(br, 4);
+    f->X[0] = 0;
+    f->X[1] = 1 << rangeBits;
+    int values = 2;
+    for(int i = 0; i < f->partitions; i++) {
+        int c = f->partClass[i];
+        for(int j = 0; j < f->classDim[c]; j++) {
+            if(values >= 65) return ERR_VORBIS_BAD_HEADER;
+            f->X[values++] = brRead(br, rangeBits);
+        }
+    }
+    f->values = values;
+    for(int i = 0; i < values; i++) f->sorted[i] = i;
+    for(int i = 1; i < values; i++) {               // insertion sort, 65 values at most
+        uint8_t t = f->sorted[i];
+        int j = i;
+        while(j > 0 && f->X[f->sorted[j - 1]] > f->X[t]) {f->sorted[j] = f->sorted[j - 1]; j--;}
+        f->sorted[j] = t;
+    }
+    for(int i = 1; i < values; i++) if(f->X[f->sorted[i]] == f->X[f->sorted[i - 1]]) return ERR_VORBIS_BAD_HEADER;
+    for(int i = 2; i < values; i++) {               // low_neighbor(), high_neighbor()
+        int lo = 0, hi = 1;
+        for(int j = 0; j < i; j++) {
+            if(f->X[j] < f->X[i] && f->X[j] > f->X[lo]) lo = j;
+            if(f->X[j] > f->X[i] && f->X[j] < f->X[hi]) hi = j;
+        }
+        f->lowN[i] = lo;
+        f->highN[i] = hi;
+    }
+    return br->eop ? ERR_VORBIS_BAD_HEADER : ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseResidue(bitReader_t *br, residue_t *r){
+    r->type = brRead(br, 16);
+    if(r->type > 2) return ERR_VORBIS_BAD_HEADER;
+    r->begin = brRead(br, 24);
+    r->end = brRead(br, 24);
+    r->partSize = brRead(br, 24) + 1;
+    r->classifications = brRead(br, 6) + 1;
+    r->classBook = brRead(br, 8);
+    if(r->classBook >= s_bookCount) return ERR_VORBIS_BAD_HEADER;
+    for(int i = 0; i < r->classifications; i++) {
+        uint8_t bits = brRead(br, 3);
+        if(brRead(br, 1)) bits |= brRead(br, 5) << 3;
+        r->cascade[i] = bits;
+    }
+    r->books = (int16_t(*)[8])arenaAlloc(r->classifications * sizeof(int16_t[8]));
+    if(!r->books) return ERR_VORBIS_SETUP_TOO_BIG;
+    for(int i = 0; i < r->classifications; i++) {
+        for(int j = 0; j < 8; j++) {
+            r->books[i][j] = -1;
+            if(r->cascade[i] & (1 << j)) {
+                r->books[i][j] = brRead(br, 8);
+                if(r->books[i][j] >= s_bookCount || !s_books[r->books[i][j]].mult) return ERR_VORBIS_BAD_HEADER;
+            }
+        }
+    }
+    return br->eop ? ERR_VORBIS_BAD_HEADER : ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseMapping(bitReader_t *br, mapping_t *m){
+    if(brRead(br, 16) != 0) return ERR_VORBIS_BAD_HEADER;
+    m->submaps = brRead(br, 1) ? brRead(br, 4) + 1 : 1;
+    m->couplingSteps = brRead(br, 1) ? brRead(br, 8) + 1 : 0;
+    if(m->couplingSteps > 2) return ERR_VORBIS_UNSUPPORTED;
+    int chBits = ilog(s_channels - 1);
+    for(int i = 0; i < m->couplingSteps; i++) {
+        m->magnitude[i] = brRead(br, chBits);
+        m->angle[i] = brRead(br, chBits);
+        if(m->magnitude[i] == m->angle[i] || m->magnitude[i] >= s_channels || m->angle[i] >= s_channels)
+            return ERR_VORBIS_BAD_HEADER;
+    }
+    if(brRead(br, 2)) return ERR_VORBIS_BAD_HEADER; // reserved
+    for(int i = 0; i < s_channels && i < VORBIS_MAX_CHANNELS; i++) { // parseIdent() refuses more, GCC can't see it
+        m->mux[i] = m->submaps > 1 ? brRead(br, 4) : 0;
+        if(m->mux[i] >= m->submaps) return ERR_VORBIS_BAD_HEADER;
+    }
+    for(int i = 0; i < m->submaps; i++) {
+        brRead(br, 8);                              // time configuration, unused
+        m->submapFloor[i] = brRead(br, 8);
+        m->submapResidue[i] = brRead(br, 8);
+        if(m->submapFloor[i] >= s_floorCount || m->submapResidue[i] >= s_residueCount) return ERR_VORBIS_BAD_HEADER;
+    }
+    return br->eop ? ERR_VORBIS_BAD_HEADER : ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int32_t sinQ(uint32_t t, uint32_t q){
+    // sin(t * pi / 2 / q), 0 <= t <= q, q is a power of two <= VORBIS_MAX_BLOCKSIZE
+    return sinTab[t * (VORBIS_MAX_BLOCKSIZE / q)];
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void makeWindow(int32_t *w, int n){
+    // rising slope of the Vorbis window: sin(pi/2 * sin^2((i + 0.5) / n * pi)), i < n/2, from the sine table
+    for(int i = 0; i < n / 2; i++) {
+        int64_t s = sinQ(2 * i + 1, n);             // sin((2i + 1) / n * pi / 2)
+        uint32_t x = (uint32_t)((s * s) >> 31);     // sin^2, Q31
+        uint64_t t = (uint64_t)x * VORBIS_MAX_BLOCKSIZE;  // pi/2 * x in table steps, 31 fraction bits
+        uint32_t k = t >> 31;
+        uint32_t f = (t & 0x7FFFFFFF) >> 15;        // Q16
+        int32_t a = sinTab[k], b = sinTab[k < VORBIS_MAX_BLOCKSIZE ? k + 1 : k];
+        w[i] = a + (int32_t)(((int64_t)(b - a) * f) >> 16);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseIdent(const uint8_t *p, int len){
+    if(len < 30 || memcmp(p + 1, "vorbis", 6) != 0) return ERR_VORBIS_BAD_HEADER;
+    uint32_t version = p[7] | p[8] << 8 | p[9] << 16 | (uint32_t)p[10] << 24;
+    uint8_t channels = p[11];
+    uint32_t rate = p[12] | p[13] << 8 | p[14] << 16 | (uint32_t)p[15] << 24;
+    int32_t nominal = p[20] | p[21] << 8 | p[22] << 16 | (uint32_t)p[23] << 24;
+    uint16_t bs0 = 1 << (p[28] & 0x0F), bs1 = 1 << (p[28] >> 4);
+    if(version != 0 || !channels || !rate || bs0 < 64 || bs0 > bs1 || !(p[29] & 1)) return ERR_VORBIS_BAD_HEADER;
+    if(channels > VORBIS_MAX_CHANNELS || bs1 > VORBIS_MAX_BLOCKSIZE) {
+        log_e("vorbis: %u channels, blocksize %u are not supported", channels, bs1);
+        return ERR_VORBIS_UNSUPPORTED;
+    }
+    arenaReset();                                   // a new stream begins, its setup follows
+    s_channels = channels;
+    s_sampleRate = rate;
+    s_nominalBitRate = nominal > 0 ? nominal : 0;
+    s_blockSize[0] = bs0;
+    s_blockSize[1] = bs1;
+    s_prevBlock = 0;
+    return ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t parseSetup(const uint8_t *p, int len){
+    bitReader_t br;
+    int8_t ret;
+    if(len < 7 || memcmp(p + 1, "vorbis", 6) != 0) return ERR_VORBIS_BAD_HEADER;
+    s_setupOk = false;                              // a chained stream or a loop brings a new setup
+    arenaReset();
+    brInit(&br, p + 7, len - 7);
+    s_bookCount = brRead(&br, 8) + 1;
+    s_books = (codebook_t*)arenaAlloc(s_bookCount * sizeof(codebook_t));
+    if(!s_books) return ERR_VORBIS_SETUP_TOO_BIG;
+    for(int i = 0; i < s_bookCount; i++) {
+        ret = parseCodebook(&br, &s_books[i]);
+        s_arenaTop = s_arenaSize;                   // the code lengths are not needed any more
+        if(ret) return ret;
+    }
+    int times = brRead(&br, 6) + 1;
+    for(int i = 0; i < times; i++) if(brRead(&br, 16) != 0) return ERR_VORBIS_BAD_HEADER;
+    s_floorCount = brRead(&br, 6) + 1;
+    s_floors = (floor1_t*)arenaAlloc(s_floorCount * sizeof(floor1_t));
+    if(!s_floors) return ERR_VORBIS_SETUP_TOO_BIG;
+    for(int i = 0; i < s_floorCount; i++) if((ret = parseFloor(&br, &s_floors[i]))) return ret;
+    s_residueCount = brRead(&br, 6) + 1;
+    s_residues = (residue_t*)arenaAlloc(s_residueCount * sizeof(residue_t));
+    if(!s_residues) return ERR_VORBIS_SETUP_TOO_BIG;
+    for(int i = 0; i < s_residueCount; i++) if((ret = parseResidue(&br, &s_residues[i]))) return ret;
+    s_mappingCount = brRead(&br, 6) + 1;
+    s_mappings = (mapping_t*)arenaAlloc(s_mappingCount * sizeof(mapping_t));
+    if(!s_mappings) return ERR_VORBIS_SETUP_TOO_BIG;
+    for(int i = 0; i < s_mappingCount; i++) if((ret = parseMapping(&br, &s_mappings[i]))) return ret;
+    s_modeCount = brRead(&br, 6) + 1;
+    for(int i = 0; i < s_modeCount; i++) {
+        s_modes[i].blockFlag = brRead(&br, 1);
+        if(brRead(&br, 16) || brRead(&br, 16)) return ERR_VORBIS_BAD_HEADER; // window and transform type 0
+        s_modes[i].mapping = brRead(&br, 8);
+        if(s_modes[i].mapping >= s_mappingCount) return ERR_VORBIS_BAD_HEADER;
+    }
+    s_modeBits = ilog(s_modeCount - 1);
+    if(!brRead(&br, 1) || br.eop) return ERR_VORBIS_BAD_HEADER; // framing bit
+    // buffers of the audio packets
+    uint16_t n2 = s_blockSize[1] / 2;
+    s_partClassSize = 0;
+    for(int i = 0; i < s_residueCount; i++) {
+        residue_t *r = &s_residues[i];
+        uint32_t size = r->type == 2 ? n2 * s_channels : n2;
+        uint32_t end = r->end < size ? r->end : size, begin = r->begin < end ? r->begin : end;
+        uint32_t parts = (end - begin) / r->partSize + s_books[r->classBook].dimensions;
+        if(parts > s_partClassSize) s_partClassSize = parts;
+    }
+    for(int i = 0; i < 2; i++) {
+        s_window[i] = (int32_t*)arenaAlloc(s_blockSize[i] / 2 * sizeof(int32_t));
+        if(!s_window[i]) return ERR_VORBIS_SETUP_TOO_BIG;
+        makeWindow(s_window[i], s_blockSize[i]);
+    }
+    for(int c = 0; c < s_channels; c++) {
+        s_vec[c] = (int32_t*)arenaAlloc(n2 * sizeof(int32_t));
+        s_overlap[c] = (int32_t*)arenaAlloc(n2 * sizeof(int32_t));
+        s_partClass[c] = (uint8_t*)arenaAlloc(s_partClassSize);
+        if(!s_vec[c] || !s_overlap[c] || !s_partClass[c]) return ERR_VORBIS_SETUP_TOO_BIG;
+    }
+    s_fft = (int32_t*)arenaAlloc(n2 * sizeof(int32_t));
+    if(!s_fft) return ERR_VORBIS_SETUP_TOO_BIG;
+    s_prevBlock = 0;
+    s_setupOk = true;
+    log_i("vorbis setup: %u codebooks, %u bytes of %u", s_bookCount, s_arenaUsed, s_arenaSize);
+    return ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          F L O O R   1
+//----------------------------------------------------------------------------------------------------------------------
+static bool floorDecode(bitReader_t *br, const floor1_t *f, int16_t *Y){
+    // the Y values of the posts, false: the channel is unused in this packet
+    static const uint16_t range[4] = {256, 128, 86, 64};
+    if(!brRead(br, 1)) return false;
+    int rbits = ilog(range[f->multiplier - 1] - 1);
+    Y[0] = brRead(br, rbits);
+    Y[1] = brRead(br, rbits);
+    int offset = 2;
+    for(int i = 0; i < f->partitions; i++) {
+        int c = f->partClass[i];
+        int cdim = f->classDim[c];
+        int cbits = f->classSub[c];
+        int csub = (1 << cbits) - 1;
+        int cval = 0;
+        if(cbits) {
+            cval = bookDecodeScalar(br, &s_books[f->classMaster[c]]);
+            if(cval < 0) return false;
+        }
+        for(int j = 0; j < cdim; j++) {
+            int book = f->subBooks[c][cval & csub];
+            cval >>= cbits;
+            Y[offset + j] = 0;
+            if(book >= 0) {
+                int v = bookDecodeScalar(br, &s_books[book]);
+                if(v < 0) return false;
+                Y[offset + j] = v;
+            }
+        }
+        offset += cdim;
+    }
+    return !br->eop;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int renderPoint(int x0, int y0, int x1, int y1, int x){
+    int dy = y1 - y0, adx = x1 - x0;
+    int off = (dy < 0 ? -dy : dy) * (x - x0) / adx;
+    return dy < 0 ? y0 - off : y0 + off;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t floorMul(int32_t v, int y){
+    if(y < 0) y = 0;
+    if(y > 255) y = 255;
+    return (int32_t)(((int64_t)v * fromdB[y]) >> (RQ + 31 - SQ));
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void renderLine(int x0, int y0, int x1, int y1, int32_t *v, int n){
+    // v[x] *= floor(x) for x0 <= x < x1, the integer line of the specification
+    int dy = y1 - y0, adx = x1 - x0;
+    int ady = dy < 0 ? -dy : dy;
+    int base = dy / adx;
+    int sy = dy < 0 ? base - 1 : base + 1;
+    int err = 0, y = y0;
+    ady -= (base < 0 ? -base : base) * adx;
+    if(x1 > n) x1 = n;
+    if(x0 < x1) v[x0] = floorMul(v[x0], y);
+    for(int x = x0 + 1; x < x1; x++) {
+        err += ady;
+        if(err >= adx) {err -= adx; y += sy;}
+        else y += base;
+        v[x] = floorMul(v[x], y);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void floorApply(const floor1_t *f, const int16_t *Y, int32_t *v, int n){
+    // amplitude value synthesis and curve synthesis, the curve is multiplied into the residue
+    static const uint16_t rangeTab[4] = {256, 128, 86, 64};
+    int range = rangeTab[f->multiplier - 1];
+    int16_t finalY[65];
+    bool step2[65];
+    finalY[0] = Y[0];
+    finalY[1] = Y[1];
+    step2[0] = step2[1] = true;
+    for(int i = 2; i < f->values; i++) {
+        int lo = f->lowN[i], hi = f->highN[i];
+        int predicted = renderPoint(f->X[lo], finalY[lo], f->X[hi], finalY[hi], f->X[i]);
+        int val = Y[i];
+        int highroom = range - predicted, lowroom = predicted;
+        int room = (highroom < lowroom ? highroom : lowroom) * 2;
+        if(val) {
+            step2[lo] = step2[hi] = step2[i] = true;
+            if(val >= room) finalY[i] = highroom > lowroom ? val - lowroom + predicted : predicted - val + highroom - 1;
+            else finalY[i] = (val & 1) ? predicted - (val + 1) / 2 : predicted + val / 2;
+        }
+        else {
+            step2[i] = false;
+            finalY[i] = predicted;
+        }
+    }
+    int lx = 0, ly = finalY[f->sorted[0]] * f->multiplier, hx = 0, hy = 0;
+    for(int i = 1; i < f->values; i++) {
+        int j = f->sorted[i];
+        if(!step2[j]) continue;
+        hy = finalY[j] * f->multiplier;
+        hx = f->X[j];
+        renderLine(lx, ly, hx, hy, v, n);
+        lx = hx;
+        ly = hy;
+    }
+    if(hx < n) renderLine(hx, hy, n, hy, v, n);
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          R E S I D U E
+//----------------------------------------------------------------------------------------------------------------------
+static bool residuePartition(bitReader_t *br, const codebook_t *cb, int type, int32_t **v, int ch, uint32_t offs, uint32_t n){
+    // adds the vectors of one partition, type 2 interleaves the channels; false at the end of the packet
+    int dim = cb->dimensions;
+    if(type == 0) {
+        uint32_t step = n / dim;
+        for(uint32_t i = 0; i < step; i++) {
+            int idx = bookDecode(br, cb);
+            if(idx < 0) return false;
+            uint32_t e = cb->words[idx].entry;
+            for(int j = 0; j < dim; j++) v[0][offs + i + j * step] += bookValue(cb, e, j);
+        }
+        return true;
+    }
+    for(uint32_t i = 0; i < n;) {
+        int idx = bookDecode(br, cb);
+        if(idx < 0) return false;
+        uint32_t e = cb->words[idx].entry;
+        if(cb->lookupType == 1 && !cb->sequenceP) {  // the common case: lattice, digits of the entry
+            for(int j = 0; j < dim && i < n; j++, i++) {
+                int32_t val = cb->mult[e % cb->lookupValues];
+                e /= cb->lookupValues;
+                uint32_t p = offs + i;
+                if(type == 2 && ch == 2) v[p & 1][p >> 1] += val;
+                else v[0][p] += val;
+            }
+        }
+        else {
+            for(int j = 0; j < dim && i < n; j++, i++) {
+                uint32_t p = offs + i;
+                int32_t val = bookValue(cb, e, j);
+                if(type == 2 && ch == 2) v[p & 1][p >> 1] += val;
+                else v[0][p] += val;
+            }
+        }
+    }
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void residueDecode(bitReader_t *br, const residue_t *r, int32_t **vec, uint8_t **partClass, int ch, uint32_t n2){
+    // ch vectors of the submap that are to be decoded, types 0 and 1 per channel, type 2 as one interleaved vector
+    uint32_t size = r->type == 2 ? n2 * ch : n2;
+    uint32_t end = r->end < size ? r->end : size, begin = r->begin < end ? r->begin : end;
+    uint32_t psize = r->partSize;
+    uint32_t parts = (end - begin) / psize;
+    if(!parts) return;
+    const codebook_t *classBook = &s_books[r->classBook];
+    int cpw = classBook->dimensions;                // classifications per codeword
+    int vecs = r->type == 2 ? 1 : ch;
+    for(int pass = 0; pass < 8; pass++) {
+        for(uint32_t i = 0; i < parts;) {
+            if(pass == 0) {
+                for(int j = 0; j < vecs; j++) {
+                    int temp = bookDecodeScalar(br, classBook);
+                    if(temp < 0) return;
+                    for(int k = cpw - 1; k >= 0; k--) {
+                        if(i + k < s_partClassSize) partClass[j][i + k] = temp % r->classifications;
+                        temp /= r->classifications;
+                    }
+                }
+            }
+            for(int k = 0; k < cpw && i < parts; k++, i++) {
+                for(int j = 0; j < vecs; j++) {
+                    int vqclass = partClass[j][i];
+                    int book = r->books[vqclass][pass];
+                    if(book < 0) continue;
+                    int32_t *v[2] = {vec[j], r->type == 2 ? vec[1] : NULL};
+                    if(!residuePartition(br, &s_books[book], r->type, v, ch, begin + i * psize, psize)) return;
+                }
+            }
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          I N V E R S E   M D C T
+//----------------------------------------------------------------------------------------------------------------------
+static void fft(int32_t *z, int n){
+    // forward complex FFT in place, n a power of two, z = re, im, re, im ...; no scaling
+    for(int i = 1, j = 0; i < n; i++) {             // bit reversed order
+        int bit = n >> 1;
+        for(; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if(i < j) {
+            int32_t t = z[2 * i]; z[2 * i] = z[2 * j]; z[2 * j] = t;
+            t = z[2 * i + 1]; z[2 * i + 1] = z[2 * j + 1]; z[2 * j + 1] = t;
+        }
+    }
+    for(int len = 2; len <= n; len <<= 1) {
+        int half = len >> 1;
+        uint32_t q = len / 4 ? len / 4 : 1;         // quarter circle in table steps of this stage
+        for(int k = 0; k < half; k++) {
+            // exp(-2 pi i k / len) = cos - i sin, angle k / len * 2pi = (4k / len) * pi/2
+            int32_t c, s;
+            if(len == 2) {c = INT32_MAX; s = 0;}
+            else {
+                uint32_t t = k;                     // in steps of pi/2 / q
+                if(t <= q) {c = sinQ(q - t, q); s = sinQ(t, q);}
+                else       {c = -sinQ(t - q, q); s = sinQ(2 * q - t, q);}
+            }
+            for(int i = k; i < n; i += len) {
+                int32_t *a = z + 2 * i, *b = z + 2 * (i + half);
+                int32_t br = MULT31(b[0], c) + MULT31(b[1], s);
+                int32_t bi = MULT31(b[1], c) - MULT31(b[0], s);
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+            }
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void dct4(int32_t *x, int n2){
+    // x (n2 values) -> DCT-IV of x in place, by an n2/2 point complex FFT
+    int n4 = n2 / 2;
+    int32_t *z = s_fft;
+    int n = n2 * 2;                                 // blocksize
+    for(int m = 0; m < n4; m++) {                   // pre-twiddle: exp(-i pi m / n2)
+        int32_t re = x[2 * m], im = x[n2 - 1 - 2 * m];
+        int32_t c = sinQ(n - 4 * m, n), s = sinQ(4 * m, n);
+        z[2 * m]     = MULT31(re, c) + MULT31(im, s);
+        z[2 * m + 1] = MULT31(im, c) - MULT31(re, s);
+    }
+    fft(z, n4);
+    for(int m = 0; m < n4; m++) {                   // post-twiddle: exp(-i pi (m + 1/4) / n2)
+        int32_t re = z[2 * m], im = z[2 * m + 1];
+        int32_t c = sinQ(n - 4 * m - 1, n), s = sinQ(4 * m + 1, n);
+        x[2 * m]          =   MULT31(re, c) + MULT31(im, s);
+        x[n2 - 1 - 2 * m] = -(MULT31(im, c) - MULT31(re, s));
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static inline int32_t imdctSample(const int32_t *u, int k, int n){
+    // sample k of the inverse MDCT (n values) from the DCT-IV u (n/2 values)
+    int n4 = n / 4;
+    if(k < n4) return u[k + n4];
+    if(k < 3 * n4) return -u[3 * n4 - 1 - k];
+    return -u[k - 3 * n4];
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          A U D I O   P A C K E T
+//----------------------------------------------------------------------------------------------------------------------
+static int8_t decodeAudio(const uint8_t *data, int len, short *outbuf){
+    bitReader_t br;
+    brInit(&br, data, len);
+    if(brRead(&br, 1) != 0) return ERR_VORBIS_INVALID_PACKET;
+    int modeNr = brRead(&br, s_modeBits);
+    if(modeNr >= s_modeCount || br.eop) return ERR_VORBIS_INVALID_PACKET;
+    const vorbisMode_t *mode = &s_modes[modeNr];
+    const mapping_t *map = &s_mappings[mode->mapping];
+    int n = s_blockSize[mode->blockFlag], n2 = n / 2;
+    bool prevLong = true, nextLong = true;
+    if(mode->blockFlag) {
+        prevLong = brRead(&br, 1);
+        nextLong = brRead(&br, 1);
+    }
+    int16_t Y[2][65];
+    bool floorUsed[2], decode[2];
+    for(int c = 0; c < s_channels; c++) {
+        memset(s_vec[c], 0, n2 * sizeof(int32_t));
+        const floor1_t *f = &s_floors[map->submapFloor[map->mux[c]]];
+        floorUsed[c] = floorDecode(&br, f, Y[c]);
+        decode[c] = floorUsed[c];
+    }
+    for(int i = 0; i < map->couplingSteps; i++) {   // nonzero vector propagate
+        if(decode[map->magnitude[i]] || decode[map->angle[i]]) decode[map->magnitude[i]] = decode[map->angle[i]] = true;
+    }
+    for(int s = 0; s < map->submaps; s++) {
+        int32_t *vec[2];
+        uint8_t *pc[2];
+        int ch = 0;
+        bool any = false;
+        const residue_t *r = &s_residues[map->submapResidue[s]];
+        for(int c = 0; c < s_channels; c++) {
+            if(map->mux[c] != s) continue;
+            if(r->type == 2) {                      // all channels of the submap, if one of them is to be decoded
+                any |= decode[c];
+                vec[ch] = s_vec[c];
+                pc[ch++] = s_partClass[c];
+            }
+            else if(decode[c]) {
+                any = true;
+                vec[ch] = s_vec[c];
+                pc[ch++] = s_partClass[c];
+            }
+        }
+        if(any && !br.eop) residueDecode(&br, r, vec, pc, ch, n2);
+    }
+    for(int i = map->couplingSteps - 1; i >= 0; i--) { // inverse coupling
+        int32_t *m = s_vec[map->magnitude[i]], *a = s_vec[map->angle[i]];
+        for(int k = 0; k < n2; k++) {
+            int32_t M = m[k], A = a[k];
+            if(M > 0) {
+                if(A > 0) {m[k] = M; a[k] = M - A;}
+                else      {a[k] = M; m[k] = M + A;}
+            }
+            else {
+                if(A > 0) {m[k] = M; a[k] = M + A;}
+                else      {a[k] = M; m[k] = M - A;}
+            }
+        }
+    }
+    // floor curve, inverse MDCT, window, overlap-add
+    int bs0 = s_blockSize[0];
+    int leftStart = 0, leftN = n2;                  // rising slope of this block
+    const int32_t *leftWin = s_window[mode->blockFlag];
+    if(mode->blockFlag && !prevLong) {leftStart = n / 4 - bs0 / 4; leftN = bs0 / 2; leftWin = s_window[0];}
+    int rightStart = n2, rightN = n2;               // falling slope
+    const int32_t *rightWin = s_window[mode->blockFlag];
+    if(mode->blockFlag && !nextLong) {rightStart = 3 * n / 4 - bs0 / 4; rightN = bs0 / 2; rightWin = s_window[0];}
+    int prev = s_prevBlock;
+    int outN = prev ? prev / 4 + n / 4 : 0;
+    for(int c = 0; c < s_channels; c++) {
+        int32_t *u = s_vec[c];
+        if(floorUsed[c]) {
+            floorApply(&s_floors[map->submapFloor[map->mux[c]]], Y[c], u, n2);
+            dct4(u, n2);
+        }
+        else memset(u, 0, n2 * sizeof(int32_t));
+        int32_t *ov = s_overlap[c];
+        for(int t = 0; t < outN; t++) {
+            int32_t s = t < prev / 2 ? ov[t] : 0;   // right half of the previous block
+            int k = t - prev / 4 + n / 4;           // index in this block
+            if(k >= leftStart) {
+                int32_t y = imdctSample(u, k, n);
+                if(k < leftStart + leftN) y = MULT31(y, leftWin[k - leftStart]);
+                s += y;
+            }
+            s = (s + (1 << (SQ - 16))) >> (SQ - 15);
+            outbuf[t * s_channels + c] = s > 32767 ? 32767 : s < -32768 ? -32768 : s;
+        }
+        for(int k = 0; k < n2; k++) {               // keep the right half for the next block
+            int x = n2 + k;
+            int32_t y = 0;
+            if(x < rightStart) y = imdctSample(u, x, n);
+            else if(x < rightStart + rightN) y = MULT31(imdctSample(u, x, n), rightWin[rightN - 1 - (x - rightStart)]);
+            ov[k] = y;
+        }
+    }
+    s_prevBlock = n;
+    s_validSamples = outN * s_channels;
+    if(outN) {
+        uint32_t rate = (uint32_t)((uint64_t)len * 8 * s_sampleRate / outN);
+        s_bitRate = s_nominalBitRate ? s_nominalBitRate : s_bitRate ? (s_bitRate * 15 + rate) / 16 : rate;
+    }
+    return ERR_VORBIS_NONE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          V O R B I S   I N I   S E C T I O N
+//----------------------------------------------------------------------------------------------------------------------
+bool VORBISDecoder_AllocateBuffers(){
+    if(!s_arena) {
+        s_arenaSize = psramFound() ? VORBIS_ARENA_PSRAM : VORBIS_ARENA_DRAM;
+        if(psramFound()) s_arena = (uint8_t*) ps_malloc(s_arenaSize);
+        else             s_arena = (uint8_t*) malloc(s_arenaSize);
+    }
+    if(!s_arena) {
+        log_e("not enough memory to allocate vorbisdecoder buffers");
+        VORBISDecoder_FreeBuffers();
+        return false;
+    }
+    s_arenaPeak = 0;
+    arenaReset();
+    VORBISDecoder_ClearBuffers();
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VORBISDecoder_ClearBuffers(){
+    s_prevBlock = 0;
+    s_validSamples = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VORBISDecoder_FreeBuffers(){
+    if(s_arena) {free(s_arena); s_arena = NULL;}
+    s_arenaSize = 0;
+    s_setupOk = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void VORBISDecoder_Reset(){                         // the packets are interrupted, the first block after the gap is
+    s_prevBlock = 0;                                // not played
+}
+//----------------------------------------------------------------------------------------------------------------------
+//          V O R B I S - D E C O D E R
+//----------------------------------------------------------------------------------------------------------------------
+int8_t VORBISDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf){
+    // one packet per call: the identification and setup headers or an audio packet, the comment header is skipped
+    s_validSamples = 0;
+    int len = *bytesLeft;
+    *bytesLeft = 0;
+    if(len <= 0) return ERR_VORBIS_NONE;
+    if(len > VORBIS_MAX_PACKET) return ERR_VORBIS_PACKET_TOO_BIG;
+    const uint8_t *pkt = inbuf;
+    if(pkt[0] & 1) {                                // header packets
+        if(pkt[0] == 1) return parseIdent(pkt, len);
+        if(pkt[0] == 5) {
+            int8_t ret = parseSetup(pkt, len);
+            if(ret) arenaReset();
+            return ret;
+        }
+        return ERR_VORBIS_NONE;
+    }
+    if(!s_setupOk) return ERR_VORBIS_NO_SETUP;
+    return decodeAudio(pkt, len, outbuf);
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint16_t VORBISGetOutputSamps(){
+    int vs = s_validSamples;
+    s_validSamples = 0;
+    return vs;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint8_t VORBISGetChannels(){
+    return s_channels;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t VORBISGetSampRate(){
+    return s_sampleRate;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint8_t VORBISGetBitsPerSample(){
+    return 16;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t VORBISGetBitRate(){
+    return s_bitRate;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t VORBISGetMemoryUsed(){
+    return s_arenaPeak;
+}
@@ -0,0 +1,48 @@
+/*
+ * vorbis_decoder.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Vorbis decoder (Vorbis I specification), integer arithmetic only, the input are the packets of an Ogg/Vorbis
+ *  stream, see container/ogg.h
+ *  Memory: one arena of fixed size, everything the setup header
+ *  describes (codebooks, floors, residues, windows, channel buffers) is placed in the arena. A stream whose
+ *  setup does not fit is refused (ERR_VORBIS_SETUP_TOO_BIG), nothing is allocated while decoding.
+ *  Restrictions:
+ *  mono or stereo, blocksizes up to 4096 (libvorbis uses 256/2048 or 512/4096 at most)
+ *  floor type 1 only, floor type 0 was last written by pre 1.0 encoders
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include "Arduino.h"
+
+#define VORBIS_MAX_PACKET       8192                // the setup header or one audio packet, longer comments are skipped
+#define VORBIS_MAX_BLOCKSIZE    4096                // 2048 samples per channel and packet at most
+#define VORBIS_MAX_CHANNELS     2
+#ifndef VORBIS_ARENA_PSRAM
+  #define VORBIS_ARENA_PSRAM    (128 * 1024)        // memory budget of the setup and the channel buffers
+#endif
+#ifndef VORBIS_ARENA_DRAM
+  #define VORBIS_ARENA_DRAM     (80 * 1024)         // without PSRAM, enough for libvorbis streams up to q10
+#endif
+
+enum : int8_t  {ERR_VORBIS_NONE = 0,
+                ERR_VORBIS_BAD_HEADER = -2,
+                ERR_VORBIS_UNSUPPORTED = -3,
+                ERR_VORBIS_SETUP_TOO_BIG = -4,
+                ERR_VORBIS_NO_SETUP = -5,
+                ERR_VORBIS_INVALID_PACKET = -6,
+                ERR_VORBIS_PACKET_TOO_BIG = -7};
+
+bool     VORBISDecoder_AllocateBuffers();
+void     VORBISDecoder_ClearBuffers();
+void     VORBISDecoder_FreeBuffers();
+void     VORBISDecoder_Reset();
+int8_t   VORBISDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
+uint16_t VORBISGetOutputSamps();
+uint8_t  VORBISGetChannels();
+uint32_t VORBISGetSampRate();
+uint8_t  VORBISGetBitsPerSample();
+uint32_t VORBISGetBitRate();
+uint32_t VORBISGetMemoryUsed();                     // the used part of the arena
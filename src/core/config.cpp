@@ -734,6 +734,7 @@ bool Config::loadStation(uint16_t ls) {
   uint16_t cs = playlistLength();
   if (cs == 0) {
     memset(station.url, 0, BUFLEN);
+    memset(station.mirrors, 0, MIRRORSLEN);
     memset(station.name, 0, BUFLEN);
     strncpy(station.name, "ёRadio", BUFLEN);
     station.ovol = 0;
@@ -749,11 +750,13 @@ bool Config::loadStation(uint16_t ls) {
   index.readBytes((char *) &pos, 4);
   index.close();
   playlist.seek(pos, SeekSet);
-  if (parseCSV(playlist.readStringUntil('\n').c_str(), tmpBuf, tmpBuf2, sOvol)) {
+  String line = playlist.readStringUntil('\n');
+  if (parseCSV(line.c_str(), tmpBuf, tmpBuf2, sOvol)) {
     memset(station.url, 0, BUFLEN);
     memset(station.name, 0, BUFLEN);
     strncpy(station.name, tmpBuf, BUFLEN);
     strncpy(station.url, tmpBuf2, BUFLEN);
+    parseMirrors(line.c_str(), station.mirrors, MIRRORSLEN);
     station.ovol = sOvol;
     setLastStation(ls);
   }
@@ -775,6 +778,24 @@ char * Config::stationByNum(uint16_t num){
   return _stationBuf;
 }
 
+bool Config::stationUrlByNum(uint16_t num, char* url, size_t len){
+  // url of a playlist entry, config.station is not touched
+  if (num == 0 || num > playlistLength()) return false;
+  File playlist = SDPLFS()->open(REAL_PLAYL, "r");
+  File index = SDPLFS()->open(REAL_INDEX, "r");
+  index.seek((num - 1) * 4, SeekSet);
+  uint32_t pos;
+  index.readBytes((char *) &pos, 4);
+  index.close();
+  playlist.seek(pos, SeekSet);
+  String line = playlist.readStringUntil('\n');
+  playlist.close();
+  if (line.length() >= len) return false;
+  char name[len];
+  int sOvol;
+  return parseCSV(line.c_str(), name, url, sOvol);
+}
+
 uint8_t Config::fillPlMenu(int from, uint8_t count, bool fromNextion) {
   int     ls      = from;
   uint8_t c       = 0;
@@ -854,6 +875,24 @@ bool Config::parseCSV(const char* line, char* name, char* url, int &ovol) {
   return true;
 }
 
+void Config::parseMirrors(const char* line, char* mirrors, size_t len) {
+  // name \t url \t ovol [\t url|url|..]
+  mirrors[0] = '\0';
+  const char* cursor = line;
+  for (uint8_t i = 0; i < 3 && cursor; i++) {
+    cursor = strchr(cursor, '\t');
+    if (cursor) cursor++;
+  }
+  if (!cursor) return;
+  size_t n = strcspn(cursor, "\r\n");
+  strlcpy(mirrors, cursor, n < len ? n + 1 : len);
+  if (n >= len) {                                  // a cut off url is dropped
+    char* bar = strrchr(mirrors, '|');
+    if (bar) *bar = '\0';
+    else mirrors[0] = '\0';
+  }
+}
+
 bool Config::parseJSON(const char* line, char* name, char* url, int &ovol) {
   char* tmps, *tmpe;
   const char* cursor = line;
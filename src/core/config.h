@@ -17,6 +17,9 @@
 #ifndef BUFLEN
   #define BUFLEN            170
 #endif
+#ifndef MIRRORSLEN
+  #define MIRRORSLEN        (BUFLEN * 2)
+#endif
 #define PLAYLIST_PATH     "/data/playlist.csv"
 #define SSIDS_PATH        "/data/wifi.csv"
 #define TMP_PATH          "/data/tmpfile.txt"
@@ -172,6 +175,7 @@ struct station_t
 {
   char name[BUFLEN];
   char url[BUFLEN];
+  char mirrors[MIRRORSLEN];   // more urls of the same stream, "url|url|..", 4th column of the playlist
   char title[BUFLEN];
   uint16_t bitrate;
   int  ovol;
@@ -227,6 +231,7 @@ class Config {
     void setStation(const char* station);
     void escapeQuotes(const char* input, char* output, size_t maxLen);
     bool parseCSV(const char* line, char* name, char* url, int &ovol);
+    void parseMirrors(const char* line, char* mirrors, size_t len);
     bool parseJSON(const char* line, char* name, char* url, int &ovol);
     bool parseWsCommand(const char* line, char* cmd, char* val, uint8_t cSize);
     bool parseSsid(const char* line, char* ssid, char* pass);
@@ -253,6 +258,7 @@ class Config {
     }
     uint8_t fillPlMenu(int from, uint8_t count, bool fromNextion=false);
     char * stationByNum(uint16_t num);
+    bool stationUrlByNum(uint16_t num, char* url, size_t len);
     void setTimezone(int8_t tzh, int8_t tzm);
     void setTimezoneOffset(uint16_t tzo);
     uint16_t getTimezoneOffset();
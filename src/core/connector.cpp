@@ -0,0 +1,195 @@
+#include "connector.h"
+#include <WiFi.h>
+#include "lwip/sockets.h"
+#include "dnscache.h"
+#include "telnet.h"
+
+#define CN_POLL_MS          10
+#define CN_SLICE_MS         50      /* the TCP connect checks for cancel() this often */
+
+Connector connector;
+
+bool Connector::_begin() {
+  if (_taskHandle) return true;
+  if (!_mutex) _mutex = xSemaphoreCreateMutex();
+  if (!_done) _done = xSemaphoreCreateBinary();
+  if (!_queue) _queue = xQueueCreate(1, sizeof(cnRequest_t));
+  if (!_mutex || !_done || !_queue) return false;
+  xTaskCreatePinnedToCore(_task, "ConnectTask", WATCHDOG_TASK_SIZE, this, WATCHDOG_TASK_PRIORITY, &_taskHandle, WATCHDOG_TASK_CORE_ID);
+  return _taskHandle != NULL;
+}
+
+int Connector::open(const char *host, uint16_t port, uint32_t timeout, uint32_t *gen, cnIdle_t idle, void *arg) {
+  if (gen) *gen = 0;
+  if (strlen(host) >= CN_HOST_LEN || !_begin()) return -1;
+  cnRequest_t r;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  if (++_gen == 0) _gen = 1;                       /* 0: not cancellable */
+  r.gen = _gen;
+  _openGen = _gen;
+  _stage = CN_DNS;
+  _stageStart = millis();
+  xSemaphoreGive(_mutex);
+  strlcpy(r.host, host, CN_HOST_LEN);
+  r.port = port;
+  r.timeout = timeout;
+  xQueueOverwrite(_queue, &r);
+  if (gen) *gen = r.gen;
+  while (true) {
+    xSemaphoreTake(_done, pdMS_TO_TICKS(CN_POLL_MS));
+    if (idle) idle(arg);
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    if (_gen != r.gen) {                           /* cancel() */
+      _cancelled++;
+      xSemaphoreGive(_mutex);
+      return -1;
+    }
+    if (_doneGen == r.gen) {
+      int fd = _fd;
+      _fd = -1;
+      xSemaphoreGive(_mutex);
+      return fd;
+    }
+    /* the task is still in the resolver (still waits for an earlier one): the result is dropped */
+    bool late = _stage == CN_DNS ? now - _stageStart > CONNECT_DNS_TIMEOUT : now - _stageStart > timeout + CN_SLICE_MS * 4;
+    if (late) {
+      _failed[_stage]++;
+      if (++_gen == 0) _gen = 1;
+      xSemaphoreGive(_mutex);
+      return -1;
+    }
+    xSemaphoreGive(_mutex);
+  }
+}
+
+uint32_t Connector::claim() {
+  if (!_begin()) return 0;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  if (++_gen == 0) _gen = 1;
+  _openGen = _gen;
+  uint32_t gen = _gen;
+  xSemaphoreGive(_mutex);
+  return gen;
+}
+
+void Connector::cancel() {
+  if (!_mutex) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  _userGen = _openGen;                             /* also after the connect, the header may still be awaited */
+  if (++_gen == 0) _gen = 1;
+  xSemaphoreGive(_mutex);
+  xSemaphoreGive(_done);
+}
+
+void Connector::stage(cnStage_e s, uint32_t ms) {
+  _last[s] = ms;
+  _sum[s] += ms;
+  _count[s]++;
+}
+
+void Connector::fail(cnStage_e s, bool cancelled) {
+  if (cancelled) _cancelled++;
+  else _failed[s]++;
+}
+
+bool Connector::_setStage(uint32_t gen, cnStage_e s) {
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  bool mine = gen == _gen;
+  if (mine) {
+    _stage = s;
+    _stageStart = millis();
+  }
+  xSemaphoreGive(_mutex);
+  return mine;
+}
+
+int Connector::_connect(const cnRequest_t &r, uint32_t ip) {
+  int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) return -1;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(r.port);
+  sa.sin_addr.s_addr = ip;
+  if (lwip_connect(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) { lwip_close(fd); return -1; }
+  uint32_t t = millis();
+  while (true) {
+    if (cancelled(r.gen)) { lwip_close(fd); return -1; }
+    if (millis() - t > r.timeout) { lwip_close(fd); return -1; }
+    fd_set ws;
+    FD_ZERO(&ws);
+    FD_SET(fd, &ws);
+    struct timeval tv = {0, CN_SLICE_MS * 1000};
+    int res = select(fd + 1, NULL, &ws, NULL, &tv);
+    if (res < 0) { lwip_close(fd); return -1; }
+    if (res > 0) break;
+  }
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if (lwip_getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err) { lwip_close(fd); return -1; }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);  /* as WiFiClient::connect() leaves it */
+  int enable = 1;
+  lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  lwip_setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+  return fd;
+}
+
+void Connector::_work(const cnRequest_t &r) {
+  uint32_t t = millis(), ms[2] = {};
+  IPAddress ip;
+  bool stale = false;
+#if DNS_CACHE
+  bool ok = dnsCache.resolve(r.host, ip, &stale);
+#else
+  bool ok = WiFi.hostByName(r.host, ip) == 1;
+#endif
+  ms[CN_DNS] = millis() - t;
+  int fd = -1;
+  if (ok && _setStage(r.gen, CN_TCP)) {
+    t = millis();
+    fd = _connect(r, ip);
+#if DNS_CACHE
+    if (fd < 0 && stale && !cancelled(r.gen)) {    /* the resolver was slow, the old address may have moved */
+      dnsCache.invalidate(r.host);
+      if (dnsCache.resolve(r.host, ip) && !cancelled(r.gen)) fd = _connect(r, ip);
+    }
+#endif
+    ms[CN_TCP] = millis() - t;
+  }
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  if (r.gen == _gen) {
+    _fd = fd;
+    _doneGen = r.gen;
+    if (!ok) _failed[CN_DNS]++;
+    else stage(CN_DNS, ms[CN_DNS]);
+    if (fd >= 0) stage(CN_TCP, ms[CN_TCP]);
+    else if (ok) _failed[CN_TCP]++;
+  } else if (fd >= 0) {
+    lwip_close(fd);                                /* cancelled or given up by open() */
+  }
+  xSemaphoreGive(_mutex);
+  xSemaphoreGive(_done);
+}
+
+void Connector::_task(void *pvParameters) {
+  Connector *self = static_cast<Connector *>(pvParameters);
+  cnRequest_t r;
+  while (true) {
+    if (xQueueReceive(self->_queue, &r, portMAX_DELAY) != pdTRUE) continue;
+    if (self->cancelled(r.gen)) continue;          /* replaced or cancelled while it was waiting */
+    self->_work(r);
+  }
+}
+
+void Connector::printStatus(uint8_t id) {
+  if (!_count[CN_DNS] && !_failed[CN_DNS] && !_cancelled) return;
+  static const char *names[] = { "dns", "tcp", "tls", "header" };
+  telnet.printf(id, "connect:\t");
+  for (uint8_t s = 0; s < CN_STAGES; s++) {
+    if (!_count[s] && !_failed[s]) continue;
+    telnet.printf(id, "%s %u ms (avg %u, %u failed), ", names[s], _last[s], _count[s] ? _sum[s] / _count[s] : 0, _failed[s]);
+  }
+  telnet.printf(id, "%u cancelled\n", _cancelled);
+}
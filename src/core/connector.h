@@ -0,0 +1,65 @@
+#ifndef connector_h
+#define connector_h
+#include "Arduino.h"
+#include "options.h"
+
+/*
+ * One connect task for Audio::connecttohost() and the keep-alive reconnects of Audio::httpPrint(). It resolves
+ * the host (dnsCache) and opens the TCP connection non-blocking, the caller gets the socket and does the TLS
+ * handshake (TlsClient::attach()). open() waits for the result; a new request replaces the one that waits in
+ * the queue, cancel() (a new station, stop, from any task) ends the connect in flight: open() and the handshake
+ * return at once, the task drops the socket at its next check (a lookup of the resolver runs to its end).
+ * cancelledByUser() tells a cancel() from a failure, the caller then gives up without a retry or an error.
+ * The optional idle callback runs in the caller's task while open() waits (Audio plays a crossfade on).
+ * Stages and their timeouts: DNS CONNECT_DNS_TIMEOUT, TCP and TLS the connection timeouts of Audio, the first
+ * byte of the response header HEADER_TIMEOUT (Audio::parseHttpResponseHeader()). The time of every stage is
+ * counted for the telnet audio stats.
+ */
+
+#define CN_HOST_LEN     128
+
+enum cnStage_e : uint8_t { CN_DNS = 0, CN_TCP = 1, CN_TLS = 2, CN_HEADER = 3, CN_STAGES = 4 };
+
+typedef void (*cnIdle_t)(void *arg);
+
+struct cnRequest_t {
+  uint32_t gen;
+  char host[CN_HOST_LEN];
+  uint16_t port;
+  uint32_t timeout;                                /* TCP stage, ms */
+};
+
+class Connector {
+  public:
+    Connector() {};
+    int open(const char *host, uint16_t port, uint32_t timeout, uint32_t *gen = NULL, cnIdle_t idle = NULL, void *arg = NULL); /* socket or -1, gen: of the request */
+    uint32_t claim();                              /* gen of a connect the caller makes itself (Audio::mirrorRace()) */
+    void cancel();
+    bool cancelled(uint32_t gen) { return gen && gen != _gen; }          /* cancelled, replaced or given up */
+    bool cancelledByUser(uint32_t gen) { return gen && gen == _userGen; } /* cancel() was called for it */
+    void stage(cnStage_e s, uint32_t ms);          /* a stage is done, TLS and header are timed by Audio */
+    void fail(cnStage_e s, bool cancelled);        /* a stage has failed or timed out, or it was cancelled */
+    void printStatus(uint8_t id);
+  private:
+    volatile uint32_t _gen = 0;                    /* request in flight, changed by open() and cancel() */
+    uint32_t _openGen = 0;                         /* last request of open() or claim() */
+    volatile uint32_t _userGen = 0;                /* the last request that cancel() has ended */
+    uint32_t _doneGen = 0;                         /* the task has a result for this request */
+    int _fd = -1;
+    cnStage_e _stage = CN_DNS;                     /* stage of the request in flight */
+    uint32_t _stageStart = 0;
+    uint32_t _last[CN_STAGES] = {}, _sum[CN_STAGES] = {}, _count[CN_STAGES] = {}, _failed[CN_STAGES] = {};
+    uint32_t _cancelled = 0;
+    QueueHandle_t _queue = NULL;
+    SemaphoreHandle_t _mutex = NULL, _done = NULL;
+    TaskHandle_t _taskHandle = NULL;
+    bool _begin();
+    bool _setStage(uint32_t gen, cnStage_e s);
+    int _connect(const cnRequest_t &r, uint32_t ip);
+    void _work(const cnRequest_t &r);
+    static void _task(void *pvParameters);
+};
+
+extern Connector connector;
+
+#endif
@@ -6,6 +6,7 @@
 #include "display.h"
 #include "network.h"
 #include "netserver.h"
+#include "prefetch.h"
 #include "ModbusHandler.h"
 
 long encOldPosition  = 0;
@@ -471,6 +472,9 @@ void controlsEvent(bool toRight, int8_t volDelta) {
     if (p > cs) p = 1;
     display.currentPlItem = p;
     display.putRequest(DRAWPLAYLIST, p);
+    #if ZAP_PREFETCH
+      if (config.getMode() == PM_WEB) prefetch.wake();   /* the user is about to zap */
+    #endif
   }
 }
 
@@ -135,6 +135,9 @@ void Display::_buildPager(){
   #ifndef HIDE_VU
     _vuwidget = new VuWidget(vuConf, bandsConf, config.theme.vumax, config.theme.vumin, config.theme.background);
   #endif
+  #if defined(SPECTRUM_WIDGET) && !defined(HIDE_SPECTRUM) && (I2S_DOUT!=255 || I2S_INTERNAL)
+    _spectrum = new SpectrumWidget(spectrumConf, spectrumBandsConf, config.theme.vumax, config.theme.vumin, config.theme.background);
+  #endif
   #ifndef HIDE_VOLBAR
     _volbar = new SliderWidget(volbarConf, config.theme.volbarin, config.theme.background, 254, config.theme.volbarout);
   #endif
@@ -174,6 +177,7 @@ void Display::_buildPager(){
     pages[PG_PLAYER]->addWidget( _bitrate);
   #endif
   if(_vuwidget) pages[PG_PLAYER]->addWidget( _vuwidget);
+  if(_spectrum) pages[PG_PLAYER]->addWidget( _spectrum);
   pages[PG_PLAYER]->addWidget(&_clock);
   pages[PG_SCREENSAVER]->addWidget(&_clock);
   pages[PG_PLAYER]->addPage(&_footer);
@@ -254,6 +258,7 @@ void Display::_start() {
   if(_weather && config.store.showweather)  _weather->setText(const_getWeather);
 
   if(_vuwidget) _vuwidget->lock();
+  if(_spectrum) _spectrum->lock();
   if(_rssi)     _setRSSI(WiFi.RSSI());
   #ifndef HIDE_IP
     if(_volip) _volip->setText(config.ipToStr(WiFi.localIP()), iptxtFmt);
@@ -373,10 +378,12 @@ void Display::_layoutChange(bool played){
   if(config.store.vumeter){
     if(played){
       if(_vuwidget) _vuwidget->unlock();
+      if(_spectrum) _spectrum->unlock();
       _clock.moveTo(clockMove);
       if(_weather) _weather->moveTo(weatherMoveVU);
     }else{
       if(_vuwidget) if(!_vuwidget->locked()) _vuwidget->lock();
+      if(_spectrum) if(!_spectrum->locked()) _spectrum->lock();
       _clock.moveBack();
       if(_weather) _weather->moveBack();
     }
@@ -433,6 +440,7 @@ void Display::loop() {
           break;
         case AUDIOINFO: if(_heapbar)  { _heapbar->lock(!config.store.audioinfo); _heapbar->setValue(player.inBufferFilled()); } break;
         case SHOWVUMETER: {
+          if(_spectrum) _spectrum->lock(!config.store.vumeter);
           if(_vuwidget){
             _vuwidget->lock(!config.store.vumeter); 
             _layoutChange(player.isRunning());
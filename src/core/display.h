@@ -47,6 +47,7 @@ class Display {
     Pager _pager;
     Page _footer;
     VuWidget *_vuwidget;
+    SpectrumWidget *_spectrum;
     NumWidget _nums;
     ProgressWidget _testprogress;
     ClockWidget _clock;
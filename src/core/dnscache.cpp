@@ -0,0 +1,254 @@
+#include "dnscache.h"
+#include <SPIFFS.h>
+#include "config.h"
+#include "network.h"
+#include "telnet.h"
+
+#define DC_TASK_SIZE        1024 * 4
+#define DC_TASK_PRIORITY    1
+#define DC_TASK_CORE_ID     0
+#define DC_TICK_MS          1000
+#define DC_RETRY_MS         30000
+
+DnsCache dnsCache;
+
+/* file: magic, then per entry ip (LE 32 bit), lookup time (LE 16 bit), host length (8 bit), host */
+
+static bool dc_host(const char *url, char *out, size_t len) {
+  const char *h = strstr(url, "://");
+  h = h ? h + 3 : url;
+  size_t n = strcspn(h, ":/?");
+  if (n == 0 || n >= len) return false;
+  memcpy(out, h, n);
+  out[n] = '\0';
+  return true;
+}
+
+bool DnsCache::_begin() {
+  if (_mutex) return _entries != NULL;
+  _mutex = xSemaphoreCreateMutex();
+  if (!_mutex) return false;
+  _size = psramInit() ? DNS_CACHE_SIZE : 8;
+  _entries = (dcEntry_t *)(psramInit() ? ps_calloc(_size, sizeof(dcEntry_t)) : calloc(_size, sizeof(dcEntry_t)));
+  if (!_entries) return false;
+#if DNS_CACHE_PERSIST
+  _load();
+#endif
+  xTaskCreatePinnedToCore(_task, "DnsTask", DC_TASK_SIZE, this, DC_TASK_PRIORITY, &_taskHandle, DC_TASK_CORE_ID);
+  return true;
+}
+
+void DnsCache::_load() {
+  File f = SPIFFS.open(DC_PATH, "r");
+  if (!f) return;
+  uint32_t magic = 0;
+  if (f.read((uint8_t *)&magic, 4) != 4 || magic != DC_MAGIC) { f.close(); return; }
+  uint8_t hdr[7];
+  for (uint16_t i = 0; i < _size && f.read(hdr, sizeof(hdr)) == sizeof(hdr); i++) {
+    dcEntry_t &e = _entries[i];
+    uint8_t len = hdr[6];
+    if (len >= DC_HOST_LEN || f.read((uint8_t *)e.host, len) != len) { e.host[0] = '\0'; break; }
+    e.host[len] = '\0';
+    memcpy(&e.ip, hdr, 4);
+    memcpy(&e.lookupMs, hdr + 4, 2);
+    e.resolved = 0;                                /* stale until it is looked up again */
+    e.next = millis();
+  }
+  f.close();
+}
+
+dcEntry_t *DnsCache::_find(const char *host) {
+  for (uint16_t i = 0; i < _size; i++) if (_entries[i].host[0] && strcmp(_entries[i].host, host) == 0) return &_entries[i];
+  return NULL;
+}
+
+dcEntry_t *DnsCache::_add(const char *host) {
+  dcEntry_t *e = &_entries[0];                     /* a free one, or the one not used for the longest time */
+  for (uint16_t i = 0; i < _size && e->host[0]; i++) if (!_entries[i].host[0] || _entries[i].used < e->used) e = &_entries[i];
+  memset(e, 0, sizeof(dcEntry_t));
+  strlcpy(e->host, host, DC_HOST_LEN);
+  e->next = millis();
+  return e;
+}
+
+bool DnsCache::_lookup(const char *host, IPAddress &ip, uint16_t &ms) {
+  uint32_t t = millis();
+  bool ok = WiFi.hostByName(host, ip) == 1 && (uint32_t)ip != 0;
+  uint32_t dt = millis() - t;
+  ms = dt > UINT16_MAX ? UINT16_MAX : dt;
+  return ok;
+}
+
+void DnsCache::_set(const char *host, const IPAddress &ip, uint16_t ms, bool ok) {
+  /* result of a lookup, under the mutex */
+  uint32_t now = millis();
+  _lookups++;
+  _lookupMs += ms;
+  dcEntry_t *e = _find(host);
+  if (!e) {
+    if (!ok) return;
+    e = _add(host);
+  }
+  e->refresh = false;
+  if (!ok) {
+    if (!e->ip) e->host[0] = '\0';                 /* ahead(): unknown host */
+    else e->next = now + DC_RETRY_MS;              /* the old address stays */
+    return;
+  }
+  if (e->ip != (uint32_t)ip) _dirty = true;
+  e->ip = ip;
+  e->resolved = now ? now : 1;
+  e->lookupMs = ms;
+  e->next = now + DNS_CACHE_TTL * 750UL;           /* refresh at 3/4 of the TTL while it is in use */
+}
+
+bool DnsCache::resolve(const char *host, IPAddress &ip, bool *stale) {
+  if (stale) *stale = false;
+  if (ip.fromString(host)) return true;
+  uint16_t ms;
+  if (!_begin() || strlen(host) >= DC_HOST_LEN) return _lookup(host, ip, ms);
+  uint32_t now = millis();
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  dcEntry_t *e = _find(host);
+  if (e && e->ip && e->resolved && now - e->resolved < DNS_CACHE_TTL * 1000UL) {
+    e->used = now;
+    ip = e->ip;
+    _hits++;
+    _savedMs += e->lookupMs;
+    xSemaphoreGive(_mutex);
+    return true;
+  }
+  if (e && e->ip) {                                /* stale: the dns task looks it up, the old address if it is slow */
+    uint32_t addr = e->ip;
+    e->used = now;
+    e->refresh = true;
+    xSemaphoreGive(_mutex);
+    xTaskNotifyGive(_taskHandle);
+    bool done = false;
+    while (!done && millis() - now < DNS_CACHE_SLOW_MS) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      xSemaphoreTake(_mutex, portMAX_DELAY);
+      e = _find(host);
+      done = !e || !e->refresh;
+      if (e && e->ip) addr = e->ip;
+      xSemaphoreGive(_mutex);
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (done) _misses++;
+    else _stale++;
+    xSemaphoreGive(_mutex);
+    if (stale) *stale = !done;
+    ip = addr;
+    return true;
+  }
+  _misses++;
+  xSemaphoreGive(_mutex);
+  bool ok = _lookup(host, ip, ms);                 /* nothing to fall back to, the caller waits */
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  _set(host, ip, ms, ok);
+  if (ok && (e = _find(host))) e->used = millis();
+  xSemaphoreGive(_mutex);
+  return ok;
+}
+
+void DnsCache::ahead(uint16_t station) {
+  uint16_t len = config.playlistLength();
+  if (config.getMode() != PM_WEB || len < 2 || !_begin()) return;
+  char url[BUFLEN], host[DC_HOST_LEN];
+  IPAddress ip;
+  for (uint16_t k = 1; k <= DNS_CACHE_AHEAD && k < len; k++) {
+    uint16_t n = (station - 1 + k) % len + 1;
+    if (!config.stationUrlByNum(n, url, BUFLEN) || !dc_host(url, host, DC_HOST_LEN) || ip.fromString(host)) continue;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_find(host)) _add(host);
+    xSemaphoreGive(_mutex);
+  }
+  xTaskNotifyGive(_taskHandle);
+}
+
+void DnsCache::invalidate(const char *host) {
+  if (!_mutex || !_entries) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  dcEntry_t *e = _find(host);
+  if (e) {
+    e->host[0] = '\0';
+    _dirty = true;
+  }
+  xSemaphoreGive(_mutex);
+}
+
+bool DnsCache::_work() {
+  /* one lookup: a waiting resolve() first, then the hosts of ahead(), then the refresh of the hosts in use */
+  char host[DC_HOST_LEN];
+  uint32_t now = millis();
+  dcEntry_t *w = NULL;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  for (uint16_t i = 0; i < _size && !(w && w->refresh); i++) {
+    dcEntry_t &e = _entries[i];
+    if (!e.host[0]) continue;
+    bool due = (int32_t)(now - e.next) >= 0;
+    if (e.refresh || (!e.ip && due) || (!w && due && e.used && now - e.used < DNS_CACHE_TTL * 1000UL)) w = &e;
+  }
+  if (w) strlcpy(host, w->host, DC_HOST_LEN);
+  xSemaphoreGive(_mutex);
+  if (!w) return false;
+  IPAddress ip;
+  uint16_t ms;
+  bool ok = _lookup(host, ip, ms);
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  _set(host, ip, ms, ok);
+  xSemaphoreGive(_mutex);
+  return true;
+}
+
+void DnsCache::_task(void *pvParameters) {
+  DnsCache *self = static_cast<DnsCache *>(pvParameters);
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DC_TICK_MS));
+    while (network.status == CONNECTED && self->_work()) ;
+  }
+}
+
+void DnsCache::flush() {
+#if DNS_CACHE_PERSIST
+  if (!_dirty || !_mutex) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  size_t len = 4;
+  for (uint16_t i = 0; i < _size; i++) if (_entries[i].host[0] && _entries[i].ip) len += 7 + strlen(_entries[i].host);
+  uint8_t *buf = (uint8_t *)malloc(len);
+  if (!buf) { xSemaphoreGive(_mutex); return; }
+  uint32_t magic = DC_MAGIC;
+  memcpy(buf, &magic, 4);
+  uint8_t *p = buf + 4;
+  for (uint16_t i = 0; i < _size; i++) {
+    dcEntry_t &e = _entries[i];
+    if (!e.host[0] || !e.ip) continue;
+    uint8_t hl = strlen(e.host);
+    memcpy(p, &e.ip, 4);
+    memcpy(p + 4, &e.lookupMs, 2);
+    p[6] = hl;
+    memcpy(p + 7, e.host, hl);
+    p += 7 + hl;
+  }
+  _dirty = false;
+  xSemaphoreGive(_mutex);
+  File f = SPIFFS.open(DC_PATH, "w");
+  if (f) {
+    if (f.write(buf, len) != len) _dirty = true;
+    f.close();
+  } else {
+    _dirty = true;
+  }
+  free(buf);
+#endif
+}
+
+void DnsCache::printStatus(uint8_t id) {
+  if (!_mutex || !_entries) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < _size; i++) if (_entries[i].host[0] && _entries[i].ip) n++;
+  telnet.printf(id, "##SYS.DNS#: %u/%u hosts, %u hits, %u misses, %u stale, %u ms saved, avg lookup %u ms\n", n, _size,
+                _hits, _misses, _stale, _savedMs, _lookups ? _lookupMs / _lookups : 0);
+  xSemaphoreGive(_mutex);
+}
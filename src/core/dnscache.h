@@ -0,0 +1,60 @@
+#ifndef dnscache_h
+#define dnscache_h
+#include "Arduino.h"
+#include <WiFi.h>
+#include "options.h"
+
+/*
+ * Addresses of the station hosts for Audio::connecttohost() and the keep-alive reconnects of Audio::httpPrint().
+ * An entry is fresh for DNS_CACHE_TTL s (the Arduino resolver does not report the TTL of the record). A stale
+ * entry is looked up again by the dns task, resolve() waits DNS_CACHE_SLOW_MS for it and takes the old address
+ * when the resolver is slower. The dns task also resolves the hosts of the next DNS_CACHE_AHEAD playlist
+ * entries (ahead()) and refreshes the hosts in use before they expire. https hosts are resolved by TlsClient
+ * (core/tlssession.h) with resolve(), it needs the name for SNI.
+ * With DNS_CACHE_PERSIST the table is kept in SPIFFS (DC_PATH), entries from the file are stale.
+ */
+
+#define DC_PATH         "/data/dns.dat"
+#define DC_HOST_LEN     96
+#define DC_MAGIC        0x31434E44      /* "DNC1" */
+
+struct dcEntry_t {
+  char host[DC_HOST_LEN];                          /* "": free */
+  uint32_t ip;                                     /* 0: not resolved yet (ahead()) */
+  uint32_t resolved;                               /* millis() of the last lookup, 0: from the file */
+  uint32_t used;                                   /* millis() of the last resolve(), for refresh and replacement */
+  uint32_t next;                                   /* millis() of the next lookup of the dns task */
+  uint16_t lookupMs;                               /* time the last lookup took */
+  bool refresh;                                    /* resolve() waits for a new lookup */
+};
+
+class DnsCache {
+  public:
+    DnsCache() {};
+    bool resolve(const char *host, IPAddress &ip, bool *stale = NULL); /* false: no address, stale: not confirmed */
+    void ahead(uint16_t station);                  /* player task, after a station has started */
+    void invalidate(const char *host);             /* the address did not connect */
+    void flush();                                  /* writes the file if an address has changed, TimeKeeper::loop0() */
+    void printStatus(uint8_t id);
+  private:
+    dcEntry_t *_entries = NULL;
+    uint16_t _size = 0;
+    uint32_t _hits = 0, _misses = 0, _stale = 0;
+    uint32_t _savedMs = 0;                         /* lookup time of the entries at their hits */
+    uint32_t _lookups = 0, _lookupMs = 0;          /* lookups of resolve() and the dns task */
+    bool _dirty = false;
+    SemaphoreHandle_t _mutex = NULL;
+    TaskHandle_t _taskHandle = NULL;
+    bool _begin();
+    void _load();
+    dcEntry_t *_find(const char *host);
+    dcEntry_t *_add(const char *host);
+    bool _lookup(const char *host, IPAddress &ip, uint16_t &ms);
+    void _set(const char *host, const IPAddress &ip, uint16_t ms, bool ok);
+    bool _work();
+    static void _task(void *pvParameters);
+};
+
+extern DnsCache dnsCache;
+
+#endif
@@ -301,6 +301,12 @@ void NetServer::processQueue(){
 }
       case VOLUME:        sprintf (wsBuf, "{\"payload\":[{\"id\":\"volume\", \"value\": %d}]}", config.store.volume); telnet.printf("##CLI.VOL#: %d\n", config.store.volume); break;
       case NRSSI:        { sprintf (wsBuf, "{\"payload\":[{\"id\":\"rssi\", \"value\": %d}, {\"id\":\"heap\", \"value\": %d}]}", rssi, (player.isRunning() && config.store.audioinfo)?(int)(100*player.inBufferFilled()/playerBufMax):0);/*rssi = 255;*/ 
+      #if I2S_DOUT!=255 || I2S_INTERNAL
+        if(player.isRunning() && config.getMode()==PM_WEB){
+          const jitterBuf_t& jb = player.getJitterBuf();
+          sprintf (wsBuf + strlen(wsBuf) - 2, ", {\"id\":\"jbtarget\", \"value\": %u}, {\"id\":\"jitter\", \"value\": %u}, {\"id\":\"jbunder\", \"value\": %u}]}", jb.targetMs, JB_JitterMs(&jb), jb.underruns);
+        }
+      #endif
       int quality = map(rssi, -100, -30, 0, 100);//Преобразуем...
       if (quality < 0) quality = 0;//в диапазон...
       if (quality < 0) quality = 0;//0...100
@@ -485,6 +485,9 @@ The connection tables are located here https://github.com/e2002/yoradio#connecti
 #ifndef SCREENSAVERSTARTUPDELAY
   #define SCREENSAVERSTARTUPDELAY 5
 #endif
+#ifndef CONNECT_DNS_TIMEOUT
+  #define CONNECT_DNS_TIMEOUT    3000 // web streams (I2S): max. wait for the address of the host, then the connect fails
+#endif
 #ifndef HEADER_TIMEOUT
   #define HEADER_TIMEOUT    5000
 #endif
@@ -506,6 +509,111 @@ The connection tables are located here https://github.com/e2002/yoradio#connecti
 #ifndef WATCHDOG_TASK_CORE_ID
   #define WATCHDOG_TASK_CORE_ID    1
 #endif
+#ifndef PLAYER_TASK_SIZE
+  #define PLAYER_TASK_SIZE    1024*8    // network, demux and decoder task (I2S output with AUDIO_RING_FRAMES > 0)
+#endif
+#ifndef PLAYER_TASK_PRIORITY
+  #define PLAYER_TASK_PRIORITY    1
+#endif
+#ifndef PLAYER_TASK_CORE_ID
+  #define PLAYER_TASK_CORE_ID    1
+#endif
+#ifndef AUDIO_RING_FRAMES
+  #define AUDIO_RING_FRAMES    4096     // PCM ring decoder -> I2S output task, stereo frames of 4 bytes in internal RAM
+#endif                                  // 0 - decoder and I2S output run in the player loop
+#ifndef AUDIO_OUT_TASK_SIZE
+  #define AUDIO_OUT_TASK_SIZE    1024*3
+#endif
+#ifndef AUDIO_OUT_TASK_PRIORITY
+  #define AUDIO_OUT_TASK_PRIORITY    4
+#endif
+#ifndef AUDIO_OUT_TASK_CORE_ID
+  #define AUDIO_OUT_TASK_CORE_ID    0
+#endif
+#ifndef AUDIO_RESAMPLE_RATE
+  #define AUDIO_RESAMPLE_RATE    0    // I2S (not VS1053): fixed output rate, e.g. 48000, other stream rates are resampled
+#endif                                // 0 - the I2S clock follows the stream (reconfigured on every rate change)
+#ifndef AUDIO_RESAMPLE_QUALITY
+  #define AUDIO_RESAMPLE_QUALITY    1 // 0 - 8 taps, 1 - 16 taps, 2 - 32 taps (see audioI2S/dsp/resampler.h)
+#endif
+#ifndef VU_PEAK_HOLD_MS
+  #define VU_PEAK_HOLD_MS    1000     // VU meter (I2S): peak hold time
+#endif
+#ifndef VU_DECAY_MS
+  #define VU_DECAY_MS    500          // VU meter (I2S): fall time of peak and hold from full scale to 0
+#endif
+#ifndef VU_RMS_MS
+  #define VU_RMS_MS    300            // VU meter (I2S): time constant of the RMS
+#endif
+#ifndef SPECTRUM_FPS
+  #define SPECTRUM_FPS    25          // spectrum widget (I2S): updates per second, one FFT per update
+#endif
+#ifndef JITTER_START_MS
+  #define JITTER_START_MS    200      // web streams (I2S): buffered audio to start decoding (see audioI2S/net/jitter.h)
+#endif
+#ifndef JITTER_MAX_MS
+  #define JITTER_MAX_MS    8000       // web streams (I2S): max. target depth of the jitter buffer (PSRAM)
+#endif
+#ifndef AUDIO_READ_WAIT_MS
+  #define AUDIO_READ_WAIT_MS  20      // web streams (I2S): max. wait for the socket while there is nothing to decode
+#endif
+#ifndef AUDIO_STALL_MS
+  #define AUDIO_STALL_MS   6000       // web streams (I2S): no data for this long -> stream lost, reconnect
+#endif
+#ifndef AUDIO_XFADE_MS
+  #define AUDIO_XFADE_MS    0         // I2S: equal power crossfade on station changes and SD track ends, 500...5000 ms
+#endif                                // 0 - hard cut (also Audio::setCrossfade(), needs PSRAM and the output task)
+#ifndef AUDIO_XFADE_MEM
+  #define AUDIO_XFADE_MEM    131072   // I2S: bytes of PSRAM for the stream data of the fading station or track
+#endif                                // (mp3, aac, flac), caps the overlap, ~8 s at 128 kbit/s
+#ifndef AUDIO_DIRECT_RECV
+  #define AUDIO_DIRECT_RECV  true    // web streams (I2S): http stream data read from the socket straight into the input buffer
+#endif
+#ifndef HLS_PIPELINE
+  #define HLS_PIPELINE    true        // m3u8 (I2S): next segment / playlist reload requested while the current segment is read
+#endif
+#ifndef STREAM_CACHE
+  #define STREAM_CACHE    true        // web mode: resolved stream, codec and sample rate of the stations in SPIFFS (see core/streamcache.h)
+#endif
+#ifndef STREAM_CACHE_SIZE
+  #define STREAM_CACHE_SIZE    200    // entries with PSRAM (~280 bytes each), 16 without
+#endif
+#ifndef DNS_CACHE
+  #define DNS_CACHE    true           // web mode: addresses of the station hosts, refreshed in the background (see core/dnscache.h)
+#endif
+#ifndef DNS_CACHE_SIZE
+  #define DNS_CACHE_SIZE    32        // hosts with PSRAM (~110 bytes each), 8 without
+#endif
+#ifndef DNS_CACHE_TTL
+  #define DNS_CACHE_TTL    600        // seconds an address is used without a new lookup
+#endif
+#ifndef DNS_CACHE_SLOW_MS
+  #define DNS_CACHE_SLOW_MS    300    // max. wait for the lookup of an expired host, then the old address is used
+#endif
+#ifndef DNS_CACHE_AHEAD
+  #define DNS_CACHE_AHEAD    4        // hosts of the next playlist entries resolved in the background
+#endif
+#ifndef DNS_CACHE_PERSIST
+  #define DNS_CACHE_PERSIST    true   // keep the addresses in SPIFFS over restarts
+#endif
+#ifndef MIRROR_RACE
+  #define MIRROR_RACE    3            // web mode: mirrors of a station connected in parallel, 1 - one by one (failover only)
+#endif
+#ifndef TLS_SESSION_CACHE
+  #define TLS_SESSION_CACHE    4      // https hosts with a TLS session kept for the resumed handshake (see core/tlssession.h), 0 - off
+#endif
+#ifndef ZAP_PREFETCH
+  #define ZAP_PREFETCH    true        // web mode: keep the previous and next station resolved and connected (see core/prefetch.h)
+#endif
+#ifndef ZAP_PREFETCH_BUDGET
+  #define ZAP_PREFETCH_BUDGET    98304  // bytes of PSRAM for the stream data read ahead on the warm connections, 0 - socket only
+#endif                                // (without PSRAM the data waits in the TCP window of the socket)
+#ifndef ZAP_PREFETCH_IDLE_MS
+  #define ZAP_PREFETCH_IDLE_MS    20000 // a warm connection not taken within this time is closed, reopened on the next zap or playlist move
+#endif
+#ifndef PREFETCH_TASK_CORE_ID
+  #define PREFETCH_TASK_CORE_ID    0
+#endif
 #ifndef CONNECTION_TIMEOUT
   #define CONNECTION_TIMEOUT    5700
 #endif
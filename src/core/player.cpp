@@ -7,6 +7,10 @@
 #include "netserver.h"
 #include "timekeeper.h"
 #include "ModbusHandler.h"
+#include "network.h"
+#include "prefetch.h"
+#include "dnscache.h"
+#include "connector.h"
 
 char Player::myStationName[Player::MYBUF_LEN];//50
 
@@ -68,11 +72,22 @@ void Player::init() {
   #endif
   _loadVol(config.store.volume);
   setConnectionTimeout(CONNECTION_TIMEOUT, CONNECTION_TIMEOUT_SSL);
+  #if (I2S_DOUT!=255 || I2S_INTERNAL) && AUDIO_RING_FRAMES > 0
+    if(startOutputTask()) xTaskCreatePinnedToCore(loopPlayerTask, "PlayerTask", PLAYER_TASK_SIZE, NULL, PLAYER_TASK_PRIORITY, &_taskHandle, PLAYER_TASK_CORE_ID);
+  #endif
   Serial.println("done");
 }
 
+void Player::loopPlayerTask(void *pvParameters) {
+  while(true){
+    if (network.status == CONNECTED || network.status==SDREADY) player.loop();
+    else vTaskDelay(10);
+  }
+}
+
 void Player::sendCommand(playerRequestParams_t request){
   if(playerQueue==NULL) return;
+  if(request.type==PR_PLAY || request.type==PR_STOP) connector.cancel(); /* the player task may wait for a connect */
   xQueueSend(playerQueue, &request, PLQ_SEND_DELAY);
 }
 
@@ -143,11 +158,14 @@ void resetPlayer(){
 
 void Player::loop() {
   if(playerQueue==NULL) return;
+  if(_taskHandle && xTaskGetCurrentTaskHandle()!=_taskHandle) { vTaskDelay(2); return; } /* runs in PlayerTask */
   playerRequestParams_t requestP;
   if(xQueueReceive(playerQueue, &requestP, isRunning()?PL_QUEUE_TICKS:PL_QUEUE_TICKS_ST)){
     switch (requestP.type){
       case PR_STOP: _stop(); break;
       case PR_PLAY: {
+        playerRequestParams_t nextP;
+        if (xQueuePeek(playerQueue, &nextP, 0) && (nextP.type==PR_PLAY || nextP.type==PR_STOP)) break; /* zapping: the last one is played */
         if (requestP.payload>0) {
           config.setLastStation((uint16_t)requestP.payload);
         } 
@@ -234,12 +252,23 @@ void Player::_play(uint16_t stationId) {
     config.saveValue(&config.store.play_mode, static_cast<uint8_t>(PM_WEB));
   }
   connproc = false;
-  if(config.getMode()==PM_WEB) isConnected=connecttohost(config.station.url);
+  #if I2S_DOUT!=255 || I2S_INTERNAL
+    zapStart(config.getMode()==PM_WEB);
+    if(config.getMode()==PM_WEB) isConnected=connecttoMirrors(config.station.url, config.station.mirrors);
+  #else
+    if(config.getMode()==PM_WEB) isConnected=connecttohost(config.station.url);
+  #endif
   connproc = true;
   if(isConnected){
     _status = PLAYING;
     config.configPostPlaying(stationId);
     setOutputPins(true);
+    #if ZAP_PREFETCH
+      if(config.getMode()==PM_WEB) prefetch.neighbours(stationId);
+    #endif
+    #if DNS_CACHE
+      if(config.getMode()==PM_WEB) dnsCache.ahead(stationId);
+    #endif
 
     // --- КОД ДЛЯ КОПИРОВАНИЯ ИМЕНИ СТАНЦИИ ---
 //     strncpy(myStationName, config.station.name, MYBUF_LEN - 1);//Копируем имя станции
@@ -251,10 +280,18 @@ void Player::_play(uint16_t stationId) {
 
     if (player_on_start_play) player_on_start_play();
     pm.on_start_play();
+  }else if(config.getMode()==PM_WEB && connectCancelled())
+  { /* left for the next request (a new station, stop), it is in the queue */
+    #if I2S_DOUT!=255 || I2S_INTERNAL
+      zapStart(false);
+    #endif
   }else
   {
     telnet.printf("##ERROR#:\tError connecting to %.128s\n", config.station.url);
     snprintf(config.tmpBuf, sizeof(config.tmpBuf), "Error connecting to %.128s", config.station.url); setError();
+    #if I2S_DOUT!=255 || I2S_INTERNAL
+      zapStart(false);
+    #endif
     _stop(true);
   };
 }
@@ -276,6 +313,8 @@ void Player::browseUrl(){
     display.putRequest(PSTART);
     if (player_on_start_play) player_on_start_play();
     pm.on_start_play();
+  }else if(connectCancelled()){
+    /* left for the next request, it is in the queue */
   }else{
     telnet.printf("##ERROR#:\tError connecting to %.128s\n", burl);
     snprintf(config.tmpBuf, sizeof(config.tmpBuf), "Error connecting to %.128s", burl); setError();
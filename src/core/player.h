@@ -43,6 +43,8 @@ class Player: public Audio {
     void _play(uint16_t stationId);
     void _loadVol(uint8_t volume);
     bool _hasError;
+    TaskHandle_t _taskHandle = NULL;  /* decoder task, I2S output runs in its own task */
+    static void loopPlayerTask(void *pvParameters);
   public:
     bool lockOutput = true;
     bool resumeAfterUrl = false;
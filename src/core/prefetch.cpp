@@ -0,0 +1,294 @@
+#include "prefetch.h"
+#include "config.h"
+#include "player.h"
+#include "network.h"
+#include "telnet.h"
+
+#define PF_TASK_SIZE        1024 * 4
+#define PF_TASK_PRIORITY    1
+#define PF_TICK_MS          50
+#define PF_RETRY_MS         5000
+#define PF_CONNECT_TIMEOUT  3000
+
+Prefetch prefetch;
+
+/* PrefetchClient: the buffered response first, then the socket */
+
+int PrefetchClient::available() {
+  return (_wr - _rd) + WiFiClient::available();
+}
+
+int PrefetchClient::read() {
+  if (_rd < _wr) return _buf[_rd++];
+  return WiFiClient::read();
+}
+
+int PrefetchClient::read(uint8_t *buf, size_t size) {
+  size_t n = _wr - _rd;
+  if (n == 0) return WiFiClient::read(buf, size);
+  if (n > size) n = size;
+  memcpy(buf, _buf + _rd, n);
+  _rd += n;
+  return n;
+}
+
+int PrefetchClient::peek() {
+  if (_rd < _wr) return _buf[_rd];
+  return WiFiClient::peek();
+}
+
+uint8_t PrefetchClient::connected() {
+  return _rd < _wr || WiFiClient::connected();
+}
+
+void PrefetchClient::stop() {
+  WiFiClient::stop();
+  _rd = _wr = 0;
+  _inUse = false;
+}
+
+size_t PrefetchClient::fill() {
+  if (!_buf || _wr >= _size) return 0;
+  int a = WiFiClient::available();
+  if (a <= 0) return 0;
+  int n = WiFiClient::read(_buf + _wr, min((size_t)a, _size - _wr));
+  if (n <= 0) return 0;
+  _wr += n;
+  return n;
+}
+
+/* the url is split and the request is built as in Audio::connecttohost(), without authorization */
+
+static bool pf_normalize(const char *url, char *out, size_t len) {
+  const char *h = strstr(url, "http");
+  if (h) return strlcpy(out, h, len) < len;
+  return snprintf(out, len, "http://%s", url) < (int)len;
+}
+
+static char *pf_request(const char *path, const char *host) {
+  size_t len = strlen(path) * 3 + strlen(host) + 160;
+  char *rqh = (char *)malloc(len);
+  if (!rqh) return NULL;
+  char *p = rqh + sprintf(rqh, "GET ");
+  for (; *path; path++) {                                   /* spaces only, as urlencode(.., true) */
+    if (*path == ' ') { memcpy(p, "%20", 3); p += 3; }
+    else *p++ = *path;
+  }
+  sprintf(p, " HTTP/1.1\r\nHost: %s\r\nIcy-MetaData:1\r\nAccept-Encoding: identity;q=1,*;q=0\r\n"
+             "User-Agent: Mozilla/5.0\r\nConnection: keep-alive\r\n\r\n", host);
+  return rqh;
+}
+
+void Prefetch::_assign(pfSlot_t &s, const char *url) {
+  s.gen = ++_gen;
+  strlcpy(s.url, url, PF_URL_LEN);
+  s.ssl = strncmp(s.url, "https", 5) == 0;
+  const char *h = s.url + (s.ssl ? 8 : 7);
+  const char *slash = strchr(h, '/');
+  size_t hlen = slash && slash - h > 1 ? slash - h : strlen(h);
+  if (hlen >= PF_HOST_LEN) hlen = PF_HOST_LEN - 1;
+  memcpy(s.host, h, hlen);
+  s.host[hlen] = '\0';
+  s.port = 80;
+  const char *colon = strchr(h, ':');
+  const char *amp = strchr(h, '&');
+  bool warm = !s.ssl;
+  if (colon && !isalpha(colon[1]) && (!amp || amp > colon)) {
+    if (colon - h < (int)hlen) s.host[colon - h] = '\0';
+    else warm = false;                                    /* ':' in the path, resolve only */
+    s.port = atoi(colon + 1);
+  }
+  if (s.ssl && s.port == 80) s.port = 443;
+  s.request = warm ? pf_request(slash && slash - h > 1 ? slash : "/", s.host) : NULL;
+  s.state = PF_RESOLVE;
+  s.retry = millis();
+}
+
+void Prefetch::_release(pfSlot_t &s) {
+  s.client.stop();
+  if (s.request) { free(s.request); s.request = NULL; }
+  s.url[0] = '\0';
+  s.gen = ++_gen;
+  s.state = PF_FREE;
+}
+
+bool Prefetch::_begin() {
+  if (_mutex) return true;
+  _mutex = xSemaphoreCreateMutex();
+  if (!_mutex) return false;
+  for (uint8_t i = 0; i < PF_SLOTS; i++) {
+    _slots[i].state = PF_FREE;
+    _slots[i].request = NULL;
+    if (ZAP_PREFETCH_BUDGET > 0 && psramInit()) {
+      _slots[i].client._buf = (uint8_t *)ps_malloc(ZAP_PREFETCH_BUDGET / PF_SLOTS);
+      if (_slots[i].client._buf) _slots[i].client._size = ZAP_PREFETCH_BUDGET / PF_SLOTS;
+    }
+  }
+  xTaskCreatePinnedToCore(_task, "PrefetchTask", PF_TASK_SIZE, this, PF_TASK_PRIORITY, &_taskHandle, PREFETCH_TASK_CORE_ID);
+  return true;
+}
+
+void Prefetch::neighbours(uint16_t station) {
+  uint16_t len = config.playlistLength();
+  if (config.getMode() != PM_WEB || len < 2) {
+    update(NULL, NULL);
+    return;
+  }
+  uint16_t p = station <= 1 ? len : station - 1;
+  uint16_t n = station >= len ? 1 : station + 1;
+  char prevUrl[BUFLEN], nextUrl[BUFLEN];
+  bool hp = config.stationUrlByNum(p, prevUrl, BUFLEN);
+  bool hn = n != p && config.stationUrlByNum(n, nextUrl, BUFLEN);
+  update(hp ? prevUrl : NULL, hn ? nextUrl : NULL);
+}
+
+void Prefetch::update(const char *prevUrl, const char *nextUrl) {
+  if (!_begin()) return;
+  char want[2][PF_URL_LEN];
+  bool need[2] = { prevUrl && pf_normalize(prevUrl, want[0], PF_URL_LEN), nextUrl && pf_normalize(nextUrl, want[1], PF_URL_LEN) };
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < PF_SLOTS; i++) {
+    pfSlot_t &s = _slots[i];
+    if (s.state == PF_FREE) continue;
+    if (s.state == PF_TAKEN) {                            /* the player's connection stays until Audio stops it */
+      if (!s.client._inUse) _release(s);
+      continue;
+    }
+    bool keep = false;
+    for (uint8_t w = 0; w < 2; w++) {
+      if (need[w] && strcmp(s.url, want[w]) == 0) { need[w] = false; keep = true; }
+    }
+    if (!keep) _release(s);
+    else if (s.state == PF_IDLE) { s.state = PF_RESOLVE; s.retry = millis(); }  /* a zap wakes it */
+  }
+  for (uint8_t w = 0; w < 2; w++) {
+    if (!need[w]) continue;
+    for (uint8_t i = 0; i < PF_SLOTS; i++) {
+      if (_slots[i].state != PF_FREE) continue;
+      _assign(_slots[i], want[w]);
+      break;
+    }
+  }
+  xSemaphoreGive(_mutex);
+}
+
+void Prefetch::wake() {
+  if (!_mutex) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < PF_SLOTS; i++) {
+    pfSlot_t &s = _slots[i];
+    if (s.state != PF_IDLE) continue;
+    s.state = PF_RESOLVE;
+    s.retry = millis();
+  }
+  xSemaphoreGive(_mutex);
+}
+
+WiFiClient *Prefetch::take(const char *url, const char *request) {
+  if (!_mutex) return NULL;
+  WiFiClient *c = NULL;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < PF_SLOTS; i++) {
+    pfSlot_t &s = _slots[i];
+    if (s.state != PF_WARM || strcmp(s.url, url) != 0) continue;
+    if (s.request && strcmp(s.request, request) == 0 && s.client.connected()) {
+      s.client._inUse = true;
+      s.state = PF_TAKEN;
+      c = &s.client;
+    }
+    break;
+  }
+  xSemaphoreGive(_mutex);
+  return c;
+}
+
+void Prefetch::_work(uint8_t i) {
+  pfSlot_t &s = _slots[i];
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  uint32_t gen = s.gen;
+  bool wait = (int32_t)(millis() - s.retry) < 0;
+  switch (s.state) {
+    case PF_TAKEN: {
+      if (!s.client._inUse) _release(s);                  /* Audio has stopped it */
+      break;
+    }
+    case PF_WARM: {
+      bool closed = !s.client.buffered() && !s.client.WiFiClient::connected();
+      if (!closed && millis() - s.since > ZAP_PREFETCH_IDLE_MS) {
+        s.client.stop();                                  /* not taken, no reconnect until wake() or the next zap */
+        s.state = PF_IDLE;
+      } else if (closed || network.status != CONNECTED) {
+        s.client.stop();                                  /* the next connect resolves again */
+        s.state = PF_RESOLVE;
+        s.retry = millis() + (closed ? PF_RETRY_MS : 0);
+      } else {
+        s.client.fill();
+      }
+      break;
+    }
+    case PF_RESOLVE: {
+      if (wait || network.status != CONNECTED) break;
+      char host[PF_HOST_LEN];
+      strlcpy(host, s.host, PF_HOST_LEN);
+      xSemaphoreGive(_mutex);
+      IPAddress ip;
+      bool ok = WiFi.hostByName(host, ip) == 1;           /* also fills the lwIP DNS table for connecttohost() */
+      xSemaphoreTake(_mutex, portMAX_DELAY);
+      if (s.gen != gen || s.state != PF_RESOLVE) break;
+      if (ok) {
+        s.ip = ip;
+        s.state = PF_RESOLVED;
+      } else {
+        s.retry = millis() + PF_RETRY_MS;
+      }
+      break;
+    }
+    case PF_RESOLVED: {
+      /* https is resolved only, warm connections are opened while the player is playing */
+      if (wait || s.ssl || !s.request || player.status() != PLAYING || network.status != CONNECTED) break;
+      IPAddress ip = s.ip;
+      uint16_t port = s.port;
+      char *request = strdup(s.request);
+      if (!request) break;
+      xSemaphoreGive(_mutex);
+      WiFiClient c;
+      bool ok = c.connect(ip, port, PF_CONNECT_TIMEOUT) && c.print(request) == strlen(request);
+      free(request);
+      xSemaphoreTake(_mutex, portMAX_DELAY);
+      if (ok && s.gen == gen && s.state == PF_RESOLVED) {
+        static_cast<WiFiClient &>(s.client) = c;
+        s.client._rd = s.client._wr = 0;
+        s.state = PF_WARM;
+        s.since = millis();
+      } else {
+        c.stop();
+        if (s.gen == gen) s.retry = millis() + PF_RETRY_MS;
+      }
+      break;
+    }
+    default: break;
+  }
+  xSemaphoreGive(_mutex);
+}
+
+void Prefetch::_task(void *pvParameters) {
+  Prefetch *self = static_cast<Prefetch *>(pvParameters);
+  while (true) {
+    for (uint8_t i = 0; i < PF_SLOTS; i++) self->_work(i);
+    vTaskDelay(pdMS_TO_TICKS(PF_TICK_MS));
+  }
+}
+
+void Prefetch::printStatus(uint8_t id) {
+  static const char *states[] = { "free", "resolving", "resolved", "warm", "taken", "idle" };
+  if (!_mutex) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < PF_SLOTS; i++) {
+    pfSlot_t &s = _slots[i];
+    if (s.state == PF_FREE) continue;
+    telnet.printf(id, "prefetch:\t%s:%u %s %s", s.host, s.port, s.state >= PF_RESOLVED ? s.ip.toString().c_str() : "-", states[s.state]);
+    if (s.state == PF_WARM) telnet.printf(id, ", %u bytes, %u s", s.client.buffered(), (millis() - s.since) / 1000);
+    telnet.printf(id, "\n");
+  }
+  xSemaphoreGive(_mutex);
+}
@@ -0,0 +1,77 @@
+#ifndef prefetch_h
+#define prefetch_h
+#include "Arduino.h"
+#include <WiFi.h>
+#include "options.h"
+
+/*
+ * Warm connections to the neighbours of the playing station (config.lastStation() +-1, web mode).
+ * The prefetch task resolves the hosts (this also fills the lwIP DNS table), opens a http connection,
+ * sends the same request as Audio::connecttohost() and reads the response (header and stream data) into a
+ * PSRAM buffer until it is full, then the TCP window stops the server. connecttohost() takes the connection
+ * over and parses the header from the buffer. https stations are resolved only (a TLS client per station
+ * costs ~40kB of heap).
+ * A warm connection that is not taken within ZAP_PREFETCH_IDLE_MS is closed and the slot waits (PF_IDLE) until the
+ * user zaps or moves in the playlist, so a radio left on one station does not reconnect to its neighbours forever.
+ */
+
+#define PF_SLOTS        3     // previous, next and the one the player has taken
+#define PF_URL_LEN      256
+#define PF_HOST_LEN     128
+
+enum pfState_e : uint8_t { PF_FREE = 0, PF_RESOLVE = 1, PF_RESOLVED = 2, PF_WARM = 3, PF_TAKEN = 4, PF_IDLE = 5 };
+
+class PrefetchClient: public WiFiClient {
+  public:
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    uint8_t connected() override;
+    void stop() override;                          /* closes the socket, drops the buffer and gives the slot back */
+    size_t fill();                                 /* socket -> buffer, returns the bytes read */
+    size_t buffered() { return _wr - _rd; }
+  private:
+    friend class Prefetch;
+    uint8_t *_buf = NULL;
+    size_t _size = 0, _rd = 0, _wr = 0;
+    volatile bool _inUse = false;
+};
+
+struct pfSlot_t {
+  pfState_e state;
+  bool ssl;
+  uint16_t port;
+  uint32_t gen;                                    /* changes with the url, a result of the task for an old url is dropped */
+  uint32_t since;                                  /* millis() of the connect */
+  uint32_t retry;                                  /* millis() of the next attempt after a failure */
+  IPAddress ip;
+  char url[PF_URL_LEN];                            /* as Audio::connecttohost() sees it, with http:// */
+  char host[PF_HOST_LEN];                          /* without port and path */
+  char *request;                                   /* http request sent on the warm connection */
+  PrefetchClient client;
+};
+
+class Prefetch {
+  public:
+    Prefetch() {};
+    void neighbours(uint16_t station);             /* player task, after a station has started */
+    void update(const char *prevUrl, const char *nextUrl);
+    void wake();                                   /* user action (playlist move): idle slots connect again */
+    WiFiClient *take(const char *url, const char *request); /* NULL: no warm connection for this request */
+    void printStatus(uint8_t id);
+  private:
+    pfSlot_t _slots[PF_SLOTS];
+    SemaphoreHandle_t _mutex = NULL;
+    TaskHandle_t _taskHandle = NULL;
+    uint32_t _gen = 0;
+    bool _begin();
+    void _assign(pfSlot_t &s, const char *url);
+    void _release(pfSlot_t &s);
+    void _work(uint8_t i);
+    static void _task(void *pvParameters);
+};
+
+extern Prefetch prefetch;
+
+#endif
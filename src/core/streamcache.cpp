@@ -0,0 +1,142 @@
+#include "streamcache.h"
+#include <SPIFFS.h>
+#include "telnet.h"
+
+StreamCache streamCache;
+
+/* file: magic, then per entry key, sampleRate, metaint (LE 32 bit), codec, channels, url length (8 bit), url */
+
+uint32_t StreamCache::_key(const char *station) {
+  uint32_t h = 2166136261u;                        /* FNV-1a */
+  for (; *station; station++) h = (h ^ (uint8_t)*station) * 16777619u;
+  return h ? h : 1;
+}
+
+bool StreamCache::_begin() {
+  if (_mutex) return _recs != NULL;
+  _mutex = xSemaphoreCreateMutex();
+  if (!_mutex) return false;
+  _size = psramInit() ? STREAM_CACHE_SIZE : 16;
+  _recs = (scRecord_t *)(psramInit() ? ps_calloc(_size, sizeof(scRecord_t)) : calloc(_size, sizeof(scRecord_t)));
+  if (!_recs) return false;
+  _load();
+  return true;
+}
+
+void StreamCache::_load() {
+  File f = SPIFFS.open(SC_PATH, "r");
+  if (!f) return;
+  uint32_t magic = 0;
+  if (f.read((uint8_t *)&magic, 4) != 4 || magic != SC_MAGIC) { f.close(); return; }
+  uint8_t hdr[15];
+  for (uint16_t i = 0; i < _size && f.read(hdr, sizeof(hdr)) == sizeof(hdr); i++) {
+    scRecord_t &r = _recs[i];
+    memcpy(&r.key, hdr, 4);
+    memcpy(&r.info.sampleRate, hdr + 4, 4);
+    memcpy(&r.info.metaint, hdr + 8, 4);
+    r.info.codec = hdr[12];
+    r.info.channels = hdr[13];
+    uint8_t len = hdr[14];
+    if (f.read((uint8_t *)r.info.url, len) != len) { r.key = 0; break; }  /* cut off, the entries before are good */
+    r.info.url[len] = '\0';
+    r.used = 0;
+  }
+  f.close();
+}
+
+scRecord_t *StreamCache::_find(uint32_t key) {
+  for (uint16_t i = 0; i < _size; i++) if (_recs[i].key == key) return &_recs[i];
+  return NULL;
+}
+
+bool StreamCache::lookup(const char *station, streamInfo_t *info) {
+  if (!_begin()) return false;
+  uint32_t key = _key(station);
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  scRecord_t *r = _find(key);
+  if (r) {
+    r->used = ++_tick;
+    *info = r->info;
+    _hits++;
+  } else {
+    _misses++;
+  }
+  xSemaphoreGive(_mutex);
+  return r != NULL;
+}
+
+void StreamCache::store(const char *station, const streamInfo_t &info) {
+  if (!_begin() || strlen(info.url) >= SC_URL_LEN) return;
+  uint32_t key = _key(station);
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  scRecord_t *r = _find(key);
+  if (!r) {
+    r = &_recs[0];                                 /* a free one, or the one not used for the longest time */
+    for (uint16_t i = 0; i < _size && r->key; i++) if (!_recs[i].key || _recs[i].used < r->used) r = &_recs[i];
+    r->key = key;
+    memset(&r->info, 0, sizeof(streamInfo_t));
+  }
+  r->used = ++_tick;
+  if (strcmp(r->info.url, info.url) || r->info.sampleRate != info.sampleRate || r->info.metaint != info.metaint ||
+      r->info.codec != info.codec || r->info.channels != info.channels) {
+    r->info = info;
+    _dirty = true;
+  }
+  xSemaphoreGive(_mutex);
+}
+
+void StreamCache::invalidate(const char *station) {
+  if (!_begin()) return;
+  uint32_t key = _key(station);
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  scRecord_t *r = _find(key);
+  if (r) {
+    r->key = 0;
+    _dirty = true;
+  }
+  xSemaphoreGive(_mutex);
+}
+
+void StreamCache::flush() {
+  if (!_dirty || !_mutex) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  size_t len = 4;
+  for (uint16_t i = 0; i < _size; i++) if (_recs[i].key) len += 15 + strlen(_recs[i].info.url);
+  uint8_t *buf = (uint8_t *)(psramInit() ? ps_malloc(len) : malloc(len));
+  if (!buf) { xSemaphoreGive(_mutex); return; }
+  uint32_t magic = SC_MAGIC;
+  memcpy(buf, &magic, 4);
+  uint8_t *p = buf + 4;
+  for (uint16_t i = 0; i < _size; i++) {
+    scRecord_t &r = _recs[i];
+    if (!r.key) continue;
+    uint8_t ul = strlen(r.info.url);
+    memcpy(p, &r.key, 4);
+    memcpy(p + 4, &r.info.sampleRate, 4);
+    memcpy(p + 8, &r.info.metaint, 4);
+    p[12] = r.info.codec;
+    p[13] = r.info.channels;
+    p[14] = ul;
+    memcpy(p + 15, r.info.url, ul);
+    p += 15 + ul;
+  }
+  _dirty = false;
+  xSemaphoreGive(_mutex);                          /* the player is not blocked by the write */
+  File f = SPIFFS.open(SC_PATH, "w");
+  if (f) {
+    if (f.write(buf, len) != len) _dirty = true;
+    f.close();
+  } else {
+    _dirty = true;
+  }
+  free(buf);
+}
+
+void StreamCache::printStatus(uint8_t id) {
+  if (!_mutex || !_recs) return;
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < _size; i++) if (_recs[i].key) n++;
+  telnet.printf(id, "stream cache:\t%u/%u entries, %u hits, %u misses\n", n, _size, _hits, _misses);
+  xSemaphoreGive(_mutex);
+}
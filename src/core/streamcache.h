@@ -0,0 +1,55 @@
+#ifndef streamcache_h
+#define streamcache_h
+#include "Arduino.h"
+#include "options.h"
+
+/*
+ * Resolved streams of the stations, kept in SPIFFS (SC_PATH) over restarts.
+ * Key: hash of the station url. Value: the stream behind playlists (.pls/.m3u/.asx) and http redirects, codec,
+ * sample rate, channels and icy-metaint of the last start that decoded audio. Audio::connecttohost() connects
+ * straight to the cached stream and sets up the decoder while the server answers, a failure drops the entry and
+ * the station is resolved again. The file is written by flush() (display task, every 5 s), not in the player task.
+ */
+
+#define SC_PATH         "/data/streams.dat"
+#define SC_URL_LEN      256
+#define SC_MAGIC        0x31435353      /* "SSC1" */
+
+struct streamInfo_t {
+  char url[SC_URL_LEN];                            /* final stream, "": the station url itself */
+  uint32_t sampleRate;
+  uint32_t metaint;
+  uint8_t codec;                                   /* Audio CODEC_... */
+  uint8_t channels;
+};
+
+struct scRecord_t {
+  uint32_t key;                                    /* 0: free */
+  uint32_t used;                                   /* last lookup or store, for the replacement */
+  streamInfo_t info;
+};
+
+class StreamCache {
+  public:
+    StreamCache() {};
+    bool lookup(const char *station, streamInfo_t *info);
+    void store(const char *station, const streamInfo_t &info);
+    void invalidate(const char *station);
+    void flush();                                  /* writes the file if an entry has changed, TimeKeeper::loop0() */
+    void printStatus(uint8_t id);
+  private:
+    scRecord_t *_recs = NULL;
+    uint16_t _size = 0;
+    uint32_t _tick = 0;
+    uint32_t _hits = 0, _misses = 0;
+    bool _dirty = false;
+    SemaphoreHandle_t _mutex = NULL;
+    bool _begin();
+    void _load();
+    scRecord_t *_find(uint32_t key);
+    static uint32_t _key(const char *station);
+};
+
+extern StreamCache streamCache;
+
+#endif
@@ -7,6 +7,11 @@
 #include "telnet.h"
 #include "esp_heap_caps.h"
 #include "ModbusHandler.h"
+#include "prefetch.h"
+#include "streamcache.h"
+#include "dnscache.h"
+#include "tlssession.h"
+#include "connector.h"
 
 Telnet telnet;
 
@@ -404,6 +409,128 @@ void Telnet::printHeapFragmentationInfo(uint8_t id){
   printf(id, "* Fragmentation: %.2f%%\n", fragmentation);
   printf(id, "*************************************\n\n");
 }
+void Telnet::printAudioStats(uint8_t id){
+#if I2S_DOUT!=255 || I2S_INTERNAL
+  const audioStats_t& st = player.getStats();
+  uint32_t frames = st.frames ? st.frames : 1;
+  printf(id, "##AUDIO.STAT#\n");
+  printf(id, "frames:\t\t%u\n", st.frames);
+  printf(id, "i2s writes:\t%u (%u frames/write)\n", st.i2sWrites, st.i2sWrites ? st.frames / st.i2sWrites : 0);
+  if(st.i2sRetries || st.i2sDropped) printf(id, "i2s retries:\t%u blocks, %u frames dropped\n", st.i2sRetries, st.i2sDropped);
+  printf(id, "dsp cycles:\t%u per frame\n", (uint32_t)(st.dspCycles / frames));
+  printf(id, "i2s cycles:\t%u per frame\n", (uint32_t)(st.i2sCycles / frames));
+  if(st.decodeFrames && st.decodeSamples && player.getSampleRate()){
+    uint32_t mhz = getCpuFrequencyMhz();
+    uint64_t audioUs = (uint64_t)st.decodeSamples * 1000000 / player.getSampleRate();
+    printf(id, "decode:\t\t%u us per frame (max %u us), %u%% of real time\n", (uint32_t)(st.decodeCycles / st.decodeFrames / mhz),
+           st.decodeMaxCycles / mhz, audioUs ? (uint32_t)(st.decodeCycles / mhz * 100 / audioUs) : 0);
+  }
+  if(player.getOutputRate() != player.getSampleRate()) printf(id, "resampler:\t%u -> %u Hz\n", player.getSampleRate(), player.getOutputRate());
+  if(player.hasOutputTask()){
+    uint32_t fill = player.ringFilled(), size = player.ringSize();
+    printf(id, "pcm ring:\t%u/%u frames (%u%%)\n", fill, size, size ? fill * 100 / size : 0);
+    printf(id, "underruns:\t%u\n", st.underruns);
+  }
+  if(st.spectrumUpdates){
+    uint32_t cyc = (uint32_t)(st.spectrumCycles / st.spectrumUpdates);
+    printf(id, "spectrum:\t%u cycles (%u us) per update, %u updates\n", cyc, cyc / getCpuFrequencyMhz(), st.spectrumUpdates);
+  }
+  if(player.isRunning() && config.getMode()==PM_WEB){
+    const jitterBuf_t& jb = player.getJitterBuf();
+    printf(id, "jitter buf:\ttarget %u ms, buffered %u ms, jitter %u ms, %u underruns, %u kbit/s\n", jb.targetMs,
+           JB_FilledMs(&jb, player.inBufferFilled()), JB_JitterMs(&jb), jb.underruns, jb.throughput * 8 / 1000);
+  }
+  if(st.recvDirect || st.recvClient){
+    printf(id, "recv:\t\t%u kB direct (%u cycles/kB), %u kB through the client (%u cycles/kB)\n", st.recvDirect / 1024,
+           st.recvDirect ? (uint32_t)(st.recvDirectCycles * 1024 / st.recvDirect) : 0, st.recvClient / 1024,
+           st.recvClient ? (uint32_t)(st.recvClientCycles * 1024 / st.recvClient) : 0);
+  }
+  if(st.hlsSegments){
+    printf(id, "hls:\t\t%u segments, %u pipelined\n", st.hlsSegments, st.hlsPipelined);
+    if(st.hlsBandwidth) printf(id, "hls variant:\t%u kbit/s, throughput %u kbit/s, %u switches\n", st.hlsBandwidth / 1000,
+                               st.hlsThroughput / 1000, st.hlsSwitches);
+  }
+  if(st.mirrorRaces || st.mirrorFailovers){
+    printf(id, "mirrors:\t%u races (%u won by a mirror), %u failovers\n", st.mirrorRaces, st.mirrorRaceWins, st.mirrorFailovers);
+  }
+  if(st.zaps){
+    printf(id, "zap:\t\tlast %u ms (%s), avg %u ms, max %u ms, %u zaps (%u warm, %u cached)\n", st.zapMs, st.zapWarm ? "warm" : "cold",
+           (uint32_t)(st.zapSumMs / st.zaps), st.zapMaxMs, st.zaps, st.warmZaps, st.cachedZaps);
+    uint32_t resolved = st.zaps - st.cachedZaps;
+    printf(id, "first audio:	avg %u ms with the stream cache, %u ms resolved
+",
+           st.cachedZaps ? (uint32_t)(st.cachedZapSumMs / st.cachedZaps) : 0,
+           resolved ? (uint32_t)((st.zapSumMs - st.cachedZapSumMs) / resolved) : 0);
+  }
+  if(st.xfades){
+    printf(id, "crossfade:\t%u fades, last overlap %u ms, fading stream %u.%u%% CPU (max %u.%u%%)\n", st.xfades, st.xfadeMs,
+           st.xfadeLoad / 10, st.xfadeLoad % 10, st.xfadeMaxLoad / 10, st.xfadeMaxLoad % 10);
+  }
+  #if ZAP_PREFETCH
+    prefetch.printStatus(id);
+  #endif
+  #if STREAM_CACHE
+    streamCache.printStatus(id);
+  #endif
+  connector.printStatus(id);
+  tlsSessions.printStatus(id);
+  printf(id, "##AUDIO.STAT#\n> ");
+#else
+  printf(id, "##CMD_ERROR#\tnot supported by this output\n> ");
+#endif
+}
+void Telnet::printCpuUsage(uint8_t id){
+#if configUSE_TRACE_FACILITY
+  /* load of every task since the last call, % of one core; IDLE0/IDLE1 is the free time of the cores */
+  static uint32_t lastUs = 0;
+  static struct { TaskHandle_t handle; uint32_t runTime; } last[32];
+  static uint8_t lastCount = 0;
+  UBaseType_t count = uxTaskGetNumberOfTasks();
+  TaskStatus_t *tasks = (TaskStatus_t *)malloc(count * sizeof(TaskStatus_t));
+  if (!tasks) {
+    printf(id, "##CMD_ERROR#\tnot enough memory\n> ");
+    return;
+  }
+  count = uxTaskGetSystemState(tasks, count, NULL);
+  uint32_t now = micros();
+  uint32_t elapsed = lastUs ? now - lastUs : 0;
+  printf(id, "##SYS.CPU#\n");
+  printf(id, "%-16s core prio    cpu  stack\n", "task");
+  for (UBaseType_t i = 0; i < count; i++) {
+    TaskStatus_t &t = tasks[i];
+  #if configTASKLIST_INCLUDE_COREID
+    int core = t.xCoreID == tskNO_AFFINITY ? -1 : t.xCoreID;
+  #else
+    int core = -1;
+  #endif
+    printf(id, "%-16s %4d %4u ", t.pcTaskName, core, t.uxCurrentPriority);
+  #if configGENERATE_RUN_TIME_STATS
+    uint32_t prev = 0;
+    bool found = false;
+    for (uint8_t j = 0; j < lastCount; j++) if (last[j].handle == t.xHandle) { prev = last[j].runTime; found = true; break; }
+    uint32_t load = elapsed && found ? (uint32_t)((uint64_t)(t.ulRunTimeCounter - prev) * 1000 / elapsed) : 0;
+    if (elapsed && found) printf(id, "%3u.%u%%", load / 10, load % 10);
+    else printf(id, "%6s", "-");
+  #else
+    printf(id, "%6s", "-");
+  #endif
+    printf(id, " %6u\n", t.usStackHighWaterMark);
+  }
+  #if configGENERATE_RUN_TIME_STATS
+    lastCount = min((UBaseType_t)32, count);
+    for (uint8_t j = 0; j < lastCount; j++) { last[j].handle = tasks[j].xHandle; last[j].runTime = tasks[j].ulRunTimeCounter; }
+    lastUs = now;
+    if (!elapsed) printf(id, "first call, run \"cpu\" again for the load since now\n");
+  #else
+    (void)elapsed;
+    printf(id, "no run time stats in this build (CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)\n");
+  #endif
+  free(tasks);
+  printf(id, "##SYS.CPU#\n> ");
+#else
+  printf(id, "##CMD_ERROR#\tnot supported by this build\n> ");
+#endif
+}
 void Telnet::on_input(const char* str, uint8_t clientId) {
   char newName[170];
   if (strlen(str) == 0) return;
@@ -477,6 +604,18 @@ void Telnet::on_input(const char* str, uint8_t clientId) {
       printf(clientId, "new smartstart value is: %d\n> ", config.store.smartstart);
       return;
     }
+  #if I2S_DOUT!=255 || I2S_INTERNAL
+    if (strcmp(str, "cli.xfade") == 0 || strcmp(str, "xfade") == 0) {
+      printf(clientId, "##CLI.XFADE#: %u\n> ", player.getCrossfade());
+      return;
+    }
+    int xfade;
+    if (sscanf(str, "xfade(%d)", &xfade) == 1 || sscanf(str, "cli.xfade(\"%d\")", &xfade) == 1 || sscanf(str, "xfade %d", &xfade) == 1) {
+      player.setCrossfade(xfade > 0 ? static_cast<uint16_t>(min(xfade, 5000)) : 0);   // ms, 0: hard cut
+      printf(clientId, "new xfade value is: %u\n> ", player.getCrossfade());
+      return;
+    }
+  #endif
     if (strcmp(str, "cli.list") == 0 || strcmp(str, "list") == 0) {
       printf(clientId, "#CLI.LIST#\n");
       File file = SPIFFS.open(PLAYLIST_PATH, "r");
@@ -516,6 +655,9 @@ void Telnet::on_input(const char* str, uint8_t clientId) {
       } else {
         printf(clientId, "##CLI.STOPPED#\n");
       }
+      #if DNS_CACHE
+        dnsCache.printStatus(clientId);
+      #endif
       printf(clientId, "> ");
       return;
     }
@@ -691,6 +833,21 @@ void Telnet::on_input(const char* str, uint8_t clientId) {
     printHeapFragmentationInfo(clientId);
     return;
   }
+  if (strcmp(str, "sys.cpu") == 0 || strcmp(str, "cpu") == 0) {
+    printCpuUsage(clientId);
+    return;
+  }
+  if (strcmp(str, "sys.audio") == 0 || strcmp(str, "audiostat") == 0) {
+    printAudioStats(clientId);
+    return;
+  }
+  if (strcmp(str, "sys.audio.reset") == 0 || strcmp(str, "audiostat reset") == 0) {
+  #if I2S_DOUT!=255 || I2S_INTERNAL
+    player.resetStats();
+  #endif
+    printf(clientId, "audio statistics cleared\n> ");
+    return;
+  }
   if (strcmp(str, "sys.config") == 0 || strcmp(str, "config") == 0) {
     config.bootInfo();
     //printf(clientId, "Free heap:\t%d bytes\n> ", xPortGetFreeHeapSize());
@@ -30,6 +30,8 @@ class Telnet {
     bool _isIPSet(IPAddress ip);
     void handleSerial();
     void printHeapFragmentationInfo(uint8_t id);
+    void printAudioStats(uint8_t id);
+    void printCpuUsage(uint8_t id);
 };
 
 extern Telnet telnet;
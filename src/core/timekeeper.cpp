@@ -6,6 +6,8 @@
 #include "player.h"
 #include "netserver.h"
 #include "rtcsupport.h"
+#include "streamcache.h"
+#include "dnscache.h"
 #include <ModbusRTU.h>
 
 #if RTCSUPPORTED
@@ -110,6 +112,13 @@ ModbusRTU mb;
     if (currentTime - _last5s >= 5000) { // 5sec
         _last5s = currentTime;
         //HEAP_INFO();
+        // loop0() runs in the DspTask (display.cpp), the SPIFFS writes of the caches belong here and not to the player
+    #if STREAM_CACHE
+        streamCache.flush();
+    #endif
+    #if DNS_CACHE
+        dnsCache.flush();
+    #endif
     }
 
     return true; // just in case
@@ -0,0 +1,198 @@
+#include "tlssession.h"
+#include "lwip/sockets.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "dnscache.h"
+#include "connector.h"
+#include "telnet.h"
+
+#define TS_STEP_WAIT_MS     2
+
+TlsSessionCache tlsSessions;
+
+bool TlsSessionCache::_begin() {
+  if (_entries) return true;
+  _entries = (tsEntry_t *)calloc(TLS_SESSION_CACHE, sizeof(tsEntry_t));
+  if (!_entries) return false;
+  for (uint8_t i = 0; i < TLS_SESSION_CACHE; i++) mbedtls_ssl_session_init(&_entries[i].session);
+  return true;
+}
+
+tsEntry_t *TlsSessionCache::_find(const char *host, uint16_t port) {
+  for (uint8_t i = 0; i < TLS_SESSION_CACHE; i++) {
+    if (_entries[i].host[0] && _entries[i].port == port && strcmp(_entries[i].host, host) == 0) return &_entries[i];
+  }
+  return NULL;
+}
+
+bool TlsSessionCache::load(const char *host, uint16_t port, mbedtls_ssl_context *ssl) {
+  if (!_entries) return false;
+  tsEntry_t *e = _find(host, port);
+  if (!e) return false;
+  e->used = millis();
+  return mbedtls_ssl_set_session(ssl, &e->session) == 0;
+}
+
+void TlsSessionCache::save(const char *host, uint16_t port, const mbedtls_ssl_context *ssl) {
+  if (strlen(host) >= TS_HOST_LEN || !_begin()) return;
+  tsEntry_t *e = _find(host, port);
+  if (!e) {                                        /* a free one, or the one not used for the longest time */
+    e = &_entries[0];
+    for (uint8_t i = 0; i < TLS_SESSION_CACHE && e->host[0]; i++) if (!_entries[i].host[0] || _entries[i].used < e->used) e = &_entries[i];
+  }
+  mbedtls_ssl_session_free(&e->session);           /* a new ticket replaces the old one */
+  mbedtls_ssl_session_init(&e->session);
+  if (mbedtls_ssl_get_session(ssl, &e->session) != 0) {
+    mbedtls_ssl_session_free(&e->session);
+    mbedtls_ssl_session_init(&e->session);
+    e->host[0] = '\0';
+    return;
+  }
+  strlcpy(e->host, host, TS_HOST_LEN);
+  e->port = port;
+  e->used = millis();
+}
+
+void TlsSessionCache::drop(const char *host, uint16_t port) {
+  if (!_entries) return;
+  tsEntry_t *e = _find(host, port);
+  if (!e) return;
+  mbedtls_ssl_session_free(&e->session);
+  mbedtls_ssl_session_init(&e->session);
+  e->host[0] = '\0';
+}
+
+void TlsSessionCache::account(bool resumed, uint32_t ms, uint32_t heap) {
+  tsStats_t &s = resumed ? _resumed : _full;
+  s.count++;
+  s.sumMs += ms;
+  s.sumHeap += heap;
+  if (heap > s.peakHeap) s.peakHeap = heap;
+}
+
+void TlsSessionCache::printStatus(uint8_t id) {
+  if (!_full.count && !_resumed.count && !_failed) return;
+  uint8_t n = 0;
+  for (uint8_t i = 0; _entries && i < TLS_SESSION_CACHE; i++) if (_entries[i].host[0]) n++;
+  const tsStats_t &f = _full, &r = _resumed;
+  telnet.printf(id, "tls:\t\t%u full (avg %u ms, heap avg %u peak %u bytes), %u resumed (avg %u ms, heap avg %u peak %u bytes), "
+                "%u failed, %u/%u sessions\n", f.count, f.count ? f.sumMs / f.count : 0, f.count ? f.sumHeap / f.count : 0, f.peakHeap,
+                r.count, r.count ? r.sumMs / r.count : 0, r.count ? r.sumHeap / r.count : 0, r.peakHeap, _failed, n, TLS_SESSION_CACHE);
+}
+
+/* TlsClient: start_ssl_client() of ssl_client.cpp for setInsecure(), with the cached session */
+
+int TlsClient::connect(const char *host, uint16_t port, int32_t timeout) {
+  _timeout = timeout;
+  return connect(host, port);
+}
+
+int TlsClient::connect(const char *host, uint16_t port) {
+  if (!_use_insecure) return WiFiClientSecure::connect(host, port); /* certificates: the framework checks them */
+  if (sslclient->socket >= 0) stop();
+  IPAddress ip;
+#if DNS_CACHE
+  if (!dnsCache.resolve(host, ip)) return 0;
+#else
+  if (!WiFi.hostByName(host, ip)) return 0;
+#endif
+  int ret = _start(ip, port, host);
+  if (ret < 0) {
+    log_e("start_ssl_client: %d", ret);
+    _lastError = ret;
+    tlsSessions.failed();
+    stop();
+    return 0;
+  }
+  _connected = true;
+  return 1;
+}
+
+int TlsClient::_start(const IPAddress &ip, uint16_t port, const char *host) {
+  sslclient_context *c = sslclient;
+  ssl_init(c);
+  c->socket = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (c->socket < 0) return -1;
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = (uint32_t)ip;
+  sa.sin_port = htons(port);
+  fcntl(c->socket, F_SETFL, fcntl(c->socket, F_GETFL, 0) | O_NONBLOCK);
+  if (lwip_connect(c->socket, (struct sockaddr *)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) return -1;
+  fd_set fdset;
+  FD_ZERO(&fdset);
+  FD_SET(c->socket, &fdset);
+  struct timeval tv;
+  tv.tv_sec = _timeout / 1000;
+  tv.tv_usec = (_timeout % 1000) * 1000;
+  if (select(c->socket + 1, NULL, &fdset, NULL, _timeout < 0 ? NULL : &tv) <= 0) return -1;
+  int err = 0, enable = 1;
+  socklen_t len = sizeof(err);
+  if (lwip_getsockopt(c->socket, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err) return -1;
+  lwip_setsockopt(c->socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  lwip_setsockopt(c->socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  lwip_setsockopt(c->socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  lwip_setsockopt(c->socket, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+  return _handshake(host, port, c->handshake_timeout, 0);
+}
+
+int TlsClient::attach(int fd, const char *host, uint16_t port, uint32_t timeout, uint32_t gen) {
+  if (sslclient->socket >= 0) stop();
+  sslclient_context *c = sslclient;
+  ssl_init(c);
+  c->socket = fd;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  struct timeval tv;
+  tv.tv_sec = timeout / 1000;
+  tv.tv_usec = (timeout % 1000) * 1000;
+  lwip_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  lwip_setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  int ret = _handshake(host, port, timeout, gen);
+  if (ret < 0) {
+    log_e("TLS handshake with %s: %d", host, ret);
+    _lastError = ret;
+    if (!connector.cancelled(gen)) tlsSessions.failed();
+    stop();
+    return 0;
+  }
+  _connected = true;
+  return 1;
+}
+
+int TlsClient::_handshake(const char *host, uint16_t port, uint32_t timeout, uint32_t gen) {
+  sslclient_context *c = sslclient;
+  uint32_t t = millis(), heap = ESP.getFreeHeap(), low = heap;
+  mbedtls_entropy_init(&c->entropy_ctx);
+  if (mbedtls_ctr_drbg_seed(&c->drbg_ctx, mbedtls_entropy_func, &c->entropy_ctx, NULL, 0) != 0) return -1;
+  if (mbedtls_ssl_config_defaults(&c->ssl_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) != 0) return -1;
+  mbedtls_ssl_conf_authmode(&c->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+  mbedtls_ssl_conf_rng(&c->ssl_conf, mbedtls_ctr_drbg_random, &c->drbg_ctx);
+  if (mbedtls_ssl_setup(&c->ssl_ctx, &c->ssl_conf) != 0) return -1;
+  if (mbedtls_ssl_set_hostname(&c->ssl_ctx, host) != 0) return -1;
+  bool cached = TLS_SESSION_CACHE && tlsSessions.load(host, port, &c->ssl_ctx);
+  mbedtls_ssl_set_bio(&c->ssl_ctx, &c->socket, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+  /* mbedtls_ssl_handshake() step by step: a full handshake goes through SERVER_CERTIFICATE, a resumed one
+   * continues with SERVER_CHANGE_CIPHER_SPEC after the ServerHello */
+  bool full = false;
+  while (c->ssl_ctx.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+    if (c->ssl_ctx.state == MBEDTLS_SSL_SERVER_CERTIFICATE) full = true;
+    int ret = mbedtls_ssl_handshake_step(&c->ssl_ctx);
+    uint32_t h = ESP.getFreeHeap();
+    if (h < low) low = h;
+    if (ret == 0) continue;
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      if (cached) tlsSessions.drop(host, port);    /* the next attempt does a full handshake */
+      return ret;
+    }
+    if (millis() - t > timeout || connector.cancelled(gen)) return -1;
+    vTaskDelay(pdMS_TO_TICKS(TS_STEP_WAIT_MS));
+  }
+  tlsSessions.account(!full, millis() - t, heap - low);
+#if TLS_SESSION_CACHE
+  tlsSessions.save(host, port, &c->ssl_ctx);
+#endif
+  return c->socket;
+}
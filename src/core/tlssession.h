@@ -0,0 +1,64 @@
+#ifndef tlssession_h
+#define tlssession_h
+#include "Arduino.h"
+#include <WiFiClientSecure.h>
+#include "mbedtls/ssl.h"
+#include "options.h"
+
+/*
+ * TLS session resumption for the https streams of Audio (connecttohost() and the keep-alive reconnects of
+ * httpPrint()). TlsClient does the connect of WiFiClientSecure in insecure mode itself (as ssl_client.cpp of
+ * Arduino-ESP32 2.0.x does it) and sets the session of the last connection to the same host:port before the
+ * handshake, session ID or ticket, whatever the server has given. A resumed handshake has no certificate and no
+ * key exchange. attach() does the same on a socket of the connect task (core/connector.h). TLS_SESSION_CACHE
+ * sessions are kept in RAM, they are used by one connect at a time (Audio).
+ * Time and heap of the full and the resumed handshakes are counted for the telnet audio stats.
+ */
+
+#define TS_HOST_LEN     96
+
+struct tsEntry_t {
+  char host[TS_HOST_LEN];                          /* "": free */
+  uint16_t port;
+  uint32_t used;                                   /* millis() of the last connect, for the replacement */
+  mbedtls_ssl_session session;
+};
+
+struct tsStats_t {
+  uint32_t count;                                  /* handshakes */
+  uint32_t sumMs;                                  /* time of the handshakes, after the TCP connect */
+  uint32_t sumHeap, peakHeap;                      /* heap used during a handshake, with the TLS buffers */
+};
+
+class TlsSessionCache {
+  public:
+    TlsSessionCache() {};
+    bool load(const char *host, uint16_t port, mbedtls_ssl_context *ssl); /* true: the session is set */
+    void save(const char *host, uint16_t port, const mbedtls_ssl_context *ssl);
+    void drop(const char *host, uint16_t port);    /* the resumed handshake has failed */
+    void account(bool resumed, uint32_t ms, uint32_t heap);
+    void failed() { _failed++; }
+    const tsStats_t &stats(bool resumed) const { return resumed ? _resumed : _full; }
+    void printStatus(uint8_t id);
+  private:
+    tsEntry_t *_entries = NULL;
+    tsStats_t _full = {}, _resumed = {};
+    uint32_t _failed = 0;
+    bool _begin();
+    tsEntry_t *_find(const char *host, uint16_t port);
+};
+
+class TlsClient: public WiFiClientSecure {
+  public:
+    using WiFiClientSecure::connect;
+    int connect(const char *host, uint16_t port) override;
+    int connect(const char *host, uint16_t port, int32_t timeout) override;
+    int attach(int fd, const char *host, uint16_t port, uint32_t timeout, uint32_t gen); /* TLS on a connected socket (Connector) */
+  private:
+    int _start(const IPAddress &ip, uint16_t port, const char *host); /* socket or -1 */
+    int _handshake(const char *host, uint16_t port, uint32_t timeout, uint32_t gen); /* gen: connector.cancel() ends it */
+};
+
+extern TlsSessionCache tlsSessions;
+
+#endif
@@ -57,6 +57,11 @@ const BitrateConfig fullbitrateConf PROGMEM = {{DSP_WIDTH-TFT_FRAMEWDT-38, 59, 2
 /* BANDS  */                             /* { onebandwidth, onebandheight, bandsHspace, bandsVspace, numofbands, fadespeed } */
 const VUBandsConfig bandsConf     PROGMEM = { 32, 130, 4, 2, 10, 3 };
 
+/* SPECTRUM  */                          /* { onebandwidth, height, bandsHspace, numofbands, fadespeed } */
+#define SPECTRUM_WIDGET
+const WidgetConfig spectrumConf   PROGMEM = { 89, 138, 1, WA_LEFT };
+const SpectrumBandsConfig spectrumBandsConf PROGMEM = { 13, 34, 3, 24, 2 };
+
 /* STRINGS  */
 const char         numtxtFmt[]    PROGMEM = "%d";
 const char           rssiFmt[]    PROGMEM = "WiFi %d";
@@ -304,10 +304,20 @@ void VuWidget::_draw(){
   uint8_t R = vulevel & 0xFF;
   
   bool played = player.isRunning();
+#if I2S_DOUT!=255 || I2S_INTERNAL
+  uint16_t vuhold = player.get_VUhold(dimension);   // fall and hold are timed by the meter (VU_DECAY_MS, VU_PEAK_HOLD_MS)
+  uint8_t holdL = (vuhold >> 8) & 0xFF;
+  uint8_t holdR = vuhold & 0xFF;
+  if(played){
+    measL=L;
+    measR=R;
+  }else{
+#else
   if(played){
     measL=(L>=measL)?measL + _bands.fadespeed:L;
     measR=(R>=measR)?measR + _bands.fadespeed:R;
   }else{
+#endif
     if(measL<dimension) measL += _bands.fadespeed;
     if(measR<dimension) measR += _bands.fadespeed;
   }
@@ -339,15 +349,27 @@ void VuWidget::_draw(){
     #ifndef BOOMBOX_STYLE
       _canvas->fillRect(_bands.width-measL, 0, measL, _bands.width, _bgcolor);
       _canvas->fillRect(_bands.width * 2 + _bands.space - measR, 0, measR, _bands.width, _bgcolor);
+      #if I2S_DOUT!=255 || I2S_INTERNAL
+        if(played && holdL<measL) _canvas->fillRect(_bands.width-holdL-1, 0, 1, _bands.height, _vumaxcolor);
+        if(played && holdR<measR) _canvas->fillRect(_bands.width * 2 + _bands.space - holdR - 1, 0, 1, _bands.height, _vumaxcolor);
+      #endif
       dsp.drawRGBBitmap(_config.left, _config.top, _canvas->getBuffer(), _bands.width * 2 + _bands.space, _bands.height);
     #else
       _canvas->fillRect(0, 0, _bands.width-(_bands.width-measL), _bands.width, _bgcolor);
       _canvas->fillRect(_bands.width * 2 + _bands.space - measR, 0, measR, _bands.width, _bgcolor);
+      #if I2S_DOUT!=255 || I2S_INTERNAL
+        if(played && holdL<measL) _canvas->fillRect(holdL, 0, 1, _bands.height, _vumaxcolor);
+        if(played && holdR<measR) _canvas->fillRect(_bands.width * 2 + _bands.space - holdR - 1, 0, 1, _bands.height, _vumaxcolor);
+      #endif
       dsp.drawRGBBitmap(_config.left, _config.top, _canvas->getBuffer(), _bands.width * 2 + _bands.space, _bands.height);
     #endif
   }else{
     _canvas->fillRect(0, 0, _bands.width, measL, _bgcolor);
     _canvas->fillRect(_bands.width + _bands.space, 0, _bands.width, measR, _bgcolor);
+    #if I2S_DOUT!=255 || I2S_INTERNAL
+      if(played && holdL<measL) _canvas->fillRect(0, holdL, _bands.width, 1, _vumaxcolor);
+      if(played && holdR<measR) _canvas->fillRect(_bands.width + _bands.space, holdR, _bands.width, 1, _vumaxcolor);
+    #endif
     dsp.drawRGBBitmap(_config.left, _config.top, _canvas->getBuffer(), _bands.width * 2 + _bands.space, _bands.height);
   }
 }
@@ -368,6 +390,64 @@ void VuWidget::_draw(){ }
 void VuWidget::loop(){ }
 void VuWidget::_clear(){ }
 #endif
+/************************
+      SPECTRUM WIDGET
+ ************************/
+#if !defined(DSP_LCD) && !defined(DSP_OLED) && (I2S_DOUT!=255 || I2S_INTERNAL)
+SpectrumWidget::~SpectrumWidget() {
+  if(_canvas) free(_canvas);
+}
+
+void SpectrumWidget::init(WidgetConfig wconf, SpectrumBandsConfig bands, uint16_t vumaxcolor, uint16_t vumincolor, uint16_t bgcolor) {
+  Widget::init(wconf, bgcolor, bgcolor);
+  _vumaxcolor = vumaxcolor;
+  _vumincolor = vumincolor;
+  _bands = bands;
+  if(_bands.numofbands > sizeof(_levels)) _bands.numofbands = sizeof(_levels);
+  memset(_levels, 0, sizeof(_levels));
+  memset(_meas, 0, sizeof(_meas));
+  _lastUpdate = 0;
+  _canvas = new Canvas(_bands.width * _bands.numofbands + _bands.space * (_bands.numofbands - 1), _bands.height);
+  player.startSpectrum();
+}
+
+void SpectrumWidget::_draw(){
+  if(!_active || _locked) return;
+  if(millis() - _lastUpdate < 1000 / SPECTRUM_FPS) return;
+  _lastUpdate = millis();
+  bool fresh = player.getSpectrum(_levels, _bands.numofbands);  // FFT runs here, in the display task
+  uint16_t w = _bands.width * _bands.numofbands + _bands.space * (_bands.numofbands - 1);
+  uint16_t top = _bands.height / 4;
+  _canvas->fillRect(0, 0, w, _bands.height, _bgcolor);
+  for(uint8_t b = 0; b < _bands.numofbands; b++){
+    uint16_t h = fresh ? (uint16_t)_levels[b] * _bands.height / 255 : 0;
+    _meas[b] = (h >= _meas[b]) ? h : (_meas[b] > _bands.fadespeed ? _meas[b] - _bands.fadespeed : 0);
+    if(!_meas[b]) continue;
+    uint16_t x = b * (_bands.width + _bands.space);
+    uint16_t y = _bands.height - _meas[b];
+    _canvas->fillRect(x, y, _bands.width, _meas[b], _vumincolor);
+    if(y < top) _canvas->fillRect(x, y, _bands.width, top - y, _vumaxcolor);
+  }
+  dsp.drawRGBBitmap(_config.left, _config.top, _canvas->getBuffer(), w, _bands.height);
+}
+
+void SpectrumWidget::loop(){
+  if(_active || !_locked) _draw();
+}
+
+void SpectrumWidget::_clear(){
+  memset(_meas, 0, sizeof(_meas));
+  dsp.fillRect(_config.left, _config.top, _bands.width * _bands.numofbands + _bands.space * (_bands.numofbands - 1), _bands.height, _bgcolor);
+}
+#else // DSP_LCD, VS1053
+SpectrumWidget::~SpectrumWidget() { }
+void SpectrumWidget::init(WidgetConfig wconf, SpectrumBandsConfig bands, uint16_t vumaxcolor, uint16_t vumincolor, uint16_t bgcolor) {
+  Widget::init(wconf, bgcolor, bgcolor);
+}
+void SpectrumWidget::_draw(){ }
+void SpectrumWidget::loop(){ }
+void SpectrumWidget::_clear(){ }
+#endif
 /************************
       NUM WIDGET
  ************************/
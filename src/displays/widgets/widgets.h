@@ -52,6 +52,14 @@ struct VUBandsConfig {
   uint8_t  fadespeed;
 };
 
+struct SpectrumBandsConfig {
+  uint16_t width;
+  uint16_t height;
+  uint8_t  space;
+  uint8_t  numofbands;
+  uint8_t  fadespeed;
+};
+
 struct MoveConfig {
   uint16_t x;
   uint16_t y;
@@ -216,6 +224,26 @@ class VuWidget: public Widget {
     void _clear();
 };
 
+class SpectrumWidget: public Widget {
+  public:
+    SpectrumWidget() {}
+    SpectrumWidget(WidgetConfig wconf, SpectrumBandsConfig bands, uint16_t vumaxcolor, uint16_t vumincolor, uint16_t bgcolor) { init(wconf, bands, vumaxcolor, vumincolor, bgcolor); }
+    ~SpectrumWidget();
+    using Widget::init;
+    void init(WidgetConfig wconf, SpectrumBandsConfig bands, uint16_t vumaxcolor, uint16_t vumincolor, uint16_t bgcolor);
+    void loop();
+  protected:
+    #if !defined(DSP_LCD) && !defined(DSP_OLED)
+      Canvas *_canvas;
+    #endif
+    SpectrumBandsConfig _bands;
+    uint16_t _vumaxcolor, _vumincolor;
+    uint8_t _levels[32], _meas[32];
+    uint32_t _lastUpdate;
+    void _draw();
+    void _clear();
+};
+
 class NumWidget: public TextWidget {
   public:
     using Widget::init;
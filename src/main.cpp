@@ -78,6 +78,7 @@ HS1527Receiver hs;
 ModbusRTU mbRTU;
 //Player player;
 
+#ifndef PIO_UNIT_TESTING   // the embedded tests link the firmware (test_build_src) with their own setup() and loop()
 void setup() {
   Serial.begin(115200);
   //----------------------Modbus--------------------------------------
@@ -180,3 +181,4 @@ void loop() {
 //     }
 // }
 }
+#endif
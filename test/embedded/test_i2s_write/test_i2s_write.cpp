@@ -0,0 +1,221 @@
+/*
+ * test_i2s_write.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Before/after benchmark of the I2S output path on the board, cycles per stereo frame:
+ *  pio test -e esp-wrover-kit -f embedded/test_i2s_write
+ *
+ *  old  the per-sample path as it was in Audio::playSample(): three float IIR stages, _computeVUlevel(), Gain() and
+ *       one i2s_write() of 4 bytes per frame, kept here as the reference since it has left Audio.cpp
+ *  new  the block path of the firmware, Audio::processI2Sblock() and Audio::writeI2Sblock() of the player (the test
+ *       links the firmware, test_build_src), called through Audio::benchOutputBlock() in blocks of I2S_BLOCK_FRAMES
+ *
+ *  Both run the same second of 44.1 kHz stereo with the same tone (3, -2, -3 dB), volume and VU meter on. The writer
+ *  waits for the DMA in both cases, so the wall time is the same; the CPU it takes is measured with a spinner task of
+ *  lower priority on the same core, whose count drops by the share of the writer: load = 1 - spins / spins without
+ *  writer, cycles per frame = load * CPU cycles of the run / frames. The DSP part of the new path is also counted
+ *  directly (audioStats_t::dspCycles).
+ */
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <unity.h>
+#include "../../../src/core/config.h"
+#include "../../../src/core/player.h"
+
+#define BENCH_RATE      44100
+#define BENCH_FRAMES    BENCH_RATE      // one second
+#define BLOCK_FRAMES    I2S_BLOCK_FRAMES
+#define BENCH_VOLUME    200
+
+static volatile uint32_t spins = 0;
+static volatile bool     spinning = false;
+static int16_t           pcm[BLOCK_FRAMES * 2];
+static uint32_t          writes = 0;
+
+//---------------------------------------------------------------------------------------------------------------------
+//    the old per-sample path (Audio::playSample() before the block pipeline)
+//---------------------------------------------------------------------------------------------------------------------
+struct iirF_t {float a0, a1, a2, b1, b2;};
+static const iirF_t oldFilter[3] = {            // IIR_calculateCoefficients(3, -2, -3) at 44.1 kHz
+    {1.00152037f, -1.98385446f, 0.98251613f, -1.98388104f, 0.98400992f},
+    {0.98056224f, -1.64805786f, 0.83042048f, -1.64805786f, 0.81098272f},
+    {0.77617465f, -0.66439735f, 0.23612034f, -1.01024662f, 0.35814426f},
+};
+static float   oldFilterBuff[3][2][2][2];      // [filter][z1, z2][in, out][channel]
+static uint8_t oldVuLeft, oldVuRight, oldVuThreshold;
+
+static int16_t* oldIIR(uint8_t f, int16_t iir_in[2]) {
+    uint8_t z1 = 0, z2 = 1;
+    enum: uint8_t {in = 0, out = 1};
+    static int16_t iir_out[2];
+    for(uint8_t c = 0; c < 2; c++) {
+        float inSample = (float)iir_in[c];
+        float outSample = oldFilter[f].a0 * inSample
+                        + oldFilter[f].a1 * oldFilterBuff[f][z1][in][c]
+                        + oldFilter[f].a2 * oldFilterBuff[f][z2][in][c]
+                        - oldFilter[f].b1 * oldFilterBuff[f][z1][out][c]
+                        - oldFilter[f].b2 * oldFilterBuff[f][z2][out][c];
+        oldFilterBuff[f][z2][in][c]  = oldFilterBuff[f][z1][in][c];
+        oldFilterBuff[f][z1][in][c]  = inSample;
+        oldFilterBuff[f][z2][out][c] = oldFilterBuff[f][z1][out][c];
+        oldFilterBuff[f][z1][out][c] = outSample;
+        iir_out[c] = (int16_t)outSample;
+    }
+    return iir_out;
+}
+static void oldVU(int16_t sample[2]) {
+    static uint8_t sampleArray[2][4][8] = {0};
+    static uint8_t cnt0 = 0, cnt1 = 0, cnt2 = 0, cnt3 = 0, cnt4 = 0;
+    static bool    f_vu = false;
+    auto avg = [&](uint8_t* sampArr) {
+        uint16_t av = 0;
+        for(int i = 0; i < 8; i++) av += sampArr[i];
+        return av >> 3;
+    };
+    auto largest = [&](uint8_t* sampArr) {
+        uint16_t maxValue = 0;
+        for(int i = 0; i < 8; i++) if(maxValue < sampArr[i]) maxValue = sampArr[i];
+        return maxValue;
+    };
+    if(cnt0 == 64) {cnt0 = 0; cnt1++;}
+    if(cnt1 == 8) {cnt1 = 0; cnt2++;}
+    if(cnt2 == 8) {cnt2 = 0; cnt3++;}
+    if(cnt3 == 8) {cnt3 = 0; cnt4++; f_vu = true;}
+    if(cnt4 == 8) {cnt4 = 0;}
+    if(!cnt0) {
+        sampleArray[0][0][cnt1] = abs(sample[0] >> 7);
+        sampleArray[1][0][cnt1] = abs(sample[1] >> 7);
+    }
+    if(!cnt1) {
+        sampleArray[0][1][cnt2] = largest(sampleArray[0][0]);
+        sampleArray[1][1][cnt2] = largest(sampleArray[1][0]);
+    }
+    if(!cnt2) {
+        sampleArray[0][2][cnt3] = largest(sampleArray[0][1]);
+        sampleArray[1][2][cnt3] = largest(sampleArray[1][1]);
+    }
+    if(!cnt3) {
+        sampleArray[0][3][cnt4] = avg(sampleArray[0][2]);
+        sampleArray[1][3][cnt4] = avg(sampleArray[1][2]);
+    }
+    if(f_vu) {
+        f_vu = false;
+        oldVuLeft = avg(sampleArray[0][3]);
+        if(oldVuLeft > oldVuThreshold) oldVuThreshold = oldVuLeft;
+        oldVuRight = avg(sampleArray[1][3]);
+        if(oldVuRight > oldVuThreshold) oldVuThreshold = oldVuRight;
+    }
+    cnt1++;
+}
+static int32_t oldGain(int16_t s[2]) {
+    int32_t v[2];
+    float step = (float)BENCH_VOLUME / 254;
+    uint8_t l = 0, r = 0;
+    int8_t balance = 0;
+    if(balance < 0) {step = step * (float)(abs(balance) * 16); l = (uint8_t)(step);}
+    if(balance > 0) {step = step * balance * 16; r = (uint8_t)(step);}
+    v[0] = (s[0] * (BENCH_VOLUME - l)) >> 8;
+    v[1] = (s[1] * (BENCH_VOLUME - r)) >> 8;
+    return (v[0] << 16) | (v[1] & 0xffff);
+}
+static bool oldPlaySample(int16_t sample[2]) {
+    sample[0] = sample[0] >> 1;
+    sample[1] = sample[1] >> 1;
+    sample = oldIIR(0, sample);
+    sample = oldIIR(1, sample);
+    sample = oldIIR(2, sample);
+    oldVU(sample);
+    uint32_t s32 = oldGain(sample);
+    size_t written = 0;
+    esp_err_t err = i2s_write((i2s_port_t)player.getI2sPort(), (const char*)&s32, sizeof(uint32_t), &written, 100);
+    writes++;
+    return err == ESP_OK && written == sizeof(uint32_t);
+}
+//---------------------------------------------------------------------------------------------------------------------
+
+static void spinTask(void*) {
+    while(true) {
+        if(spinning) spins++;
+        else vTaskDelay(1);
+    }
+}
+enum : uint8_t {RUN_IDLE, RUN_OLD, RUN_NEW};
+struct bench_t {uint8_t path; TaskHandle_t caller; uint32_t ms; uint32_t cycles; uint32_t failed;};
+static void writerTask(void* arg) {
+    bench_t* b = (bench_t*)arg;
+    uint32_t t = millis(), c = ESP.getCycleCount();
+    if(b->path == RUN_OLD) {
+        for(uint32_t i = 0; i < BENCH_FRAMES; i += BLOCK_FRAMES)
+            for(uint16_t k = 0; k < BLOCK_FRAMES; k++) {
+                int16_t sample[2] = {pcm[2 * k], pcm[2 * k + 1]};
+                if(!oldPlaySample(sample)) b->failed++;
+            }
+    }
+    else if(b->path == RUN_NEW) {
+        uint32_t w = player.getStats().i2sWrites;
+        for(uint32_t i = 0; i < BENCH_FRAMES; i += BLOCK_FRAMES)
+            if(!player.benchOutputBlock(pcm, BLOCK_FRAMES, BENCH_RATE)) b->failed++;
+        writes += player.getStats().i2sWrites - w;
+    }
+    else vTaskDelay(pdMS_TO_TICKS(1000));        // reference: the spinner alone
+    b->cycles = ESP.getCycleCount() - c;
+    b->ms = millis() - t;
+    xTaskNotifyGive(b->caller);
+    vTaskDelete(NULL);
+}
+static float run(bench_t* b) {
+    // spins per ms while the writer runs
+    b->caller = xTaskGetCurrentTaskHandle();
+    i2s_zero_dma_buffer((i2s_port_t)player.getI2sPort());
+    spins = 0;
+    spinning = true;
+    xTaskCreatePinnedToCore(writerTask, "bench", 4096, b, 3, NULL, 1);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    spinning = false;
+    return (float)spins / (float)b->ms;
+}
+
+void test_block_path_needs_fewer_cycles_per_frame() {
+    const uint32_t frames = (BENCH_FRAMES + BLOCK_FRAMES - 1) / BLOCK_FRAMES * BLOCK_FRAMES;
+    bench_t idle = {RUN_IDLE}, oldRun = {RUN_OLD}, newRun = {RUN_NEW};
+    float spinsIdle = run(&idle);
+    writes = 0;
+    float spinsOld = run(&oldRun);
+    uint32_t oldWrites = writes;
+    writes = 0;
+    player.resetStats();
+    float spinsNew = run(&newRun);
+    uint32_t newWrites = writes;
+    float loadOld = 1.0f - spinsOld / spinsIdle, loadNew = 1.0f - spinsNew / spinsIdle;
+    float cpfOld = loadOld * oldRun.cycles / frames, cpfNew = loadNew * newRun.cycles / frames;
+    float dspNew = (float)player.getStats().dspCycles / frames;
+    char msg[220];
+    snprintf(msg, sizeof(msg), "old: %u writes, %u ms, CPU %.1f%%, %.0f cycles/frame | new: %u writes, %u ms, "
+             "CPU %.1f%%, %.0f cycles/frame (DSP %.0f)", oldWrites, oldRun.ms, (double)(loadOld * 100.0f),
+             (double)cpfOld, newWrites, newRun.ms, (double)(loadNew * 100.0f), (double)cpfNew, (double)dspNew);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, oldRun.failed, "old path: i2s_write() failed");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, newRun.failed, "new path: writeI2Sblock() failed");
+    TEST_ASSERT_TRUE_MESSAGE(cpfNew < cpfOld, msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void setup() {
+    delay(2000);
+    for(int i = 0; i < BLOCK_FRAMES; i++) {     // 1 kHz left, 1.5 kHz right at -6 dBFS
+        pcm[2 * i]     = (int16_t)(16383.0f * sinf(2.0f * (float)PI * 1000.0f * i / BENCH_RATE));
+        pcm[2 * i + 1] = (int16_t)(16383.0f * sinf(2.0f * (float)PI * 1500.0f * i / BENCH_RATE));
+    }
+    config.store.vumeter = true;
+    player.setTone(3, -2, -3);
+    player.setVolume(BENCH_VOLUME);
+    player.benchOutputBlock(pcm, BLOCK_FRAMES, BENCH_RATE);   // I2S clock and filters at 44.1 kHz for both paths
+    xTaskCreatePinnedToCore(spinTask, "spin", 2048, NULL, 2, NULL, 1);
+    UNITY_BEGIN();
+    RUN_TEST(test_block_path_needs_fewer_cycles_per_frame);
+    UNITY_END();
+}
+void loop() {}
@@ -0,0 +1,60 @@
+/*
+ * test_spectrum.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  CPU cost of the spectrum analyzer (dsp/spectrum) on the board:
+ *  pio test -e esp-wrover-kit -f embedded/test_spectrum
+ *
+ *  Cycles of SP_Tap() for one I2S block (runs in the I2S output task) and of SP_Compute() for the 24 bands of the
+ *  SpectrumWidget (runs in the display task), measured with ESP.getCycleCount() over many calls. The share of one
+ *  core is the tap of one second of 44.1 kHz audio plus SPECTRUM_FPS transforms, it must stay below 5 %.
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include "../../../src/audioI2S/dsp/spectrum.h"
+
+#define BENCH_RATE      44100
+#define BLOCK_FRAMES    256             // I2S_BLOCK_FRAMES
+#define BANDS           24              // SpectrumWidget
+#define FPS             25              // SPECTRUM_FPS
+#define RUNS            200
+
+static uint32_t    spMem[SP_MEM_SIZE / 4];
+static spectrum_t  sp;
+static int16_t     block[BLOCK_FRAMES * 2];
+
+void test_spectrum_cpu() {
+    uint8_t lv[SP_MAX_BANDS];
+    SP_Init(&sp, spMem);
+    for(int i = 0; i < BLOCK_FRAMES * 2; i++) block[i] = (int16_t)(esp_random() % 20001) - 10000;
+    for(int i = 0; i < SP_TAP_LEN * 2 / BLOCK_FRAMES; i++) SP_Tap(&sp, block, BLOCK_FRAMES, BENCH_RATE);
+
+    uint32_t tapCycles = 0, computeCycles = 0, maxCompute = 0;
+    for(int r = 0; r < RUNS; r++) {
+        uint32_t t = ESP.getCycleCount();
+        SP_Tap(&sp, block, BLOCK_FRAMES, BENCH_RATE);
+        tapCycles += ESP.getCycleCount() - t;
+        t = ESP.getCycleCount();
+        TEST_ASSERT_TRUE(SP_Compute(&sp, lv, BANDS));
+        t = ESP.getCycleCount() - t;
+        computeCycles += t;
+        if(t > maxCompute) maxCompute = t;
+    }
+    float mhz = ESP.getCpuFreqMHz();
+    float tapUs = tapCycles / (float)RUNS / mhz, computeUs = computeCycles / (float)RUNS / mhz;
+    float load = (tapUs * BENCH_RATE / BLOCK_FRAMES + computeUs * FPS) / 1e4f;   // % of one core
+    char msg[160];
+    snprintf(msg, sizeof(msg), "tap %.1f us per %u frames, compute %.0f us (max %.0f us), %.2f%% of one core at %u fps",
+             (double)tapUs, BLOCK_FRAMES, (double)computeUs, (double)(maxCompute / mhz), (double)load, FPS);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(load < 5.0f, msg);
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_spectrum_cpu);
+    UNITY_END();
+}
+void loop() {}
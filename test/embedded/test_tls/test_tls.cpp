@@ -0,0 +1,91 @@
+/*
+ * test_tls.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Full and resumed TLS handshakes of TlsClient (core/tlssession) on the board:
+ *  PLATFORMIO_BUILD_FLAGS='-DTEST_WIFI_SSID=\"ssid\" -DTEST_WIFI_PASS=\"password\"' pio test -e esp-wrover-kit -f embedded/test_tls
+ *
+ *  TLS_HOST (an https stream server of the station list by default) is connected TLS_CONNECTS times with its session
+ *  dropped before every connect (full handshake) and TLS_CONNECTS times with the session of the connect before
+ *  (resumed). Per connect: the time of the handshake and the heap it takes at the lowest point, from the counters of
+ *  tlsSessions (the telnet "tls:" line), the time of connect() with DNS and TCP, and ESP.getFreeHeap() before the
+ *  connect against after stop() (nothing is left behind).
+ */
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <unity.h>
+#include "../testwifi.h"
+#include "../../../src/core/tlssession.h"
+
+#ifndef TLS_HOST
+  #define TLS_HOST      "radiorecord.hostingradio.ru"
+#endif
+#define TLS_PORT        443
+#define TLS_CONNECTS    5
+#define TLS_LEAK        512                     // bytes, heap left after stop() (lwIP, allocator)
+
+struct tlsRun_t {uint32_t n, handshakeMs, handshakeHeap, connectMs; int32_t left;};
+
+static bool handshake(tlsRun_t* r, bool resumed) {
+    // false: no connection, or the other kind of handshake
+    static TlsClient client;
+    client.setInsecure();                       // as Audio, TlsClient resumes only in insecure mode
+    const tsStats_t& st = tlsSessions.stats(resumed);
+    uint32_t count = st.count, ms = st.sumMs, heap = st.sumHeap;
+    uint32_t free0 = ESP.getFreeHeap(), t = millis();
+    if(!client.connect(TLS_HOST, TLS_PORT)) return false;
+    uint32_t connectMs = millis() - t;
+    client.stop();
+    delay(200);                                 // the TCP close
+    if(st.count != count + 1) return false;
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%-7s handshake %u ms, heap %u bytes, connect %u ms, heap after stop %d bytes",
+             resumed ? "resumed" : "full", st.sumMs - ms, st.sumHeap - heap, connectMs, (int)(ESP.getFreeHeap() - free0));
+    TEST_MESSAGE(msg);
+    r->n++;
+    r->handshakeMs += st.sumMs - ms;
+    r->handshakeHeap += st.sumHeap - heap;
+    r->connectMs += connectMs;
+    r->left += (int32_t)(free0 - ESP.getFreeHeap());
+    return true;
+}
+
+static void report(const char* name, const tlsRun_t& r) {
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%-7s %u connects: handshake avg %u ms, heap avg %u bytes, connect avg %u ms", name,
+             r.n, r.handshakeMs / r.n, r.handshakeHeap / r.n, r.connectMs / r.n);
+    TEST_MESSAGE(msg);
+}
+
+void test_resumed_handshake() {
+    if(!testWifiConnect()) TEST_IGNORE_MESSAGE("no WiFi, set TEST_WIFI_SSID and TEST_WIFI_PASS");
+    tlsRun_t full = {}, resumed = {};
+    tlsSessions.drop(TLS_HOST, TLS_PORT);
+    TEST_ASSERT_TRUE_MESSAGE(handshake(&full, false), "first connect");   // the session cache, DNS entry
+    full = {};
+    for(int i = 0; i < TLS_CONNECTS; i++) {
+        tlsSessions.drop(TLS_HOST, TLS_PORT);
+        TEST_ASSERT_TRUE_MESSAGE(handshake(&full, false), "full: no connection or resumed");
+    }
+    for(int i = 0; i < TLS_CONNECTS; i++)
+        TEST_ASSERT_TRUE_MESSAGE(handshake(&resumed, true), "resumed: no connection or full (no session from " TLS_HOST ")");
+    report("full", full);
+    report("resumed", resumed);
+    TEST_ASSERT_TRUE(resumed.handshakeMs < full.handshakeMs);
+    TEST_ASSERT_TRUE(resumed.handshakeHeap < full.handshakeHeap);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(TLS_LEAK * TLS_CONNECTS, full.left);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(TLS_LEAK * TLS_CONNECTS, resumed.left);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void setup() {
+    delay(2000);
+    SPIFFS.begin(true);                     // the file of the DNS cache, as Config::init()
+    UNITY_BEGIN();
+    RUN_TEST(test_resumed_handshake);
+    UNITY_END();
+}
+void loop() {}
@@ -0,0 +1,90 @@
+/*
+ * test_ttfa.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Time to first audio of a station behind a playlist, with and without the stream cache (core/streamcache):
+ *  PLATFORMIO_BUILD_FLAGS='-DTEST_WIFI_SSID=\"ssid\" -DTEST_WIFI_PASS=\"password\"' pio test -e esp-wrover-kit -f embedded/test_ttfa
+ *
+ *  The station (TTFA_STATION, a .pls by default) is played TTFA_ZAPS times with its cache entry dropped before every
+ *  start (resolved: playlist request, then the stream) and TTFA_ZAPS times with the entry of the run before (cached:
+ *  straight to the stream, decoder set up while the server answers). The time is the one of the zap statistics,
+ *  zapStart() to the first decoded frames (audioStats_t::zapMs), the same the telnet audiostat shows.
+ */
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <unity.h>
+#include "../testwifi.h"
+#include "../../../src/core/player.h"
+#include "../../../src/core/streamcache.h"
+
+#ifndef TTFA_STATION
+  #define TTFA_STATION  "http://somafm.com/groovesalad.pls"
+#endif
+#define TTFA_ZAPS       5
+#define TTFA_TIMEOUT    15000
+
+struct ttfa_t {uint32_t n, sum, min, max, cached;};
+
+static bool zap(ttfa_t* r) {
+    // false: no audio within TTFA_TIMEOUT
+    player.stopSong();
+    delay(500);
+    uint32_t zaps = player.getStats().zaps;
+    player.zapStart(true);
+    if(!player.connecttohost(TTFA_STATION)) return false;
+    uint32_t t = millis();
+    while(player.getStats().zaps == zaps) {
+        if(millis() - t > TTFA_TIMEOUT) return false;
+        player.Audio::loop();
+        vTaskDelay(1);
+    }
+    const audioStats_t& st = player.getStats();
+    if(st.cachedZaps) r->cached++;
+    r->n++;
+    r->sum += st.zapMs;
+    if(!r->min || st.zapMs < r->min) r->min = st.zapMs;
+    if(st.zapMs > r->max) r->max = st.zapMs;
+    for(t = millis(); millis() - t < 1000;) {player.Audio::loop(); vTaskDelay(1);}   // the entry is stored on audio
+    return true;
+}
+
+static void report(const char* name, const ttfa_t& r) {
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%-9s %u zaps: avg %u ms, min %u ms, max %u ms (%u from the cache)", name, r.n,
+             r.n ? r.sum / r.n : 0, r.min, r.max, r.cached);
+    TEST_MESSAGE(msg);
+}
+
+void test_cached_zap_is_faster() {
+    if(!testWifiConnect()) TEST_IGNORE_MESSAGE("no WiFi, set TEST_WIFI_SSID and TEST_WIFI_PASS");
+    ttfa_t resolved = {}, cached = {};
+    for(int i = 0; i < TTFA_ZAPS; i++) {
+        streamCache.invalidate(TTFA_STATION);
+        player.resetStats();
+        TEST_ASSERT_TRUE_MESSAGE(zap(&resolved), "resolved: no audio");
+    }
+    for(int i = 0; i < TTFA_ZAPS; i++) {
+        player.resetStats();
+        TEST_ASSERT_TRUE_MESSAGE(zap(&cached), "cached: no audio");
+    }
+    player.stopSong();
+    report("resolved", resolved);
+    report("cached", cached);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, resolved.cached, "resolved zaps hit the cache");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(TTFA_ZAPS, cached.cached, "cached zaps missed the cache");
+    TEST_ASSERT_TRUE(cached.sum < resolved.sum);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void setup() {
+    delay(2000);
+    SPIFFS.begin(true);                     // the cache file, as Config::init()
+    player.setVolume(0);
+    UNITY_BEGIN();
+    RUN_TEST(test_cached_zap_is_faster);
+    UNITY_END();
+}
+void loop() {}
@@ -0,0 +1,25 @@
+/*
+ * testwifi.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  WiFi for the board tests that need the network, the access point comes from the build flags:
+ *  PLATFORMIO_BUILD_FLAGS='-DTEST_WIFI_SSID=\"ssid\" -DTEST_WIFI_PASS=\"password\"' pio test -e esp-wrover-kit -f ...
+ *  Without them the tests are ignored.
+ */
+#pragma once
+#include <WiFi.h>
+
+static bool testWifiConnect(uint32_t timeoutMs = 20000) {
+#if defined(TEST_WIFI_SSID) && defined(TEST_WIFI_PASS)
+    if(WiFi.status() == WL_CONNECTED) return true;
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(TEST_WIFI_SSID, TEST_WIFI_PASS);
+    uint32_t t = millis();
+    while(WiFi.status() != WL_CONNECTED && millis() - t < timeoutMs) delay(100);
+    return WiFi.status() == WL_CONNECTED;
+#else
+    (void)timeoutMs;
+    return false;
+#endif
+}
@@ -0,0 +1,48 @@
+/*
+ * Arduino.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Host stand-in for the native tests (pio test -e native): the few Arduino/ESP-IDF calls the audio modules use.
+ *  Allocations go to the C heap, PSRAM is reported as missing unless a test sets hostPsram.
+ */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <vector>
+
+#ifndef PROGMEM
+  #define PROGMEM
+#endif
+#define pgm_read_byte(a)    (*(const uint8_t*)(a))
+#define pgm_read_word(a)    (*(const uint16_t*)(a))
+#define pgm_read_dword(a)   (*(const uint32_t*)(a))
+
+#define MALLOC_CAP_DEFAULT  1
+#define MALLOC_CAP_INTERNAL 2
+#define MALLOC_CAP_SPIRAM   4
+#define MALLOC_CAP_8BIT     8
+
+static bool hostPsram = false;
+static inline bool  psramFound() {return hostPsram;}
+static inline void* ps_malloc(size_t n) {return malloc(n);}
+static inline void* heap_caps_malloc(size_t n, uint32_t) {return malloc(n);}
+static inline void* heap_caps_calloc(size_t n, size_t size, uint32_t) {return calloc(n, size);}
+static inline void* heap_caps_malloc_prefer(size_t n, int, ...) {return malloc(n);}
+
+#ifndef HOST_LOG
+  #define HOST_LOG 0        // 1: print the log of the modules
+#endif
+#define host_log(...)       do {if(HOST_LOG) {printf(__VA_ARGS__); printf("\n");}} while(0)
+#define AUDIO_INFO(...)     host_log(__VA_ARGS__)
+#define log_i(...)          host_log(__VA_ARGS__)
+#define log_e(...)          host_log(__VA_ARGS__)
+#define log_w(...)          host_log(__VA_ARGS__)
+#define log_d(...)          do {} while(0)
+
+using namespace std;
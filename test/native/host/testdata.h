@@ -0,0 +1,31 @@
+/*
+ * testdata.h
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Captures and reference files of the native tests are kept next to the test source, loadTestFile(__FILE__, name)
+ *  finds them independent of the working directory of the test runner.
+ */
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+static inline std::vector<uint8_t> loadTestFile(const char* source, const char* name) {
+    std::string path = source;
+    size_t slash = path.find_last_of("/\\");
+    path = (slash == std::string::npos ? std::string(".") : path.substr(0, slash)) + "/" + name;
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if(!f) return data;
+    uint8_t buf[4096];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+static inline uint32_t testRand(uint32_t* seed) {   // LCG, the same sequence on every host
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
@@ -0,0 +1,137 @@
+/*
+ * test_aac.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  AAC decoder instances (aac_decoder, AACCreate()): two streams decoded at the same time, interleaved frame by frame
+ *  and in two threads, give the PCM of the single default instance (AACDecoder_AllocateBuffers(), AACDecode()) bit
+ *  for bit. AACDecoder_Detach() hands a running default instance over, it goes on with its stream while a new
+ *  default instance decodes another one.
+ *
+ *  a.aac  FFmpeg aac, LC in ADTS, 44.1 kHz stereo, 128 kbit/s, 1.5 s
+ *  b.aac  FFmpeg aac, LC in ADTS, 32 kHz mono, 48 kbit/s, 2 s
+ */
+#include <unity.h>
+#include <thread>
+#include "testdata.h"
+#include "aac_decoder/aac_decoder.cpp"
+
+struct job_t {
+    std::vector<uint8_t> in;
+    size_t               pos = 0;
+    std::vector<int16_t> out;
+    AACDecoder*          dec = NULL;                // NULL: the default instance
+    short                pcm[2 * 2048];              // SBR doubles the frame
+};
+
+static void load(job_t* j, const char* name) {
+    j->in = loadTestFile(__FILE__, name);
+    j->in.resize(j->in.size() + 64);                // the decoder reads a few bytes ahead
+    j->pos = 0;
+    j->out.clear();
+}
+
+static bool step(job_t* j) {
+    // one frame, false at the end of the stream
+    while(j->pos < j->in.size() - 64) {
+        int left = j->in.size() - 64 - j->pos;
+        int offs = AACFindSyncWord(&j->in[j->pos], left);
+        if(offs < 0) return false;
+        j->pos += offs;
+        left -= offs;
+        int bytesLeft = left;
+        int ret = j->dec ? AACDecode(j->dec, &j->in[j->pos], &bytesLeft, j->pcm)
+                         : AACDecode(&j->in[j->pos], &bytesLeft, j->pcm);
+        j->pos += left - bytesLeft ? left - bytesLeft : 1;
+        if(ret == ERR_AAC_NONE) {
+            int n = j->dec ? AACGetOutputSamps(j->dec) : AACGetOutputSamps();
+            j->out.insert(j->out.end(), j->pcm, j->pcm + n);
+            return true;
+        }
+        if(ret == ERR_AAC_INDATA_UNDERFLOW) return false;
+    }
+    return false;
+}
+
+static std::vector<int16_t> single(const char* name) {
+    // empty if the buffers can't be allocated
+    static job_t j;
+    load(&j, name);
+    if(!AACDecoder_AllocateBuffers()) return {};
+    while(step(&j)) {}
+    AACDecoder_FreeBuffers();
+    return j.out;
+}
+
+static job_t a, b;
+
+void test_interleaved() {
+    std::vector<int16_t> ra = single("a.aac"), rb = single("b.aac");
+    TEST_ASSERT_TRUE(ra.size() > 44100 * 2 && rb.size() > 32000);
+    load(&a, "a.aac");
+    load(&b, "b.aac");
+    a.dec = AACCreate();
+    b.dec = AACCreate();
+    TEST_ASSERT_TRUE(a.dec && b.dec);
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    AACDestroy(a.dec);
+    AACDestroy(b.dec);
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void test_threads() {
+    std::vector<int16_t> ra = single("a.aac"), rb = single("b.aac");
+    for(int run = 0; run < 4; run++) {
+        load(&a, "a.aac");
+        load(&b, "b.aac");
+        a.dec = AACCreate();
+        b.dec = AACCreate();
+        std::thread ta([] {while(step(&a)) {}});
+        std::thread tb([] {while(step(&b)) {}});
+        ta.join();
+        tb.join();
+        AACDestroy(a.dec);
+        AACDestroy(b.dec);
+        TEST_ASSERT_TRUE(a.out == ra);
+        TEST_ASSERT_TRUE(b.out == rb);
+    }
+}
+
+void test_detach() {
+    // a begins in the default instance, which is detached after 20 frames; b in a new default instance
+    std::vector<int16_t> ra = single("a.aac"), rb = single("b.aac");
+    load(&a, "a.aac");
+    load(&b, "b.aac");
+    a.dec = b.dec = NULL;
+    TEST_ASSERT_TRUE(AACDecoder_AllocateBuffers());
+    for(int i = 0; i < 20; i++) TEST_ASSERT_TRUE(step(&a));
+    a.dec = AACDecoder_Detach();
+    TEST_ASSERT_NOT_NULL(a.dec);
+    TEST_ASSERT_EQUAL(ERR_AAC_NULL_POINTER, AACDecode(&b.in[0], NULL, b.pcm));   // no default instance now
+    TEST_ASSERT_TRUE(AACDecoder_AllocateBuffers());
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    AACDestroy(a.dec);
+    AACDecoder_FreeBuffers();
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_interleaved);
+    RUN_TEST(test_threads);
+    RUN_TEST(test_detach);
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+/*
+ * test_abr.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  HLS variant selection (net/abr): the throughput estimate, the rules to switch up and down, and the continuity of
+ *  the media sequence across a switch.
+ *
+ *  The sequence test follows Audio::parsePlaylist_M3U8(), popPlaylistURL() and hlsSegmentDone(): live playlists of
+ *  12 segments, a new segment every step, the queue takes the new entries (ABR_Queue(), the hash queue of the player
+ *  is the set of known segments of the variant), 0, 1 or 2 segments are requested per step (ABR_Requested()), so the
+ *  player runs behind the live edge by a varying distance. A switch drops the queue and loads the playlist of the
+ *  other variant. Every media sequence number must be requested exactly once
+ *  and in order, whatever variant it comes from.
+ */
+#include <unity.h>
+#include <set>
+#include <deque>
+#include "testdata.h"
+#include "net/abr.cpp"
+
+static const uint32_t bw[4] = {64000, 256000, 32000, 128000};       // as listed in a master playlist, not sorted
+
+static void samples(abr_t* abr, uint32_t bps, int n, bool limited = false) {
+    for(int i = 0; i < n; i++) ABR_Sample(abr, bps / 8, 1000, limited);   // one second segments
+}
+
+void test_estimate() {
+    abr_t abr;
+    ABR_Reset(&abr);
+    TEST_ASSERT_EQUAL_INT(3, ABR_Select(&abr, bw, 4, 3));               // no sample, no change
+    samples(&abr, 400000, 1);
+    TEST_ASSERT_EQUAL_UINT32(400000, abr.estimate);                      // the first sample is taken
+    samples(&abr, 200000, 1);
+    TEST_ASSERT_EQUAL_UINT32(200000, abr.estimate);                      // down at once
+    samples(&abr, 600000, 1);
+    TEST_ASSERT_EQUAL_UINT32(300000, abr.estimate);                      // up by 1/4
+    samples(&abr, 100000, 1, true);
+    TEST_ASSERT_EQUAL_UINT32(300000, abr.estimate);                      // limited: not lower
+    samples(&abr, 700000, 1, true);
+    TEST_ASSERT_EQUAL_UINT32(400000, abr.estimate);                      // limited: higher is taken
+    ABR_Sample(&abr, 100, 10, false);                                    // under ABR_MIN_MS: limited
+    TEST_ASSERT_EQUAL_UINT32(400000, abr.estimate);
+}
+
+void test_switch_down_at_once() {
+    abr_t abr;
+    ABR_Reset(&abr);
+    samples(&abr, 1000000, 10);
+    TEST_ASSERT_EQUAL_INT(1, ABR_Select(&abr, bw, 4, 3));               // 256k <= 75% of 1M
+    TEST_ASSERT_TRUE(abr.switched);
+    ABR_PlaylistDone(&abr);
+    samples(&abr, 300000, 1);                                            // 75%: 225k
+    TEST_ASSERT_EQUAL_INT(3, ABR_Select(&abr, bw, 4, 1));               // no hold on the way down
+    samples(&abr, 20000, 1);
+    TEST_ASSERT_EQUAL_INT(2, ABR_Select(&abr, bw, 4, 3));               // none fits: the lowest
+    TEST_ASSERT_EQUAL_INT(2, ABR_Select(&abr, bw, 4, 2));
+}
+
+void test_switch_up_after_hold() {
+    abr_t abr;
+    ABR_Reset(&abr);
+    samples(&abr, 100000, 1);
+    TEST_ASSERT_EQUAL_INT(0, ABR_Select(&abr, bw, 4, 1));               // down to 64k (75k budget)
+    TEST_ASSERT_EQUAL_UINT16(0, abr.hold);
+    // the link gets faster: the estimate follows by 1/4, the switch waits for ABR_HOLD_SEGMENTS
+    int v = 0, seg = 0, firstUp = -1;
+    for(; seg < 20; seg++) {
+        samples(&abr, 1000000, 1);
+        int n = ABR_Select(&abr, bw, 4, v);
+        if(n != v && firstUp < 0) firstUp = seg;
+        if(n != v) TEST_ASSERT_TRUE(bw[n] > bw[v]);
+        if(n != v) TEST_ASSERT_TRUE(bw[n] <= abr.estimate * (uint64_t)ABR_MARGIN / 100);
+        v = n;
+    }
+    TEST_ASSERT_EQUAL_INT(ABR_HOLD_SEGMENTS - 1, firstUp);             // not before the hold
+    TEST_ASSERT_EQUAL_INT(1, v);                                        // the highest in the end
+    // a single fast segment right after a switch does not move it up again
+    samples(&abr, 100000, 1);
+    v = ABR_Select(&abr, bw, 4, v);
+    TEST_ASSERT_EQUAL_INT(0, v);
+    samples(&abr, 10000000, 1);
+    TEST_ASSERT_EQUAL_INT(0, ABR_Select(&abr, bw, 4, v));
+}
+
+void test_sequence_after_switch() {
+    // variant a queued 100...105, 100 and 101 requested, switch: b continues at 102
+    abr_t abr;
+    ABR_Reset(&abr);
+    for(int64_t s = 100; s <= 105; s++) TEST_ASSERT_TRUE(ABR_Queue(&abr, s));
+    ABR_PlaylistDone(&abr);
+    ABR_Requested(&abr, 100);
+    ABR_Requested(&abr, 101);
+    samples(&abr, 1000000, ABR_HOLD_SEGMENTS);
+    TEST_ASSERT_EQUAL_INT(1, ABR_Select(&abr, bw, 4, 0));
+    for(int64_t s = 98; s <= 101; s++) TEST_ASSERT_FALSE(ABR_Queue(&abr, s));
+    for(int64_t s = 102; s <= 106; s++) TEST_ASSERT_TRUE(ABR_Queue(&abr, s));
+    TEST_ASSERT_TRUE(ABR_Queue(&abr, -1));                              // no #EXT-X-MEDIA-SEQUENCE
+    ABR_PlaylistDone(&abr);
+    TEST_ASSERT_TRUE(ABR_Queue(&abr, 5));                               // a restarted sequence plays
+    ABR_Requested(&abr, -1);
+    TEST_ASSERT_EQUAL(101, abr.lastSeq);
+}
+
+void test_sequence_continuity() {
+    // 2000 segments of a live stream, the throughput changes at random, every segment is requested once and in order
+    abr_t abr;
+    ABR_Reset(&abr);
+    uint32_t seed = 5, switches = 0;
+    int variant = 3;
+    int64_t live = 1000;                                                // newest segment of the playlists
+    std::deque<int64_t> queue;                                          // m_playlistURL, the oldest at the front
+    std::set<int64_t> known;                                            // m_hashQueue of the current variant
+    int64_t expect = -1;
+    bool reload = true;
+    for(int step = 0; step < 2000; step++, live++) {
+        uint32_t r = testRand(&seed);
+        if(reload || queue.empty()) {                                   // parsePlaylist_M3U8()
+            for(int64_t s = live - 11; s <= live; s++) {
+                if(!ABR_Queue(&abr, s)) {known.insert(s); continue;}
+                if(known.insert(s).second) queue.push_back(s);
+            }
+            ABR_PlaylistDone(&abr);
+            reload = false;
+        }
+        int requests = r % 3;                                           // the segments take more or less time
+        if(expect >= 0 && live - expect > 8) requests = 2;              // but stay in the window
+        if(expect >= 0 && live - expect < 2) requests = 0;
+        for(int k = 0; k < requests && !queue.empty(); k++) {
+            int64_t s = queue.front();                                  // popPlaylistURL()
+            queue.pop_front();
+            ABR_Requested(&abr, s);
+            if(expect < 0) expect = s;
+            char msg[64];
+            snprintf(msg, sizeof(msg), "step %d: segment %lld, expected %lld", step, (long long)s, (long long)expect);
+            TEST_ASSERT_TRUE_MESSAGE(s == expect, msg);
+            expect = s + 1;
+            ABR_Sample(&abr, (testRand(&seed) % 400000 + 20000) / 8, 1000, false); // hlsSegmentDone()
+            int v = ABR_Select(&abr, bw, 4, variant);
+            if(v != variant) {
+                variant = v;
+                switches++;
+                queue.clear();
+                known.clear();                                          // other urls, other hashes
+                reload = true;
+                break;
+            }
+        }
+        if((r >> 8) % 3 == 0) reload = true;                            // #EXT-X-TARGETDURATION
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%u switches, last segment %lld", switches, (long long)expect - 1);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(switches > 50);
+    TEST_ASSERT_TRUE(expect > 2900);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_estimate);
+    RUN_TEST(test_switch_down_at_once);
+    RUN_TEST(test_switch_up_after_hold);
+    RUN_TEST(test_sequence_after_switch);
+    RUN_TEST(test_sequence_continuity);
+    return UNITY_END();
+}
@@ -0,0 +1,134 @@
+/*
+ * test_biquad.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Q29 Direct Form I biquad with error feedback (dsp/biquad) against a double precision reference with the same
+ *  (float) coefficients: the tone control of Audio::IIR_calculateCoefficients() (low shelf 80 Hz, peak 3 kHz,
+ *  high shelf 6 kHz) at 16...48 kHz and -40...+6 dB. Bounds of biquad.h: 0.51 LSB per stage, 3 LSB for the
+ *  cascade of 3, no DC offset.
+ */
+#include <unity.h>
+#include <algorithm>
+#include "testdata.h"
+#include "dsp/biquad.cpp"
+
+struct coef_t {double a0, a1, a2, b1, b2;};
+
+static void toneCoefficients(coef_t f[3], int g0, int g1, int g2, double sr) {
+    // as Audio::IIR_calculateCoefficients(), rounded to float like the values handed to BQ_SetStage()
+    double K, norm, Q, V;
+    K = tan(M_PI * 80 / sr); V = pow(10, fabs((double)g0) / 20.0);
+    if(g0 >= 0) {norm = 1 / (1 + sqrt(2) * K + K * K);
+                 f[0] = {(1 + sqrt(2 * V) * K + V * K * K) * norm, 2 * (V * K * K - 1) * norm, (1 - sqrt(2 * V) * K + V * K * K) * norm, 2 * (K * K - 1) * norm, (1 - sqrt(2) * K + K * K) * norm};}
+    else        {norm = 1 / (1 + sqrt(2 * V) * K + V * K * K);
+                 f[0] = {(1 + sqrt(2) * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - sqrt(2) * K + K * K) * norm, 2 * (V * K * K - 1) * norm, (1 - sqrt(2 * V) * K + V * K * K) * norm};}
+    K = tan(M_PI * 3000 / sr); V = pow(10, fabs((double)g1) / 20.0); Q = 2.5;
+    if(g1 >= 0) {norm = 1 / (1 + 1 / Q * K + K * K);
+                 f[1] = {(1 + V / Q * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - V / Q * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - 1 / Q * K + K * K) * norm};}
+    else        {norm = 1 / (1 + V / Q * K + K * K);
+                 f[1] = {(1 + 1 / Q * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - 1 / Q * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - V / Q * K + K * K) * norm};}
+    K = tan(M_PI * 6000 / sr); V = pow(10, fabs((double)g2) / 20.0);
+    if(g2 >= 0) {norm = 1 / (1 + sqrt(2) * K + K * K);
+                 f[2] = {(V + sqrt(2 * V) * K + K * K) * norm, 2 * (K * K - V) * norm, (V - sqrt(2 * V) * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - sqrt(2) * K + K * K) * norm};}
+    else        {norm = 1 / (V + sqrt(2 * V) * K + K * K);
+                 f[2] = {(1 + sqrt(2) * K + K * K) * norm, 2 * (K * K - 1) * norm, (1 - sqrt(2) * K + K * K) * norm, 2 * (K * K - V) * norm, (V - sqrt(2 * V) * K + K * K) * norm};}
+    for(int n = 0; n < 3; n++) f[n] = {(float)f[n].a0, (float)f[n].a1, (float)f[n].a2, (float)f[n].b1, (float)f[n].b2};
+}
+
+struct result_t {double maxErr; double meanErr;};
+
+static result_t runChain(const coef_t f[3], const bool active[3], double sr, uint32_t seed) {
+    // 400 blocks of a swept sine with noise (half scale, the headroom of Audio::processI2Sblock()), L = -R
+    bqChain_t ch;
+    BQ_Init(&ch);
+    for(int n = 0; n < 3; n++) BQ_SetStage(&ch, n, f[n].a0, f[n].a1, f[n].a2, f[n].b1, f[n].b2, active[n]);
+    BQ_Commit(&ch);
+    int16_t buf[512] = {0};
+    BQ_Process(&ch, buf, 256);                      // the cross-fade to the new coefficients runs over one block
+    double st[3][2][4] = {};                        // reference history x1 x2 y1 y2
+    double ph = 0, sum = 0, mx = 0;
+    long cnt = 0;
+    for(int blk = 0; blk < 400; blk++) {
+        double ref[256][2];
+        for(int i = 0; i < 256; i++) {
+            double v = 0.45 * sin(ph) + 0.04 * ((int)(testRand(&seed) % 2001) - 1000) / 1000.0;
+            ph += 2 * M_PI * (60 + blk * 20) / sr;
+            int16_t s = (int16_t)lrint(v * 16383);
+            buf[2 * i] = s;
+            buf[2 * i + 1] = -s;
+            for(int c = 0; c < 2; c++) {
+                double x = buf[2 * i + c];
+                for(int n = 0; n < 3; n++) {
+                    double y = x;
+                    if(active[n]) {
+                        double* S = st[n][c];
+                        y = f[n].a0 * x + f[n].a1 * S[0] + f[n].a2 * S[1] - f[n].b1 * S[2] - f[n].b2 * S[3];
+                        S[1] = S[0]; S[0] = x; S[3] = S[2]; S[2] = y;
+                    }
+                    x = std::max(-32768.0, std::min(32767.0, y));
+                }
+                ref[i][c] = x;
+            }
+        }
+        BQ_Process(&ch, buf, 256);
+        for(int i = 0; i < 256; i++) for(int c = 0; c < 2; c++) {
+            double e = buf[2 * i + c] - ref[i][c];
+            sum += e;
+            cnt++;
+            mx = std::max(mx, fabs(e));
+        }
+    }
+    return {mx, sum / cnt};
+}
+
+static const double rates[] = {16000, 22050, 32000, 44100, 48000};
+static const int    gains[] = {-40, -20, -6, -1, 1, 3, 6};
+
+void test_single_stage_error_bound() {
+    double worst = 0;
+    for(double sr : rates) for(int n = 0; n < 3; n++) for(int g : gains) {
+        coef_t f[3];
+        toneCoefficients(f, n == 0 ? g : 0, n == 1 ? g : 0, n == 2 ? g : 0, sr);
+        bool active[3] = {n == 0, n == 1, n == 2};
+        result_t r = runChain(f, active, sr, 1 + n * 100 + g);
+        worst = std::max(worst, r.maxErr);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "stage %d, %g Hz, %d dB: max %.3f LSB, mean %.4f", n, sr, g, r.maxErr, r.meanErr);
+        TEST_ASSERT_TRUE_MESSAGE(r.maxErr <= 0.51, msg);
+        TEST_ASSERT_TRUE_MESSAGE(fabs(r.meanErr) < 0.01, msg);
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "worst single stage error %.3f LSB", worst);
+    TEST_MESSAGE(msg);
+}
+
+void test_cascade_error_bound() {
+    double worst = 0;
+    uint32_t pick = 1;
+    for(double sr : rates) for(int g0 : gains) for(int g1 : gains) for(int g2 : gains) {
+        if(testRand(&pick) % 4) continue;           // a quarter of the combinations
+        coef_t f[3];
+        toneCoefficients(f, g0, g1, g2, sr);
+        bool active[3] = {true, true, true};
+        result_t r = runChain(f, active, sr, pick);
+        worst = std::max(worst, r.maxErr);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%g Hz, %d/%d/%d dB: max %.3f LSB, mean %.4f", sr, g0, g1, g2, r.maxErr, r.meanErr);
+        TEST_ASSERT_TRUE_MESSAGE(r.maxErr <= 3.0, msg);
+        TEST_ASSERT_TRUE_MESSAGE(fabs(r.meanErr) < 0.05, msg);
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "worst cascade error %.3f LSB", worst);
+    TEST_MESSAGE(msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_stage_error_bound);
+    RUN_TEST(test_cascade_error_bound);
+    return UNITY_END();
+}
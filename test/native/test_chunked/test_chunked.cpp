@@ -0,0 +1,120 @@
+/*
+ * test_chunked.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  "Transfer-Encoding: chunked" decoder (net/chunked): the payload comes out byte identical, whatever the read
+ *  sizes are, with and without ICY_Demux() (net/icy) behind it.
+ *
+ *  capture.chunked  chunked body of the ICY stream of test_icy (capture.icy, audio capture.mp3): sizes in lower and
+ *                   upper case hex, chunk extensions, chunks of 1 and 17 bytes, a trailer after the last chunk
+ *  fuzz             random chunk sizes and ICY blocks, read in random pieces, the end is found
+ */
+#include <unity.h>
+#include <algorithm>
+#include <string>
+#include "testdata.h"
+#include "net/chunked.cpp"
+#include "net/icy.cpp"
+
+static std::vector<uint8_t> decode(const std::vector<uint8_t>& wire, uint32_t metaint, uint32_t* seed,
+                                   uint32_t maxRead, chunked_t* ck) {
+    // reads of 1...maxRead bytes, seed NULL: one byte at a time
+    static icyDemux_t d;
+    CK_Reset(ck);
+    ICY_Reset(&d, metaint, NULL, NULL);
+    std::vector<uint8_t> buf(wire), out;
+    size_t p = 0;
+    while(p < buf.size()) {
+        size_t n = std::min<size_t>(seed ? 1 + testRand(seed) % maxRead : 1, buf.size() - p);
+        uint32_t k = ICY_Demux(&d, buf.data() + p, CK_Decode(ck, buf.data() + p, n));
+        out.insert(out.end(), buf.begin() + p, buf.begin() + p + k);
+        p += n;
+    }
+    return out;
+}
+
+void test_capture_byte_identity() {
+    std::vector<uint8_t> wire  = loadTestFile(__FILE__, "capture.chunked");
+    std::vector<uint8_t> body  = loadTestFile(__FILE__, "../test_icy/capture.icy");
+    std::vector<uint8_t> audio = loadTestFile(__FILE__, "../test_icy/capture.mp3");
+    TEST_ASSERT_FALSE(wire.empty() || body.empty() || audio.empty());
+    chunked_t ck;
+    uint32_t seed = 1;
+    for(int run = 0; run < 200; run++) {
+        uint32_t* s = run == 0 ? NULL : &seed;
+        uint32_t  maxRead = run < 100 ? 64 : 20000;
+        char msg[64];
+        snprintf(msg, sizeof(msg), "run %d", run);
+        TEST_ASSERT_TRUE_MESSAGE(decode(wire, 0, s, maxRead, &ck) == body, msg);      // chunked only
+        TEST_ASSERT_EQUAL_MESSAGE(CK_DONE, ck.state, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(15, ck.chunks, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(4096, ck.first, msg);
+        TEST_ASSERT_TRUE_MESSAGE(decode(wire, 8192, s, maxRead, &ck) == audio, msg);  // and ICY
+    }
+}
+
+void test_fuzz_chunks_and_splits() {
+    for(uint32_t run = 1; run <= 200; run++) {
+        uint32_t seed = run;
+        uint32_t mi = run % 3 ? 0 : 8192;
+        std::vector<uint8_t> audio, body, wire;
+        for(int i = 0; i < 300000; i++) audio.push_back(testRand(&seed));
+        size_t a = 0;                               // body: audio with ICY blocks
+        while(a < audio.size()) {
+            size_t n = mi ? std::min<size_t>(mi, audio.size() - a) : audio.size() - a;
+            body.insert(body.end(), audio.begin() + a, audio.begin() + a + n);
+            a += n;
+            if(mi && n == mi) {
+                std::string m = "StreamTitle='x';";
+                body.push_back(1);
+                body.insert(body.end(), m.begin(), m.end());
+            }
+        }
+        size_t p = 0;                               // wire: the body in chunks
+        uint32_t chunks = 0;
+        while(p < body.size()) {
+            size_t n = std::min<size_t>(1 + testRand(&seed) % (run % 2 ? 4096 : 40000), body.size() - p);
+            char h[32];
+            int hl = snprintf(h, sizeof(h), run % 5 ? "%zx\r\n" : "%zX;ext=1\r\n", n);
+            wire.insert(wire.end(), h, h + hl);
+            wire.insert(wire.end(), body.begin() + p, body.begin() + p + n);
+            wire.push_back('\r');
+            wire.push_back('\n');
+            p += n;
+            chunks++;
+        }
+        std::string tail = run % 4 ? "0\r\n\r\n" : "0\r\nX-Trailer: 1\r\n\r\n";
+        wire.insert(wire.end(), tail.begin(), tail.end());
+        chunked_t ck;
+        std::vector<uint8_t> out = decode(wire, mi, &seed, 16000, &ck);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "run %u: %u chunks, metaint %u", run, chunks, mi);
+        TEST_ASSERT_TRUE_MESSAGE(out == audio, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(CK_DONE, ck.state, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(chunks, ck.chunks, msg);
+    }
+}
+
+void test_nothing_after_the_last_chunk() {
+    std::string wire = "5\r\nhello\r\n0\r\n\r\nHTTP/1.1 200 OK\r\n";
+    std::vector<uint8_t> buf(wire.begin(), wire.end());
+    chunked_t ck;
+    CK_Reset(&ck);
+    uint32_t n = CK_Decode(&ck, buf.data(), buf.size());
+    TEST_ASSERT_EQUAL(5, n);
+    TEST_ASSERT_TRUE(memcmp(buf.data(), "hello", 5) == 0);
+    TEST_ASSERT_EQUAL(CK_DONE, ck.state);
+    TEST_ASSERT_EQUAL(0, CK_Decode(&ck, buf.data(), buf.size()));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_byte_identity);
+    RUN_TEST(test_fuzz_chunks_and_splits);
+    RUN_TEST(test_nothing_after_the_last_chunk);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+/*
+ * test_crossfade.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Equal power crossfade (dsp/crossfade) as Audio::xfadeMix() and xfadePump() use it: the gains over the whole fade
+ *  (gOld^2 + gNew^2 = 1, the sine against sin()), the level of two unrelated streams through the fade, the
+ *  saturation of correlated ones, the length of a fade, and the new stream bit exact once the fade is done (from
+ *  there xfadeEnd() detaches the old source, XF_Mix() must not touch a sample).
+ */
+#include <unity.h>
+#include "testdata.h"
+#include "dsp/crossfade.cpp"
+
+#define XF_END      ((uint32_t)XF_STEPS << XF_FRAC_BITS)
+
+static void tone(int16_t* buf, uint32_t from, uint16_t frames, double hz, double amp) {
+    for(uint16_t i = 0; i < frames; i++)
+        buf[2 * i] = buf[2 * i + 1] = (int16_t)lrint(amp * sin(2 * M_PI * hz * (from + i) / 48000));
+}
+
+void test_equal_power() {
+    // every position of the fade (the gains change every 32 Q20 steps): gOld^2 + gNew^2 in 0.9999...1.0001, the sine
+    // within one Q15 step
+    xfade_t xf;
+    XF_Init(&xf, 1000);
+    double lo = 2, hi = 0, maxErr = 0;
+    for(uint32_t phase = 0; phase <= XF_END; phase += 32) {
+        double gNew = xf_gain(phase) / 32768.0, gOld = xf_gain(XF_END - phase) / 32768.0;
+        double p = gNew * gNew + gOld * gOld;
+        if(p < lo) lo = p;
+        if(p > hi) hi = p;
+        double e = fabs(gNew - sin(M_PI_2 * phase / XF_END));
+        if(e > maxErr) maxErr = e;
+    }
+    char msg[100];
+    snprintf(msg, sizeof(msg), "gOld^2 + gNew^2: %.6f...%.6f, sine error %.2e", lo, hi, maxErr);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(lo >= 0.9999 && hi <= 1.0001, msg);
+    TEST_ASSERT_TRUE_MESSAGE(maxErr < 3.2e-5, msg);
+    TEST_ASSERT_EQUAL(0, xf_gain(0));
+    TEST_ASSERT_EQUAL(32768, xf_gain(XF_END));
+    TEST_ASSERT_EQUAL(32768, xf_gain(XF_END + 12345));              // past the end
+}
+
+void test_level_through_the_fade() {
+    // two unrelated programmes of the same level (1 kHz and 1.5 kHz, whole periods in every 10 ms block): the sum keeps
+    // the level within 0.05 dB over the fade, a linear fade would dip by 3 dB in the middle
+    const uint32_t frames = 48000;                                   // 1 s at 48 kHz
+    const uint16_t block = 480;
+    xfade_t xf;
+    XF_Init(&xf, frames);
+    int16_t o[2 * block], n[2 * block];
+    double lo = 99, hi = -99;
+    for(uint32_t f = 0; f < frames; f += block) {
+        tone(o, f, block, 1000, 16000);
+        tone(n, f, block, 1500, 16000);
+        double in = 0, out = 0;
+        for(int i = 0; i < 2 * block; i++) in += (double)o[i] * o[i];
+        XF_Mix(&xf, n, o, block);
+        for(int i = 0; i < 2 * block; i++) out += (double)n[i] * n[i];
+        double db = 10 * log10(out / in);
+        if(db < lo) lo = db;
+        if(db > hi) hi = db;
+    }
+    char msg[80];
+    snprintf(msg, sizeof(msg), "level over the fade %+.4f...%+.4f dB", lo, hi);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(lo > -0.05 && hi < 0.05, msg);
+}
+
+void test_saturation() {
+    // the same signal in both, in the middle of the fade: +3 dB, full scale is saturated, not wrapped
+    xfade_t xf;
+    XF_Init(&xf, 2);
+    xf.phase = XF_END / 2;
+    xf.step = 0;                                                     // both frames in the middle
+    int16_t o[4] = {32767, -32768, 20000, -20000}, n[4] = {32767, -32768, 20000, -20000};
+    XF_Mix(&xf, n, o, 2);
+    TEST_ASSERT_EQUAL(32767, n[0]);
+    TEST_ASSERT_EQUAL(-32768, n[1]);
+    TEST_ASSERT_INT_WITHIN(2, 28284, n[2]);                          // 20000 * 2 * sin(pi/4)
+    TEST_ASSERT_INT_WITHIN(2, -28284, n[3]);
+}
+
+void test_fade_length() {
+    // XF_Done() after the frames of XF_Init() (the step rounds down: at most 1/1000 later), the first frame is the old
+    // stream alone
+    const uint32_t lens[5] = {1, 441, 24000, 96000, 240000};        // up to 5 s at 48 kHz
+    for(uint32_t len : lens) {
+        xfade_t xf;
+        XF_Init(&xf, len);
+        int16_t o[2] = {1000, -1000}, n[2] = {3000, -3000};
+        XF_Mix(&xf, n, o, 1);
+        TEST_ASSERT_EQUAL(1000, n[0]);
+        TEST_ASSERT_EQUAL(-1000, n[1]);
+        uint32_t done = 1;
+        while(!XF_Done(&xf)) {
+            n[0] = n[1] = 0;
+            XF_Mix(&xf, n, o, 1);
+            done++;
+        }
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%u frames: done after %u", len, done);
+        TEST_ASSERT_TRUE_MESSAGE(done >= len && done <= len + len / 1000 + 1, msg);
+    }
+}
+
+void test_pass_through_after_the_fade() {
+    // mixed in blocks as xfadeMix() does, the block that ends the fade included: from the first frame at the end of
+    // the fade on, the new stream comes out bit exact, whatever the old source holds; XF_Old() gives silence
+    const uint32_t frames = 4410;
+    const uint16_t block = 128;
+    xfade_t xf;
+    XF_Init(&xf, frames);
+    uint32_t seed = 5;
+    int16_t o[2 * block], n[2 * block], ref[2 * block];
+    uint32_t f = 0, exact = 0;
+    for(; f < frames + 10 * block; f += block) {
+        for(int i = 0; i < 2 * block; i++) {o[i] = (int16_t)testRand(&seed); n[i] = ref[i] = (int16_t)testRand(&seed);}
+        uint32_t phase = xf.phase;
+        XF_Mix(&xf, n, o, block);
+        for(uint16_t i = 0; i < block; i++, phase += xf.step) {
+            if(phase < XF_END) continue;                             // still fading
+            TEST_ASSERT_EQUAL_MEMORY(&ref[2 * i], &n[2 * i], 4);
+            exact++;
+        }
+    }
+    TEST_ASSERT_TRUE(XF_Done(&xf));
+    TEST_ASSERT_TRUE(exact >= 10 * block);
+    // every sample value, left the negative, right the positive half
+    static int16_t all[2 * 32768], out[2 * 32768], zero[2 * 32768];
+    for(int i = 0; i < 32768; i++) {all[2 * i] = (int16_t)(i - 32768); all[2 * i + 1] = (int16_t)i;}
+    memcpy(out, all, sizeof(out));
+    XF_Mix(&xf, out, all, 32768);                                    // the old source is anything
+    TEST_ASSERT_EQUAL_MEMORY(all, out, sizeof(all));
+    XF_Old(&xf, out, 32768);
+    TEST_ASSERT_EQUAL_MEMORY(zero, out, sizeof(zero));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_equal_power);
+    RUN_TEST(test_level_through_the_fade);
+    RUN_TEST(test_saturation);
+    RUN_TEST(test_fade_length);
+    RUN_TEST(test_pass_through_after_the_fade);
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/*
+ * test_flac.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  FLAC decoder instances (flac_decoder, FLACCreate()): two streams decoded at the same time, interleaved block by
+ *  block and in two threads, give the PCM of the single default instance (FLACDecoder_AllocateBuffers(),
+ *  FLACDecode()) bit for bit. FLACDecoder_Detach() hands a running default instance over, it goes on with its stream
+ *  while a new default instance decodes another one. The streams are given in windows of 16000 bytes, as
+ *  Audio::sendBytes() does.
+ *
+ *  a.flac  libsndfile (libFLAC), 44.1 kHz stereo, 16 bit, 0.5 s
+ *  b.flac  libsndfile (libFLAC), 48 kHz mono, 16 bit, 1 s
+ */
+#include <unity.h>
+#include <thread>
+#include "testdata.h"
+#include "flac_decoder/flac_decoder.cpp"
+
+struct job_t {
+    std::vector<uint8_t> in;
+    size_t               pos = 0;
+    std::vector<int16_t> out;
+    FLACDecoder*         dec = NULL;                // NULL: the default instance
+    int8_t               err = ERR_FLAC_NONE;       // the error that ended the stream
+    uint8_t              channels = 2;              // from STREAMINFO
+    short                pcm[2 * 2048];
+};
+
+static void load(job_t* j, const char* name) {
+    // "fLaC" and the metadata blocks are skipped, Audio reads them itself
+    j->in = loadTestFile(__FILE__, name);
+    j->pos = 0;
+    j->out.clear();
+    j->err = ERR_FLAC_NONE;
+    if(j->in.size() < 8) {j->err = ERR_FLAC_SYNC_CODE_NOT_FOUND; return;}
+    size_t p = 4;
+    bool last = false;
+    while(!last && p + 4 + 13 <= j->in.size()) {
+        last = j->in[p] & 0x80;
+        if((j->in[p] & 0x7F) == 0) j->channels = ((j->in[p + 4 + 12] >> 1) & 7) + 1;
+        p += 4 + (j->in[p + 1] << 16 | j->in[p + 2] << 8 | j->in[p + 3]);
+    }
+    j->pos = p;
+    j->in.resize(j->in.size() + 64);                // the decoder reads a few bytes ahead
+}
+
+static bool step(job_t* j) {
+    // one output block of up to 2048 samples, false at the end of the stream or on an error
+    if(j->err != ERR_FLAC_NONE || j->pos >= j->in.size() - 64) return false;
+    int len = std::min<size_t>(j->in.size() - 64 - j->pos, 16000);
+    int bytesLeft = len;
+    int8_t ret = j->dec ? FLACDecode(j->dec, &j->in[j->pos], &bytesLeft, j->pcm)
+                        : FLACDecode(&j->in[j->pos], &bytesLeft, j->pcm);
+    if(ret < 0) {j->err = ret; return false;}
+    int n = j->dec ? FLACGetOutputSamps(j->dec) : FLACGetOutputSamps();
+    for(int i = 0; i < n / j->channels; i++)       // the output is always two channels wide
+        for(int c = 0; c < j->channels; c++) j->out.push_back(j->pcm[2 * i + c]);
+    if(ret == ERR_FLAC_NONE) j->pos += len - bytesLeft;   // GIVE_NEXT_LOOP: the rest of the block is pending
+    return true;
+}
+
+static std::vector<int16_t> single(const char* name) {
+    // empty if the buffers can't be allocated or the stream doesn't decode
+    static job_t j;
+    load(&j, name);
+    if(!FLACDecoder_AllocateBuffers()) return {};
+    while(step(&j)) {}
+    FLACDecoder_FreeBuffers();
+    if(j.err != ERR_FLAC_NONE) return {};
+    return j.out;
+}
+
+static job_t a, b;
+
+void test_interleaved() {
+    std::vector<int16_t> ra = single("a.flac"), rb = single("b.flac");
+    TEST_ASSERT_TRUE(ra.size() >= 44100 && rb.size() >= 48000);
+    load(&a, "a.flac");
+    load(&b, "b.flac");
+    a.dec = FLACCreate();
+    b.dec = FLACCreate();
+    TEST_ASSERT_TRUE(a.dec && b.dec);
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    FLACDestroy(a.dec);
+    FLACDestroy(b.dec);
+    TEST_ASSERT_EQUAL(ERR_FLAC_NONE, a.err);
+    TEST_ASSERT_EQUAL(ERR_FLAC_NONE, b.err);
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void test_threads() {
+    std::vector<int16_t> ra = single("a.flac"), rb = single("b.flac");
+    for(int run = 0; run < 4; run++) {
+        load(&a, "a.flac");
+        load(&b, "b.flac");
+        a.dec = FLACCreate();
+        b.dec = FLACCreate();
+        std::thread ta([] {while(step(&a)) {}});
+        std::thread tb([] {while(step(&b)) {}});
+        ta.join();
+        tb.join();
+        FLACDestroy(a.dec);
+        FLACDestroy(b.dec);
+        TEST_ASSERT_EQUAL(ERR_FLAC_NONE, a.err);
+        TEST_ASSERT_EQUAL(ERR_FLAC_NONE, b.err);
+        TEST_ASSERT_TRUE(a.out == ra);
+        TEST_ASSERT_TRUE(b.out == rb);
+    }
+}
+
+void test_detach() {
+    // a begins in the default instance, which is detached after 5 blocks; b in a new default instance
+    std::vector<int16_t> ra = single("a.flac"), rb = single("b.flac");
+    load(&a, "a.flac");
+    load(&b, "b.flac");
+    a.dec = b.dec = NULL;
+    TEST_ASSERT_TRUE(FLACDecoder_AllocateBuffers());
+    for(int i = 0; i < 5; i++) TEST_ASSERT_TRUE(step(&a));
+    a.dec = FLACDecoder_Detach();
+    TEST_ASSERT_NOT_NULL(a.dec);
+    TEST_ASSERT_TRUE(FLACDecoder_AllocateBuffers());
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    FLACDestroy(a.dec);
+    FLACDecoder_FreeBuffers();
+    TEST_ASSERT_EQUAL(ERR_FLAC_NONE, a.err);
+    TEST_ASSERT_EQUAL(ERR_FLAC_NONE, b.err);
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_interleaved);
+    RUN_TEST(test_threads);
+    RUN_TEST(test_detach);
+    return UNITY_END();
+}
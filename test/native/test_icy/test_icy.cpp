@@ -0,0 +1,114 @@
+/*
+ * test_icy.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  ICY metadata demultiplexer (net/icy): the audio bytes come out byte identical to the stream without metadata and
+ *  onMeta reports every title change once, whatever the read sizes are.
+ *
+ *  capture.icy  icy-metaint 8192 stream as a server sends it (the audio is capture.mp3), with empty blocks, a
+ *               repeated title and a title with UTF-8 and a StreamUrl
+ *  fuzz         random audio with metaint 1...32768, titles, empty blocks and blocks longer than ICY_META_MAX,
+ *               read in random pieces
+ */
+#include <unity.h>
+#include <algorithm>
+#include <string>
+#include "testdata.h"
+#include "net/icy.cpp"
+
+static std::vector<std::string> events;
+
+static void onMeta(void*, const char* meta) {
+    events.push_back(meta);
+}
+
+static std::vector<uint8_t> demux(const std::vector<uint8_t>& stream, uint32_t metaint, uint32_t* seed,
+                                  uint32_t maxRead) {
+    // reads of 1...maxRead bytes, seed NULL: one byte at a time
+    static icyDemux_t d;
+    ICY_Reset(&d, metaint, onMeta, NULL);
+    events.clear();
+    std::vector<uint8_t> buf(stream), out;
+    size_t p = 0;
+    while(p < buf.size()) {
+        size_t n = std::min<size_t>(seed ? 1 + testRand(seed) % maxRead : 1, buf.size() - p);
+        uint32_t k = ICY_Demux(&d, buf.data() + p, n);
+        out.insert(out.end(), buf.begin() + p, buf.begin() + p + k);
+        p += n;
+    }
+    return out;
+}
+
+void test_capture_byte_identity() {
+    std::vector<uint8_t> stream = loadTestFile(__FILE__, "capture.icy");
+    std::vector<uint8_t> audio = loadTestFile(__FILE__, "capture.mp3");
+    TEST_ASSERT_FALSE(stream.empty() || audio.empty());
+    std::vector<std::string> titles = {
+        "StreamTitle='Radio Test - Morning Show';StreamUrl='';",
+        "StreamTitle='Artist \xc3\x9c - Title (Live)';StreamUrl='http://example.org/cover.jpg';",
+    };
+    uint32_t seed = 1;
+    for(int run = 0; run < 200; run++) {
+        std::vector<uint8_t> out = run == 0 ? demux(stream, 8192, NULL, 0)
+                                 : demux(stream, 8192, &seed, run < 100 ? 64 : 20000);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "run %d: %zu audio bytes, %zu events", run, out.size(), events.size());
+        TEST_ASSERT_TRUE_MESSAGE(out == audio, msg);
+        TEST_ASSERT_TRUE_MESSAGE(events == titles, msg);
+    }
+}
+
+void test_fuzz_metaint_and_splits() {
+    static const uint32_t metaints[] = {1, 7, 16, 255, 8192, 16000, 32768};
+    for(uint32_t mi : metaints) for(uint32_t run = 1; run <= 20; run++) {
+        uint32_t seed = run * 977 + mi;
+        std::vector<uint8_t> audio, stream;
+        std::vector<std::string> want;
+        std::string last;
+        size_t total = (mi < 256 ? 20000 : 200000) + testRand(&seed) % 50000;   // small metaint: less audio
+        for(size_t i = 0; i < total; i++) audio.push_back(testRand(&seed));
+        size_t a = 0;
+        for(int blk = 0; a < audio.size(); blk++) {
+            size_t n = std::min<size_t>(mi, audio.size() - a);
+            stream.insert(stream.end(), audio.begin() + a, audio.begin() + a + n);
+            a += n;
+            if(n < mi) break;
+            std::string m;
+            switch(testRand(&seed) % 5) {
+                case 1: m = "StreamTitle='Song " + std::to_string(blk / 3) + "';StreamUrl='';"; break;
+                case 2: m = std::string(600 + testRand(&seed) % 3480, 'x'); break;   // longer than ICY_META_MAX
+                case 3: m = "StreamTitle='" + std::string(400, 'a' + blk % 26) + "';"; break;
+                default: break;                                                      // empty block
+            }
+            size_t l = (m.size() + 15) / 16;
+            stream.push_back(l);
+            stream.insert(stream.end(), m.begin(), m.end());
+            stream.resize(stream.size() + l * 16 - m.size(), 0);
+            if(!m.empty() && m.size() <= ICY_META_MAX && m != last) { want.push_back(m); last = m; }
+        }
+        std::vector<uint8_t> out = demux(stream, mi, &seed, 20000);
+        char msg[80];
+        snprintf(msg, sizeof(msg), "metaint %u, run %u: audio %s, %zu of %zu events", mi, run,
+                 out == audio ? "identical" : "differs", events.size(), want.size());
+        TEST_ASSERT_TRUE_MESSAGE(out == audio && events == want, msg);
+    }
+}
+
+void test_no_metadata() {
+    std::vector<uint8_t> audio = loadTestFile(__FILE__, "capture.mp3");
+    uint32_t seed = 5;
+    TEST_ASSERT_TRUE(demux(audio, 0, &seed, 5000) == audio);
+    TEST_ASSERT_TRUE(events.empty());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_byte_identity);
+    RUN_TEST(test_fuzz_metaint_and_splits);
+    RUN_TEST(test_no_metadata);
+    return UNITY_END();
+}
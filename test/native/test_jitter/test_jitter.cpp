@@ -0,0 +1,250 @@
+/*
+ * test_jitter.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Jitter buffer controller (net/jitter): the estimator, the target depth rules and a simulation of a web stream.
+ *
+ *  The simulation runs in steps of 1 ms: a server paced at 128 kbit/s sends TCP segments of 1460 bytes and holds now
+ *  and then (no data, the backlog follows at once), the socket keeps up to 16 kB. The loop of
+ *  Audio::processWebStream() is followed: JB_Arrival() on the socket level, a read limited by JB_ReadLimit() to
+ *  maxFrameSize (1600), JB_Ready(), JB_Decode(), a frame of 418 bytes (MP3, 26.1 ms) is decoded while InBuff holds
+ *  maxFrameSize and the PCM ring (4096 frames, 93 ms) has room. The output drains the ring in real time, an empty ring
+ *  while playing is a gap. The old path started at one frame, read one frame per loop and decoded whenever it could.
+ */
+#include <unity.h>
+#include "testdata.h"
+#include "net/jitter.cpp"
+
+#define RATE        16000           // bytes per second, 128 kbit/s
+#define SEGMENT     1460
+#define SOCKET_MAX  16384
+#define MAX_FRAME   1600            // InBuff.getMaxBlockSize()
+#define FRAME       418
+#define FRAME_US    26125           // FRAME at RATE
+#define RING_US     92880           // AUDIO_RING_FRAMES at 44.1 kHz
+#define CAPACITY    300000          // InBuff in PSRAM
+
+struct sim_t {
+    uint32_t gaps, gapMs, longestGap, startMs, underruns, targetMs, jitterMs;
+};
+
+static sim_t simulate(bool jitterBuffer, uint32_t seconds, uint32_t maxHoldMs, uint32_t burst, uint32_t seed) {
+    jitterBuf_t jb;
+    JB_Reset(&jb, 200, 8000, CAPACITY, 0);
+    sim_t r = {};
+    uint64_t sent = 0, due = burst;
+    uint32_t sock = 0, filled = 0, holdUntil = 0;
+    int64_t  ringUs = 0;
+    bool     started = false, playing = false, inGap = false;
+    uint32_t gapStart = 0;
+    for(uint32_t t = 0; t < seconds * 1000; t++) {
+        // server
+        due += RATE / 1000;
+        if(maxHoldMs && testRand(&seed) % 3000 == 0) holdUntil = t + testRand(&seed) % (maxHoldMs + 1);
+        if(t >= holdUntil)
+            while(sent + SEGMENT <= due && sock + SEGMENT <= SOCKET_MAX) {sent += SEGMENT; sock += SEGMENT;}
+        // player loop
+        uint32_t n = sock;
+        if(jitterBuffer) {
+            JB_Arrival(&jb, sock, RATE, t);
+            if(JB_ReadLimit(&jb, filled, MAX_FRAME) != UINT32_MAX && n > MAX_FRAME) n = MAX_FRAME;
+        }
+        else if(n > MAX_FRAME) n = MAX_FRAME;
+        if(n > CAPACITY - filled) n = CAPACITY - filled;
+        sock -= n;
+        filled += n;
+        if(jitterBuffer) JB_Read(&jb, n);
+        if(!started) {
+            started = jitterBuffer ? JB_Ready(&jb, filled, MAX_FRAME) : filled > MAX_FRAME;
+            if(started) r.startMs = t;
+        }
+        for(int k = 0; started && k < 4 && ringUs + FRAME_US <= RING_US; k++) {
+            if(jitterBuffer && !JB_Decode(&jb, filled, MAX_FRAME, true, t)) break;
+            if(filled < MAX_FRAME) break;
+            filled -= FRAME;
+            ringUs += FRAME_US;
+            playing = true;
+        }
+        // output
+        if(!playing) continue;
+        if(ringUs > 0) {
+            ringUs -= 1000;
+            if(ringUs < 0) ringUs = 0;
+            if(inGap) {
+                uint32_t g = t - gapStart;
+                r.gapMs += g;
+                if(g > r.longestGap) r.longestGap = g;
+                inGap = false;
+            }
+        }
+        else if(!inGap) {
+            inGap = true;
+            gapStart = t;
+            r.gaps++;
+        }
+    }
+    r.underruns = jb.underruns;
+    r.targetMs  = jb.targetMs;
+    r.jitterMs  = JB_JitterMs(&jb);
+    return r;
+}
+
+static void report(const char* name, const sim_t& s) {
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%-24s start %4u ms, %3u gaps, %5u ms in total, longest %4u ms, target %4u ms, jitter %u ms",
+             name, s.startMs, s.gaps, s.gapMs, s.longestGap, s.targetMs, s.jitterMs);
+    TEST_MESSAGE(msg);
+}
+
+void test_estimator() {
+    // paced segments: no jitter; segments late by 0...200 ms: the mean lateness
+    jitterBuf_t jb;
+    JB_Reset(&jb, 200, 8000, CAPACITY, 0);
+    uint32_t sock = 0, seed = 3;
+    for(uint32_t i = 0; i < 200; i++) {                 // one segment every 91.25 ms
+        sock += SEGMENT;
+        JB_Arrival(&jb, sock, RATE, i * 9125 / 100);
+        JB_Read(&jb, SEGMENT);
+        sock = 0;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, JB_JitterMs(&jb));
+    TEST_ASSERT_EQUAL_UINT32(200, jb.targetMs);
+    TEST_ASSERT_UINT32_WITHIN(RATE / 50, RATE, jb.throughput);
+    uint32_t t0 = 200 * 9125 / 100;
+    for(uint32_t i = 0; i < 2000; i++) {
+        sock += SEGMENT;
+        JB_Arrival(&jb, sock, RATE, t0 + i * 9125 / 100 + testRand(&seed) % 201);
+        JB_Read(&jb, SEGMENT);
+        sock = 0;
+    }
+    // lateness uniform in 0...200 ms: E[max(0, x - y)] = 200 / 6 = 33 ms, the target stays at the start depth
+    char msg[64];
+    snprintf(msg, sizeof(msg), "jitter %u ms, target %u ms", JB_JitterMs(&jb), jb.targetMs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_UINT32_WITHIN_MESSAGE(10, 33, JB_JitterMs(&jb), msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(200, jb.targetMs, msg);
+    for(uint32_t i = 0; i < 2000; i++) {                // 0...400 ms: 67 ms, the target follows the peaks of 4 x jitter
+        sock += SEGMENT;
+        JB_Arrival(&jb, sock, RATE, t0 + 200000 + i * 9125 / 100 + testRand(&seed) % 401);
+        JB_Read(&jb, SEGMENT);
+        sock = 0;
+    }
+    snprintf(msg, sizeof(msg), "jitter %u ms, target %u ms", JB_JitterMs(&jb), jb.targetMs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_UINT32_WITHIN_MESSAGE(20, 67, JB_JitterMs(&jb), msg);
+    TEST_ASSERT_TRUE_MESSAGE(jb.targetMs >= JB_JITTER_FACTOR * JB_JitterMs(&jb) && jb.targetMs < 1000, msg);
+}
+
+void test_burst_is_not_jitter() {
+    // 64 kB at once, then paced: early arrivals count as 0
+    jitterBuf_t jb;
+    JB_Reset(&jb, 200, 8000, CAPACITY, 0);
+    uint32_t sock = 0;
+    for(uint32_t i = 0; i < 45; i++) JB_Arrival(&jb, sock += SEGMENT, RATE, i / 4);
+    JB_Read(&jb, sock);
+    sock = 0;
+    for(uint32_t i = 0; i < 100; i++) {
+        JB_Arrival(&jb, SEGMENT, RATE, 12 + i * 9125 / 100);
+        JB_Read(&jb, SEGMENT);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, JB_JitterMs(&jb));
+    TEST_ASSERT_EQUAL_UINT32(200, jb.targetMs);
+}
+
+void test_target_rules() {
+    jitterBuf_t jb;
+    JB_Reset(&jb, 200, 8000, CAPACITY, 0);
+    uint32_t target = RATE / 5;                         // 200 ms
+    TEST_ASSERT_FALSE(JB_Ready(&jb, MAX_FRAME, MAX_FRAME));     // more than one frame
+    TEST_ASSERT_FALSE(JB_Ready(&jb, target - 1, MAX_FRAME));
+    TEST_ASSERT_TRUE(JB_Ready(&jb, target + MAX_FRAME, MAX_FRAME));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, JB_ReadLimit(&jb, target - 1, MAX_FRAME));
+    TEST_ASSERT_EQUAL_UINT32(MAX_FRAME, JB_ReadLimit(&jb, target, MAX_FRAME));
+    TEST_ASSERT_TRUE(JB_Decode(&jb, MAX_FRAME, MAX_FRAME, true, 1000));
+    TEST_ASSERT_TRUE(JB_Decode(&jb, 10, MAX_FRAME, false, 1000));       // a file runs out, no underrun
+    // underrun: +500 ms (at least), then half
+    TEST_ASSERT_FALSE(JB_Decode(&jb, MAX_FRAME - 1, MAX_FRAME, true, 1000));
+    TEST_ASSERT_EQUAL_UINT32(700, jb.targetMs);
+    TEST_ASSERT_EQUAL_UINT32(1, jb.underruns);
+    TEST_ASSERT_FALSE(JB_Decode(&jb, RATE * 699 / 1000, MAX_FRAME, true, 1100)); // waits for the target depth
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, JB_ReadLimit(&jb, RATE, MAX_FRAME));    // and reads in full meanwhile
+    TEST_ASSERT_TRUE(JB_Decode(&jb, RATE * 700 / 1000, MAX_FRAME, true, 1200));
+    TEST_ASSERT_FALSE(JB_Decode(&jb, 0, MAX_FRAME, true, 2000));
+    TEST_ASSERT_EQUAL_UINT32(1200, jb.targetMs);
+    TEST_ASSERT_FALSE(JB_Decode(&jb, RATE * 1199 / 1000, MAX_FRAME, true, 2000));
+    TEST_ASSERT_TRUE(JB_Decode(&jb, RATE * 1200 / 1000, MAX_FRAME, true, 2000));
+    // stable: after 30 s -250 ms, then every 10 s, down to the start depth
+    uint32_t t = 2000;
+    while(t < 2000 + JB_STABLE_MS - 1000) JB_Arrival(&jb, 0, RATE, t += 1000);
+    TEST_ASSERT_EQUAL_UINT32(1200, jb.targetMs);
+    JB_Arrival(&jb, 0, RATE, t += 1000);
+    TEST_ASSERT_EQUAL_UINT32(950, jb.targetMs);
+    while(t < 2000 + JB_STABLE_MS + JB_SHRINK_EVERY_MS - 1000) JB_Arrival(&jb, 0, RATE, t += 1000);
+    TEST_ASSERT_EQUAL_UINT32(950, jb.targetMs);
+    JB_Arrival(&jb, 0, RATE, t += 1000);
+    TEST_ASSERT_EQUAL_UINT32(700, jb.targetMs);
+    for(uint32_t end = t + 100000; t < end;) JB_Arrival(&jb, 0, RATE, t += 1000);
+    TEST_ASSERT_EQUAL_UINT32(200, jb.targetMs);
+    // limits: JITTER_MAX_MS and 3/4 of the buffer
+    for(int i = 0; i < 20; i++) {JB_Decode(&jb, 0, MAX_FRAME, true, t); jb.rebuffer = false;}
+    TEST_ASSERT_EQUAL_UINT32(8000, jb.targetMs);
+    JB_Reset(&jb, 200, 8000, 1600, 0);                  // RAM buffer without PSRAM
+    TEST_ASSERT_EQUAL_UINT32(75, jb.targetMs);
+    JB_Decode(&jb, 0, MAX_FRAME, true, 0);
+    TEST_ASSERT_EQUAL_UINT32(75, jb.targetMs);
+    TEST_ASSERT_TRUE(JB_Ready(&jb, MAX_FRAME, MAX_FRAME - 418));
+}
+
+static void holds(uint32_t maxHoldMs, uint32_t maxGaps) {
+    // 20 runs of 300 s, every run has at most as many gaps as the old path and at most maxGaps
+    sim_t o = {}, n = {};
+    for(uint32_t seed = 1; seed <= 20; seed++) {
+        sim_t so = simulate(false, 300, maxHoldMs, 0, seed), sn = simulate(true, 300, maxHoldMs, 0, seed);
+        char msg[80];
+        snprintf(msg, sizeof(msg), "seed %u: old %u gaps, jitter buffer %u gaps", seed, so.gaps, sn.gaps);
+        TEST_ASSERT_TRUE_MESSAGE(sn.gaps <= so.gaps && sn.gaps <= maxGaps, msg);
+        o.gaps += so.gaps; o.gapMs += so.gapMs; if(so.longestGap > o.longestGap) o.longestGap = so.longestGap;
+        n.gaps += sn.gaps; n.gapMs += sn.gapMs; if(sn.longestGap > n.longestGap) n.longestGap = sn.longestGap;
+        o.startMs = so.startMs; n.startMs = sn.startMs;
+        o.targetMs = so.targetMs; n.targetMs = sn.targetMs;
+    }
+    char name[40];
+    snprintf(name, sizeof(name), "old, holds <= %u ms", maxHoldMs);
+    report(name, o);
+    report("jitter buffer", n);
+    TEST_ASSERT_TRUE(n.gaps < o.gaps);
+}
+
+void test_holds_300ms() {
+    holds(300, 1);                                      // the first hold, then the grown target covers them
+}
+
+void test_holds_1s() {
+    holds(1000, 5);
+}
+
+void test_burst_start() {
+    // 64 kB burst, no holds: no gap, the start is a few ms later at most
+    sim_t o = simulate(false, 60, 0, 65536, 3), n = simulate(true, 60, 0, 65536, 3);
+    report("old, 64 kB burst", o);
+    report("jitter buffer", n);
+    TEST_ASSERT_EQUAL_UINT32(0, o.gaps);
+    TEST_ASSERT_EQUAL_UINT32(0, n.gaps);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(o.startMs + 10, n.startMs);
+    TEST_ASSERT_EQUAL_UINT32(200, n.targetMs);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_estimator);
+    RUN_TEST(test_burst_is_not_jitter);
+    RUN_TEST(test_target_rules);
+    RUN_TEST(test_holds_300ms);
+    RUN_TEST(test_holds_1s);
+    RUN_TEST(test_burst_start);
+    return UNITY_END();
+}
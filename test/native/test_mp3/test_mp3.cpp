@@ -0,0 +1,137 @@
+/*
+ * test_mp3.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  MP3 decoder instances (mp3_decoder, MP3Create()): two streams decoded at the same time, interleaved frame by frame
+ *  and in two threads, give the PCM of the single default instance (MP3Decoder_AllocateBuffers(), MP3Decode()) bit
+ *  for bit. MP3Decoder_Detach() hands a running default instance over, it goes on with its stream while a new
+ *  default instance decodes another one.
+ *
+ *  a.mp3  libmp3lame, 44.1 kHz stereo, 128 kbit/s, 1.5 s
+ *  b.mp3  libmp3lame, 22.05 kHz mono, 48 kbit/s, 2 s
+ */
+#include <unity.h>
+#include <thread>
+#include "testdata.h"
+#include "mp3_decoder/mp3_decoder.cpp"
+
+struct job_t {
+    std::vector<uint8_t> in;
+    size_t               pos = 0;
+    std::vector<int16_t> out;
+    MP3Decoder*          dec = NULL;                // NULL: the default instance
+    short                pcm[2 * 1152];
+};
+
+static void load(job_t* j, const char* name) {
+    j->in = loadTestFile(__FILE__, name);
+    j->in.resize(j->in.size() + 64);                // the decoder reads a few bytes ahead
+    j->pos = 0;
+    j->out.clear();
+}
+
+static bool step(job_t* j) {
+    // one frame, false at the end of the stream
+    while(j->pos < j->in.size() - 64) {
+        int left = j->in.size() - 64 - j->pos;
+        int offs = MP3FindSyncWord(&j->in[j->pos], left);
+        if(offs < 0) return false;
+        j->pos += offs;
+        left -= offs;
+        int bytesLeft = left;
+        int ret = j->dec ? MP3Decode(j->dec, &j->in[j->pos], &bytesLeft, j->pcm, 0)
+                         : MP3Decode(&j->in[j->pos], &bytesLeft, j->pcm, 0);
+        j->pos += left - bytesLeft ? left - bytesLeft : 1;
+        if(ret == ERR_MP3_NONE) {
+            int n = j->dec ? MP3GetOutputSamps(j->dec) : MP3GetOutputSamps();
+            j->out.insert(j->out.end(), j->pcm, j->pcm + n);
+            return true;
+        }
+        if(ret == ERR_MP3_INDATA_UNDERFLOW) return false;
+    }
+    return false;
+}
+
+static std::vector<int16_t> single(const char* name) {
+    // empty if the buffers can't be allocated
+    static job_t j;
+    load(&j, name);
+    if(!MP3Decoder_AllocateBuffers()) return {};
+    while(step(&j)) {}
+    MP3Decoder_FreeBuffers();
+    return j.out;
+}
+
+static job_t a, b;
+
+void test_interleaved() {
+    std::vector<int16_t> ra = single("a.mp3"), rb = single("b.mp3");
+    TEST_ASSERT_TRUE(ra.size() > 44100 * 2 && rb.size() > 22050);
+    load(&a, "a.mp3");
+    load(&b, "b.mp3");
+    a.dec = MP3Create();
+    b.dec = MP3Create();
+    TEST_ASSERT_TRUE(a.dec && b.dec);
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    MP3Destroy(a.dec);
+    MP3Destroy(b.dec);
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void test_threads() {
+    std::vector<int16_t> ra = single("a.mp3"), rb = single("b.mp3");
+    for(int run = 0; run < 4; run++) {
+        load(&a, "a.mp3");
+        load(&b, "b.mp3");
+        a.dec = MP3Create();
+        b.dec = MP3Create();
+        std::thread ta([] {while(step(&a)) {}});
+        std::thread tb([] {while(step(&b)) {}});
+        ta.join();
+        tb.join();
+        MP3Destroy(a.dec);
+        MP3Destroy(b.dec);
+        TEST_ASSERT_TRUE(a.out == ra);
+        TEST_ASSERT_TRUE(b.out == rb);
+    }
+}
+
+void test_detach() {
+    // a begins in the default instance, which is detached after 20 frames; b in a new default instance
+    std::vector<int16_t> ra = single("a.mp3"), rb = single("b.mp3");
+    load(&a, "a.mp3");
+    load(&b, "b.mp3");
+    a.dec = b.dec = NULL;
+    TEST_ASSERT_TRUE(MP3Decoder_AllocateBuffers());
+    for(int i = 0; i < 20; i++) TEST_ASSERT_TRUE(step(&a));
+    a.dec = MP3Decoder_Detach();
+    TEST_ASSERT_NOT_NULL(a.dec);
+    TEST_ASSERT_EQUAL(ERR_MP3_NULL_POINTER, MP3Decode(&b.in[0], NULL, b.pcm, 0));   // no default instance now
+    TEST_ASSERT_TRUE(MP3Decoder_AllocateBuffers());
+    bool ia = true, ib = true;
+    while(ia || ib) {
+        if(ia) ia = step(&a);
+        if(ib) ib = step(&b);
+    }
+    MP3Destroy(a.dec);
+    MP3Decoder_FreeBuffers();
+    TEST_ASSERT_TRUE(a.out == ra);
+    TEST_ASSERT_TRUE(b.out == rb);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_interleaved);
+    RUN_TEST(test_threads);
+    RUN_TEST(test_detach);
+    return UNITY_END();
+}
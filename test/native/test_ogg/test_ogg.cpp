@@ -0,0 +1,382 @@
+/*
+ * test_ogg.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Ogg demultiplexer (container/ogg), driven as Audio::sendBytes() does: windows of the input in random sizes, the
+ *  rest of a window is given again, a decode error or no progress is followed by OGG_FindSyncWord().
+ *
+ *  packets   a test codec records the packets: random sizes, empty packets, multiples of 255 (lacing value 0 at
+ *            the end), packets across two and more pages (continued flag), pages of 1...255 segments, a packet
+ *            larger than the packet buffer; the codec takes a packet in one call, in parts (as FLAC) or several
+ *            times (as the frames of Opus)
+ *  CRC       a damaged page is skipped with the packets in it and the packet that continues from it
+ *  streams   chained streams (a BOS page after the data pages), a chained track of another codec, multiplexed
+ *            streams (two BOS pages in a group), garbage between the pages
+ *  capture   the Vorbis streams of test_vorbis one after the other as a chained stream: the PCM is the one of the
+ *            single streams, bit for bit
+ */
+#include <unity.h>
+#include <algorithm>
+#include "testdata.h"
+#include "container/ogg.cpp"
+#include "vorbis_decoder/vorbis_decoder.cpp"
+
+typedef std::vector<uint8_t> packet_t;
+
+//----------------------------------------------------------------------------------------------------------------------
+//          test streams
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t crc32(const uint8_t* p, size_t len) {           // bitwise, independent of ogg_crc()
+    uint32_t crc = 0;
+    for(size_t i = 0; i < len; i++) {
+        crc ^= (uint32_t)p[i] << 24;
+        for(int k = 0; k < 8; k++) crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+    return crc;
+}
+
+static void writePage(std::vector<uint8_t>* out, uint32_t serial, uint32_t seq, uint8_t flags,
+                      const std::vector<uint8_t>& segs, const std::vector<uint8_t>& body) {
+    size_t at = out->size();
+    uint8_t h[OGG_PAGE_HEADER] = {'O', 'g', 'g', 'S', 0, flags};
+    for(int i = 0; i < 4; i++) h[6 + i] = seq >> (8 * i);      // granule: the page number will do
+    for(int i = 0; i < 4; i++) h[14 + i] = serial >> (8 * i);
+    for(int i = 0; i < 4; i++) h[18 + i] = seq >> (8 * i);
+    h[26] = segs.size();
+    out->insert(out->end(), h, h + OGG_PAGE_HEADER);
+    out->insert(out->end(), segs.begin(), segs.end());
+    out->insert(out->end(), body.begin(), body.end());
+    uint32_t crc = crc32(out->data() + at, out->size() - at);
+    for(int i = 0; i < 4; i++) (*out)[at + 22 + i] = crc >> (8 * i);
+}
+
+static void writeStream(std::vector<uint8_t>* out, uint32_t serial, const std::vector<packet_t>& pk, uint32_t* seed) {
+    // the first packet alone on the BOS page, then pages of 1...255 segments, a page ends within a packet or after it
+    uint32_t seq = 0;
+    std::vector<uint8_t> segs, body;
+    uint8_t flags = 0x02;
+    uint32_t maxSegs = 1;
+    for(size_t i = 0; i < pk.size(); i++) {
+        size_t off = 0;
+        for(size_t n = pk[i].size() / 255 + 1, k = 0; k < n; k++) {
+            uint8_t s = k + 1 < n ? 255 : pk[i].size() % 255;
+            if(segs.size() == maxSegs) {                        // the page is full
+                writePage(out, serial, seq++, flags, segs, body);
+                segs.clear();
+                body.clear();
+                flags = k ? 0x01 : 0;                           // the packet goes on in the next page
+                maxSegs = 1 + testRand(seed) % 255;
+            }
+            segs.push_back(s);
+            body.insert(body.end(), pk[i].begin() + off, pk[i].begin() + off + s);
+            off += s;
+        }
+        bool last = i + 1 == pk.size();
+        if(i == 0 || last || testRand(seed) % 4 == 0) {
+            writePage(out, serial, seq++, flags | (last ? 0x04 : 0), segs, body);
+            segs.clear();
+            body.clear();
+            flags = 0;
+            maxSegs = 1 + testRand(seed) % 255;
+        }
+    }
+}
+
+static std::vector<packet_t> makePackets(uint8_t id, size_t count, uint32_t* seed) {
+    // identification header "\x01test" + id, then packets of 0...6000 bytes, the first byte numbers them
+    std::vector<packet_t> pk = {{1, 't', 'e', 's', 't', id}};
+    for(size_t i = 1; i < count; i++) {
+        size_t len;
+        switch(testRand(seed) % 8) {
+            case 0:  len = 0; break;
+            case 1:  len = 255 * (1 + testRand(seed) % 3); break;
+            case 2:  len = 1000 + testRand(seed) % 5000; break;
+            default: len = 1 + testRand(seed) % 400; break;
+        }
+        packet_t p(len);
+        for(size_t k = 0; k < len; k++) p[k] = testRand(seed);
+        if(len) p[0] = i & 0xFE;                                // even: not a header packet
+        pk.push_back(p);
+    }
+    return pk;
+}
+
+static std::vector<packet_t> nonEmpty(const std::vector<packet_t>& pk) {   // empty packets are not handed over
+    std::vector<packet_t> r;
+    for(const packet_t& p : pk) if(!p.empty()) r.push_back(p);
+    return r;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//          test codec
+//----------------------------------------------------------------------------------------------------------------------
+enum {TAKE_ALL, TAKE_PARTS, TAKE_FRAMES};
+static int                   takeMode = TAKE_ALL;
+static std::vector<packet_t> got;
+static packet_t              part;
+static int                   frames = 0, resets = 0;
+
+static bool isTest(const uint8_t* pkt, uint32_t len) {return len == 6 && memcmp(pkt, "\x01test", 5) == 0;}
+static bool isOther(const uint8_t* pkt, uint32_t len) {return len == 6 && memcmp(pkt, "\x01othr", 5) == 0;}
+static void reset() {resets++; part.clear(); frames = 0;}
+static int8_t take(uint8_t* pkt, int* bytesLeft, short*) {
+    int len = *bytesLeft;
+    if(takeMode == TAKE_PARTS) {                                // as FLAC: a part of the packet per call
+        int n = std::min(len, 1 + len / 3);
+        part.insert(part.end(), pkt, pkt + n);
+        *bytesLeft = len - n;
+        if(*bytesLeft) return ERR_OGG_NONE;
+    }
+    else if(takeMode == TAKE_FRAMES) {                          // as Opus: the whole packet again for every frame
+        if(++frames < 3) return OGG_GIVE_NEXT_LOOP;
+        frames = 0;
+        part.assign(pkt, pkt + len);
+        *bytesLeft = 0;
+    }
+    else {
+        part.assign(pkt, pkt + len);
+        *bytesLeft = 0;
+    }
+    got.push_back(part);
+    part.clear();
+    return ERR_OGG_NONE;
+}
+static const oggCodec_t testCodec  = {1, 20000, isTest, reset, take};
+static const oggCodec_t otherCodec = {2, 20000, isOther, NULL, take};
+
+//----------------------------------------------------------------------------------------------------------------------
+//          driver
+//----------------------------------------------------------------------------------------------------------------------
+static oggDemux_t ogg;
+static int        errors;
+
+static void play(const std::vector<uint8_t>& in, const oggCodec_t* codec, uint32_t seed, uint32_t maxRead,
+                 std::vector<int16_t>* pcm = NULL, uint32_t minRead = 300) {
+    // as Audio::sendBytes(): windows of minRead...maxRead bytes, the codec follows the first stream that has one,
+    // the output goes to pcm
+    static short out[VORBIS_MAX_BLOCKSIZE];
+    std::vector<uint8_t> buf(in);
+    got.clear();
+    part.clear();
+    frames = resets = errors = 0;
+    memset(&ogg, 0, sizeof(ogg));
+    OGG_Register(&ogg, &testCodec);
+    OGG_Register(&ogg, &otherCodec);
+    OGG_Register(&ogg, codec);
+    OGG_AllocateBuffers(&ogg, codec);
+    size_t pos = 0;
+    bool   sync = true;
+    while(pos < buf.size() || ogg.pending) {
+        int len = std::min<size_t>(buf.size() - pos, minRead + testRand(&seed) % (maxRead - minRead + 1));
+        if(!sync) {
+            int s = OGG_FindSyncWord(&ogg, buf.data() + pos, len);
+            if(s < 0) {pos += std::max(len - 3, 1); continue;}
+            pos += s;
+            sync = true;
+            continue;
+        }
+        int bytesLeft = len;
+        int8_t ret = OGG_Decode(&ogg, buf.data() + pos, &bytesLeft, out);
+        int used = len - bytesLeft;
+        if(ret < 0) {errors++; pos += used ? used : 2; sync = false; continue;}
+        if(!used && ret == ERR_OGG_NONE) {
+            if(pos + len == buf.size()) break;                  // the end, a cut page
+            pos++;
+            sync = false;
+            continue;
+        }
+        pos += used;
+        if(pcm) {
+            uint16_t n = VORBISGetOutputSamps();
+            pcm->insert(pcm->end(), out, out + n);
+        }
+    }
+    OGG_FreeBuffers(&ogg);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//          tests
+//----------------------------------------------------------------------------------------------------------------------
+void test_crc() {
+    std::vector<uint8_t> s;
+    uint32_t seed = 7;
+    writeStream(&s, 1, makePackets(0, 20, &seed), &seed);
+    oggPage_t page;
+    for(size_t p = 0; p < s.size(); p += page.headerLen + page.bodyLen) {
+        TEST_ASSERT_TRUE(OGG_ParsePage(&page, s.data() + p, s.size() - p) > 0);
+        TEST_ASSERT_EQUAL_HEX32(ogg_le32(s.data() + p + 22), ogg_crc(s.data() + p, page.headerLen + page.bodyLen));
+    }
+    static const uint8_t silence[] = {                           // a page of libogg
+        'O', 'g', 'g', 'S', 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0x78, 0x56, 0x34, 0x12, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 1, 2, 3};
+    uint8_t pg[sizeof(silence)];
+    memcpy(pg, silence, sizeof(pg));
+    uint32_t c = crc32(pg, sizeof(pg));
+    TEST_ASSERT_EQUAL_HEX32(c, ogg_crc(pg, sizeof(pg)));
+    for(int i = 0; i < 4; i++) pg[22 + i] = c >> (8 * i);
+    TEST_ASSERT_EQUAL_HEX32(c, ogg_crc(pg, sizeof(pg)));         // the CRC field does not count
+}
+
+void test_packets_and_splits() {
+    for(uint32_t run = 1; run <= 150; run++) {
+        uint32_t seed = run;
+        std::vector<packet_t> pk = makePackets(0, 60, &seed);
+        std::vector<uint8_t> s;
+        writeStream(&s, run, pk, &seed);
+        takeMode = run % 3;
+        play(s, &testCodec, run, run % 2 ? 1600 : 16000);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "run %u, mode %d: %zu of %zu packets, %u copied, %d errors", run, takeMode,
+                 got.size(), nonEmpty(pk).size(), ogg.copied, errors);
+        TEST_ASSERT_TRUE_MESSAGE(got == nonEmpty(pk), msg);
+        TEST_ASSERT_EQUAL_MESSAGE(0, errors, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(0, ogg.skipped, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(0, ogg.crcErrors, msg);
+    }
+    takeMode = TAKE_ALL;
+}
+
+void test_packet_too_big() {
+    uint32_t seed = 3;
+    std::vector<packet_t> pk = makePackets(0, 10, &seed);
+    pk[4] = packet_t(25000, 0x42);                              // 20000 bytes of packet buffer
+    std::vector<uint8_t> s;
+    writeStream(&s, 1, pk, &seed);
+    play(s, &testCodec, 1, 1600);
+    pk.erase(pk.begin() + 4);
+    TEST_ASSERT_TRUE(got == nonEmpty(pk));
+    TEST_ASSERT_EQUAL(1, ogg.skipped);
+}
+
+void test_damaged_page() {
+    // one byte of the body of a page changed: the packets that lie in the page are lost, the others come through
+    for(uint32_t run = 1; run <= 50; run++) {
+        uint32_t seed = run * 31;
+        std::vector<packet_t> pk = makePackets(0, 40, &seed);
+        std::vector<uint8_t> s;
+        writeStream(&s, 1, pk, &seed);
+        std::vector<size_t> pages;
+        oggPage_t page;
+        for(size_t p = 0; p < s.size(); p += page.headerLen + page.bodyLen) {
+            OGG_ParsePage(&page, s.data() + p, s.size() - p);
+            if(p && page.bodyLen) pages.push_back(p);
+        }
+        size_t at = pages[testRand(&seed) % pages.size()];
+        OGG_ParsePage(&page, s.data() + at, s.size() - at);
+        s[at + page.headerLen + testRand(&seed) % page.bodyLen] ^= 0x10;
+        play(s, &testCodec, run, 65307, NULL, 65307);           // windows that hold the largest page
+        std::vector<packet_t> want = nonEmpty(pk);
+        size_t lost = 0;
+        for(const packet_t& p : want) if(std::find(got.begin(), got.end(), p) == got.end()) lost++;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "run %u: %zu of %zu packets, %zu lost", run, got.size(), want.size(), lost);
+        TEST_ASSERT_EQUAL_MESSAGE(1, ogg.crcErrors, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(want.size(), got.size() + lost, msg);   // nothing damaged comes through
+        TEST_ASSERT_TRUE_MESSAGE(lost >= 1 && lost <= (size_t)page.segCount + 1, msg);
+    }
+}
+
+void test_chained_and_multiplexed() {
+    uint32_t seed = 11;
+    std::vector<packet_t> a = makePackets(0, 30, &seed), b = makePackets(1, 30, &seed), c = makePackets(2, 30, &seed);
+    std::vector<packet_t> o = makePackets(3, 10, &seed);
+    o[0] = {1, 'o', 't', 'h', 'r', 0};
+    std::vector<uint8_t> s;                                     // a, b chained, a track of the other codec, c
+    writeStream(&s, 100, a, &seed);
+    writeStream(&s, 200, b, &seed);
+    writeStream(&s, 300, o, &seed);
+    writeStream(&s, 400, c, &seed);
+    play(s, &testCodec, 5, 1600);
+    std::vector<packet_t> want = nonEmpty(a), tb = nonEmpty(b), tc = nonEmpty(c);
+    want.insert(want.end(), tb.begin(), tb.end());
+    want.insert(want.end(), tc.begin(), tc.end());
+    TEST_ASSERT_TRUE(got == want);
+    TEST_ASSERT_EQUAL(3, ogg.chains);
+    TEST_ASSERT_EQUAL(1, errors);                               // ERR_OGG_CODEC_CHANGED
+    TEST_ASSERT_TRUE(resets >= 3);
+
+    std::vector<uint8_t> m, sa, sb;                             // BOS pages of a and b, then their pages interleaved
+    writeStream(&sa, 1, a, &seed);
+    writeStream(&sb, 2, b, &seed);
+    std::vector<std::vector<uint8_t>> pa, pb;
+    for(auto* x : {&sa, &sb}) {
+        oggPage_t page;
+        for(size_t p = 0; p < x->size(); p += page.headerLen + page.bodyLen) {
+            OGG_ParsePage(&page, x->data() + p, x->size() - p);
+            (x == &sa ? pa : pb).push_back(std::vector<uint8_t>(x->begin() + p, x->begin() + p + page.headerLen + page.bodyLen));
+        }
+    }
+    for(size_t i = 0; i < std::max(pa.size(), pb.size()); i++) {
+        if(i < pa.size()) m.insert(m.end(), pa[i].begin(), pa[i].end());
+        if(i < pb.size()) m.insert(m.end(), pb[i].begin(), pb[i].end());
+    }
+    play(m, &testCodec, 9, 1600);
+    TEST_ASSERT_TRUE(got == nonEmpty(a));
+    TEST_ASSERT_EQUAL(0, ogg.chains);
+}
+
+void test_garbage_between_pages() {
+    uint32_t seed = 21;
+    std::vector<packet_t> pk = makePackets(0, 50, &seed);
+    std::vector<uint8_t> s, g;
+    writeStream(&s, 1, pk, &seed);
+    std::vector<size_t> pages;                                  // 3000 bytes of garbage before a page
+    oggPage_t page;
+    for(size_t p = 0; p < s.size(); p += page.headerLen + page.bodyLen) {
+        OGG_ParsePage(&page, s.data() + p, s.size() - p);
+        if(p) pages.push_back(p);
+    }
+    size_t at = pages[pages.size() / 2];
+    for(int i = 0; i < 3000; i++) g.push_back(i % 7 ? testRand(&seed) : 'O');
+    s.insert(s.begin() + at, g.begin(), g.end());
+    play(s, &testCodec, 2, 1600);
+    size_t found = 0;
+    for(const packet_t& p : nonEmpty(pk)) if(std::find(got.begin(), got.end(), p) != got.end()) found++;
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%zu of %zu packets, %u resyncs", found, nonEmpty(pk).size(), ogg.resyncs);
+    TEST_ASSERT_EQUAL_MESSAGE(found, got.size(), msg);          // only whole packets
+    TEST_ASSERT_TRUE_MESSAGE(found + 2 >= nonEmpty(pk).size(), msg);   // the packet across the gap at most
+    TEST_ASSERT_TRUE_MESSAGE(ogg.resyncs >= 1, msg);
+}
+
+static bool isVorbis(const uint8_t* pkt, uint32_t len) {      // as Audio::oggIsVorbis()
+    return len >= 7 && pkt[0] == 1 && memcmp(pkt + 1, "vorbis", 6) == 0;
+}
+static const oggCodec_t vorbisCodec = {10, VORBIS_MAX_PACKET, isVorbis, VORBISDecoder_Reset, VORBISDecode};
+
+void test_vorbis_chained_capture() {
+    // 22.05 kHz mono, then 44.1 kHz stereo with another setup
+    std::vector<uint8_t> a = loadTestFile(__FILE__, "../test_vorbis/q5_22k_mono.ogg");
+    std::vector<uint8_t> b = loadTestFile(__FILE__, "../test_vorbis/q10_44k_stereo.ogg");
+    TEST_ASSERT_FALSE(a.empty() || b.empty());
+    std::vector<uint8_t> ab(a);
+    ab.insert(ab.end(), b.begin(), b.end());
+    std::vector<int16_t> pa, pb, pab;
+    TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+    play(a, &vorbisCodec, 1, 1600, &pa);
+    play(b, &vorbisCodec, 2, 1600, &pb);
+    play(ab, &vorbisCodec, 3, 1600, &pab);
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_EQUAL(1, ogg.chains);
+    TEST_ASSERT_EQUAL(44100, VORBISGetSampRate());
+    TEST_ASSERT_EQUAL(2, VORBISGetChannels());
+    VORBISDecoder_FreeBuffers();
+    pa.insert(pa.end(), pb.begin(), pb.end());
+    TEST_ASSERT_TRUE(pa.size() > 11025 + 2 * 22050);
+    TEST_ASSERT_TRUE(pab == pa);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc);
+    RUN_TEST(test_packets_and_splits);
+    RUN_TEST(test_packet_too_big);
+    RUN_TEST(test_damaged_page);
+    RUN_TEST(test_chained_and_multiplexed);
+    RUN_TEST(test_garbage_between_pages);
+    RUN_TEST(test_vorbis_chained_capture);
+    return UNITY_END();
+}
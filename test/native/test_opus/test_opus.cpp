@@ -0,0 +1,185 @@
+/*
+ * test_opus.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  CELT decoder (opus_decoder, celt) against reference vectors of libopus 1.6.1: the final range of the range decoder
+ *  after every packet is bit exact (as opus_demo checks it), the PCM is compared with the output of opus_decode().
+ *  The PCM of this decoder is locked bit exact (celt.fix), the integer synthesis gives the same on every build.
+ *
+ *  celt.bit  132 packets of a stereo stream in the format of opus_demo (per packet: length and final range, 32 bit
+ *            big endian, then the packet), encoded with OPUS_SET_FORCE_MODE(MODE_CELT_ONLY): frames of 2.5, 5, 10 and
+ *            20 ms, NB, WB, SWB and FB, 32...128 kbit/s, CBR and VBR, mono packets (OPUS_SET_FORCE_CHANNELS(1)),
+ *            packets of 2...4 frames (code 1, 2 and 3)
+ *  celt.dec  opus_decode() of celt.bit, 48 kHz, 16 bit stereo, float build of libopus (the one at hand, a fixed
+ *            point build of libopus is not bit exact with this decoder either, its inverse MDCT has an own FFT)
+ *  celt.fix  the output of this decoder for celt.bit, 48 kHz, 16 bit stereo (checked at -O0, -O2 and with UBSan)
+ *  silk.bit  SILK and hybrid packets (20ms), the decoder gives them out as silence
+ */
+#include <unity.h>
+#include "testdata.h"
+#include "opus_decoder/celt.cpp"
+#include "opus_decoder/opus_decoder.cpp"
+
+struct packet_t {
+    std::vector<uint8_t> data;
+    uint32_t             range;
+};
+
+static std::vector<packet_t> loadBit(const char* name) {
+    std::vector<uint8_t> f = loadTestFile(__FILE__, name);
+    std::vector<packet_t> pk;
+    size_t p = 0;
+    while(p + 8 <= f.size()) {
+        uint32_t len = f[p] << 24 | f[p + 1] << 16 | f[p + 2] << 8 | f[p + 3];
+        packet_t k;
+        k.range = (uint32_t)f[p + 4] << 24 | f[p + 5] << 16 | f[p + 6] << 8 | f[p + 7];
+        p += 8;
+        if(p + len > f.size()) break;
+        k.data.assign(f.begin() + p, f.begin() + p + len);
+        pk.push_back(k);
+        p += len;
+    }
+    return pk;
+}
+
+static void openStream() {                          // OpusHead: stereo, no pre-skip, no gain, family 0
+    static const uint8_t head[19] = {'O', 'p', 'u', 's', 'H', 'e', 'a', 'd', 1, 2, 0, 0, 0x80, 0xBB, 0, 0, 0, 0, 0};
+    uint8_t buf[19];
+    memcpy(buf, head, sizeof(buf));
+    TEST_ASSERT_TRUE(OPUSDecoder_AllocateBuffers());
+    TEST_ASSERT_EQUAL(ERR_OPUS_NONE, OPUSParseHead(buf, sizeof(buf)));
+    OPUSDecoder_ClearBuffers();
+}
+
+static int8_t decodePacket(packet_t& k, std::vector<int16_t>* pcm) {
+    // as Audio::sendBytes(): the packet is given again as long as OPUSDecode() wants it
+    static short out[CELT_MAX_FRAME * 2];
+    int8_t ret;
+    do {
+        int bytesLeft = k.data.size();
+        ret = OPUSDecode(k.data.data(), &bytesLeft, out);
+        uint16_t n = OPUSGetOutputSamps();
+        if(pcm) pcm->insert(pcm->end(), out, out + n);
+    } while(ret == OPUS_GIVE_NEXT_LOOP);
+    return ret;
+}
+
+void test_final_range_and_pcm() {
+    std::vector<packet_t> pk = loadBit("celt.bit");
+    std::vector<uint8_t>  dec = loadTestFile(__FILE__, "celt.dec");
+    std::vector<uint8_t>  fix = loadTestFile(__FILE__, "celt.fix");
+    TEST_ASSERT_EQUAL(132, pk.size());
+    openStream();
+    std::vector<int16_t> pcm;
+    for(size_t i = 0; i < pk.size(); i++) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "packet %zu, toc 0x%02x", i, pk[i].data[0]);
+        TEST_ASSERT_EQUAL_MESSAGE(ERR_OPUS_NONE, decodePacket(pk[i], &pcm), msg);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(pk[i].range, OPUSGetFinalRange(), msg);
+    }
+    TEST_ASSERT_EQUAL(dec.size() / 2, pcm.size());
+    TEST_ASSERT_EQUAL(fix.size() / 2, pcm.size());
+    TEST_ASSERT_EQUAL_MEMORY(fix.data(), pcm.data(), fix.size());             // little endian host
+    double se = 0, ss = 0;
+    int maxErr = 0;
+    for(size_t i = 0; i < pcm.size(); i++) {
+        int16_t r = (int16_t)(dec[2 * i] | dec[2 * i + 1] << 8);
+        int e = pcm[i] - r;
+        se += (double)e * e;
+        ss += (double)r * r;
+        if(abs(e) > maxErr) maxErr = abs(e);
+    }
+    double snr = se ? 10 * log10(ss / se) : 999;
+    char msg[80];
+    snprintf(msg, sizeof(msg), "%.1f dB against opus_decode(), max error %d", snr, maxErr);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(snr >= 69 && maxErr <= 512, msg);  // 69.6 dB, 442: fixed point against float
+}
+
+void test_silk_and_hybrid_muted() {
+    // SILK, hybrid and a 60ms SILK frame (config 11, in parts of CELT_MAX_FRAME) play as silence of their length, the
+    // CELT packet behind them starts from a reset decoder: packet 40 after 40 CELT packets and the muted ones is
+    // decoded as on a fresh decoder
+    std::vector<packet_t> pk = loadBit("silk.bit");
+    std::vector<packet_t> celt = loadBit("celt.bit");
+    TEST_ASSERT_EQUAL(4, pk.size());
+    packet_t silk60;
+    silk60.data.assign(40, 0x55);
+    silk60.data[0] = 11 << 3 | 0x04;
+    pk.push_back(silk60);
+    openStream();
+    std::vector<int16_t> first;
+    decodePacket(celt[40], &first);
+    int peak = 0;
+    for(int16_t v : first) if(abs(v) > peak) peak = abs(v);
+    TEST_ASSERT_TRUE(peak > 1000);
+    OPUSDecoder_ClearBuffers();
+    for(int i = 0; i < 40; i++) decodePacket(celt[i], NULL);
+    for(packet_t& k : pk) {
+        std::vector<int16_t> pcm;
+        static short out[CELT_MAX_FRAME * 2];
+        int8_t ret;
+        int parts = 0;
+        do {
+            int bytesLeft = k.data.size();
+            ret = OPUSDecode(k.data.data(), &bytesLeft, out);
+            uint16_t n = OPUSGetOutputSamps();
+            TEST_ASSERT_TRUE(n > 0 && n <= CELT_MAX_FRAME * 2);
+            pcm.insert(pcm.end(), out, out + n);
+            parts++;
+            if(ret == OPUS_GIVE_NEXT_LOOP) TEST_ASSERT_EQUAL((int)k.data.size(), bytesLeft);
+            else TEST_ASSERT_EQUAL(0, bytesLeft);                            // consumed with the last part
+        } while(ret == OPUS_GIVE_NEXT_LOOP);
+        TEST_ASSERT_EQUAL(ERR_OPUS_NONE, ret);
+        uint8_t config = k.data[0] >> 3;
+        TEST_ASSERT_EQUAL(config == 11 ? 2880 * 2 : 960 * 2, pcm.size());
+        TEST_ASSERT_EQUAL(config == 11 ? 3 : 1, parts);
+        for(int16_t v : pcm) TEST_ASSERT_EQUAL(0, v);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, OPUSGetMutedFrames());
+    std::vector<int16_t> again;
+    TEST_ASSERT_EQUAL(ERR_OPUS_NONE, decodePacket(celt[40], &again));
+    TEST_ASSERT_EQUAL_UINT32(celt[40].range, OPUSGetFinalRange());
+    TEST_ASSERT_EQUAL(first.size(), again.size());
+    TEST_ASSERT_EQUAL_MEMORY(first.data(), again.data(), first.size() * 2);   // as on a fresh decoder
+}
+
+void test_mixed_stream_plays_on() {
+    // SILK and hybrid packets between the CELT packets: every CELT packet is decoded, the stream keeps its length
+    std::vector<packet_t> pk = loadBit("celt.bit");
+    std::vector<packet_t> silk = loadBit("silk.bit");
+    std::vector<uint8_t>  fix = loadTestFile(__FILE__, "celt.fix");
+    openStream();
+    std::vector<int16_t> pcm;
+    size_t silkSamples = 0, celtSamples = 0;
+    for(size_t i = 0; i < pk.size(); i++) {
+        if(i % 20 == 10) {
+            packet_t& k = silk[i / 20 % silk.size()];
+            size_t n = pcm.size();
+            TEST_ASSERT_EQUAL(ERR_OPUS_NONE, decodePacket(k, &pcm));
+            silkSamples += pcm.size() - n;
+        }
+        size_t n = pcm.size();
+        char msg[64];
+        snprintf(msg, sizeof(msg), "packet %zu, toc 0x%02x", i, pk[i].data[0]);
+        TEST_ASSERT_EQUAL_MESSAGE(ERR_OPUS_NONE, decodePacket(pk[i], &pcm), msg);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(pk[i].range, OPUSGetFinalRange(), msg);
+        celtSamples += pcm.size() - n;
+    }
+    TEST_ASSERT_EQUAL(7, OPUSGetMutedFrames());
+    TEST_ASSERT_EQUAL(7 * 960 * 2, silkSamples);
+    TEST_ASSERT_EQUAL(fix.size() / 2, celtSamples);
+    TEST_ASSERT_EQUAL_MEMORY(fix.data(), pcm.data(), 10 * 2 * 120 * 2);         // up to the first SILK packet
+}
+
+void setUp() {}
+void tearDown() {OPUSDecoder_FreeBuffers();}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_final_range_and_pcm);
+    RUN_TEST(test_silk_and_hybrid_muted);
+    RUN_TEST(test_mixed_stream_plays_on);
+    return UNITY_END();
+}
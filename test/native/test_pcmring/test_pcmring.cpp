@@ -0,0 +1,162 @@
+/*
+ * test_pcmring.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  PCM ring between decoder and I2S output task (dsp/pcmring): rate marks and flush on one thread, then a producer
+ *  and a consumer thread as Audio::playChunk() and Audio::outputLoop() use it.
+ *
+ *  Every frame carries the id of the rate it was written under (high byte) and a running counter (low 24 bits).
+ *  The consumer switches its rate only on the marks read() hands over, so a frame played at the wrong rate, a lost
+ *  or early mark, a lost, doubled or reordered frame fails the test. Marks come in bursts, back to back (no frame
+ *  between them) and until the FIFO is full.
+ */
+#include <unity.h>
+#include <thread>
+#include "testdata.h"
+#include "dsp/pcmring.cpp"
+
+#define RING_FRAMES     4096            // AUDIO_RING_FRAMES order of magnitude
+#define RUN_FRAMES      20000000
+
+static PcmRing ring;
+
+static inline uint32_t frame(uint32_t rateId, uint32_t n) {return rateId << 24 | (n & 0xFFFFFF);}
+
+static size_t writeFrames(uint32_t rateId, uint32_t* n, size_t count) {
+    uint32_t buf[512];
+    if(count > 512) count = 512;
+    for(size_t i = 0; i < count; i++) buf[i] = frame(rateId, *n + i);
+    size_t w = ring.write(buf, count);
+    *n += w;
+    return w;
+}
+
+void test_marks_in_order() {
+    TEST_ASSERT_TRUE(ring.init(RING_FRAMES));
+    uint32_t n = 0, buf[RING_FRAMES], mark = 0;
+    writeFrames(0, &n, 100);
+    TEST_ASSERT_TRUE(ring.mark(1000));
+    TEST_ASSERT_TRUE(ring.mark(1001));              // back to back: no frame plays at 1000
+    writeFrames(1, &n, 50);
+    TEST_ASSERT_TRUE(ring.mark(1002));
+    writeFrames(2, &n, 10);
+
+    TEST_ASSERT_EQUAL(100, ring.read(buf, RING_FRAMES, &mark));   // stops in front of the first mark
+    TEST_ASSERT_EQUAL_UINT32(0, mark);
+    TEST_ASSERT_EQUAL_HEX32(frame(0, 99), buf[99]);
+    TEST_ASSERT_EQUAL(50, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(1001, mark);
+    TEST_ASSERT_EQUAL_HEX32(frame(1, 100), buf[0]);
+    mark = 0;
+    TEST_ASSERT_EQUAL(10, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(1002, mark);
+    TEST_ASSERT_EQUAL_HEX32(frame(2, 150), buf[0]);
+    mark = 0;
+    TEST_ASSERT_EQUAL(0, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(0, mark);
+}
+
+void test_mark_at_the_end_and_full_fifo() {
+    TEST_ASSERT_TRUE(ring.init(RING_FRAMES));
+    uint32_t n = 0, buf[RING_FRAMES], mark = 0;
+    writeFrames(0, &n, 20);
+    for(uint32_t i = 0; i < PCMRING_MARKS; i++) {
+        TEST_ASSERT_TRUE(ring.mark(2000 + i));
+        writeFrames(i + 1, &n, 1);
+    }
+    TEST_ASSERT_FALSE(ring.mark(3000));             // full, the producer waits
+    TEST_ASSERT_EQUAL(20, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(0, mark);
+    TEST_ASSERT_EQUAL(1, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(2000, mark);
+    TEST_ASSERT_TRUE(ring.mark(3000));              // one handed over, room for one
+    TEST_ASSERT_FALSE(ring.mark(3001));
+    for(uint32_t i = 1; i < PCMRING_MARKS; i++) {
+        TEST_ASSERT_EQUAL(1, ring.read(buf, RING_FRAMES, &mark));
+        TEST_ASSERT_EQUAL_UINT32(2000 + i, mark);
+        TEST_ASSERT_EQUAL_HEX32(frame(i + 1, 20 + i), buf[0]);
+    }
+    mark = 0;                                       // the last mark has no frames yet, it is handed over anyway
+    TEST_ASSERT_EQUAL(0, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(3000, mark);
+}
+
+void test_flush_passes_the_marks() {
+    TEST_ASSERT_TRUE(ring.init(RING_FRAMES));
+    uint32_t n = 0, buf[RING_FRAMES], mark = 0;
+    writeFrames(0, &n, 300);
+    ring.mark(4000);
+    writeFrames(1, &n, 300);
+    ring.mark(4001);
+    writeFrames(2, &n, 300);
+    ring.flush();                                   // a station change: nothing of it plays, the rate still counts
+    ring.mark(4002);
+    writeFrames(3, &n, 40);
+    TEST_ASSERT_EQUAL(40, ring.read(buf, RING_FRAMES, &mark));
+    TEST_ASSERT_EQUAL_UINT32(4002, mark);
+    TEST_ASSERT_EQUAL_HEX32(frame(3, 900), buf[0]);
+    TEST_ASSERT_EQUAL(0, ring.filled());
+}
+
+void test_producer_consumer() {
+    TEST_ASSERT_TRUE(ring.init(RING_FRAMES));
+    static std::atomic<bool> done;
+    static uint32_t marksPut, fifoFull;
+    done = false;
+    marksPut = fifoFull = 0;
+    std::thread producer([] {
+        uint32_t seed = 7, n = 0, rateId = 0;
+        while(n < RUN_FRAMES) {
+            uint32_t r = testRand(&seed);
+            if(r % 64 == 0) {                       // a burst of marks, the last one holds for the next frames
+                uint32_t burst = 1 + (r >> 6) % (PCMRING_MARKS + 2);
+                for(uint32_t k = 0; k < burst; k++) {
+                    rateId = (rateId + 1) & 0xFF;
+                    while(!ring.mark(rateId + 1)) {fifoFull++; std::this_thread::yield();}
+                    marksPut++;
+                    if((r >> 12) & 1) while(!writeFrames(rateId, &n, 1)) std::this_thread::yield(); // one frame each
+                }
+            }
+            if(!writeFrames(rateId, &n, 1 + (r >> 8) % 400)) std::this_thread::yield();
+        }
+        done = true;
+    });
+    uint32_t seed = 11, expect = 0, rateId = 0, marks = 0, errors = 0, got = 0;
+    static uint32_t buf[RING_FRAMES];
+    while(true) {
+        uint32_t mark = 0;
+        bool last = done;
+        size_t k = ring.read(buf, 1 + testRand(&seed) % 300, &mark);
+        if(mark) {rateId = mark - 1; marks++;}
+        for(size_t i = 0; i < k; i++) {
+            if(buf[i] != frame(rateId, expect) && errors++ < 5)
+                printf("frame %u: 0x%08x, expected 0x%08x\n", got, buf[i], frame(rateId, expect));
+            expect++;
+            got++;
+        }
+        if(!k) {
+            if(last && !ring.filled()) break;
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%u frames, %u marks put, %u with frames handed over, FIFO full %u times", got,
+             marksPut, marks, fifoFull);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, msg);
+    TEST_ASSERT_TRUE_MESSAGE(got >= RUN_FRAMES && marks > 0 && marks <= marksPut, msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_marks_in_order);
+    RUN_TEST(test_mark_at_the_end_and_full_fifo);
+    RUN_TEST(test_flush_passes_the_marks);
+    RUN_TEST(test_producer_consumer);
+    return UNITY_END();
+}
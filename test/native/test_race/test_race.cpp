@@ -0,0 +1,211 @@
+/*
+ * test_race.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Connection race between mirrors (net/race), as Audio::mirrorRace() runs it, against local servers on 127.0.0.1
+ *  (one thread each): the winner is the first good status line, a bad status, a closed or refused connection drops
+ *  a mirror, a status line in two parts is waited for. The winner's response is still unread after the race, the
+ *  losers are closed, the race ends after the timeout or on cancel.
+ */
+#include <unity.h>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <arpa/inet.h>
+#include "net/race.cpp"
+
+#define RQH "GET /stream HTTP/1.1\r\nHost: mirror\r\nIcy-MetaData:1\r\n\r\n"
+
+struct server_t {
+    int         lfd;
+    uint16_t    port;
+    std::thread th;
+    std::string request;                            // what the server has read
+};
+
+static std::atomic<bool> done;
+static server_t srv[4];                             // stopped in tearDown(), also after a failed assertion
+static int nsrv;
+
+static uint16_t serve(int delayMs, const char* part1, int splitMs, const char* part2) {
+    // accept, read the request, answer after delayMs (part1, part2 after splitMs, NULL: close), hold until done
+    server_t* s = &srv[nsrv++];
+    s->request.clear();
+    s->lfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(s->lfd, (struct sockaddr*)&sa, sizeof(sa));
+    socklen_t len = sizeof(sa);
+    getsockname(s->lfd, (struct sockaddr*)&sa, &len);
+    s->port = ntohs(sa.sin_port);
+    listen(s->lfd, 1);
+    s->th = std::thread([=] {
+        int fd = accept(s->lfd, NULL, NULL);
+        if(fd < 0) return;
+        char buf[256];
+        int n = recv(fd, buf, sizeof(buf) - 1, 0);
+        if(n > 0) s->request.assign(buf, n);
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        if(!part1) {close(fd); return;}
+        send(fd, part1, strlen(part1), MSG_NOSIGNAL);
+        if(part2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(splitMs));
+            send(fd, part2, strlen(part2), MSG_NOSIGNAL);
+        }
+        while(!done) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        close(fd);
+    });
+    return s->port;
+}
+
+static void stopServers() {
+    done = true;
+    for(int i = 0; i < nsrv; i++) {
+        shutdown(srv[i].lfd, SHUT_RDWR);            // an accept() that got no connection returns
+        if(srv[i].th.joinable()) srv[i].th.join();
+        close(srv[i].lfd);
+    }
+    nsrv = 0;
+    done = false;
+}
+
+static uint16_t refusedPort() {
+    // a port nobody listens on
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, (struct sockaddr*)&sa, sizeof(sa));
+    socklen_t len = sizeof(sa);
+    getsockname(fd, (struct sockaddr*)&sa, &len);
+    close(fd);
+    return ntohs(sa.sin_port);
+}
+
+static int race(const uint16_t* ports, int n, uint32_t timeoutMs, raceConn_t* c, uint32_t* ms,
+                raceCancel_t cancel = NULL, void* arg = NULL) {
+    for(int i = 0; i < n; i++) {
+        c[i].fd = RACE_Connect(htonl(INADDR_LOOPBACK), ports[i]);
+        c[i].sent = false;
+        c[i].rqh = RQH;
+    }
+    auto t = std::chrono::steady_clock::now();
+    int win = RACE_Run(c, n, timeoutMs, cancel, arg);
+    *ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t).count();
+    return win;
+}
+
+static std::string readWinner(int fd) {
+    char buf[64];
+    int n = recv(fd, buf, sizeof(buf), 0);          // blocking again
+    return n > 0 ? std::string(buf, n) : std::string();
+}
+
+void test_status() {
+    TEST_ASSERT_EQUAL(RACE_WIN,  RACE_Status("HTTP/1.1 200 OK", 15));
+    TEST_ASSERT_EQUAL(RACE_WIN,  RACE_Status("HTTP/1.0 302 Fo", 15));
+    TEST_ASSERT_EQUAL(RACE_WIN,  RACE_Status("ICY 200 OK\r\n", 12));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("HTTP/1.1 503 Se", 15));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("HTTP/1.1 404 No", 15));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("ICY 401 Unautho", 15));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("<html><head>", 12));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("", 0));               // closed
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("", -1));
+    TEST_ASSERT_EQUAL(RACE_WAIT, RACE_Status("HTT", 3));
+    TEST_ASSERT_EQUAL(RACE_WAIT, RACE_Status("HTTP/1.1 ", 9));
+    TEST_ASSERT_EQUAL(RACE_WAIT, RACE_Status("ICY ", 4));
+    TEST_ASSERT_EQUAL(RACE_DROP, RACE_Status("HTX", 3));
+}
+
+void test_first_good_status_wins() {
+    // 503 after 50 ms, 302 after 150 ms, ICY 200 after 300 ms: the 302 wins at 150 ms
+    uint16_t ports[3] = {serve(50,  "HTTP/1.1 503 Service Unavailable\r\n\r\n", 0, NULL),
+                         serve(150, "HTTP/1.1 302 Found\r\nLocation: http://x/\r\n\r\n", 0, NULL),
+                         serve(300, "ICY 200 OK\r\n\r\n", 0, NULL)};
+    raceConn_t c[3];
+    uint32_t ms;
+    int win = race(ports, 3, 2000, c, &ms);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "winner %d after %u ms", win, ms);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_INT(1, win);
+    TEST_ASSERT_TRUE_MESSAGE(ms >= 140 && ms < 290, msg);
+    TEST_ASSERT_EQUAL_INT(-1, c[0].fd);
+    TEST_ASSERT_EQUAL_INT(-1, c[2].fd);
+    std::string got = readWinner(c[1].fd);
+    close(c[1].fd);
+    TEST_ASSERT_TRUE(got.compare(0, 12, "HTTP/1.1 302") == 0);                   // peeked only
+    for(int i = 0; i < 3; i++) TEST_ASSERT_TRUE(srv[i].request == RQH);         // every mirror got the request
+}
+
+void test_failures_are_dropped() {
+    // refused, closed without an answer, 404: the ICY 200 behind them wins
+    uint16_t ports[4] = {refusedPort(), serve(20, NULL, 0, NULL), serve(40, "HTTP/1.1 404 Not Found\r\n\r\n", 0, NULL),
+                         serve(100, "ICY 200 OK\r\nicy-metaint:16000\r\n\r\n", 0, NULL)};
+    raceConn_t c[4];
+    uint32_t ms;
+    int win = race(ports, 4, 2000, c, &ms);
+    TEST_ASSERT_EQUAL_INT(3, win);
+    std::string got = readWinner(c[3].fd);
+    close(c[3].fd);
+    TEST_ASSERT_TRUE(got.compare(0, 10, "ICY 200 OK") == 0);
+}
+
+void test_status_line_in_two_parts() {
+    // "HTT" + "P/1.0 200 OK" 30 ms later wins against a 200 after 200 ms
+    uint16_t ports[2] = {serve(20, "HTT", 30, "P/1.0 200 OK\r\n\r\n"), serve(200, "HTTP/1.1 200 OK\r\n\r\n", 0, NULL)};
+    raceConn_t c[2];
+    uint32_t ms;
+    int win = race(ports, 2, 2000, c, &ms);
+    TEST_ASSERT_EQUAL_INT(0, win);
+    std::string got = readWinner(c[0].fd);
+    if(got.size() < 12) got += readWinner(c[0].fd);
+    close(c[0].fd);
+    TEST_ASSERT_TRUE(ms < 190);
+    TEST_ASSERT_TRUE(got.compare(0, 12, "HTTP/1.0 200") == 0);
+}
+
+void test_none_answers() {
+    // all bad: at once; silent: after the timeout
+    uint16_t ports[2] = {serve(10, "HTTP/1.1 500 Error\r\n\r\n", 0, NULL), serve(10, "HTTP/1.1 403 Forbidden\r\n\r\n", 0, NULL)};
+    raceConn_t c[2];
+    uint32_t ms;
+    TEST_ASSERT_EQUAL_INT(-1, race(ports, 2, 2000, c, &ms));
+    TEST_ASSERT_TRUE(ms < 500);
+    TEST_ASSERT_TRUE(c[0].fd == -1 && c[1].fd == -1);
+    stopServers();
+    ports[0] = serve(5000, "HTTP/1.1 200 OK\r\n\r\n", 0, NULL);
+    ports[1] = serve(5000, "HTTP/1.1 200 OK\r\n\r\n", 0, NULL);
+    TEST_ASSERT_EQUAL_INT(-1, race(ports, 2, 300, c, &ms));
+    TEST_ASSERT_TRUE(ms >= 300 && ms < 450);
+    TEST_ASSERT_TRUE(c[0].fd == -1 && c[1].fd == -1);
+}
+
+void test_cancel() {
+    uint16_t ports[2] = {serve(5000, "HTTP/1.1 200 OK\r\n\r\n", 0, NULL), serve(5000, "HTTP/1.1 200 OK\r\n\r\n", 0, NULL)};
+    static std::chrono::steady_clock::time_point t0;
+    t0 = std::chrono::steady_clock::now();
+    raceConn_t c[2];
+    uint32_t ms;
+    int win = race(ports, 2, 3000, c, &ms, [](void*) {return std::chrono::steady_clock::now() - t0 > std::chrono::milliseconds(100);});
+    TEST_ASSERT_EQUAL_INT(-1, win);
+    TEST_ASSERT_TRUE(ms >= 100 && ms < 250);
+    TEST_ASSERT_TRUE(c[0].fd == -1 && c[1].fd == -1);
+}
+
+void setUp() {}
+void tearDown() {stopServers();}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_status);
+    RUN_TEST(test_first_good_status_wins);
+    RUN_TEST(test_failures_are_dropped);
+    RUN_TEST(test_status_line_in_two_parts);
+    RUN_TEST(test_none_answers);
+    RUN_TEST(test_cancel);
+    return UNITY_END();
+}
@@ -0,0 +1,207 @@
+/*
+ * test_recv.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Direct socket receive (net/recv) as Audio::streamRead() uses it, against a sender thread on 127.0.0.1. The client
+ *  is a model of WiFiClient of Arduino-ESP32 2.0.x: WiFiClientRxBuffer with its 1436 bytes, filled by one recv()
+ *  when empty, available() is the buffered bytes plus FIONREAD.
+ *
+ *  order:       the stream is read in turns through the client (the header, a prefetch buffer) and with
+ *               streamRead() while the sender writes, every byte must come once and in order
+ *  throughput:  the stream is read through the client and direct, the CPU time of the reading thread and the recv()
+ *               calls per path are reported, the direct path must need fewer calls and less CPU with 16 kB reads
+ */
+#include <unity.h>
+#include <thread>
+#include <atomic>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "testdata.h"
+#include "net/recv.cpp"
+
+#define ORDER_BYTES     (32u << 20)
+#define RUN_BYTES       (256u << 20)
+
+static uint32_t recvCalls;
+
+class RxClient {                        // WiFiClientRxBuffer (WiFiClient.cpp, Arduino-ESP32 2.0.x)
+  public:
+    explicit RxClient(int fd) : _fd(fd) {}
+    int fd() const {return _fd;}
+    int available() {return _fill - _pos + level();}
+    int read(uint8_t* dst, size_t len) {
+        if(!dst || !len || (_pos == _fill && !fillBuffer())) return 0;
+        size_t a = _fill - _pos;
+        if(len <= a || ((len - a) <= (_size - _fill) && fillBuffer() >= len)) {
+            memcpy(dst, _buffer + _pos, len);
+            _pos += len;
+            return len;
+        }
+        size_t left = len, toRead = a;
+        uint8_t* buf = dst;
+        memcpy(buf, _buffer + _pos, toRead);
+        _pos += toRead;
+        left -= toRead;
+        buf += toRead;
+        while(left) {
+            if(!fillBuffer()) break;
+            a = _fill - _pos;
+            toRead = a > left ? left : a;
+            memcpy(buf, _buffer + _pos, toRead);
+            _pos += toRead;
+            left -= toRead;
+            buf += toRead;
+        }
+        return len - left;
+    }
+  private:
+    static const size_t _size = 1436;
+    uint8_t _buffer[_size];
+    size_t  _pos = 0, _fill = 0;
+    int     _fd;
+    int level() {int n = 0; return ioctl(_fd, FIONREAD, &n) < 0 ? 0 : n;}
+    size_t fillBuffer() {
+        if(_pos == _fill) _pos = _fill = 0;
+        if(_fill < _size && level()) {
+            recvCalls++;
+            int res = recv(_fd, _buffer + _fill, _size - _fill, MSG_DONTWAIT);
+            if(res > 0) _fill += res;
+        }
+        return _fill - _pos;
+    }
+};
+
+static int streamRead(RxClient& client, uint8_t* buf, uint32_t len, uint32_t* direct) {
+    // Audio::streamRead()
+    int sock = RECV_Level(client.fd());
+    if(sock >= 0 && client.available() <= sock) {
+        recvCalls++;
+        int n = RECV_Read(client.fd(), buf, len);
+        *direct += n;
+        return n;
+    }
+    return client.read(buf, len);
+}
+
+static inline uint8_t pattern(uint32_t i) {return (uint8_t)(i % 251);}   // no period that fits a buffer
+
+static std::thread sender;
+
+static int connectSender(uint32_t bytes, bool pace) {
+    // a connected socket, the thread behind it writes bytes of the pattern (in random blocks and pauses with pace)
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(lfd, (struct sockaddr*)&sa, sizeof(sa));
+    socklen_t len = sizeof(sa);
+    getsockname(lfd, (struct sockaddr*)&sa, &len);
+    listen(lfd, 1);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    connect(fd, (struct sockaddr*)&sa, sizeof(sa));
+    int sfd = accept(lfd, NULL, NULL);
+    close(lfd);
+    sender = std::thread([=] {
+        static uint8_t block[65536];
+        uint32_t seed = 3, sent = 0;
+        while(sent < bytes) {
+            uint32_t r = pace ? testRand(&seed) : 0;
+            uint32_t n = pace ? 1 + r % 8000 : sizeof(block);
+            if(n > bytes - sent) n = bytes - sent;
+            for(uint32_t i = 0; i < n; i++) block[i] = pattern(sent + i);
+            int w = send(sfd, block, n, MSG_NOSIGNAL);
+            if(w <= 0) break;
+            sent += w;
+            if(pace && (r >> 16) % 16 == 0) usleep(50);
+        }
+        close(sfd);
+    });
+    return fd;
+}
+
+static void waitData(int fd) {
+    struct pollfd p = {fd, POLLIN, 0};
+    poll(&p, 1, 100);
+}
+
+static double cpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void test_order() {
+    int fd = connectSender(ORDER_BYTES, true);
+    RxClient client(fd);
+    static uint8_t buf[16384];
+    uint32_t seed = 9, got = 0, direct = 0, errors = 0, turns = 0;
+    bool viaClient = true;                                  // the header is read through the client
+    while(got < ORDER_BYTES) {
+        uint32_t r = testRand(&seed);
+        if(r % 64 == 0) {viaClient = !viaClient; turns++;}
+        uint32_t len = 1 + (r >> 8) % sizeof(buf);
+        int n = viaClient ? client.read(buf, len < 2000 ? len : len % 2000 + 1) : streamRead(client, buf, len, &direct);
+        if(n <= 0) {waitData(fd); continue;}
+        for(int i = 0; i < n; i++) if(buf[i] != pattern(got + i) && errors++ < 5)
+            printf("byte %u: %u, expected %u\n", got + i, buf[i], pattern(got + i));
+        got += n;
+    }
+    sender.join();
+    close(fd);
+    char msg[100];
+    snprintf(msg, sizeof(msg), "%u MB, %u MB direct, %u turns", got >> 20, direct >> 20, turns);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, msg);
+    TEST_ASSERT_TRUE_MESSAGE(direct > ORDER_BYTES / 4 && direct < ORDER_BYTES, msg);
+}
+
+static double run(bool direct, uint32_t readLen, uint32_t* calls) {
+    // ns of CPU per byte of the reading thread
+    int fd = connectSender(RUN_BYTES, false);
+    RxClient client(fd);
+    static uint8_t buf[16384];
+    uint32_t got = 0, d = 0;
+    recvCalls = 0;
+    double t = cpuNs();
+    while(got < RUN_BYTES) {
+        int n = direct ? streamRead(client, buf, readLen, &d) : client.read(buf, readLen);
+        if(n <= 0) {waitData(fd); continue;}
+        got += n;
+    }
+    t = cpuNs() - t;
+    sender.join();
+    close(fd);
+    *calls = recvCalls;
+    return t / got;
+}
+
+void test_throughput() {
+    uint32_t lens[2] = {16384, 1600};                       // an InBuff block, a frame
+    double ns[2][2];
+    uint32_t calls[2][2];
+    for(int l = 0; l < 2; l++) {
+        ns[l][0] = run(false, lens[l], &calls[l][0]);
+        ns[l][1] = run(true, lens[l], &calls[l][1]);
+        char msg[120];
+        snprintf(msg, sizeof(msg), "%5u byte reads: client %.3f ns/byte %u recv, direct %.3f ns/byte %u recv", lens[l],
+                 ns[l][0], calls[l][0], ns[l][1], calls[l][1]);
+        TEST_MESSAGE(msg);
+    }
+    TEST_ASSERT_TRUE(calls[0][1] * 4 < calls[0][0]);
+    TEST_ASSERT_TRUE(ns[0][1] < ns[0][0]);
+    TEST_ASSERT_TRUE(calls[1][1] < calls[1][0]);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_order);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,73 @@
+/*
+ * test_spectrum.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Spectrum analyzer (dsp/spectrum) with the R4FFT() of the AAC decoder: a sine lands in the band of its bin, at
+ *  the level of spectrum.h (0...255 over SP_RANGE_DB, 0 dB = full scale sine) within 2 dB, silence shows nothing.
+ *  The CPU cost on the board is measured by test/embedded/test_spectrum.
+ */
+#include <unity.h>
+#include "aac_decoder/aac_decoder.cpp"
+#include "dsp/spectrum.cpp"
+
+#define BANDS 24                                    // SpectrumWidget
+
+static uint32_t    spMem[SP_MEM_SIZE / 4];
+static spectrum_t  sp;
+
+static void tapSine(uint32_t rate, double freq, double dB, int blocks) {
+    // blocks of 256 frames, as processI2Sblock() taps them
+    double amp = 32767.0 * pow(10.0, dB / 20.0), ph = 0;
+    int16_t buf[512];
+    for(int blk = 0; blk < blocks; blk++) {
+        for(int i = 0; i < 256; i++) {
+            int16_t s = (int16_t)lrint(amp * sin(ph));
+            ph += 2 * M_PI * freq / rate;
+            buf[2 * i] = s;
+            buf[2 * i + 1] = s;
+        }
+        SP_Tap(&sp, buf, 256, rate);
+    }
+}
+
+void test_sine_band_and_level() {
+    static const uint32_t rates[] = {22050, 44100, 48000};
+    static const double   freqs[] = {60, 200, 1000, 5000, 10000};
+    static const double   levels[] = {0, -20, -40};
+    uint8_t lv[SP_MAX_BANDS];
+    for(uint32_t rate : rates) for(double f : freqs) for(double dB : levels) {
+        SP_Init(&sp, spMem);
+        tapSine(rate, f, dB, 16);
+        TEST_ASSERT_TRUE(SP_Compute(&sp, lv, BANDS));
+        int best = 0;
+        for(int b = 1; b < BANDS; b++) if(lv[b] > lv[best]) best = b;
+        int bin = (int)lrint(f * SP_FFT_LEN / (rate / sp.decim)), band = -1;
+        for(int b = 0; b < BANDS; b++) if(bin >= sp.edge[b] && bin < sp.edge[b + 1]) band = b;
+        double expect = 255.0 * (SP_RANGE_DB + dB) / SP_RANGE_DB;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%u Hz, sine %g Hz %g dB: band %d (expected %d), level %d (expected %.0f)",
+                 rate, f, dB, best, band, lv[best], expect);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(band, best, msg);
+        TEST_ASSERT_TRUE_MESSAGE(fabs(lv[best] - expect) <= 2 * 255.0 / SP_RANGE_DB, msg);
+    }
+}
+
+void test_silence_and_no_new_samples() {
+    uint8_t lv[SP_MAX_BANDS];
+    SP_Init(&sp, spMem);
+    tapSine(44100, 1000, -200, 8);                  // zeros
+    TEST_ASSERT_TRUE(SP_Compute(&sp, lv, BANDS));
+    for(int b = 0; b < BANDS; b++) TEST_ASSERT_EQUAL_UINT8(0, lv[b]);
+    TEST_ASSERT_FALSE(SP_Compute(&sp, lv, BANDS)); // nothing tapped since
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sine_band_and_level);
+    RUN_TEST(test_silence_and_no_new_samples);
+    return UNITY_END();
+}
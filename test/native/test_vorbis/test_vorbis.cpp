@@ -0,0 +1,190 @@
+/*
+ * test_vorbis.cpp
+ *
+ *  Created on: Oct 17,2026
+ *
+ *  Memory bound and decode time of the Vorbis decoder (vorbis_decoder) on the host. The streams are played through
+ *  the Ogg demultiplexer (container/ogg) as Audio::sendBytes() does, in reads of up to 1600 bytes.
+ *
+ *  memory   the peak of the arena (VORBISGetMemoryUsed()) fits VORBIS_ARENA_DRAM for libvorbis streams of the
+ *           lowest quality up to q10, mono and stereo, 22.05...48 kHz; a setup larger than the arena is refused
+ *           with ERR_VORBIS_SETUP_TOO_BIG and nothing is played
+ *  output   the sines come out at the right level, the SNR against the best fitting sine is within 1 dB of the one
+ *           of the libvorbis output
+ *  time     host microseconds per second of audio, reported
+ *  compare  against the libvorbis output, the decoder is integer only: SNR >= 60 dB
+ *
+ *  q*.ogg   libsndfile (libvorbis 1.3.7), 0.5 s, 1 kHz left and 1.5 kHz right at -6 dBFS
+ *  q*.s16   the libvorbis output of q*.ogg, 16 bit
+ */
+#include <unity.h>
+#include <chrono>
+#include "testdata.h"
+#include "container/ogg.cpp"
+#include "vorbis_decoder/vorbis_decoder.cpp"
+
+struct stream_t {
+    const char* name;
+    uint32_t    rate;
+    uint8_t     channels;
+    double      refSnr;                             // dB, libvorbis output, the lower one of the channels
+};
+
+static const stream_t streams[] = {
+    {"qmin_44k_stereo.ogg", 44100, 2, 29.7},
+    {"q5_22k_mono.ogg",     22050, 1, 31.2},
+    {"q5_44k_stereo.ogg",   44100, 2, 43.4},
+    {"q10_44k_stereo.ogg",  44100, 2, 53.4},
+    {"q10_48k_stereo.ogg",  48000, 2, 52.7},
+};
+
+static bool isVorbis(const uint8_t* pkt, uint32_t len) {      // as Audio::oggIsVorbis()
+    return len >= 7 && pkt[0] == 1 && memcmp(pkt + 1, "vorbis", 6) == 0;
+}
+static const oggCodec_t oggVorbis = {10, VORBIS_MAX_PACKET, isVorbis, VORBISDecoder_Reset, VORBISDecode};
+static oggDemux_t ogg;
+
+static int8_t play(const char* name, std::vector<int16_t>* pcm, double* us) {
+    // the first error ends the stream, ERR_OGG_NO_CODEC: the file is missing
+    std::vector<uint8_t> in = loadTestFile(__FILE__, name);
+    memset(&ogg, 0, sizeof(ogg));
+    OGG_Register(&ogg, &oggVorbis);
+    if(in.empty() || OGG_Probe(&ogg, in.data(), in.size()) != &oggVorbis || !OGG_AllocateBuffers(&ogg, &oggVorbis))
+        return ERR_OGG_NO_CODEC;
+    static short out[VORBIS_MAX_BLOCKSIZE];
+    uint32_t seed = 1;
+    size_t pos = 0;
+    *us = 0;
+    while(pos < in.size() || ogg.pending) {
+        int len = std::min<size_t>(in.size() - pos, 300 + testRand(&seed) % 1301);
+        int bytesLeft = len;
+        auto t = std::chrono::steady_clock::now();
+        int8_t ret = OGG_Decode(&ogg, in.data() + pos, &bytesLeft, out);
+        *us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count();
+        if(ret < 0) {OGG_FreeBuffers(&ogg); return ret;}
+        pos += len - bytesLeft;
+        uint16_t n = VORBISGetOutputSamps();
+        pcm->insert(pcm->end(), out, out + n);
+    }
+    OGG_FreeBuffers(&ogg);
+    return ERR_VORBIS_NONE;
+}
+
+static double sineSnr(const std::vector<int16_t>& pcm, int ch, int c, double freq, uint32_t rate, double* amp) {
+    // least squares fit of a sine of freq, the middle of the stream
+    size_t frames = pcm.size() / ch, a = frames / 5, b = frames - frames / 5;
+    double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+    for(size_t i = a; i < b; i++) {
+        double s = sin(2 * M_PI * freq * i / rate), k = cos(2 * M_PI * freq * i / rate), y = pcm[i * ch + c];
+        ss += s * s; sc += s * k; cc += k * k; ys += y * s; yc += y * k;
+    }
+    double det = ss * cc - sc * sc, p = (ys * cc - yc * sc) / det, q = (yc * ss - ys * sc) / det;
+    double se = 0, sy = 0;
+    for(size_t i = a; i < b; i++) {
+        double fit = p * sin(2 * M_PI * freq * i / rate) + q * cos(2 * M_PI * freq * i / rate);
+        double e = pcm[i * ch + c] - fit;
+        se += e * e;
+        sy += fit * fit;
+    }
+    *amp = sqrt(p * p + q * q) / 32768;
+    return 10 * log10(sy / se);
+}
+
+void test_memory_bound() {
+    hostPsram = false;                              // the smaller budget
+    for(const stream_t& s : streams) {
+        TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+        TEST_ASSERT_EQUAL(VORBIS_ARENA_DRAM, s_arenaSize);
+        std::vector<int16_t> pcm;
+        double us;
+        int8_t ret = play(s.name, &pcm, &us);
+        char msg[120];
+        snprintf(msg, sizeof(msg), "%s: %u of %u bytes of the arena, %u Hz, %u ch", s.name, VORBISGetMemoryUsed(),
+                 VORBIS_ARENA_DRAM, VORBISGetSampRate(), VORBISGetChannels());
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(ERR_VORBIS_NONE, ret, msg);
+        TEST_ASSERT_TRUE_MESSAGE(VORBISGetMemoryUsed() <= VORBIS_ARENA_DRAM, msg);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(s.rate, VORBISGetSampRate(), msg);
+        TEST_ASSERT_EQUAL_MESSAGE(s.channels, VORBISGetChannels(), msg);
+        VORBISDecoder_FreeBuffers();
+    }
+}
+
+void test_setup_too_big() {
+    // the q10 setup in an arena of half its size: refused, no audio packet is decoded
+    hostPsram = false;
+    TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+    std::vector<int16_t> pcm;
+    double us;
+    TEST_ASSERT_EQUAL_INT(ERR_VORBIS_NONE, play("q10_44k_stereo.ogg", &pcm, &us));
+    uint32_t need = VORBISGetMemoryUsed();
+    VORBISDecoder_FreeBuffers();
+    TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+    s_arenaSize = need / 2;
+    pcm.clear();
+    TEST_ASSERT_EQUAL_INT(ERR_VORBIS_SETUP_TOO_BIG, play("q10_44k_stereo.ogg", &pcm, &us));
+    TEST_ASSERT_TRUE(pcm.empty());
+    TEST_ASSERT_TRUE(VORBISGetMemoryUsed() <= need / 2);
+    VORBISDecoder_FreeBuffers();
+}
+
+void test_output_and_time() {
+    for(const stream_t& s : streams) {
+        TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+        std::vector<int16_t> pcm;
+        double us;
+        TEST_ASSERT_EQUAL_INT(ERR_VORBIS_NONE, play(s.name, &pcm, &us));
+        size_t frames = pcm.size() / s.channels;
+        char msg[160];
+        int len = snprintf(msg, sizeof(msg), "%-20s %6zu frames, %5.0f us per second of audio on the host,", s.name,
+                           frames, us / ((double)frames / s.rate));
+        TEST_ASSERT_TRUE_MESSAGE(frames > s.rate / 2 - 2048 && frames <= s.rate / 2 + 2048, msg);
+        for(int c = 0; c < s.channels; c++) {
+            double amp, snr = sineSnr(pcm, s.channels, c, c ? 1500 : 1000, s.rate, &amp);
+            len += snprintf(msg + len, sizeof(msg) - len, " %.1f dB (level %.3f)", snr, amp);
+            TEST_ASSERT_TRUE_MESSAGE(snr >= s.refSnr - 1 && fabs(amp - 0.5) < 0.05, msg);
+        }
+        TEST_MESSAGE(msg);
+        VORBISDecoder_FreeBuffers();
+    }
+}
+
+void test_against_libvorbis() {
+    for(const char* name : {"q5_22k_mono", "q10_44k_stereo"}) {
+        std::string ogg = std::string(name) + ".ogg", ref = std::string(name) + ".s16";
+        std::vector<uint8_t> r = loadTestFile(__FILE__, ref.c_str());
+        TEST_ASSERT_FALSE_MESSAGE(r.empty(), name);
+        TEST_ASSERT_TRUE(VORBISDecoder_AllocateBuffers());
+        std::vector<int16_t> pcm;
+        double us;
+        TEST_ASSERT_EQUAL_INT(ERR_VORBIS_NONE, play(ogg.c_str(), &pcm, &us));
+        VORBISDecoder_FreeBuffers();
+        TEST_ASSERT_TRUE_MESSAGE(pcm.size() >= r.size() / 2, name);   // libvorbis cuts the last block at the granule
+        double se = 0, ss = 0;
+        int maxErr = 0;
+        for(size_t i = 0; i < r.size() / 2; i++) {
+            int16_t v = (int16_t)(r[2 * i] | r[2 * i + 1] << 8);
+            int e = pcm[i] - v;
+            se += (double)e * e;
+            ss += (double)v * v;
+            if(abs(e) > maxErr) maxErr = abs(e);
+        }
+        double snr = se ? 10 * log10(ss / se) : 999;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s: %.1f dB against libvorbis, max error %d", name, snr, maxErr);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE_MESSAGE(snr >= 60, msg);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_memory_bound);
+    RUN_TEST(test_setup_too_big);
+    RUN_TEST(test_output_and_time);
+    RUN_TEST(test_against_libvorbis);
+    return UNITY_END();
+}